@@ -0,0 +1,77 @@
+#ifndef ALLOWLIST_H
+#define ALLOWLIST_H
+
+#include <stddef.h>
+
+/**
+ * @file allowlist.h
+ * @brief 해시 기반 허용 프로세스 목록
+ * @details 프로세스 이름을 소문자로 정규화하여 하나의 연속된 아레나에 인턴하고,
+ *          오픈 어드레싱 해시 테이블로 항목 수와 관계없이 O(1)에 조회합니다.
+ *          항목마다 0이 아닌 값 하나(키 규칙 번호 + 1)를 함께 저장합니다.
+ *          추가는 설정 로드 시에만, 조회는 후크에서 수행합니다.
+ */
+
+/**
+ * @brief 해시 테이블 슬롯
+ * @details offset이 0이면 빈 슬롯입니다. (아레나의 0번 바이트는 사용하지 않음)
+ */
+typedef struct allowlist_slot {
+    unsigned int hash;   /**< 정규화된 이름의 해시 */
+    unsigned int offset; /**< 아레나 내 문자열 시작 위치 */
+    unsigned int value;  /**< 항목 값 (0이 아님) */
+} allowlist_slot;
+
+/**
+ * @brief 허용 프로세스 목록
+ */
+typedef struct allowlist {
+    char* arena;            /**< 소문자로 정규화된 이름들이 NUL로 구분되어 저장되는 공간 */
+    size_t arena_size;      /**< 아레나 할당 크기 */
+    size_t arena_used;      /**< 아레나 사용량 */
+    allowlist_slot* slots;  /**< 오픈 어드레싱 해시 테이블 */
+    unsigned long slot_mask;/**< 슬롯 수 - 1 (슬롯 수는 2의 거듭제곱) */
+    unsigned long count;    /**< 등록된 이름 수 */
+} allowlist;
+
+/**
+ * @brief 빈 목록으로 초기화합니다.
+ */
+void allowlist_init(allowlist* list);
+
+/**
+ * @brief 목록이 사용하는 메모리를 해제하고 빈 목록으로 되돌립니다.
+ */
+void allowlist_free(allowlist* list);
+
+/**
+ * @brief 프로세스 이름을 값 1로 추가합니다. (대소문자 구분 없음, 중복은 무시)
+ * @return int 성공 시 1 (이미 있는 경우 포함), 메모리 부족 시 0
+ */
+int allowlist_add(allowlist* list, const char* name);
+
+/**
+ * @brief 프로세스 이름을 추가하거나, 이미 있으면 값을 바꿉니다. (대소문자 구분 없음)
+ * @param value 저장할 값 (0이 아니어야 함)
+ * @return int 성공 시 1, 메모리 부족 시 0
+ */
+int allowlist_set(allowlist* list, const char* name, unsigned int value);
+
+/**
+ * @brief 프로세스 이름에 저장된 값을 반환합니다. (대소문자 구분 없음)
+ * @return unsigned int 저장된 값, 목록에 없으면 0
+ */
+unsigned int allowlist_value(const allowlist* list, const char* name);
+
+/**
+ * @brief 프로세스 이름이 목록에 있는지 확인합니다. (대소문자 구분 없음)
+ * @return int 있으면 1, 없으면 0
+ */
+int allowlist_contains(const allowlist* list, const char* name);
+
+/**
+ * @brief 등록된 이름 수를 반환합니다.
+ */
+unsigned long allowlist_count(const allowlist* list);
+
+#endif // ALLOWLIST_H
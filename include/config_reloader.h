@@ -0,0 +1,85 @@
+#ifndef CONFIG_RELOADER_H
+#define CONFIG_RELOADER_H
+
+#include "file_watch.h"
+#include "policy_store.h"
+#include "kp_platform.h"
+
+/**
+ * @file config_reloader.h
+ * @brief 설정 파일 감시 및 정책 핫 리로드
+ * @details 백그라운드 스레드가 설정 파일 변경을 감시하다가, 변경이 잦아들면 새 정책 스냅샷을
+ *          만들어 policy_store에 게시합니다. 후크 스레드는 관여하지 않습니다.
+ */
+
+/** @brief 변경 감지 후 추가 변경이 없는지 기다리는 시간 (편집기의 분할 저장 대비) */
+#define CONFIG_RELOAD_DEBOUNCE_MS 200
+
+/**
+ * @brief 설정 파일에서 새 정책 스냅샷을 만드는 콜백
+ * @return policy_snapshot* 새 스냅샷, 실패 시 NULL (기존 정책 유지)
+ */
+typedef policy_snapshot* (*policy_load_fn)(const char* path, void* user);
+
+/**
+ * @brief 새 스냅샷이 게시된 뒤 호출되는 콜백 (캐시 무효화 등)
+ */
+typedef void (*policy_published_fn)(const policy_snapshot* snapshot, void* user);
+
+/**
+ * @brief 설정 리로더
+ */
+typedef struct config_reloader {
+    file_watch watch;              /**< 설정 파일 감시 상태 */
+    policy_store* store;           /**< 게시 대상 저장소 */
+    policy_load_fn load;           /**< 스냅샷 생성 콜백 */
+    policy_published_fn published; /**< 게시 후 콜백 (NULL 가능) */
+    void* user;                    /**< 콜백 사용자 데이터 */
+    kp_thread thread;              /**< 감시 스레드 */
+    volatile int stop;             /**< 감시 스레드 종료 요청 */
+    unsigned long reloads;         /**< 성공한 리로드 횟수 */
+    unsigned long failures;        /**< 실패한 리로드 횟수 */
+} config_reloader;
+
+/**
+ * @brief 설정 파일을 다시 읽어 새 정책 스냅샷을 만드는 기본 콜백 (policy_load_fn)
+ * @details 저장 도중 파일이 잠시 사라진 경우 등 파일을 읽을 수 없으면 기본 정책으로 되돌리지 않고
+ *          NULL을 반환하여 기존 정책을 유지합니다.
+ * @param user 사용하지 않음
+ */
+policy_snapshot* config_reloader_load_file(const char* path, void* user);
+
+/**
+ * @brief 리로더를 초기화하고 파일 감시를 시작합니다. (스레드는 시작하지 않음)
+ * @return int 성공 시 1, 파일 감시를 시작할 수 없으면 0
+ */
+int config_reloader_init(config_reloader* reloader, const char* path, policy_store* store,
+                         policy_load_fn load, policy_published_fn published, void* user);
+
+/**
+ * @brief 변경을 최대 timeout_ms 동안 기다렸다가, 바뀌었으면 다시 로드하여 게시합니다.
+ * @details 감시 스레드의 한 주기이며, 스레드 없이 직접 호출하여 동작을 확인할 수도 있습니다.
+ * @return int 새 스냅샷을 게시했으면 1, 변경이 없으면 0, 로드에 실패했으면 -1
+ */
+int config_reloader_poll(config_reloader* reloader, unsigned int timeout_ms);
+
+/**
+ * @brief 변경 여부와 관계없이 설정 파일을 지금 다시 로드하여 게시합니다.
+ * @details 감시 스레드 없이 이벤트 루프에서 리로더를 구동할 때(디바운스 만료, 제어 채널의 리로드 요청) 사용합니다.
+ *          게시는 한 스레드에서만 해야 하므로 감시 스레드와 함께 쓰면 안 됩니다.
+ * @return int 새 스냅샷을 게시했으면 1, 로드에 실패했으면 -1
+ */
+int config_reloader_reload(config_reloader* reloader);
+
+/**
+ * @brief 백그라운드 감시 스레드를 시작합니다.
+ * @return int 성공 시 1
+ */
+int config_reloader_start(config_reloader* reloader);
+
+/**
+ * @brief 감시 스레드를 멈추고 파일 감시를 끝냅니다.
+ */
+void config_reloader_stop(config_reloader* reloader);
+
+#endif // CONFIG_RELOADER_H
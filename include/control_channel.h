@@ -0,0 +1,221 @@
+#ifndef CONTROL_CHANNEL_H
+#define CONTROL_CHANNEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file control_channel.h
+ * @brief 로컬 제어 채널 (통계 조회, 정책 리로드, 로그 상세 수준 변경, 종료 요청)
+ * @details Windows에서는 이름 있는 파이프(`\\.\pipe\<이름>`), 그 외 환경에서는 Unix 도메인 소켓
+ *          (`/tmp/<이름>.sock`)을 사용합니다. 메시지는 8바이트 헤더와 고정 크기 본문으로 된 이진 프레임이며,
+ *          같은 기계의 프로세스끼리만 주고받으므로 호스트 바이트 순서를 그대로 씁니다.
+ *
+ *          서버는 블로킹하지 않습니다. 메인 루프가 control_server_wait_handle()(Windows) 또는
+ *          control_server_fd()(POSIX)를 다른 대기 대상과 함께 기다리다가 신호가 오면
+ *          control_server_service()를 호출하고, 요청은 그 안에서 처리 콜백으로 전달됩니다.
+ *          클라이언트는 한 번에 하나만 연결할 수 있습니다.
+ *          처리 콜백은 control_server.client_pid로 요청한 프로세스를 확인할 수 있습니다.
+ */
+
+/** @brief 기본 채널 이름 */
+#define CONTROL_CHANNEL_NAME "keyboard_protector"
+
+/** @brief 프레임 시작 표식 ("KPC1") */
+#define CONTROL_MAGIC 0x3143504BUL
+
+/** @brief 응답 프레임의 type에 더해지는 비트 */
+#define CONTROL_REPLY 0x8000
+
+/** @brief 프레임 본문 최대 크기 */
+#define CONTROL_PAYLOAD_MAX 256
+
+/** @brief 채널 이름 최대 길이 */
+#define CONTROL_NAME_SIZE 64
+
+/**
+ * @brief 요청 종류
+ */
+typedef enum control_command {
+    CONTROL_PING = 1,          /**< 연결 확인 (본문 없음) */
+    CONTROL_STATS = 2,         /**< 실시간 카운터 조회 (응답 본문: control_stats) */
+    CONTROL_RELOAD = 3,        /**< 설정 파일을 다시 읽어 정책 게시 */
+    CONTROL_SET_VERBOSITY = 4, /**< 로그 상세 수준 변경 (요청 본문: uint32_t log_verbosity) */
+    CONTROL_SHUTDOWN = 5,      /**< 후크를 해제하고 정상 종료 */
+    CONTROL_SUBSCRIBE = 6,     /**< 공유 메모리 키 전달 구독 (요청 본문: uint32_t 프로세스 ID, 응답 본문: key_delivery_grant) */
+    CONTROL_UNSUBSCRIBE = 7,   /**< 공유 메모리 키 전달 구독 해제 (요청 본문: uint32_t 프로세스 ID) */
+    CONTROL_SHADOW_REPORT = 8  /**< 그림자 집계 보고서를 지금 기록 (응답 본문: 보고서 경로, 종료 문자 없음) */
+} control_command;
+
+/**
+ * @brief 응답 상태
+ */
+typedef enum control_status {
+    CONTROL_OK = 0,            /**< 성공 */
+    CONTROL_ERR_UNKNOWN = 1,   /**< 알 수 없는 요청 */
+    CONTROL_ERR_INVALID = 2,   /**< 본문이 잘못됨 */
+    CONTROL_ERR_FAILED = 3     /**< 요청을 수행하지 못함 (예: 설정 파일 로드 실패) */
+} control_status;
+
+/**
+ * @brief 실시간 카운터 번호 (control_stats.values의 인덱스, 새 항목은 끝에만 추가)
+ */
+typedef enum control_stat {
+    CONTROL_STAT_UPTIME_MS = 0,         /**< 후크 설치 후 경과 시간 */
+    CONTROL_STAT_POLICY_VERSION,        /**< 현재 정책 버전 */
+    CONTROL_STAT_ALLOWED_PROCESSES,     /**< 허용 프로세스 수 */
+    CONTROL_STAT_LOG_VERBOSITY,         /**< 현재 로그 상세 수준 */
+    CONTROL_STAT_PROCESSED,             /**< 작업 스레드가 처리한 키 이벤트 */
+    CONTROL_STAT_DROPPED,               /**< 큐가 가득 차서 버린 키 이벤트 */
+    CONTROL_STAT_ALLOWED,               /**< 허용 판정 */
+    CONTROL_STAT_BLOCKED,               /**< 차단 판정 */
+    CONTROL_STAT_UNKNOWN,               /**< 확인 실패 판정 */
+    CONTROL_STAT_INJECTED,              /**< 주입한 키 이벤트 */
+    CONTROL_STAT_REPEATS,               /**< 자동 반복 빠른 경로 */
+    CONTROL_STAT_RULE_BLOCKED,          /**< 키 규칙으로 차단한 키 다운 */
+    CONTROL_STAT_SELF_PASSED,           /**< 자체 주입 키 빠른 경로 */
+    CONTROL_STAT_FOREIGN_PASSED,        /**< 외부 주입 키 통과 */
+    CONTROL_STAT_FOREIGN_BLOCKED,       /**< 외부 주입 키 차단 */
+    CONTROL_STAT_FOREIGN_PROCESSED,     /**< 외부 주입 키 처리 */
+    CONTROL_STAT_RELOADS,               /**< 성공한 정책 리로드 */
+    CONTROL_STAT_RELOAD_FAILURES,       /**< 실패한 정책 리로드 */
+    CONTROL_STAT_DELIVERY_CHANNELS,     /**< 열려 있는 공유 메모리 전달 채널 */
+    CONTROL_STAT_DELIVERED,             /**< 공유 메모리로 전달한 키 이벤트 */
+    CONTROL_STAT_DELIVERY_FALLBACKS,    /**< 전달 링이 가득 차서 SendInput으로 대신 주입한 키 이벤트 */
+    CONTROL_STAT_HOOK_LEVEL,            /**< 현재 부가 작업 축소 단계 (hook_degrade_level) */
+    CONTROL_STAT_HOOK_OVER_BUDGET,      /**< 지연 예산을 넘은 키 입력 */
+    CONTROL_STAT_HOOK_DEGRADATIONS,     /**< 축소 단계를 내린 횟수 */
+    CONTROL_STAT_HOOK_RECOVERIES,       /**< 축소 단계를 되돌린 횟수 */
+    CONTROL_STAT_HOOK_PROBES,           /**< 후크 생존 확인 탐침 수 */
+    CONTROL_STAT_HOOK_REINSTALLS,       /**< 후크 재설치 횟수 */
+    CONTROL_STAT_SHADOW_KEY_DOWNS,      /**< 그림자 집계에 더한 키 다운 */
+    CONTROL_STAT_SHADOW_DISAGREEMENTS,  /**< 현재 정책과 후보 정책의 판정이 다른 키 다운 */
+    CONTROL_STAT_COUNT
+} control_stat;
+
+/**
+ * @brief 프레임 헤더 (8바이트)
+ */
+typedef struct control_header {
+    uint32_t magic;   /**< CONTROL_MAGIC */
+    uint16_t type;    /**< control_command 값 (응답이면 CONTROL_REPLY 비트 추가) */
+    uint16_t length;  /**< 본문 길이 (CONTROL_PAYLOAD_MAX 이하) */
+} control_header;
+
+/**
+ * @brief 요청 또는 응답 메시지
+ * @details 응답 본문은 항상 uint32_t 상태(control_status)로 시작하고, 그 뒤에 요청별 데이터가 옵니다.
+ */
+typedef struct control_message {
+    control_header header;                    /**< 프레임 헤더 */
+    unsigned char payload[CONTROL_PAYLOAD_MAX]; /**< 본문 */
+} control_message;
+
+/**
+ * @brief CONTROL_STATS 응답 데이터
+ */
+typedef struct control_stats {
+    uint32_t count;                       /**< 보낸 카운터 수 (CONTROL_STAT_COUNT) */
+    uint32_t reserved;                    /**< 정렬용 예약 공간 */
+    uint64_t values[CONTROL_STAT_COUNT];  /**< control_stat 순서의 카운터 */
+} control_stats;
+
+/**
+ * @brief 요청 처리 콜백
+ * @details 서버를 서비스하는 스레드에서 호출됩니다. reply의 헤더는 서버가 채우며,
+ *          콜백은 control_message_set_status()/control_message_append()로 본문만 작성합니다.
+ */
+typedef void (*control_handler_fn)(const control_message* request, control_message* reply, void* user);
+
+/**
+ * @brief 제어 채널 서버
+ */
+typedef struct control_server {
+    char name[CONTROL_NAME_SIZE];            /**< 채널 이름 */
+    control_handler_fn handler;              /**< 요청 처리 콜백 */
+    void* user;                              /**< 콜백 사용자 데이터 */
+    unsigned char buffer[sizeof(control_message)]; /**< 받는 중인 프레임 */
+    size_t used;                             /**< buffer에 받은 바이트 수 */
+    int connected;                           /**< 클라이언트가 연결되어 있는지 여부 */
+    unsigned long client_pid;                /**< 연결된 클라이언트의 프로세스 ID (운영체제가 알려 주지 않으면 0) */
+    unsigned long requests;                  /**< 처리한 요청 수 */
+    unsigned long rejected;                  /**< 잘못된 프레임으로 끊은 연결 수 */
+#ifdef _WIN32
+    void* pipe;                              /**< 파이프 인스턴스 (HANDLE) */
+    void* event;                             /**< 겹친 I/O 완료 이벤트 (HANDLE, 수동 리셋) */
+    void* overlapped;                        /**< 진행 중인 연결/읽기 요청 (OVERLAPPED*) */
+    int pending;                             /**< 겹친 I/O가 진행 중인지 여부 */
+#else
+    int listen_fd;                           /**< 수신 대기 소켓 */
+    int client_fd;                           /**< 연결된 클라이언트 소켓 (-1이면 없음) */
+#endif
+} control_server;
+
+/**
+ * @brief 서버를 열고 첫 연결을 기다리기 시작합니다.
+ * @param server 서버 상태
+ * @param name 채널 이름 (NULL이면 CONTROL_CHANNEL_NAME)
+ * @param handler 요청 처리 콜백
+ * @param user 콜백 사용자 데이터
+ * @return int 성공 시 1, 같은 이름의 서버가 이미 있거나 만들 수 없으면 0
+ */
+int control_server_open(control_server* server, const char* name, control_handler_fn handler, void* user);
+
+/**
+ * @brief 메인 루프가 기다릴 Win32 이벤트 핸들을 반환합니다. (POSIX에서는 NULL)
+ */
+void* control_server_wait_handle(const control_server* server);
+
+/**
+ * @brief 메인 루프가 poll로 기다릴 소켓을 반환합니다. (Windows에서는 -1)
+ * @details 클라이언트가 연결되어 있으면 클라이언트 소켓, 아니면 수신 대기 소켓입니다.
+ */
+int control_server_fd(const control_server* server);
+
+/**
+ * @brief 준비된 연결과 요청을 블로킹 없이 처리합니다.
+ * @return int 이번 호출에서 처리한 요청 수
+ */
+int control_server_service(control_server* server);
+
+/**
+ * @brief 서버를 닫습니다.
+ */
+void control_server_close(control_server* server);
+
+/**
+ * @brief 응답 본문을 상태 값 하나로 초기화합니다.
+ */
+void control_message_set_status(control_message* reply, control_status status);
+
+/**
+ * @brief 응답 본문 끝에 데이터를 덧붙입니다.
+ * @return int 성공 시 1, 본문 최대 크기를 넘으면 0
+ */
+int control_message_append(control_message* reply, const void* data, size_t size);
+
+/**
+ * @brief 응답 본문의 상태 값을 읽습니다.
+ * @return control_status 상태 (본문이 없으면 CONTROL_ERR_INVALID)
+ */
+control_status control_message_status(const control_message* reply);
+
+/**
+ * @brief 요청을 보내고 응답을 기다립니다. (제어 도구용)
+ * @param name 채널 이름 (NULL이면 CONTROL_CHANNEL_NAME)
+ * @param command 요청 종류
+ * @param payload 요청 본문 (NULL 가능)
+ * @param size 요청 본문 크기
+ * @param reply 받은 응답
+ * @param timeout_ms 연결을 기다릴 최대 시간 (POSIX에서는 보내기와 받기에도 적용)
+ * @return int 성공 시 1, 연결하지 못했거나 응답이 잘못되면 0
+ */
+int control_client_call(const char* name, control_command command, const void* payload, size_t size,
+                        control_message* reply, unsigned int timeout_ms);
+
+/**
+ * @brief 카운터 이름을 반환합니다.
+ */
+const char* control_stat_name(control_stat stat);
+
+#endif // CONTROL_CHANNEL_H
@@ -0,0 +1,28 @@
+#ifndef CRYPTO_KEYCODE_H
+#define CRYPTO_KEYCODE_H
+
+/**
+ * @file crypto_keycode.h
+ * @brief 키 코드 암호화/복호화
+ * @details 솔트 자리에 ChaCha20 키스트림 워드(keystream.h)를 받아 XOR하는 스트림 암호입니다.
+ *          이 워드는 비밀 값이므로 로그와 저널에는 워드 대신 키스트림 위치를 솔트로 기록합니다.
+ *          Windows API에 의존하지 않으므로 재생 도구 등 다른 환경에서도 그대로 사용할 수 있습니다.
+ */
+
+/**
+ * @brief 키 코드를 키스트림 워드로 암호화합니다.
+ * @param key_code 암호화할 키 코드
+ * @param salt 키스트림 워드 (키 이벤트마다 새로 꺼낸 값)
+ * @return unsigned int 암호화된 키 코드
+ */
+unsigned int encrypt_keycode_with_salt(unsigned int key_code, unsigned int salt);
+
+/**
+ * @brief 암호화된 키 코드를 같은 키스트림 워드로 복호화합니다.
+ * @param encrypted_code 복호화할 암호화된 키 코드
+ * @param salt 암호화에 사용했던 동일한 키스트림 워드
+ * @return unsigned int 복호화된 (원래의) 키 코드
+ */
+unsigned int decrypt_keycode_with_salt(unsigned int encrypted_code, unsigned int salt);
+
+#endif // CRYPTO_KEYCODE_H
@@ -0,0 +1,167 @@
+#ifndef DEVICE_TABLE_H
+#define DEVICE_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file device_table.h
+ * @brief 입력 장치 테이블과 장치별 규칙
+ * @details 저수준 키보드 후크는 어느 키보드에서 온 키인지 알려주지 않으므로, Raw Input(WM_INPUT)으로 받은
+ *          장치 핸들을 키로 하는 해시 테이블에 장치 이름과 분류를 보관합니다. 분류는 [Devices] 규칙으로 정하며
+ *          (장치 이름의 일부, 예: VID_05E0&PID_1200), 규칙에 없는 장치는 Default 분류를 따릅니다.
+ *
+ *          - normal: 기존과 같이 처리
+ *          - trusted: 신뢰 장치 (바코드 스캐너 등). 판정/암호화/주입은 같고 키 단위 로그와 후보 정책 집계만 생략
+ *          - untrusted: 신뢰하지 않는 장치 (알 수 없는 HID 주입 장치 등). 모든 키를 처리 코어에 넘기지 않고 차단
+ *
+ *          장치를 알 수 없는 하드웨어 키(짝이 없거나 테이블에 없는 장치)도 Default 분류를 따릅니다.
+ *
+ *          테이블은 이벤트 루프 스레드 하나에서만 사용하며, Win32 API를 쓰지 않으므로 Linux에서도 빌드됩니다.
+ */
+
+/** @brief 테이블 크기 (2의 거듭제곱, 동시에 연결된 키보드 수보다 충분히 큼) */
+#define DEVICE_TABLE_CAPACITY 64
+
+/** @brief 장치 이름 최대 길이 (Raw Input 장치 경로) */
+#define DEVICE_NAME_SIZE 160
+
+/** @brief 장치 규칙 최대 개수 */
+#define DEVICE_MAX_RULES 32
+
+/** @brief 장치 규칙 패턴 최대 길이 */
+#define DEVICE_RULE_PATTERN_SIZE 96
+
+/** @brief 같은 장치의 키 간격이 이보다 짧으면 하나의 버스트로 봄 (사람의 타이핑보다 짧은 간격) */
+#define DEVICE_BURST_GAP_NS 15000000ULL
+
+/** @brief 버스트로 셀 최소 연속 키 수 */
+#define DEVICE_BURST_MIN_KEYS 8
+
+/**
+ * @brief 장치 분류
+ */
+typedef enum device_class {
+    DEVICE_CLASS_NORMAL = 0,    /**< 기존과 같이 처리 */
+    DEVICE_CLASS_TRUSTED = 1,   /**< 신뢰 장치: 키 단위 로그 생략 */
+    DEVICE_CLASS_UNTRUSTED = 2, /**< 신뢰하지 않는 장치: 차단 */
+    DEVICE_CLASS_COUNT
+} device_class;
+
+/**
+ * @brief 장치 규칙 하나 ([Devices] <패턴>=<분류>)
+ */
+typedef struct device_rule {
+    char pattern[DEVICE_RULE_PATTERN_SIZE]; /**< 장치 이름에 포함되어야 하는 문자열 (대소문자 무시) */
+    int device_class;                       /**< device_class 값 */
+} device_rule;
+
+/**
+ * @brief 장치 규칙 목록 (정책 스냅샷의 일부)
+ */
+typedef struct device_rules {
+    device_rule rules[DEVICE_MAX_RULES]; /**< 규칙 (먼저 적은 규칙이 우선) */
+    int count;                           /**< 규칙 수 */
+    int default_class;                   /**< 규칙에 없는 장치의 분류 ([Devices] Default) */
+} device_rules;
+
+/**
+ * @brief 장치 하나
+ */
+typedef struct device_entry {
+    uintptr_t handle;                   /**< 장치 핸들 (0이면 빈 자리) */
+    int device_class;                   /**< device_class 값 */
+    char name[DEVICE_NAME_SIZE];        /**< 장치 이름 */
+    unsigned long keys;                 /**< 받은 키 이벤트 수 */
+    unsigned long long last_ns;         /**< 마지막 키 시각 */
+    unsigned long run;                  /**< 진행 중인 연속 키 수 (간격이 DEVICE_BURST_GAP_NS 이하) */
+    unsigned long bursts;               /**< 버스트 수 */
+    unsigned long longest_burst;        /**< 가장 긴 버스트의 키 수 */
+} device_entry;
+
+/**
+ * @brief 장치 핸들 → 장치 해시 테이블 (열린 주소법, 선형 탐사)
+ */
+typedef struct device_table {
+    device_entry entries[DEVICE_TABLE_CAPACITY]; /**< 장치 */
+    int count;                          /**< 등록된 장치 수 */
+    unsigned long lookups;              /**< 조회 수 */
+    unsigned long probes;               /**< 조회에서 확인한 자리 수 (충돌 확인용) */
+} device_table;
+
+/**
+ * @brief 분류 이름을 값으로 바꿉니다. ("normal", "trusted", "untrusted")
+ * @return int device_class 값, 알 수 없는 이름이면 -1
+ */
+int device_class_parse(const char* text);
+
+/**
+ * @brief 분류 값을 이름으로 바꿉니다.
+ */
+const char* device_class_name(int device_class);
+
+/**
+ * @brief 규칙 목록을 비웁니다. (Default는 normal)
+ */
+void device_rules_init(device_rules* rules);
+
+/**
+ * @brief 규칙을 추가합니다.
+ * @return int 성공 시 1, 규칙이 가득 찼으면 0
+ */
+int device_rules_add(device_rules* rules, const char* pattern, int device_class);
+
+/**
+ * @brief 장치 이름에 해당하는 분류를 찾습니다.
+ * @return int 처음으로 일치한 규칙의 분류, 없으면 default_class
+ */
+int device_rules_classify(const device_rules* rules, const char* device_name);
+
+/**
+ * @brief 차단할 장치가 있을 수 있는 규칙인지 확인합니다. (untrusted 규칙이나 Default=untrusted)
+ * @details 이런 규칙에서는 장치를 알기 전에 키를 넘기면 차단할 키가 새어 나가므로 짝짓기가 후크 이벤트를 붙잡아야 합니다.
+ * @return int untrusted 분류가 있으면 1
+ */
+int device_rules_has_untrusted(const device_rules* rules);
+
+/**
+ * @brief 빈 테이블로 초기화합니다.
+ */
+void device_table_init(device_table* table);
+
+/**
+ * @brief 장치를 찾습니다.
+ * @return device_entry* 장치, 없으면 NULL
+ */
+device_entry* device_table_find(device_table* table, uintptr_t handle);
+
+/**
+ * @brief 장치를 등록하고 규칙으로 분류합니다. 이미 있으면 기존 장치를 반환합니다.
+ * @param table 테이블
+ * @param handle 장치 핸들 (0이 아니어야 함)
+ * @param name 장치 이름 (NULL이면 빈 이름, 규칙은 Default만 적용)
+ * @param rules 분류 규칙 (NULL이면 normal)
+ * @return device_entry* 장치, 테이블이 가득 찼으면 NULL
+ */
+device_entry* device_table_insert(device_table* table, uintptr_t handle, const char* name,
+                                  const device_rules* rules);
+
+/**
+ * @brief 장치를 제거합니다. (분리된 장치)
+ * @return int 제거했으면 1, 없으면 0
+ */
+int device_table_remove(device_table* table, uintptr_t handle);
+
+/**
+ * @brief 규칙이 바뀐 뒤 모든 장치를 다시 분류합니다.
+ * @return int 분류가 바뀐 장치 수
+ */
+int device_table_classify(device_table* table, const device_rules* rules);
+
+/**
+ * @brief 장치의 키 하나를 기록하고 버스트 상태를 갱신합니다.
+ * @return int 이 키로 연속 키가 DEVICE_BURST_MIN_KEYS개가 되어 새 버스트가 시작되었으면 1, 아니면 0
+ */
+int device_entry_key(device_entry* entry, unsigned long long now_ns);
+
+#endif // DEVICE_TABLE_H
@@ -0,0 +1,59 @@
+#ifndef FILE_WATCH_H
+#define FILE_WATCH_H
+
+/**
+ * @file file_watch.h
+ * @brief 단일 파일 변경 감시 인터페이스
+ * @details Windows에서는 FindFirstChangeNotification으로 디렉토리 변경 알림을 기다리고,
+ *          그 외 환경에서는 파일 상태(stat)를 주기적으로 비교합니다. 두 구현 모두
+ *          수정 시각과 크기를 비교하여 실제로 대상 파일이 바뀐 경우에만 변경으로 보고합니다.
+ */
+
+/** @brief 감시 대상 경로 최대 길이 */
+#define FILE_WATCH_PATH_SIZE 260
+
+/**
+ * @brief 파일 감시 상태
+ */
+typedef struct file_watch {
+    char path[FILE_WATCH_PATH_SIZE]; /**< 감시 대상 파일 경로 */
+    long long mtime;                 /**< 마지막으로 확인한 수정 시각 */
+    long long size;                  /**< 마지막으로 확인한 크기 (-1이면 파일 없음) */
+#ifdef _WIN32
+    void* change_handle;             /**< FindFirstChangeNotification 핸들 */
+#endif
+} file_watch;
+
+/**
+ * @brief 파일 감시를 시작합니다.
+ * @param watch 감시 상태
+ * @param path 감시할 파일 경로
+ * @return int 성공 시 1, 실패 시 0
+ */
+int file_watch_open(file_watch* watch, const char* path);
+
+/**
+ * @brief 파일이 바뀔 때까지 최대 timeout_ms 동안 기다립니다.
+ * @return int 파일이 바뀌었으면 1, 시간 초과면 0, 오류면 -1
+ */
+int file_watch_wait(file_watch* watch, unsigned int timeout_ms);
+
+/**
+ * @brief 현재 파일 상태를 기준값으로 다시 기록합니다.
+ * @details 변경을 처리한 뒤 호출하여 같은 변경이 다시 보고되지 않도록 합니다.
+ */
+void file_watch_rearm(file_watch* watch);
+
+/**
+ * @brief 이벤트 루프가 기다릴 변경 알림 핸들을 반환합니다.
+ * @details Windows에서는 신호되면 file_watch_wait(watch, 0)으로 확인합니다. 알림 API가 없는 환경에서는 NULL이며,
+ *          이때는 주기적으로 file_watch_wait(watch, 0)을 호출해야 합니다.
+ */
+void* file_watch_handle(const file_watch* watch);
+
+/**
+ * @brief 파일 감시를 끝냅니다.
+ */
+void file_watch_close(file_watch* watch);
+
+#endif // FILE_WATCH_H
@@ -0,0 +1,129 @@
+#ifndef FOREGROUND_CACHE_H
+#define FOREGROUND_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file foreground_cache.h
+ * @brief 포그라운드 프로세스 판정 캐시
+ * @details 포그라운드 창이 바뀌기 전까지는 (창 핸들, PID, 프로세스 시작 시각)이 같으므로
+ *          프로세스 조회와 허용 여부 판정 결과를 캐시하여 키 입력마다 커널 호출을 반복하지 않습니다.
+ *          플랫폼 API는 process_lookup_provider를 통해서만 호출하므로 Windows 외 환경에서도 동작합니다.
+ */
+
+/** @brief 프로세스 이름 버퍼 크기 (Windows MAX_PATH와 동일) */
+#define FOREGROUND_NAME_SIZE 260
+
+/**
+ * @brief 포그라운드 창을 식별하는 키
+ * @details PID는 재사용될 수 있으므로 프로세스 시작 시각을 함께 비교합니다.
+ */
+typedef struct foreground_identity {
+    uintptr_t window;              /**< 창 핸들 (HWND) */
+    unsigned long process_id;      /**< 창을 소유한 프로세스 ID */
+    unsigned long long start_time; /**< 프로세스 시작 시각 (FILETIME 등 플랫폼 고유 값) */
+} foreground_identity;
+
+/**
+ * @brief 프로세스 조회 공급자 인터페이스
+ * @details Win32 구현은 GetForegroundWindow/OpenProcess 등을 사용하며,
+ *          테스트와 벤치마크에서는 가짜 공급자로 교체할 수 있습니다.
+ */
+typedef struct process_lookup_provider {
+    /** @brief 공급자 구현이 사용하는 임의의 컨텍스트 */
+    void* context;
+    /**
+     * @brief 현재 포그라운드 창의 식별 정보를 가져옵니다.
+     * @return int 성공 시 1, 실패 시 0
+     */
+    int (*get_foreground)(void* context, foreground_identity* identity);
+    /**
+     * @brief 식별된 프로세스의 실행 파일 이름을 가져옵니다.
+     * @return int 성공 시 1, 실패 시 0
+     */
+    int (*get_process_name)(void* context, const foreground_identity* identity,
+                            char* name, size_t name_size);
+} process_lookup_provider;
+
+/**
+ * @brief 프로세스 이름이 허용 대상인지 판정하는 콜백
+ * @return int 차단이면 0, 허용이면 0이 아닌 값 (캐시에 그대로 보관되며 키 규칙 번호 + 1로 사용)
+ */
+typedef int (*process_verdict_fn)(const char* process_name, void* user);
+
+/**
+ * @brief 캐시 조회 결과
+ */
+typedef enum foreground_verdict {
+    FOREGROUND_UNKNOWN = 0, /**< 포그라운드 프로세스를 확인할 수 없음 */
+    FOREGROUND_BLOCKED,     /**< 허용되지 않은 프로세스 */
+    FOREGROUND_ALLOWED      /**< 허용된 프로세스 */
+} foreground_verdict;
+
+/**
+ * @brief 포그라운드 판정 캐시
+ * @details foreground_cache_invalidate()를 제외한 모든 함수는 후크 스레드에서만 호출합니다.
+ */
+typedef struct foreground_cache {
+    const process_lookup_provider* provider; /**< 프로세스 조회 공급자 */
+    process_verdict_fn verdict;              /**< 허용 여부 판정 콜백 */
+    void* verdict_user;                      /**< 판정 콜백에 전달할 사용자 데이터 */
+
+    unsigned long generation;        /**< 무효화 세대 (모든 스레드에서 증가 가능) */
+    unsigned long cached_generation; /**< 캐시가 유효한 세대 */
+    int valid;                       /**< 캐시된 판정이 존재하는지 여부 */
+    int allowed;                     /**< 캐시된 판정 콜백 결과 (0이면 차단, 그 외는 키 규칙 번호 + 1) */
+    int verify;                      /**< 포그라운드 변경 알림이 없어 키마다 포그라운드를 확인하는지 여부 */
+    foreground_identity identity;    /**< 캐시된 포그라운드 식별 정보 */
+    char process_name[FOREGROUND_NAME_SIZE]; /**< 캐시된 프로세스 이름 */
+
+    unsigned long hits;          /**< 세대 비교만으로 끝난 조회 수 */
+    unsigned long revalidations; /**< 같은 프로세스에 대해 판정만 다시 한 횟수 */
+    unsigned long lookups;       /**< 프로세스 이름까지 다시 조회한 횟수 */
+    unsigned long failures;      /**< 조회에 실패한 횟수 */
+    unsigned long verify_changes; /**< 키마다 확인하다가 포그라운드 변경을 찾아 무효화한 횟수 */
+} foreground_cache;
+
+/**
+ * @brief 캐시를 초기화합니다.
+ * @param cache 초기화할 캐시
+ * @param provider 프로세스 조회 공급자
+ * @param verdict 허용 여부 판정 콜백
+ * @param verdict_user 판정 콜백에 전달할 사용자 데이터
+ */
+void foreground_cache_init(foreground_cache* cache, const process_lookup_provider* provider,
+                           process_verdict_fn verdict, void* verdict_user);
+
+/**
+ * @brief 캐시를 무효화합니다.
+ * @details 포그라운드 변경 알림(EVENT_SYSTEM_FOREGROUND)이나 정책 변경 시 호출합니다.
+ *          세대 값만 원자적으로 증가시키므로 어느 스레드에서든 호출할 수 있습니다.
+ */
+void foreground_cache_invalidate(foreground_cache* cache);
+
+/**
+ * @brief 포그라운드 변경 알림 없이 키마다 포그라운드를 확인할지 설정합니다.
+ * @details 알림(EVENT_SYSTEM_FOREGROUND 등)을 등록하지 못하면 세대가 바뀌지 않아 첫 판정이 계속 쓰이므로,
+ *          이 모드에서는 조회할 때마다 공급자로 포그라운드 식별 정보를 가져와 캐시와 비교합니다.
+ *          후크 스레드가 키를 처리하기 전에 호출합니다.
+ */
+void foreground_cache_set_verify(foreground_cache* cache, int verify);
+
+/**
+ * @brief 확인 모드이면 포그라운드가 캐시와 같은지 확인하고, 다르면 캐시를 무효화합니다.
+ * @details 확인 모드가 아니면 아무것도 하지 않습니다. 세대만 비교하는 빠른 경로(자동 반복 등) 앞에서 호출합니다.
+ * @return int 무효화했으면 1, 아니면 0
+ */
+int foreground_cache_verify(foreground_cache* cache);
+
+/**
+ * @brief 현재 포그라운드 프로세스의 판정을 반환합니다.
+ * @details 캐시가 유효하면 세대 비교 한 번으로 캐시된 판정을 반환합니다. (확인 모드에서는 포그라운드 비교 뒤)
+ * @param cache 캐시
+ * @param process_name 프로세스 이름을 돌려받을 포인터 (NULL 가능, 캐시 내부 버퍼를 가리킴)
+ * @return foreground_verdict 판정 결과
+ */
+foreground_verdict foreground_cache_lookup(foreground_cache* cache, const char** process_name);
+
+#endif // FOREGROUND_CACHE_H
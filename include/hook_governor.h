@@ -0,0 +1,154 @@
+#ifndef HOOK_GOVERNOR_H
+#define HOOK_GOVERNOR_H
+
+#include <stdint.h>
+
+/**
+ * @file hook_governor.h
+ * @brief 후크 지연 예산 관리자와 후크 감시(워치독) 판정 로직
+ * @details Windows는 저수준 후크가 LowLevelHooksTimeout을 넘기면 알리지 않고 후크를 제거합니다.
+ *          이 모듈은 키 입력 지연 표본과 후크 심장 박동(마지막 후크 호출 시각)을 모아 두었다가,
+ *          감시 스레드가 주기적으로 hook_governor_tick()을 호출하면 다음을 판정합니다.
+ *
+ *          - 지연 예산: 구간 최대 지연이 예산을 넘으면 한 단계씩 부가 작업을 줄이고(degrade),
+ *            예산의 절반 이하인 구간이 이어지면 한 단계씩 되돌립니다. 후크 제한 시간의 절반을 넘으면
+ *            바로 가장 낮은 단계로 내립니다.
+ *          - 후크 생존: 후크가 마지막으로 호출된 뒤에 시스템 입력이 있었는데 유예 시간이 지나도록 후크가
+ *            호출되지 않으면 탐침 키를 보내게 하고, 탐침도 후크에 도착하지 않으면 재설치를 요청합니다.
+ *
+ *          시각은 모두 호출자가 넘기는 나노초 값이므로 가상 시계로 Linux에서 그대로 시험할 수 있습니다.
+ *          hook_governor_heartbeat()/hook_governor_sample()은 후크/작업 스레드에서,
+ *          hook_governor_tick()과 hook_governor_reinstalled()는 감시 스레드 하나에서만 호출합니다.
+ */
+
+/** @brief 기본 지연 예산 (마이크로초) */
+#define HOOK_GOVERNOR_DEFAULT_BUDGET_US 2000
+
+/** @brief 예산 안으로 돌아온 구간이 이만큼 이어지면 한 단계 복구 */
+#define HOOK_GOVERNOR_RECOVER_WINDOWS 5
+
+/** @brief 입력 뒤 후크 호출을 기다리는 기본 유예 시간 (밀리초) */
+#define HOOK_GOVERNOR_STALL_MS 1000
+
+/** @brief 탐침 키가 후크에 도착하기를 기다리는 시간 (밀리초) */
+#define HOOK_GOVERNOR_PROBE_TIMEOUT_MS 500
+
+/** @brief 탐침 사이의 최소 간격 (밀리초, 마우스 입력만 있을 때 탐침이 잦아지지 않도록 제한) */
+#define HOOK_GOVERNOR_PROBE_INTERVAL_MS 5000
+
+/**
+ * @brief 부가 작업 축소 단계 (숫자가 클수록 더 많이 줄임)
+ */
+typedef enum hook_degrade_level {
+    HOOK_LEVEL_NORMAL = 0,       /**< 모든 기능 동작 */
+    HOOK_LEVEL_QUIET_LOG,        /**< 허용된 키의 상세 로그 생략 (차단/조회 실패만 기록) */
+    HOOK_LEVEL_LIGHT_LOOKUP,     /**< 포그라운드 창과 PID가 같으면 프로세스를 다시 열지 않음 */
+    HOOK_LEVEL_COUNT
+} hook_degrade_level;
+
+/**
+ * @brief hook_governor_tick()이 요청하는 조치
+ */
+typedef enum hook_governor_action {
+    HOOK_ACTION_NONE = 0,    /**< 할 일 없음 */
+    HOOK_ACTION_PROBE,       /**< 후크가 받을 탐침 키를 보낼 것 */
+    HOOK_ACTION_REINSTALL    /**< 후크가 제거된 것으로 보이므로 다시 설치할 것 */
+} hook_governor_action;
+
+/**
+ * @brief 관리자 설정
+ */
+typedef struct hook_governor_config {
+    uint64_t budget_ns;          /**< 키 입력 하나의 지연 예산 */
+    uint64_t timeout_ns;         /**< 시스템 후크 제한 시간 (LowLevelHooksTimeout) */
+    uint64_t stall_ns;           /**< 입력 뒤 후크 호출을 기다리는 유예 시간 */
+    uint64_t probe_timeout_ns;   /**< 탐침 도착 제한 시간 */
+    uint64_t probe_interval_ns;  /**< 탐침 사이 최소 간격 */
+    unsigned int recover_windows;/**< 한 단계 복구에 필요한 연속 안정 구간 수 */
+} hook_governor_config;
+
+/**
+ * @brief 관리자 상태
+ */
+typedef struct hook_governor {
+    hook_governor_config config;     /**< 설정 (budget_ns는 실행 중 바뀔 수 있음) */
+
+    // 후크/작업 스레드가 갱신 (감시 스레드가 구간마다 가져가며 0으로 되돌림)
+    uint64_t heartbeat_ns;           /**< 마지막 후크 호출 시각 */
+    uint64_t window_max_ns;          /**< 이번 구간 최대 지연 */
+    unsigned long window_samples;    /**< 이번 구간 표본 수 */
+    unsigned long window_over;       /**< 이번 구간에 예산을 넘은 표본 수 */
+
+    // 감시 스레드 소유
+    int level;                       /**< 현재 hook_degrade_level (다른 스레드는 hook_governor_level()로 읽음) */
+    unsigned int calm_windows;       /**< 연속 안정 구간 수 */
+    int probing;                     /**< 탐침 응답을 기다리는 중인지 여부 */
+    uint64_t probe_sent_ns;          /**< 마지막 탐침 시각 */
+    uint64_t last_window_max_ns;     /**< 직전 구간 최대 지연 (보고용) */
+
+    // 누적 카운터 (감시 스레드가 갱신, 다른 스레드는 느슨하게 읽음)
+    unsigned long over_budget;       /**< 예산을 넘은 표본 수 */
+    unsigned long timeout_risks;     /**< 후크 제한 시간의 절반을 넘은 구간 수 */
+    unsigned long degradations;      /**< 단계를 내린 횟수 */
+    unsigned long recoveries;        /**< 단계를 되돌린 횟수 */
+    unsigned long probes;            /**< 보낸 탐침 수 */
+    unsigned long reinstalls;        /**< 요청한 재설치 수 */
+} hook_governor;
+
+/**
+ * @brief 기본 설정을 채웁니다.
+ * @param config 채울 설정
+ * @param timeout_ms 시스템 후크 제한 시간 (밀리초)
+ * @param budget_us 지연 예산 (마이크로초, 0이면 HOOK_GOVERNOR_DEFAULT_BUDGET_US)
+ */
+void hook_governor_default_config(hook_governor_config* config, uint32_t timeout_ms, uint32_t budget_us);
+
+/**
+ * @brief 관리자를 초기화합니다.
+ * @param governor 관리자 상태
+ * @param config 설정
+ * @param now_ns 현재 시각 (첫 심장 박동으로 사용)
+ */
+void hook_governor_init(hook_governor* governor, const hook_governor_config* config, uint64_t now_ns);
+
+/**
+ * @brief 지연 예산을 바꿉니다. (정책 리로드 시, 어느 스레드에서든 호출 가능)
+ */
+void hook_governor_set_budget(hook_governor* governor, uint64_t budget_ns);
+
+/**
+ * @brief 후크가 호출되었음을 기록합니다. (후크 스레드)
+ */
+void hook_governor_heartbeat(hook_governor* governor, uint64_t now_ns);
+
+/**
+ * @brief 키 입력 하나의 지연 표본을 기록합니다. (후크/작업 스레드)
+ * @details 원자적 읽기/쓰기 몇 번만 하므로 후크 안에서 호출해도 됩니다.
+ */
+void hook_governor_sample(hook_governor* governor, uint64_t latency_ns);
+
+/**
+ * @brief 구간을 마감하고 단계와 후크 생존을 판정합니다. (감시 스레드)
+ * @param governor 관리자 상태
+ * @param now_ns 현재 시각
+ * @param last_input_ns 시스템이 마지막으로 입력을 받은 시각 (모르면 0)
+ * @return hook_governor_action 호출자가 수행할 조치
+ */
+hook_governor_action hook_governor_tick(hook_governor* governor, uint64_t now_ns, uint64_t last_input_ns);
+
+/**
+ * @brief 후크를 다시 설치했음을 기록합니다. (감시 상태 초기화)
+ */
+void hook_governor_reinstalled(hook_governor* governor, uint64_t now_ns);
+
+/**
+ * @brief 현재 축소 단계를 반환합니다. (어느 스레드에서든 호출 가능)
+ */
+hook_degrade_level hook_governor_level(const hook_governor* governor);
+
+/**
+ * @brief 축소 단계 이름을 반환합니다.
+ */
+const char* hook_governor_level_name(hook_degrade_level level);
+
+#endif // HOOK_GOVERNOR_H
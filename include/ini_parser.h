@@ -0,0 +1,82 @@
+#ifndef INI_PARSER_H
+#define INI_PARSER_H
+
+#include <stddef.h>
+
+/**
+ * @file ini_parser.h
+ * @brief 복사 없는 단일 패스 INI 파서
+ * @details 파일 전체를 한 번 읽은 버퍼를 처음부터 끝까지 한 번만 훑으며, 섹션/키/값을
+ *          원본 버퍼를 가리키는 슬라이스로 콜백에 넘깁니다. GetPrivateProfileStringA처럼
+ *          키마다 파일을 다시 열고 훑지 않으므로 항목 수에 비례하는 시간에 로드됩니다.
+ *
+ * 지원 문법:
+ * - `[섹션]` 헤더 (여러 섹션, 같은 섹션 반복 허용)
+ * - `키=값` 항목 (키 이름 제한 없음, 앞뒤 공백 제거, 값을 감싼 큰따옴표 제거)
+ * - `;` 또는 `#`으로 시작하는 주석 줄, 빈 줄, UTF-8 BOM, CRLF 줄바꿈
+ */
+
+/**
+ * @brief 원본 버퍼의 일부를 가리키는 문자열 조각 (NUL 종료 아님)
+ */
+typedef struct ini_slice {
+    const char* ptr; /**< 시작 위치 */
+    size_t len;      /**< 길이 */
+} ini_slice;
+
+/**
+ * @brief 파싱된 항목 하나
+ */
+typedef struct ini_entry {
+    ini_slice section; /**< 항목이 속한 섹션 이름 (섹션 헤더 전이면 빈 슬라이스) */
+    ini_slice key;     /**< 키 이름 */
+    ini_slice value;   /**< 값 */
+    int line;          /**< 1부터 시작하는 줄 번호 */
+} ini_entry;
+
+/**
+ * @brief 파싱 콜백 묶음
+ */
+typedef struct ini_handler {
+    /**
+     * @brief 항목마다 호출됩니다.
+     * @return int 계속하려면 1, 파싱을 멈추려면 0
+     */
+    int (*entry)(void* user, const ini_entry* entry);
+    /**
+     * @brief 잘못된 줄마다 호출됩니다. (NULL 가능, 해당 줄은 건너뜀)
+     */
+    void (*error)(void* user, int line, const char* message);
+    void* user; /**< 콜백에 전달할 사용자 데이터 */
+} ini_handler;
+
+/**
+ * @brief 버퍼를 한 번에 파싱합니다.
+ * @param data INI 파일 내용 (NUL 종료 필요 없음)
+ * @param size 내용 길이
+ * @param handler 콜백 묶음
+ * @return int 잘못된 줄의 수, 콜백이 파싱을 멈췄으면 -1
+ */
+int ini_parse(const char* data, size_t size, const ini_handler* handler);
+
+/**
+ * @brief 슬라이스가 문자열과 대소문자 구분 없이 같은지 비교합니다.
+ * @return int 같으면 1
+ */
+int ini_slice_equals(ini_slice slice, const char* text);
+
+/**
+ * @brief 슬라이스를 NUL 종료 문자열로 복사합니다. (버퍼보다 길면 잘림)
+ * @return size_t 복사한 길이
+ */
+size_t ini_slice_copy(ini_slice slice, char* buffer, size_t buffer_size);
+
+/**
+ * @brief 파일 전체를 한 번에 읽어 새 버퍼로 반환합니다.
+ * @param path 파일 경로
+ * @param size 읽은 길이를 돌려받을 포인터
+ * @return char* 파일 내용 (free로 해제), 파일을 열 수 없으면 NULL
+ */
+char* ini_read_file(const char* path, size_t* size);
+
+#endif // INI_PARSER_H
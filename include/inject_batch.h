@@ -0,0 +1,160 @@
+#ifndef INJECT_BATCH_H
+#define INJECT_BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file inject_batch.h
+ * @brief 키 주입 묶음 처리
+ * @details 복호화된 키를 하나씩 SendInput(1, ...)으로 주입하면 키마다 시스템 호출과 입력 큐 왕복이 한 번씩
+ *          생기므로, 작업 스레드가 한 번 깨어나 처리하는 동안의 키를 모아 출력 함수 한 번으로 내보냅니다.
+ *
+ *          다음 중 하나가 되면 모은 키를 내보내며, 내보내는 순서는 항상 넣은 순서와 같습니다.
+ *          - 크기: 모은 키가 limit개가 됨
+ *          - 기한: 첫 키를 넣은 뒤 max_delay_ns가 지남 (밀린 큐를 처리하는 동안에도 지연이 쌓이지 않도록)
+ *          - 포그라운드 변경: 다른 창으로 갈 키가 들어옴 (이전 창의 키가 새 창에 가지 않도록)
+ *          - 유휴: 작업 스레드의 큐가 비어 잠들기 직전 (호출자가 inject_batch_flush 호출)
+ *
+ *          유니코드 경로를 켜면 Ctrl/Alt/Win이 눌려 있지 않은 동안의 문자 키를 출력 함수가 바꿔 준 문자로
+ *          내보냅니다. (Win32: KEYEVENTF_UNICODE) 키 업은 키 다운 때 쓴 문자로 내보냅니다.
+ *          묶음 안의 키는 아직 주입 전이므로 시스템의 Caps Lock 상태 대신, 넣은 Caps Lock 키 다운으로
+ *          켜짐/꺼짐을 직접 따라가서 출력 함수에 넘깁니다.
+ *
+ *          출력은 inject_sink 인터페이스 뒤에 있으므로 Linux에서도 기록용 가짜 출력으로 시험하고 측정할 수 있습니다.
+ *          작업 스레드 하나에서만 사용합니다.
+ */
+
+/** @brief 묶음 하나의 최대 키 수 */
+#define INJECT_BATCH_CAPACITY 64
+
+/** @brief 기본 묶음 크기 ([Injection] BatchSize가 0일 때) */
+#define INJECT_BATCH_DEFAULT_LIMIT 16
+
+/** @brief 기본 묶음 기한 ([Injection] BatchDelayUs가 0일 때) */
+#define INJECT_BATCH_DEFAULT_DELAY_NS 1000000ULL
+
+/** @brief Caps Lock 가상 키 코드 (VK_CAPITAL) */
+#define INJECT_VK_CAPITAL 0x14u
+
+/** @brief 키 업 */
+#define INJECT_KEY_UP 0x1u
+
+/** @brief 가상 키 코드 대신 문자로 주입 (Win32: KEYEVENTF_UNICODE) */
+#define INJECT_KEY_UNICODE 0x2u
+
+/**
+ * @brief 주입할 키 하나
+ */
+typedef struct inject_key {
+    uint16_t vk_code;   /**< 가상 키 코드 (유니코드 키는 원래 가상 키 코드) */
+    uint16_t unicode;   /**< UTF-16 문자 (INJECT_KEY_UNICODE일 때) */
+    uint32_t flags;     /**< INJECT_KEY_* 값 */
+} inject_key;
+
+/**
+ * @brief 묶음을 내보낸 이유
+ */
+typedef enum inject_flush_reason {
+    INJECT_FLUSH_SIZE = 0,     /**< 묶음이 가득 참 */
+    INJECT_FLUSH_DEADLINE,     /**< 첫 키의 기한이 지남 */
+    INJECT_FLUSH_FOREGROUND,   /**< 주입 대상 창이 바뀜 */
+    INJECT_FLUSH_IDLE,         /**< 작업 스레드가 잠들기 직전이거나 호출자가 요청함 */
+    INJECT_FLUSH_REASON_COUNT
+} inject_flush_reason;
+
+/**
+ * @brief 묶음을 받는 출력
+ */
+typedef struct inject_sink {
+    void* context;  /**< 출력 함수에 넘길 사용자 데이터 */
+    /**
+     * @brief 키를 순서대로 주입합니다. (Win32: SendInput(count, ...))
+     * @return size_t 주입한 키 수 (앞에서부터)
+     */
+    size_t (*send)(void* context, const inject_key* keys, size_t count);
+    /**
+     * @brief 가상 키 코드를 현재 자판 배열의 문자로 바꿉니다. (NULL이면 유니코드 경로를 쓰지 않음)
+     * @param shift Shift가 눌려 있는지 여부
+     * @param caps_lock 이 키까지 주입한 키 기준으로 Caps Lock이 켜져 있는지 여부
+     * @return unsigned int UTF-16 문자, 문자가 아니거나 바꿀 수 없으면 0
+     */
+    unsigned int (*translate)(void* context, unsigned int vk_code, int shift, int caps_lock);
+} inject_sink;
+
+/**
+ * @brief 묶음 처리 통계
+ */
+typedef struct inject_batch_stats {
+    unsigned long keys;            /**< 넣은 키 수 */
+    unsigned long sends;           /**< 출력 함수 호출 수 */
+    unsigned long flushes[INJECT_FLUSH_REASON_COUNT]; /**< 이유별로 내보낸 횟수 */
+    unsigned long unicode_keys;    /**< 문자로 바꾸어 넣은 키 수 */
+    unsigned long failed;          /**< 출력 함수가 주입하지 못한 키 수 */
+    unsigned long max_batch;       /**< 한 번에 내보낸 최대 키 수 */
+} inject_batch_stats;
+
+/**
+ * @brief 묶음 처리 상태 (작업 스레드 전용)
+ */
+typedef struct inject_batch {
+    inject_key keys[INJECT_BATCH_CAPACITY]; /**< 모은 키 (넣은 순서) */
+    size_t count;                  /**< 모은 키 수 */
+    size_t limit;                  /**< 묶음 크기 (1이면 모으지 않음) */
+    unsigned long long max_delay_ns; /**< 첫 키부터 내보낼 때까지의 최대 시간 */
+    unsigned long long deadline_ns;  /**< 모은 키를 내보낼 기한 (모은 키가 없으면 0) */
+    uint64_t target;               /**< 모은 키의 주입 대상 (포그라운드 창) */
+    int unicode;                   /**< 유니코드 경로 사용 여부 */
+    unsigned int held_modifiers;   /**< 주입한 키 기준으로 눌려 있는 조합 키 (key_modifier_key 마스크) */
+    int caps_lock;                 /**< 주입한 키 기준 Caps Lock 켜짐 여부 */
+    int caps_down;                 /**< Caps Lock 키가 눌려 있는지 여부 (자동 반복은 켜짐/꺼짐을 바꾸지 않음) */
+    uint16_t unicode_down[256];    /**< 문자로 주입한 키 다운의 문자 (가상 키 코드별, 키 업에 사용) */
+    inject_sink sink;              /**< 출력 */
+    inject_batch_stats stats;      /**< 통계 */
+} inject_batch;
+
+/**
+ * @brief 묶음 처리 상태를 초기화합니다.
+ * @param limit 묶음 크기 (0이면 기본값, INJECT_BATCH_CAPACITY보다 크면 잘림)
+ * @param max_delay_ns 묶음 기한 (0이면 기본값)
+ */
+void inject_batch_init(inject_batch* batch, const inject_sink* sink, size_t limit, unsigned long long max_delay_ns);
+
+/**
+ * @brief 묶음 크기, 기한, 유니코드 경로를 바꿉니다. (정책이 바뀔 때)
+ * @details 줄어든 크기보다 많이 모여 있으면 먼저 내보냅니다.
+ */
+void inject_batch_configure(inject_batch* batch, size_t limit, unsigned long long max_delay_ns, int unicode);
+
+/**
+ * @brief 시작할 때의 Caps Lock 켜짐 여부를 설정합니다. (이후에는 넣은 키로 따라감)
+ */
+void inject_batch_set_caps_lock(inject_batch* batch, int on);
+
+/**
+ * @brief 키 하나를 묶음에 넣습니다.
+ * @details 대상이 바뀌었으면 모은 키를 먼저 내보내고, 넣은 뒤 묶음이 가득 찼거나 기한이 지났으면 바로 내보냅니다.
+ * @param target 주입 대상 (포그라운드 창 식별 값)
+ * @param now_ns 현재 시각
+ * @return int 항상 1 (주입 실패는 내보낼 때 통계에 셈)
+ */
+int inject_batch_add(inject_batch* batch, unsigned int vk_code, int key_down, uint64_t target,
+                     unsigned long long now_ns);
+
+/**
+ * @brief 모은 키를 모두 내보냅니다.
+ * @return size_t 주입한 키 수
+ */
+size_t inject_batch_flush(inject_batch* batch, inject_flush_reason reason);
+
+/**
+ * @brief 기한이 지났으면 모은 키를 내보냅니다.
+ */
+void inject_batch_poll(inject_batch* batch, unsigned long long now_ns);
+
+/**
+ * @brief 내보낸 이유의 이름을 반환합니다.
+ */
+const char* inject_flush_reason_name(inject_flush_reason reason);
+
+#endif // INJECT_BATCH_H
@@ -0,0 +1,166 @@
+#ifndef INPUT_CORRELATOR_H
+#define INPUT_CORRELATOR_H
+
+#include <stdint.h>
+#include "key_pipeline.h"
+
+/**
+ * @file input_correlator.h
+ * @brief Raw Input 이벤트와 후크 이벤트 짝짓기
+ * @details 같은 키 입력이 저수준 후크(장치 정보 없음)와 WM_INPUT(장치 핸들 있음)으로 한 번씩 들어오므로,
+ *          스캔 코드와 키 다운/업이 같은 이벤트끼리 들어온 순서대로 짝지어 후크 이벤트에 장치를 붙입니다.
+ *
+ *          두 알림의 순서는 Windows 버전과 후크 체인에 따라 다르므로 양쪽을 모두 처리합니다.
+ *          - Raw Input이 먼저 오면: 짝을 기다리는 Raw Input 큐에서 찾아 후크 이벤트를 바로 내보냅니다.
+ *          - 후크가 먼저 오면: 짝을 찾지 못한 후크 이벤트를 장치 미상으로 바로 내보내되, 늦게 온 Raw Input이
+ *            방금 내보낸 이벤트의 짝이면 그 지연을 학습합니다. 늦은 짝이 계속 보이면 후크 이벤트를
+ *            최대 hold_ns 동안 붙잡아 두었다가 짝이 오면 장치와 함께 내보내고, 붙잡은 이벤트가 계속 짝 없이
+ *            만료되면(후크가 차단한 키에는 WM_INPUT이 오지 않는 환경 등) 다시 붙잡지 않습니다.
+ *          - 장치 규칙이 키를 차단할 수 있으면(input_correlator_require_hold) 학습을 기다리지 않고 처음부터
+ *            최대 시간만큼 붙잡으며, 만료가 이어져도 붙잡기를 끄지 않습니다.
+ *
+ *          붙잡힌 이벤트 뒤의 후크 이벤트도 함께 붙잡으므로 내보내는 순서는 항상 후크 순서와 같습니다.
+ *          시각은 호출자가 넘기고 스레드 하나(이벤트 루프)에서만 호출하므로 Linux에서 결정적으로 시험할 수 있습니다.
+ */
+
+/** @brief 후크 이벤트 대기열 크기 (2의 거듭제곱) */
+#define INPUT_CORRELATOR_PENDING 64
+
+/** @brief 짝을 기다리는 Raw Input 수 (2의 거듭제곱) */
+#define INPUT_CORRELATOR_RAW 32
+
+/** @brief 장치 미상으로 내보낸 뒤 늦은 짝을 확인할 최근 후크 이벤트 수 (2의 거듭제곱) */
+#define INPUT_CORRELATOR_RECENT 16
+
+/** @brief 짝을 찾을 최대 시각 차이 */
+#define INPUT_CORRELATOR_WINDOW_NS 50000000ULL
+
+/** @brief 후크 이벤트를 붙잡는 최대 시간 */
+#define INPUT_CORRELATOR_MAX_HOLD_NS 4000000ULL
+
+/** @brief 후크 이벤트를 붙잡는 최소 시간 */
+#define INPUT_CORRELATOR_MIN_HOLD_NS 200000ULL
+
+/** @brief 붙잡기를 켜거나 끄기 전에 확인할 늦은 짝(또는 만료) 수 */
+#define INPUT_CORRELATOR_LEARN 8
+
+/** @brief 스캔 코드와 확장 키 플래그(E0)를 합친 짝짓기 키 (가상 키 코드는 왼쪽/오른쪽 Shift 표기가 서로 다름) */
+#define INPUT_SCAN_KEY(scan_code, extended) (((scan_code) & 0xFFu) | ((extended) ? 0x100u : 0u))
+
+/** @brief 비어 있는 짝짓기 키 (후크 이벤트에 넘기면 Raw Input이 오지 않는 주입된 키로 보고 짝을 찾지 않음) */
+#define INPUT_SCAN_KEY_NONE 0xFFFFFFFFu
+
+/**
+ * @brief 짝짓기에 쓰는 입력 하나
+ */
+typedef struct input_key {
+    unsigned long long time_ns;  /**< 알림을 받은 시각 */
+    uintptr_t device;            /**< 장치 핸들 (후크 이벤트는 0) */
+    unsigned int scan_key;       /**< INPUT_SCAN_KEY 값 */
+    unsigned int key_down;       /**< 키 다운 여부 */
+} input_key;
+
+/**
+ * @brief 짝을 기다리는 후크 이벤트
+ */
+typedef struct input_pending {
+    key_event event;             /**< 후크 이벤트 */
+    input_key key;               /**< 짝짓기 정보 (짝을 찾으면 device가 채워짐) */
+    unsigned long long deadline_ns; /**< 이 시각까지 짝이 없으면 장치 미상으로 내보냄 */
+    int matched;                 /**< 짝을 찾았는지 여부 */
+} input_pending;
+
+/**
+ * @brief 짝짓기가 끝난 후크 이벤트를 받는 함수 (후크 순서대로 호출)
+ * @param event 후크 이벤트
+ * @param device 장치 핸들 (짝이 없으면 0)
+ * @param user 사용자 데이터
+ */
+typedef void (*input_release_fn)(const key_event* event, uintptr_t device, void* user);
+
+/**
+ * @brief 짝짓기 통계
+ */
+typedef struct input_correlator_stats {
+    unsigned long hook_events;   /**< 후크 이벤트 수 */
+    unsigned long injected;      /**< 짝을 찾지 않은 주입된 후크 이벤트 수 */
+    unsigned long raw_events;    /**< Raw Input 이벤트 수 (장치 핸들이 있는 것만) */
+    unsigned long early_matches; /**< Raw Input이 먼저 와서 바로 짝지은 수 */
+    unsigned long held_matches;  /**< 붙잡아 둔 후크 이벤트에 늦은 Raw Input이 짝지어진 수 */
+    unsigned long late_matches;  /**< 이미 장치 미상으로 내보낸 이벤트의 짝이 늦게 온 수 (학습용) */
+    unsigned long unmatched;     /**< 장치 미상으로 내보낸 후크 이벤트 수 */
+    unsigned long expired;       /**< 붙잡았지만 짝 없이 만료된 후크 이벤트 수 */
+    unsigned long stale_raw;     /**< 짝 없이 버린 Raw Input 수 */
+    unsigned long overflows;     /**< 대기열이 가득 차 바로 내보낸 횟수 */
+    unsigned long hold_changes;  /**< 붙잡기를 켜거나 끈 횟수 */
+    unsigned long long max_late_ns; /**< 관측한 최대 늦은 짝 지연 */
+} input_correlator_stats;
+
+/**
+ * @brief 짝짓기 상태 (이벤트 루프 스레드 전용)
+ */
+typedef struct input_correlator {
+    input_pending pending[INPUT_CORRELATOR_PENDING]; /**< 후크 순서대로 붙잡은 이벤트 */
+    unsigned int pending_head;   /**< 가장 오래된 이벤트 위치 */
+    unsigned int pending_count;  /**< 붙잡은 이벤트 수 */
+    input_key raw[INPUT_CORRELATOR_RAW]; /**< 짝을 기다리는 Raw Input (도착 순서) */
+    unsigned int raw_head;       /**< 가장 오래된 Raw Input 위치 */
+    unsigned int raw_count;      /**< Raw Input 수 */
+    input_key recent[INPUT_CORRELATOR_RECENT]; /**< 장치 미상으로 내보낸 최근 후크 이벤트 */
+    unsigned int recent_next;    /**< 다음에 덮어쓸 위치 */
+    unsigned long long hold_ns;  /**< 후크 이벤트를 붙잡는 시간 (0이면 붙잡지 않음) */
+    unsigned long learn_late;    /**< 붙잡기를 켜기 위해 센 늦은 짝 수 */
+    unsigned long learn_expired; /**< 붙잡기를 끄기 위해 센 만료 수 (짝을 찾으면 줄어듦) */
+    int hold_required;           /**< 장치 규칙이 붙잡기를 요구하는지 여부 (학습으로 끄지 않음) */
+    input_release_fn release;    /**< 내보내기 함수 */
+    void* user;                  /**< 내보내기 함수 사용자 데이터 */
+    input_correlator_stats stats; /**< 통계 */
+} input_correlator;
+
+/**
+ * @brief 짝짓기 상태를 초기화합니다. (붙잡기 꺼짐)
+ */
+void input_correlator_init(input_correlator* correlator, input_release_fn release, void* user);
+
+/**
+ * @brief 장치를 알기 전에 후크 이벤트를 넘기면 안 되는지 설정합니다. (장치 규칙이 바뀔 때)
+ * @details 요구하면 붙잡기 시간을 INPUT_CORRELATOR_MAX_HOLD_NS로 켜고, 요구가 풀리면 붙잡기를 끄고 다시 학습합니다.
+ *          이미 붙잡은 이벤트의 기한은 바꾸지 않습니다.
+ * @param required 0이 아니면 붙잡기 요구
+ */
+void input_correlator_require_hold(input_correlator* correlator, int required);
+
+/**
+ * @brief 후크 이벤트 하나를 넣습니다.
+ * @details 짝이 이미 있거나 붙잡을 필요가 없으면 이 안에서 release가 호출됩니다.
+ *          주입된 키는 붙잡지 않지만, 앞에 붙잡힌 이벤트가 있으면 순서를 지키기 위해 그 뒤에 내보냅니다.
+ * @param scan_key INPUT_SCAN_KEY 값 (주입된 키는 INPUT_SCAN_KEY_NONE)
+ * @param now_ns 현재 시각
+ */
+void input_correlator_hook(input_correlator* correlator, const key_event* event, unsigned int scan_key,
+                           unsigned long long now_ns);
+
+/**
+ * @brief Raw Input 이벤트 하나를 넣습니다.
+ * @param device 장치 핸들 (0이면 주입된 입력이므로 무시)
+ */
+void input_correlator_raw(input_correlator* correlator, uintptr_t device, unsigned int scan_key, int key_down,
+                          unsigned long long now_ns);
+
+/**
+ * @brief 기한이 지난 후크 이벤트를 장치 미상으로 내보냅니다.
+ */
+void input_correlator_expire(input_correlator* correlator, unsigned long long now_ns);
+
+/**
+ * @brief 다음으로 만료될 후크 이벤트의 기한을 반환합니다.
+ * @return unsigned long long 기한, 붙잡은 이벤트가 없으면 0
+ */
+unsigned long long input_correlator_deadline(const input_correlator* correlator);
+
+/**
+ * @brief 붙잡은 이벤트를 모두 내보냅니다. (종료 시)
+ */
+void input_correlator_flush(input_correlator* correlator);
+
+#endif // INPUT_CORRELATOR_H
@@ -0,0 +1,193 @@
+#ifndef KEY_DELIVERY_H
+#define KEY_DELIVERY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "kp_platform.h"
+#include "control_channel.h"
+
+/**
+ * @file key_delivery.h
+ * @brief 협력 애플리케이션용 공유 메모리 키 입력 전달 링
+ * @details 구독한 애플리케이션이 포그라운드일 때, 처리 코어는 복호화한 키를 SendInput으로 다시 주입하는 대신
+ *          애플리케이션 전용 공유 메모리 링에 채널 키로 암호화한 레코드를 넣습니다. 애플리케이션에 링크된
+ *          클라이언트가 프로세스 안에서 복호화하므로 평문 키가 입력 스택이나 다른 저수준 후크를 거치지 않습니다.
+ *
+ *          - 채널 키(256비트)와 논스는 채널마다 새로 만들며, 제어 채널 응답으로만 구독자에게 전달됩니다.
+ *          - 레코드 n의 암호화 워드는 ChaCha20(채널 키, 스트림 KEY_DELIVERY_STREAM, 논스) 블록 n/16의 n%16번째 워드입니다.
+ *          - 링은 단일 생산자/단일 소비자이며 잠금 없이 head/tail 순번만 주고받습니다. 링이 가득 차면 생산자는
+ *            기다리지 않고 레코드를 버립니다(dropped).
+ *          - 소비자는 잠들기 전에만 waiting을 세우고, 생산자는 waiting을 내린 경우에만 이벤트를 신호합니다.
+ *            따라서 붙여넣기처럼 몰려 오는 키는 깨우기 한 번으로 한꺼번에 읽힙니다.
+ */
+
+/** @brief 링 표식 ("KPDV") */
+#define KEY_DELIVERY_MAGIC 0x5644504BUL
+
+/** @brief 링 배치 버전 */
+#define KEY_DELIVERY_VERSION 1
+
+/** @brief 링 레코드 수 (2의 거듭제곱) */
+#define KEY_DELIVERY_CAPACITY 1024
+
+/** @brief 전달 채널이 쓰는 키스트림 스트림 번호 (0, 1은 세션 키스트림 풀이 사용) */
+#define KEY_DELIVERY_STREAM 2
+
+/** @brief 공유 메모리/이벤트 이름 최대 길이 */
+#define KEY_DELIVERY_NAME_SIZE 48
+
+/** @brief 생산자와 소비자 필드를 나누는 캐시 라인 크기 */
+#define KEY_DELIVERY_CACHE_LINE 64
+
+/**
+ * @brief 링 레코드 (16바이트)
+ */
+typedef struct key_delivery_record {
+    uint32_t encrypted;  /**< 가상 키 코드 ^ 채널 키스트림 워드 */
+    uint32_t message;    /**< KEY_MESSAGE_KEYDOWN 또는 KEY_MESSAGE_KEYUP */
+    uint32_t time_ms;    /**< 생산자 단조 시계 (밀리초, 하위 32비트) */
+    uint32_t reserved;   /**< 예약 (0) */
+} key_delivery_record;
+
+/**
+ * @brief 공유 메모리 링 배치
+ * @details 순번(head, tail)은 32비트로 넘침을 허용하며 차이로 크기를 계산합니다.
+ *          채널 하나로 2^32 - 1개 레코드를 보낸 뒤에는 키스트림을 재사용하지 않도록 채널을 닫습니다.
+ */
+typedef struct key_delivery_ring {
+    uint32_t magic;          /**< KEY_DELIVERY_MAGIC (모든 필드를 초기화한 뒤 마지막에 기록) */
+    uint32_t version;        /**< KEY_DELIVERY_VERSION */
+    uint32_t capacity;       /**< 레코드 수 */
+    uint32_t record_size;    /**< sizeof(key_delivery_record) */
+    uint32_t producer_pid;   /**< 생산자 프로세스 ID */
+    uint32_t consumer_pid;   /**< 구독한 프로세스 ID */
+    uint32_t nonce;          /**< 채널 논스 (키는 공유 메모리에 두지 않음) */
+    uint32_t closed;         /**< 생산자가 채널을 닫았으면 1 */
+    char pad0[KEY_DELIVERY_CACHE_LINE - 8 * sizeof(uint32_t)];
+    uint32_t head;           /**< 다음에 쓸 순번 (생산자 소유) */
+    uint32_t dropped;        /**< 링이 가득 차서 버린 레코드 수 (생산자 소유) */
+    uint32_t wakeups;        /**< 소비자를 깨운 횟수 (생산자 소유) */
+    char pad1[KEY_DELIVERY_CACHE_LINE - 3 * sizeof(uint32_t)];
+    uint32_t tail;           /**< 다음에 읽을 순번 (소비자 소유) */
+    uint32_t waiting;        /**< 소비자가 잠들려는 중이면 1 (소비자가 세우고 생산자가 내림) */
+    char pad2[KEY_DELIVERY_CACHE_LINE - 2 * sizeof(uint32_t)];
+    key_delivery_record records[KEY_DELIVERY_CAPACITY]; /**< 레코드 */
+} key_delivery_ring;
+
+/**
+ * @brief 구독 승인 정보 (제어 채널 CONTROL_SUBSCRIBE 응답 본문)
+ */
+typedef struct key_delivery_grant {
+    char name[KEY_DELIVERY_NAME_SIZE]; /**< 공유 메모리 이름 (이벤트 이름은 뒤에 ".wake") */
+    uint32_t key[8];                   /**< 채널 키 */
+    uint32_t nonce;                    /**< 채널 논스 */
+    uint32_t capacity;                 /**< 링 레코드 수 */
+} key_delivery_grant;
+
+/**
+ * @brief 채널 키스트림 워드 캐시 (순번이 같은 블록에 있는 동안 다시 생성하지 않음)
+ */
+typedef struct key_delivery_cipher {
+    uint32_t key[8];         /**< 채널 키 */
+    uint32_t nonce;          /**< 채널 논스 */
+    uint32_t block_index;    /**< 캐시된 블록 번호 */
+    int block_valid;         /**< 캐시된 블록이 있는지 여부 */
+    uint32_t block[16];      /**< 캐시된 키스트림 블록 */
+} key_delivery_cipher;
+
+/**
+ * @brief 생산자 쪽 채널
+ */
+typedef struct key_delivery_channel {
+    kp_shared_memory memory;     /**< 링 공유 메모리 */
+    kp_named_event event;        /**< 소비자 깨우기 이벤트 */
+    key_delivery_ring* ring;     /**< 링 (memory 안) */
+    key_delivery_cipher cipher;  /**< 채널 키스트림 */
+    unsigned long delivered;     /**< 링에 넣은 레코드 수 */
+} key_delivery_channel;
+
+/**
+ * @brief 복호화된 키 입력
+ */
+typedef struct key_delivery_key {
+    uint32_t vk_code;    /**< 가상 키 코드 */
+    uint32_t message;    /**< KEY_MESSAGE_KEYDOWN 또는 KEY_MESSAGE_KEYUP */
+    uint32_t time_ms;    /**< 생산자 단조 시계 (밀리초) */
+} key_delivery_key;
+
+/**
+ * @brief 소비자 쪽 클라이언트 (애플리케이션에 링크)
+ */
+typedef struct key_delivery_client {
+    kp_shared_memory memory;     /**< 링 공유 메모리 */
+    kp_named_event event;        /**< 깨우기 이벤트 */
+    key_delivery_ring* ring;     /**< 링 (memory 안) */
+    key_delivery_cipher cipher;  /**< 채널 키스트림 */
+    char control_name[CONTROL_NAME_SIZE]; /**< 구독한 제어 채널 이름 (비어 있으면 구독 해제 요청 안 함) */
+    unsigned long reads;         /**< 레코드를 하나 이상 읽은 호출 수 */
+    unsigned long waits;         /**< 이벤트를 기다린 횟수 */
+} key_delivery_client;
+
+/**
+ * @brief 채널 이름을 만듭니다. ("KeyboardProtectorDelivery.<PID>")
+ */
+void key_delivery_channel_name(char* name, size_t size, unsigned long consumer_pid);
+
+/**
+ * @brief 새 채널 키로 링과 깨우기 이벤트를 만듭니다.
+ * @param channel 채널 상태
+ * @param consumer_pid 구독한 프로세스 ID
+ * @param grant 구독자에게 보낼 승인 정보
+ * @return int 성공 시 1, 실패 시 0
+ */
+int key_delivery_channel_open(key_delivery_channel* channel, unsigned long consumer_pid, key_delivery_grant* grant);
+
+/**
+ * @brief 키 입력 하나를 암호화하여 링에 넣습니다. (생산자 스레드 하나에서만 호출)
+ * @return int 넣었으면 1, 링이 가득 찼거나 채널이 닫혔으면 0
+ */
+int key_delivery_push(key_delivery_channel* channel, uint32_t vk_code, uint32_t message, uint32_t time_ms);
+
+/**
+ * @brief 채널을 닫습니다. (소비자에게 닫힘을 알리고 링과 이벤트 이름을 제거)
+ */
+void key_delivery_channel_close(key_delivery_channel* channel);
+
+/**
+ * @brief 승인 정보로 링에 연결합니다. (제어 채널을 거치지 않는 직접 연결)
+ * @return int 성공 시 1, 링이 없거나 배치가 맞지 않으면 0
+ */
+int key_delivery_client_attach(key_delivery_client* client, const key_delivery_grant* grant);
+
+/**
+ * @brief 제어 채널로 구독을 요청하고 링에 연결합니다.
+ * @param client 클라이언트 상태
+ * @param control_name 제어 채널 이름 (NULL이면 기본 이름)
+ * @param timeout_ms 제어 채널 연결 제한 시간
+ * @return int 성공 시 1, 구독이 거부되었거나 연결할 수 없으면 0
+ */
+int key_delivery_client_connect(key_delivery_client* client, const char* control_name, unsigned int timeout_ms);
+
+/**
+ * @brief 쌓인 키 입력을 한꺼번에 읽습니다.
+ * @details 링이 비어 있으면 timeout_ms까지 한 번 기다립니다. 기다리는 동안 들어온 키는 깨우기 한 번으로 모두 읽힙니다.
+ * @param client 클라이언트 상태
+ * @param keys 복호화한 키를 받을 배열
+ * @param max_keys 배열 크기
+ * @param timeout_ms 링이 비어 있을 때 기다릴 최대 시간 (0이면 기다리지 않음)
+ * @return size_t 읽은 키 수
+ */
+size_t key_delivery_client_read(key_delivery_client* client, key_delivery_key* keys, size_t max_keys,
+                                unsigned int timeout_ms);
+
+/**
+ * @brief 생산자가 채널을 닫았는지 확인합니다.
+ */
+int key_delivery_client_closed(const key_delivery_client* client);
+
+/**
+ * @brief 링 연결을 끊고, 제어 채널로 구독했다면 구독 해제를 요청합니다.
+ */
+void key_delivery_client_close(key_delivery_client* client);
+
+#endif // KEY_DELIVERY_H
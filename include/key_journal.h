@@ -0,0 +1,294 @@
+#ifndef KEY_JOURNAL_H
+#define KEY_JOURNAL_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "spsc_ring.h"
+#include "kp_platform.h"
+
+/**
+ * @file key_journal.h
+ * @brief 추가 전용 이진 키 입력 저널과 메모리 매핑 조회
+ * @details 키 다운 판정마다 고정 크기 레코드(UTC 시각, 암호화된 키 코드, 솔트, 판정, 인턴된 프로세스 번호)를
+ *          남깁니다. 작업 스레드는 레코드를 SPSC 링에 넣기만 하고, 저널 스레드가 레코드를 블록으로 묶어
+ *          CRC32와 함께 세그먼트 파일에 덧붙입니다. 세그먼트가 일정 크기를 넘으면 새 파일로 넘어갑니다.
+ *
+ *          모든 값은 리틀 엔디언입니다.
+ *          세그먼트 헤더(72): "KPJRNL\0\0"(8) | 버전(2) | 레코드 크기(2) | 블록 헤더 크기(2) | 플래그(2)
+ *                             | PID(4) | 세그먼트 순번(4) | 생성 UTC ns(8)
+ *                             | 세션 논스(4) | 저널 키 확인 값(4) | 저널 키로 감싼 세션 키(32)
+ *          블록 헤더(32): 매직 "KPJB"(4) | 종류(2) | 개수 또는 이름 번호(2) | 페이로드 크기(4) | CRC32(4)
+ *                         | 블록 안 최소 UTC ns(8) | 최대 UTC ns(8)
+ *          레코드(24): UTC ns(8) | 암호화된 키 코드(4) | 솔트(4) | 이름 번호(2) | 판정(1) | 예약(1) | 순번(4)
+ *
+ *          레코드의 솔트는 키스트림 위치이며, 키스트림 워드나 세션 키는 평문으로 남기지 않습니다.
+ *          설정에서 저널 키 파일을 지정하면 세션 키를 저널 키로 감싸 헤더에 넣으므로, 같은 키 파일을 가진
+ *          조회 도구만 세션 키를 풀어 레코드를 복호화할 수 있습니다. 저널 키가 없으면 어떤 도구도 복호화할 수 없습니다.
+ *
+ *          CRC32는 CRC 자리를 0으로 둔 블록 헤더와 페이로드 전체에 대해 계산합니다.
+ *          프로세스 이름은 세그먼트마다 처음 쓰일 때 이름 블록으로 다시 정의하므로, 세그먼트 하나만으로
+ *          조회할 수 있고 여러 세그먼트를 병렬로 읽을 수 있습니다.
+ */
+
+/** @brief 저널 형식 버전 */
+#define KEY_JOURNAL_VERSION 2
+
+/** @brief 세그먼트 헤더 크기 (바이트) */
+#define KEY_JOURNAL_SEGMENT_HEADER_SIZE 72
+
+/** @brief 세그먼트 헤더 플래그: 저널 키로 감싼 세션 키가 들어 있음 */
+#define KEY_JOURNAL_FLAG_WRAPPED_KEY 0x0001
+
+/** @brief 저널 키 파일의 16진수 자릿수 (256비트) */
+#define KEY_JOURNAL_KEY_HEX_DIGITS 64
+
+/** @brief 블록 헤더 크기 (바이트) */
+#define KEY_JOURNAL_BLOCK_HEADER_SIZE 32
+
+/** @brief 레코드 크기 (바이트) */
+#define KEY_JOURNAL_RECORD_SIZE 24
+
+/** @brief 블록 하나에 담는 최대 레코드 수 */
+#define KEY_JOURNAL_BLOCK_RECORDS 128
+
+/** @brief 블록 종류: 키 레코드 */
+#define KEY_JOURNAL_BLOCK_RECORDS_TYPE 1
+
+/** @brief 블록 종류: 프로세스 이름 정의 */
+#define KEY_JOURNAL_BLOCK_NAME_TYPE 2
+
+/** @brief 인턴할 수 있는 프로세스 이름 수 */
+#define KEY_JOURNAL_MAX_NAMES 256
+
+/** @brief 프로세스 이름 최대 길이 */
+#define KEY_JOURNAL_NAME_SIZE 260
+
+/** @brief 프로세스를 알 수 없음 */
+#define KEY_JOURNAL_NO_NAME 0xFFFF
+
+/** @brief 작업 스레드 → 저널 스레드 링 용량 (2의 거듭제곱) */
+#define KEY_JOURNAL_RING_CAPACITY 8192
+
+/** @brief 세그먼트 기본 최대 크기 (바이트) */
+#define KEY_JOURNAL_DEFAULT_SEGMENT_BYTES (16UL * 1024UL * 1024UL)
+
+/** @brief 덜 찬 블록을 기록하기까지 기다리는 최대 시간 (밀리초) */
+#define KEY_JOURNAL_FLUSH_INTERVAL_MS 1000
+
+/** @brief 세그먼트 디렉토리 경로 최대 길이 */
+#define KEY_JOURNAL_PATH_SIZE 260
+
+/**
+ * @brief 세그먼트 헤더에 넣는 세션 키 정보
+ */
+typedef struct key_journal_key_info {
+    uint32_t nonce;                    /**< 세션 논스 (키스트림 풀의 논스) */
+    uint32_t key_check;                /**< 저널 키 확인 값 (조회 도구가 키 파일이 맞는지 확인) */
+    uint32_t wrapped_key[8];           /**< 저널 키로 감싼 세션 키 */
+    int wrapped;                       /**< 감싼 세션 키가 있는지 여부 */
+} key_journal_key_info;
+
+/**
+ * @brief 작업 스레드가 링에 넣는 레코드
+ */
+typedef struct key_journal_entry {
+    unsigned long long timestamp_ns;   /**< 이벤트 시각 (kp_now_ns, 저널 스레드가 UTC로 변환) */
+    unsigned int encrypted_keycode;    /**< 암호화된 키 코드 */
+    unsigned int salt;                 /**< 암호화에 사용한 솔트 (키스트림 위치, 워드 자체는 기록하지 않음) */
+    unsigned short name_id;            /**< 인턴된 프로세스 이름 번호 */
+    unsigned char verdict;             /**< LOG_VERDICT_* 값 */
+    unsigned char reserved;            /**< 정렬용 예약 공간 */
+} key_journal_entry;
+
+/**
+ * @brief 저널 기록 통계
+ */
+typedef struct key_journal_stats {
+    unsigned long records;        /**< 파일에 기록한 레코드 수 */
+    unsigned long blocks;         /**< 기록한 레코드 블록 수 */
+    unsigned long segments;       /**< 만든 세그먼트 수 */
+    unsigned long dropped;        /**< 링이 가득 차서 버려진 레코드 수 */
+    unsigned long write_errors;   /**< 파일 쓰기에 실패한 블록 수 */
+} key_journal_stats;
+
+/**
+ * @brief 저널 기록기
+ * @details key_journal_intern_name()과 key_journal_append()는 한 스레드(작업 스레드)에서만 호출합니다.
+ *          나머지 필드는 저널 스레드가 소유합니다.
+ */
+typedef struct key_journal_writer {
+    spsc_ring ring;                                     /**< 작업 스레드 → 저널 스레드 레코드 큐 */
+    key_journal_entry storage[KEY_JOURNAL_RING_CAPACITY]; /**< 링 저장 공간 */
+    unsigned long name_count;                           /**< 인턴된 이름 수 (생산자가 release로 게시) */
+    unsigned int last_name;                             /**< 마지막으로 인턴한 이름 번호 (생산자 전용) */
+    char names[KEY_JOURNAL_MAX_NAMES][KEY_JOURNAL_NAME_SIZE]; /**< 추가만 가능한 이름 테이블 */
+
+    char directory[KEY_JOURNAL_PATH_SIZE];              /**< 세그먼트를 만들 디렉토리 */
+    key_journal_key_info key_info;                      /**< 세그먼트 헤더에 넣을 세션 키 정보 */
+    unsigned long segment_limit;                        /**< 세그먼트 최대 크기 (바이트) */
+    FILE* segment;                                      /**< 현재 세그먼트 (없으면 NULL) */
+    unsigned long segment_bytes;                        /**< 현재 세그먼트 크기 */
+    unsigned int segment_sequence;                      /**< 다음 세그먼트 순번 */
+    unsigned char name_written[KEY_JOURNAL_MAX_NAMES];  /**< 현재 세그먼트에 정의한 이름 */
+    unsigned long long wall_base_ns;                    /**< 시각 변환 기준 UTC */
+    unsigned long long mono_base_ns;                    /**< 시각 변환 기준 kp_now_ns */
+    unsigned char block[KEY_JOURNAL_BLOCK_HEADER_SIZE + KEY_JOURNAL_BLOCK_RECORDS * KEY_JOURNAL_RECORD_SIZE]; /**< 채우는 중인 블록 */
+    unsigned int block_records;                         /**< 블록에 담긴 레코드 수 */
+    unsigned long long block_started_ns;                /**< 블록의 첫 레코드를 받은 시각 (kp_now_ns) */
+    unsigned long sequence;                             /**< 다음 레코드 순번 */
+
+    kp_event wake;                                      /**< 저널 스레드 깨우기 이벤트 */
+    int writer_sleeping;                                /**< 저널 스레드가 대기 중인지 여부 (원자적 접근) */
+    volatile int stop;                                  /**< 저널 스레드 종료 요청 */
+    kp_thread thread;                                   /**< 저널 스레드 */
+    key_journal_stats stats;                            /**< 통계 */
+} key_journal_writer;
+
+/**
+ * @brief 저널 스레드를 시작합니다.
+ * @details 세그먼트 파일은 첫 블록을 기록할 때 만듭니다.
+ * @param writer 초기화할 기록기
+ * @param directory 세그먼트를 만들 디렉토리 (이미 있어야 함)
+ * @param segment_limit 세그먼트 최대 크기 (0이면 기본값)
+ * @param key_info 세그먼트 헤더에 넣을 세션 키 정보 (NULL이면 논스 0, 감싼 세션 키 없음)
+ * @return int 성공 시 1, 실패 시 0
+ */
+int key_journal_writer_start(key_journal_writer* writer, const char* directory, unsigned long segment_limit,
+                             const key_journal_key_info* key_info);
+
+/**
+ * @brief 저널 키 파일을 읽습니다.
+ * @details 파일에는 16진수 64자리(32바이트, 앞 바이트부터)가 들어 있어야 하며 공백과 줄바꿈은 무시합니다.
+ * @return int 성공 시 1, 파일이 없거나 형식이 다르면 0
+ */
+int key_journal_read_key_file(const char* path, uint32_t key[8]);
+
+/**
+ * @brief 세션 키를 저널 키로 감쌉니다.
+ * @param info 채울 세션 키 정보
+ * @param journal_key 저널 키 (key_journal_read_key_file)
+ * @param session_key 키스트림 풀의 세션 키
+ * @param nonce 키스트림 풀의 세션 논스
+ */
+void key_journal_wrap_key(key_journal_key_info* info, const uint32_t journal_key[8],
+                          const uint32_t session_key[8], uint32_t nonce);
+
+/**
+ * @brief 프로세스 이름을 인턴하고 번호를 반환합니다. (생산자 전용)
+ * @return unsigned short 이름 번호, 이름이 없거나 테이블이 가득 차면 KEY_JOURNAL_NO_NAME
+ */
+unsigned short key_journal_intern_name(key_journal_writer* writer, const char* name);
+
+/**
+ * @brief 레코드를 링에 넣습니다. (생산자 전용, 대기하지 않음)
+ * @return int 성공 시 1, 링이 가득 차서 버려졌으면 0
+ */
+int key_journal_append(key_journal_writer* writer, const key_journal_entry* entry);
+
+/**
+ * @brief 통계 사본을 가져옵니다. (근사값)
+ */
+void key_journal_writer_get_stats(const key_journal_writer* writer, key_journal_stats* stats);
+
+/**
+ * @brief 남은 레코드를 기록하고 저널 스레드를 멈춥니다.
+ */
+void key_journal_writer_stop(key_journal_writer* writer);
+
+/**
+ * @brief 세그먼트에서 읽은 레코드
+ */
+typedef struct key_journal_record {
+    unsigned long long timestamp_ns;   /**< UTC 시각 (유닉스 나노초) */
+    unsigned int encrypted_keycode;    /**< 암호화된 키 코드 */
+    unsigned int salt;                 /**< 솔트 (키스트림 위치) */
+    unsigned int sequence;             /**< 기록한 프로세스 안에서의 순번 */
+    unsigned short name_id;            /**< 세그먼트 안의 프로세스 이름 번호 */
+    unsigned char verdict;             /**< LOG_VERDICT_* 값 */
+} key_journal_record;
+
+/**
+ * @brief 읽기 전용으로 매핑한 세그먼트
+ * @details 이름은 매핑된 파일을 가리키며, 조회하면서 정의를 만날 때 채워집니다.
+ */
+typedef struct key_journal_segment {
+    kp_mapped_file map;                                /**< 세그먼트 파일 매핑 */
+    unsigned long process_id;                          /**< 기록한 프로세스 ID */
+    unsigned long sequence;                            /**< 세그먼트 순번 */
+    unsigned long long created_ns;                     /**< 생성 UTC 시각 */
+    unsigned int flags;                                /**< KEY_JOURNAL_FLAG_* 값 */
+    key_journal_key_info key_info;                     /**< 헤더의 세션 키 정보 */
+    const char* names[KEY_JOURNAL_MAX_NAMES];          /**< 이름 번호 → 이름 (NUL 종료 아님) */
+    unsigned short name_lengths[KEY_JOURNAL_MAX_NAMES];/**< 이름 길이 */
+} key_journal_segment;
+
+/**
+ * @brief 조회 조건
+ */
+typedef struct key_journal_query {
+    unsigned long long from_ns;   /**< 이 시각 이상 (0이면 제한 없음) */
+    unsigned long long to_ns;     /**< 이 시각 미만 (0이면 제한 없음) */
+    const char* process;          /**< 프로세스 이름 (대소문자 구분 없음, NULL이면 전체) */
+    unsigned int verdict_mask;    /**< (1 << 판정) 비트 집합 (0이면 전체) */
+} key_journal_query;
+
+/**
+ * @brief 조회 결과 요약
+ */
+typedef struct key_journal_scan_result {
+    unsigned long blocks;          /**< 검사한 레코드 블록 수 */
+    unsigned long blocks_skipped;  /**< 시각 범위 밖이라 건너뛴 블록 수 */
+    unsigned long records;         /**< 검사한 레코드 수 */
+    unsigned long matched;         /**< 조건에 맞는 레코드 수 */
+    int truncated;                 /**< 손상되었거나 기록 중인 블록에서 멈췄는지 여부 */
+} key_journal_scan_result;
+
+/**
+ * @brief 조건에 맞는 레코드마다 호출되는 함수
+ */
+typedef void (*key_journal_visit_fn)(void* user, const key_journal_segment* segment,
+                                     const key_journal_record* record);
+
+/**
+ * @brief 세그먼트 파일을 매핑하고 헤더를 확인합니다.
+ * @return int 성공 시 1, 파일이 없거나 형식이 다르면 0
+ */
+int key_journal_segment_open(key_journal_segment* segment, const char* path);
+
+/**
+ * @brief 세그먼트의 블록을 차례로 검사하여 조건에 맞는 레코드를 전달합니다.
+ * @details 블록 헤더의 시각 범위로 관계없는 블록은 CRC 확인 없이 건너뜁니다.
+ *          CRC가 맞지 않거나 잘린 블록을 만나면 그 지점에서 멈춥니다.
+ * @param visit 레코드마다 호출할 함수 (NULL이면 개수만 셈)
+ * @return int 끝까지 읽었으면 1, 손상된 블록에서 멈췄으면 0
+ */
+int key_journal_scan(key_journal_segment* segment, const key_journal_query* query,
+                     key_journal_visit_fn visit, void* user, key_journal_scan_result* result);
+
+/**
+ * @brief 세그먼트 안의 이름 번호에 해당하는 프로세스 이름을 반환합니다.
+ * @param length 이름 길이를 돌려받을 포인터
+ * @return const char* 이름 (NUL 종료 아님, 정의되지 않았으면 NULL)
+ */
+const char* key_journal_segment_name(const key_journal_segment* segment, unsigned int name_id, size_t* length);
+
+/**
+ * @brief 세그먼트 헤더의 감싼 세션 키를 저널 키로 풉니다.
+ * @return int 성공 시 1, 감싼 세션 키가 없거나 저널 키가 다르면 0
+ */
+int key_journal_unwrap_key(const key_journal_segment* segment, const uint32_t journal_key[8], uint32_t session_key[8]);
+
+/**
+ * @brief 레코드의 암호화된 키 코드를 세션 키로 복호화합니다.
+ * @param session_key key_journal_unwrap_key()로 푼 세션 키
+ * @param nonce 세그먼트의 세션 논스
+ * @return unsigned int 원래 가상 키 코드
+ */
+unsigned int key_journal_decrypt(const uint32_t session_key[8], uint32_t nonce, const key_journal_record* record);
+
+/**
+ * @brief 세그먼트 매핑을 해제합니다.
+ */
+void key_journal_segment_close(key_journal_segment* segment);
+
+#endif // KEY_JOURNAL_H
@@ -0,0 +1,127 @@
+#ifndef KEY_PIPELINE_H
+#define KEY_PIPELINE_H
+
+#include "spsc_ring.h"
+#include "kp_platform.h"
+#include "stats_block.h"
+
+/**
+ * @file key_pipeline.h
+ * @brief 후크 → 작업 스레드 키 이벤트 파이프라인
+ * @details 후크는 키 이벤트를 잠금 없는 SPSC 큐에 복사하고 바로 반환하며,
+ *          전용 작업 스레드가 프로세스 확인, 암호화, 정책 판정, SendInput을 순서대로 처리합니다.
+ *          큐는 하나이고 작업 스레드도 하나이므로 키 이벤트 순서가 보존됩니다.
+ */
+
+/** @brief 큐에 담을 수 있는 키 이벤트 수 (2의 거듭제곱) */
+#define KEY_PIPELINE_CAPACITY 1024
+
+/**
+ * @brief 작업 스레드의 처리 단계 (단계별 소요 시간 집계용)
+ */
+typedef enum key_pipeline_stage {
+    KEY_STAGE_RESOLVE = 0, /**< 포그라운드 프로세스 확인 및 정책 판정 */
+    KEY_STAGE_CRYPTO,      /**< 솔트 생성과 암호화/복호화 */
+    KEY_STAGE_INJECT,      /**< 복호화된 키 주입 (SendInput) */
+    KEY_STAGE_COUNT
+} key_pipeline_stage;
+
+/**
+ * @brief 후크가 큐에 넣는 키 이벤트 (KBDLLHOOKSTRUCT 사본)
+ */
+typedef struct key_event {
+    unsigned long long enqueue_ns; /**< 후크가 큐에 넣은 시각 (kp_now_ns) */
+    unsigned int vk_code;          /**< 가상 키 코드 */
+    unsigned int scan_code;        /**< 스캔 코드 */
+    unsigned int flags;            /**< LLKHF_* 플래그 */
+    unsigned int time;             /**< 시스템 이벤트 시각 (밀리초) */
+    unsigned int message;          /**< WM_KEYDOWN, WM_KEYUP, WM_SYSKEYDOWN, WM_SYSKEYUP */
+    unsigned int tag;              /**< 백엔드가 붙이는 값 (Win32: 입력 장치 분류 device_class, 재생 도구: 레코드 번호) */
+} key_event;
+
+/**
+ * @brief 작업 스레드가 이벤트마다 호출하는 처리 함수
+ */
+typedef void (*key_event_handler)(const key_event* event, void* user);
+
+/**
+ * @brief 큐가 비어 작업 스레드가 잠들기 직전에 호출하는 함수 (모아 둔 주입 내보내기 등)
+ */
+typedef void (*key_idle_handler)(void* user);
+
+/**
+ * @brief 파이프라인 통계 (작업 스레드가 갱신, 어느 스레드에서든 읽기 가능)
+ */
+typedef struct key_pipeline_stats {
+    unsigned long enqueued;    /**< 큐에 넣은 이벤트 수 */
+    unsigned long dropped;     /**< 큐가 가득 차서 버린 이벤트 수 */
+    unsigned long processed;   /**< 처리한 이벤트 수 */
+    unsigned long wakeups;     /**< 잠든 작업 스레드를 깨운 횟수 */
+    unsigned long max_depth;   /**< 관측된 최대 큐 깊이 */
+    unsigned long long lag_total_ns; /**< 큐 대기 시간 합계 */
+    unsigned long long lag_max_ns;   /**< 큐 대기 시간 최대값 */
+    unsigned long long stage_total_ns[KEY_STAGE_COUNT]; /**< 단계별 소요 시간 합계 */
+    unsigned long long stage_max_ns[KEY_STAGE_COUNT];   /**< 단계별 소요 시간 최대값 */
+} key_pipeline_stats;
+
+/**
+ * @brief 키 이벤트 파이프라인
+ */
+typedef struct key_pipeline {
+    spsc_ring queue;                           /**< 후크 → 작업 스레드 큐 */
+    key_event storage[KEY_PIPELINE_CAPACITY];  /**< 큐 저장 공간 */
+    kp_event wake;                             /**< 작업 스레드 깨우기 이벤트 */
+    int worker_sleeping;                       /**< 작업 스레드가 대기 중인지 여부 (원자적 접근) */
+    volatile int stop;                         /**< 작업 스레드 종료 요청 */
+    kp_thread worker;                          /**< 작업 스레드 */
+    key_event_handler handler;                 /**< 이벤트 처리 함수 */
+    key_idle_handler idle;                     /**< 유휴 처리 함수 (NULL 가능) */
+    void* user;                                /**< 처리 함수 사용자 데이터 */
+    key_pipeline_stats stats;                  /**< 통계 */
+    kp_stats_block* stats_block;               /**< 지연 히스토그램을 기록할 통계 블록 (NULL 가능) */
+} key_pipeline;
+
+/**
+ * @brief 파이프라인을 초기화하고 작업 스레드를 시작합니다.
+ * @details idle은 큐가 빌 때마다 작업 스레드가 호출하며, 종료할 때도 남은 이벤트를 처리한 뒤 한 번 호출됩니다.
+ *          작업 스레드가 시작되기 전에 설정되므로 첫 이벤트부터 빠짐없이 적용됩니다.
+ * @param idle 유휴 처리 함수 (NULL 가능, 처리 함수와 같은 사용자 데이터를 받음)
+ * @return int 성공 시 1, 실패 시 0
+ */
+int key_pipeline_start(key_pipeline* pipeline, key_event_handler handler, key_idle_handler idle, void* user);
+
+/**
+ * @brief 큐 대기, 단계별 소요 시간, 이벤트 처리 시간을 히스토그램으로 기록할 통계 블록을 연결합니다.
+ * @details 후크를 설치하기 전에 호출해야 합니다.
+ */
+void key_pipeline_attach_stats(key_pipeline* pipeline, kp_stats_block* block);
+
+/**
+ * @brief 키 이벤트를 큐에 넣습니다. (후크 스레드 전용, 잠금/할당 없음)
+ * @details 작업 스레드가 잠들어 있을 때만 깨우기 신호를 보냅니다.
+ * @return int 성공 시 1, 큐가 가득 찼으면 0
+ */
+int key_pipeline_submit(key_pipeline* pipeline, const key_event* event);
+
+/**
+ * @brief 단계별 소요 시간을 기록합니다. (작업 스레드 전용)
+ */
+void key_pipeline_record_stage(key_pipeline* pipeline, key_pipeline_stage stage, unsigned long long elapsed_ns);
+
+/**
+ * @brief 현재 큐 깊이를 반환합니다.
+ */
+unsigned long key_pipeline_depth(const key_pipeline* pipeline);
+
+/**
+ * @brief 통계의 일관된 사본을 가져옵니다. (근사값)
+ */
+void key_pipeline_get_stats(const key_pipeline* pipeline, key_pipeline_stats* stats);
+
+/**
+ * @brief 남은 이벤트를 모두 처리한 뒤 작업 스레드를 멈춥니다.
+ * @details 후크를 해제한 뒤에 호출해야 합니다.
+ */
+void key_pipeline_stop(key_pipeline* pipeline);
+
+#endif // KEY_PIPELINE_H
@@ -0,0 +1,129 @@
+#ifndef KEY_POLICY_H
+#define KEY_POLICY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file key_policy.h
+ * @brief 프로세스별 키 규칙 (가상 키 비트맵 + 조합 키 표)
+ * @details config.ini의 `[KeyRules]` 항목을 로드 시에 규칙 하나당 256비트 가상 키 비트맵과
+ *          16비트 조합 키 표로 컴파일합니다. 키 입력마다 하는 판정은 비트 검사 두 번으로 끝납니다.
+ *
+ *          규칙 문법: `<키 항목...> [| <조합 항목...>]` (항목은 공백이나 쉼표로 구분)
+ *          - 키 항목: 분류(`all`, `alpha`, `digit`, `alnum`, `func`, `nav`, `edit`, `punct`, `numpad`,
+ *            `shift`, `ctrl`, `alt`, `win`, `modifiers`), 키 이름(`a`, `f5`, `esc`, `enter` 등),
+ *            또는 `0x41` 같은 가상 키 코드. 앞에 `-`를 붙이면 제외합니다.
+ *          - 조합 항목: `any`(기본값), `none`(조합 키 없이 누른 경우만), `-shift`/`-ctrl`/`-alt`/`-win`
+ *            (해당 조합 키를 누르고 있는 상태 제외)
+ *
+ *          예: `putty.exe=alnum punct edit nav | -ctrl -alt`, `wt.exe=all | -win`
+ */
+
+/** @brief 규칙 테이블의 최대 규칙 수 (0번은 [AllowedProcesses]용 전체 허용 규칙) */
+#define KEY_POLICY_MAX_RULES 64
+
+/** @brief 모든 키와 모든 조합을 허용하는 기본 규칙 번호 */
+#define KEY_POLICY_RULE_ALL 0
+
+/**
+ * @brief 모든 키를 차단하는 규칙 번호
+ * @details 테이블 범위 밖 번호이므로 key_policy_allows()가 항상 차단합니다.
+ *          컴파일할 수 없는 [KeyRules] 항목의 프로세스에 지정하여, [AllowedProcesses]에도 있는 프로세스가
+ *          전체 허용(0번)으로 남지 않게 합니다.
+ */
+#define KEY_POLICY_RULE_DENY KEY_POLICY_MAX_RULES
+
+/** @brief 가상 키 비트맵의 32비트 워드 수 (256비트) */
+#define KEY_POLICY_KEY_WORDS 8
+
+/** @brief 조합 키 상태 비트: Shift */
+#define KEY_MOD_SHIFT 0x1
+/** @brief 조합 키 상태 비트: Ctrl */
+#define KEY_MOD_CTRL 0x2
+/** @brief 조합 키 상태 비트: Alt */
+#define KEY_MOD_ALT 0x4
+/** @brief 조합 키 상태 비트: Win */
+#define KEY_MOD_WIN 0x8
+/** @brief 조합 키 상태 수 (KEY_MOD_* 비트 조합 16가지) */
+#define KEY_MOD_STATES 16
+
+/** @brief 종료 키 기본값 (VK_ESCAPE) */
+#define KEY_POLICY_DEFAULT_EXIT_KEY 0x1B
+
+/**
+ * @brief 컴파일된 키 규칙
+ */
+typedef struct key_rule {
+    uint32_t keys[KEY_POLICY_KEY_WORDS]; /**< 허용하는 가상 키 비트맵 */
+    uint32_t chords;                     /**< 허용하는 조합 키 상태 표 (비트 n = KEY_MOD_* 조합 n) */
+} key_rule;
+
+/**
+ * @brief 규칙 테이블 (정책 스냅샷에 포함되어 게시 후에는 변경되지 않음)
+ */
+typedef struct key_policy {
+    unsigned int count;                     /**< 규칙 수 (0번 규칙 포함) */
+    key_rule rules[KEY_POLICY_MAX_RULES];   /**< 규칙 목록 */
+} key_policy;
+
+/**
+ * @brief 전체 허용 규칙(0번) 하나만 있는 테이블로 초기화합니다.
+ */
+void key_policy_init(key_policy* policy);
+
+/**
+ * @brief 규칙 문자열을 컴파일합니다.
+ * @param rule 컴파일 결과
+ * @param spec 규칙 문자열
+ * @param bad_token 알 수 없는 항목을 돌려받을 버퍼 (NULL 가능)
+ * @param bad_size 버퍼 크기
+ * @return int 성공 시 1, 알 수 없거나 너무 긴 항목이 있으면 0
+ */
+int key_rule_compile(key_rule* rule, const char* spec, char* bad_token, size_t bad_size);
+
+/**
+ * @brief 규칙을 테이블에 추가합니다.
+ * @return int 규칙 번호, 테이블이 가득 차면 -1
+ */
+int key_policy_add(key_policy* policy, const key_rule* rule);
+
+/**
+ * @brief 키 입력이 규칙에서 허용되는지 판정합니다.
+ * @param policy 규칙 테이블
+ * @param rule 규칙 번호 (범위를 벗어나면 차단)
+ * @param vk_code 가상 키 코드
+ * @param modifiers 누르고 있는 조합 키 상태 (KEY_MOD_* 비트)
+ * @return int 허용이면 1, 차단이면 0
+ */
+int key_policy_allows(const key_policy* policy, unsigned int rule, unsigned int vk_code, unsigned int modifiers);
+
+/**
+ * @brief 가상 키가 조합 키라면 눌림 상태 마스크의 비트를 반환합니다.
+ * @details 왼쪽/오른쪽 키를 따로 추적하기 위한 8비트 마스크이며, key_modifier_state()로 KEY_MOD_* 상태로 바꿉니다.
+ * @return unsigned int 조합 키 비트, 조합 키가 아니면 0
+ */
+unsigned int key_modifier_key(unsigned int vk_code);
+
+/**
+ * @brief 눌림 상태 마스크를 KEY_MOD_* 조합 키 상태로 바꿉니다.
+ */
+unsigned int key_modifier_state(unsigned int held_keys);
+
+/**
+ * @brief 키 이름을 가상 키 코드로 바꿉니다. (대소문자 구분 없음)
+ * @return int 가상 키 코드, 알 수 없는 이름이면 -1
+ */
+int key_name_to_vk(const char* name);
+
+/**
+ * @brief 규칙이 허용하는 키 수를 반환합니다.
+ */
+unsigned int key_rule_key_count(const key_rule* rule);
+
+/**
+ * @brief 규칙이 허용하는 조합 키 상태 수를 반환합니다.
+ */
+unsigned int key_rule_chord_count(const key_rule* rule);
+
+#endif // KEY_POLICY_H
@@ -0,0 +1,131 @@
+#ifndef KEY_PROCESSOR_H
+#define KEY_PROCESSOR_H
+
+#include "key_pipeline.h"
+#include "foreground_cache.h"
+#include "key_policy.h"
+#include "kp_config.h"
+
+/**
+ * @file key_processor.h
+ * @brief 플랫폼 독립 키 이벤트 처리 코어
+ * @details 솔트 생성, 암호화, 포그라운드 판정과 키 규칙 적용, 복호화된 키 주입을 한곳에서 수행합니다.
+ *          시계와 주입, 로그는 key_processor_backend로만 호출하므로
+ *          Win32 작업 스레드와 재생 도구가 같은 코드를 사용합니다.
+ *          KP_STATIC_BACKEND 빌드에서는 솔트 생성과 주입을 kp_backend_* 함수로 직접 호출하고,
+ *          KP_FEATURE_KEY_LOG나 KP_FEATURE_STAGE_TIMING이 0이면 판정 기록과 단계별 시간 측정이 빠집니다.
+ */
+
+/** @brief 키 메시지 값 (Win32 WM_KEYDOWN 등과 같은 값) */
+#define KEY_MESSAGE_KEYDOWN    0x0100
+#define KEY_MESSAGE_KEYUP      0x0101
+#define KEY_MESSAGE_SYSKEYDOWN 0x0104
+#define KEY_MESSAGE_SYSKEYUP   0x0105
+
+/** @brief 솔트를 보관하는 가상 키 코드 범위 */
+#define KEY_PROCESSOR_KEYS 256
+
+/** @brief 키 상태 플래그: 키 업을 기다리는 키 다운이 있음 (키스트림 워드는 0일 수 있으므로 솔트와 따로 표시) */
+#define KEY_STATE_PENDING 0x01
+
+/** @brief 키 상태 레코드를 정렬할 캐시 라인 크기 */
+#define KEY_STATE_CACHE_LINE 64
+
+/**
+ * @brief 처리 코어가 호출하는 플랫폼 함수 모음
+ */
+typedef struct key_processor_backend {
+    /** @brief 백엔드 구현이 사용하는 임의의 컨텍스트 */
+    void* context;
+    /**
+     * @brief 키 다운마다 새 키스트림 워드와 그 솔트를 만듭니다. (Win32: 키스트림 풀, 재생: 가상 시계 또는 키스트림 풀)
+     * @details 솔트는 로그와 저널에 남는 공개 값(키스트림 위치)이고, 암호화에 쓰는 워드는 pad로만 돌려받아
+     *          키 상태 밖으로 내보내지 않습니다.
+     * @param pad 키스트림 워드를 돌려받을 포인터
+     * @return unsigned int 솔트 (키스트림 위치)
+     */
+    unsigned int (*make_salt)(void* context, unsigned int* pad);
+    /**
+     * @brief 복호화된 키를 주입합니다. (Win32: SendInput)
+     * @return int 성공 시 1, 실패 시 0
+     */
+    int (*inject)(void* context, unsigned int vk_code, int key_down);
+    /**
+     * @brief 키 다운 판정을 기록합니다. (NULL 가능, salt는 키스트림 위치이며 워드는 넘기지 않음)
+     * @details 자동 반복 키 다운은 하나씩 기록하지 않고, 키 업(또는 판정이 바뀔 때)에 반복 횟수와 함께 한 번 기록합니다.
+     * @param verdict LOG_VERDICT_* 값
+     * @param process_name 포그라운드 프로세스 이름 (알 수 없으면 NULL)
+     * @param repeats 0이면 새 키 다운, 0보다 크면 그동안 합친 자동 반복 횟수
+     */
+    void (*log)(void* context, unsigned int vk_code, unsigned int salt,
+                unsigned int encrypted_keycode, int verdict, const char* process_name, unsigned int repeats);
+} key_processor_backend;
+
+/**
+ * @brief 가상 키 코드 하나의 상태 (32바이트, 캐시 라인 하나에 2개)
+ * @details 키 다운과 키 업, 자동 반복이 같은 레코드만 읽고 쓰므로 키 하나를 처리하는 데 캐시 라인 하나면 됩니다.
+ */
+typedef struct key_state {
+    unsigned int salt;              /**< 키 다운 때 만든 솔트 (키스트림 위치, 자동 반복 로그에 재사용) */
+    unsigned int pad;               /**< 키 다운 때 꺼낸 키스트림 워드 (키 업 복호화와 반복에 재사용) */
+    unsigned int encrypted;         /**< 암호화된 키 코드 */
+    unsigned int generation;        /**< 판정을 얻은 포그라운드 캐시 세대 (하위 32비트) */
+    unsigned short repeats;         /**< 아직 기록하지 않은 자동 반복 횟수 */
+    unsigned char flags;            /**< KEY_STATE_* 플래그 */
+    unsigned char verdict;          /**< 캐시된 foreground_verdict 값 */
+} __attribute__((aligned(32))) key_state;
+
+/**
+ * @brief 키 이벤트 처리 코어 상태 (작업 스레드 하나에서만 사용)
+ */
+typedef struct key_processor {
+    foreground_cache* foreground;      /**< 포그라운드 판정 캐시 */
+    key_processor_backend backend;     /**< 플랫폼 함수 */
+    key_pipeline* pipeline;            /**< 단계별 시간을 기록할 파이프라인 (NULL이면 기록 안 함) */
+    const key_policy* policy;          /**< 이벤트를 처리하는 동안 참조할 키 규칙 (호출자가 설정, NULL이면 모든 키 허용) */
+    unsigned int modifier_keys;        /**< 누르고 있는 조합 키 (key_modifier_key 비트) */
+    key_state keys[KEY_PROCESSOR_KEYS] __attribute__((aligned(KEY_STATE_CACHE_LINE))); /**< 키 코드별 상태 */
+    unsigned long injected;            /**< 주입한 키 이벤트 수 */
+    unsigned long repeats;             /**< 빠른 경로로 처리한 자동 반복 키 다운 수 */
+    unsigned long rule_blocked;        /**< 허용 프로세스이지만 키 규칙으로 차단한 키 다운 수 */
+} key_processor;
+
+#if KP_STATIC_BACKEND
+/**
+ * @brief 정적 백엔드의 솔트 생성 함수 (KP_STATIC_BACKEND 빌드에서 처리 코어를 링크하는 프로그램이 정의)
+ * @details backend.make_salt 대신 호출되며, context에는 backend.context가 그대로 넘어옵니다.
+ */
+unsigned int kp_backend_make_salt(void* context, unsigned int* pad);
+
+/**
+ * @brief 정적 백엔드의 주입 함수 (KP_STATIC_BACKEND 빌드에서 backend.inject 대신 호출)
+ */
+int kp_backend_inject(void* context, unsigned int vk_code, int key_down);
+#endif
+
+/**
+ * @brief 처리 코어를 초기화합니다.
+ * @param processor 초기화할 처리 코어
+ * @param foreground 포그라운드 판정 캐시
+ * @param backend 플랫폼 함수 (내용이 복사됨)
+ * @param pipeline 단계별 소요 시간을 기록할 파이프라인 (NULL 가능)
+ */
+void key_processor_init(key_processor* processor, foreground_cache* foreground,
+                        const key_processor_backend* backend, key_pipeline* pipeline);
+
+/**
+ * @brief 메시지가 키 다운인지 확인합니다.
+ */
+int key_processor_is_key_down(unsigned int message);
+
+/**
+ * @brief 키 이벤트 하나를 처리합니다.
+ * @param processor 처리 코어
+ * @param event 처리할 키 이벤트
+ * @param process_name 판정에 사용한 프로세스 이름을 돌려받을 포인터 (NULL 가능)
+ * @return foreground_verdict 포그라운드 판정 결과
+ */
+foreground_verdict key_processor_handle(key_processor* processor, const key_event* event,
+                                        const char** process_name);
+
+#endif // KEY_PROCESSOR_H
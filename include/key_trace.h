@@ -0,0 +1,99 @@
+#ifndef KEY_TRACE_H
+#define KEY_TRACE_H
+
+#include <stdio.h>
+#include "key_pipeline.h"
+#include "foreground_cache.h"
+
+/**
+ * @file key_trace.h
+ * @brief 키 입력 트레이스 기록/재생 파일 형식
+ * @details 파일은 16바이트 헤더 뒤에 24바이트 고정 크기 레코드가 이어지는 리틀 엔디언 이진 형식입니다.
+ *          포그라운드 프로세스 이름은 처음 나타날 때 한 번만 라벨 정의 레코드로 기록하고,
+ *          이후 키 레코드는 2바이트 라벨 번호로 참조합니다.
+ *
+ *          헤더: "KPTRACE\0"(8) | 버전(2) | 레코드 크기(2) | 예약(4)
+ *          키 레코드: 시각 ns(8) | vk(2) | scan(2) | flags(2) | message(2) | 라벨(2) | 예약(2) | time(4)
+ *          라벨 정의: message가 KEY_TRACE_LABEL인 레코드, vk 자리에 이름 길이, 뒤에 이름 바이트
+ */
+
+/** @brief 트레이스 파일 형식 버전 */
+#define KEY_TRACE_VERSION 1
+
+/** @brief 레코드 크기 (바이트) */
+#define KEY_TRACE_RECORD_SIZE 24
+
+/** @brief 파일 하나에 정의할 수 있는 최대 라벨 수 */
+#define KEY_TRACE_MAX_LABELS 256
+
+/** @brief 라벨 정의 레코드의 message 값 */
+#define KEY_TRACE_LABEL 0
+
+/** @brief 포그라운드 프로세스를 알 수 없음 */
+#define KEY_TRACE_NO_LABEL 0xFFFF
+
+/**
+ * @brief 트레이스에서 읽은 키 레코드
+ */
+typedef struct key_trace_record {
+    unsigned long long timestamp_ns; /**< 첫 레코드 기준 상대 시각 (나노초) */
+    unsigned int vk_code;            /**< 가상 키 코드 */
+    unsigned int scan_code;          /**< 스캔 코드 */
+    unsigned int flags;              /**< LLKHF_* 플래그 */
+    unsigned int message;            /**< WM_KEYDOWN 등 키 메시지 */
+    unsigned int time;               /**< 시스템 이벤트 시각 (밀리초) */
+    unsigned short label;            /**< 포그라운드 프로세스 라벨 (KEY_TRACE_NO_LABEL 가능) */
+} key_trace_record;
+
+/**
+ * @brief 열린 트레이스 파일 (기록 또는 재생 중 하나)
+ */
+typedef struct key_trace {
+    FILE* file;                      /**< 트레이스 파일 */
+    int writing;                     /**< 기록용으로 열었는지 여부 */
+    unsigned long records;           /**< 기록하거나 읽은 키 레코드 수 */
+    unsigned long long base_ns;      /**< 첫 레코드의 절대 시각 (기록용) */
+    unsigned int label_count;        /**< 정의된 라벨 수 */
+    unsigned int last_label;         /**< 마지막으로 사용한 라벨 (기록용) */
+    char labels[KEY_TRACE_MAX_LABELS][FOREGROUND_NAME_SIZE]; /**< 라벨 번호 → 프로세스 이름 */
+} key_trace;
+
+/**
+ * @brief 기록용 트레이스 파일을 만들고 헤더를 씁니다.
+ * @return int 성공 시 1, 실패 시 0
+ */
+int key_trace_open_write(key_trace* trace, const char* path);
+
+/**
+ * @brief 재생용 트레이스 파일을 열고 헤더를 확인합니다.
+ * @return int 성공 시 1, 파일이 없거나 형식이 다르면 0
+ */
+int key_trace_open_read(key_trace* trace, const char* path);
+
+/**
+ * @brief 키 이벤트 하나를 기록합니다. (작업 스레드 전용)
+ * @details 처음 보는 프로세스 이름이면 라벨 정의 레코드를 먼저 씁니다.
+ * @param label 포그라운드 프로세스 이름 (NULL 가능)
+ * @return int 성공 시 1, 실패 시 0
+ */
+int key_trace_write(key_trace* trace, const key_event* event, const char* label);
+
+/**
+ * @brief 다음 키 레코드를 읽습니다.
+ * @details 라벨 정의 레코드는 내부에서 처리하고 건너뜁니다.
+ * @return int 읽었으면 1, 파일 끝이면 0, 형식 오류면 -1
+ */
+int key_trace_read(key_trace* trace, key_trace_record* record);
+
+/**
+ * @brief 라벨 번호에 해당하는 프로세스 이름을 반환합니다.
+ * @return const char* 프로세스 이름 (정의되지 않은 라벨이면 NULL)
+ */
+const char* key_trace_label(const key_trace* trace, unsigned int label);
+
+/**
+ * @brief 트레이스 파일을 닫습니다.
+ */
+void key_trace_close(key_trace* trace);
+
+#endif // KEY_TRACE_H
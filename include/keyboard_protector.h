@@ -7,21 +7,9 @@
 #include <psapi.h>
 #include <shlwapi.h>
 
-/**
- * @brief 키 코드를 솔트와 키를 사용하여 암호화합니다.
- * @param key_code 암호화할 키 코드
- * @param salt 암호화에 사용할 솔트 값 (매번 다르게 생성 권장)
- * @return unsigned int 암호화된 키 코드
- */
-unsigned int encrypt_keycode_with_salt(unsigned int key_code, unsigned int salt);
-
-/**
- * @brief 암호화된 키 코드를 솔트와 키를 사용하여 복호화합니다.
- * @param encrypted_code 복호화할 암호화된 키 코드
- * @param salt 암호화에 사용했던 동일한 솔트 값
- * @return unsigned int 복호화된 (원래의) 키 코드
- */
-unsigned int decrypt_keycode_with_salt(unsigned int encrypted_code, unsigned int salt);
+#include "crypto_keycode.h"
+#include "win32_backend.h"
+#include "kp_config.h"
 
 /**
  * @brief 키보드 입력이 발생할 때마다 호출되는 저수준 키보드 후크 프로시저
@@ -44,17 +32,42 @@ void SetHook(void);
 void UnsetHook(void);
 
 /**
- * @brief 전역 키보드 후크 핸들
+ * @brief 후크 메시지, 종료 요청, 제어 채널, 설정 파일 변경, 타이머를 처리하는 이벤트 루프
+ * @details SetHook()을 호출한 스레드에서 실행해야 하며, 종료 키나 제어 채널의 종료 요청이 오면 반환합니다.
+ * @return int 프로그램 종료 코드 (0: 정상 종료, 1: 오류 발생)
  */
-extern HHOOK g_keyboardHook;
+int RunEventLoop(void);
+
+/**
+ * @brief 제어 채널 이름을 지정합니다.
+ * @details SetHook() 전에 호출해야 합니다. 기본값은 CONTROL_CHANNEL_NAME입니다.
+ * @param name 채널 이름 (NULL이나 빈 문자열이면 제어 채널을 열지 않음)
+ * @return BOOL 이름이 너무 길면 FALSE
+ */
+BOOL SetControlChannelName(const char* name);
+
+#if KP_FEATURE_SHADOW
+/**
+ * @brief 그림자(감사 전용) 모드를 켭니다. ([Shadow] Enabled=1과 같음)
+ * @details SetHook() 전에 호출해야 합니다. 키 입력을 차단하지 않고 정책 판정만 집계합니다.
+ */
+void EnableShadowMode(void);
+#endif
 
+#if KP_FEATURE_TRACE
 /**
- * @brief 현재 포커스된 창의 프로세스 실행 파일 이름을 가져옵니다.
- * @param processName 버퍼에 저장될 프로세스 이름 (최대 MAX_PATH)
- * @param bufferSize 버퍼 크기
+ * @brief 키 입력 트레이스 기록을 시작합니다.
+ * @details SetHook() 전에 호출해야 하며, 기록된 파일은 tools/trace_replay로 재생할 수 있습니다.
+ * @param tracePath 트레이스 파일 경로
  * @return BOOL 성공 시 TRUE, 실패 시 FALSE
  */
-BOOL GetCurrentProcessName(char* processName, DWORD bufferSize);
+BOOL StartTraceRecording(const char* tracePath);
+#endif
+
+/**
+ * @brief 전역 키보드 후크 핸들
+ */
+extern HHOOK g_keyboardHook;
 
 /**
  * @brief 특정 프로세스 이름이 허용된 프로세스인지 확인합니다.
@@ -63,16 +76,9 @@ BOOL GetCurrentProcessName(char* processName, DWORD bufferSize);
  */
 BOOL IsAllowedProcess(const char* processName);
 
-/**
- * @brief 복호화된 키 코드를 SendInput을 사용하여 전달합니다.
- * @param vkCode 전달할 가상 키 코드
- * @param isKeyDown 키 다운 이벤트인지 여부 (TRUE: 키 다운, FALSE: 키 업)
- * @return BOOL 성공 시 TRUE, 실패 시 FALSE
- */
-BOOL SendDecryptedKey(DWORD vkCode, BOOL isKeyDown);
-
 /**
  * @brief INI 파일에서 허용된 프로세스 목록을 로드합니다.
+ * @details 새 정책 스냅샷을 만든 뒤 원자적으로 게시합니다. 정책 게시는 이벤트 루프 스레드에서만 해야 합니다.
  * @param iniFilePath INI 파일 경로 (NULL이면 기본 경로 사용)
  * @return BOOL 성공 시 TRUE, 실패 시 FALSE
  */
@@ -80,6 +86,7 @@ BOOL LoadAllowedProcessesFromIni(const char* iniFilePath);
 
 /**
  * @brief 로드된 허용 프로세스 목록을 해제합니다.
+ * @details 후크가 해제된 뒤에만 호출해야 합니다.
  */
 void FreeAllowedProcesses(void);
 
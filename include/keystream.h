@@ -0,0 +1,163 @@
+#ifndef KEYSTREAM_H
+#define KEYSTREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "spsc_ring.h"
+#include "kp_platform.h"
+
+/**
+ * @file keystream.h
+ * @brief ChaCha20 키스트림 엔진과 미리 생성한 키스트림 풀
+ * @details 세션마다 난수 256비트 키를 정하고, 백그라운드 스레드가 ChaCha20 블록을 미리 생성하여
+ *          잠금 없는 SPSC 풀에 32비트 워드 단위로 채워 둡니다. 키 이벤트 하나를 암호화하는 데는
+ *          풀에서 워드 하나를 꺼내 XOR하는 것으로 충분합니다.
+ *
+ *          논스는 (스트림 번호, 세션 난수) 64비트이고 블록 카운터는 64비트입니다.
+ *          백그라운드 스레드는 스트림 0을, 풀이 비었을 때 소비자가 직접 생성하는 예비 경로는
+ *          스트림 1을 사용하므로 두 경로가 같은 키스트림을 재사용하지 않습니다.
+ *
+ *          워드를 꺼낼 때마다 그 워드의 키스트림 위치(스트림 번호와 워드 번호)도 함께 돌려줍니다.
+ *          로그와 저널에는 워드 대신 이 위치만 기록하므로, 세션 키 없이는 암호화된 키 코드를 풀 수 없고
+ *          세션 키를 가진 쪽은 keystream_word_at()으로 워드를 다시 만들어 복호화합니다.
+ */
+
+/** @brief ChaCha20 블록 하나의 워드 수 (64바이트) */
+#define KEYSTREAM_BLOCK_WORDS 16
+
+/** @brief 풀에 담아 두는 키스트림 워드 수 (2의 거듭제곱) */
+#define KEYSTREAM_POOL_WORDS 4096
+
+/** @brief 풀이 이 수준 아래로 내려가면 백그라운드 스레드를 깨움 */
+#define KEYSTREAM_POOL_LOW_WATER (KEYSTREAM_POOL_WORDS / 4)
+
+/** @brief 백그라운드 스레드가 한 번에 생성하는 블록 수 (AVX2 커널 폭) */
+#define KEYSTREAM_BATCH_BLOCKS 8
+
+/** @brief 백그라운드 스레드 스트림 번호 */
+#define KEYSTREAM_STREAM_REFILL 0
+
+/** @brief 풀이 비었을 때 사용하는 예비 스트림 번호 */
+#define KEYSTREAM_STREAM_FALLBACK 1
+
+/** @brief 저널 키로 세션 키를 감쌀 때 쓰는 스트림 번호 (key_journal.h) */
+#define KEYSTREAM_STREAM_JOURNAL 2
+
+/** @brief 키스트림 위치에서 예비 스트림(스트림 1)을 나타내는 비트 */
+#define KEYSTREAM_POSITION_FALLBACK 0x80000000u
+
+/** @brief 키스트림 위치의 워드 번호 비트 (스트림마다 2^31 워드 뒤에는 위치가 되풀이됨) */
+#define KEYSTREAM_POSITION_INDEX 0x7FFFFFFFu
+
+/**
+ * @brief ChaCha20 블록 생성 커널
+ */
+typedef enum keystream_kernel {
+    KEYSTREAM_KERNEL_SCALAR = 0, /**< 이식 가능한 C 구현 */
+    KEYSTREAM_KERNEL_SSE2,       /**< 4블록 병렬 SSE2 */
+    KEYSTREAM_KERNEL_AVX2,       /**< 8블록 병렬 AVX2 */
+    KEYSTREAM_KERNEL_COUNT
+} keystream_kernel;
+
+/**
+ * @brief 키스트림 풀 통계
+ */
+typedef struct keystream_stats {
+    unsigned long words_used;       /**< 소비한 키스트림 워드 수 */
+    unsigned long underflows;       /**< 풀이 비어 예비 스트림으로 생성한 횟수 */
+    unsigned long refill_wakeups;   /**< 백그라운드 스레드를 깨운 횟수 */
+    unsigned long long blocks;      /**< 백그라운드 스레드가 생성한 블록 수 */
+} keystream_stats;
+
+/**
+ * @brief 미리 생성한 키스트림 풀
+ * @details keystream_pool_next()는 한 스레드(작업 스레드)에서만 호출합니다.
+ */
+typedef struct keystream_pool {
+    spsc_ring ring;                          /**< 백그라운드 스레드 → 소비자 워드 큐 */
+    uint32_t storage[KEYSTREAM_POOL_WORDS];  /**< 풀 저장 공간 */
+    uint32_t key[8];                         /**< 세션 키 (256비트) */
+    uint32_t nonce;                          /**< 세션 난수 논스 */
+    keystream_kernel kernel;                 /**< 사용할 블록 생성 커널 */
+
+    uint64_t refill_counter;                 /**< 스트림 0 블록 카운터 (백그라운드 스레드 소유) */
+    uint32_t refill_taken;                   /**< 스트림 0에서 꺼낸 워드 수 = 다음 워드 번호 (소비자 소유) */
+    uint64_t fallback_counter;               /**< 스트림 1 블록 카운터 (소비자 소유) */
+    uint32_t fallback[KEYSTREAM_BLOCK_WORDS];/**< 예비 스트림 블록 */
+    unsigned int fallback_used;              /**< 예비 블록에서 사용한 워드 수 */
+
+    kp_event wake;                           /**< 백그라운드 스레드 깨우기 이벤트 */
+    int refill_sleeping;                     /**< 백그라운드 스레드가 대기 중인지 여부 (원자적 접근) */
+    volatile int stop;                       /**< 백그라운드 스레드 종료 요청 */
+    kp_thread thread;                        /**< 백그라운드 생성 스레드 */
+    keystream_stats stats;                   /**< 통계 */
+} keystream_pool;
+
+/**
+ * @brief 커널을 이 CPU에서 사용할 수 있는지 확인합니다.
+ */
+int keystream_kernel_supported(keystream_kernel kernel);
+
+/**
+ * @brief 이 CPU에서 사용할 수 있는 가장 빠른 커널을 반환합니다.
+ */
+keystream_kernel keystream_best_kernel(void);
+
+/**
+ * @brief 커널 이름을 반환합니다.
+ */
+const char* keystream_kernel_name(keystream_kernel kernel);
+
+/**
+ * @brief ChaCha20 키스트림 블록을 연속으로 생성합니다.
+ * @param kernel 사용할 커널 (지원하지 않으면 스칼라 커널 사용)
+ * @param key 256비트 키
+ * @param stream 스트림 번호 (논스 앞 32비트)
+ * @param nonce 세션 논스 (논스 뒤 32비트)
+ * @param counter 첫 블록 카운터
+ * @param out 출력 버퍼 (blocks * KEYSTREAM_BLOCK_WORDS 워드)
+ * @param blocks 생성할 블록 수
+ */
+void keystream_generate(keystream_kernel kernel, const uint32_t key[8], uint32_t stream, uint32_t nonce,
+                        uint64_t counter, uint32_t* out, size_t blocks);
+
+/**
+ * @brief 풀을 초기화하고 백그라운드 생성 스레드를 시작합니다.
+ * @details 시작 전에 풀을 가득 채워 두므로 첫 키 입력부터 워드를 꺼낼 수 있습니다.
+ *          커널은 keystream_best_kernel()로 고르며, KP_KEYSTREAM_KERNEL(kp_config.h)로 고정한 빌드에서는 그 커널을 씁니다.
+ * @param pool 초기화할 풀
+ * @param key 256비트 키 (NULL이면 세션 난수 키 생성)
+ * @param nonce 세션 논스 (key가 NULL이면 무시하고 난수 사용)
+ * @return int 성공 시 1, 실패 시 0
+ */
+int keystream_pool_start(keystream_pool* pool, const uint32_t key[8], uint32_t nonce);
+
+/**
+ * @brief 다음 키스트림 워드를 꺼냅니다. (소비자 스레드 전용)
+ * @details 풀이 비어 있으면 예비 스트림 블록을 직접 생성하므로 항상 성공합니다.
+ * @param pool 풀
+ * @param position 꺼낸 워드의 키스트림 위치를 돌려받을 포인터 (기록해도 되는 공개 값, NULL 가능)
+ * @return uint32_t 키스트림 워드 (비밀 값, 로그나 저널에 남기지 않음)
+ */
+uint32_t keystream_pool_next(keystream_pool* pool, uint32_t* position);
+
+/**
+ * @brief 키스트림 위치의 워드를 다시 만듭니다. (저널 조회 등 세션 키를 가진 복호화 쪽)
+ * @param key 세션 키
+ * @param nonce 세션 논스
+ * @param position keystream_pool_next()가 돌려준 위치
+ * @return uint32_t 그 위치의 키스트림 워드
+ */
+uint32_t keystream_word_at(const uint32_t key[8], uint32_t nonce, uint32_t position);
+
+/**
+ * @brief 통계 사본을 가져옵니다. (근사값)
+ */
+void keystream_pool_get_stats(const keystream_pool* pool, keystream_stats* stats);
+
+/**
+ * @brief 백그라운드 스레드를 멈추고 키 자료를 지웁니다.
+ */
+void keystream_pool_stop(keystream_pool* pool);
+
+#endif // KEYSTREAM_H
@@ -0,0 +1,39 @@
+#ifndef KP_ATOMIC_H
+#define KP_ATOMIC_H
+
+/**
+ * @file kp_atomic.h
+ * @brief 스레드 간 공유 변수에 사용하는 원자 연산 매크로
+ * @details C99에는 표준 원자 연산이 없으므로 GCC(MinGW-w64 포함)의 __atomic 내장 함수를 감쌉니다.
+ *          후크 스레드와 백그라운드 스레드가 공유하는 모든 값은 이 매크로를 통해서만 접근합니다.
+ */
+
+/** @brief 획득(acquire) 의미의 원자적 읽기 */
+#define kp_atomic_load(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+
+/** @brief 순서 보장이 필요 없는 원자적 읽기 (통계 카운터 등) */
+#define kp_atomic_load_relaxed(ptr) __atomic_load_n((ptr), __ATOMIC_RELAXED)
+
+/** @brief 해제(release) 의미의 원자적 쓰기 */
+#define kp_atomic_store(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+
+/** @brief 순서 보장이 필요 없는 원자적 쓰기 */
+#define kp_atomic_store_relaxed(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_RELAXED)
+
+/** @brief 원자적 덧셈 후 이전 값 반환 */
+#define kp_atomic_fetch_add(ptr, value) __atomic_fetch_add((ptr), (value), __ATOMIC_ACQ_REL)
+
+/** @brief 통계 카운터용 원자적 덧셈 (순서 보장 없음) */
+#define kp_atomic_add_relaxed(ptr, value) ((void)__atomic_fetch_add((ptr), (value), __ATOMIC_RELAXED))
+
+/** @brief 원자적 교환 후 이전 값 반환 */
+#define kp_atomic_exchange(ptr, value) __atomic_exchange_n((ptr), (value), __ATOMIC_ACQ_REL)
+
+/** @brief 원자적 비교 후 교환, 성공 시 0이 아닌 값 반환 */
+#define kp_atomic_compare_exchange(ptr, expected, desired) \
+    __atomic_compare_exchange_n((ptr), (expected), (desired), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+/** @brief 앞뒤 메모리 접근의 순서를 모두 보장하는 울타리 (쓰기 후 다른 변수 읽기 순서가 중요할 때) */
+#define kp_atomic_fence() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#endif // KP_ATOMIC_H
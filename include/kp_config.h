@@ -0,0 +1,96 @@
+#ifndef KP_CONFIG_H
+#define KP_CONFIG_H
+
+/**
+ * @file kp_config.h
+ * @brief 컴파일 시점 기능 선택 매크로
+ * @details 빌드 변형(make release-lean 등)이 -D로 넘기는 설정 매크로의 기본값을 한곳에서 정합니다.
+ *          기본 빌드는 모든 기능을 켜고 실행 중에 설정으로 고르며, KP_LEAN을 정의하면 부가 기능을 빼고
+ *          처리 코어의 백엔드 호출과 키스트림 커널을 컴파일 시점에 고정합니다.
+ *          각 매크로는 KP_LEAN과 함께 개별로 덮어쓸 수 있습니다. (예: -DKP_LEAN -DKP_EXIT_KEY=0x1B)
+ */
+
+/** @brief KP_EXIT_KEY 값: 종료 키를 실행 중에 [KeyPolicy] ExitKey로 정함 */
+#define KP_EXIT_KEY_RUNTIME (-1)
+
+/** @brief KP_KEYSTREAM_KERNEL 값: 키스트림 커널을 실행 중에 CPU 기능으로 고름 */
+#define KP_KEYSTREAM_KERNEL_RUNTIME (-1)
+
+#ifdef KP_LEAN
+#ifndef KP_FEATURE_KEY_LOG
+#define KP_FEATURE_KEY_LOG 0
+#endif
+#ifndef KP_FEATURE_SHADOW
+#define KP_FEATURE_SHADOW 0
+#endif
+#ifndef KP_FEATURE_TRACE
+#define KP_FEATURE_TRACE 0
+#endif
+#ifndef KP_FEATURE_STAGE_TIMING
+#define KP_FEATURE_STAGE_TIMING 0
+#endif
+#ifndef KP_EXIT_KEY
+#define KP_EXIT_KEY 0
+#endif
+#ifndef KP_STATIC_BACKEND
+#define KP_STATIC_BACKEND 1
+#endif
+// 대상 명령어 집합(-m 옵션)이 보장하는 가장 넓은 커널로 고정
+#ifndef KP_KEYSTREAM_KERNEL
+#if defined(__AVX2__)
+#define KP_KEYSTREAM_KERNEL 2
+#elif defined(__SSE2__)
+#define KP_KEYSTREAM_KERNEL 1
+#else
+#define KP_KEYSTREAM_KERNEL 0
+#endif
+#endif
+#endif // KP_LEAN
+
+/** @brief 키 단위 로그 링과 이진 저널 (0이면 처리 코어의 판정 기록과 로그 드레인 스레드가 빠짐) */
+#ifndef KP_FEATURE_KEY_LOG
+#define KP_FEATURE_KEY_LOG 1
+#endif
+
+/** @brief 그림자(감사 전용) 모드와 후보 정책 비교 ([Shadow], --shadow, kp_ctl shadow-report) */
+#ifndef KP_FEATURE_SHADOW
+#define KP_FEATURE_SHADOW 1
+#endif
+
+/** @brief 키 입력 트레이스 기록 (--record) */
+#ifndef KP_FEATURE_TRACE
+#define KP_FEATURE_TRACE 1
+#endif
+
+/** @brief 처리 코어의 단계별 소요 시간 측정 (암호화/프로세스 확인/주입 히스토그램) */
+#ifndef KP_FEATURE_STAGE_TIMING
+#define KP_FEATURE_STAGE_TIMING 1
+#endif
+
+/**
+ * @brief 종료 키 가상 키 코드
+ * @details KP_EXIT_KEY_RUNTIME이면 [KeyPolicy] ExitKey를 따르고, 0이면 종료 키 검사가 후크에서 빠지며
+ *          (kp_ctl shutdown으로 종료), 그 밖의 값이면 그 키로 고정합니다.
+ */
+#ifndef KP_EXIT_KEY
+#define KP_EXIT_KEY KP_EXIT_KEY_RUNTIME
+#endif
+
+/**
+ * @brief 처리 코어가 솔트 생성과 주입을 함수 포인터 대신 kp_backend_* 함수로 직접 호출할지 여부
+ * @details 1이면 처리 코어를 링크하는 프로그램이 kp_backend_make_salt()와 kp_backend_inject()를 정의해야 하며,
+ *          링크 시간 최적화로 두 함수가 처리 코어 안에 인라인될 수 있습니다.
+ */
+#ifndef KP_STATIC_BACKEND
+#define KP_STATIC_BACKEND 0
+#endif
+
+/**
+ * @brief 키스트림 풀을 채우는 커널 (keystream_kernel 값, KP_KEYSTREAM_KERNEL_RUNTIME이면 CPU 기능으로 고름)
+ * @details 고정한 커널은 실행할 CPU가 지원해야 합니다.
+ */
+#ifndef KP_KEYSTREAM_KERNEL
+#define KP_KEYSTREAM_KERNEL KP_KEYSTREAM_KERNEL_RUNTIME
+#endif
+
+#endif // KP_CONFIG_H
@@ -0,0 +1,222 @@
+#ifndef KP_PLATFORM_H
+#define KP_PLATFORM_H
+
+/**
+ * @file kp_platform.h
+ * @brief 스레드, 대기, 고해상도 시계, 공유 메모리, 파일 매핑을 감싸는 플랫폼 추상화 계층
+ * @details Windows에서는 Win32 API를, 그 외 환경에서는 POSIX API를 사용합니다.
+ *          이 헤더는 windows.h를 포함하지 않으므로 플랫폼 중립 모듈에서도 사용할 수 있습니다.
+ */
+
+#include <stddef.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+/**
+ * @brief 스레드 진입 함수 형식
+ */
+typedef void (*kp_thread_fn)(void* arg);
+
+/**
+ * @brief 플랫폼 스레드 핸들
+ */
+typedef struct kp_thread {
+#ifdef _WIN32
+    void* handle;        /**< Win32 스레드 핸들 (HANDLE) */
+#else
+    pthread_t handle;    /**< POSIX 스레드 핸들 */
+#endif
+    kp_thread_fn fn;     /**< 스레드 진입 함수 */
+    void* arg;           /**< 진입 함수 인자 */
+    int started;         /**< 스레드가 시작되었는지 여부 */
+} kp_thread;
+
+/**
+ * @brief 자동 리셋 이벤트 (한 번 신호하면 대기 중인 스레드 하나를 깨움)
+ */
+typedef struct kp_event {
+#ifdef _WIN32
+    void* handle;           /**< Win32 이벤트 핸들 (HANDLE) */
+#else
+    pthread_mutex_t mutex;  /**< 신호 상태 보호용 뮤텍스 */
+    pthread_cond_t cond;    /**< 대기용 조건 변수 */
+    int signaled;           /**< 신호 상태 */
+#endif
+} kp_event;
+
+/**
+ * @brief 이름 있는 자동 리셋 이벤트 (다른 프로세스와 공유)
+ * @details Windows에서는 이름 있는 이벤트, 그 외에서는 이름 있는 세마포어(sem_open)를 사용합니다.
+ */
+typedef struct kp_named_event {
+    void* handle;           /**< 이벤트 핸들 (HANDLE) 또는 sem_t* */
+    int owner;              /**< 만든 프로세스인지 여부 (닫을 때 이름 제거) */
+    char name[64];          /**< sem_open 이름 (POSIX) */
+} kp_named_event;
+
+/**
+ * @brief 이름 있는 공유 메모리 매핑 (다른 프로세스에서 읽을 수 있음)
+ */
+typedef struct kp_shared_memory {
+    void* address;          /**< 매핑된 주소 */
+    size_t size;            /**< 매핑 크기 */
+#ifdef _WIN32
+    void* handle;           /**< 파일 매핑 핸들 (HANDLE) */
+#else
+    int owner;              /**< 만든 프로세스인지 여부 (닫을 때 이름 제거) */
+    char name[64];          /**< shm_open 이름 */
+#endif
+} kp_shared_memory;
+
+/**
+ * @brief 읽기 전용 파일 매핑
+ */
+typedef struct kp_mapped_file {
+    const void* address;    /**< 매핑된 주소 (빈 파일이면 NULL) */
+    size_t size;            /**< 매핑한 시점의 파일 크기 */
+} kp_mapped_file;
+
+/**
+ * @brief 새 스레드를 시작합니다.
+ * @param thread 스레드 핸들 (호출자가 수명을 관리)
+ * @param fn 스레드 진입 함수
+ * @param arg 진입 함수 인자
+ * @return int 성공 시 1, 실패 시 0
+ */
+int kp_thread_start(kp_thread* thread, kp_thread_fn fn, void* arg);
+
+/**
+ * @brief 스레드가 끝날 때까지 기다린 뒤 핸들을 정리합니다.
+ * @param thread 시작된 스레드 핸들 (시작되지 않았으면 아무 것도 하지 않음)
+ */
+void kp_thread_join(kp_thread* thread);
+
+/**
+ * @brief 자동 리셋 이벤트를 만듭니다. (신호 없음 상태)
+ * @return int 성공 시 1, 실패 시 0
+ */
+int kp_event_init(kp_event* event);
+
+/**
+ * @brief 이벤트에 신호를 보냅니다.
+ */
+void kp_event_signal(kp_event* event);
+
+/**
+ * @brief 신호가 오거나 시간이 지날 때까지 기다립니다.
+ * @return int 신호를 받았으면 1, 시간 초과면 0
+ */
+int kp_event_wait(kp_event* event, unsigned int timeout_ms);
+
+/**
+ * @brief 이벤트를 해제합니다.
+ */
+void kp_event_destroy(kp_event* event);
+
+/**
+ * @brief 지정한 시간 동안 현재 스레드를 재웁니다.
+ * @param milliseconds 대기 시간 (밀리초)
+ */
+void kp_sleep_ms(unsigned int milliseconds);
+
+/**
+ * @brief 단조 증가하는 고해상도 시계 값을 반환합니다.
+ * @details Windows에서는 QueryPerformanceCounter, 그 외에서는 clock_gettime(CLOCK_MONOTONIC)을 사용합니다.
+ * @return unsigned long long 나노초 단위 시각
+ */
+unsigned long long kp_now_ns(void);
+
+/**
+ * @brief 현재 UTC 시각을 반환합니다.
+ * @details 호스트 간에 비교할 수 있도록 1970-01-01 기준 나노초로 반환합니다. 단조 증가는 보장하지 않습니다.
+ * @return unsigned long long 유닉스 시각 (나노초)
+ */
+unsigned long long kp_wall_time_ns(void);
+
+/**
+ * @brief 이름 있는 공유 메모리를 만들고 0으로 채워 매핑합니다.
+ * @details Windows에서는 "Local\\<이름>" 페이징 파일 매핑, 그 외에서는 shm_open("/<이름>")을 사용합니다.
+ *          POSIX에서는 Windows의 기본 보안 설명자와 같이 만든 사용자만 접근할 수 있습니다.
+ * @param shm 공유 메모리 핸들
+ * @param name 매핑 이름 (접두사 없이)
+ * @param size 매핑 크기 (바이트)
+ * @return int 성공 시 1, 실패 시 0
+ */
+int kp_shared_memory_create(kp_shared_memory* shm, const char* name, size_t size);
+
+/**
+ * @brief 다른 프로세스가 만든 공유 메모리를 읽기 전용으로 매핑합니다.
+ * @return int 성공 시 1, 없으면 0
+ */
+int kp_shared_memory_open(kp_shared_memory* shm, const char* name, size_t size);
+
+/**
+ * @brief 다른 프로세스가 만든 공유 메모리를 읽기/쓰기로 매핑합니다.
+ * @details 소비자가 읽은 위치를 되돌려 써야 하는 링 버퍼 등에 사용합니다.
+ * @return int 성공 시 1, 없으면 0
+ */
+int kp_shared_memory_attach(kp_shared_memory* shm, const char* name, size_t size);
+
+/**
+ * @brief 매핑을 해제합니다. (만든 프로세스라면 이름도 제거)
+ */
+void kp_shared_memory_close(kp_shared_memory* shm);
+
+/**
+ * @brief 이름 있는 자동 리셋 이벤트를 만듭니다. (신호 없음 상태)
+ * @details 같은 이름의 이벤트가 이미 있으면 실패합니다. (POSIX에서는 이전 실행이 남긴 세마포어를 지우고 다시 만듦)
+ * @return int 성공 시 1, 실패 시 0
+ */
+int kp_named_event_create(kp_named_event* event, const char* name);
+
+/**
+ * @brief 다른 프로세스가 만든 이벤트를 엽니다.
+ * @return int 성공 시 1, 없으면 0
+ */
+int kp_named_event_open(kp_named_event* event, const char* name);
+
+/**
+ * @brief 이벤트에 신호를 보냅니다. (이미 신호 상태면 아무 일도 하지 않음)
+ */
+void kp_named_event_signal(kp_named_event* event);
+
+/**
+ * @brief 신호가 오거나 시간이 지날 때까지 기다립니다.
+ * @return int 신호를 받았으면 1, 시간 초과면 0
+ */
+int kp_named_event_wait(kp_named_event* event, unsigned int timeout_ms);
+
+/**
+ * @brief 이벤트를 닫습니다. (만든 프로세스라면 이름도 제거)
+ */
+void kp_named_event_close(kp_named_event* event);
+
+/**
+ * @brief 파일 전체를 읽기 전용으로 매핑합니다.
+ * @details 매핑한 뒤 다른 프로세스가 파일 끝에 덧붙인 내용은 보이지 않습니다.
+ * @return int 성공 시 1 (빈 파일도 성공), 파일을 열 수 없으면 0
+ */
+int kp_file_map(kp_mapped_file* map, const char* path);
+
+/**
+ * @brief 파일 매핑을 해제합니다.
+ */
+void kp_file_unmap(kp_mapped_file* map);
+
+/**
+ * @brief 현재 프로세스 ID를 반환합니다.
+ */
+unsigned long kp_process_id(void);
+
+/**
+ * @brief 운영체제의 암호학적 난수 생성기로 버퍼를 채웁니다.
+ * @details Windows에서는 RtlGenRandom(SystemFunction036), 그 외에서는 /dev/urandom을 사용합니다.
+ * @param buffer 채울 버퍼
+ * @param size 버퍼 크기
+ * @return int 성공 시 1, 실패 시 0
+ */
+int kp_random_bytes(void* buffer, unsigned long size);
+
+#endif // KP_PLATFORM_H
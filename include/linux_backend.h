@@ -0,0 +1,188 @@
+#ifndef LINUX_BACKEND_H
+#define LINUX_BACKEND_H
+
+#include <stddef.h>
+#include <linux/input.h>
+
+/**
+ * @file linux_backend.h
+ * @brief 처리 코어가 사용하는 Linux 입력 계층 (evdev 입력, uinput 출력, 키 코드 변환)
+ * @details win32_backend.h의 Linux 대응입니다. 키보드 장치 노드(/dev/input/event*)를 EVIOCGRAB으로 독점하여
+ *          다른 프로그램에 키가 가지 않게 하고, epoll로 깨어날 때마다 준비된 장치의 이벤트를 한꺼번에 읽습니다.
+ *          허용된 키는 uinput 가상 키보드로 다시 내보내며, 깨어남 한 번에 모인 출력은 write() 한 번으로 씁니다.
+ *
+ *          처리 코어는 Win32 가상 키 코드로 판정하므로 evdev 키 코드와 가상 키 코드를 서로 변환합니다.
+ *          실제 장치 대신 FIFO나 파이프(struct input_event 레코드 스트림)를 입력으로, 일반 파일이나 FIFO를
+ *          출력으로 쓸 수 있으므로 장치 권한 없이도 같은 코드 경로를 시험할 수 있습니다. (tools/evdev_feed)
+ */
+
+/** @brief 동시에 읽을 수 있는 입력 장치 수 */
+#define LINUX_INPUT_MAX_DEVICES 16
+
+/** @brief 장치 경로 최대 길이 */
+#define LINUX_INPUT_PATH_SIZE 128
+
+/** @brief 출력 버퍼에 모을 수 있는 이벤트 수 (가득 차면 바로 씀) */
+#define LINUX_SINK_BATCH 512
+
+/** @brief 출력 장치가 다룰 수 있는 evdev 키 코드 범위 */
+#define LINUX_SINK_KEYS 0x300
+
+/** @brief uinput 가상 키보드 이름 (장치 자동 검색에서 제외) */
+#define LINUX_UINPUT_NAME "Keyboard Protector"
+
+/**
+ * @brief 입력 장치 하나
+ */
+typedef struct linux_input_device {
+    int fd;                             /**< 장치 파일 디스크립터 (-1이면 빈 자리) */
+    int grabbed;                        /**< EVIOCGRAB으로 독점했는지 여부 */
+    int fake;                           /**< FIFO나 파이프 등 evdev 장치가 아닌 입력인지 여부 */
+    size_t partial;                     /**< 이전 read()에서 남은 불완전한 레코드 바이트 수 (가짜 장치) */
+    unsigned char pending[sizeof(struct input_event)]; /**< 불완전한 레코드 */
+    unsigned long events;               /**< 읽은 이벤트 수 */
+    char path[LINUX_INPUT_PATH_SIZE];   /**< 장치 경로 ("-"이면 표준 입력) */
+} linux_input_device;
+
+/**
+ * @brief 입력 장치 묶음과 epoll 대기 상태
+ */
+typedef struct linux_input {
+    int epoll_fd;                       /**< epoll 인스턴스 */
+    linux_input_device devices[LINUX_INPUT_MAX_DEVICES]; /**< 입력 장치 */
+    int open_devices;                   /**< 열려 있는 장치 수 (0이 되면 입력 끝) */
+    unsigned long wakeups;              /**< 이벤트를 읽은 epoll 깨어남 수 */
+    unsigned long reads;                /**< read() 호출 수 */
+    unsigned long events;               /**< 읽은 이벤트 수 */
+} linux_input;
+
+/**
+ * @brief 키 출력 장치 (uinput 또는 가짜 출력 파일)
+ * @details 가짜 출력도 uinput에 쓰는 것과 같은 struct input_event 레코드를 그대로 기록합니다.
+ */
+typedef struct linux_sink {
+    int fd;                             /**< 출력 파일 디스크립터 */
+    int uinput;                         /**< uinput 장치인지 여부 (닫을 때 UI_DEV_DESTROY) */
+    int frame_open;                     /**< 마지막 SYN_REPORT 이후 쓴 키 이벤트가 있는지 여부 */
+    size_t count;                       /**< 버퍼에 모인 이벤트 수 */
+    struct input_event buffer[LINUX_SINK_BATCH]; /**< 다음 write()로 쓸 이벤트 */
+    unsigned char down[LINUX_SINK_KEYS / 8]; /**< 출력 쪽에서 눌린 키 비트맵 (자동 반복 값 2와 종료 시 키 떼기용) */
+    unsigned long keys;                 /**< 내보낸 키 이벤트 수 */
+    unsigned long writes;               /**< write() 호출 수 */
+    unsigned long errors;               /**< 쓰기 실패 수 */
+} linux_sink;
+
+/**
+ * @brief evdev 키 코드를 가상 키 코드로 바꿉니다.
+ * @return unsigned int 가상 키 코드 (대응하는 키가 없으면 0)
+ */
+unsigned int linux_keymap_to_vk(unsigned int code);
+
+/**
+ * @brief 가상 키 코드를 evdev 키 코드로 바꿉니다.
+ * @return unsigned int evdev 키 코드 (대응하는 키가 없으면 0)
+ */
+unsigned int linux_keymap_from_vk(unsigned int vk_code);
+
+/**
+ * @brief 가상 키 코드가 없는 evdev 키 코드가 판정 없이 그대로 내보내도 되는 키인지 확인합니다.
+ * @details 문자를 입력하지 않는 전원/밝기/미디어/무선 키만 명시적으로 허용합니다. KEY_YEN, KEY_RO, KEY_KPEQUAL,
+ *          KEY_KPCOMMA, KEY_HENKAN처럼 문자를 입력할 수 있는 나머지 키는 판정과 암호화를 우회하지 않도록 차단합니다.
+ * @return int 통과시킬 키이면 1, 아니면 0
+ */
+int linux_keymap_passthrough(unsigned int code);
+
+/**
+ * @brief 입력 장치 묶음을 초기화합니다. (장치 없음)
+ * @return int 성공 시 1, epoll을 만들 수 없으면 0
+ */
+int linux_input_init(linux_input* input);
+
+/**
+ * @brief 입력 장치를 엽니다.
+ * @details evdev 장치라면 타임스탬프를 CLOCK_MONOTONIC으로 바꾸고, 눌린 키가 모두 떼어질 때까지(최대 1초) 기다린 뒤
+ *          grab이 0이 아니면 EVIOCGRAB으로 독점합니다. 문자 장치가 아니면 가짜 장치로 보고 레코드 스트림으로 읽습니다.
+ * @param input 입력 장치 묶음
+ * @param path 장치 경로 ("-"이면 표준 입력)
+ * @param grab 독점 여부
+ * @return int 성공 시 1, 실패 시 0
+ */
+int linux_input_add_device(linux_input* input, const char* path, int grab);
+
+/**
+ * @brief /dev/input/event*에서 문자 키를 가진 키보드를 모두 찾아 엽니다.
+ * @details 이 프로그램이 만든 uinput 가상 키보드(LINUX_UINPUT_NAME)는 제외합니다.
+ * @return int 연 장치 수
+ */
+int linux_input_add_keyboards(linux_input* input, int grab);
+
+/**
+ * @brief 장치 외에 함께 기다릴 파일 디스크립터를 등록합니다. (포그라운드 변경 알림 등)
+ * @return int 성공 시 1, 실패 시 0
+ */
+int linux_input_watch(linux_input* input, int fd);
+
+/**
+ * @brief 입력을 기다린 뒤 준비된 모든 장치에서 이벤트를 한꺼번에 읽습니다.
+ * @details 장치마다 읽을 수 있는 만큼(버퍼가 찰 때까지) 읽으며, 끝에 이른 가짜 장치나 분리된 장치는 닫습니다.
+ * @param input 입력 장치 묶음
+ * @param events 이벤트를 받을 버퍼
+ * @param capacity 버퍼 크기 (이벤트 수)
+ * @param timeout_ms 최대 대기 시간 (밀리초, -1이면 무한)
+ * @param watch_ready 등록한 파일 디스크립터가 읽을 수 있게 되었으면 1을 받음 (NULL 가능)
+ * @return int 읽은 이벤트 수 (시간 초과나 신호면 0), 오류면 -1
+ */
+int linux_input_wait(linux_input* input, struct input_event* events, size_t capacity, int timeout_ms,
+                     int* watch_ready);
+
+/**
+ * @brief 모든 장치의 독점을 풀고 닫습니다.
+ */
+void linux_input_close(linux_input* input);
+
+/**
+ * @brief uinput 가상 키보드를 만듭니다.
+ * @return int 성공 시 1, 실패 시 0 (/dev/uinput 권한 필요)
+ */
+int linux_sink_open_uinput(linux_sink* sink, const char* name);
+
+/**
+ * @brief 가짜 출력 파일(또는 FIFO)을 엽니다. 기존 파일은 비웁니다.
+ * @return int 성공 시 1, 실패 시 0
+ */
+int linux_sink_open_file(linux_sink* sink, const char* path);
+
+/**
+ * @brief 키 이벤트 하나를 출력 버퍼에 넣습니다.
+ * @details 이미 눌린 키의 키 다운은 자동 반복(값 2)으로 내보냅니다. 버퍼가 가득 차면 바로 씁니다.
+ * @param sink 출력 장치
+ * @param code evdev 키 코드
+ * @param key_down 키 다운 여부
+ * @return int 성공 시 1, 범위를 벗어난 코드나 쓰기 실패 시 0
+ */
+int linux_sink_key(linux_sink* sink, unsigned int code, int key_down);
+
+/**
+ * @brief 가상 키 코드가 없는 키 이벤트를 통과 허용 목록에 있을 때만 출력 버퍼에 넣습니다.
+ * @details 허용 목록(linux_keymap_passthrough)에 없는 키는 포그라운드와 관계없이 내보내지 않습니다.
+ * @return int 내보냈으면 1, 차단했거나 쓰기에 실패했으면 0
+ */
+int linux_sink_unmapped_key(linux_sink* sink, unsigned int code, int key_down);
+
+/**
+ * @brief 입력 프레임이 끝났음을 표시합니다. (키 이벤트를 넣은 뒤라면 SYN_REPORT 추가)
+ */
+void linux_sink_sync(linux_sink* sink);
+
+/**
+ * @brief 모인 이벤트를 프레임을 닫은 뒤 write() 한 번으로 씁니다.
+ * @return int 성공 시 1, 쓰기 실패 시 0
+ */
+int linux_sink_flush(linux_sink* sink);
+
+/**
+ * @brief 눌린 채 남은 키를 모두 뗀 뒤 출력 장치를 닫습니다.
+ */
+void linux_sink_close(linux_sink* sink);
+
+#endif // LINUX_BACKEND_H
@@ -0,0 +1,55 @@
+#ifndef LINUX_FOREGROUND_H
+#define LINUX_FOREGROUND_H
+
+#include "foreground_cache.h"
+
+/**
+ * @file linux_foreground.h
+ * @brief Linux 포그라운드 프로세스 조회 공급자
+ * @details Linux에는 X11, Wayland 합성기마다 다른 포그라운드 창 API만 있으므로, 처리 코어는 공급자 인터페이스
+ *          (process_lookup_provider)로만 조회하고 공급자를 실행할 때 고릅니다.
+ *
+ *          - 파일 공급자: 창 관리자 훅이나 스크립트(예: xdotool, swaymsg 구독)가 포그라운드가 바뀔 때마다 파일에
+ *            "<PID> [<창 번호>]" 또는 프로세스 이름을 씁니다. PID이면 /proc에서 실행 파일 이름과 시작 시각을 읽습니다.
+ *            파일이 있는 디렉토리를 inotify로 감시하므로 이벤트 루프가 알림을 받을 때만 판정 캐시를 무효화합니다.
+ *          - 고정 공급자: 항상 같은 프로세스 이름을 돌려줍니다. (가짜 장치로 시험할 때)
+ *
+ *          조회는 판정 캐시가 무효화된 뒤 첫 키에서만 일어나므로 키 입력마다 파일을 읽지 않습니다.
+ */
+
+/**
+ * @brief 포그라운드 공급자 상태
+ */
+typedef struct linux_foreground {
+    process_lookup_provider provider;   /**< 판정 캐시에 넘길 공급자 (context는 이 구조체) */
+    int notify_fd;                      /**< 이벤트 루프가 기다릴 변경 알림 (inotify, 없으면 -1) */
+    char path[FOREGROUND_NAME_SIZE];    /**< 포그라운드 파일 경로 (파일 공급자) */
+    const char* file_name;              /**< path에서 디렉토리를 뺀 파일 이름 (알림 거르기용) */
+    char name[FOREGROUND_NAME_SIZE];    /**< 마지막으로 확인한 프로세스 이름 (고정 공급자는 고정 이름) */
+    unsigned long changes;              /**< 포그라운드 파일 변경 알림 수 */
+} linux_foreground;
+
+/**
+ * @brief 파일 공급자를 엽니다.
+ * @details 파일이 아직 없어도 성공하며, 파일이 생기기 전까지 포그라운드는 확인 불가(차단)입니다.
+ * @return int 성공 시 1, 디렉토리를 감시할 수 없으면 0
+ */
+int linux_foreground_open_file(linux_foreground* foreground, const char* path);
+
+/**
+ * @brief 고정 공급자를 엽니다.
+ */
+void linux_foreground_open_fixed(linux_foreground* foreground, const char* name);
+
+/**
+ * @brief 변경 알림을 모두 읽습니다. (이벤트 루프에서 notify_fd가 준비되면 호출)
+ * @return int 포그라운드 파일이 바뀌었으면 1 (판정 캐시를 무효화해야 함), 아니면 0
+ */
+int linux_foreground_drain(linux_foreground* foreground);
+
+/**
+ * @brief 공급자를 닫습니다.
+ */
+void linux_foreground_close(linux_foreground* foreground);
+
+#endif // LINUX_FOREGROUND_H
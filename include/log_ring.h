@@ -0,0 +1,112 @@
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <stdio.h>
+#include "spsc_ring.h"
+
+/**
+ * @file log_ring.h
+ * @brief 후크 스레드용 비동기 이진 로그 링
+ * @details 후크는 포맷팅이나 할당 없이 고정 크기 이벤트 레코드만 기록하고,
+ *          백그라운드 드레인 스레드가 문자열 포맷팅과 콘솔/파일 출력을 담당합니다.
+ */
+
+/** @brief 링에 담을 수 있는 레코드 수 (2의 거듭제곱) */
+#define LOG_RING_CAPACITY 4096
+
+/** @brief 인턴할 수 있는 프로세스 이름 수 */
+#define LOG_NAME_SLOTS 256
+
+/** @brief 프로세스 이름 최대 길이 */
+#define LOG_NAME_SIZE 260
+
+/** @brief 인턴 테이블이 가득 찼거나 이름이 없을 때 사용하는 인덱스 */
+#define LOG_NAME_NONE 0xFFFFu
+
+/**
+ * @brief 로그 상세 수준 (config.ini [Logging] Verbosity)
+ */
+typedef enum log_verbosity {
+    LOG_VERBOSITY_OFF = 0,     /**< 키 단위 로그를 기록하지 않음 */
+    LOG_VERBOSITY_BLOCKED = 1, /**< 차단 및 조회 실패만 기록 */
+    LOG_VERBOSITY_ALL = 2      /**< 모든 키 입력 기록 (기본값) */
+} log_verbosity;
+
+/**
+ * @brief 키 이벤트 판정
+ */
+typedef enum log_verdict {
+    LOG_VERDICT_ALLOWED = 0, /**< 허용된 프로세스로 복호화되어 전달됨 */
+    LOG_VERDICT_BLOCKED = 1, /**< 허용되지 않은 프로세스라서 차단됨 */
+    LOG_VERDICT_UNKNOWN = 2  /**< 프로세스를 확인할 수 없어 차단됨 */
+} log_verdict;
+
+/**
+ * @brief 후크가 기록하는 고정 크기 이벤트 레코드
+ */
+typedef struct log_record {
+    unsigned long long timestamp_ns; /**< 이벤트 시각 (kp_now_ns) */
+    unsigned int salt;               /**< 암호화에 사용한 솔트 (키스트림 위치, 워드 자체는 기록하지 않음) */
+    unsigned int encrypted_keycode;  /**< 암호화된 키 코드 */
+    unsigned short vk_code;          /**< 원본 가상 키 코드 */
+    unsigned short name_id;          /**< 인턴된 프로세스 이름 인덱스 */
+    unsigned char verdict;           /**< log_verdict 값 */
+    unsigned char reserved;          /**< 정렬용 예약 공간 */
+    unsigned short repeats;          /**< 합쳐진 자동 반복 횟수 (0이면 새 키 다운) */
+} log_record;
+
+/**
+ * @brief 비동기 로그 링
+ */
+typedef struct log_ring {
+    spsc_ring ring;                          /**< 레코드 전달용 SPSC 링 */
+    log_record storage[LOG_RING_CAPACITY];   /**< 링 저장 공간 */
+    int verbosity;                           /**< log_verbosity 값 (원자적 접근) */
+    unsigned long dropped;                   /**< 링이 가득 차서 버려진 레코드 수 */
+    unsigned long reported_dropped;          /**< 드레인 스레드가 마지막으로 보고한 손실 수 */
+
+    unsigned long name_count;                      /**< 인턴된 이름 수 (생산자가 release로 게시) */
+    char names[LOG_NAME_SLOTS][LOG_NAME_SIZE];     /**< 추가만 가능한 이름 테이블 */
+} log_ring;
+
+/**
+ * @brief 로그 링을 초기화합니다.
+ * @param log 초기화할 로그 링
+ * @param verbosity 초기 상세 수준
+ */
+void log_ring_init(log_ring* log, int verbosity);
+
+/**
+ * @brief 상세 수준을 변경합니다. (어느 스레드에서든 호출 가능)
+ */
+void log_ring_set_verbosity(log_ring* log, int verbosity);
+
+/**
+ * @brief 주어진 판정의 레코드를 기록해야 하는지 확인합니다.
+ * @return int 기록해야 하면 1
+ */
+int log_ring_wants(const log_ring* log, int verdict);
+
+/**
+ * @brief 프로세스 이름을 인턴하고 인덱스를 반환합니다. (생산자 전용)
+ * @details 이름이 바뀔 때만 호출하도록 하여 키 입력마다 문자열 비교를 하지 않습니다.
+ * @return unsigned short 이름 인덱스, 테이블이 가득 차면 LOG_NAME_NONE
+ */
+unsigned short log_ring_intern_name(log_ring* log, const char* name);
+
+/**
+ * @brief 레코드를 기록합니다. (생산자 전용, 포맷팅/할당 없음)
+ * @return int 성공 시 1, 링이 가득 차서 버려졌으면 0
+ */
+int log_ring_write(log_ring* log, const log_record* record);
+
+/**
+ * @brief 쌓인 레코드를 포맷팅하여 출력합니다. (소비자 전용)
+ * @param log 로그 링
+ * @param out 출력 스트림
+ * @param with_timestamp 각 줄 앞에 시각을 붙일지 여부 (파일 출력용)
+ * @return unsigned long 처리한 레코드 수
+ */
+unsigned long log_ring_drain(log_ring* log, FILE* out, int with_timestamp);
+
+#endif // LOG_RING_H
@@ -0,0 +1,59 @@
+#ifndef POLICY_LOADER_H
+#define POLICY_LOADER_H
+
+#include <stddef.h>
+#include "policy_store.h"
+
+/**
+ * @file policy_loader.h
+ * @brief config.ini 내용을 정책 스냅샷으로 변환
+ * @details ini_parser로 파일을 한 번만 훑어 모든 섹션을 처리합니다.
+ *
+ * - `[AllowedProcesses]`: 키 이름과 관계없이 모든 값을 허용 프로세스로 등록 (모든 키 허용)
+ * - `[KeyRules]`: `<프로세스>=<규칙>` 형식으로 프로세스별 키 규칙을 등록 (문법은 key_policy.h 참고)
+ * - `[KeyPolicy]`: `ExitKey` (종료 키 이름, `none`이면 종료 키 없음)
+ * - `[Logging]`: `Verbosity`, `LogFile`, `JournalDir`, `JournalSegmentMB`
+ * - `[Injection]`: `Foreign` (`process`, `pass`, `block`), `BatchSize`, `BatchDelayUs`, `Unicode`
+ * - `[Hook]`: `LatencyBudgetUs` (키 입력 하나의 지연 예산, 넘으면 부가 작업을 줄임)
+ * - `[Shadow]`: `Enabled` (감사 전용 모드), `Candidate` (후보 정책 INI), `ReportFile` (집계 CSV)
+ * - `[Devices]`: `Default` (규칙에 없는 키보드의 분류), `<장치 이름 일부>=<normal|trusted|untrusted>`
+ * - 그 밖의 섹션은 이후 정책 확장을 위해 무시
+ */
+
+/** @brief 기본 정책에서 허용하는 프로세스 */
+#define POLICY_DEFAULT_PROCESS "notepad++.exe"
+
+/**
+ * @brief 정책 로드 결과
+ */
+typedef enum policy_load_status {
+    POLICY_LOAD_OK = 0,      /**< 파일에서 정책을 읽음 */
+    POLICY_LOAD_DEFAULT = 1, /**< 허용 프로세스가 없어 기본 정책을 사용 */
+    POLICY_LOAD_MISSING = 2  /**< 파일이 없어 기본 정책을 사용 */
+} policy_load_status;
+
+/**
+ * @brief 항목별 안내 출력("[설정] ...")을 켜거나 끕니다.
+ * @details 벤치마크처럼 같은 내용을 반복해서 로드할 때 사용합니다. 오류는 항상 출력합니다.
+ * @param quiet 1이면 안내 출력 생략, 2이면 INI 줄 경고도 생략 (퍼징, 단위 테스트), 0이면 출력 (기본값)
+ */
+void policy_load_set_quiet(int quiet);
+
+/**
+ * @brief 메모리에 있는 INI 내용으로 정책 스냅샷을 만듭니다.
+ * @param data INI 내용
+ * @param size 내용 길이
+ * @param status 로드 결과를 돌려받을 포인터
+ * @return policy_snapshot* 새 스냅샷, 메모리 부족 시 NULL
+ */
+policy_snapshot* policy_load_buffer(const char* data, size_t size, policy_load_status* status);
+
+/**
+ * @brief INI 파일을 한 번 읽어 정책 스냅샷을 만듭니다.
+ * @param path INI 파일 경로
+ * @param status 로드 결과를 돌려받을 포인터
+ * @return policy_snapshot* 새 스냅샷, 메모리 부족 시 NULL
+ */
+policy_snapshot* policy_load_file(const char* path, policy_load_status* status);
+
+#endif // POLICY_LOADER_H
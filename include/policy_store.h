@@ -0,0 +1,135 @@
+#ifndef POLICY_STORE_H
+#define POLICY_STORE_H
+
+#include "allowlist.h"
+#include "key_policy.h"
+#include "device_table.h"
+
+/**
+ * @file policy_store.h
+ * @brief 불변 정책 스냅샷과 RCU 방식의 게시/회수
+ * @details 설정 재로드는 백그라운드 스레드에서 새 스냅샷을 완성한 뒤 포인터 교환 한 번으로 게시합니다.
+ *          후크(단일 읽기 스레드)는 잠금 없이 현재 스냅샷을 읽으며, 이전 스냅샷은
+ *          읽기 스레드가 더 이상 참조하지 않음이 확인된 뒤에 해제됩니다.
+ */
+
+/** @brief 정책에 저장하는 경로의 최대 길이 */
+#define POLICY_PATH_SIZE 260
+
+/** @brief 회수 대기 중인 스냅샷의 최대 개수 */
+#define POLICY_RETIRE_SLOTS 8
+
+/**
+ * @brief 다른 프로그램이 주입한(LLKHF_INJECTED) 키 입력 처리 방식 ([Injection] Foreign)
+ * @details 이 프로그램이 SendInput으로 주입한 키는 서명으로 구분되어 항상 그대로 통과합니다.
+ */
+typedef enum policy_injection {
+    POLICY_INJECTION_PROCESS = 0, /**< 실제 키 입력과 같이 암호화/판정 (기본값) */
+    POLICY_INJECTION_PASS = 1,    /**< 처리하지 않고 다음 후크로 전달 */
+    POLICY_INJECTION_BLOCK = 2    /**< 항상 차단 */
+} policy_injection;
+
+/**
+ * @brief 게시 후에는 변경되지 않는 정책 스냅샷
+ */
+typedef struct policy_snapshot {
+    allowlist allowed;     /**< 허용 프로세스 목록 (값은 키 규칙 번호 + 1) */
+    key_policy keys;       /**< 컴파일된 키 규칙 테이블 ([KeyRules]) */
+    unsigned int exit_key; /**< 종료 키 가상 키 코드 ([KeyPolicy] ExitKey, 0이면 없음) */
+    int log_verbosity;     /**< [Logging] Verbosity 값 */
+    char log_file[POLICY_PATH_SIZE]; /**< [Logging] LogFile 값 (비어 있으면 콘솔 출력) */
+    char journal_dir[POLICY_PATH_SIZE]; /**< [Logging] JournalDir 값 (비어 있으면 이진 저널 기록 안 함) */
+    unsigned long journal_segment_mb;   /**< [Logging] JournalSegmentMB 값 (0이면 기본값) */
+    char journal_key_file[POLICY_PATH_SIZE]; /**< [Logging] JournalKeyFile 값 (비어 있으면 저널을 복호화할 수 없음) */
+    int foreign_injection; /**< policy_injection 값 ([Injection] Foreign) */
+    unsigned long inject_batch_size; /**< [Injection] BatchSize 값 (한 번에 주입할 최대 키 수, 0이면 기본값, 1이면 모으지 않음) */
+    unsigned long inject_batch_delay_us; /**< [Injection] BatchDelayUs 값 (첫 키부터 주입까지 최대 시간, 0이면 기본값) */
+    int inject_unicode;    /**< [Injection] Unicode 값 (1이면 문자 키를 KEYEVENTF_UNICODE로 주입) */
+    unsigned long hook_budget_us; /**< [Hook] LatencyBudgetUs 값 (0이면 기본값) */
+    int shadow_enabled;    /**< [Shadow] Enabled 값 (1이면 키를 차단하지 않고 판정만 집계, 시작할 때만 반영) */
+    char shadow_candidate[POLICY_PATH_SIZE]; /**< [Shadow] Candidate 값 (나란히 판정할 후보 정책 INI, 비어 있으면 없음) */
+    char shadow_report[POLICY_PATH_SIZE];    /**< [Shadow] ReportFile 값 (집계 CSV 경로, 비어 있으면 기본값) */
+    device_rules devices;  /**< [Devices] 장치별 분류 규칙 */
+    unsigned long version; /**< 게시 순번 (policy_store_publish가 설정) */
+} policy_snapshot;
+
+/**
+ * @brief 회수 대기 중인 스냅샷
+ */
+typedef struct policy_retired {
+    policy_snapshot* snapshot; /**< 해제할 스냅샷 */
+    unsigned long epoch;       /**< 이 스냅샷을 대체한 게시 세대 */
+} policy_retired;
+
+/**
+ * @brief 현재 정책 포인터와 회수 대기 목록
+ * @details 읽기 스레드는 하나(후크 스레드)이고, 게시 함수는 한 번에 한 스레드만 호출해야 합니다.
+ */
+typedef struct policy_store {
+    policy_snapshot* current;   /**< 현재 게시된 스냅샷 (원자적 교환) */
+    unsigned long epoch;        /**< 게시 세대 */
+    unsigned long reader_epoch; /**< 읽기 스레드가 진입 시 본 세대, 유휴 상태면 POLICY_READER_IDLE */
+    policy_retired retired[POLICY_RETIRE_SLOTS]; /**< 회수 대기 목록 (게시 스레드 전용) */
+    int retired_count;          /**< 회수 대기 개수 */
+} policy_store;
+
+/** @brief 읽기 스레드가 스냅샷을 참조하지 않는 상태 */
+#define POLICY_READER_IDLE (~0UL)
+
+/**
+ * @brief 빈 정책 스냅샷을 만듭니다.
+ * @return policy_snapshot* 새 스냅샷, 메모리 부족 시 NULL
+ */
+policy_snapshot* policy_snapshot_create(void);
+
+/**
+ * @brief 스냅샷과 그 안의 목록을 해제합니다.
+ */
+void policy_snapshot_destroy(policy_snapshot* snapshot);
+
+/**
+ * @brief 정책 저장소를 초기화합니다. (스냅샷 없음)
+ */
+void policy_store_init(policy_store* store);
+
+/**
+ * @brief 현재 스냅샷을 읽기 위해 진입합니다. (읽기 스레드 전용)
+ * @details policy_store_exit()를 호출하기 전까지 반환된 스냅샷은 해제되지 않습니다.
+ * @return policy_snapshot* 현재 스냅샷 (아직 게시되지 않았으면 NULL)
+ */
+policy_snapshot* policy_store_enter(policy_store* store);
+
+/**
+ * @brief 스냅샷 참조를 끝냅니다. (읽기 스레드 전용)
+ */
+void policy_store_exit(policy_store* store);
+
+/**
+ * @brief 현재 스냅샷을 반환합니다. (게시 스레드 전용)
+ * @details 스냅샷을 교체하고 해제하는 것은 게시 스레드뿐이므로, 게시 스레드는 읽기 스레드의 진입 표시를
+ *          건드리지 않고 다음 게시 전까지 이 스냅샷을 읽을 수 있습니다.
+ * @return policy_snapshot* 현재 스냅샷 (아직 게시되지 않았으면 NULL)
+ */
+policy_snapshot* policy_store_current(const policy_store* store);
+
+/**
+ * @brief 새 스냅샷을 게시하고 이전 스냅샷을 회수 대기 목록에 넣습니다.
+ * @details 회수 대기 목록이 가득 차면 읽기 스레드가 빠져나올 때까지 기다립니다.
+ * @param store 정책 저장소
+ * @param snapshot 완성된 새 스냅샷 (소유권이 저장소로 넘어감, NULL이면 정책을 비움)
+ */
+void policy_store_publish(policy_store* store, policy_snapshot* snapshot);
+
+/**
+ * @brief 읽기 스레드가 더 이상 참조하지 않는 스냅샷을 해제합니다. (게시 스레드 전용)
+ * @return int 아직 회수 대기 중인 스냅샷 수
+ */
+int policy_store_reclaim(policy_store* store);
+
+/**
+ * @brief 현재 스냅샷과 대기 중인 스냅샷을 모두 해제합니다.
+ * @details 읽기 스레드가 멈춘 뒤(후크 해제 후)에만 호출해야 합니다.
+ */
+void policy_store_destroy(policy_store* store);
+
+#endif // POLICY_STORE_H
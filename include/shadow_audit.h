@@ -0,0 +1,138 @@
+#ifndef SHADOW_AUDIT_H
+#define SHADOW_AUDIT_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "key_pipeline.h"
+#include "foreground_cache.h"
+#include "policy_store.h"
+
+/**
+ * @file shadow_audit.h
+ * @brief 그림자(감사 전용) 모드 판정 집계
+ * @details 새 허용 목록을 바로 적용하지 않고, 키 입력은 모두 그대로 통과시키면서 정책이 허용/차단했을 판정만
+ *          프로세스별·키 분류별 카운터에 모읍니다. 후보 정책을 함께 넘기면 현재 정책과 나란히 판정하여
+ *          (현재 판정, 후보 판정) 조합별로 셉니다.
+ *
+ *          이벤트마다 로그를 남기지 않고, 카운터 표는 미리 할당된 고정 크기이므로 실행 중에 메모리를 할당하지 않습니다.
+ *          포그라운드 창이 바뀌지 않으면 프로세스 항목과 후보 정책의 규칙 번호를 캐시하므로,
+ *          키 다운 하나의 비용은 키 규칙 비트 검사 두 번과 카운터 증가 한 번입니다.
+ *          shadow_audit_handle()은 작업 스레드 하나에서만 호출하고, 다른 스레드는 카운터를 잠금 없이 읽습니다.
+ */
+
+/** @brief 프로세스 표 크기 (2의 거듭제곱, 가득 차면 이후 프로세스는 "(other)" 항목에 모음) */
+#define SHADOW_AUDIT_PROCESSES 64
+
+/** @brief 판정 번호: 후보 정책 없음 (foreground_verdict 값 다음) */
+#define SHADOW_VERDICT_NONE 3
+
+/** @brief 판정 번호 수 (FOREGROUND_UNKNOWN, BLOCKED, ALLOWED, SHADOW_VERDICT_NONE) */
+#define SHADOW_VERDICTS 4
+
+/**
+ * @brief 키 분류 (key_policy.h의 규칙 분류와 같은 범위)
+ */
+typedef enum shadow_key_class {
+    SHADOW_KEY_ALPHA = 0,   /**< A~Z */
+    SHADOW_KEY_DIGIT,       /**< 0~9 */
+    SHADOW_KEY_FUNC,        /**< F1~F24 */
+    SHADOW_KEY_NAV,         /**< 방향키, Home/End, PageUp/Down, Insert/Delete */
+    SHADOW_KEY_EDIT,        /**< Backspace, Tab, Enter, Space */
+    SHADOW_KEY_PUNCT,       /**< 문장 부호 (OEM 키) */
+    SHADOW_KEY_NUMPAD,      /**< 숫자 키패드 */
+    SHADOW_KEY_MODIFIER,    /**< Shift, Ctrl, Alt, Win */
+    SHADOW_KEY_OTHER,       /**< 그 밖의 키 */
+    SHADOW_KEY_CLASS_COUNT
+} shadow_key_class;
+
+/**
+ * @brief 프로세스 하나의 카운터
+ */
+typedef struct shadow_process {
+    int used;                              /**< 이름이 기록되었는지 여부 (이름을 쓴 뒤 원자적으로 게시) */
+    char name[FOREGROUND_NAME_SIZE];       /**< 프로세스 이름 */
+    /** @brief [키 분류][현재 정책 판정][후보 정책 판정]별 키 다운 수 */
+    uint32_t counts[SHADOW_KEY_CLASS_COUNT][SHADOW_VERDICT_NONE][SHADOW_VERDICTS];
+} shadow_process;
+
+/**
+ * @brief 그림자 모드 집계 상태
+ */
+typedef struct shadow_audit {
+    shadow_process processes[SHADOW_AUDIT_PROCESSES]; /**< 프로세스 표 (이름 해시, 선형 탐사) */
+    shadow_process unknown;         /**< 포그라운드 프로세스를 확인하지 못한 키 ("(unknown)") */
+    shadow_process overflow;        /**< 표가 가득 찬 뒤 처음 본 프로세스의 키 ("(other)") */
+    unsigned char classes[256];     /**< 가상 키 코드 → shadow_key_class */
+    unsigned int modifier_keys;     /**< 누르고 있는 조합 키 (key_modifier_key 비트) */
+    uint32_t pressed[8];            /**< 키 업을 기다리는 키 비트맵 (자동 반복 구분) */
+
+    // 작업 스레드 캐시 (포그라운드 캐시 세대와 후보 정책 버전이 같으면 재사용)
+    int cache_valid;                /**< 캐시가 유효한지 여부 */
+    unsigned long cached_generation; /**< 캐시를 채운 포그라운드 캐시 세대 */
+    const policy_snapshot* cached_candidate; /**< 캐시를 채운 후보 정책 */
+    unsigned long cached_candidate_version;  /**< 캐시를 채운 후보 정책 버전 */
+    shadow_process* cached_entry;   /**< 현재 포그라운드 프로세스 항목 */
+    unsigned int cached_candidate_rule; /**< 후보 정책의 규칙 번호 + 1 (0이면 차단) */
+
+    // 누적 카운터 (작업 스레드가 갱신, 다른 스레드는 느슨하게 읽음)
+    unsigned long key_downs;        /**< 집계한 키 다운 수 (자동 반복 제외) */
+    unsigned long repeats;          /**< 집계에서 뺀 자동 반복 키 다운 수 */
+    unsigned long disagreements;    /**< 현재 정책과 후보 정책의 판정이 다른 키 다운 수 */
+    unsigned long processes_used;   /**< 프로세스 표에 등록된 프로세스 수 */
+    uint64_t eval_ns_total;         /**< 키 다운 판정과 집계에 쓴 시간 합계 (평균은 key_downs로 나눔) */
+    uint64_t eval_ns_max;           /**< 키 다운 하나의 최대 판정/집계 시간 */
+} shadow_audit;
+
+/**
+ * @brief 집계 상태를 초기화합니다.
+ */
+void shadow_audit_init(shadow_audit* audit);
+
+/**
+ * @brief 키 이벤트 하나를 판정하고 집계합니다. (작업 스레드)
+ * @details 현재 정책의 판정은 포그라운드 판정 캐시(허용 여부 콜백)와 active의 키 규칙으로 구하고,
+ *          후보 정책의 판정은 같은 프로세스 이름을 candidate의 허용 목록과 키 규칙으로 구합니다.
+ *          키 다운만 집계하며 자동 반복은 repeats에만 셉니다.
+ * @param audit 집계 상태
+ * @param foreground 포그라운드 판정 캐시
+ * @param active 현재 정책 (NULL이면 키 규칙 없이 허용 목록만으로 판정)
+ * @param candidate 후보 정책 (NULL이면 후보 판정은 SHADOW_VERDICT_NONE)
+ * @param event 키 이벤트
+ * @return foreground_verdict 현재 정책으로 판정한 결과
+ */
+foreground_verdict shadow_audit_handle(shadow_audit* audit, foreground_cache* foreground,
+                                       const policy_snapshot* active, const policy_snapshot* candidate,
+                                       const key_event* event);
+
+/**
+ * @brief 키 분류 이름을 반환합니다.
+ */
+const char* shadow_key_class_name(shadow_key_class key_class);
+
+/**
+ * @brief 판정 번호(foreground_verdict 또는 SHADOW_VERDICT_NONE)의 이름을 반환합니다.
+ */
+const char* shadow_verdict_name(int verdict);
+
+/**
+ * @brief 0이 아닌 카운터를 CSV로 씁니다. (어느 스레드에서든 호출 가능)
+ * @details `#`으로 시작하는 요약 줄 뒤에 `process,key_class,active,candidate,count` 형식의 줄이 옵니다.
+ * @return int 성공 시 1, 쓰기 오류 시 0
+ */
+int shadow_audit_write_report(const shadow_audit* audit, FILE* out);
+
+/**
+ * @brief [Shadow] 경로 값(Candidate, ReportFile)을 현재 설정 파일 기준 경로로 바꿉니다.
+ * @details 절대 경로(`\\` 또는 `/`로 시작하거나 드라이브 문자가 있는 경로)는 그대로 쓰고,
+ *          상대 경로는 config_path가 있는 디렉토리(`\\`와 `/` 모두 구분자로 봄)에 붙입니다.
+ * @param config_path 현재 정책을 읽은 설정 파일 경로 (디렉토리가 없으면 상대 경로 그대로)
+ * @param value 설정 값 (비어 있으면 default_name 사용)
+ * @param default_name 기본 파일 이름
+ * @param path 결과 경로 버퍼
+ * @param size 결과 버퍼 크기
+ * @return int 성공 시 1, 버퍼가 모자라면 0 (path는 빈 문자열)
+ */
+int shadow_audit_resolve_path(const char* config_path, const char* value, const char* default_name,
+                              char* path, size_t size);
+
+#endif // SHADOW_AUDIT_H
@@ -0,0 +1,69 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stddef.h>
+
+/**
+ * @file spsc_ring.h
+ * @brief 단일 생산자/단일 소비자 고정 크기 링 버퍼
+ * @details 잠금과 동적 할당 없이 후크 스레드(생산자)에서 백그라운드 스레드(소비자)로
+ *          고정 크기 레코드를 넘깁니다. 저장 공간은 호출자가 제공하며 용량은 2의 거듭제곱이어야 합니다.
+ */
+
+/** @brief 생산자/소비자 인덱스를 서로 다른 캐시 라인에 두기 위한 크기 */
+#define SPSC_CACHE_LINE 64
+
+/**
+ * @brief SPSC 링 버퍼
+ * @details head는 소비자만, tail은 생산자만 갱신합니다.
+ */
+typedef struct spsc_ring {
+    unsigned char* storage;  /**< 레코드 저장 공간 (capacity * element_size 바이트) */
+    size_t element_size;     /**< 레코드 하나의 크기 */
+    unsigned long mask;      /**< capacity - 1 */
+
+    char pad0[SPSC_CACHE_LINE];
+    unsigned long head;        /**< 다음에 읽을 위치 (소비자 소유) */
+    unsigned long cached_tail; /**< 소비자가 마지막으로 본 tail */
+
+    char pad1[SPSC_CACHE_LINE];
+    unsigned long tail;        /**< 다음에 쓸 위치 (생산자 소유) */
+    unsigned long cached_head; /**< 생산자가 마지막으로 본 head */
+
+    char pad2[SPSC_CACHE_LINE];
+} spsc_ring;
+
+/**
+ * @brief 링 버퍼를 초기화합니다.
+ * @param ring 초기화할 링 버퍼
+ * @param storage capacity * element_size 바이트 이상의 저장 공간
+ * @param element_size 레코드 크기
+ * @param capacity 레코드 개수 (2의 거듭제곱)
+ * @return int 성공 시 1, 용량이 2의 거듭제곱이 아니면 0
+ */
+int spsc_ring_init(spsc_ring* ring, void* storage, size_t element_size, unsigned long capacity);
+
+/**
+ * @brief 레코드 하나를 넣습니다. (생산자 전용)
+ * @return int 성공 시 1, 가득 찬 경우 0
+ */
+int spsc_ring_push(spsc_ring* ring, const void* element);
+
+/**
+ * @brief 레코드 하나를 꺼냅니다. (소비자 전용)
+ * @return int 성공 시 1, 비어 있는 경우 0
+ */
+int spsc_ring_pop(spsc_ring* ring, void* element);
+
+/**
+ * @brief 현재 링에 들어 있는 레코드 수의 근사값을 반환합니다.
+ * @details 어느 스레드에서든 호출할 수 있으나 다른 스레드가 갱신 중이면 근사값입니다.
+ */
+unsigned long spsc_ring_size(const spsc_ring* ring);
+
+/**
+ * @brief 링의 전체 용량을 반환합니다.
+ */
+unsigned long spsc_ring_capacity(const spsc_ring* ring);
+
+#endif // SPSC_RING_H
@@ -0,0 +1,133 @@
+#ifndef STATS_BLOCK_H
+#define STATS_BLOCK_H
+
+#include <stdint.h>
+#include "kp_platform.h"
+
+/**
+ * @file stats_block.h
+ * @brief 단계별 지연 히스토그램과 공유 메모리 통계 블록
+ * @details 히스토그램은 HDR 방식의 로그 구간 버킷을 사용합니다. 2의 거듭제곱 구간마다 16개의 하위 버킷을 두어
+ *          1ns부터 약 18분까지 상대 오차 6% 이내로 기록하며, 기록은 잠금 없이 버킷 카운터 하나를 올리는 것으로 끝납니다.
+ *
+ *          통계 블록은 이름 있는 공유 메모리에 놓이므로 모니터링 도구(tools/stats_reader)가 프로세스를 멈추지 않고
+ *          읽을 수 있습니다. 32비트 실행 파일과 64비트 도구가 같은 배치를 보도록 고정 폭 정수만 사용합니다.
+ */
+
+/** @brief 공유 메모리 이름 */
+#define KP_STATS_SHM_NAME "KeyboardProtectorStats"
+
+/** @brief 통계 블록 식별 값 ("KPST") */
+#define KP_STATS_MAGIC 0x5453504BUL
+
+/** @brief 통계 블록 배치 버전 */
+#define KP_STATS_VERSION 1
+
+/** @brief 2의 거듭제곱 구간당 하위 버킷 수의 로그 (16개) */
+#define LATENCY_SUB_BUCKET_BITS 4
+
+/** @brief 기록할 수 있는 최대 지수 (2^40 ns, 약 18분) */
+#define LATENCY_MAX_EXPONENT 40
+
+/** @brief 히스토그램 버킷 수 */
+#define LATENCY_BUCKETS ((LATENCY_MAX_EXPONENT - LATENCY_SUB_BUCKET_BITS + 1) << LATENCY_SUB_BUCKET_BITS)
+
+/** @brief LowLevelHooksTimeout 레지스트리 값이 없을 때 가정하는 기본값 (밀리초) */
+#define KP_STATS_DEFAULT_HOOK_TIMEOUT_MS 300
+
+/**
+ * @brief 계측 단계
+ */
+typedef enum kp_stat_stage {
+    KP_STAT_HOOK = 0,   /**< LowLevelKeyboardProc 전체 (후크 스레드) */
+    KP_STAT_QUEUE,      /**< 후크 → 작업 스레드 큐 대기 */
+    KP_STAT_RESOLVE,    /**< 포그라운드 프로세스 확인 및 정책 판정 */
+    KP_STAT_CRYPTO,     /**< 솔트 생성과 암호화 */
+    KP_STAT_INJECT,     /**< 복호화된 키 주입 (SendInput) */
+    KP_STAT_EVENT,      /**< 작업 스레드의 이벤트 하나 처리 전체 */
+    KP_STAT_COUNT
+} kp_stat_stage;
+
+/**
+ * @brief 판정별 이벤트 카운터 인덱스
+ */
+typedef enum kp_stat_verdict {
+    KP_VERDICT_ALLOWED = 0, /**< 허용되어 복호화/주입됨 */
+    KP_VERDICT_BLOCKED,     /**< 허용되지 않은 프로세스라서 차단됨 */
+    KP_VERDICT_UNKNOWN,     /**< 프로세스 확인 실패로 차단됨 */
+    KP_VERDICT_COUNT
+} kp_stat_verdict;
+
+/**
+ * @brief 로그 구간 지연 히스토그램 (기록하는 스레드는 하나, 읽는 쪽은 여럿)
+ */
+typedef struct latency_histogram {
+    uint64_t count;                     /**< 기록된 값 수 */
+    uint64_t sum_ns;                    /**< 기록된 값의 합 */
+    uint64_t max_ns;                    /**< 최대값 */
+    uint32_t buckets[LATENCY_BUCKETS];  /**< 버킷별 개수 */
+} latency_histogram;
+
+/**
+ * @brief 공유 메모리 통계 블록
+ */
+typedef struct kp_stats_block {
+    uint32_t magic;             /**< KP_STATS_MAGIC (모든 필드를 초기화한 뒤 마지막에 기록) */
+    uint32_t version;           /**< KP_STATS_VERSION */
+    uint32_t size;              /**< 블록 크기 (바이트) */
+    uint32_t process_id;        /**< 기록 중인 프로세스 ID */
+    uint32_t hook_timeout_ms;   /**< 시스템 LowLevelHooksTimeout (밀리초) */
+    uint32_t reserved;          /**< 정렬용 예약 공간 */
+    uint64_t near_timeout;      /**< 후크 시간이 제한 시간의 절반을 넘은 횟수 */
+    uint64_t verdicts[KP_VERDICT_COUNT];         /**< 판정별 이벤트 수 */
+    latency_histogram stages[KP_STAT_COUNT];     /**< 단계별 지연 히스토그램 */
+} kp_stats_block;
+
+/**
+ * @brief 히스토그램에 값을 기록합니다. (잠금 없음)
+ * @param histogram 히스토그램 (NULL이면 무시)
+ * @param value_ns 기록할 값 (나노초)
+ */
+void latency_histogram_record(latency_histogram* histogram, uint64_t value_ns);
+
+/**
+ * @brief 값이 들어가는 버킷 번호를 반환합니다.
+ */
+unsigned int latency_bucket_index(uint64_t value_ns);
+
+/**
+ * @brief 버킷이 나타내는 값 범위의 상한을 반환합니다.
+ */
+uint64_t latency_bucket_upper(unsigned int index);
+
+/**
+ * @brief 히스토그램의 백분위 값을 구합니다.
+ * @param histogram 히스토그램
+ * @param quantile 0.0 ~ 1.0 (예: 0.999)
+ * @return uint64_t 해당 백분위가 속한 버킷의 상한 (기록이 없으면 0)
+ */
+uint64_t latency_histogram_percentile(const latency_histogram* histogram, double quantile);
+
+/**
+ * @brief 통계 블록을 초기화합니다.
+ * @param block 초기화할 블록 (0으로 채워진 메모리)
+ * @param hook_timeout_ms 시스템 후크 제한 시간 (밀리초)
+ */
+void kp_stats_block_init(kp_stats_block* block, uint32_t hook_timeout_ms);
+
+/**
+ * @brief 단계 지연을 기록합니다. (block이 NULL이면 무시)
+ */
+void kp_stats_record(kp_stats_block* block, kp_stat_stage stage, uint64_t elapsed_ns);
+
+/**
+ * @brief 판정 카운터를 올립니다. (block이 NULL이면 무시)
+ */
+void kp_stats_count_verdict(kp_stats_block* block, kp_stat_verdict verdict);
+
+/**
+ * @brief 단계 이름을 반환합니다.
+ */
+const char* kp_stat_stage_name(kp_stat_stage stage);
+
+#endif // STATS_BLOCK_H
@@ -0,0 +1,92 @@
+#ifndef WIN32_BACKEND_H
+#define WIN32_BACKEND_H
+
+#include <windows.h>
+#include "foreground_cache.h"
+#include "inject_batch.h"
+
+/**
+ * @file win32_backend.h
+ * @brief 처리 코어가 사용하는 Win32 API 호출 계층
+ * @details 포그라운드 창과 프로세스 조회(GetForegroundWindow, OpenProcess), 키 주입(SendInput),
+ *          주입 묶음 출력, 주입 서명 생성만 담당합니다. 플랫폼 독립 코어(libkpcore)는 이 파일에 의존하지 않으며,
+ *          재생 도구와 벤치마크는 같은 인터페이스(process_lookup_provider, key_processor_backend)의
+ *          가짜 구현을 사용합니다.
+ */
+
+/**
+ * @brief 이 프로그램이 SendInput으로 주입한 키에 붙이는 세션 서명 (dwExtraInfo)
+ * @details Win32InitInjectionSignature()가 시작할 때 난수로 정하며,
+ *          후크는 이 값으로 자신이 주입한 키를 O(1)에 식별합니다.
+ */
+extern ULONG_PTR g_injectionSignature;
+
+/**
+ * @brief 후크 생존 확인 탐침 키의 서명 (dwExtraInfo, 세션 서명과 다른 값)
+ */
+extern ULONG_PTR g_probeSignature;
+
+/** @brief 탐침 키의 가상 키 코드 (할당되지 않은 0xFF, 후크가 죽어 애플리케이션에 전달되어도 무해) */
+#define HOOK_PROBE_VK 0xFF
+
+/**
+ * @brief Win32 API 기반 프로세스 조회 공급자
+ */
+extern const process_lookup_provider g_win32ProcessProvider;
+
+/**
+ * @brief SendInput 기반 주입 묶음 출력 (묶음 하나를 SendInput 한 번으로 주입, 유니코드 경로는 KEYEVENTF_UNICODE)
+ */
+extern const inject_sink g_win32InjectSink;
+
+/**
+ * @brief 세션 서명을 생성합니다. (후크 설치 전에 한 번 호출)
+ */
+void Win32InitInjectionSignature(void);
+
+/**
+ * @brief 후크가 받을 탐침 키(HOOK_PROBE_VK 키 업)를 주입합니다.
+ * @return BOOL 성공 시 TRUE
+ */
+BOOL Win32SendHookProbe(void);
+
+/**
+ * @brief 포그라운드 조회를 가볍게 할지 정합니다. (후크 지연 관리자의 축소 단계)
+ * @details 켜면 포그라운드 창과 PID가 직전 조회와 같을 때 프로세스를 다시 열어 생성 시각을 읽지 않습니다.
+ */
+void Win32SetLightweightForeground(BOOL enabled);
+
+/**
+ * @brief 처리 코어의 키 주입 함수 (SendInput)
+ * @return int 성공 시 1, 실패 시 0
+ */
+int Win32InjectKey(void* context, unsigned int vkCode, int keyDown);
+
+/**
+ * @brief 현재 포커스된 창의 프로세스 실행 파일 이름을 가져옵니다.
+ * @param processName 버퍼에 저장될 프로세스 이름 (최대 MAX_PATH)
+ * @param bufferSize 버퍼 크기
+ * @return BOOL 성공 시 TRUE, 실패 시 FALSE
+ */
+BOOL GetCurrentProcessName(char* processName, DWORD bufferSize);
+
+/**
+ * @brief 프로세스 ID로 생성 시각과 실행 파일 이름을 가져옵니다.
+ * @details 생성 시각은 포그라운드 식별 정보(foreground_identity.start_time)와 같은 값이므로 PID 재사용을 구분할 수 있습니다.
+ * @param processId 조회할 프로세스 ID
+ * @param startTime 프로세스 생성 시각 (FILETIME)
+ * @param processName 실행 파일 이름을 받을 버퍼 (NULL이면 이름은 조회하지 않음)
+ * @param bufferSize 버퍼 크기
+ * @return BOOL 성공 시 TRUE, 프로세스가 없거나 열 수 없으면 FALSE
+ */
+BOOL Win32QueryProcess(DWORD processId, unsigned long long* startTime, char* processName, DWORD bufferSize);
+
+/**
+ * @brief 복호화된 키 코드를 SendInput을 사용하여 전달합니다.
+ * @param vkCode 전달할 가상 키 코드
+ * @param isKeyDown 키 다운 이벤트인지 여부 (TRUE: 키 다운, FALSE: 키 업)
+ * @return BOOL 성공 시 TRUE, 실패 시 FALSE
+ */
+BOOL SendDecryptedKey(DWORD vkCode, BOOL isKeyDown);
+
+#endif // WIN32_BACKEND_H
@@ -0,0 +1,208 @@
+#include "allowlist.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/** @brief 초기 슬롯 수 (2의 거듭제곱) */
+#define ALLOWLIST_INITIAL_SLOTS 16
+
+/** @brief 초기 아레나 크기 */
+#define ALLOWLIST_INITIAL_ARENA 1024
+
+/**
+ * @brief ASCII 대문자를 소문자로 바꿉니다. (로캘과 무관하게 _stricmp와 같은 규칙)
+ */
+static unsigned char fold_char(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? (unsigned char)(c + ('a' - 'A')) : c;
+}
+
+/**
+ * @brief 소문자로 정규화한 문자열의 FNV-1a 해시와 길이를 계산합니다.
+ */
+static unsigned int hash_folded(const char* name, size_t* length) {
+    unsigned int hash = 2166136261u;
+    const unsigned char* p = (const unsigned char*)name;
+    while (*p != '\0') {
+        hash ^= fold_char(*p++);
+        hash *= 16777619u;
+    }
+    *length = (size_t)(p - (const unsigned char*)name);
+    return hash;
+}
+
+/**
+ * @brief 정규화된 아레나 문자열과 입력 이름을 대소문자 구분 없이 비교합니다.
+ */
+static int folded_equals(const char* folded, const char* name) {
+    const unsigned char* a = (const unsigned char*)folded;
+    const unsigned char* b = (const unsigned char*)name;
+    while (*a != '\0' && *a == fold_char(*b)) {
+        a++;
+        b++;
+    }
+    return *a == '\0' && *b == '\0';
+}
+
+/**
+ * @brief 해시에 해당하는 이름의 슬롯을 찾거나, 없으면 삽입할 빈 슬롯을 반환합니다.
+ */
+static allowlist_slot* find_slot(const allowlist* list, unsigned int hash, const char* name) {
+    unsigned long index = hash & list->slot_mask;
+    for (;;) {
+        allowlist_slot* slot = &list->slots[index];
+        if (slot->offset == 0) {
+            return slot;
+        }
+        if (slot->hash == hash && folded_equals(list->arena + slot->offset, name)) {
+            return slot;
+        }
+        index = (index + 1) & list->slot_mask;
+    }
+}
+
+/**
+ * @brief 슬롯 테이블을 두 배로 늘리고 기존 항목을 다시 배치합니다.
+ */
+static int grow_slots(allowlist* list) {
+    unsigned long old_count = (list->slots != NULL) ? list->slot_mask + 1 : 0;
+    unsigned long new_count = (old_count != 0) ? old_count * 2 : ALLOWLIST_INITIAL_SLOTS;
+    allowlist_slot* slots = (allowlist_slot*)calloc(new_count, sizeof(allowlist_slot));
+    if (slots == NULL) {
+        return 0;
+    }
+    
+    for (unsigned long i = 0; i < old_count; i++) {
+        allowlist_slot* old = &list->slots[i];
+        if (old->offset != 0) {
+            unsigned long index = old->hash & (new_count - 1);
+            while (slots[index].offset != 0) {
+                index = (index + 1) & (new_count - 1);
+            }
+            slots[index] = *old;
+        }
+    }
+    
+    free(list->slots);
+    list->slots = slots;
+    list->slot_mask = new_count - 1;
+    return 1;
+}
+
+/**
+ * @brief 빈 목록으로 초기화합니다.
+ */
+void allowlist_init(allowlist* list) {
+    memset(list, 0, sizeof(*list));
+}
+
+/**
+ * @brief 목록이 사용하는 메모리를 해제하고 빈 목록으로 되돌립니다.
+ */
+void allowlist_free(allowlist* list) {
+    free(list->arena);
+    free(list->slots);
+    allowlist_init(list);
+}
+
+/**
+ * @brief 이름을 추가하거나 이미 있는 항목의 값을 바꿉니다.
+ * @details 부하율을 1/2 이하로 유지하여 조회 시 탐사 길이를 짧게 합니다.
+ * @param replace 이미 있는 항목의 값을 바꿀지 여부
+ */
+static int insert_name(allowlist* list, const char* name, unsigned int value, int replace) {
+    if (name == NULL || name[0] == '\0') {
+        return 1;
+    }
+    if ((list->count + 1) * 2 > ((list->slots != NULL) ? list->slot_mask + 1 : 0)) {
+        if (!grow_slots(list)) {
+            return 0;
+        }
+    }
+    
+    size_t length = 0;
+    unsigned int hash = hash_folded(name, &length);
+    allowlist_slot* slot = find_slot(list, hash, name);
+    if (slot->offset != 0) {
+        if (replace) {
+            slot->value = value;
+        }
+        return 1;
+    }
+    
+    // 아레나에 정규화된 문자열 추가 (0번 바이트는 빈 슬롯 표시용으로 비워 둠)
+    size_t needed = ((list->arena_used != 0) ? list->arena_used : 1) + length + 1;
+    if (needed > list->arena_size) {
+        size_t new_size = (list->arena_size != 0) ? list->arena_size : ALLOWLIST_INITIAL_ARENA;
+        while (new_size < needed) {
+            new_size *= 2;
+        }
+        char* arena = (char*)realloc(list->arena, new_size);
+        if (arena == NULL) {
+            return 0;
+        }
+        list->arena = arena;
+        list->arena_size = new_size;
+    }
+    if (list->arena_used == 0) {
+        list->arena[0] = '\0';
+        list->arena_used = 1;
+    }
+    
+    char* dest = list->arena + list->arena_used;
+    for (size_t i = 0; i < length; i++) {
+        dest[i] = (char)fold_char((unsigned char)name[i]);
+    }
+    dest[length] = '\0';
+    
+    slot->hash = hash;
+    slot->offset = (unsigned int)list->arena_used;
+    slot->value = value;
+    list->arena_used += length + 1;
+    list->count++;
+    return 1;
+}
+
+/**
+ * @brief 프로세스 이름을 값 1로 추가합니다.
+ */
+int allowlist_add(allowlist* list, const char* name) {
+    return insert_name(list, name, 1, 0);
+}
+
+/**
+ * @brief 프로세스 이름을 추가하거나, 이미 있으면 값을 바꿉니다.
+ */
+int allowlist_set(allowlist* list, const char* name, unsigned int value) {
+    return insert_name(list, name, (value != 0) ? value : 1, 1);
+}
+
+/**
+ * @brief 프로세스 이름이 목록에 있는지 확인합니다.
+ */
+int allowlist_contains(const allowlist* list, const char* name) {
+    if (name == NULL || list->count == 0) {
+        return 0;
+    }
+    size_t length = 0;
+    unsigned int hash = hash_folded(name, &length);
+    return find_slot(list, hash, name)->offset != 0;
+}
+
+/**
+ * @brief 프로세스 이름에 저장된 값을 반환합니다.
+ */
+unsigned int allowlist_value(const allowlist* list, const char* name) {
+    if (name == NULL || list->count == 0) {
+        return 0;
+    }
+    size_t length = 0;
+    unsigned int hash = hash_folded(name, &length);
+    return find_slot(list, hash, name)->value;
+}
+
+/**
+ * @brief 등록된 이름 수를 반환합니다.
+ */
+unsigned long allowlist_count(const allowlist* list) {
+    return list->count;
+}
@@ -0,0 +1,99 @@
+#include "config_reloader.h"
+#include "policy_loader.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/** @brief 감시 스레드가 종료 요청을 확인하는 간격 (밀리초) */
+#define CONFIG_RELOAD_POLL_MS 250
+
+/**
+ * @brief 설정 파일을 다시 읽어 새 정책 스냅샷을 만드는 기본 콜백
+ */
+policy_snapshot* config_reloader_load_file(const char* path, void* user) {
+    (void)user;
+    policy_load_status status = POLICY_LOAD_OK;
+    policy_snapshot* snapshot = policy_load_file(path, &status);
+    if (status == POLICY_LOAD_MISSING) {
+        fprintf(stderr, "[경고] INI 파일이 없어 기존 정책을 유지합니다: %s\n", path);
+        policy_snapshot_destroy(snapshot);
+        return NULL;
+    }
+    return snapshot;
+}
+
+/**
+ * @brief 리로더를 초기화하고 파일 감시를 시작합니다.
+ */
+int config_reloader_init(config_reloader* reloader, const char* path, policy_store* store,
+                         policy_load_fn load, policy_published_fn published, void* user) {
+    memset(reloader, 0, sizeof(*reloader));
+    reloader->store = store;
+    reloader->load = load;
+    reloader->published = published;
+    reloader->user = user;
+    return file_watch_open(&reloader->watch, path);
+}
+
+/**
+ * @brief 변경을 기다렸다가, 바뀌었으면 다시 로드하여 게시합니다.
+ */
+int config_reloader_poll(config_reloader* reloader, unsigned int timeout_ms) {
+    if (file_watch_wait(&reloader->watch, timeout_ms) <= 0) {
+        // 대기 중이던 스냅샷 회수 기회로 사용
+        policy_store_reclaim(reloader->store);
+        return 0;
+    }
+    
+    // 편집기가 파일을 여러 번에 나눠 쓰는 경우를 위해 변경이 잦아들 때까지 대기
+    do {
+        file_watch_rearm(&reloader->watch);
+    } while (file_watch_wait(&reloader->watch, CONFIG_RELOAD_DEBOUNCE_MS) > 0);
+    
+    return config_reloader_reload(reloader);
+}
+
+/**
+ * @brief 설정 파일을 지금 다시 로드하여 게시합니다.
+ */
+int config_reloader_reload(config_reloader* reloader) {
+    policy_snapshot* snapshot = reloader->load(reloader->watch.path, reloader->user);
+    if (snapshot == NULL) {
+        reloader->failures++;
+        return -1;
+    }
+    
+    policy_store_publish(reloader->store, snapshot);
+    reloader->reloads++;
+    if (reloader->published != NULL) {
+        reloader->published(snapshot, reloader->user);
+    }
+    return 1;
+}
+
+/**
+ * @brief 감시 스레드 함수
+ */
+static void reloader_thread(void* arg) {
+    config_reloader* reloader = (config_reloader*)arg;
+    while (!reloader->stop) {
+        config_reloader_poll(reloader, CONFIG_RELOAD_POLL_MS);
+    }
+}
+
+/**
+ * @brief 백그라운드 감시 스레드를 시작합니다.
+ */
+int config_reloader_start(config_reloader* reloader) {
+    reloader->stop = 0;
+    return kp_thread_start(&reloader->thread, reloader_thread, reloader);
+}
+
+/**
+ * @brief 감시 스레드를 멈추고 파일 감시를 끝냅니다.
+ */
+void config_reloader_stop(config_reloader* reloader) {
+    reloader->stop = 1;
+    kp_thread_join(&reloader->thread);
+    file_watch_close(&reloader->watch);
+}
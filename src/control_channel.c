@@ -0,0 +1,754 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#ifdef __linux__
+#define _GNU_SOURCE  // struct ucred (SO_PEERCRED)
+#endif
+#endif
+
+#include "control_channel.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#endif
+
+/** @brief 응답을 보낼 때 기다리는 최대 시간 (느린 클라이언트가 메인 루프를 붙잡지 않도록 제한) */
+#define CONTROL_WRITE_TIMEOUT_MS 1000
+
+/** @brief 전체 경로 버퍼 크기 */
+#define CONTROL_PATH_SIZE 128
+
+/**
+ * @brief 카운터 이름 (control_stat 순서)
+ */
+static const char* const g_stat_names[CONTROL_STAT_COUNT] = {
+    "uptime_ms",
+    "policy_version",
+    "allowed_processes",
+    "log_verbosity",
+    "processed",
+    "dropped",
+    "allowed",
+    "blocked",
+    "unknown",
+    "injected",
+    "repeats",
+    "rule_blocked",
+    "self_passed",
+    "foreign_passed",
+    "foreign_blocked",
+    "foreign_processed",
+    "reloads",
+    "reload_failures",
+    "delivery_channels",
+    "delivered",
+    "delivery_fallbacks",
+    "hook_level",
+    "hook_over_budget",
+    "hook_degradations",
+    "hook_recoveries",
+    "hook_probes",
+    "hook_reinstalls",
+    "shadow_key_downs",
+    "shadow_disagreements"
+};
+
+/**
+ * @brief 카운터 이름을 반환합니다.
+ */
+const char* control_stat_name(control_stat stat) {
+    return ((unsigned int)stat < CONTROL_STAT_COUNT) ? g_stat_names[stat] : "unknown";
+}
+
+/**
+ * @brief 응답 본문을 상태 값 하나로 초기화합니다.
+ */
+void control_message_set_status(control_message* reply, control_status status) {
+    uint32_t value = (uint32_t)status;
+    memcpy(reply->payload, &value, sizeof(value));
+    reply->header.length = (uint16_t)sizeof(value);
+}
+
+/**
+ * @brief 응답 본문 끝에 데이터를 덧붙입니다.
+ */
+int control_message_append(control_message* reply, const void* data, size_t size) {
+    if ((size_t)reply->header.length + size > CONTROL_PAYLOAD_MAX) {
+        return 0;
+    }
+    memcpy(reply->payload + reply->header.length, data, size);
+    reply->header.length = (uint16_t)(reply->header.length + size);
+    return 1;
+}
+
+/**
+ * @brief 응답 본문의 상태 값을 읽습니다.
+ */
+control_status control_message_status(const control_message* reply) {
+    uint32_t value = CONTROL_ERR_INVALID;
+    if (reply->header.length >= sizeof(value)) {
+        memcpy(&value, reply->payload, sizeof(value));
+    }
+    return (control_status)value;
+}
+
+/**
+ * @brief 채널 이름을 확인하고 복사합니다.
+ * @details 경로 구분자나 특수 문자가 섞이지 않도록 영문자, 숫자, '_', '-', '.'만 허용합니다.
+ */
+static int copy_name(char* dest, const char* name) {
+    if (name == NULL) {
+        name = CONTROL_CHANNEL_NAME;
+    }
+    size_t length = strlen(name);
+    if (length == 0 || length >= CONTROL_NAME_SIZE) {
+        return 0;
+    }
+    for (size_t i = 0; i < length; i++) {
+        char c = name[i];
+        int valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                    c == '_' || c == '-' || c == '.';
+        if (!valid) {
+            return 0;
+        }
+    }
+    memcpy(dest, name, length + 1);
+    return 1;
+}
+
+/**
+ * @brief 요청 프레임 헤더가 올바른지 확인합니다.
+ */
+static int header_valid(const control_header* header) {
+    return header->magic == CONTROL_MAGIC && header->length <= CONTROL_PAYLOAD_MAX;
+}
+
+static int server_send(control_server* server, const void* data, size_t size);
+
+/**
+ * @brief 받은 바이트에서 완성된 프레임을 모두 처리하고 응답을 보냅니다.
+ * @return int 처리한 요청 수, 잘못된 프레임이거나 응답을 보내지 못하면 -1
+ */
+static int dispatch_frames(control_server* server) {
+    int handled = 0;
+    while (server->used >= sizeof(control_header)) {
+        control_header header;
+        memcpy(&header, server->buffer, sizeof(header));
+        if (!header_valid(&header) || (header.type & CONTROL_REPLY) != 0) {
+            return -1;
+        }
+        size_t total = sizeof(control_header) + header.length;
+        if (server->used < total) {
+            break;
+        }
+
+        control_message request;
+        control_message reply;
+        memset(&request, 0, sizeof(request));
+        memset(&reply, 0, sizeof(reply));
+        memcpy(&request, server->buffer, total);
+        reply.header.magic = CONTROL_MAGIC;
+        reply.header.type = (uint16_t)(header.type | CONTROL_REPLY);
+        control_message_set_status(&reply, CONTROL_ERR_UNKNOWN);
+        server->handler(&request, &reply, server->user);
+        server->requests++;
+        handled++;
+
+        if (!server_send(server, &reply, sizeof(control_header) + reply.header.length)) {
+            return -1;
+        }
+        memmove(server->buffer, server->buffer + total, server->used - total);
+        server->used -= total;
+    }
+    return handled;
+}
+
+#ifdef _WIN32
+
+#ifndef PIPE_REJECT_REMOTE_CLIENTS
+#define PIPE_REJECT_REMOTE_CLIENTS 0x00000008
+#endif
+
+/**
+ * @brief 채널 이름으로 파이프 경로를 만듭니다.
+ */
+static void pipe_path(char* path, const char* name) {
+    snprintf(path, CONTROL_PATH_SIZE, "\\\\.\\pipe\\%s", name);
+}
+
+/** @brief GetNamedPipeClientProcessId 함수 형식 (Windows Vista 이상) */
+typedef BOOL (WINAPI *GetNamedPipeClientProcessIdFn)(HANDLE, PULONG);
+
+/**
+ * @brief 연결된 클라이언트를 기록하고 프로세스 ID를 확인합니다.
+ * @details Windows XP에는 GetNamedPipeClientProcessId가 없으므로 동적으로 찾고, 없으면 0으로 둡니다.
+ */
+static void pipe_connected(control_server* server) {
+    static GetNamedPipeClientProcessIdFn query = NULL;
+    static int resolved = 0;
+    if (!resolved) {
+        HMODULE kernel = GetModuleHandleA("kernel32.dll");
+        if (kernel != NULL) {
+            query = (GetNamedPipeClientProcessIdFn)(void*)GetProcAddress(kernel, "GetNamedPipeClientProcessId");
+        }
+        resolved = 1;
+    }
+
+    ULONG pid = 0;
+    server->connected = 1;
+    server->client_pid = (query != NULL && query((HANDLE)server->pipe, &pid)) ? (unsigned long)pid : 0;
+}
+
+/**
+ * @brief 다음 클라이언트 연결을 기다리기 시작합니다.
+ * @details 클라이언트가 먼저 연결되어 있었다면(ERROR_PIPE_CONNECTED) 이벤트를 직접 신호하여
+ *          메인 루프가 곧바로 control_server_service()를 호출하도록 합니다.
+ */
+static void pipe_listen(control_server* server) {
+    OVERLAPPED* overlapped = (OVERLAPPED*)server->overlapped;
+    HANDLE event = overlapped->hEvent;
+    memset(overlapped, 0, sizeof(*overlapped));
+    overlapped->hEvent = event;
+    ResetEvent(event);
+
+    server->pending = 0;
+    if (ConnectNamedPipe((HANDLE)server->pipe, overlapped)) {
+        pipe_connected(server);
+        SetEvent(event);
+        return;
+    }
+    DWORD error = GetLastError();
+    if (error == ERROR_IO_PENDING) {
+        server->pending = 1;
+    } else if (error == ERROR_PIPE_CONNECTED) {
+        pipe_connected(server);
+        SetEvent(event);
+    }
+}
+
+/**
+ * @brief 클라이언트 연결을 끊고 다음 연결을 기다립니다.
+ */
+static void pipe_restart(control_server* server) {
+    DisconnectNamedPipe((HANDLE)server->pipe);
+    server->connected = 0;
+    server->client_pid = 0;
+    server->used = 0;
+    pipe_listen(server);
+}
+
+/**
+ * @brief 다음 요청 바이트를 겹친 I/O로 읽기 시작합니다.
+ * @return int 시작했으면 1, 연결이 끊어졌으면 0
+ */
+static int pipe_read(control_server* server) {
+    OVERLAPPED* overlapped = (OVERLAPPED*)server->overlapped;
+    HANDLE event = overlapped->hEvent;
+    memset(overlapped, 0, sizeof(*overlapped));
+    overlapped->hEvent = event;
+
+    // 즉시 완료되어도 이벤트가 신호되므로 완료 처리는 항상 control_server_service()에서 수행
+    if (!ReadFile((HANDLE)server->pipe, server->buffer + server->used,
+                  (DWORD)(sizeof(server->buffer) - server->used), NULL, overlapped) &&
+        GetLastError() != ERROR_IO_PENDING) {
+        return 0;
+    }
+    server->pending = 1;
+    return 1;
+}
+
+/**
+ * @brief 응답을 보냅니다. (진행 중인 읽기가 없을 때만 호출)
+ */
+static int server_send(control_server* server, const void* data, size_t size) {
+    OVERLAPPED* overlapped = (OVERLAPPED*)server->overlapped;
+    HANDLE event = overlapped->hEvent;
+    memset(overlapped, 0, sizeof(*overlapped));
+    overlapped->hEvent = event;
+
+    if (!WriteFile((HANDLE)server->pipe, data, (DWORD)size, NULL, overlapped) &&
+        GetLastError() != ERROR_IO_PENDING) {
+        return 0;
+    }
+    if (WaitForSingleObject(event, CONTROL_WRITE_TIMEOUT_MS) != WAIT_OBJECT_0) {
+        CancelIo((HANDLE)server->pipe);
+        return 0;
+    }
+    DWORD written = 0;
+    return GetOverlappedResult((HANDLE)server->pipe, overlapped, &written, FALSE) && written == size;
+}
+
+/**
+ * @brief 서버를 열고 첫 연결을 기다리기 시작합니다.
+ * @details 원격 클라이언트는 거부하며(Windows Vista 이상), 기본 보안 설명자에 따라 쓰기는
+ *          같은 사용자와 관리자만 할 수 있습니다. 같은 이름의 서버가 이미 있으면 실패합니다.
+ */
+int control_server_open(control_server* server, const char* name, control_handler_fn handler, void* user) {
+    memset(server, 0, sizeof(*server));
+    if (!copy_name(server->name, name)) {
+        return 0;
+    }
+    server->handler = handler;
+    server->user = user;
+
+    OVERLAPPED* overlapped = (OVERLAPPED*)calloc(1, sizeof(OVERLAPPED));
+    HANDLE event = CreateEventA(NULL, TRUE, FALSE, NULL);
+    if (overlapped == NULL || event == NULL) {
+        free(overlapped);
+        if (event != NULL) {
+            CloseHandle(event);
+        }
+        return 0;
+    }
+    overlapped->hEvent = event;
+
+    char path[CONTROL_PATH_SIZE];
+    pipe_path(path, server->name);
+    DWORD openMode = PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE;
+    DWORD pipeMode = PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT;
+    HANDLE pipe = CreateNamedPipeA(path, openMode, pipeMode | PIPE_REJECT_REMOTE_CLIENTS, 1,
+                                   sizeof(control_message), sizeof(control_message), 0, NULL);
+    if (pipe == INVALID_HANDLE_VALUE && GetLastError() == ERROR_INVALID_PARAMETER) {
+        // Windows XP는 PIPE_REJECT_REMOTE_CLIENTS를 지원하지 않음
+        pipe = CreateNamedPipeA(path, openMode, pipeMode, 1,
+                                sizeof(control_message), sizeof(control_message), 0, NULL);
+    }
+    if (pipe == INVALID_HANDLE_VALUE) {
+        CloseHandle(event);
+        free(overlapped);
+        return 0;
+    }
+
+    server->pipe = pipe;
+    server->event = event;
+    server->overlapped = overlapped;
+    pipe_listen(server);
+    return 1;
+}
+
+/**
+ * @brief 메인 루프가 기다릴 Win32 이벤트 핸들을 반환합니다.
+ */
+void* control_server_wait_handle(const control_server* server) {
+    return server->event;
+}
+
+/**
+ * @brief POSIX 전용이므로 항상 -1을 반환합니다.
+ */
+int control_server_fd(const control_server* server) {
+    (void)server;
+    return -1;
+}
+
+/**
+ * @brief 완료된 연결/읽기를 처리하고 다음 읽기를 시작합니다.
+ */
+int control_server_service(control_server* server) {
+    if (server->pipe == NULL) {
+        return 0;
+    }
+
+    int handled = 0;
+    if (server->pending) {
+        if (WaitForSingleObject((HANDLE)server->event, 0) != WAIT_OBJECT_0) {
+            return 0;
+        }
+        DWORD bytes = 0;
+        BOOL ok = GetOverlappedResult((HANDLE)server->pipe, (OVERLAPPED*)server->overlapped, &bytes, FALSE);
+        server->pending = 0;
+        if (!server->connected) {
+            if (!ok) {
+                pipe_restart(server);
+                return 0;
+            }
+            pipe_connected(server);
+        } else {
+            if (!ok || bytes == 0) {
+                // 클라이언트가 연결을 끊음
+                pipe_restart(server);
+                return 0;
+            }
+            server->used += bytes;
+            handled = dispatch_frames(server);
+            if (handled < 0) {
+                server->rejected++;
+                pipe_restart(server);
+                return 0;
+            }
+        }
+    }
+
+    if (server->connected && !server->pending && !pipe_read(server)) {
+        pipe_restart(server);
+    }
+    return handled;
+}
+
+/**
+ * @brief 서버를 닫습니다.
+ */
+void control_server_close(control_server* server) {
+    if (server->pipe != NULL) {
+        CancelIo((HANDLE)server->pipe);
+        if (server->connected) {
+            DisconnectNamedPipe((HANDLE)server->pipe);
+        }
+        CloseHandle((HANDLE)server->pipe);
+        server->pipe = NULL;
+    }
+    if (server->event != NULL) {
+        CloseHandle((HANDLE)server->event);
+        server->event = NULL;
+    }
+    free(server->overlapped);
+    server->overlapped = NULL;
+    server->connected = 0;
+    server->pending = 0;
+}
+
+/** @brief 클라이언트 연결 */
+typedef HANDLE client_conn;
+
+/**
+ * @brief 서버에 연결합니다. (파이프가 사용 중이면 timeout_ms까지 기다림)
+ */
+static int client_open(client_conn* conn, const char* name, unsigned int timeout_ms) {
+    char path[CONTROL_PATH_SIZE];
+    pipe_path(path, name);
+    for (int attempt = 0; attempt < 2; attempt++) {
+        HANDLE pipe = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
+        if (pipe != INVALID_HANDLE_VALUE) {
+            *conn = pipe;
+            return 1;
+        }
+        if (GetLastError() != ERROR_PIPE_BUSY || !WaitNamedPipeA(path, timeout_ms)) {
+            break;
+        }
+    }
+    return 0;
+}
+
+static int client_write(client_conn conn, const void* data, size_t size) {
+    DWORD written = 0;
+    return WriteFile(conn, data, (DWORD)size, &written, NULL) && written == size;
+}
+
+static int client_read(client_conn conn, void* data, size_t size) {
+    unsigned char* bytes = (unsigned char*)data;
+    while (size > 0) {
+        DWORD read = 0;
+        if (!ReadFile(conn, bytes, (DWORD)size, &read, NULL) || read == 0) {
+            return 0;
+        }
+        bytes += read;
+        size -= read;
+    }
+    return 1;
+}
+
+static void client_close(client_conn conn) {
+    CloseHandle(conn);
+}
+
+#else
+
+/**
+ * @brief 채널 이름으로 소켓 경로를 만듭니다.
+ */
+static int socket_address(struct sockaddr_un* address, const char* name) {
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    int length = snprintf(address->sun_path, sizeof(address->sun_path), "/tmp/%s.sock", name);
+    return length > 0 && (size_t)length < sizeof(address->sun_path);
+}
+
+/**
+ * @brief 소켓을 논블로킹 모드로 바꿉니다.
+ */
+static int set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/**
+ * @brief 소켓 경로를 이미 쓰는 서버가 살아 있는지 확인합니다.
+ */
+static int socket_in_use(const struct sockaddr_un* address) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return 0;
+    }
+    int alive = connect(fd, (const struct sockaddr*)address, sizeof(*address)) == 0;
+    close(fd);
+    return alive;
+}
+
+/**
+ * @brief 연결된 클라이언트를 닫습니다.
+ */
+static void close_client(control_server* server) {
+    if (server->client_fd >= 0) {
+        close(server->client_fd);
+    }
+    server->client_fd = -1;
+    server->connected = 0;
+    server->client_pid = 0;
+    server->used = 0;
+}
+
+/**
+ * @brief 연결된 클라이언트의 프로세스 ID를 확인합니다. (확인할 수 없으면 0)
+ */
+static unsigned long peer_pid(int fd) {
+#ifdef SO_PEERCRED
+    struct ucred credentials;
+    socklen_t size = sizeof(credentials);
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &size) == 0) {
+        return (unsigned long)credentials.pid;
+    }
+#else
+    (void)fd;
+#endif
+    return 0;
+}
+
+/**
+ * @brief 응답을 보냅니다. (소켓이 가득 차면 CONTROL_WRITE_TIMEOUT_MS까지 기다림)
+ */
+static int server_send(control_server* server, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    while (size > 0) {
+        ssize_t sent = send(server->client_fd, bytes, size, MSG_NOSIGNAL);
+        if (sent > 0) {
+            bytes += sent;
+            size -= (size_t)sent;
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            struct pollfd entry = { server->client_fd, POLLOUT, 0 };
+            if (poll(&entry, 1, CONTROL_WRITE_TIMEOUT_MS) > 0) {
+                continue;
+            }
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief 서버를 열고 첫 연결을 기다리기 시작합니다.
+ * @details 소켓 파일은 소유자만 읽고 쓸 수 있습니다. 이전 실행이 남긴 소켓 파일은 응답하는 서버가
+ *          없을 때만 지우고 다시 만듭니다.
+ */
+int control_server_open(control_server* server, const char* name, control_handler_fn handler, void* user) {
+    memset(server, 0, sizeof(*server));
+    server->listen_fd = -1;
+    server->client_fd = -1;
+    struct sockaddr_un address;
+    if (!copy_name(server->name, name) || !socket_address(&address, server->name)) {
+        return 0;
+    }
+    server->handler = handler;
+    server->user = user;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return 0;
+    }
+    mode_t previous = umask(077);
+    int bound = bind(fd, (struct sockaddr*)&address, sizeof(address)) == 0;
+    if (!bound && errno == EADDRINUSE && !socket_in_use(&address)) {
+        unlink(address.sun_path);
+        bound = bind(fd, (struct sockaddr*)&address, sizeof(address)) == 0;
+    }
+    umask(previous);
+    if (!bound || listen(fd, 1) != 0 || !set_nonblocking(fd)) {
+        if (bound) {
+            unlink(address.sun_path);
+        }
+        close(fd);
+        return 0;
+    }
+    server->listen_fd = fd;
+    return 1;
+}
+
+/**
+ * @brief Windows 전용이므로 항상 NULL을 반환합니다.
+ */
+void* control_server_wait_handle(const control_server* server) {
+    (void)server;
+    return NULL;
+}
+
+/**
+ * @brief 메인 루프가 poll로 기다릴 소켓을 반환합니다.
+ */
+int control_server_fd(const control_server* server) {
+    return (server->client_fd >= 0) ? server->client_fd : server->listen_fd;
+}
+
+/**
+ * @brief 대기 중인 연결을 받고, 받은 요청을 처리합니다.
+ */
+int control_server_service(control_server* server) {
+    if (server->listen_fd < 0) {
+        return 0;
+    }
+    if (server->client_fd < 0) {
+        int fd = accept(server->listen_fd, NULL, NULL);
+        if (fd < 0) {
+            return 0;
+        }
+        if (!set_nonblocking(fd)) {
+            close(fd);
+            return 0;
+        }
+        server->client_fd = fd;
+        server->connected = 1;
+        server->client_pid = peer_pid(fd);
+        server->used = 0;
+    }
+
+    ssize_t received = recv(server->client_fd, server->buffer + server->used,
+                            sizeof(server->buffer) - server->used, 0);
+    if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return 0;
+    }
+    if (received <= 0) {
+        // 클라이언트가 연결을 끊음
+        close_client(server);
+        return 0;
+    }
+    server->used += (size_t)received;
+    int handled = dispatch_frames(server);
+    if (handled < 0) {
+        server->rejected++;
+        close_client(server);
+        return 0;
+    }
+    return handled;
+}
+
+/**
+ * @brief 서버를 닫고 소켓 파일을 지웁니다.
+ */
+void control_server_close(control_server* server) {
+    close_client(server);
+    if (server->listen_fd >= 0) {
+        struct sockaddr_un address;
+        close(server->listen_fd);
+        server->listen_fd = -1;
+        if (socket_address(&address, server->name)) {
+            unlink(address.sun_path);
+        }
+    }
+}
+
+/** @brief 클라이언트 연결 */
+typedef int client_conn;
+
+/**
+ * @brief 서버에 연결합니다. (보내기/받기 제한 시간은 timeout_ms)
+ */
+static int client_open(client_conn* conn, const char* name, unsigned int timeout_ms) {
+    struct sockaddr_un address;
+    if (!socket_address(&address, name)) {
+        return 0;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return 0;
+    }
+    struct timeval timeout;
+    timeout.tv_sec = (time_t)(timeout_ms / 1000);
+    timeout.tv_usec = (suseconds_t)((timeout_ms % 1000) * 1000);
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0) {
+        close(fd);
+        return 0;
+    }
+    *conn = fd;
+    return 1;
+}
+
+static int client_write(client_conn conn, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    while (size > 0) {
+        ssize_t sent = send(conn, bytes, size, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            return 0;
+        }
+        bytes += sent;
+        size -= (size_t)sent;
+    }
+    return 1;
+}
+
+static int client_read(client_conn conn, void* data, size_t size) {
+    unsigned char* bytes = (unsigned char*)data;
+    while (size > 0) {
+        ssize_t received = recv(conn, bytes, size, 0);
+        if (received <= 0) {
+            return 0;
+        }
+        bytes += received;
+        size -= (size_t)received;
+    }
+    return 1;
+}
+
+static void client_close(client_conn conn) {
+    close(conn);
+}
+
+#endif
+
+/**
+ * @brief 요청을 보내고 응답을 기다립니다.
+ */
+int control_client_call(const char* name, control_command command, const void* payload, size_t size,
+                        control_message* reply, unsigned int timeout_ms) {
+    char channel[CONTROL_NAME_SIZE];
+    if (!copy_name(channel, name) || size > CONTROL_PAYLOAD_MAX) {
+        return 0;
+    }
+
+    control_message request;
+    memset(&request, 0, sizeof(request));
+    request.header.magic = CONTROL_MAGIC;
+    request.header.type = (uint16_t)command;
+    request.header.length = (uint16_t)size;
+    if (size > 0) {
+        memcpy(request.payload, payload, size);
+    }
+
+    client_conn conn;
+    if (!client_open(&conn, channel, timeout_ms)) {
+        return 0;
+    }
+    memset(reply, 0, sizeof(*reply));
+    int ok = client_write(conn, &request, sizeof(control_header) + size) &&
+             client_read(conn, &reply->header, sizeof(reply->header)) &&
+             header_valid(&reply->header) &&
+             reply->header.type == (uint16_t)(command | CONTROL_REPLY) &&
+             client_read(conn, reply->payload, reply->header.length);
+    client_close(conn);
+    return ok;
+}
@@ -0,0 +1,259 @@
+#include "device_table.h"
+
+#include <string.h>
+
+/** @brief 테이블 인덱스 마스크 */
+#define DEVICE_TABLE_MASK (DEVICE_TABLE_CAPACITY - 1)
+
+/**
+ * @brief 분류 이름 (device_class 순서)
+ */
+static const char* const g_device_class_names[DEVICE_CLASS_COUNT] = { "normal", "trusted", "untrusted" };
+
+/**
+ * @brief ASCII 대문자를 소문자로 바꿉니다.
+ */
+static unsigned char fold_char(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? (unsigned char)(c + ('a' - 'A')) : c;
+}
+
+/**
+ * @brief 대소문자를 무시하고 text에 pattern이 들어 있는지 확인합니다.
+ */
+static int contains_folded(const char* text, const char* pattern) {
+    if (pattern[0] == '\0') {
+        return 0;
+    }
+    for (const unsigned char* start = (const unsigned char*)text; *start != '\0'; start++) {
+        const unsigned char* a = start;
+        const unsigned char* b = (const unsigned char*)pattern;
+        while (*b != '\0' && *a != '\0' && fold_char(*a) == fold_char(*b)) {
+            a++;
+            b++;
+        }
+        if (*b == '\0') {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 장치 핸들의 해시 자리 (핸들은 4의 배수인 경우가 많으므로 곱셈 해시의 상위 비트 사용)
+ */
+static unsigned int slot_of(uintptr_t handle) {
+    uint64_t mixed = (uint64_t)handle * 0x9E3779B97F4A7C15ULL;
+    return (unsigned int)(mixed >> 58) & DEVICE_TABLE_MASK;
+}
+
+/**
+ * @brief 분류 이름을 값으로 바꿉니다.
+ */
+int device_class_parse(const char* text) {
+    for (int i = 0; i < DEVICE_CLASS_COUNT; i++) {
+        const char* name = g_device_class_names[i];
+        const unsigned char* a = (const unsigned char*)text;
+        const unsigned char* b = (const unsigned char*)name;
+        while (*b != '\0' && fold_char(*a) == *b) {
+            a++;
+            b++;
+        }
+        if (*a == '\0' && *b == '\0') {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief 분류 값을 이름으로 바꿉니다.
+ */
+const char* device_class_name(int device_class) {
+    return (device_class >= 0 && device_class < DEVICE_CLASS_COUNT) ? g_device_class_names[device_class] : "?";
+}
+
+/**
+ * @brief 규칙 목록을 비웁니다.
+ */
+void device_rules_init(device_rules* rules) {
+    memset(rules, 0, sizeof(*rules));
+    rules->default_class = DEVICE_CLASS_NORMAL;
+}
+
+/**
+ * @brief 규칙을 추가합니다.
+ */
+int device_rules_add(device_rules* rules, const char* pattern, int device_class) {
+    if (rules->count >= DEVICE_MAX_RULES) {
+        return 0;
+    }
+    device_rule* rule = &rules->rules[rules->count++];
+    strncpy(rule->pattern, pattern, sizeof(rule->pattern) - 1);
+    rule->pattern[sizeof(rule->pattern) - 1] = '\0';
+    rule->device_class = device_class;
+    return 1;
+}
+
+/**
+ * @brief 장치 이름에 해당하는 분류를 찾습니다.
+ */
+int device_rules_classify(const device_rules* rules, const char* device_name) {
+    if (rules == NULL) {
+        return DEVICE_CLASS_NORMAL;
+    }
+    if (device_name != NULL) {
+        for (int i = 0; i < rules->count; i++) {
+            if (contains_folded(device_name, rules->rules[i].pattern)) {
+                return rules->rules[i].device_class;
+            }
+        }
+    }
+    return rules->default_class;
+}
+
+/**
+ * @brief 차단할 장치가 있을 수 있는 규칙인지 확인합니다.
+ */
+int device_rules_has_untrusted(const device_rules* rules) {
+    if (rules->default_class == DEVICE_CLASS_UNTRUSTED) {
+        return 1;
+    }
+    for (int i = 0; i < rules->count; i++) {
+        if (rules->rules[i].device_class == DEVICE_CLASS_UNTRUSTED) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 빈 테이블로 초기화합니다.
+ */
+void device_table_init(device_table* table) {
+    memset(table, 0, sizeof(*table));
+}
+
+/**
+ * @brief 장치를 찾습니다.
+ */
+device_entry* device_table_find(device_table* table, uintptr_t handle) {
+    table->lookups++;
+    unsigned int index = slot_of(handle);
+    for (int probe = 0; probe < DEVICE_TABLE_CAPACITY; probe++) {
+        device_entry* entry = &table->entries[index];
+        table->probes++;
+        if (entry->handle == handle) {
+            return entry;
+        }
+        if (entry->handle == 0) {
+            return NULL;
+        }
+        index = (index + 1) & DEVICE_TABLE_MASK;
+    }
+    return NULL;
+}
+
+/**
+ * @brief 장치를 등록하고 규칙으로 분류합니다.
+ */
+device_entry* device_table_insert(device_table* table, uintptr_t handle, const char* name,
+                                  const device_rules* rules) {
+    unsigned int index = slot_of(handle);
+    for (int probe = 0; probe < DEVICE_TABLE_CAPACITY; probe++) {
+        device_entry* entry = &table->entries[index];
+        if (entry->handle == handle) {
+            return entry;
+        }
+        if (entry->handle == 0) {
+            memset(entry, 0, sizeof(*entry));
+            entry->handle = handle;
+            if (name != NULL) {
+                strncpy(entry->name, name, sizeof(entry->name) - 1);
+            }
+            entry->device_class = device_rules_classify(rules, entry->name[0] != '\0' ? entry->name : NULL);
+            table->count++;
+            return entry;
+        }
+        index = (index + 1) & DEVICE_TABLE_MASK;
+    }
+    return NULL;
+}
+
+/**
+ * @brief 장치를 제거합니다.
+ * @details 묘비 없이 뒤따르는 항목을 제자리로 당겨, 조회가 항상 빈 자리에서 끝나도록 합니다.
+ */
+int device_table_remove(device_table* table, uintptr_t handle) {
+    unsigned int index = slot_of(handle);
+    int probe;
+    for (probe = 0; probe < DEVICE_TABLE_CAPACITY; probe++) {
+        if (table->entries[index].handle == handle) {
+            break;
+        }
+        if (table->entries[index].handle == 0) {
+            return 0;
+        }
+        index = (index + 1) & DEVICE_TABLE_MASK;
+    }
+    if (probe == DEVICE_TABLE_CAPACITY) {
+        return 0;
+    }
+
+    unsigned int hole = index;
+    unsigned int next = (hole + 1) & DEVICE_TABLE_MASK;
+    while (table->entries[next].handle != 0) {
+        // 원래 자리가 (hole, next] 구간 밖이면 빈 자리로 옮겨도 조회 경로가 끊기지 않음
+        unsigned int home = slot_of(table->entries[next].handle);
+        unsigned int distance_next = (next - home) & DEVICE_TABLE_MASK;
+        unsigned int distance_hole = (next - hole) & DEVICE_TABLE_MASK;
+        if (distance_next >= distance_hole) {
+            table->entries[hole] = table->entries[next];
+            hole = next;
+        }
+        next = (next + 1) & DEVICE_TABLE_MASK;
+    }
+    memset(&table->entries[hole], 0, sizeof(table->entries[hole]));
+    table->count--;
+    return 1;
+}
+
+/**
+ * @brief 규칙이 바뀐 뒤 모든 장치를 다시 분류합니다.
+ */
+int device_table_classify(device_table* table, const device_rules* rules) {
+    int changed = 0;
+    for (int i = 0; i < DEVICE_TABLE_CAPACITY; i++) {
+        device_entry* entry = &table->entries[i];
+        if (entry->handle == 0) {
+            continue;
+        }
+        int device_class = device_rules_classify(rules, entry->name[0] != '\0' ? entry->name : NULL);
+        if (device_class != entry->device_class) {
+            entry->device_class = device_class;
+            changed++;
+        }
+    }
+    return changed;
+}
+
+/**
+ * @brief 장치의 키 하나를 기록하고 버스트 상태를 갱신합니다.
+ */
+int device_entry_key(device_entry* entry, unsigned long long now_ns) {
+    int started = 0;
+    if (entry->keys != 0 && now_ns >= entry->last_ns && now_ns - entry->last_ns <= DEVICE_BURST_GAP_NS) {
+        entry->run++;
+        if (entry->run == DEVICE_BURST_MIN_KEYS) {
+            entry->bursts++;
+            started = 1;
+        }
+        if (entry->run >= DEVICE_BURST_MIN_KEYS && entry->run > entry->longest_burst) {
+            entry->longest_burst = entry->run;
+        }
+    } else {
+        entry->run = 1;
+    }
+    entry->keys++;
+    entry->last_ns = now_ns;
+    return started;
+}
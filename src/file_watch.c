@@ -0,0 +1,165 @@
+#include "file_watch.h"
+#include "kp_platform.h"
+
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+/** @brief POSIX 구현에서 파일 상태를 확인하는 간격 (밀리초) */
+#define FILE_WATCH_POLL_MS 100
+
+/**
+ * @brief 파일의 수정 시각과 크기를 읽습니다.
+ * @details 파일이 없으면 크기를 -1로 기록합니다.
+ */
+static void read_stamp(const char* path, long long* mtime, long long* size) {
+    struct stat info;
+    if (stat(path, &info) != 0) {
+        *mtime = 0;
+        *size = -1;
+        return;
+    }
+    *mtime = (long long)info.st_mtime;
+    *size = (long long)info.st_size;
+}
+
+/**
+ * @brief 기준값과 비교하여 파일이 바뀌었는지 확인합니다.
+ */
+static int stamp_changed(const file_watch* watch) {
+    long long mtime = 0;
+    long long size = 0;
+    read_stamp(watch->path, &mtime, &size);
+    return mtime != watch->mtime || size != watch->size;
+}
+
+/**
+ * @brief 현재 파일 상태를 기준값으로 다시 기록합니다.
+ */
+void file_watch_rearm(file_watch* watch) {
+    read_stamp(watch->path, &watch->mtime, &watch->size);
+}
+
+#ifdef _WIN32
+
+/**
+ * @brief 파일 감시를 시작합니다.
+ * @details 파일이 들어 있는 디렉토리의 쓰기/이름/크기 변경 알림을 등록합니다.
+ */
+int file_watch_open(file_watch* watch, const char* path) {
+    memset(watch, 0, sizeof(*watch));
+    strncpy(watch->path, path, FILE_WATCH_PATH_SIZE - 1);
+    file_watch_rearm(watch);
+    
+    char directory[FILE_WATCH_PATH_SIZE];
+    strcpy(directory, watch->path);
+    char* lastSlash = strrchr(directory, '\\');
+    if (lastSlash != NULL) {
+        *lastSlash = '\0';
+    } else {
+        strcpy(directory, ".");
+    }
+    
+    watch->change_handle = FindFirstChangeNotificationA(
+        directory, FALSE,
+        FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE
+    );
+    if (watch->change_handle == INVALID_HANDLE_VALUE) {
+        watch->change_handle = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief 파일이 바뀔 때까지 최대 timeout_ms 동안 기다립니다.
+ * @details 같은 디렉토리의 다른 파일 변경으로 깨어난 경우에는 변경으로 보고하지 않습니다.
+ */
+int file_watch_wait(file_watch* watch, unsigned int timeout_ms) {
+    if (watch->change_handle == NULL) {
+        return -1;
+    }
+    DWORD result = WaitForSingleObject((HANDLE)watch->change_handle, timeout_ms);
+    if (result == WAIT_TIMEOUT) {
+        return 0;
+    }
+    if (result != WAIT_OBJECT_0) {
+        return -1;
+    }
+    if (!FindNextChangeNotification((HANDLE)watch->change_handle)) {
+        return -1;
+    }
+    return stamp_changed(watch);
+}
+
+/**
+ * @brief 디렉토리 변경 알림 핸들을 반환합니다.
+ */
+void* file_watch_handle(const file_watch* watch) {
+    return watch->change_handle;
+}
+
+/**
+ * @brief 파일 감시를 끝냅니다.
+ */
+void file_watch_close(file_watch* watch) {
+    if (watch->change_handle != NULL) {
+        FindCloseChangeNotification((HANDLE)watch->change_handle);
+        watch->change_handle = NULL;
+    }
+}
+
+#else
+
+/**
+ * @brief 파일 감시를 시작합니다.
+ */
+int file_watch_open(file_watch* watch, const char* path) {
+    memset(watch, 0, sizeof(*watch));
+    strncpy(watch->path, path, FILE_WATCH_PATH_SIZE - 1);
+    file_watch_rearm(watch);
+    return 1;
+}
+
+/**
+ * @brief 파일이 바뀔 때까지 최대 timeout_ms 동안 기다립니다.
+ * @details 알림 API 대신 FILE_WATCH_POLL_MS 간격으로 파일 상태를 비교합니다.
+ */
+int file_watch_wait(file_watch* watch, unsigned int timeout_ms) {
+    unsigned int waited = 0;
+    for (;;) {
+        if (stamp_changed(watch)) {
+            return 1;
+        }
+        if (waited >= timeout_ms) {
+            return 0;
+        }
+        unsigned int step = timeout_ms - waited;
+        if (step > FILE_WATCH_POLL_MS) {
+            step = FILE_WATCH_POLL_MS;
+        }
+        kp_sleep_ms(step);
+        waited += step;
+    }
+}
+
+/**
+ * @brief 알림 API를 쓰지 않으므로 항상 NULL을 반환합니다.
+ */
+void* file_watch_handle(const file_watch* watch) {
+    (void)watch;
+    return NULL;
+}
+
+/**
+ * @brief 파일 감시를 끝냅니다.
+ */
+void file_watch_close(file_watch* watch) {
+    (void)watch;
+}
+
+#endif
@@ -0,0 +1,118 @@
+#include "foreground_cache.h"
+#include "kp_atomic.h"
+
+#include <string.h>
+
+/**
+ * @brief 캐시를 초기화합니다.
+ * @param cache 초기화할 캐시
+ * @param provider 프로세스 조회 공급자
+ * @param verdict 허용 여부 판정 콜백
+ * @param verdict_user 판정 콜백에 전달할 사용자 데이터
+ */
+void foreground_cache_init(foreground_cache* cache, const process_lookup_provider* provider,
+                           process_verdict_fn verdict, void* verdict_user) {
+    memset(cache, 0, sizeof(*cache));
+    cache->provider = provider;
+    cache->verdict = verdict;
+    cache->verdict_user = verdict_user;
+}
+
+/**
+ * @brief 캐시를 무효화합니다.
+ * @details 세대 값만 증가시키며, 실제 재조회는 다음 foreground_cache_lookup()에서 수행됩니다.
+ */
+void foreground_cache_invalidate(foreground_cache* cache) {
+    kp_atomic_fetch_add(&cache->generation, 1UL);
+}
+
+/**
+ * @brief 두 식별 정보가 같은 프로세스의 같은 창을 가리키는지 비교합니다.
+ */
+static int identity_equals(const foreground_identity* a, const foreground_identity* b) {
+    return a->window == b->window &&
+           a->process_id == b->process_id &&
+           a->start_time == b->start_time;
+}
+
+/**
+ * @brief 포그라운드 변경 알림 없이 키마다 포그라운드를 확인할지 설정합니다.
+ */
+void foreground_cache_set_verify(foreground_cache* cache, int verify) {
+    cache->verify = verify ? 1 : 0;
+}
+
+/**
+ * @brief 확인 모드이면 포그라운드가 캐시와 같은지 확인하고, 다르면 캐시를 무효화합니다.
+ * @details 조회에 실패해도 무효화하여 다음 조회가 공급자를 다시 거치게 합니다. (캐시된 허용 판정을 쓰지 않음)
+ */
+int foreground_cache_verify(foreground_cache* cache) {
+    // 이미 무효화되어 다음 조회가 공급자를 거칠 때는 확인하지 않음
+    if (!cache->verify || !cache->valid || cache->cached_generation != kp_atomic_load(&cache->generation)) {
+        return 0;
+    }
+    foreground_identity identity;
+    memset(&identity, 0, sizeof(identity));
+    if (cache->provider->get_foreground(cache->provider->context, &identity) &&
+        identity_equals(&identity, &cache->identity)) {
+        return 0;
+    }
+    cache->verify_changes++;
+    foreground_cache_invalidate(cache);
+    return 1;
+}
+
+/**
+ * @brief 현재 포그라운드 프로세스의 판정을 반환합니다.
+ * @param cache 캐시
+ * @param process_name 프로세스 이름을 돌려받을 포인터 (NULL 가능)
+ * @return foreground_verdict 판정 결과
+ */
+foreground_verdict foreground_cache_lookup(foreground_cache* cache, const char** process_name) {
+    foreground_cache_verify(cache);
+    unsigned long generation = kp_atomic_load(&cache->generation);
+
+    // 빠른 경로: 마지막 조회 이후 무효화가 없었다면 캐시된 판정을 그대로 사용
+    if (cache->valid && cache->cached_generation == generation) {
+        cache->hits++;
+        if (process_name != NULL) {
+            *process_name = cache->process_name;
+        }
+        return cache->allowed ? FOREGROUND_ALLOWED : FOREGROUND_BLOCKED;
+    }
+
+    foreground_identity identity;
+    memset(&identity, 0, sizeof(identity));
+    if (!cache->provider->get_foreground(cache->provider->context, &identity)) {
+        // 포그라운드 창이 없는 경우 등은 캐시하지 않고 다음 키에서 다시 시도
+        cache->valid = 0;
+        cache->failures++;
+        return FOREGROUND_UNKNOWN;
+    }
+
+    if (cache->valid && identity_equals(&identity, &cache->identity)) {
+        // 같은 프로세스로 돌아온 경우: 이름은 그대로 두고 판정만 갱신 (정책 변경 대비)
+        cache->revalidations++;
+    } else {
+        char name[FOREGROUND_NAME_SIZE];
+        if (!cache->provider->get_process_name(cache->provider->context, &identity,
+                                               name, sizeof(name))) {
+            cache->valid = 0;
+            cache->failures++;
+            return FOREGROUND_UNKNOWN;
+        }
+        memcpy(cache->process_name, name, sizeof(name));
+        cache->process_name[FOREGROUND_NAME_SIZE - 1] = '\0';
+        cache->identity = identity;
+        cache->lookups++;
+    }
+
+    cache->allowed = cache->verdict(cache->process_name, cache->verdict_user);
+    cache->cached_generation = generation;
+    cache->valid = 1;
+
+    if (process_name != NULL) {
+        *process_name = cache->process_name;
+    }
+    return cache->allowed ? FOREGROUND_ALLOWED : FOREGROUND_BLOCKED;
+}
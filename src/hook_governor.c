@@ -0,0 +1,155 @@
+#include "hook_governor.h"
+#include "kp_atomic.h"
+
+#include <string.h>
+
+/**
+ * @brief 기본 설정을 채웁니다.
+ */
+void hook_governor_default_config(hook_governor_config* config, uint32_t timeout_ms, uint32_t budget_us) {
+    memset(config, 0, sizeof(*config));
+    config->budget_ns = (uint64_t)((budget_us != 0) ? budget_us : HOOK_GOVERNOR_DEFAULT_BUDGET_US) * 1000ULL;
+    config->timeout_ns = (uint64_t)timeout_ms * 1000000ULL;
+    config->stall_ns = HOOK_GOVERNOR_STALL_MS * 1000000ULL;
+    config->probe_timeout_ns = HOOK_GOVERNOR_PROBE_TIMEOUT_MS * 1000000ULL;
+    config->probe_interval_ns = HOOK_GOVERNOR_PROBE_INTERVAL_MS * 1000000ULL;
+    config->recover_windows = HOOK_GOVERNOR_RECOVER_WINDOWS;
+}
+
+/**
+ * @brief 관리자를 초기화합니다.
+ */
+void hook_governor_init(hook_governor* governor, const hook_governor_config* config, uint64_t now_ns) {
+    memset(governor, 0, sizeof(*governor));
+    governor->config = *config;
+    governor->heartbeat_ns = now_ns;
+}
+
+/**
+ * @brief 지연 예산을 바꿉니다.
+ */
+void hook_governor_set_budget(hook_governor* governor, uint64_t budget_ns) {
+    kp_atomic_store_relaxed(&governor->config.budget_ns, budget_ns);
+}
+
+/**
+ * @brief 후크가 호출되었음을 기록합니다.
+ */
+void hook_governor_heartbeat(hook_governor* governor, uint64_t now_ns) {
+    kp_atomic_store(&governor->heartbeat_ns, now_ns);
+}
+
+/**
+ * @brief 키 입력 하나의 지연 표본을 기록합니다.
+ * @details 최대값 갱신이 감시 스레드의 구간 마감과 겹치면 표본 하나가 다음 구간으로 넘어갈 수 있지만,
+ *          판정은 여러 구간에 걸쳐 이루어지므로 잠금을 쓰지 않습니다.
+ */
+void hook_governor_sample(hook_governor* governor, uint64_t latency_ns) {
+    kp_atomic_add_relaxed(&governor->window_samples, 1UL);
+    if (latency_ns > kp_atomic_load_relaxed(&governor->window_max_ns)) {
+        kp_atomic_store_relaxed(&governor->window_max_ns, latency_ns);
+    }
+    if (latency_ns > kp_atomic_load_relaxed(&governor->config.budget_ns)) {
+        kp_atomic_add_relaxed(&governor->window_over, 1UL);
+    }
+}
+
+/**
+ * @brief 구간 최대 지연으로 축소 단계를 조정합니다.
+ */
+static void adjust_level(hook_governor* governor, uint64_t window_max, unsigned long over) {
+    uint64_t budget = kp_atomic_load_relaxed(&governor->config.budget_ns);
+    int level = governor->level;
+
+    if (governor->config.timeout_ns != 0 && window_max > governor->config.timeout_ns / 2) {
+        // 후크 제거 직전: 단계를 하나씩 내릴 여유가 없음
+        governor->timeout_risks++;
+        if (level < HOOK_LEVEL_COUNT - 1) {
+            governor->degradations++;
+            level = HOOK_LEVEL_COUNT - 1;
+        }
+        governor->calm_windows = 0;
+    } else if (over > 0) {
+        if (level < HOOK_LEVEL_COUNT - 1) {
+            governor->degradations++;
+            level++;
+        }
+        governor->calm_windows = 0;
+    } else if (window_max <= budget / 2) {
+        // 입력이 없던 구간도 안정 구간으로 셈
+        if (level > HOOK_LEVEL_NORMAL && ++governor->calm_windows >= governor->config.recover_windows) {
+            governor->recoveries++;
+            governor->calm_windows = 0;
+            level--;
+        }
+    } else {
+        governor->calm_windows = 0;
+    }
+    kp_atomic_store(&governor->level, level);
+}
+
+/**
+ * @brief 구간을 마감하고 단계와 후크 생존을 판정합니다.
+ */
+hook_governor_action hook_governor_tick(hook_governor* governor, uint64_t now_ns, uint64_t last_input_ns) {
+    uint64_t window_max = kp_atomic_exchange(&governor->window_max_ns, (uint64_t)0);
+    unsigned long over = kp_atomic_exchange(&governor->window_over, 0UL);
+    kp_atomic_exchange(&governor->window_samples, 0UL);
+    governor->over_budget += over;
+    governor->last_window_max_ns = window_max;
+    adjust_level(governor, window_max, over);
+
+    uint64_t heartbeat = kp_atomic_load(&governor->heartbeat_ns);
+    if (governor->probing) {
+        if (heartbeat >= governor->probe_sent_ns) {
+            // 탐침(또는 다른 키)이 후크에 도착함: 후크는 살아 있음
+            governor->probing = 0;
+            return HOOK_ACTION_NONE;
+        }
+        if (now_ns - governor->probe_sent_ns >= governor->config.probe_timeout_ns) {
+            governor->probing = 0;
+            governor->reinstalls++;
+            return HOOK_ACTION_REINSTALL;
+        }
+        return HOOK_ACTION_NONE;
+    }
+
+    // 후크가 마지막으로 호출된 뒤의 입력이 유예 시간이 지나도록 후크에 오지 않음
+    // (마우스 입력도 시스템 입력이므로 바로 재설치하지 않고 탐침으로 확인)
+    if (last_input_ns > heartbeat && now_ns >= last_input_ns &&
+        now_ns - last_input_ns >= governor->config.stall_ns &&
+        (governor->probes == 0 || now_ns - governor->probe_sent_ns >= governor->config.probe_interval_ns)) {
+        governor->probing = 1;
+        governor->probe_sent_ns = now_ns;
+        governor->probes++;
+        return HOOK_ACTION_PROBE;
+    }
+    return HOOK_ACTION_NONE;
+}
+
+/**
+ * @brief 후크를 다시 설치했음을 기록합니다.
+ */
+void hook_governor_reinstalled(hook_governor* governor, uint64_t now_ns) {
+    governor->probing = 0;
+    kp_atomic_store(&governor->heartbeat_ns, now_ns);
+}
+
+/**
+ * @brief 현재 축소 단계를 반환합니다.
+ */
+hook_degrade_level hook_governor_level(const hook_governor* governor) {
+    return (hook_degrade_level)kp_atomic_load_relaxed(&governor->level);
+}
+
+/**
+ * @brief 축소 단계 이름을 반환합니다.
+ */
+const char* hook_governor_level_name(hook_degrade_level level) {
+    switch (level) {
+    case HOOK_LEVEL_NORMAL:       return "normal";
+    case HOOK_LEVEL_QUIET_LOG:    return "quiet_log";
+    case HOOK_LEVEL_LIGHT_LOOKUP: return "light_lookup";
+    default:                      return "unknown";
+    }
+}
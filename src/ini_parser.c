@@ -0,0 +1,173 @@
+#include "ini_parser.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 공백 문자(스페이스, 탭)인지 확인합니다.
+ */
+static int is_blank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+/**
+ * @brief 슬라이스 앞뒤의 공백을 제거합니다.
+ */
+static ini_slice trim(const char* begin, const char* end) {
+    while (begin < end && is_blank(*begin)) {
+        begin++;
+    }
+    while (end > begin && (is_blank(end[-1]) || end[-1] == '\r')) {
+        end--;
+    }
+    ini_slice slice;
+    slice.ptr = begin;
+    slice.len = (size_t)(end - begin);
+    return slice;
+}
+
+/**
+ * @brief 잘못된 줄을 보고합니다.
+ */
+static void report(const ini_handler* handler, int line, const char* message, int* errors) {
+    (*errors)++;
+    if (handler->error != NULL) {
+        handler->error(handler->user, line, message);
+    }
+}
+
+/**
+ * @brief 버퍼를 한 번에 파싱합니다.
+ * @param data INI 파일 내용 (NUL 종료 필요 없음)
+ * @param size 내용 길이
+ * @param handler 콜백 묶음
+ * @return int 잘못된 줄의 수, 콜백이 파싱을 멈췄으면 -1
+ */
+int ini_parse(const char* data, size_t size, const ini_handler* handler) {
+    const char* cursor = data;
+    const char* limit = data + size;
+    int line = 0;
+    int errors = 0;
+    
+    ini_entry entry;
+    memset(&entry, 0, sizeof(entry));
+    
+    // UTF-8 BOM 건너뛰기
+    if (size >= 3 && (unsigned char)data[0] == 0xEF &&
+        (unsigned char)data[1] == 0xBB && (unsigned char)data[2] == 0xBF) {
+        cursor += 3;
+    }
+    
+    while (cursor < limit) {
+        const char* newline = (const char*)memchr(cursor, '\n', (size_t)(limit - cursor));
+        const char* end = (newline != NULL) ? newline : limit;
+        ini_slice text = trim(cursor, end);
+        line++;
+        cursor = (newline != NULL) ? newline + 1 : limit;
+        
+        if (text.len == 0 || text.ptr[0] == ';' || text.ptr[0] == '#') {
+            continue;
+        }
+        
+        if (text.ptr[0] == '[') {
+            const char* close = (const char*)memchr(text.ptr, ']', text.len);
+            if (close == NULL) {
+                report(handler, line, "섹션 헤더에 ']'가 없습니다", &errors);
+                continue;
+            }
+            entry.section = trim(text.ptr + 1, close);
+            continue;
+        }
+        
+        const char* equals = (const char*)memchr(text.ptr, '=', text.len);
+        if (equals == NULL) {
+            report(handler, line, "'키=값' 형식이 아닙니다", &errors);
+            continue;
+        }
+        
+        entry.key = trim(text.ptr, equals);
+        if (entry.key.len == 0) {
+            report(handler, line, "키 이름이 비어 있습니다", &errors);
+            continue;
+        }
+        
+        entry.value = trim(equals + 1, text.ptr + text.len);
+        // GetPrivateProfileString과 같이 값을 감싼 큰따옴표 제거
+        if (entry.value.len >= 2 && entry.value.ptr[0] == '"' &&
+            entry.value.ptr[entry.value.len - 1] == '"') {
+            entry.value.ptr++;
+            entry.value.len -= 2;
+        }
+        entry.line = line;
+        
+        if (!handler->entry(handler->user, &entry)) {
+            return -1;
+        }
+    }
+    
+    return errors;
+}
+
+/**
+ * @brief 슬라이스가 문자열과 대소문자 구분 없이 같은지 비교합니다.
+ */
+int ini_slice_equals(ini_slice slice, const char* text) {
+    size_t i = 0;
+    for (; i < slice.len; i++) {
+        char a = slice.ptr[i];
+        char b = text[i];
+        if (b == '\0') {
+            return 0;
+        }
+        if (a >= 'A' && a <= 'Z') {
+            a = (char)(a + ('a' - 'A'));
+        }
+        if (b >= 'A' && b <= 'Z') {
+            b = (char)(b + ('a' - 'A'));
+        }
+        if (a != b) {
+            return 0;
+        }
+    }
+    return text[i] == '\0';
+}
+
+/**
+ * @brief 슬라이스를 NUL 종료 문자열로 복사합니다.
+ */
+size_t ini_slice_copy(ini_slice slice, char* buffer, size_t buffer_size) {
+    if (buffer_size == 0) {
+        return 0;
+    }
+    size_t length = (slice.len < buffer_size - 1) ? slice.len : buffer_size - 1;
+    memcpy(buffer, slice.ptr, length);
+    buffer[length] = '\0';
+    return length;
+}
+
+/**
+ * @brief 파일 전체를 한 번에 읽어 새 버퍼로 반환합니다.
+ */
+char* ini_read_file(const char* path, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    
+    char* buffer = NULL;
+    long length = -1;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        length = ftell(file);
+    }
+    if (length >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+        buffer = (char*)malloc((size_t)length + 1);
+        if (buffer != NULL) {
+            *size = fread(buffer, 1, (size_t)length, file);
+            buffer[*size] = '\0';
+        }
+    }
+    
+    fclose(file);
+    return buffer;
+}
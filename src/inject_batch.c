@@ -0,0 +1,173 @@
+#include "inject_batch.h"
+#include "key_policy.h"
+
+#include <string.h>
+
+/**
+ * @brief 내보낸 이유 이름 (inject_flush_reason 순서)
+ */
+static const char* const g_flush_reason_names[INJECT_FLUSH_REASON_COUNT] = {
+    "size", "deadline", "foreground", "idle"
+};
+
+/**
+ * @brief 묶음 크기를 허용 범위로 맞춥니다.
+ */
+static size_t clamp_limit(size_t limit) {
+    if (limit == 0) {
+        return INJECT_BATCH_DEFAULT_LIMIT;
+    }
+    return (limit > INJECT_BATCH_CAPACITY) ? INJECT_BATCH_CAPACITY : limit;
+}
+
+/**
+ * @brief 키 하나를 문자로 바꿀 수 있으면 유니코드 키로 채웁니다.
+ * @details 단축키가 문자로 바뀌지 않도록 Ctrl/Alt/Win이 눌려 있으면 바꾸지 않으며,
+ *          키 업은 키 다운 때 쓴 문자가 있을 때만 문자로 내보냅니다.
+ */
+static void fill_unicode(inject_batch* batch, inject_key* key, int key_down) {
+    unsigned int vk_code = key->vk_code & 0xFFu;
+    if (!key_down) {
+        if (batch->unicode_down[vk_code] != 0) {
+            key->unicode = batch->unicode_down[vk_code];
+            key->flags |= INJECT_KEY_UNICODE;
+            batch->unicode_down[vk_code] = 0;
+        }
+        return;
+    }
+    if (!batch->unicode || batch->sink.translate == NULL || key_modifier_key(vk_code) != 0) {
+        return;
+    }
+    unsigned int state = key_modifier_state(batch->held_modifiers);
+    if (state & (KEY_MOD_CTRL | KEY_MOD_ALT | KEY_MOD_WIN)) {
+        return;
+    }
+    unsigned int unicode = batch->sink.translate(batch->sink.context, vk_code, (state & KEY_MOD_SHIFT) != 0,
+                                                 batch->caps_lock);
+    if (unicode == 0 || unicode > 0xFFFFu) {
+        return;
+    }
+    key->unicode = (uint16_t)unicode;
+    key->flags |= INJECT_KEY_UNICODE;
+    batch->unicode_down[vk_code] = (uint16_t)unicode;
+    batch->stats.unicode_keys++;
+}
+
+/**
+ * @brief 묶음 처리 상태를 초기화합니다.
+ */
+void inject_batch_init(inject_batch* batch, const inject_sink* sink, size_t limit, unsigned long long max_delay_ns) {
+    memset(batch, 0, sizeof(*batch));
+    batch->sink = *sink;
+    batch->limit = clamp_limit(limit);
+    batch->max_delay_ns = (max_delay_ns != 0) ? max_delay_ns : INJECT_BATCH_DEFAULT_DELAY_NS;
+}
+
+/**
+ * @brief 묶음 크기, 기한, 유니코드 경로를 바꿉니다.
+ */
+void inject_batch_configure(inject_batch* batch, size_t limit, unsigned long long max_delay_ns, int unicode) {
+    batch->limit = clamp_limit(limit);
+    batch->max_delay_ns = (max_delay_ns != 0) ? max_delay_ns : INJECT_BATCH_DEFAULT_DELAY_NS;
+    batch->unicode = unicode ? 1 : 0;
+    if (batch->count >= batch->limit) {
+        inject_batch_flush(batch, INJECT_FLUSH_SIZE);
+    }
+}
+
+/**
+ * @brief 시작할 때의 Caps Lock 켜짐 여부를 설정합니다.
+ */
+void inject_batch_set_caps_lock(inject_batch* batch, int on) {
+    batch->caps_lock = on ? 1 : 0;
+}
+
+/**
+ * @brief Caps Lock 키를 따라 켜짐/꺼짐을 바꿉니다. (처음 누를 때만, 자동 반복 제외)
+ */
+static void track_caps_lock(inject_batch* batch, unsigned int vk_code, int key_down) {
+    if ((vk_code & 0xFFu) != INJECT_VK_CAPITAL) {
+        return;
+    }
+    if (key_down && !batch->caps_down) {
+        batch->caps_lock = !batch->caps_lock;
+    }
+    batch->caps_down = key_down ? 1 : 0;
+}
+
+/**
+ * @brief 키 하나를 묶음에 넣습니다.
+ */
+int inject_batch_add(inject_batch* batch, unsigned int vk_code, int key_down, uint64_t target,
+                     unsigned long long now_ns) {
+    if (batch->count > 0 && target != batch->target) {
+        inject_batch_flush(batch, INJECT_FLUSH_FOREGROUND);
+    }
+    if (batch->count == 0) {
+        batch->target = target;
+        batch->deadline_ns = now_ns + batch->max_delay_ns;
+    }
+
+    inject_key* key = &batch->keys[batch->count++];
+    key->vk_code = (uint16_t)vk_code;
+    key->unicode = 0;
+    key->flags = key_down ? 0u : INJECT_KEY_UP;
+    fill_unicode(batch, key, key_down);
+    track_caps_lock(batch, vk_code, key_down);
+    unsigned int modifier = key_modifier_key(vk_code);
+    if (modifier != 0) {
+        batch->held_modifiers = key_down ? (batch->held_modifiers | modifier) : (batch->held_modifiers & ~modifier);
+    }
+    batch->stats.keys++;
+
+    if (batch->count >= batch->limit) {
+        inject_batch_flush(batch, INJECT_FLUSH_SIZE);
+    } else if (now_ns >= batch->deadline_ns) {
+        inject_batch_flush(batch, INJECT_FLUSH_DEADLINE);
+    }
+    return 1;
+}
+
+/**
+ * @brief 모은 키를 모두 내보냅니다.
+ * @details 출력 함수가 일부만 주입하면(다른 입력과 섞이지 않도록 SendInput이 막은 경우 등) 남은 키를 한 번 더
+ *          보내고, 그래도 주입하지 못한 키는 버리고 셉니다.
+ */
+size_t inject_batch_flush(inject_batch* batch, inject_flush_reason reason) {
+    if (batch->count == 0) {
+        return 0;
+    }
+    size_t sent = 0;
+    for (int attempt = 0; attempt < 2 && sent < batch->count; attempt++) {
+        batch->stats.sends++;
+        size_t result = batch->sink.send(batch->sink.context, batch->keys + sent, batch->count - sent);
+        if (result == 0) {
+            break;
+        }
+        sent += (result < batch->count - sent) ? result : batch->count - sent;
+    }
+    batch->stats.failed += (unsigned long)(batch->count - sent);
+    batch->stats.flushes[reason]++;
+    if (batch->count > batch->stats.max_batch) {
+        batch->stats.max_batch = (unsigned long)batch->count;
+    }
+    batch->count = 0;
+    batch->deadline_ns = 0;
+    return sent;
+}
+
+/**
+ * @brief 기한이 지났으면 모은 키를 내보냅니다.
+ */
+void inject_batch_poll(inject_batch* batch, unsigned long long now_ns) {
+    if (batch->count > 0 && now_ns >= batch->deadline_ns) {
+        inject_batch_flush(batch, INJECT_FLUSH_DEADLINE);
+    }
+}
+
+/**
+ * @brief 내보낸 이유의 이름을 반환합니다.
+ */
+const char* inject_flush_reason_name(inject_flush_reason reason) {
+    return ((int)reason >= 0 && reason < INJECT_FLUSH_REASON_COUNT) ? g_flush_reason_names[reason] : "?";
+}
@@ -0,0 +1,286 @@
+#include "input_correlator.h"
+#include "key_processor.h"
+
+#include <string.h>
+
+/**
+ * @brief 두 입력이 같은 키 동작인지 확인합니다. (시각 차이가 짝짓기 범위 안이어야 함)
+ */
+static int same_key(const input_key* a, const input_key* b) {
+    unsigned long long gap = (a->time_ns > b->time_ns) ? a->time_ns - b->time_ns : b->time_ns - a->time_ns;
+    return a->scan_key == b->scan_key && a->key_down == b->key_down && gap <= INPUT_CORRELATOR_WINDOW_NS;
+}
+
+/**
+ * @brief 장치 미상으로 내보낸 후크 이벤트를 늦은 짝 확인용으로 기억합니다.
+ */
+static void remember_unmatched(input_correlator* correlator, const input_key* key) {
+    correlator->recent[correlator->recent_next] = *key;
+    correlator->recent_next = (correlator->recent_next + 1) & (INPUT_CORRELATOR_RECENT - 1);
+}
+
+/**
+ * @brief 후크 이벤트 하나를 내보냅니다.
+ */
+static void release_one(input_correlator* correlator, const key_event* event, const input_key* key, int matched) {
+    if (!matched) {
+        correlator->stats.unmatched++;
+        remember_unmatched(correlator, key);
+    }
+    correlator->release(event, matched ? key->device : 0, correlator->user);
+}
+
+/**
+ * @brief 대기열 맨 앞의 이벤트를 꺼내 내보냅니다.
+ */
+static void release_head(input_correlator* correlator) {
+    input_pending* head = &correlator->pending[correlator->pending_head];
+    correlator->pending_head = (correlator->pending_head + 1) & (INPUT_CORRELATOR_PENDING - 1);
+    correlator->pending_count--;
+    release_one(correlator, &head->event, &head->key, head->matched);
+}
+
+/**
+ * @brief 짝을 찾았거나 기한이 지난 이벤트를 맨 앞부터 차례로 내보냅니다.
+ * @details 실제로 붙잡았던 이벤트가 짝 없이 만료되는 일이 계속되면 붙잡기를 끕니다.
+ */
+static void release_ready(input_correlator* correlator, unsigned long long now_ns) {
+    while (correlator->pending_count > 0) {
+        input_pending* head = &correlator->pending[correlator->pending_head];
+        if (!head->matched) {
+            if (head->deadline_ns > now_ns) {
+                break;
+            }
+            if (head->deadline_ns > head->key.time_ns) {
+                correlator->stats.expired++;
+                if (correlator->hold_ns != 0 && !correlator->hold_required &&
+                    ++correlator->learn_expired >= INPUT_CORRELATOR_LEARN) {
+                    correlator->hold_ns = 0;
+                    correlator->learn_expired = 0;
+                    correlator->learn_late = 0;
+                    correlator->stats.hold_changes++;
+                }
+            }
+        }
+        release_head(correlator);
+    }
+}
+
+/**
+ * @brief 후크 이벤트를 대기열 끝에 넣습니다. (가득 차면 맨 앞 이벤트를 먼저 내보냄)
+ */
+static void append_pending(input_correlator* correlator, const key_event* event, const input_key* key,
+                           int matched, unsigned long long deadline_ns) {
+    if (correlator->pending_count == INPUT_CORRELATOR_PENDING) {
+        correlator->stats.overflows++;
+        release_head(correlator);
+    }
+    unsigned int index = (correlator->pending_head + correlator->pending_count) & (INPUT_CORRELATOR_PENDING - 1);
+    input_pending* pending = &correlator->pending[index];
+    pending->event = *event;
+    pending->key = *key;
+    pending->matched = matched;
+    pending->deadline_ns = deadline_ns;
+    correlator->pending_count++;
+}
+
+/**
+ * @brief 늦은 짝의 지연을 기록합니다.
+ */
+static void record_late(input_correlator* correlator, const input_key* hook, unsigned long long now_ns) {
+    unsigned long long delay = (now_ns > hook->time_ns) ? now_ns - hook->time_ns : 0;
+    if (delay > correlator->stats.max_late_ns) {
+        correlator->stats.max_late_ns = delay;
+    }
+}
+
+/**
+ * @brief 짝짓기 상태를 초기화합니다.
+ */
+void input_correlator_init(input_correlator* correlator, input_release_fn release, void* user) {
+    memset(correlator, 0, sizeof(*correlator));
+    for (unsigned int i = 0; i < INPUT_CORRELATOR_RECENT; i++) {
+        correlator->recent[i].scan_key = INPUT_SCAN_KEY_NONE;
+    }
+    correlator->release = release;
+    correlator->user = user;
+}
+
+/**
+ * @brief 장치를 알기 전에 후크 이벤트를 넘기면 안 되는지 설정합니다.
+ */
+void input_correlator_require_hold(input_correlator* correlator, int required) {
+    required = required ? 1 : 0;
+    if (correlator->hold_required == required) {
+        return;
+    }
+    correlator->hold_required = required;
+    correlator->learn_late = 0;
+    correlator->learn_expired = 0;
+    unsigned long long hold = required ? INPUT_CORRELATOR_MAX_HOLD_NS : 0;
+    if (correlator->hold_ns != hold) {
+        correlator->hold_ns = hold;
+        correlator->stats.hold_changes++;
+    }
+}
+
+/**
+ * @brief 후크 이벤트 하나를 넣습니다.
+ */
+void input_correlator_hook(input_correlator* correlator, const key_event* event, unsigned int scan_key,
+                           unsigned long long now_ns) {
+    input_key key;
+    key.time_ns = now_ns;
+    key.device = 0;
+    key.scan_key = scan_key;
+    key.key_down = key_processor_is_key_down(event->message) ? 1u : 0u;
+    correlator->stats.hook_events++;
+
+    // 주입된 키: Raw Input이 오지 않으므로 짝을 찾지 않음 (장치 없이 짝지은 것으로 취급하여 학습에서 제외)
+    if (scan_key == INPUT_SCAN_KEY_NONE) {
+        correlator->stats.injected++;
+        if (correlator->pending_count == 0) {
+            correlator->release(event, 0, correlator->user);
+        } else {
+            append_pending(correlator, event, &key, 1, now_ns);
+            release_ready(correlator, now_ns);
+        }
+        return;
+    }
+
+    // 짝짓기 범위를 벗어난 Raw Input은 버림 (도착 순서이므로 맨 앞부터)
+    while (correlator->raw_count > 0) {
+        const input_key* oldest = &correlator->raw[correlator->raw_head];
+        if (oldest->time_ns + INPUT_CORRELATOR_WINDOW_NS >= now_ns) {
+            break;
+        }
+        correlator->raw_head = (correlator->raw_head + 1) & (INPUT_CORRELATOR_RAW - 1);
+        correlator->raw_count--;
+        correlator->stats.stale_raw++;
+    }
+
+    // Raw Input이 먼저 온 경우: 가장 오래된 짝을 꺼냄 (뒤의 항목을 한 칸씩 당김)
+    for (unsigned int i = 0; i < correlator->raw_count; i++) {
+        unsigned int index = (correlator->raw_head + i) & (INPUT_CORRELATOR_RAW - 1);
+        if (!same_key(&correlator->raw[index], &key)) {
+            continue;
+        }
+        key.device = correlator->raw[index].device;
+        for (unsigned int j = i + 1; j < correlator->raw_count; j++) {
+            unsigned int from = (correlator->raw_head + j) & (INPUT_CORRELATOR_RAW - 1);
+            correlator->raw[(from - 1) & (INPUT_CORRELATOR_RAW - 1)] = correlator->raw[from];
+        }
+        correlator->raw_count--;
+        correlator->stats.early_matches++;
+        if (correlator->pending_count == 0) {
+            release_one(correlator, event, &key, 1);
+        } else {
+            append_pending(correlator, event, &key, 1, now_ns);
+            release_ready(correlator, now_ns);
+        }
+        return;
+    }
+
+    // 짝이 없음: 붙잡지 않으면 바로 내보내고, 앞에 붙잡힌 이벤트가 있으면 순서를 지키기 위해 뒤에 줄 세움
+    if (correlator->hold_ns == 0 && correlator->pending_count == 0) {
+        release_one(correlator, event, &key, 0);
+        return;
+    }
+    append_pending(correlator, event, &key, 0, now_ns + correlator->hold_ns);
+    release_ready(correlator, now_ns);
+}
+
+/**
+ * @brief Raw Input 이벤트 하나를 넣습니다.
+ */
+void input_correlator_raw(input_correlator* correlator, uintptr_t device, unsigned int scan_key, int key_down,
+                          unsigned long long now_ns) {
+    if (device == 0) {
+        return;
+    }
+    input_key key;
+    key.time_ns = now_ns;
+    key.device = device;
+    key.scan_key = scan_key;
+    key.key_down = key_down ? 1u : 0u;
+    correlator->stats.raw_events++;
+
+    // 붙잡아 둔 후크 이벤트의 짝
+    for (unsigned int i = 0; i < correlator->pending_count; i++) {
+        input_pending* pending = &correlator->pending[(correlator->pending_head + i) & (INPUT_CORRELATOR_PENDING - 1)];
+        if (pending->matched || !same_key(&pending->key, &key)) {
+            continue;
+        }
+        pending->matched = 1;
+        pending->key.device = device;
+        correlator->stats.held_matches++;
+        record_late(correlator, &pending->key, now_ns);
+        if (correlator->learn_expired > 0) {
+            correlator->learn_expired--;
+        }
+        release_ready(correlator, now_ns);
+        return;
+    }
+
+    // 이미 장치 미상으로 내보낸 후크 이벤트의 짝: 후크가 먼저 오는 환경이므로 지연을 학습하여 붙잡기를 켬
+    for (unsigned int i = 0; i < INPUT_CORRELATOR_RECENT; i++) {
+        unsigned int index = (correlator->recent_next + i) & (INPUT_CORRELATOR_RECENT - 1);
+        input_key* recent = &correlator->recent[index];
+        if (recent->scan_key == INPUT_SCAN_KEY_NONE || recent->time_ns > now_ns || !same_key(recent, &key)) {
+            continue;
+        }
+        recent->scan_key = INPUT_SCAN_KEY_NONE;
+        correlator->stats.late_matches++;
+        record_late(correlator, recent, now_ns);
+        if (correlator->hold_ns == 0 && ++correlator->learn_late >= INPUT_CORRELATOR_LEARN) {
+            unsigned long long hold = correlator->stats.max_late_ns * 2;
+            if (hold < INPUT_CORRELATOR_MIN_HOLD_NS) {
+                hold = INPUT_CORRELATOR_MIN_HOLD_NS;
+            } else if (hold > INPUT_CORRELATOR_MAX_HOLD_NS) {
+                hold = INPUT_CORRELATOR_MAX_HOLD_NS;
+            }
+            correlator->hold_ns = hold;
+            correlator->learn_late = 0;
+            correlator->learn_expired = 0;
+            correlator->stats.hold_changes++;
+        }
+        return;
+    }
+
+    // 후크 이벤트가 아직 오지 않음: 짝을 기다림 (가득 차면 가장 오래된 것을 버림)
+    if (correlator->raw_count == INPUT_CORRELATOR_RAW) {
+        correlator->raw_head = (correlator->raw_head + 1) & (INPUT_CORRELATOR_RAW - 1);
+        correlator->raw_count--;
+        correlator->stats.stale_raw++;
+    }
+    correlator->raw[(correlator->raw_head + correlator->raw_count) & (INPUT_CORRELATOR_RAW - 1)] = key;
+    correlator->raw_count++;
+}
+
+/**
+ * @brief 기한이 지난 후크 이벤트를 장치 미상으로 내보냅니다.
+ */
+void input_correlator_expire(input_correlator* correlator, unsigned long long now_ns) {
+    release_ready(correlator, now_ns);
+}
+
+/**
+ * @brief 다음으로 만료될 후크 이벤트의 기한을 반환합니다.
+ * @details 맨 앞 이벤트가 뒤의 이벤트를 모두 막고 있으므로 맨 앞의 기한만 보면 됩니다.
+ */
+unsigned long long input_correlator_deadline(const input_correlator* correlator) {
+    if (correlator->pending_count == 0) {
+        return 0;
+    }
+    unsigned long long deadline = correlator->pending[correlator->pending_head].deadline_ns;
+    return (deadline != 0) ? deadline : 1;
+}
+
+/**
+ * @brief 붙잡은 이벤트를 모두 내보냅니다.
+ */
+void input_correlator_flush(input_correlator* correlator) {
+    while (correlator->pending_count > 0) {
+        release_head(correlator);
+    }
+}
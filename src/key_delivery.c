@@ -0,0 +1,306 @@
+#include "key_delivery.h"
+#include "keystream.h"
+#include "kp_atomic.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/** @brief 채널 이름 접두사 */
+#define KEY_DELIVERY_PREFIX "KeyboardProtectorDelivery"
+
+/** @brief 깨우기 이벤트 이름 접미사 */
+#define KEY_DELIVERY_WAKE_SUFFIX ".wake"
+
+/**
+ * @brief 순번의 채널 키스트림 워드를 반환합니다.
+ * @details 블록 하나(16워드)를 캐시하므로 연속된 순번은 16개마다 한 번만 블록을 생성합니다.
+ */
+static uint32_t cipher_word(key_delivery_cipher* cipher, uint32_t sequence) {
+    uint32_t block = sequence / KEYSTREAM_BLOCK_WORDS;
+    if (!cipher->block_valid || cipher->block_index != block) {
+        keystream_generate(KEYSTREAM_KERNEL_SCALAR, cipher->key, KEY_DELIVERY_STREAM, cipher->nonce,
+                           block, cipher->block, 1);
+        cipher->block_index = block;
+        cipher->block_valid = 1;
+    }
+    return cipher->block[sequence % KEYSTREAM_BLOCK_WORDS];
+}
+
+/**
+ * @brief 채널 키와 캐시된 키스트림을 메모리에서 지웁니다.
+ */
+static void cipher_wipe(key_delivery_cipher* cipher) {
+    volatile unsigned char* p = (volatile unsigned char*)cipher;
+    for (size_t i = 0; i < sizeof(*cipher); i++) {
+        p[i] = 0;
+    }
+}
+
+/**
+ * @brief 공유 메모리 이름으로 깨우기 이벤트 이름을 만듭니다.
+ */
+static int wake_name(char* name, size_t size, const char* memory_name) {
+    int length = snprintf(name, size, "%s" KEY_DELIVERY_WAKE_SUFFIX, memory_name);
+    return length > 0 && (size_t)length < size;
+}
+
+/**
+ * @brief 채널 이름을 만듭니다.
+ */
+void key_delivery_channel_name(char* name, size_t size, unsigned long consumer_pid) {
+    snprintf(name, size, KEY_DELIVERY_PREFIX ".%lu", consumer_pid);
+}
+
+/**
+ * @brief 새 채널 키로 링과 깨우기 이벤트를 만듭니다.
+ * @details 다른 필드를 모두 채운 뒤 magic을 마지막에 기록하므로, 소비자는 magic이 보이면 나머지 헤더를 믿을 수 있습니다.
+ */
+int key_delivery_channel_open(key_delivery_channel* channel, unsigned long consumer_pid, key_delivery_grant* grant) {
+    memset(channel, 0, sizeof(*channel));
+    memset(grant, 0, sizeof(*grant));
+
+    char event_name[KEY_DELIVERY_NAME_SIZE + sizeof(KEY_DELIVERY_WAKE_SUFFIX)];
+    key_delivery_channel_name(grant->name, sizeof(grant->name), consumer_pid);
+    if (!wake_name(event_name, sizeof(event_name), grant->name) ||
+        !kp_random_bytes(channel->cipher.key, sizeof(channel->cipher.key)) ||
+        !kp_random_bytes(&channel->cipher.nonce, sizeof(channel->cipher.nonce))) {
+        cipher_wipe(&channel->cipher);
+        return 0;
+    }
+
+    if (!kp_shared_memory_create(&channel->memory, grant->name, sizeof(key_delivery_ring))) {
+        cipher_wipe(&channel->cipher);
+        return 0;
+    }
+    if (!kp_named_event_create(&channel->event, event_name)) {
+        kp_shared_memory_close(&channel->memory);
+        cipher_wipe(&channel->cipher);
+        return 0;
+    }
+
+    key_delivery_ring* ring = (key_delivery_ring*)channel->memory.address;
+    ring->version = KEY_DELIVERY_VERSION;
+    ring->capacity = KEY_DELIVERY_CAPACITY;
+    ring->record_size = sizeof(key_delivery_record);
+    ring->producer_pid = (uint32_t)kp_process_id();
+    ring->consumer_pid = (uint32_t)consumer_pid;
+    ring->nonce = channel->cipher.nonce;
+    kp_atomic_store(&ring->magic, (uint32_t)KEY_DELIVERY_MAGIC);
+    channel->ring = ring;
+
+    memcpy(grant->key, channel->cipher.key, sizeof(grant->key));
+    grant->nonce = channel->cipher.nonce;
+    grant->capacity = KEY_DELIVERY_CAPACITY;
+    return 1;
+}
+
+/**
+ * @brief 키 입력 하나를 암호화하여 링에 넣습니다.
+ * @details 레코드를 쓴 뒤 head를 해제 의미로 올리고, 울타리 뒤에 waiting을 1에서 0으로 내린 경우에만 이벤트를 신호합니다.
+ *          소비자는 waiting을 세운 뒤 울타리 너머로 head를 다시 확인하므로 둘 중 하나는 반드시 상대의 쓰기를 봅니다.
+ */
+int key_delivery_push(key_delivery_channel* channel, uint32_t vk_code, uint32_t message, uint32_t time_ms) {
+    key_delivery_ring* ring = channel->ring;
+    if (ring == NULL || kp_atomic_load_relaxed(&ring->closed)) {
+        return 0;
+    }
+
+    uint32_t head = ring->head;
+    if (head + 1 == 0) {
+        // 순번이 한 바퀴 돌면 같은 키스트림 워드를 다시 쓰게 되므로 채널을 닫음
+        kp_atomic_store(&ring->closed, 1u);
+        kp_named_event_signal(&channel->event);
+        return 0;
+    }
+    if (head - kp_atomic_load(&ring->tail) >= KEY_DELIVERY_CAPACITY) {
+        kp_atomic_store_relaxed(&ring->dropped, ring->dropped + 1);
+        return 0;
+    }
+
+    key_delivery_record* record = &ring->records[head % KEY_DELIVERY_CAPACITY];
+    record->encrypted = vk_code ^ cipher_word(&channel->cipher, head);
+    record->message = message;
+    record->time_ms = time_ms;
+    record->reserved = 0;
+    kp_atomic_store(&ring->head, head + 1);
+    channel->delivered++;
+
+    kp_atomic_fence();
+    uint32_t expected = 1;
+    if (kp_atomic_load_relaxed(&ring->waiting) &&
+        kp_atomic_compare_exchange(&ring->waiting, &expected, 0u)) {
+        kp_atomic_store_relaxed(&ring->wakeups, ring->wakeups + 1);
+        kp_named_event_signal(&channel->event);
+    }
+    return 1;
+}
+
+/**
+ * @brief 채널을 닫습니다.
+ */
+void key_delivery_channel_close(key_delivery_channel* channel) {
+    if (channel->ring != NULL) {
+        kp_atomic_store(&channel->ring->closed, 1u);
+        kp_named_event_signal(&channel->event);
+        channel->ring = NULL;
+    }
+    kp_named_event_close(&channel->event);
+    kp_shared_memory_close(&channel->memory);
+    cipher_wipe(&channel->cipher);
+}
+
+/**
+ * @brief 승인 정보로 링에 연결합니다.
+ */
+int key_delivery_client_attach(key_delivery_client* client, const key_delivery_grant* grant) {
+    memset(client, 0, sizeof(*client));
+
+    char memory_name[KEY_DELIVERY_NAME_SIZE];
+    char event_name[KEY_DELIVERY_NAME_SIZE + sizeof(KEY_DELIVERY_WAKE_SUFFIX)];
+    memcpy(memory_name, grant->name, sizeof(memory_name));
+    memory_name[sizeof(memory_name) - 1] = '\0';
+    if (grant->capacity != KEY_DELIVERY_CAPACITY || !wake_name(event_name, sizeof(event_name), memory_name)) {
+        return 0;
+    }
+
+    if (!kp_shared_memory_attach(&client->memory, memory_name, sizeof(key_delivery_ring))) {
+        return 0;
+    }
+    key_delivery_ring* ring = (key_delivery_ring*)client->memory.address;
+    if (kp_atomic_load(&ring->magic) != KEY_DELIVERY_MAGIC || ring->version != KEY_DELIVERY_VERSION ||
+        ring->capacity != KEY_DELIVERY_CAPACITY || ring->record_size != sizeof(key_delivery_record) ||
+        ring->nonce != grant->nonce) {
+        kp_shared_memory_close(&client->memory);
+        return 0;
+    }
+    if (!kp_named_event_open(&client->event, event_name)) {
+        kp_shared_memory_close(&client->memory);
+        return 0;
+    }
+
+    memcpy(client->cipher.key, grant->key, sizeof(client->cipher.key));
+    client->cipher.nonce = grant->nonce;
+    client->ring = ring;
+    return 1;
+}
+
+/**
+ * @brief 제어 채널로 구독을 요청하고 링에 연결합니다.
+ * @details 처리 코어는 요청한 프로세스가 허용 목록에 있는지 확인한 뒤에만 채널 키를 응답합니다.
+ */
+int key_delivery_client_connect(key_delivery_client* client, const char* control_name, unsigned int timeout_ms) {
+    memset(client, 0, sizeof(*client));
+    if (control_name == NULL) {
+        control_name = CONTROL_CHANNEL_NAME;
+    }
+    if (strlen(control_name) >= sizeof(client->control_name)) {
+        return 0;
+    }
+
+    uint32_t pid = (uint32_t)kp_process_id();
+    control_message reply;
+    if (!control_client_call(control_name, CONTROL_SUBSCRIBE, &pid, sizeof(pid), &reply, timeout_ms) ||
+        control_message_status(&reply) != CONTROL_OK ||
+        reply.header.length < sizeof(uint32_t) + sizeof(key_delivery_grant)) {
+        return 0;
+    }
+
+    key_delivery_grant grant;
+    memcpy(&grant, reply.payload + sizeof(uint32_t), sizeof(grant));
+    volatile unsigned char* p = (volatile unsigned char*)reply.payload;
+    int attached = key_delivery_client_attach(client, &grant);
+    // 응답 사본에 남은 채널 키를 지움
+    for (size_t i = 0; i < sizeof(reply.payload); i++) {
+        p[i] = 0;
+    }
+    p = (volatile unsigned char*)&grant;
+    for (size_t i = 0; i < sizeof(grant); i++) {
+        p[i] = 0;
+    }
+    if (!attached) {
+        control_client_call(control_name, CONTROL_UNSUBSCRIBE, &pid, sizeof(pid), &reply, timeout_ms);
+        return 0;
+    }
+    strcpy(client->control_name, control_name);
+    return 1;
+}
+
+/**
+ * @brief 쌓인 레코드를 tail부터 복호화하고 tail을 한 번만 옮깁니다.
+ */
+static size_t drain(key_delivery_client* client, key_delivery_key* keys, size_t max_keys) {
+    key_delivery_ring* ring = client->ring;
+    uint32_t tail = ring->tail;
+    uint32_t available = kp_atomic_load(&ring->head) - tail;
+    if (available > KEY_DELIVERY_CAPACITY) {
+        // 생산자 쪽 값이 손상됨: 읽지 않고 닫힌 채널로 취급
+        return 0;
+    }
+    size_t count = (available < max_keys) ? available : max_keys;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t sequence = tail + (uint32_t)i;
+        const key_delivery_record* record = &ring->records[sequence % KEY_DELIVERY_CAPACITY];
+        keys[i].vk_code = record->encrypted ^ cipher_word(&client->cipher, sequence);
+        keys[i].message = record->message;
+        keys[i].time_ms = record->time_ms;
+    }
+    if (count > 0) {
+        kp_atomic_store(&ring->tail, tail + (uint32_t)count);
+        client->reads++;
+    }
+    return count;
+}
+
+/**
+ * @brief 쌓인 키 입력을 한꺼번에 읽습니다.
+ * @details 링이 비어 있을 때만 waiting을 세우고, 울타리 뒤에 head를 다시 확인한 다음 잠듭니다.
+ *          생산자는 waiting을 내린 경우에만 신호하므로 잠든 동안 몇 개가 들어와도 깨우기는 한 번입니다.
+ */
+size_t key_delivery_client_read(key_delivery_client* client, key_delivery_key* keys, size_t max_keys,
+                                unsigned int timeout_ms) {
+    if (client->ring == NULL || max_keys == 0) {
+        return 0;
+    }
+    size_t count = drain(client, keys, max_keys);
+    if (count > 0 || timeout_ms == 0 || key_delivery_client_closed(client)) {
+        return count;
+    }
+
+    key_delivery_ring* ring = client->ring;
+    kp_atomic_store(&ring->waiting, 1u);
+    kp_atomic_fence();
+    if (kp_atomic_load(&ring->head) == ring->tail && !kp_atomic_load(&ring->closed)) {
+        client->waits++;
+        kp_named_event_wait(&client->event, timeout_ms);
+    }
+    // 생산자가 이미 내렸다면 남은 신호는 다음 대기에서 한 번 헛깨어날 뿐임
+    kp_atomic_store(&ring->waiting, 0u);
+    return drain(client, keys, max_keys);
+}
+
+/**
+ * @brief 생산자가 채널을 닫았는지 확인합니다.
+ */
+int key_delivery_client_closed(const key_delivery_client* client) {
+    return client->ring == NULL || kp_atomic_load(&client->ring->closed) != 0;
+}
+
+/**
+ * @brief 링 연결을 끊고, 제어 채널로 구독했다면 구독 해제를 요청합니다.
+ */
+void key_delivery_client_close(key_delivery_client* client) {
+    if (client->ring != NULL) {
+        kp_atomic_store_relaxed(&client->ring->waiting, 0u);
+        client->ring = NULL;
+    }
+    kp_named_event_close(&client->event);
+    kp_shared_memory_close(&client->memory);
+    cipher_wipe(&client->cipher);
+
+    if (client->control_name[0] != '\0') {
+        uint32_t pid = (uint32_t)kp_process_id();
+        control_message reply;
+        control_client_call(client->control_name, CONTROL_UNSUBSCRIBE, &pid, sizeof(pid), &reply, 1000);
+        client->control_name[0] = '\0';
+    }
+}
@@ -0,0 +1,685 @@
+#include "key_journal.h"
+#include "keystream.h"
+#include "crypto_keycode.h"
+#include "kp_atomic.h"
+
+#include <ctype.h>
+#include <string.h>
+#include <time.h>
+
+/** @brief 세그먼트 파일을 식별하는 매직 값 */
+static const unsigned char k_journal_magic[8] = { 'K', 'P', 'J', 'R', 'N', 'L', 0, 0 };
+
+/** @brief 블록 헤더 매직 값 ("KPJB") */
+#define KEY_JOURNAL_BLOCK_MAGIC 0x424A504BUL
+
+/** @brief 저널 스레드가 새 레코드를 확인하는 주기 (밀리초) */
+#define KEY_JOURNAL_POLL_MS 100
+
+/** @brief 링이 이만큼 차면 생산자가 잠든 저널 스레드를 깨움 */
+#define KEY_JOURNAL_WAKE_DEPTH (KEY_JOURNAL_RING_CAPACITY / 2)
+
+static void put_u16(unsigned char* p, unsigned int v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+}
+
+static void put_u32(unsigned char* p, unsigned long v) {
+    put_u16(p, (unsigned int)(v & 0xFFFF));
+    put_u16(p + 2, (unsigned int)((v >> 16) & 0xFFFF));
+}
+
+static void put_u64(unsigned char* p, unsigned long long v) {
+    put_u32(p, (unsigned long)(v & 0xFFFFFFFFUL));
+    put_u32(p + 4, (unsigned long)(v >> 32));
+}
+
+static unsigned int get_u16(const unsigned char* p) {
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8);
+}
+
+static unsigned long get_u32(const unsigned char* p) {
+    return (unsigned long)get_u16(p) | ((unsigned long)get_u16(p + 2) << 16);
+}
+
+static unsigned long long get_u64(const unsigned char* p) {
+    return (unsigned long long)get_u32(p) | ((unsigned long long)get_u32(p + 4) << 32);
+}
+
+/**
+ * @brief CRC32 (IEEE 802.3, 반사 다항식 0xEDB88320) 바이트 조회 테이블
+ */
+static const unsigned long k_crc32_table[256] = {
+    0x00000000UL, 0x77073096UL, 0xEE0E612CUL, 0x990951BAUL,
+    0x076DC419UL, 0x706AF48FUL, 0xE963A535UL, 0x9E6495A3UL,
+    0x0EDB8832UL, 0x79DCB8A4UL, 0xE0D5E91EUL, 0x97D2D988UL,
+    0x09B64C2BUL, 0x7EB17CBDUL, 0xE7B82D07UL, 0x90BF1D91UL,
+    0x1DB71064UL, 0x6AB020F2UL, 0xF3B97148UL, 0x84BE41DEUL,
+    0x1ADAD47DUL, 0x6DDDE4EBUL, 0xF4D4B551UL, 0x83D385C7UL,
+    0x136C9856UL, 0x646BA8C0UL, 0xFD62F97AUL, 0x8A65C9ECUL,
+    0x14015C4FUL, 0x63066CD9UL, 0xFA0F3D63UL, 0x8D080DF5UL,
+    0x3B6E20C8UL, 0x4C69105EUL, 0xD56041E4UL, 0xA2677172UL,
+    0x3C03E4D1UL, 0x4B04D447UL, 0xD20D85FDUL, 0xA50AB56BUL,
+    0x35B5A8FAUL, 0x42B2986CUL, 0xDBBBC9D6UL, 0xACBCF940UL,
+    0x32D86CE3UL, 0x45DF5C75UL, 0xDCD60DCFUL, 0xABD13D59UL,
+    0x26D930ACUL, 0x51DE003AUL, 0xC8D75180UL, 0xBFD06116UL,
+    0x21B4F4B5UL, 0x56B3C423UL, 0xCFBA9599UL, 0xB8BDA50FUL,
+    0x2802B89EUL, 0x5F058808UL, 0xC60CD9B2UL, 0xB10BE924UL,
+    0x2F6F7C87UL, 0x58684C11UL, 0xC1611DABUL, 0xB6662D3DUL,
+    0x76DC4190UL, 0x01DB7106UL, 0x98D220BCUL, 0xEFD5102AUL,
+    0x71B18589UL, 0x06B6B51FUL, 0x9FBFE4A5UL, 0xE8B8D433UL,
+    0x7807C9A2UL, 0x0F00F934UL, 0x9609A88EUL, 0xE10E9818UL,
+    0x7F6A0DBBUL, 0x086D3D2DUL, 0x91646C97UL, 0xE6635C01UL,
+    0x6B6B51F4UL, 0x1C6C6162UL, 0x856530D8UL, 0xF262004EUL,
+    0x6C0695EDUL, 0x1B01A57BUL, 0x8208F4C1UL, 0xF50FC457UL,
+    0x65B0D9C6UL, 0x12B7E950UL, 0x8BBEB8EAUL, 0xFCB9887CUL,
+    0x62DD1DDFUL, 0x15DA2D49UL, 0x8CD37CF3UL, 0xFBD44C65UL,
+    0x4DB26158UL, 0x3AB551CEUL, 0xA3BC0074UL, 0xD4BB30E2UL,
+    0x4ADFA541UL, 0x3DD895D7UL, 0xA4D1C46DUL, 0xD3D6F4FBUL,
+    0x4369E96AUL, 0x346ED9FCUL, 0xAD678846UL, 0xDA60B8D0UL,
+    0x44042D73UL, 0x33031DE5UL, 0xAA0A4C5FUL, 0xDD0D7CC9UL,
+    0x5005713CUL, 0x270241AAUL, 0xBE0B1010UL, 0xC90C2086UL,
+    0x5768B525UL, 0x206F85B3UL, 0xB966D409UL, 0xCE61E49FUL,
+    0x5EDEF90EUL, 0x29D9C998UL, 0xB0D09822UL, 0xC7D7A8B4UL,
+    0x59B33D17UL, 0x2EB40D81UL, 0xB7BD5C3BUL, 0xC0BA6CADUL,
+    0xEDB88320UL, 0x9ABFB3B6UL, 0x03B6E20CUL, 0x74B1D29AUL,
+    0xEAD54739UL, 0x9DD277AFUL, 0x04DB2615UL, 0x73DC1683UL,
+    0xE3630B12UL, 0x94643B84UL, 0x0D6D6A3EUL, 0x7A6A5AA8UL,
+    0xE40ECF0BUL, 0x9309FF9DUL, 0x0A00AE27UL, 0x7D079EB1UL,
+    0xF00F9344UL, 0x8708A3D2UL, 0x1E01F268UL, 0x6906C2FEUL,
+    0xF762575DUL, 0x806567CBUL, 0x196C3671UL, 0x6E6B06E7UL,
+    0xFED41B76UL, 0x89D32BE0UL, 0x10DA7A5AUL, 0x67DD4ACCUL,
+    0xF9B9DF6FUL, 0x8EBEEFF9UL, 0x17B7BE43UL, 0x60B08ED5UL,
+    0xD6D6A3E8UL, 0xA1D1937EUL, 0x38D8C2C4UL, 0x4FDFF252UL,
+    0xD1BB67F1UL, 0xA6BC5767UL, 0x3FB506DDUL, 0x48B2364BUL,
+    0xD80D2BDAUL, 0xAF0A1B4CUL, 0x36034AF6UL, 0x41047A60UL,
+    0xDF60EFC3UL, 0xA867DF55UL, 0x316E8EEFUL, 0x4669BE79UL,
+    0xCB61B38CUL, 0xBC66831AUL, 0x256FD2A0UL, 0x5268E236UL,
+    0xCC0C7795UL, 0xBB0B4703UL, 0x220216B9UL, 0x5505262FUL,
+    0xC5BA3BBEUL, 0xB2BD0B28UL, 0x2BB45A92UL, 0x5CB36A04UL,
+    0xC2D7FFA7UL, 0xB5D0CF31UL, 0x2CD99E8BUL, 0x5BDEAE1DUL,
+    0x9B64C2B0UL, 0xEC63F226UL, 0x756AA39CUL, 0x026D930AUL,
+    0x9C0906A9UL, 0xEB0E363FUL, 0x72076785UL, 0x05005713UL,
+    0x95BF4A82UL, 0xE2B87A14UL, 0x7BB12BAEUL, 0x0CB61B38UL,
+    0x92D28E9BUL, 0xE5D5BE0DUL, 0x7CDCEFB7UL, 0x0BDBDF21UL,
+    0x86D3D2D4UL, 0xF1D4E242UL, 0x68DDB3F8UL, 0x1FDA836EUL,
+    0x81BE16CDUL, 0xF6B9265BUL, 0x6FB077E1UL, 0x18B74777UL,
+    0x88085AE6UL, 0xFF0F6A70UL, 0x66063BCAUL, 0x11010B5CUL,
+    0x8F659EFFUL, 0xF862AE69UL, 0x616BFFD3UL, 0x166CCF45UL,
+    0xA00AE278UL, 0xD70DD2EEUL, 0x4E048354UL, 0x3903B3C2UL,
+    0xA7672661UL, 0xD06016F7UL, 0x4969474DUL, 0x3E6E77DBUL,
+    0xAED16A4AUL, 0xD9D65ADCUL, 0x40DF0B66UL, 0x37D83BF0UL,
+    0xA9BCAE53UL, 0xDEBB9EC5UL, 0x47B2CF7FUL, 0x30B5FFE9UL,
+    0xBDBDF21CUL, 0xCABAC28AUL, 0x53B39330UL, 0x24B4A3A6UL,
+    0xBAD03605UL, 0xCDD70693UL, 0x54DE5729UL, 0x23D967BFUL,
+    0xB3667A2EUL, 0xC4614AB8UL, 0x5D681B02UL, 0x2A6F2B94UL,
+    0xB40BBE37UL, 0xC30C8EA1UL, 0x5A05DF1BUL, 0x2D02EF8DUL
+};
+
+/**
+ * @brief CRC32 값을 이어서 계산합니다.
+ * @param crc 이전 결과 (처음에는 0)
+ */
+static unsigned long crc32_update(unsigned long crc, const unsigned char* data, size_t size) {
+    crc = ~crc & 0xFFFFFFFFUL;
+    for (size_t i = 0; i < size; i++) {
+        crc = (crc >> 8) ^ k_crc32_table[(crc ^ data[i]) & 0xFF];
+    }
+    return ~crc & 0xFFFFFFFFUL;
+}
+
+/**
+ * @brief CRC 자리를 0으로 둔 블록 헤더와 페이로드의 CRC32를 계산합니다.
+ */
+static unsigned long block_crc(const unsigned char* header, const unsigned char* payload, size_t payload_size) {
+    unsigned char copy[KEY_JOURNAL_BLOCK_HEADER_SIZE];
+    memcpy(copy, header, sizeof(copy));
+    put_u32(copy + 12, 0);
+    unsigned long crc = crc32_update(0, copy, sizeof(copy));
+    return crc32_update(crc, payload, payload_size);
+}
+
+/**
+ * @brief 블록 헤더를 채웁니다. (CRC 포함)
+ */
+static void fill_block_header(unsigned char* header, unsigned int type, unsigned int count,
+                              const unsigned char* payload, size_t payload_size,
+                              unsigned long long first_ns, unsigned long long last_ns) {
+    put_u32(header, KEY_JOURNAL_BLOCK_MAGIC);
+    put_u16(header + 4, type);
+    put_u16(header + 6, count);
+    put_u32(header + 8, (unsigned long)payload_size);
+    put_u32(header + 12, 0);
+    put_u64(header + 16, first_ns);
+    put_u64(header + 24, last_ns);
+    put_u32(header + 12, block_crc(header, payload, payload_size));
+}
+
+/**
+ * @brief 현재 세그먼트를 닫습니다.
+ */
+static void close_segment(key_journal_writer* writer) {
+    if (writer->segment != NULL) {
+        fclose(writer->segment);
+        writer->segment = NULL;
+    }
+}
+
+/**
+ * @brief 새 세그먼트 파일을 만들고 헤더를 씁니다.
+ * @details 파일 이름은 생성 UTC 시각과 PID, 순번으로 정하므로 이름 순서가 시간 순서와 같습니다.
+ * @return int 성공 시 1, 실패 시 0
+ */
+static int open_segment(key_journal_writer* writer) {
+    // 세그먼트마다 시각 변환 기준을 다시 잡아 장시간 실행 중의 시계 보정을 반영
+    writer->wall_base_ns = kp_wall_time_ns();
+    writer->mono_base_ns = kp_now_ns();
+
+    time_t seconds = (time_t)(writer->wall_base_ns / 1000000000ULL);
+    struct tm* utc = gmtime(&seconds);
+    if (utc == NULL) {
+        return 0;
+    }
+    char path[KEY_JOURNAL_PATH_SIZE + 64];
+    snprintf(path, sizeof(path), "%s/kpj-%04d%02d%02dT%02d%02d%02dZ-%lu-%04u.kpj", writer->directory,
+             utc->tm_year + 1900, utc->tm_mon + 1, utc->tm_mday, utc->tm_hour, utc->tm_min, utc->tm_sec,
+             kp_process_id(), writer->segment_sequence);
+
+    writer->segment = fopen(path, "wb");
+    if (writer->segment == NULL) {
+        return 0;
+    }
+
+    unsigned char header[KEY_JOURNAL_SEGMENT_HEADER_SIZE] = {0};
+    memcpy(header, k_journal_magic, sizeof(k_journal_magic));
+    put_u16(header + 8, KEY_JOURNAL_VERSION);
+    put_u16(header + 10, KEY_JOURNAL_RECORD_SIZE);
+    put_u16(header + 12, KEY_JOURNAL_BLOCK_HEADER_SIZE);
+    put_u16(header + 14, writer->key_info.wrapped ? KEY_JOURNAL_FLAG_WRAPPED_KEY : 0);
+    put_u32(header + 16, kp_process_id());
+    put_u32(header + 20, writer->segment_sequence);
+    put_u64(header + 24, writer->wall_base_ns);
+    put_u32(header + 32, writer->key_info.nonce);
+    if (writer->key_info.wrapped) {
+        put_u32(header + 36, writer->key_info.key_check);
+        for (int i = 0; i < 8; i++) {
+            put_u32(header + 40 + i * 4, writer->key_info.wrapped_key[i]);
+        }
+    }
+    if (fwrite(header, 1, sizeof(header), writer->segment) != sizeof(header)) {
+        close_segment(writer);
+        return 0;
+    }
+
+    writer->segment_sequence++;
+    writer->segment_bytes = sizeof(header);
+    memset(writer->name_written, 0, sizeof(writer->name_written));
+    kp_atomic_add_relaxed(&writer->stats.segments, 1UL);
+    return 1;
+}
+
+/**
+ * @brief 현재 세그먼트에 아직 정의하지 않은 이름이면 이름 블록을 씁니다.
+ * @return int 성공 시 1, 쓰기 실패 시 0
+ */
+static int write_name(key_journal_writer* writer, unsigned int name_id) {
+    if (name_id >= KEY_JOURNAL_MAX_NAMES || writer->name_written[name_id] ||
+        name_id >= kp_atomic_load(&writer->name_count)) {
+        return 1;
+    }
+    const char* name = writer->names[name_id];
+    size_t length = strlen(name);
+    unsigned char header[KEY_JOURNAL_BLOCK_HEADER_SIZE];
+    fill_block_header(header, KEY_JOURNAL_BLOCK_NAME_TYPE, name_id, (const unsigned char*)name, length, 0, 0);
+    if (fwrite(header, 1, sizeof(header), writer->segment) != sizeof(header) ||
+        fwrite(name, 1, length, writer->segment) != length) {
+        return 0;
+    }
+    writer->segment_bytes += (unsigned long)(sizeof(header) + length);
+    writer->name_written[name_id] = 1;
+    return 1;
+}
+
+/**
+ * @brief 채운 블록을 세그먼트에 덧붙입니다.
+ * @details 세그먼트가 최대 크기를 넘게 되면 새 세그먼트로 넘어가고, 블록이 참조하는 이름을 먼저 정의합니다.
+ *          블록마다 fflush하므로 조회 도구는 기록 중인 세그먼트도 완성된 블록까지 읽을 수 있습니다.
+ */
+static void flush_block(key_journal_writer* writer) {
+    if (writer->block_records == 0) {
+        return;
+    }
+    unsigned char* header = writer->block;
+    unsigned char* payload = writer->block + KEY_JOURNAL_BLOCK_HEADER_SIZE;
+    size_t payload_size = (size_t)writer->block_records * KEY_JOURNAL_RECORD_SIZE;
+    size_t block_size = KEY_JOURNAL_BLOCK_HEADER_SIZE + payload_size;
+
+    if (writer->segment != NULL && writer->segment_bytes + block_size > writer->segment_limit) {
+        close_segment(writer);
+    }
+    int ok = (writer->segment != NULL) || open_segment(writer);
+    unsigned long long first_ns = ~0ULL;
+    unsigned long long last_ns = 0;
+    for (unsigned int i = 0; ok && i < writer->block_records; i++) {
+        const unsigned char* record = payload + i * KEY_JOURNAL_RECORD_SIZE;
+        unsigned long long timestamp = get_u64(record);
+        first_ns = (timestamp < first_ns) ? timestamp : first_ns;
+        last_ns = (timestamp > last_ns) ? timestamp : last_ns;
+        ok = write_name(writer, get_u16(record + 16));
+    }
+    if (ok) {
+        fill_block_header(header, KEY_JOURNAL_BLOCK_RECORDS_TYPE, writer->block_records,
+                          payload, payload_size, first_ns, last_ns);
+        ok = fwrite(writer->block, 1, block_size, writer->segment) == block_size &&
+             fflush(writer->segment) == 0;
+    }
+
+    if (ok) {
+        writer->segment_bytes += (unsigned long)block_size;
+        kp_atomic_add_relaxed(&writer->stats.records, (unsigned long)writer->block_records);
+        kp_atomic_add_relaxed(&writer->stats.blocks, 1UL);
+    } else {
+        // 다음 블록은 새 세그먼트에 기록 (디스크가 가득 찬 경우 등)
+        kp_atomic_add_relaxed(&writer->stats.write_errors, 1UL);
+        close_segment(writer);
+    }
+    writer->block_records = 0;
+}
+
+/**
+ * @brief 링에서 꺼낸 레코드를 블록에 추가합니다.
+ */
+static void add_record(key_journal_writer* writer, const key_journal_entry* entry) {
+    if (writer->block_records == 0) {
+        writer->block_started_ns = kp_now_ns();
+    }
+    unsigned long long wall_ns = writer->wall_base_ns +
+        ((entry->timestamp_ns > writer->mono_base_ns) ? entry->timestamp_ns - writer->mono_base_ns : 0);
+
+    unsigned char* record = writer->block + KEY_JOURNAL_BLOCK_HEADER_SIZE +
+                            writer->block_records * KEY_JOURNAL_RECORD_SIZE;
+    put_u64(record, wall_ns);
+    put_u32(record + 8, entry->encrypted_keycode);
+    put_u32(record + 12, entry->salt);
+    put_u16(record + 16, entry->name_id);
+    record[18] = entry->verdict;
+    record[19] = 0;
+    put_u32(record + 20, writer->sequence++ & 0xFFFFFFFFUL);
+
+    if (++writer->block_records == KEY_JOURNAL_BLOCK_RECORDS) {
+        flush_block(writer);
+    }
+}
+
+/**
+ * @brief 저널 스레드 함수
+ * @details 링의 레코드를 블록으로 모으고, 블록이 가득 차거나 첫 레코드 이후 일정 시간이 지나면 기록합니다.
+ */
+static void journal_thread(void* arg) {
+    key_journal_writer* writer = (key_journal_writer*)arg;
+    // 첫 세그먼트를 열기 전에 받은 레코드도 변환할 수 있도록 기준 시각을 잡아 둠
+    writer->wall_base_ns = kp_wall_time_ns();
+    writer->mono_base_ns = kp_now_ns();
+
+    for (;;) {
+        int stopping = kp_atomic_load(&writer->stop);
+        key_journal_entry entry;
+        while (spsc_ring_pop(&writer->ring, &entry)) {
+            add_record(writer, &entry);
+        }
+        if (writer->block_records > 0 &&
+            (stopping || kp_now_ns() - writer->block_started_ns >= KEY_JOURNAL_FLUSH_INTERVAL_MS * 1000000ULL)) {
+            flush_block(writer);
+        }
+        if (stopping) {
+            break;
+        }
+
+        __atomic_store_n(&writer->writer_sleeping, 1, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (spsc_ring_size(&writer->ring) < KEY_JOURNAL_WAKE_DEPTH && !kp_atomic_load(&writer->stop)) {
+            kp_event_wait(&writer->wake, KEY_JOURNAL_POLL_MS);
+        }
+        __atomic_store_n(&writer->writer_sleeping, 0, __ATOMIC_SEQ_CST);
+    }
+    close_segment(writer);
+}
+
+/**
+ * @brief 저널 스레드를 시작합니다.
+ */
+int key_journal_writer_start(key_journal_writer* writer, const char* directory, unsigned long segment_limit,
+                             const key_journal_key_info* key_info) {
+    memset(writer, 0, sizeof(*writer));
+    spsc_ring_init(&writer->ring, writer->storage, sizeof(key_journal_entry), KEY_JOURNAL_RING_CAPACITY);
+    strncpy(writer->directory, directory, sizeof(writer->directory) - 1);
+    if (key_info != NULL) {
+        writer->key_info = *key_info;
+    }
+    writer->segment_limit = (segment_limit != 0) ? segment_limit : KEY_JOURNAL_DEFAULT_SEGMENT_BYTES;
+    writer->last_name = KEY_JOURNAL_NO_NAME;
+    if (!kp_event_init(&writer->wake)) {
+        return 0;
+    }
+    if (!kp_thread_start(&writer->thread, journal_thread, writer)) {
+        kp_event_destroy(&writer->wake);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief 16진수 숫자 하나의 값을 반환합니다. (16진수가 아니면 -1)
+ */
+static int hex_value(int c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    c = tolower(c);
+    return (c >= 'a' && c <= 'f') ? c - 'a' + 10 : -1;
+}
+
+/**
+ * @brief 저널 키 파일을 읽습니다.
+ */
+int key_journal_read_key_file(const char* path, uint32_t key[8]) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        return 0;
+    }
+    unsigned char bytes[KEY_JOURNAL_KEY_HEX_DIGITS / 2] = {0};
+    int digits = 0;
+    int ok = 1;
+    int c;
+    while ((c = fgetc(file)) != EOF) {
+        if (isspace(c)) {
+            continue;
+        }
+        int value = hex_value(c);
+        if (value < 0 || digits >= KEY_JOURNAL_KEY_HEX_DIGITS) {
+            ok = 0;
+            break;
+        }
+        bytes[digits / 2] = (unsigned char)((bytes[digits / 2] << 4) | value);
+        digits++;
+    }
+    fclose(file);
+    ok = ok && digits == KEY_JOURNAL_KEY_HEX_DIGITS;
+    for (int i = 0; i < 8; i++) {
+        key[i] = ok ? (uint32_t)get_u32(bytes + i * 4) : 0;
+    }
+    memset(bytes, 0, sizeof(bytes));
+    return ok;
+}
+
+/**
+ * @brief 저널 키와 세션 논스로 감싸기용 키스트림 블록을 만듭니다.
+ * @details 워드 0~7은 세션 키를 감싸는 데, 워드 8은 키 확인 값으로 씁니다.
+ */
+static void wrap_block(const uint32_t journal_key[8], uint32_t nonce, uint32_t block[KEYSTREAM_BLOCK_WORDS]) {
+    keystream_generate(KEYSTREAM_KERNEL_SCALAR, journal_key, KEYSTREAM_STREAM_JOURNAL, nonce, 0, block, 1);
+}
+
+/**
+ * @brief 세션 키를 저널 키로 감쌉니다.
+ */
+void key_journal_wrap_key(key_journal_key_info* info, const uint32_t journal_key[8],
+                          const uint32_t session_key[8], uint32_t nonce) {
+    uint32_t block[KEYSTREAM_BLOCK_WORDS];
+    wrap_block(journal_key, nonce, block);
+    info->nonce = nonce;
+    info->key_check = block[8];
+    for (int i = 0; i < 8; i++) {
+        info->wrapped_key[i] = session_key[i] ^ block[i];
+    }
+    info->wrapped = 1;
+    memset(block, 0, sizeof(block));
+}
+
+/**
+ * @brief 프로세스 이름을 인턴하고 번호를 반환합니다.
+ * @details 포그라운드는 드물게 바뀌므로 직전 이름부터 비교합니다.
+ */
+unsigned short key_journal_intern_name(key_journal_writer* writer, const char* name) {
+    if (name == NULL) {
+        return KEY_JOURNAL_NO_NAME;
+    }
+    if (writer->last_name != KEY_JOURNAL_NO_NAME && strcmp(writer->names[writer->last_name], name) == 0) {
+        return (unsigned short)writer->last_name;
+    }
+
+    unsigned long count = writer->name_count;
+    for (unsigned long i = 0; i < count; i++) {
+        if (strcmp(writer->names[i], name) == 0) {
+            writer->last_name = (unsigned int)i;
+            return (unsigned short)i;
+        }
+    }
+    if (count >= KEY_JOURNAL_MAX_NAMES) {
+        return KEY_JOURNAL_NO_NAME;
+    }
+
+    strncpy(writer->names[count], name, KEY_JOURNAL_NAME_SIZE - 1);
+    writer->names[count][KEY_JOURNAL_NAME_SIZE - 1] = '\0';
+    kp_atomic_store(&writer->name_count, count + 1);
+    writer->last_name = (unsigned int)count;
+    return (unsigned short)count;
+}
+
+/**
+ * @brief 레코드를 링에 넣습니다.
+ * @details 링이 절반 넘게 찼을 때만 잠든 저널 스레드를 깨우므로, 평소에는 시스템 호출이 없습니다.
+ */
+int key_journal_append(key_journal_writer* writer, const key_journal_entry* entry) {
+    if (!spsc_ring_push(&writer->ring, entry)) {
+        kp_atomic_add_relaxed(&writer->stats.dropped, 1UL);
+        return 0;
+    }
+    if (spsc_ring_size(&writer->ring) >= KEY_JOURNAL_WAKE_DEPTH) {
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_exchange_n(&writer->writer_sleeping, 0, __ATOMIC_SEQ_CST)) {
+            kp_event_signal(&writer->wake);
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief 통계 사본을 가져옵니다.
+ */
+void key_journal_writer_get_stats(const key_journal_writer* writer, key_journal_stats* stats) {
+    stats->records = kp_atomic_load_relaxed(&writer->stats.records);
+    stats->blocks = kp_atomic_load_relaxed(&writer->stats.blocks);
+    stats->segments = kp_atomic_load_relaxed(&writer->stats.segments);
+    stats->dropped = kp_atomic_load_relaxed(&writer->stats.dropped);
+    stats->write_errors = kp_atomic_load_relaxed(&writer->stats.write_errors);
+}
+
+/**
+ * @brief 남은 레코드를 기록하고 저널 스레드를 멈춥니다.
+ */
+void key_journal_writer_stop(key_journal_writer* writer) {
+    if (!writer->thread.started) {
+        return;
+    }
+    kp_atomic_store(&writer->stop, 1);
+    kp_event_signal(&writer->wake);
+    kp_thread_join(&writer->thread);
+    kp_event_destroy(&writer->wake);
+}
+
+/**
+ * @brief 세그먼트 파일을 매핑하고 헤더를 확인합니다.
+ */
+int key_journal_segment_open(key_journal_segment* segment, const char* path) {
+    memset(segment, 0, sizeof(*segment));
+    if (!kp_file_map(&segment->map, path)) {
+        return 0;
+    }
+    const unsigned char* data = (const unsigned char*)segment->map.address;
+    if (segment->map.size < KEY_JOURNAL_SEGMENT_HEADER_SIZE ||
+        memcmp(data, k_journal_magic, sizeof(k_journal_magic)) != 0 ||
+        get_u16(data + 8) != KEY_JOURNAL_VERSION ||
+        get_u16(data + 10) != KEY_JOURNAL_RECORD_SIZE ||
+        get_u16(data + 12) != KEY_JOURNAL_BLOCK_HEADER_SIZE) {
+        key_journal_segment_close(segment);
+        return 0;
+    }
+    segment->process_id = get_u32(data + 16);
+    segment->sequence = get_u32(data + 20);
+    segment->created_ns = get_u64(data + 24);
+    segment->flags = get_u16(data + 14);
+    segment->key_info.nonce = (uint32_t)get_u32(data + 32);
+    segment->key_info.wrapped = (segment->flags & KEY_JOURNAL_FLAG_WRAPPED_KEY) != 0;
+    segment->key_info.key_check = (uint32_t)get_u32(data + 36);
+    for (int i = 0; i < 8; i++) {
+        segment->key_info.wrapped_key[i] = (uint32_t)get_u32(data + 40 + i * 4);
+    }
+    return 1;
+}
+
+/**
+ * @brief 세그먼트 헤더의 감싼 세션 키를 저널 키로 풉니다.
+ */
+int key_journal_unwrap_key(const key_journal_segment* segment, const uint32_t journal_key[8], uint32_t session_key[8]) {
+    if (!segment->key_info.wrapped) {
+        return 0;
+    }
+    uint32_t block[KEYSTREAM_BLOCK_WORDS];
+    wrap_block(journal_key, segment->key_info.nonce, block);
+    int ok = block[8] == segment->key_info.key_check;
+    for (int i = 0; i < 8; i++) {
+        session_key[i] = ok ? segment->key_info.wrapped_key[i] ^ block[i] : 0;
+    }
+    memset(block, 0, sizeof(block));
+    return ok;
+}
+
+/**
+ * @brief 레코드의 암호화된 키 코드를 세션 키로 복호화합니다.
+ * @details 솔트(키스트림 위치)의 워드를 다시 만들어 XOR합니다.
+ */
+unsigned int key_journal_decrypt(const uint32_t session_key[8], uint32_t nonce, const key_journal_record* record) {
+    uint32_t word = keystream_word_at(session_key, nonce, record->salt);
+    return decrypt_keycode_with_salt(record->encrypted_keycode, word);
+}
+
+/**
+ * @brief 길이가 주어진 이름과 NUL 종료 이름을 대소문자 구분 없이 비교합니다.
+ */
+static int name_equals(const char* name, size_t length, const char* expected) {
+    for (size_t i = 0; i < length; i++) {
+        if (expected[i] == '\0' ||
+            tolower((unsigned char)name[i]) != tolower((unsigned char)expected[i])) {
+            return 0;
+        }
+    }
+    return expected[length] == '\0';
+}
+
+/**
+ * @brief 세그먼트의 블록을 차례로 검사하여 조건에 맞는 레코드를 전달합니다.
+ * @details 프로세스 조건은 이름 블록을 만날 때 이름 번호 집합으로 바꾸어 두므로,
+ *          레코드마다 문자열을 비교하지 않습니다.
+ */
+int key_journal_scan(key_journal_segment* segment, const key_journal_query* query,
+                     key_journal_visit_fn visit, void* user, key_journal_scan_result* result) {
+    const unsigned char* data = (const unsigned char*)segment->map.address;
+    size_t size = segment->map.size;
+    size_t offset = KEY_JOURNAL_SEGMENT_HEADER_SIZE;
+    unsigned char process_match[KEY_JOURNAL_MAX_NAMES] = {0};
+
+    while (offset + KEY_JOURNAL_BLOCK_HEADER_SIZE <= size) {
+        const unsigned char* header = data + offset;
+        const unsigned char* payload = header + KEY_JOURNAL_BLOCK_HEADER_SIZE;
+        unsigned int type = get_u16(header + 4);
+        unsigned int count = get_u16(header + 6);
+        unsigned long payload_size = get_u32(header + 8);
+        if (get_u32(header) != KEY_JOURNAL_BLOCK_MAGIC ||
+            payload_size > size - offset - KEY_JOURNAL_BLOCK_HEADER_SIZE) {
+            result->truncated = 1;
+            return 0;
+        }
+        offset += KEY_JOURNAL_BLOCK_HEADER_SIZE + payload_size;
+
+        if (type == KEY_JOURNAL_BLOCK_RECORDS_TYPE) {
+            unsigned long long first_ns = get_u64(header + 16);
+            unsigned long long last_ns = get_u64(header + 24);
+            if ((query->from_ns != 0 && last_ns < query->from_ns) ||
+                (query->to_ns != 0 && first_ns >= query->to_ns)) {
+                result->blocks_skipped++;
+                continue;
+            }
+        }
+        if (block_crc(header, payload, payload_size) != get_u32(header + 12)) {
+            result->truncated = 1;
+            return 0;
+        }
+
+        if (type == KEY_JOURNAL_BLOCK_NAME_TYPE) {
+            if (count < KEY_JOURNAL_MAX_NAMES && payload_size < KEY_JOURNAL_NAME_SIZE) {
+                segment->names[count] = (const char*)payload;
+                segment->name_lengths[count] = (unsigned short)payload_size;
+                process_match[count] = query->process != NULL &&
+                                       name_equals((const char*)payload, payload_size, query->process);
+            }
+            continue;
+        }
+        if (type != KEY_JOURNAL_BLOCK_RECORDS_TYPE || payload_size != (unsigned long)count * KEY_JOURNAL_RECORD_SIZE) {
+            continue;
+        }
+
+        result->blocks++;
+        result->records += count;
+        for (unsigned int i = 0; i < count; i++) {
+            const unsigned char* raw = payload + (size_t)i * KEY_JOURNAL_RECORD_SIZE;
+            key_journal_record record;
+            record.timestamp_ns = get_u64(raw);
+            if ((query->from_ns != 0 && record.timestamp_ns < query->from_ns) ||
+                (query->to_ns != 0 && record.timestamp_ns >= query->to_ns)) {
+                continue;
+            }
+            record.name_id = (unsigned short)get_u16(raw + 16);
+            record.verdict = raw[18];
+            if (query->process != NULL &&
+                (record.name_id >= KEY_JOURNAL_MAX_NAMES || !process_match[record.name_id])) {
+                continue;
+            }
+            if (query->verdict_mask != 0 && (record.verdict >= 32 || !(query->verdict_mask & (1U << record.verdict)))) {
+                continue;
+            }
+            result->matched++;
+            if (visit != NULL) {
+                record.encrypted_keycode = (unsigned int)get_u32(raw + 8);
+                record.salt = (unsigned int)get_u32(raw + 12);
+                record.sequence = (unsigned int)get_u32(raw + 20);
+                visit(user, segment, &record);
+            }
+        }
+    }
+    if (offset != size) {
+        // 블록 헤더도 다 쓰지 못한 채 끝난 세그먼트 (기록 중이거나 비정상 종료)
+        result->truncated = 1;
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief 세그먼트 안의 이름 번호에 해당하는 프로세스 이름을 반환합니다.
+ */
+const char* key_journal_segment_name(const key_journal_segment* segment, unsigned int name_id, size_t* length) {
+    if (name_id >= KEY_JOURNAL_MAX_NAMES || segment->names[name_id] == NULL) {
+        *length = 0;
+        return NULL;
+    }
+    *length = segment->name_lengths[name_id];
+    return segment->names[name_id];
+}
+
+/**
+ * @brief 세그먼트 매핑을 해제합니다.
+ */
+void key_journal_segment_close(key_journal_segment* segment) {
+    kp_file_unmap(&segment->map);
+}
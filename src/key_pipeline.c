@@ -0,0 +1,174 @@
+#include "key_pipeline.h"
+#include "kp_atomic.h"
+
+#include <string.h>
+
+/** @brief 깨우기 신호를 놓친 경우에 대비한 최대 대기 시간 (밀리초) */
+#define KEY_PIPELINE_IDLE_WAIT_MS 50
+
+/**
+ * @brief 관측값으로 최대값을 갱신합니다. (작업 스레드 전용 값)
+ */
+static void update_max(unsigned long long* max, unsigned long long value) {
+    if (value > kp_atomic_load_relaxed(max)) {
+        kp_atomic_store_relaxed(max, value);
+    }
+}
+
+/**
+ * @brief 큐에서 이벤트 하나를 꺼내 처리합니다.
+ * @return int 처리했으면 1, 큐가 비었으면 0
+ */
+static int process_one(key_pipeline* pipeline) {
+    key_event event;
+    unsigned long depth = spsc_ring_size(&pipeline->queue);
+    if (!spsc_ring_pop(&pipeline->queue, &event)) {
+        return 0;
+    }
+    
+    if (depth > kp_atomic_load_relaxed(&pipeline->stats.max_depth)) {
+        kp_atomic_store_relaxed(&pipeline->stats.max_depth, depth);
+    }
+    unsigned long long now = kp_now_ns();
+    unsigned long long lag = (now > event.enqueue_ns) ? now - event.enqueue_ns : 0;
+    kp_atomic_add_relaxed(&pipeline->stats.lag_total_ns, lag);
+    update_max(&pipeline->stats.lag_max_ns, lag);
+    kp_stats_record(pipeline->stats_block, KP_STAT_QUEUE, lag);
+    
+    pipeline->handler(&event, pipeline->user);
+    kp_atomic_add_relaxed(&pipeline->stats.processed, 1UL);
+    if (pipeline->stats_block != NULL) {
+        kp_stats_record(pipeline->stats_block, KP_STAT_EVENT, kp_now_ns() - now);
+    }
+    return 1;
+}
+
+/**
+ * @brief 작업 스레드 함수
+ * @details 큐가 비면 유휴 처리 함수를 부른 뒤, 잠들기 전에 잠든 상태를 먼저 게시하고 큐를 다시 확인하여
+ *          후크가 넣은 이벤트를 놓치지 않도록 합니다.
+ */
+static void worker_thread(void* arg) {
+    key_pipeline* pipeline = (key_pipeline*)arg;
+    
+    while (!pipeline->stop) {
+        if (process_one(pipeline)) {
+            continue;
+        }
+        if (pipeline->idle != NULL) {
+            pipeline->idle(pipeline->user);
+            if (spsc_ring_size(&pipeline->queue) != 0) {
+                continue;
+            }
+        }
+        
+        __atomic_store_n(&pipeline->worker_sleeping, 1, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (spsc_ring_size(&pipeline->queue) == 0 && !pipeline->stop) {
+            kp_event_wait(&pipeline->wake, KEY_PIPELINE_IDLE_WAIT_MS);
+        }
+        __atomic_store_n(&pipeline->worker_sleeping, 0, __ATOMIC_SEQ_CST);
+    }
+    
+    // 종료 전에 남은 이벤트 처리 (키 업 누락 방지)
+    while (process_one(pipeline)) {
+    }
+    if (pipeline->idle != NULL) {
+        pipeline->idle(pipeline->user);
+    }
+}
+
+/**
+ * @brief 파이프라인을 초기화하고 작업 스레드를 시작합니다.
+ */
+int key_pipeline_start(key_pipeline* pipeline, key_event_handler handler, key_idle_handler idle, void* user) {
+    memset(pipeline, 0, sizeof(*pipeline));
+    spsc_ring_init(&pipeline->queue, pipeline->storage, sizeof(key_event), KEY_PIPELINE_CAPACITY);
+    pipeline->handler = handler;
+    pipeline->idle = idle;
+    pipeline->user = user;
+    if (!kp_event_init(&pipeline->wake)) {
+        return 0;
+    }
+    if (!kp_thread_start(&pipeline->worker, worker_thread, pipeline)) {
+        kp_event_destroy(&pipeline->wake);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief 지연 히스토그램을 기록할 통계 블록을 연결합니다.
+ */
+void key_pipeline_attach_stats(key_pipeline* pipeline, kp_stats_block* block) {
+    pipeline->stats_block = block;
+}
+
+/**
+ * @brief 키 이벤트를 큐에 넣습니다.
+ */
+int key_pipeline_submit(key_pipeline* pipeline, const key_event* event) {
+    if (!spsc_ring_push(&pipeline->queue, event)) {
+        kp_atomic_add_relaxed(&pipeline->stats.dropped, 1UL);
+        return 0;
+    }
+    kp_atomic_add_relaxed(&pipeline->stats.enqueued, 1UL);
+    
+    // 작업 스레드가 깨어 있으면 시스템 호출 없이 반환
+    // (잠든 상태 플래그를 직접 내려, 작업 스레드가 깨어나는 동안 들어온 이벤트가 신호를 반복하지 않도록 함)
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_exchange_n(&pipeline->worker_sleeping, 0, __ATOMIC_SEQ_CST)) {
+        kp_atomic_add_relaxed(&pipeline->stats.wakeups, 1UL);
+        kp_event_signal(&pipeline->wake);
+    }
+    return 1;
+}
+
+/**
+ * @brief 단계별 소요 시간을 기록합니다.
+ */
+void key_pipeline_record_stage(key_pipeline* pipeline, key_pipeline_stage stage, unsigned long long elapsed_ns) {
+    static const kp_stat_stage histogram_stage[KEY_STAGE_COUNT] = {
+        KP_STAT_RESOLVE, KP_STAT_CRYPTO, KP_STAT_INJECT
+    };
+    kp_atomic_add_relaxed(&pipeline->stats.stage_total_ns[stage], elapsed_ns);
+    update_max(&pipeline->stats.stage_max_ns[stage], elapsed_ns);
+    kp_stats_record(pipeline->stats_block, histogram_stage[stage], elapsed_ns);
+}
+
+/**
+ * @brief 현재 큐 깊이를 반환합니다.
+ */
+unsigned long key_pipeline_depth(const key_pipeline* pipeline) {
+    return spsc_ring_size(&pipeline->queue);
+}
+
+/**
+ * @brief 통계 사본을 가져옵니다.
+ */
+void key_pipeline_get_stats(const key_pipeline* pipeline, key_pipeline_stats* stats) {
+    stats->enqueued = kp_atomic_load_relaxed(&pipeline->stats.enqueued);
+    stats->dropped = kp_atomic_load_relaxed(&pipeline->stats.dropped);
+    stats->processed = kp_atomic_load_relaxed(&pipeline->stats.processed);
+    stats->wakeups = kp_atomic_load_relaxed(&pipeline->stats.wakeups);
+    stats->max_depth = kp_atomic_load_relaxed(&pipeline->stats.max_depth);
+    stats->lag_total_ns = kp_atomic_load_relaxed(&pipeline->stats.lag_total_ns);
+    stats->lag_max_ns = kp_atomic_load_relaxed(&pipeline->stats.lag_max_ns);
+    for (int i = 0; i < KEY_STAGE_COUNT; i++) {
+        stats->stage_total_ns[i] = kp_atomic_load_relaxed(&pipeline->stats.stage_total_ns[i]);
+        stats->stage_max_ns[i] = kp_atomic_load_relaxed(&pipeline->stats.stage_max_ns[i]);
+    }
+}
+
+/**
+ * @brief 남은 이벤트를 모두 처리한 뒤 작업 스레드를 멈춥니다.
+ */
+void key_pipeline_stop(key_pipeline* pipeline) {
+    if (!pipeline->worker.started) {
+        return;
+    }
+    pipeline->stop = 1;
+    kp_event_signal(&pipeline->wake);
+    kp_thread_join(&pipeline->worker);
+    kp_event_destroy(&pipeline->wake);
+}
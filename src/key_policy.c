@@ -0,0 +1,379 @@
+#include "key_policy.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** @brief 규칙 항목 하나의 최대 길이 */
+#define KEY_POLICY_TOKEN_SIZE 32
+
+/** @brief 모든 조합 키 상태를 허용하는 조합 표 */
+#define KEY_POLICY_ALL_CHORDS 0xFFFFU
+
+/**
+ * @brief 이름이 붙은 가상 키 범위 (같은 이름의 행이 여러 개면 모두 적용)
+ */
+typedef struct key_range {
+    const char* name;    /**< 분류 또는 키 이름 */
+    unsigned char first; /**< 범위 시작 가상 키 */
+    unsigned char last;  /**< 범위 끝 가상 키 (포함) */
+} key_range;
+
+/**
+ * @brief 분류와 키 이름 표
+ * @details 글자, 숫자, F1~F24, numpad0~9, 0x 코드는 key_name_to_vk()에서 따로 처리합니다.
+ */
+static const key_range g_key_ranges[] = {
+    { "all",        0x01, 0xFE },
+    { "alpha",      0x41, 0x5A },
+    { "digit",      0x30, 0x39 },
+    { "alnum",      0x30, 0x39 }, { "alnum", 0x41, 0x5A },
+    { "func",       0x70, 0x87 },
+    { "nav",        0x21, 0x28 }, { "nav", 0x2D, 0x2E },
+    { "edit",       0x08, 0x09 }, { "edit", 0x0D, 0x0D }, { "edit", 0x20, 0x20 },
+    { "punct",      0xBA, 0xC0 }, { "punct", 0xDB, 0xDF }, { "punct", 0xE2, 0xE2 },
+    { "numpad",     0x60, 0x6F },
+    { "shift",      0x10, 0x10 }, { "shift", 0xA0, 0xA1 },
+    { "ctrl",       0x11, 0x11 }, { "ctrl", 0xA2, 0xA3 },
+    { "alt",        0x12, 0x12 }, { "alt", 0xA4, 0xA5 },
+    { "win",        0x5B, 0x5C },
+    { "modifiers",  0x10, 0x12 }, { "modifiers", 0x5B, 0x5C }, { "modifiers", 0xA0, 0xA5 },
+    { "backspace",  0x08, 0x08 }, { "back", 0x08, 0x08 },
+    { "tab",        0x09, 0x09 },
+    { "enter",      0x0D, 0x0D }, { "return", 0x0D, 0x0D },
+    { "pause",      0x13, 0x13 },
+    { "capslock",   0x14, 0x14 },
+    { "esc",        0x1B, 0x1B }, { "escape", 0x1B, 0x1B },
+    { "space",      0x20, 0x20 },
+    { "pageup",     0x21, 0x21 }, { "pgup", 0x21, 0x21 },
+    { "pagedown",   0x22, 0x22 }, { "pgdn", 0x22, 0x22 },
+    { "end",        0x23, 0x23 },
+    { "home",       0x24, 0x24 },
+    { "left",       0x25, 0x25 },
+    { "up",         0x26, 0x26 },
+    { "right",      0x27, 0x27 },
+    { "down",       0x28, 0x28 },
+    { "printscreen", 0x2C, 0x2C },
+    { "insert",     0x2D, 0x2D }, { "ins", 0x2D, 0x2D },
+    { "delete",     0x2E, 0x2E }, { "del", 0x2E, 0x2E },
+    { "lwin",       0x5B, 0x5B },
+    { "rwin",       0x5C, 0x5C },
+    { "apps",       0x5D, 0x5D },
+    { "numlock",    0x90, 0x90 },
+    { "scrolllock", 0x91, 0x91 },
+    { "lshift",     0xA0, 0xA0 },
+    { "rshift",     0xA1, 0xA1 },
+    { "lctrl",      0xA2, 0xA2 },
+    { "rctrl",      0xA3, 0xA3 },
+    { "lalt",       0xA4, 0xA4 },
+    { "ralt",       0xA5, 0xA5 }
+};
+
+/**
+ * @brief ASCII 대문자를 소문자로 바꿉니다.
+ */
+static char fold_char(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c;
+}
+
+/**
+ * @brief 두 문자열을 대소문자 구분 없이 비교합니다.
+ */
+static int name_equals(const char* a, const char* b) {
+    while (*a != '\0' && fold_char(*a) == fold_char(*b)) {
+        a++;
+        b++;
+    }
+    return *a == '\0' && *b == '\0';
+}
+
+/**
+ * @brief 이름이 접두사로 시작하는지 대소문자 구분 없이 확인합니다.
+ */
+static int name_has_prefix(const char* name, const char* prefix) {
+    while (*prefix != '\0' && fold_char(*name) == *prefix) {
+        name++;
+        prefix++;
+    }
+    return *prefix == '\0';
+}
+
+/**
+ * @brief 비트맵의 가상 키 범위를 설정하거나 지웁니다.
+ */
+static void set_range(key_rule* rule, unsigned int first, unsigned int last, int allow) {
+    for (unsigned int vk = first; vk <= last; vk++) {
+        uint32_t bit = 1U << (vk & 31);
+        if (allow) {
+            rule->keys[vk >> 5] |= bit;
+        } else {
+            rule->keys[vk >> 5] &= ~bit;
+        }
+    }
+}
+
+/**
+ * @brief 키 항목 하나를 비트맵에 반영합니다.
+ * @return int 알려진 분류나 키 이름이면 1
+ */
+static int apply_key_term(key_rule* rule, const char* name, int allow) {
+    int found = 0;
+    for (size_t i = 0; i < sizeof(g_key_ranges) / sizeof(g_key_ranges[0]); i++) {
+        if (name_equals(g_key_ranges[i].name, name)) {
+            set_range(rule, g_key_ranges[i].first, g_key_ranges[i].last, allow);
+            found = 1;
+        }
+    }
+    if (!found) {
+        int vk = key_name_to_vk(name);
+        if (vk < 0) {
+            return 0;
+        }
+        set_range(rule, (unsigned int)vk, (unsigned int)vk, allow);
+    }
+    return 1;
+}
+
+/**
+ * @brief 조합 키 이름을 KEY_MOD_* 비트로 바꿉니다.
+ */
+static unsigned int modifier_from_name(const char* name) {
+    if (name_equals("shift", name)) return KEY_MOD_SHIFT;
+    if (name_equals("ctrl", name))  return KEY_MOD_CTRL;
+    if (name_equals("alt", name))   return KEY_MOD_ALT;
+    if (name_equals("win", name))   return KEY_MOD_WIN;
+    return 0;
+}
+
+/**
+ * @brief 조합 항목 하나를 조합 표에 반영합니다.
+ * @return int 알려진 항목이면 1
+ */
+static int apply_chord_term(key_rule* rule, const char* term) {
+    if (name_equals("any", term)) {
+        rule->chords = KEY_POLICY_ALL_CHORDS;
+        return 1;
+    }
+    if (name_equals("none", term)) {
+        rule->chords = 1U;
+        return 1;
+    }
+    if (term[0] != '-') {
+        return 0;
+    }
+    unsigned int modifier = modifier_from_name(term + 1);
+    if (modifier == 0) {
+        return 0;
+    }
+    // 해당 조합 키를 누르고 있는 모든 상태 제외
+    for (unsigned int state = 0; state < KEY_MOD_STATES; state++) {
+        if (state & modifier) {
+            rule->chords &= ~(1U << state);
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief 알 수 없는 항목을 호출자 버퍼에 복사합니다.
+ */
+static int reject_token(const char* token, char* bad_token, size_t bad_size) {
+    if (bad_token != NULL && bad_size > 0) {
+        strncpy(bad_token, token, bad_size - 1);
+        bad_token[bad_size - 1] = '\0';
+    }
+    return 0;
+}
+
+/**
+ * @brief 전체 허용 규칙(0번) 하나만 있는 테이블로 초기화합니다.
+ */
+void key_policy_init(key_policy* policy) {
+    memset(policy, 0, sizeof(*policy));
+    set_range(&policy->rules[KEY_POLICY_RULE_ALL], 0x01, 0xFE, 1);
+    policy->rules[KEY_POLICY_RULE_ALL].chords = KEY_POLICY_ALL_CHORDS;
+    policy->count = 1;
+}
+
+/**
+ * @brief 규칙 문자열을 컴파일합니다.
+ * @details 키 항목이 없거나 첫 키 항목이 제외 항목이면 `all`에서 시작합니다.
+ *          조합 항목이 없으면 모든 조합 키 상태를 허용합니다.
+ */
+int key_rule_compile(key_rule* rule, const char* spec, char* bad_token, size_t bad_size) {
+    memset(rule, 0, sizeof(*rule));
+    rule->chords = KEY_POLICY_ALL_CHORDS;
+
+    int chord_part = 0;
+    int key_terms = 0;
+    const char* p = spec;
+    for (;;) {
+        // 구분자 건너뛰기 ('|' 뒤부터는 조합 항목)
+        while (*p == ' ' || *p == '\t' || *p == ',' || *p == '|') {
+            if (*p == '|') {
+                chord_part = 1;
+            }
+            p++;
+        }
+        if (*p == '\0') {
+            break;
+        }
+
+        char token[KEY_POLICY_TOKEN_SIZE];
+        size_t length = 0;
+        int overlong = 0;
+        while (*p != '\0' && *p != ' ' && *p != '\t' && *p != ',' && *p != '|') {
+            if (length + 1 < sizeof(token)) {
+                token[length++] = *p;
+            } else {
+                overlong = 1;
+            }
+            p++;
+        }
+        token[length] = '\0';
+        // 잘린 항목이 우연히 알려진 이름이 되지 않도록 너무 긴 항목은 거부
+        if (overlong) {
+            return reject_token(token, bad_token, bad_size);
+        }
+
+        if (chord_part) {
+            if (!apply_chord_term(rule, token)) {
+                return reject_token(token, bad_token, bad_size);
+            }
+            continue;
+        }
+        int allow = (token[0] != '-');
+        if (!allow && key_terms == 0) {
+            set_range(rule, 0x01, 0xFE, 1);
+        }
+        if (!apply_key_term(rule, allow ? token : token + 1, allow)) {
+            return reject_token(token, bad_token, bad_size);
+        }
+        key_terms++;
+    }
+
+    if (key_terms == 0) {
+        set_range(rule, 0x01, 0xFE, 1);
+    }
+    return 1;
+}
+
+/**
+ * @brief 규칙을 테이블에 추가합니다.
+ */
+int key_policy_add(key_policy* policy, const key_rule* rule) {
+    if (policy->count >= KEY_POLICY_MAX_RULES) {
+        return -1;
+    }
+    policy->rules[policy->count] = *rule;
+    return (int)policy->count++;
+}
+
+/**
+ * @brief 키 입력이 규칙에서 허용되는지 판정합니다.
+ * @details 정책 재로드 직후에는 판정 캐시가 이전 스냅샷의 규칙 번호를 들고 있을 수 있으므로,
+ *          범위를 벗어난 번호는 안전을 위해 차단합니다.
+ */
+int key_policy_allows(const key_policy* policy, unsigned int rule, unsigned int vk_code, unsigned int modifiers) {
+    if (rule >= policy->count) {
+        return 0;
+    }
+    const key_rule* entry = &policy->rules[rule];
+    return (int)((entry->keys[(vk_code >> 5) & (KEY_POLICY_KEY_WORDS - 1)] >> (vk_code & 31)) &
+                 (entry->chords >> (modifiers & (KEY_MOD_STATES - 1))) & 1U);
+}
+
+/**
+ * @brief 가상 키가 조합 키라면 눌림 상태 마스크의 비트를 반환합니다.
+ * @details 비트 0~1은 Shift, 2~3은 Ctrl, 4~5는 Alt, 6~7은 Win(왼쪽/오른쪽)이며,
+ *          좌우 구분이 없는 VK_SHIFT/VK_CONTROL/VK_MENU는 왼쪽 비트로 기록합니다.
+ */
+unsigned int key_modifier_key(unsigned int vk_code) {
+    switch (vk_code) {
+    case 0x10: case 0xA0: return 0x01; // VK_SHIFT, VK_LSHIFT
+    case 0xA1:            return 0x02; // VK_RSHIFT
+    case 0x11: case 0xA2: return 0x04; // VK_CONTROL, VK_LCONTROL
+    case 0xA3:            return 0x08; // VK_RCONTROL
+    case 0x12: case 0xA4: return 0x10; // VK_MENU, VK_LMENU
+    case 0xA5:            return 0x20; // VK_RMENU
+    case 0x5B:            return 0x40; // VK_LWIN
+    case 0x5C:            return 0x80; // VK_RWIN
+    default:              return 0;
+    }
+}
+
+/**
+ * @brief 눌림 상태 마스크를 KEY_MOD_* 조합 키 상태로 바꿉니다.
+ */
+unsigned int key_modifier_state(unsigned int held_keys) {
+    return ((held_keys & 0x03) ? KEY_MOD_SHIFT : 0) |
+           ((held_keys & 0x0C) ? KEY_MOD_CTRL : 0) |
+           ((held_keys & 0x30) ? KEY_MOD_ALT : 0) |
+           ((held_keys & 0xC0) ? KEY_MOD_WIN : 0);
+}
+
+/**
+ * @brief 키 이름을 가상 키 코드로 바꿉니다.
+ * @details 글자/숫자 한 자, `f1`~`f24`, `numpad0`~`numpad9`, `0x` 코드, 표에 있는 단일 키 이름을 받습니다.
+ */
+int key_name_to_vk(const char* name) {
+    size_t length = strlen(name);
+    if (length == 1) {
+        char c = fold_char(name[0]);
+        if (c >= 'a' && c <= 'z') {
+            return 0x41 + (c - 'a');
+        }
+        if (c >= '0' && c <= '9') {
+            return 0x30 + (c - '0');
+        }
+        return -1;
+    }
+    if (length > 2 && name[0] == '0' && fold_char(name[1]) == 'x') {
+        // strtoul이 받아 주는 부호와 공백은 허용하지 않음
+        if (!isxdigit((unsigned char)name[2])) {
+            return -1;
+        }
+        char* end = NULL;
+        unsigned long vk = strtoul(name + 2, &end, 16);
+        return (*end == '\0' && vk >= 0x01 && vk <= 0xFE) ? (int)vk : -1;
+    }
+    if (fold_char(name[0]) == 'f' && name[1] >= '1' && name[1] <= '9') {
+        char* end = NULL;
+        unsigned long index = strtoul(name + 1, &end, 10);
+        return (*end == '\0' && index >= 1 && index <= 24) ? (int)(0x6F + index) : -1;
+    }
+    if (length == 7 && name_has_prefix(name, "numpad") && name[6] >= '0' && name[6] <= '9') {
+        return 0x60 + (name[6] - '0');
+    }
+
+    // 단일 키 이름 (행이 하나이고 범위가 키 하나인 이름만, 분류는 제외)
+    int found = -1;
+    for (size_t i = 0; i < sizeof(g_key_ranges) / sizeof(g_key_ranges[0]); i++) {
+        const key_range* range = &g_key_ranges[i];
+        if (name_equals(range->name, name)) {
+            if (found >= 0 || range->first != range->last) {
+                return -1;
+            }
+            found = range->first;
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief 규칙이 허용하는 키 수를 반환합니다.
+ */
+unsigned int key_rule_key_count(const key_rule* rule) {
+    unsigned int count = 0;
+    for (int i = 0; i < KEY_POLICY_KEY_WORDS; i++) {
+        count += (unsigned int)__builtin_popcount(rule->keys[i]);
+    }
+    return count;
+}
+
+/**
+ * @brief 규칙이 허용하는 조합 키 상태 수를 반환합니다.
+ */
+unsigned int key_rule_chord_count(const key_rule* rule) {
+    return (unsigned int)__builtin_popcount(rule->chords & KEY_POLICY_ALL_CHORDS);
+}
@@ -0,0 +1,304 @@
+#include "key_processor.h"
+#include "crypto_keycode.h"
+#include "log_ring.h"
+#include "kp_atomic.h"
+
+#include <string.h>
+
+#if KP_STATIC_BACKEND
+#define BACKEND_MAKE_SALT(processor, pad) kp_backend_make_salt((processor)->backend.context, (pad))
+#define BACKEND_INJECT(processor, vk_code, key_down) \
+    kp_backend_inject((processor)->backend.context, (vk_code), (key_down))
+#else
+#define BACKEND_MAKE_SALT(processor, pad) (processor)->backend.make_salt((processor)->backend.context, (pad))
+#define BACKEND_INJECT(processor, vk_code, key_down) \
+    (processor)->backend.inject((processor)->backend.context, (vk_code), (key_down))
+#endif
+
+/**
+ * @brief 처리 코어를 초기화합니다.
+ * @param processor 초기화할 처리 코어
+ * @param foreground 포그라운드 판정 캐시
+ * @param backend 플랫폼 함수 (내용이 복사됨)
+ * @param pipeline 단계별 소요 시간을 기록할 파이프라인 (NULL 가능)
+ */
+void key_processor_init(key_processor* processor, foreground_cache* foreground,
+                        const key_processor_backend* backend, key_pipeline* pipeline) {
+    memset(processor, 0, sizeof(*processor));
+    processor->foreground = foreground;
+    processor->backend = *backend;
+    processor->pipeline = pipeline;
+}
+
+/**
+ * @brief 메시지가 키 다운인지 확인합니다.
+ */
+int key_processor_is_key_down(unsigned int message) {
+    return message == KEY_MESSAGE_KEYDOWN || message == KEY_MESSAGE_SYSKEYDOWN;
+}
+
+/**
+ * @brief 첫 단계의 시작 시각을 반환합니다. (단계별 시간을 기록하지 않으면 0)
+ */
+static unsigned long long begin_stage(const key_processor* processor) {
+#if KP_FEATURE_STAGE_TIMING
+    return (processor->pipeline != NULL) ? kp_now_ns() : 0;
+#else
+    (void)processor;
+    return 0;
+#endif
+}
+
+/**
+ * @brief 단계 소요 시간을 기록하고 다음 단계의 시작 시각을 반환합니다.
+ */
+static unsigned long long end_stage(key_processor* processor, key_pipeline_stage stage,
+                                    unsigned long long start) {
+#if KP_FEATURE_STAGE_TIMING
+    if (processor->pipeline == NULL) {
+        return 0;
+    }
+    unsigned long long now = kp_now_ns();
+    key_pipeline_record_stage(processor->pipeline, stage, now - start);
+    return now;
+#else
+    (void)processor;
+    (void)stage;
+    (void)start;
+    return 0;
+#endif
+}
+
+/**
+ * @brief 판정을 백엔드 로그에 기록합니다.
+ */
+static void report_verdict(key_processor* processor, unsigned int vk_code, unsigned int salt,
+                           unsigned int encrypted_keycode, foreground_verdict verdict,
+                           const char* process_name, unsigned int repeats) {
+#if KP_FEATURE_KEY_LOG
+    static const int log_verdicts[] = {
+        LOG_VERDICT_UNKNOWN,  // FOREGROUND_UNKNOWN
+        LOG_VERDICT_BLOCKED,  // FOREGROUND_BLOCKED
+        LOG_VERDICT_ALLOWED   // FOREGROUND_ALLOWED
+    };
+    if (processor->backend.log != NULL) {
+        processor->backend.log(processor->backend.context, vk_code, salt, encrypted_keycode,
+                               log_verdicts[verdict], (verdict == FOREGROUND_UNKNOWN) ? NULL : process_name,
+                               repeats);
+    }
+#else
+    (void)processor;
+    (void)vk_code;
+    (void)salt;
+    (void)encrypted_keycode;
+    (void)verdict;
+    (void)process_name;
+    (void)repeats;
+#endif
+}
+
+/**
+ * @brief 포그라운드 판정에 키 규칙을 적용합니다.
+ * @details 허용 프로세스라도 규칙 비트맵에 없는 키이거나 허용하지 않는 조합 키 상태에서 누른 키는 차단합니다.
+ *          판정 캐시에는 프로세스의 규칙 번호 + 1이 들어 있으므로 비트 검사 두 번으로 끝납니다.
+ */
+static foreground_verdict resolve_key(key_processor* processor, unsigned int vk_code, const char** process_name) {
+    foreground_verdict verdict = foreground_cache_lookup(processor->foreground, process_name);
+    if (verdict == FOREGROUND_ALLOWED && processor->policy != NULL &&
+        !key_policy_allows(processor->policy, (unsigned int)processor->foreground->allowed - 1U, vk_code,
+                           key_modifier_state(processor->modifier_keys))) {
+        processor->rule_blocked++;
+        return FOREGROUND_BLOCKED;
+    }
+    return verdict;
+}
+
+/**
+ * @brief 판정 캐시가 키 상태의 세대에서 얻은 프로세스 이름을 아직 들고 있으면 반환합니다.
+ */
+static const char* cached_process_name(const key_processor* processor, const key_state* state) {
+    const foreground_cache* cache = processor->foreground;
+    if (cache->valid && (unsigned int)cache->cached_generation == state->generation) {
+        return cache->process_name;
+    }
+    return NULL;
+}
+
+/**
+ * @brief 합쳐 둔 자동 반복 횟수를 한 번의 로그로 기록합니다.
+ */
+static void flush_repeats(key_processor* processor, unsigned int vk_code, key_state* state) {
+    if (state->repeats == 0) {
+        return;
+    }
+    report_verdict(processor, vk_code, state->salt, state->encrypted, (foreground_verdict)state->verdict,
+                   cached_process_name(processor, state), state->repeats);
+    state->repeats = 0;
+}
+
+/**
+ * @brief 자동 반복 키 다운을 처리합니다.
+ * @details 키를 누르고 있는 동안 Windows는 초당 약 30회 키 다운을 반복해서 보냅니다.
+ *          키 다운 때 만든 솔트와 암호화 상태를 그대로 쓰고, 그 뒤로 포그라운드 캐시가 무효화되지 않았다면
+ *          캐시된 판정도 그대로 사용합니다. (변경 알림이 없는 확인 모드에서는 포그라운드를 먼저 비교)
+ *          반복은 하나씩 기록하지 않고 횟수만 셉니다.
+ */
+static foreground_verdict handle_repeat(key_processor* processor, unsigned int original_keycode,
+                                        key_state* state, const char** process_name) {
+    unsigned long long stage_start = begin_stage(processor);
+    foreground_cache_verify(processor->foreground);
+    unsigned int generation = (unsigned int)kp_atomic_load(&processor->foreground->generation);
+    foreground_verdict verdict = (foreground_verdict)state->verdict;
+    
+    if (verdict != FOREGROUND_UNKNOWN && state->generation == generation) {
+        // 빠른 경로: 캐시된 판정 사용
+        *process_name = cached_process_name(processor, state);
+        if (state->repeats < 0xFFFF) {
+            state->repeats++;
+        }
+    } else {
+        // 키를 누른 채 포그라운드나 정책이 바뀐 경우(또는 확인 실패): 다시 판정
+        // 세대가 바뀌었으면 캐시가 아직 이전 이름을 들고 있을 때 그동안의 반복을 마감
+        if (state->generation != generation) {
+            flush_repeats(processor, original_keycode, state);
+        }
+        verdict = resolve_key(processor, original_keycode, process_name);
+        stage_start = end_stage(processor, KEY_STAGE_RESOLVE, stage_start);
+        state->generation = generation;
+        if (verdict != (foreground_verdict)state->verdict) {
+            // 판정이 달라지면 새 판정을 키 다운처럼 기록
+            state->verdict = (unsigned char)verdict;
+            report_verdict(processor, original_keycode, state->salt, state->encrypted, verdict, *process_name, 0);
+        } else if (state->repeats < 0xFFFF) {
+            state->repeats++;
+        }
+    }
+    processor->repeats++;
+    
+    if (verdict == FOREGROUND_ALLOWED) {
+        unsigned int decrypted_keycode = decrypt_keycode_with_salt(state->encrypted, state->pad);
+        if (BACKEND_INJECT(processor, decrypted_keycode, 1)) {
+            processor->injected++;
+        }
+        end_stage(processor, KEY_STAGE_INJECT, stage_start);
+    }
+    return verdict;
+}
+
+/**
+ * @brief 키 다운 이벤트를 처리합니다.
+ * @details 솔트 생성과 암호화, 포그라운드 프로세스 판정을 거쳐 허용된 프로세스에만 복호화된 키를 주입합니다.
+ *          키 업 전에 같은 키의 키 다운이 다시 오면 자동 반복으로 보고 빠른 경로로 처리합니다.
+ */
+static foreground_verdict handle_key_down(key_processor* processor, unsigned int original_keycode,
+                                          const char** process_name) {
+    key_state* state = (original_keycode < KEY_PROCESSOR_KEYS) ? &processor->keys[original_keycode] : NULL;
+    if (state != NULL && (state->flags & KEY_STATE_PENDING)) {
+        return handle_repeat(processor, original_keycode, state, process_name);
+    }
+    
+    unsigned long long stage_start = begin_stage(processor);
+    
+    // 솔트 생성 (Win32는 미리 생성한 키스트림 풀에서 워드 하나를 꺼내고, 솔트로는 그 위치만 받음)
+    unsigned int pad;
+    unsigned int salt = BACKEND_MAKE_SALT(processor, &pad);
+    
+    // 키 코드 암호화
+    unsigned int encrypted_keycode = encrypt_keycode_with_salt(original_keycode, pad);
+    stage_start = end_stage(processor, KEY_STAGE_CRYPTO, stage_start);
+    
+    // 현재 포커스된 프로세스 확인 (포그라운드가 바뀌지 않았다면 캐시된 판정 사용) 후 키 규칙 적용
+    // 세대는 조회 전에 읽어 두어, 조회 중에 무효화되면 다음 반복에서 다시 판정하도록 함
+    unsigned int generation = (unsigned int)kp_atomic_load(&processor->foreground->generation);
+    foreground_verdict verdict = resolve_key(processor, original_keycode, process_name);
+    stage_start = end_stage(processor, KEY_STAGE_RESOLVE, stage_start);
+    
+    // 솔트와 암호화된 키 코드, 판정 저장 (키 업 복호화와 자동 반복용)
+    if (state != NULL) {
+        state->salt = salt;
+        state->pad = pad;
+        state->encrypted = encrypted_keycode;
+        state->generation = generation;
+        state->repeats = 0;
+        state->flags = KEY_STATE_PENDING;
+        state->verdict = (unsigned char)verdict;
+    }
+    
+    report_verdict(processor, original_keycode, salt, encrypted_keycode, verdict, *process_name, 0);
+    if (verdict == FOREGROUND_ALLOWED) {
+        // 허용된 프로세스: 복호화하여 전달
+        unsigned int decrypted_keycode = decrypt_keycode_with_salt(encrypted_keycode, pad);
+        if (BACKEND_INJECT(processor, decrypted_keycode, 1)) {
+            processor->injected++;
+        }
+        end_stage(processor, KEY_STAGE_INJECT, stage_start);
+    }
+    // 허용되지 않은 프로세스이거나 프로세스 이름을 가져올 수 없는 경우: 안전을 위해 차단
+    return verdict;
+}
+
+/**
+ * @brief 키 업 이벤트를 처리합니다.
+ * @details 합쳐 둔 자동 반복 횟수를 기록하고, 허용된 프로세스라면 키 다운 때 저장한 솔트로 복호화하여 키 업을 주입합니다.
+ */
+static foreground_verdict handle_key_up(key_processor* processor, unsigned int original_keycode,
+                                        const char** process_name) {
+    unsigned long long stage_start = begin_stage(processor);
+    key_state* state = (original_keycode < KEY_PROCESSOR_KEYS) ? &processor->keys[original_keycode] : NULL;
+    if (state != NULL) {
+        flush_repeats(processor, original_keycode, state);
+    }
+    
+    // 현재 포커스된 프로세스 확인 (포그라운드가 바뀌지 않았다면 캐시된 판정 사용)
+    foreground_verdict verdict = foreground_cache_lookup(processor->foreground, process_name);
+    stage_start = end_stage(processor, KEY_STAGE_RESOLVE, stage_start);
+    
+    if (state == NULL) {
+        return verdict;
+    }
+    
+    // 키 규칙 등으로 키 다운을 주입하지 않은 키는 키 업도 보내지 않음
+    if (verdict == FOREGROUND_ALLOWED && (state->flags & KEY_STATE_PENDING) &&
+        state->verdict != FOREGROUND_ALLOWED) {
+        verdict = FOREGROUND_BLOCKED;
+    }
+    
+    // 허용된 프로세스: 복호화된 키 업 이벤트 전달
+    if (verdict == FOREGROUND_ALLOWED && (state->flags & KEY_STATE_PENDING)) {
+        unsigned int decrypted_keycode = decrypt_keycode_with_salt(state->encrypted, state->pad);
+        if (BACKEND_INJECT(processor, decrypted_keycode, 0)) {
+            processor->injected++;
+        }
+        end_stage(processor, KEY_STAGE_INJECT, stage_start);
+    }
+    
+    // 상태 초기화 (다음 키 입력을 위해)
+    memset(state, 0, sizeof(*state));
+    return verdict;
+}
+
+/**
+ * @brief 키 이벤트 하나를 처리합니다.
+ * @param processor 처리 코어
+ * @param event 처리할 키 이벤트
+ * @param process_name 판정에 사용한 프로세스 이름을 돌려받을 포인터 (NULL 가능)
+ * @return foreground_verdict 포그라운드 판정 결과
+ */
+foreground_verdict key_processor_handle(key_processor* processor, const key_event* event,
+                                        const char** process_name) {
+    const char* name = NULL;
+    foreground_verdict verdict;
+    // 조합 키 상태는 판정 뒤에 갱신 (조합 키 자체는 자신을 누르기 전 상태로 판정)
+    unsigned int modifier = key_modifier_key(event->vk_code);
+    if (key_processor_is_key_down(event->message)) {
+        verdict = handle_key_down(processor, event->vk_code, &name);
+        processor->modifier_keys |= modifier;
+    } else {
+        verdict = handle_key_up(processor, event->vk_code, &name);
+        processor->modifier_keys &= ~modifier;
+    }
+    if (process_name != NULL) {
+        *process_name = name;
+    }
+    return verdict;
+}
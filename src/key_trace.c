@@ -0,0 +1,224 @@
+#include "key_trace.h"
+
+#include <string.h>
+
+/** @brief 파일 시작을 식별하는 매직 값 */
+static const unsigned char k_trace_magic[8] = { 'K', 'P', 'T', 'R', 'A', 'C', 'E', 0 };
+
+/** @brief 헤더 크기 (바이트) */
+#define KEY_TRACE_HEADER_SIZE 16
+
+static void put_u16(unsigned char* p, unsigned int v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+}
+
+static void put_u32(unsigned char* p, unsigned long v) {
+    put_u16(p, (unsigned int)(v & 0xFFFF));
+    put_u16(p + 2, (unsigned int)((v >> 16) & 0xFFFF));
+}
+
+static void put_u64(unsigned char* p, unsigned long long v) {
+    put_u32(p, (unsigned long)(v & 0xFFFFFFFFUL));
+    put_u32(p + 4, (unsigned long)(v >> 32));
+}
+
+static unsigned int get_u16(const unsigned char* p) {
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8);
+}
+
+static unsigned long get_u32(const unsigned char* p) {
+    return (unsigned long)get_u16(p) | ((unsigned long)get_u16(p + 2) << 16);
+}
+
+static unsigned long long get_u64(const unsigned char* p) {
+    return (unsigned long long)get_u32(p) | ((unsigned long long)get_u32(p + 4) << 32);
+}
+
+/**
+ * @brief 기록용 트레이스 파일을 만들고 헤더를 씁니다.
+ * @return int 성공 시 1, 실패 시 0
+ */
+int key_trace_open_write(key_trace* trace, const char* path) {
+    memset(trace, 0, sizeof(*trace));
+    trace->last_label = KEY_TRACE_NO_LABEL;
+    trace->file = fopen(path, "wb");
+    if (trace->file == NULL) {
+        return 0;
+    }
+    trace->writing = 1;
+    
+    unsigned char header[KEY_TRACE_HEADER_SIZE] = {0};
+    memcpy(header, k_trace_magic, sizeof(k_trace_magic));
+    put_u16(header + 8, KEY_TRACE_VERSION);
+    put_u16(header + 10, KEY_TRACE_RECORD_SIZE);
+    if (fwrite(header, 1, sizeof(header), trace->file) != sizeof(header)) {
+        key_trace_close(trace);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief 재생용 트레이스 파일을 열고 헤더를 확인합니다.
+ * @return int 성공 시 1, 파일이 없거나 형식이 다르면 0
+ */
+int key_trace_open_read(key_trace* trace, const char* path) {
+    memset(trace, 0, sizeof(*trace));
+    trace->last_label = KEY_TRACE_NO_LABEL;
+    trace->file = fopen(path, "rb");
+    if (trace->file == NULL) {
+        return 0;
+    }
+    
+    unsigned char header[KEY_TRACE_HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), trace->file) != sizeof(header) ||
+        memcmp(header, k_trace_magic, sizeof(k_trace_magic)) != 0 ||
+        get_u16(header + 8) != KEY_TRACE_VERSION ||
+        get_u16(header + 10) != KEY_TRACE_RECORD_SIZE) {
+        key_trace_close(trace);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief 프로세스 이름의 라벨 번호를 찾고, 처음 보는 이름이면 정의 레코드를 씁니다.
+ * @return unsigned int 라벨 번호 (KEY_TRACE_NO_LABEL 가능)
+ */
+static unsigned int intern_label(key_trace* trace, const char* label) {
+    if (label == NULL) {
+        return KEY_TRACE_NO_LABEL;
+    }
+    // 포그라운드는 드물게 바뀌므로 직전 라벨부터 비교
+    if (trace->last_label != KEY_TRACE_NO_LABEL && strcmp(trace->labels[trace->last_label], label) == 0) {
+        return trace->last_label;
+    }
+    for (unsigned int i = 0; i < trace->label_count; i++) {
+        if (strcmp(trace->labels[i], label) == 0) {
+            trace->last_label = i;
+            return i;
+        }
+    }
+    if (trace->label_count >= KEY_TRACE_MAX_LABELS) {
+        return KEY_TRACE_NO_LABEL;
+    }
+    
+    size_t length = strlen(label);
+    if (length >= FOREGROUND_NAME_SIZE) {
+        length = FOREGROUND_NAME_SIZE - 1;
+    }
+    unsigned int id = trace->label_count;
+    unsigned char record[KEY_TRACE_RECORD_SIZE] = {0};
+    put_u16(record + 8, (unsigned int)length);
+    put_u16(record + 14, KEY_TRACE_LABEL);
+    put_u16(record + 16, id);
+    if (fwrite(record, 1, sizeof(record), trace->file) != sizeof(record) ||
+        fwrite(label, 1, length, trace->file) != length) {
+        return KEY_TRACE_NO_LABEL;
+    }
+    
+    memcpy(trace->labels[id], label, length);
+    trace->labels[id][length] = '\0';
+    trace->label_count++;
+    trace->last_label = id;
+    return id;
+}
+
+/**
+ * @brief 키 이벤트 하나를 기록합니다. (작업 스레드 전용)
+ * @details 처음 보는 프로세스 이름이면 라벨 정의 레코드를 먼저 씁니다.
+ * @param label 포그라운드 프로세스 이름 (NULL 가능)
+ * @return int 성공 시 1, 실패 시 0
+ */
+int key_trace_write(key_trace* trace, const key_event* event, const char* label) {
+    if (trace->file == NULL || !trace->writing) {
+        return 0;
+    }
+    if (trace->records == 0) {
+        trace->base_ns = event->enqueue_ns;
+    }
+    
+    unsigned int label_id = intern_label(trace, label);
+    unsigned long long relative = (event->enqueue_ns > trace->base_ns) ? event->enqueue_ns - trace->base_ns : 0;
+    
+    unsigned char record[KEY_TRACE_RECORD_SIZE] = {0};
+    put_u64(record, relative);
+    put_u16(record + 8, event->vk_code);
+    put_u16(record + 10, event->scan_code);
+    put_u16(record + 12, event->flags);
+    put_u16(record + 14, event->message);
+    put_u16(record + 16, label_id);
+    put_u32(record + 20, event->time);
+    if (fwrite(record, 1, sizeof(record), trace->file) != sizeof(record)) {
+        return 0;
+    }
+    trace->records++;
+    return 1;
+}
+
+/**
+ * @brief 다음 키 레코드를 읽습니다.
+ * @details 라벨 정의 레코드는 내부에서 처리하고 건너뜁니다.
+ * @return int 읽었으면 1, 파일 끝이면 0, 형식 오류면 -1
+ */
+int key_trace_read(key_trace* trace, key_trace_record* record) {
+    if (trace->file == NULL || trace->writing) {
+        return -1;
+    }
+    
+    for (;;) {
+        unsigned char raw[KEY_TRACE_RECORD_SIZE];
+        size_t got = fread(raw, 1, sizeof(raw), trace->file);
+        if (got == 0) {
+            return 0;
+        }
+        if (got != sizeof(raw)) {
+            return -1;
+        }
+        
+        unsigned int message = get_u16(raw + 14);
+        if (message == KEY_TRACE_LABEL) {
+            unsigned int length = get_u16(raw + 8);
+            unsigned int id = get_u16(raw + 16);
+            if (id != trace->label_count || id >= KEY_TRACE_MAX_LABELS || length >= FOREGROUND_NAME_SIZE ||
+                fread(trace->labels[id], 1, length, trace->file) != length) {
+                return -1;
+            }
+            trace->labels[id][length] = '\0';
+            trace->label_count++;
+            continue;
+        }
+        
+        record->timestamp_ns = get_u64(raw);
+        record->vk_code = get_u16(raw + 8);
+        record->scan_code = get_u16(raw + 10);
+        record->flags = get_u16(raw + 12);
+        record->message = message;
+        record->label = (unsigned short)get_u16(raw + 16);
+        record->time = (unsigned int)get_u32(raw + 20);
+        trace->records++;
+        return 1;
+    }
+}
+
+/**
+ * @brief 라벨 번호에 해당하는 프로세스 이름을 반환합니다.
+ * @return const char* 프로세스 이름 (정의되지 않은 라벨이면 NULL)
+ */
+const char* key_trace_label(const key_trace* trace, unsigned int label) {
+    if (label >= trace->label_count) {
+        return NULL;
+    }
+    return trace->labels[label];
+}
+
+/**
+ * @brief 트레이스 파일을 닫습니다.
+ */
+void key_trace_close(key_trace* trace) {
+    if (trace->file != NULL) {
+        fclose(trace->file);
+        trace->file = NULL;
+    }
+}
@@ -1,4 +1,26 @@
 #include "keyboard_protector.h"
+#include "win32_backend.h"
+#include "foreground_cache.h"
+#include "log_ring.h"
+#include "policy_store.h"
+#include "policy_loader.h"
+#include "config_reloader.h"
+#include "key_pipeline.h"
+#include "key_processor.h"
+#include "key_trace.h"
+#include "keystream.h"
+#include "stats_block.h"
+#include "key_journal.h"
+#include "control_channel.h"
+#include "key_delivery.h"
+#include "hook_governor.h"
+#include "shadow_audit.h"
+#include "device_table.h"
+#include "input_correlator.h"
+#include "inject_batch.h"
+#include "kp_config.h"
+#include "kp_platform.h"
+#include "kp_atomic.h"
 
 /**
  * @brief 전역 키보드 후크 핸들
@@ -12,304 +34,1705 @@ HHOOK g_keyboardHook = NULL;
 volatile BOOL g_running = TRUE;
 
 /**
- * @brief 키 코드별 솔트 값 저장 (최대 256개 키)
- * @details 각 키 코드에 대한 솔트를 저장하여 키 업 이벤트에서 복호화할 수 있도록 합니다.
+ * @brief 종료 요청 이유
  */
-static unsigned int g_keySalt[256] = {0};
+typedef enum ShutdownReason {
+    SHUTDOWN_NONE = 0,     /**< 종료 요청 없음 */
+    SHUTDOWN_EXIT_KEY,     /**< 종료 키가 눌림 */
+    SHUTDOWN_CONTROL       /**< 제어 채널의 종료 요청 */
+} ShutdownReason;
+
+static volatile LONG g_shutdownReason = SHUTDOWN_NONE;
+
+/**
+ * @brief 종료 요청 이벤트 (수동 리셋)
+ * @details 후크와 제어 채널은 이 이벤트만 신호하고, 후크 해제와 정리는 이벤트 루프가 빠져나온 뒤 수행합니다.
+ */
+static HANDLE g_shutdownEvent = NULL;
+
+/** @brief 이벤트 루프가 주기적으로 깨어나 정리 작업을 하는 간격 (밀리초) */
+#define EVENT_LOOP_TICK_MS 1000
+
+/**
+ * @brief 로컬 제어 채널 (이름 있는 파이프)
+ */
+static control_server g_controlServer;
+static BOOL g_controlEnabled = FALSE;
+static char g_controlName[CONTROL_NAME_SIZE] = CONTROL_CHANNEL_NAME;
+
+/** @brief 동시에 열 수 있는 공유 메모리 전달 채널 수 */
+#define MAX_DELIVERY_CHANNELS 8
+
+/**
+ * @brief 전달 채널 슬롯 상태
+ */
+typedef enum DeliverySlotState {
+    DELIVERY_SLOT_FREE = 0,    /**< 비어 있음 */
+    DELIVERY_SLOT_ACTIVE,      /**< 작업 스레드가 키를 넣을 수 있음 */
+    DELIVERY_SLOT_CLOSING      /**< 이벤트 루프가 닫는 중 (작업 스레드는 새로 사용하지 않음) */
+} DeliverySlotState;
+
+/**
+ * @brief 구독한 애플리케이션 하나의 전달 채널
+ * @details 이벤트 루프 스레드만 열고 닫으며, 작업 스레드는 ACTIVE 상태인 동안 users를 올려 두고 키를 넣습니다.
+ */
+typedef struct DeliverySlot {
+    LONG state;                       /**< DeliverySlotState 값 */
+    LONG users;                       /**< 채널을 사용 중인 작업 스레드 수 (0 또는 1) */
+    DWORD processId;                  /**< 구독한 프로세스 ID */
+    unsigned long long startTime;     /**< 구독한 프로세스 생성 시각 (PID 재사용 구분) */
+    key_delivery_channel channel;     /**< 공유 메모리 링 */
+} DeliverySlot;
+
+static DeliverySlot g_deliverySlots[MAX_DELIVERY_CHANNELS];
+
+/**
+ * @brief 공유 메모리 전달 통계 (작업 스레드가 갱신)
+ */
+typedef struct DeliveryStats {
+    unsigned long delivered;   /**< 링으로 전달한 키 이벤트 */
+    unsigned long fallbacks;   /**< 링이 가득 차서 SendInput으로 대신 주입한 키 이벤트 */
+} DeliveryStats;
+
+static DeliveryStats g_deliveryStats = {0, 0};
+
+/**
+ * @brief 복호화된 키 주입 묶음 (작업 스레드 전용)
+ * @details 작업 스레드가 깨어나 처리하는 동안의 키를 모아 SendInput 한 번으로 주입하며,
+ *          큐가 비면 바로 주입하므로 키 하나만 들어온 경우에는 지연이 늘지 않습니다.
+ */
+static inject_batch g_injectBatch;
+
+/**
+ * @brief 후크 지연 예산 관리자 (후크/작업 스레드가 표본을 넣고 감시 스레드가 판정)
+ */
+static hook_governor g_hookGovernor;
+
+/** @brief 후크 호출 지연을 셀 때 무시하는 GetTickCount 해상도 오차 (밀리초) */
+#define HOOK_DISPATCH_TICK_SLACK_MS 32
+
+/** @brief 감시 스레드가 깨어나 구간을 마감하는 간격 (밀리초) */
+#define WATCHDOG_PERIOD_MS 250
+
+/**
+ * @brief 후크 감시 스레드
+ * @details 후크 설치는 메시지 루프 스레드에서 해야 하므로, 감시 스레드는 g_hookReinstallEvent만 신호합니다.
+ */
+static kp_thread g_watchdogThread;
+static kp_event g_watchdogWake;
+static volatile int g_watchdogStop = 0;
+static BOOL g_watchdogRunning = FALSE;
+static HANDLE g_hookReinstallEvent = NULL;
+
+// Windows XP SDK 헤더에 없는 Raw Input 장치 알림 정의 (Vista 이상)
+#ifndef RIDEV_DEVNOTIFY
+#define RIDEV_DEVNOTIFY 0x00002000
+#endif
+#ifndef WM_INPUT_DEVICE_CHANGE
+#define WM_INPUT_DEVICE_CHANGE 0x00FE
+#endif
+#ifndef GIDC_REMOVAL
+#define GIDC_REMOVAL 2
+#endif
+#ifndef KEYBOARD_OVERRUN_MAKE_CODE
+#define KEYBOARD_OVERRUN_MAKE_CODE 0xFF
+#endif
+
+/**
+ * @brief 입력 장치 추적 (Raw Input)
+ * @details 메시지 전용 창으로 받은 WM_INPUT의 장치 핸들로 장치 테이블을 채우고, 후크 이벤트와 짝지어
+ *          장치 분류를 key_event.tag에 실어 작업 스레드로 보냅니다. 테이블과 짝짓기 상태는 후크와 같은
+ *          이벤트 루프 스레드에서만 사용합니다.
+ */
+static device_table g_deviceTable;
+static input_correlator g_inputCorrelator;
+static HWND g_rawInputWindow = NULL;
+static BOOL g_rawInputEnabled = FALSE;
+
+/**
+ * @brief 이벤트 루프가 쓰는 장치 규칙 ([Devices])
+ * @details 정책은 어느 스레드에서든 게시될 수 있으므로, 게시할 때 복사본을 g_pendingDeviceRules에 넣고
+ *          이벤트 루프가 다음 반복에서 꺼내 반영합니다.
+ */
+static device_rules g_deviceRules;
+static device_rules* g_pendingDeviceRules = NULL;
+
+/**
+ * @brief 장치별 처리 통계
+ */
+typedef struct DeviceStats {
+    unsigned long noHandle;         /**< 장치 핸들이 없어 건너뛴 WM_INPUT (주입된 입력) */
+    unsigned long tableFull;        /**< 장치 테이블이 가득 차 등록하지 못한 장치의 키 */
+    unsigned long untrustedBlocked; /**< 신뢰하지 않는 장치에서 와서 차단한 키 */
+    unsigned long trustedKeys;      /**< 신뢰 장치의 키 (키 단위 로그 생략) */
+    unsigned long trustedLogSkipped; /**< 신뢰 장치의 키라서 생략한 키 단위 로그 (작업 스레드가 갱신) */
+    unsigned long unknownDefault;   /**< 장치를 알 수 없어 Default 분류를 적용한 하드웨어 키 */
+} DeviceStats;
+
+static DeviceStats g_deviceStats = {0, 0, 0, 0, 0, 0};
+
+/**
+ * @brief 작업 스레드가 처리 중인 키가 신뢰 장치의 키인지 여부 (작업 스레드 전용)
+ */
+static BOOL g_trustedKey = FALSE;
+
+#if KP_FEATURE_SHADOW
+/** @brief 그림자 집계 보고서를 주기적으로 다시 쓰는 간격 (밀리초) */
+#define SHADOW_REPORT_INTERVAL_MS (10 * 60 * 1000)
+
+/** @brief 그림자 집계 보고서 기본 파일 이름 (config.ini와 같은 디렉토리) */
+#define SHADOW_REPORT_DEFAULT "shadow_report.csv"
+
+/**
+ * @brief 그림자(감사 전용) 모드 여부
+ * @details TRUE이면 후크는 모든 키를 그대로 통과시키고, 작업 스레드는 주입 없이 판정만 집계합니다.
+ *          [Shadow] Enabled 또는 --shadow로 켜며 시작할 때만 반영합니다.
+ */
+static BOOL g_shadowMode = FALSE;
+static BOOL g_shadowRequested = FALSE;
+
+/**
+ * @brief 그림자 집계 (프로세스별/키 분류별 현재 정책과 후보 정책 판정)
+ */
+static shadow_audit g_shadowAudit;
+
+/**
+ * @brief 후보 정책 저장소 ([Shadow] Candidate, 작업 스레드가 유일한 읽기 스레드)
+ */
+static policy_store g_candidateStore;
+static int g_shadowCandidate = 0;
+
+/**
+ * @brief 그림자 집계 보고서 경로와 다음 주기 기록 시각
+ */
+static char g_shadowReportPath[MAX_PATH] = {0};
+static unsigned long long g_nextShadowReportNs = 0;
+#endif // KP_FEATURE_SHADOW
+
+/**
+ * @brief 후크를 설치한 시각 (kp_now_ns, 제어 채널의 가동 시간 계산용)
+ */
+static unsigned long long g_startNs = 0;
+
+/**
+ * @brief 주입된 키 입력 처리 통계
+ */
+typedef struct InjectionStats {
+    unsigned long selfPassed;      /**< 서명이 일치하여 빠른 경로로 통과한 자체 주입 키 */
+    unsigned long foreignPassed;   /**< 정책에 따라 그대로 통과한 외부 주입 키 */
+    unsigned long foreignBlocked;  /**< 정책에 따라 차단한 외부 주입 키 */
+    unsigned long foreignProcessed;/**< 실제 키 입력과 같이 처리한 외부 주입 키 */
+} InjectionStats;
+
+static InjectionStats g_injectionStats = {0, 0, 0, 0};
+
+/**
+ * @brief 후크가 읽는 외부 주입 키 처리 방식 (policy_injection 값)
+ * @details 정책 스냅샷은 작업 스레드만 참조하므로, 후크에 필요한 이 값만 게시 시 따로 복사합니다.
+ */
+static int g_foreignInjectionPolicy = POLICY_INJECTION_PROCESS;
+/** @brief 종료 키 가상 키 코드 (후크에서 읽도록 게시 시 원자적으로 갱신, 0이면 종료 키 없음) */
+static unsigned int g_exitKey = KEY_POLICY_DEFAULT_EXIT_KEY;
+/**
+ * @brief 제어 채널 통계에 보고할 정책 버전과 허용 프로세스 수
+ * @details 정책 저장소의 읽기 스레드는 작업 스레드 하나뿐이므로, 이벤트 루프는 저장소에 진입하지 않고 게시 시 복사한 이 값을 읽습니다.
+ */
+static unsigned long g_publishedPolicyVersion = 0;
+static unsigned long g_publishedAllowedCount = 0;
+
+/** @brief 후크가 비교할 종료 키 (KP_EXIT_KEY로 고정한 빌드에서는 상수이므로 0이면 검사가 빠짐) */
+#if KP_EXIT_KEY == KP_EXIT_KEY_RUNTIME
+#define CURRENT_EXIT_KEY() kp_atomic_load_relaxed(&g_exitKey)
+#else
+#define CURRENT_EXIT_KEY() ((unsigned int)KP_EXIT_KEY)
+#endif
+
+/**
+ * @brief 후크 → 작업 스레드 키 이벤트 파이프라인
+ * @details 후크는 이벤트를 큐에 복사하고 바로 차단을 반환하며, 나머지 처리는 작업 스레드가 담당합니다.
+ */
+static key_pipeline g_keyPipeline;
+
+/**
+ * @brief 작업 스레드의 키 이벤트 처리 코어 (솔트, 암호화, 판정, 주입)
+ */
+static key_processor g_keyProcessor;
+
+/**
+ * @brief 세션 키로 미리 생성해 두는 ChaCha20 키스트림 풀
+ * @details 백그라운드 스레드가 블록을 채우고, 작업 스레드는 키 다운마다 워드 하나를 꺼내 XOR합니다.
+ */
+static keystream_pool g_keystreamPool;
+
+/**
+ * @brief 단계별 지연 히스토그램과 판정 카운터를 담는 통계 블록
+ * @details 공유 메모리(KP_STATS_SHM_NAME)에 두어 tools/stats_reader가 실행 중에 읽을 수 있습니다.
+ */
+static kp_stats_block* g_statsBlock = NULL;
+static kp_shared_memory g_statsMemory;
+static kp_stats_block g_localStatsBlock;
+
+#if KP_FEATURE_TRACE
+/**
+ * @brief 키 입력 트레이스 기록 파일 (--record 지정 시, 작업 스레드에서만 기록)
+ */
+static key_trace g_traceRecorder;
+static BOOL g_traceRecording = FALSE;
+#endif // KP_FEATURE_TRACE
+
+/**
+ * @brief 현재 정책 스냅샷 저장소
+ * @details 설정 재로드 스레드가 새 스냅샷을 원자적으로 게시하고, 후크는 잠금 없이 읽습니다.
+ */
+static policy_store g_policyStore;
+
+/**
+ * @brief 작업 스레드가 이벤트를 처리하는 동안 참조하는 정책 스냅샷 (작업 스레드 전용)
+ */
+static policy_snapshot* g_activePolicy = NULL;
+
+/**
+ * @brief config.ini 변경 감시 및 핫 리로드
+ * @details 별도 스레드 없이 이벤트 루프가 변경 알림 핸들을 기다리며, 정책 게시는 모두 이벤트 루프 스레드에서 일어납니다.
+ */
+static config_reloader g_configReloader;
+static BOOL g_configWatchEnabled = FALSE;
+
+/**
+ * @brief 현재 정책을 읽은 설정 파일 경로 (리로드 감시 대상, [Shadow] 상대 경로의 기준)
+ */
+static char g_configPath[MAX_PATH] = {0};
+
+/**
+ * @brief 마지막 설정 파일 변경 뒤 리로드할 시각 (kp_now_ns, 0이면 예정된 리로드 없음)
+ */
+static unsigned long long g_reloadDeadlineNs = 0;
+
+/**
+ * @brief 후크에서 기록하는 비동기 로그 링
+ * @details 후크는 고정 크기 레코드만 기록하고, 드레인 스레드가 포맷팅과 출력을 담당합니다.
+ */
+static log_ring g_logRing;
+
+#if KP_FEATURE_KEY_LOG
+/**
+ * @brief 로그 드레인 스레드
+ */
+static kp_thread g_logThread;
+
+/**
+ * @brief 로그 드레인 스레드 종료 요청 플래그
+ */
+static volatile int g_logThreadStop = 0;
+
+/**
+ * @brief 로그 출력 파일 ([Logging] LogFile, 없으면 콘솔 출력)
+ */
+static FILE* g_logFile = NULL;
+
+/**
+ * @brief 키 다운 판정을 세그먼트 파일로 남기는 이진 저널 ([Logging] JournalDir 지정 시)
+ * @details 작업 스레드는 레코드를 링에 넣기만 하고, 블록 단위 기록과 세그먼트 교체는 저널 스레드가 담당합니다.
+ */
+static key_journal_writer g_journal;
+static BOOL g_journalEnabled = FALSE;
+
+/**
+ * @brief 마지막으로 인턴한 프로세스 이름의 인덱스와, 그때의 판정 캐시 조회 횟수
+ * @details 판정 캐시가 프로세스 이름을 새로 조회했을 때만 이름을 다시 인턴합니다.
+ */
+static unsigned short g_logNameId = LOG_NAME_NONE;
+static unsigned long g_logNameLookups = 0;
+#endif // KP_FEATURE_KEY_LOG
+
+/**
+ * @brief 포그라운드 프로세스 판정 캐시
+ * @details EVENT_SYSTEM_FOREGROUND 알림이나 설정 재로드 시 무효화되며,
+ *          그 사이의 키 입력은 세대 비교 한 번으로 허용 여부를 결정합니다.
+ */
+static foreground_cache g_foregroundCache;
+
+/**
+ * @brief 포그라운드 변경 알림을 받는 WinEvent 후크 핸들
+ */
+static HWINEVENTHOOK g_foregroundEventHook = NULL;
+
+/**
+ * @brief 프로세스에 적용할 키 규칙을 찾습니다.
+ * @param processName 확인할 프로세스 이름
+ * @return unsigned int 허용되지 않은 프로세스면 0, 허용된 프로세스면 키 규칙 번호 + 1
+ */
+static unsigned int LookupProcessRule(const char* processName) {
+    if (processName == NULL) {
+        return 0;
+    }
+    
+    // 작업 스레드가 이벤트를 처리하는 중에는 이미 참조 중인 스냅샷을 사용
+    if (g_activePolicy != NULL) {
+        return allowlist_value(&g_activePolicy->allowed, processName);
+    }
+    
+    // 해시 테이블 조회 (대소문자 구분 없음, 항목 수와 무관하게 O(1))
+    policy_snapshot* policy = policy_store_enter(&g_policyStore);
+    unsigned int rule = (policy != NULL) ? allowlist_value(&policy->allowed, processName) : 0;
+    policy_store_exit(&g_policyStore);
+    return rule;
+}
+
+/**
+ * @brief 이벤트 루프 스레드에서 프로세스의 키 규칙을 찾습니다.
+ * @details 정책 게시는 모두 이벤트 루프 스레드에서 일어나므로, 작업 스레드 전용인 g_activePolicy나
+ *          읽기 스레드 하나만 허용하는 저장소 진입 없이 현재 스냅샷을 그대로 읽습니다.
+ * @return unsigned int 허용되지 않은 프로세스면 0, 허용된 프로세스면 키 규칙 번호 + 1
+ */
+static unsigned int LookupPublishedRule(const char* processName) {
+    const policy_snapshot* policy = policy_store_current(&g_policyStore);
+    return (processName != NULL && policy != NULL) ? allowlist_value(&policy->allowed, processName) : 0;
+}
+
+/**
+ * @brief 판정 캐시에서 사용하는 허용 여부 콜백
+ * @return int 차단이면 0, 허용이면 키 규칙 번호 + 1
+ */
+static int AllowedProcessVerdict(const char* processName, void* user) {
+    (void)user;
+    return (int)LookupProcessRule(processName);
+}
+
+/**
+ * @brief 포그라운드 창이 바뀔 때 호출되는 WinEvent 콜백
+ * @details 판정 캐시를 무효화하여 다음 키 입력에서 프로세스를 다시 확인하도록 합니다.
+ */
+static void CALLBACK ForegroundChangedProc(HWINEVENTHOOK hWinEventHook, DWORD event, HWND hwnd,
+                                           LONG idObject, LONG idChild,
+                                           DWORD idEventThread, DWORD dwmsEventTime) {
+    (void)hWinEventHook; (void)event; (void)hwnd; (void)idObject;
+    (void)idChild; (void)idEventThread; (void)dwmsEventTime;
+    foreground_cache_invalidate(&g_foregroundCache);
+}
+
+/**
+ * @brief 사용할 INI 파일 경로를 결정합니다.
+ * @param iniFilePath 지정된 INI 파일 경로 (NULL이면 실행 파일과 같은 디렉토리의 config.ini)
+ * @param configPath 결정된 경로를 저장할 버퍼 (MAX_PATH)
+ */
+static void ResolveConfigPath(const char* iniFilePath, char* configPath) {
+    if (iniFilePath == NULL || iniFilePath[0] == '\0') {
+        // 실행 파일과 같은 디렉토리에 config.ini 파일 사용
+        GetModuleFileNameA(NULL, configPath, MAX_PATH);
+        char* lastSlash = strrchr(configPath, '\\');
+        if (lastSlash != NULL) {
+            *(lastSlash + 1) = '\0';
+        }
+        strcat_s(configPath, MAX_PATH, "config.ini");
+    } else if (configPath != iniFilePath) {
+        strcpy_s(configPath, MAX_PATH, iniFilePath);
+    }
+}
+
+#if KP_FEATURE_SHADOW
+/**
+ * @brief [Shadow] 경로 값을 현재 설정 파일 기준 경로로 바꿉니다.
+ * @param value 설정 값 (비어 있으면 defaultName 사용)
+ * @param defaultName 기본 파일 이름
+ * @param path 결과 경로 (MAX_PATH 크기)
+ */
+static void ResolveShadowPath(const char* value, const char* defaultName, char* path) {
+    if (g_configPath[0] == '\0') {
+        ResolveConfigPath(NULL, g_configPath);
+    }
+    shadow_audit_resolve_path(g_configPath, value, defaultName, path, MAX_PATH);
+}
+#endif // KP_FEATURE_SHADOW
+
+#if KP_FEATURE_KEY_LOG
+/**
+ * @brief 로그 드레인 스레드 함수
+ * @details 로그 링에 쌓인 레코드를 주기적으로 포맷팅하여 콘솔 또는 파일에 출력합니다.
+ */
+static void LogDrainThread(void* arg) {
+    (void)arg;
+    FILE* out = (g_logFile != NULL) ? g_logFile : stdout;
+    int withTimestamp = (g_logFile != NULL);
+    
+    while (!g_logThreadStop) {
+        if (log_ring_drain(&g_logRing, out, withTimestamp) == 0) {
+            kp_sleep_ms(10);
+        }
+    }
+    // 종료 직전에 남은 레코드 출력
+    log_ring_drain(&g_logRing, out, withTimestamp);
+}
+
+/**
+ * @brief 현재 정책의 [Logging] LogFile 설정에 따라 로그 드레인 스레드를 시작합니다.
+ * @details 로그 파일은 시작할 때만 열며, 이후 리로드에서는 상세 수준만 반영됩니다.
+ * @return BOOL 드레인 스레드 시작에 성공하면 TRUE
+ */
+static BOOL StartLogging(void) {
+    policy_snapshot* policy = policy_store_enter(&g_policyStore);
+    if (policy != NULL && policy->log_file[0] != '\0') {
+        g_logFile = fopen(policy->log_file, "a");
+        if (g_logFile == NULL) {
+            fprintf(stderr, "[경고] 로그 파일을 열 수 없습니다: %s (콘솔에 출력합니다)\n", policy->log_file);
+        } else {
+            printf("[설정] 로그 파일: %s\n", policy->log_file);
+        }
+    }
+    if (policy != NULL && policy->journal_dir[0] != '\0') {
+        // 저널 키 파일이 있으면 세션 키를 감싸 세그먼트 헤더에 넣음 (없으면 솔트(위치)만 남아 복호화 불가)
+        key_journal_key_info keyInfo;
+        memset(&keyInfo, 0, sizeof(keyInfo));
+        keyInfo.nonce = g_keystreamPool.nonce;
+        if (policy->journal_key_file[0] != '\0') {
+            uint32_t journalKey[8];
+            if (key_journal_read_key_file(policy->journal_key_file, journalKey)) {
+                key_journal_wrap_key(&keyInfo, journalKey, g_keystreamPool.key, g_keystreamPool.nonce);
+                SecureZeroMemory(journalKey, sizeof(journalKey));
+            } else {
+                fprintf(stderr, "[경고] 저널 키 파일을 읽을 수 없습니다: %s (저널을 복호화할 수 없습니다)\n",
+                        policy->journal_key_file);
+            }
+        }
+        if (key_journal_writer_start(&g_journal, policy->journal_dir, policy->journal_segment_mb * 1024UL * 1024UL,
+                                     &keyInfo)) {
+            // 작업 스레드는 이미 실행 중이므로 기록기 초기화가 끝난 뒤 게시
+            kp_atomic_store(&g_journalEnabled, TRUE);
+            printf("[설정] 키 입력 저널: %s\n", policy->journal_dir);
+        } else {
+            fprintf(stderr, "[경고] 키 입력 저널 스레드를 시작할 수 없습니다.\n");
+        }
+    }
+    policy_store_exit(&g_policyStore);
+    
+    g_logThreadStop = 0;
+    if (!kp_thread_start(&g_logThread, LogDrainThread, NULL)) {
+        fprintf(stderr, "[경고] 로그 드레인 스레드를 시작할 수 없습니다. 키 단위 로그를 끕니다.\n");
+        log_ring_set_verbosity(&g_logRing, LOG_VERBOSITY_OFF);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief 로그 드레인 스레드를 멈추고 남은 로그를 출력합니다.
+ */
+static void StopLogging(void) {
+    g_logThreadStop = 1;
+    kp_thread_join(&g_logThread);
+    if (g_logFile != NULL) {
+        fclose(g_logFile);
+        g_logFile = NULL;
+    }
+    if (g_journalEnabled) {
+        key_journal_stats stats;
+        g_journalEnabled = FALSE;
+        key_journal_writer_stop(&g_journal);
+        key_journal_writer_get_stats(&g_journal, &stats);
+        printf("[통계] 저널: 레코드 %lu | 블록 %lu | 세그먼트 %lu | 손실 %lu | 쓰기 실패 %lu\n",
+               stats.records, stats.blocks, stats.segments, stats.dropped, stats.write_errors);
+    }
+}
+#endif // KP_FEATURE_KEY_LOG
+
+#if KP_FEATURE_SHADOW
+/**
+ * @brief 그림자 집계 보고서를 CSV로 씁니다.
+ * @details 임시 파일에 다 쓴 뒤 교체하므로, 기록 중에 종료되어도 이전 보고서는 남습니다.
+ * @return BOOL 성공 시 TRUE
+ */
+static BOOL WriteShadowReport(void) {
+    char tempPath[MAX_PATH + 4];
+    sprintf_s(tempPath, sizeof(tempPath), "%s.tmp", g_shadowReportPath);
+    FILE* out = fopen(tempPath, "w");
+    if (out == NULL) {
+        fprintf(stderr, "[경고] 그림자 집계 보고서를 쓸 수 없습니다: %s\n", g_shadowReportPath);
+        return FALSE;
+    }
+    int written = shadow_audit_write_report(&g_shadowAudit, out);
+    if (fclose(out) != 0 || !written ||
+        !MoveFileExA(tempPath, g_shadowReportPath, MOVEFILE_REPLACE_EXISTING)) {
+        fprintf(stderr, "[경고] 그림자 집계 보고서를 쓸 수 없습니다: %s\n", g_shadowReportPath);
+        DeleteFileA(tempPath);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief 현재 정책의 [Shadow] 설정과 --shadow에 따라 그림자 모드와 보고서 경로를 정합니다.
+ * @details 후크를 설치하기 전에 호출합니다. 후보 정책만 지정하고 그림자 모드를 켜지 않으면
+ *          키는 지금처럼 차단/주입하면서 후보 정책 판정만 나란히 집계합니다.
+ */
+static void StartShadowAudit(void) {
+    policy_snapshot* policy = policy_store_enter(&g_policyStore);
+    g_shadowMode = g_shadowRequested || (policy != NULL && policy->shadow_enabled);
+    ResolveShadowPath((policy != NULL) ? policy->shadow_report : "", SHADOW_REPORT_DEFAULT, g_shadowReportPath);
+    policy_store_exit(&g_policyStore);
+    
+    g_nextShadowReportNs = kp_now_ns() + SHADOW_REPORT_INTERVAL_MS * 1000000ULL;
+    if (g_shadowMode) {
+        printf("[그림자] 감사 전용 모드: 키 입력을 차단하지 않고 정책 판정만 집계합니다.\n");
+    }
+    if (g_shadowMode || g_shadowCandidate) {
+        printf("[그림자] 집계 보고서: %s\n", g_shadowReportPath);
+    }
+}
+
+/**
+ * @brief 그림자(감사 전용) 모드를 켭니다.
+ */
+void EnableShadowMode(void) {
+    g_shadowRequested = TRUE;
+}
+#endif // KP_FEATURE_SHADOW
+
+#if KP_FEATURE_KEY_LOG
+/**
+ * @brief 키 다운 이벤트를 로그 링에 기록합니다. (작업 스레드 전용)
+ * @details 포맷팅과 할당 없이 고정 크기 레코드만 기록합니다. 자동 반복은 키 업 때 횟수와 함께 한 번만 기록됩니다.
+ */
+static void LogKeyEvent(unsigned int keycode, unsigned int salt, unsigned int encryptedKeycode,
+                        int verdict, const char* processName, unsigned int repeats) {
+    if (!log_ring_wants(&g_logRing, verdict)) {
+        return;
+    }
+    // 지연 예산을 넘는 동안에는 허용된 키의 상세 로그를 생략 (차단/조회 실패는 계속 기록)
+    if (verdict == LOG_VERDICT_ALLOWED && hook_governor_level(&g_hookGovernor) >= HOOK_LEVEL_QUIET_LOG) {
+        return;
+    }
+    
+    // 판정 캐시가 프로세스 이름을 새로 조회한 경우에만 이름을 다시 인턴
+    if (processName != NULL && g_foregroundCache.lookups != g_logNameLookups) {
+        g_logNameId = log_ring_intern_name(&g_logRing, processName);
+        g_logNameLookups = g_foregroundCache.lookups;
+    }
+    
+    log_record record;
+    record.timestamp_ns = kp_now_ns();
+    record.salt = salt;
+    record.encrypted_keycode = encryptedKeycode;
+    record.vk_code = (unsigned short)keycode;
+    record.name_id = (processName != NULL) ? g_logNameId : LOG_NAME_NONE;
+    record.verdict = (unsigned char)verdict;
+    record.reserved = 0;
+    record.repeats = (unsigned short)repeats;
+    log_ring_write(&g_logRing, &record);
+}
+
+/**
+ * @brief 키 다운 판정을 이진 저널에 넣습니다. (작업 스레드 전용)
+ * @details 로그 상세 수준과 관계없이 모든 판정을 기록하며, 링이 가득 차면 기다리지 않고 버립니다.
+ */
+static void JournalKeyEvent(unsigned int salt, unsigned int encryptedKeycode, int verdict, const char* processName) {
+    if (!kp_atomic_load(&g_journalEnabled)) {
+        return;
+    }
+    key_journal_entry entry;
+    entry.timestamp_ns = kp_now_ns();
+    entry.encrypted_keycode = encryptedKeycode;
+    entry.salt = salt;
+    entry.name_id = key_journal_intern_name(&g_journal, processName);
+    entry.verdict = (unsigned char)verdict;
+    entry.reserved = 0;
+    key_journal_append(&g_journal, &entry);
+}
+#endif // KP_FEATURE_KEY_LOG
+
+#if KP_FEATURE_SHADOW
+/**
+ * @brief [Shadow] Candidate 후보 정책을 로드하여 후보 정책 저장소에 게시합니다. (게시 스레드)
+ * @details 후보 정책 파일이 없으면 이전 후보 정책을 유지하고, 설정에서 항목을 지우면 후보 정책을 내립니다.
+ */
+static void LoadShadowCandidate(const policy_snapshot* snapshot) {
+    if (snapshot->shadow_candidate[0] == '\0') {
+        if (g_shadowCandidate) {
+            kp_atomic_store(&g_shadowCandidate, 0);
+            policy_store_publish(&g_candidateStore, NULL);
+            printf("[그림자] 후보 정책을 내렸습니다.\n");
+        }
+        return;
+    }
+    
+    char path[MAX_PATH] = {0};
+    ResolveShadowPath(snapshot->shadow_candidate, "", path);
+    policy_load_status status = POLICY_LOAD_OK;
+    // 후보 정책의 항목별 안내는 현재 정책 안내와 헷갈리므로 생략
+    policy_load_set_quiet(1);
+    policy_snapshot* candidate = policy_load_file(path, &status);
+    policy_load_set_quiet(0);
+    if (candidate == NULL) {
+        return;
+    }
+    if (status == POLICY_LOAD_MISSING) {
+        fprintf(stderr, "[경고] 후보 정책 파일이 없습니다: %s\n", path);
+        policy_snapshot_destroy(candidate);
+        return;
+    }
+    policy_store_publish(&g_candidateStore, candidate);
+    kp_atomic_store(&g_shadowCandidate, 1);
+    printf("[그림자] 후보 정책 버전 %lu 적용: %s (허용 프로세스 %lu개, 키 규칙 %u개)\n", candidate->version, path,
+           allowlist_count(&candidate->allowed), candidate->keys.count - 1);
+}
+#endif // KP_FEATURE_SHADOW
+
+/**
+ * @brief 게시된 장치 규칙을 이벤트 루프에 넘깁니다.
+ * @details 이벤트 루프가 아직 꺼내지 않은 이전 규칙은 새 규칙으로 바꾸고 해제합니다.
+ */
+static void QueueDeviceRules(const device_rules* rules) {
+    device_rules* copy = (device_rules*)malloc(sizeof(device_rules));
+    if (copy == NULL) {
+        fprintf(stderr, "[경고] 장치 규칙을 반영할 메모리가 부족합니다.\n");
+        return;
+    }
+    *copy = *rules;
+    device_rules* previous = kp_atomic_exchange(&g_pendingDeviceRules, copy);
+    free(previous);
+}
+
+/**
+ * @brief 이벤트 루프가 넘겨받은 장치 규칙을 반영하고 등록된 장치를 다시 분류합니다. (이벤트 루프 스레드)
+ */
+static void ApplyPendingDeviceRules(void) {
+    device_rules* rules = kp_atomic_exchange(&g_pendingDeviceRules, (device_rules*)NULL);
+    if (rules == NULL) {
+        return;
+    }
+    g_deviceRules = *rules;
+    free(rules);
+    // 차단할 장치가 있으면 장치를 알기 전에 키를 넘기지 않도록 학습 없이 붙잡음
+    input_correlator_require_hold(&g_inputCorrelator, device_rules_has_untrusted(&g_deviceRules));
+    int changed = device_table_classify(&g_deviceTable, &g_deviceRules);
+    if (changed > 0) {
+        printf("[장치] 규칙 변경으로 장치 %d개의 분류가 바뀌었습니다.\n", changed);
+    }
+}
+
+/**
+ * @brief 새 정책이 게시된 뒤 후크 쪽 상태를 갱신합니다.
+ * @details 캐시된 판정을 무효화하고 로그 상세 수준을 반영합니다. 어느 스레드에서든 호출할 수 있습니다.
+ */
+static void OnPolicyPublished(const policy_snapshot* snapshot, void* user) {
+    (void)user;
+    foreground_cache_invalidate(&g_foregroundCache);
+    if (snapshot != NULL) {
+        log_ring_set_verbosity(&g_logRing, snapshot->log_verbosity);
+        hook_governor_set_budget(&g_hookGovernor, (uint64_t)((snapshot->hook_budget_us != 0) ?
+            snapshot->hook_budget_us : HOOK_GOVERNOR_DEFAULT_BUDGET_US) * 1000ULL);
+        kp_atomic_store(&g_foreignInjectionPolicy, snapshot->foreign_injection);
+        kp_atomic_store(&g_exitKey, snapshot->exit_key);
+        kp_atomic_store(&g_publishedAllowedCount, allowlist_count(&snapshot->allowed));
+        kp_atomic_store(&g_publishedPolicyVersion, snapshot->version);
+        QueueDeviceRules(&snapshot->devices);
+        printf("[설정] 정책 버전 %lu 적용 (허용 프로세스 %lu개, 키 규칙 %u개, 로그 상세 수준 %d)\n",
+               snapshot->version, allowlist_count(&snapshot->allowed), snapshot->keys.count - 1,
+               snapshot->log_verbosity);
+#if KP_FEATURE_SHADOW
+        LoadShadowCandidate(snapshot);
+#endif
+    }
+}
+
+/**
+ * @brief INI 파일에서 허용된 프로세스 목록을 로드합니다.
+ * @details 새 정책 스냅샷을 완성한 뒤 원자적으로 게시하므로 후크 실행 중에 호출해도 안전합니다.
+ * @param iniFilePath INI 파일 경로 (NULL이면 기본 경로 사용)
+ * @return BOOL 성공 시 TRUE, 실패 시 FALSE
+ */
+BOOL LoadAllowedProcessesFromIni(const char* iniFilePath) {
+    // INI 파일 경로 결정 (리로드 감시와 [Shadow] 상대 경로도 이 파일을 기준으로 함)
+    ResolveConfigPath(iniFilePath, g_configPath);
+    
+    // 파일을 한 번 읽어 모든 섹션을 단일 패스로 파싱
+    policy_load_status status = POLICY_LOAD_OK;
+    policy_snapshot* snapshot = policy_load_file(g_configPath, &status);
+    if (snapshot == NULL) {
+        return FALSE;
+    }
+    
+    // 포인터 교환 한 번으로 게시 (이전 스냅샷은 후크가 빠져나간 뒤 해제됨)
+    policy_store_publish(&g_policyStore, snapshot);
+    OnPolicyPublished(snapshot, NULL);
+    return (status == POLICY_LOAD_OK) ? TRUE : FALSE;
+}
+
+/**
+ * @brief 로드된 허용 프로세스 목록을 해제합니다.
+ * @details 후크가 해제된 뒤에만 호출해야 합니다.
+ */
+void FreeAllowedProcesses(void) {
+    policy_store_destroy(&g_policyStore);
+}
+
+/**
+ * @brief 특정 프로세스 이름이 허용된 프로세스인지 확인합니다.
+ * @details 키 규칙이 있는 프로세스도 허용된 프로세스로 봅니다. (키 단위 판정은 처리 코어에서 수행)
+ * @param processName 확인할 프로세스 이름
+ * @return BOOL 허용된 프로세스면 TRUE, 아니면 FALSE
+ */
+BOOL IsAllowedProcess(const char* processName) {
+    return (LookupProcessRule(processName) != 0) ? TRUE : FALSE;
+}
+
+/**
+ * @brief 처리 코어의 솔트 생성 함수 (키스트림 풀에서 워드 하나를 꺼내고, 솔트로는 그 위치를 반환)
+ */
+static unsigned int Win32MakeSalt(void* context, unsigned int* pad) {
+    (void)context;
+    uint32_t position;
+    *pad = (unsigned int)keystream_pool_next(&g_keystreamPool, &position);
+    return (unsigned int)position;
+}
+
+#if KP_FEATURE_KEY_LOG
+/**
+ * @brief 처리 코어의 로그 함수 (이진 저널과 비동기 로그 링에 기록)
+ * @details 저널은 키 다운 판정만 기록하므로 자동 반복 요약(repeats > 0)은 로그 링에만 넣습니다.
+ *          신뢰 장치(바코드 스캐너 등)의 키는 판정/암호화/주입은 그대로 하고 키 단위 로그만 남기지 않고 개수만 셉니다.
+ */
+static void Win32LogKey(void* context, unsigned int vkCode, unsigned int salt,
+                        unsigned int encryptedKeycode, int verdict, const char* processName,
+                        unsigned int repeats) {
+    (void)context;
+    if (g_trustedKey) {
+        kp_atomic_add_relaxed(&g_deviceStats.trustedLogSkipped, 1UL);
+        return;
+    }
+    if (repeats == 0) {
+        JournalKeyEvent(salt, encryptedKeycode, verdict, processName);
+    }
+    LogKeyEvent(vkCode, salt, encryptedKeycode, verdict, processName, repeats);
+}
+#endif // KP_FEATURE_KEY_LOG
+
+/**
+ * @brief 처리 코어의 주입 함수 (구독한 애플리케이션이면 공유 메모리 링, 아니면 SendInput 묶음)
+ * @details 판정에 쓴 포그라운드 식별 정보(PID, 생성 시각)가 구독 채널과 같을 때만 링에 넣습니다.
+ *          소비자가 밀려 링이 가득 차면 키를 잃지 않도록 SendInput으로 대신 주입합니다.
+ *          링에 넣기 전에 모아 둔 키를 먼저 주입하여 두 경로 사이에서도 순서를 지킵니다.
+ */
+static int Win32DeliverOrInject(void* context, unsigned int vkCode, int keyDown) {
+    const foreground_identity* identity = &g_foregroundCache.identity;
+    for (int i = 0; i < MAX_DELIVERY_CHANNELS; i++) {
+        DeliverySlot* slot = &g_deliverySlots[i];
+        if (kp_atomic_load(&slot->state) != DELIVERY_SLOT_ACTIVE || slot->processId != identity->process_id ||
+            slot->startTime != identity->start_time) {
+            continue;
+        }
+        inject_batch_flush(&g_injectBatch, INJECT_FLUSH_IDLE);
+        // 이벤트 루프가 state를 CLOSING으로 바꾼 뒤 users를 확인하므로, 울타리 뒤에 state를 다시 확인
+        kp_atomic_fetch_add(&slot->users, 1);
+        kp_atomic_fence();
+        int delivered = kp_atomic_load(&slot->state) == DELIVERY_SLOT_ACTIVE &&
+                        key_delivery_push(&slot->channel, vkCode,
+                                          keyDown ? KEY_MESSAGE_KEYDOWN : KEY_MESSAGE_KEYUP,
+                                          (uint32_t)(kp_now_ns() / 1000000ULL));
+        kp_atomic_fetch_add(&slot->users, -1);
+        if (delivered) {
+            kp_atomic_add_relaxed(&g_deliveryStats.delivered, 1);
+            return 1;
+        }
+        kp_atomic_add_relaxed(&g_deliveryStats.fallbacks, 1);
+        break;
+    }
+    (void)context;
+    return inject_batch_add(&g_injectBatch, vkCode, keyDown, (uint64_t)identity->window, kp_now_ns());
+}
+
+/**
+ * @brief 작업 스레드의 큐가 비면 모아 둔 키를 주입합니다.
+ */
+static void FlushInjectBatch(void* user) {
+    (void)user;
+    inject_batch_flush(&g_injectBatch, INJECT_FLUSH_IDLE);
+}
+
+/**
+ * @brief Win32 API 기반 처리 코어 백엔드
+ */
+static const key_processor_backend g_win32ProcessorBackend = {
+    NULL,
+    Win32MakeSalt,
+    Win32DeliverOrInject,
+#if KP_FEATURE_KEY_LOG
+    Win32LogKey
+#else
+    NULL
+#endif
+};
+
+#if KP_STATIC_BACKEND
+/**
+ * @brief 정적 백엔드의 솔트 생성 함수 (처리 코어가 함수 포인터 없이 직접 호출)
+ */
+unsigned int kp_backend_make_salt(void* context, unsigned int* pad) {
+    return Win32MakeSalt(context, pad);
+}
+
+/**
+ * @brief 정적 백엔드의 주입 함수 (처리 코어가 함수 포인터 없이 직접 호출)
+ */
+int kp_backend_inject(void* context, unsigned int vk_code, int key_down) {
+    return Win32DeliverOrInject(context, vk_code, key_down);
+}
+#endif
+
+#if KP_FEATURE_SHADOW
+/**
+ * @brief 키 이벤트 하나를 현재 정책과 후보 정책으로 판정하여 그림자 집계에 더합니다. (작업 스레드)
+ * @details 지연 예산을 크게 넘는 동안(light_lookup 단계)에는 후보 정책 판정을 생략하며,
+ *          생략한 키 다운은 보고서에 후보 판정 none으로 남습니다.
+ * @return foreground_verdict 현재 정책으로 판정한 결과
+ */
+static foreground_verdict AuditKeyEvent(const key_event* event) {
+    BOOL withCandidate = kp_atomic_load_relaxed(&g_shadowCandidate) &&
+                         hook_governor_level(&g_hookGovernor) < HOOK_LEVEL_LIGHT_LOOKUP;
+    policy_snapshot* candidate = withCandidate ? policy_store_enter(&g_candidateStore) : NULL;
+    foreground_verdict verdict = shadow_audit_handle(&g_shadowAudit, &g_foregroundCache, g_activePolicy,
+                                                     candidate, event);
+    if (withCandidate) {
+        policy_store_exit(&g_candidateStore);
+    }
+    return verdict;
+}
+#endif // KP_FEATURE_SHADOW
+
+/**
+ * @brief 작업 스레드에서 큐의 키 이벤트 하나를 처리합니다.
+ * @details 처리하는 동안 현재 정책 스냅샷을 잠금 없이 참조하며, 반환 전에 참조를 끝내
+ *          리로드 스레드가 이전 스냅샷을 회수할 수 있도록 합니다.
+ *          그림자 모드에서는 주입과 키 단위 로그 없이 판정만 집계하고, 강제 모드에서도 후보 정책이 있으면
+ *          처리 코어의 판정과 나란히 집계합니다. (신뢰 장치의 키는 후보 정책 집계와 키 단위 로그를 생략)
+ */
+static void ProcessKeyEvent(const key_event* event, void* user) {
+    (void)user;
+    g_trustedKey = (event->tag == DEVICE_CLASS_TRUSTED) ? TRUE : FALSE;
+    g_activePolicy = policy_store_enter(&g_policyStore);
+    g_keyProcessor.policy = (g_activePolicy != NULL) ? &g_activePolicy->keys : NULL;
+    if (g_activePolicy != NULL) {
+        inject_batch_configure(&g_injectBatch, g_activePolicy->inject_batch_size,
+                               (unsigned long long)g_activePolicy->inject_batch_delay_us * 1000ULL,
+                               g_activePolicy->inject_unicode);
+    }
+    
+    static const kp_stat_verdict verdictCounter[] = {
+        KP_VERDICT_UNKNOWN,  // FOREGROUND_UNKNOWN
+        KP_VERDICT_BLOCKED,  // FOREGROUND_BLOCKED
+        KP_VERDICT_ALLOWED   // FOREGROUND_ALLOWED
+    };
+    const char* processName = NULL;
+    foreground_verdict verdict;
+#if KP_FEATURE_SHADOW
+    if (g_shadowMode) {
+        verdict = AuditKeyEvent(event);
+        processName = (verdict != FOREGROUND_UNKNOWN) ? g_foregroundCache.process_name : NULL;
+    } else {
+        verdict = key_processor_handle(&g_keyProcessor, event, &processName);
+        if (kp_atomic_load_relaxed(&g_shadowCandidate) && !g_trustedKey) {
+            AuditKeyEvent(event);
+        }
+    }
+#else
+    verdict = key_processor_handle(&g_keyProcessor, event, &processName);
+#endif
+    kp_stats_count_verdict(g_statsBlock, verdictCounter[verdict]);
+    
+    g_keyProcessor.policy = NULL;
+    g_activePolicy = NULL;
+    policy_store_exit(&g_policyStore);
+    
+    // 후크 진입부터 주입까지 걸린 시간을 지연 예산과 비교
+    hook_governor_sample(&g_hookGovernor, kp_now_ns() - event->enqueue_ns);
+    
+#if KP_FEATURE_TRACE
+    // 재생 도구에서 같은 포그라운드 순서로 재현할 수 있도록 판정에 쓴 프로세스 이름과 함께 기록
+    if (g_traceRecording) {
+        key_trace_write(&g_traceRecorder, event, processName);
+    }
+#else
+    (void)processName;
+#endif
+}
+
+#if KP_FEATURE_TRACE
+/**
+ * @brief 키 입력 트레이스 기록을 시작합니다.
+ * @details SetHook() 전에 호출해야 하며, 기록은 작업 스레드에서 수행되어 후크에는 영향을 주지 않습니다.
+ * @param tracePath 트레이스 파일 경로
+ * @return BOOL 성공 시 TRUE, 실패 시 FALSE
+ */
+BOOL StartTraceRecording(const char* tracePath) {
+    if (!key_trace_open_write(&g_traceRecorder, tracePath)) {
+        fprintf(stderr, "[오류] 트레이스 파일을 만들 수 없습니다: %s\n", tracePath);
+        return FALSE;
+    }
+    g_traceRecording = TRUE;
+    printf("[정보] 키 입력 트레이스를 기록합니다: %s\n", tracePath);
+    return TRUE;
+}
+
+/**
+ * @brief 키 입력 트레이스 기록을 끝내고 파일을 닫습니다.
+ * @details 작업 스레드가 멈춘 뒤에 호출해야 합니다.
+ */
+static void StopTraceRecording(void) {
+    if (!g_traceRecording) {
+        return;
+    }
+    g_traceRecording = FALSE;
+    printf("[정보] 트레이스 기록 완료: 키 이벤트 %lu개, 프로세스 라벨 %u개\n",
+           g_traceRecorder.records, g_traceRecorder.label_count);
+    key_trace_close(&g_traceRecorder);
+}
+#endif // KP_FEATURE_TRACE
+
+/**
+ * @brief 이벤트 루프에 종료를 요청합니다.
+ * @details 후크에서도 호출되므로 이벤트 신호 외의 작업은 하지 않습니다. 먼저 들어온 이유만 기록합니다.
+ */
+static void RequestShutdown(ShutdownReason reason) {
+    InterlockedCompareExchange(&g_shutdownReason, reason, SHUTDOWN_NONE);
+    g_running = FALSE;
+    SetEvent(g_shutdownEvent);
+}
+
+/** @brief Raw Input을 받는 메시지 전용 창의 클래스 이름 */
+#define RAW_INPUT_WINDOW_CLASS "KeyProtectRawInput"
+
+/**
+ * @brief 짝짓기가 끝난 후크 이벤트를 장치 분류에 따라 처리합니다. (이벤트 루프 스레드, 후크 순서대로 호출)
+ * @details 신뢰하지 않는 장치의 키는 처리 코어에 넘기지 않고 버리며(원본 키는 후크에서 이미 차단됨),
+ *          나머지는 분류를 tag에 실어 작업 스레드 큐에 넣습니다. 장치를 알 수 없는 하드웨어 키는
+ *          Default 분류를 따르고(Default=untrusted이면 차단), 주입된 키는 주입 정책을 이미 거쳤으므로 normal입니다.
+ */
+static void ReleaseCorrelatedKey(const key_event* event, uintptr_t device, void* user) {
+    (void)user;
+    key_event tagged = *event;
+    tagged.tag = DEVICE_CLASS_NORMAL;
+    device_entry* entry = (device != 0) ? device_table_find(&g_deviceTable, device) : NULL;
+    if (entry != NULL) {
+        device_entry_key(entry, event->enqueue_ns);
+        tagged.tag = (unsigned int)entry->device_class;
+    } else if (!(event->flags & LLKHF_INJECTED)) {
+        g_deviceStats.unknownDefault++;
+        tagged.tag = (unsigned int)g_deviceRules.default_class;
+    }
+    if (tagged.tag == DEVICE_CLASS_UNTRUSTED) {
+        g_deviceStats.untrustedBlocked++;
+        return;
+    }
+    if (tagged.tag == DEVICE_CLASS_TRUSTED) {
+        g_deviceStats.trustedKeys++;
+    }
+    key_pipeline_submit(&g_keyPipeline, &tagged);
+}
+
+/**
+ * @brief 처음 보는 장치를 이름과 함께 장치 테이블에 등록합니다.
+ * @return device_entry* 장치, 테이블이 가득 찼으면 NULL
+ */
+static device_entry* RegisterInputDevice(HANDLE hDevice) {
+    char name[512] = {0};
+    UINT size = (UINT)sizeof(name);
+    if (GetRawInputDeviceInfoA(hDevice, RIDI_DEVICENAME, name, &size) == (UINT)-1) {
+        name[0] = '\0';
+    }
+    device_entry* entry = device_table_insert(&g_deviceTable, (uintptr_t)hDevice,
+                                              (name[0] != '\0') ? name : NULL, &g_deviceRules);
+    if (entry != NULL) {
+        printf("[장치] 키보드 연결: %s (%s)\n", (entry->name[0] != '\0') ? entry->name : "(이름 없음)",
+               device_class_name(entry->device_class));
+    }
+    return entry;
+}
+
+/**
+ * @brief WM_INPUT 하나를 처리합니다.
+ * @details 장치 핸들이 없는 입력(SendInput으로 주입된 키)은 짝짓기에 넣지 않습니다.
+ */
+static void HandleRawInput(HRAWINPUT hRawInput) {
+    unsigned long long now = kp_now_ns();
+    RAWINPUT input;
+    UINT size = (UINT)sizeof(input);
+    if (GetRawInputData(hRawInput, RID_INPUT, &input, &size, sizeof(RAWINPUTHEADER)) == (UINT)-1 ||
+        input.header.dwType != RIM_TYPEKEYBOARD) {
+        return;
+    }
+    if (input.header.hDevice == NULL) {
+        g_deviceStats.noHandle++;
+        return;
+    }
+    const RAWKEYBOARD* keyboard = &input.data.keyboard;
+    if (keyboard->MakeCode == KEYBOARD_OVERRUN_MAKE_CODE) {
+        return;
+    }
+    if (device_table_find(&g_deviceTable, (uintptr_t)input.header.hDevice) == NULL &&
+        RegisterInputDevice(input.header.hDevice) == NULL) {
+        g_deviceStats.tableFull++;
+    }
+    input_correlator_raw(&g_inputCorrelator, (uintptr_t)input.header.hDevice,
+                         INPUT_SCAN_KEY(keyboard->MakeCode, keyboard->Flags & RI_KEY_E0),
+                         (keyboard->Flags & RI_KEY_BREAK) ? 0 : 1, now);
+}
+
+/**
+ * @brief Raw Input 메시지 전용 창 프로시저
+ */
+static LRESULT CALLBACK RawInputWindowProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam) {
+    if (message == WM_INPUT) {
+        HandleRawInput((HRAWINPUT)lParam);
+    } else if (message == WM_INPUT_DEVICE_CHANGE && wParam == GIDC_REMOVAL) {
+        device_entry* entry = device_table_find(&g_deviceTable, (uintptr_t)lParam);
+        if (entry != NULL) {
+            printf("[장치] 키보드 분리: %s (키 %lu개, 버스트 %lu회)\n",
+                   (entry->name[0] != '\0') ? entry->name : "(이름 없음)", entry->keys, entry->bursts);
+            device_table_remove(&g_deviceTable, (uintptr_t)lParam);
+        }
+    }
+    return DefWindowProcA(hwnd, message, wParam, lParam);
+}
+
+/**
+ * @brief 키보드 Raw Input 수신을 시작합니다. (이벤트 루프 스레드, 후크 설치 전)
+ * @details 포그라운드와 관계없이 받도록 RIDEV_INPUTSINK로 등록하고, 장치 분리 알림(RIDEV_DEVNOTIFY)을
+ *          지원하지 않는 Windows XP에서는 알림 없이 다시 등록합니다. 실패하면 장치 구분 없이 기존과 같이 동작합니다.
+ */
+static void StartRawInput(void) {
+    device_table_init(&g_deviceTable);
+    device_rules_init(&g_deviceRules);
+    input_correlator_init(&g_inputCorrelator, ReleaseCorrelatedKey, NULL);
+    ApplyPendingDeviceRules();
+    
+    WNDCLASSA windowClass;
+    ZeroMemory(&windowClass, sizeof(windowClass));
+    windowClass.lpfnWndProc = RawInputWindowProc;
+    windowClass.hInstance = GetModuleHandleA(NULL);
+    windowClass.lpszClassName = RAW_INPUT_WINDOW_CLASS;
+    if (RegisterClassA(&windowClass) == 0) {
+        fprintf(stderr, "[경고] Raw Input 창 클래스를 등록할 수 없습니다. (Error Code: %lu)\n", GetLastError());
+        return;
+    }
+    g_rawInputWindow = CreateWindowExA(0, RAW_INPUT_WINDOW_CLASS, "", 0, 0, 0, 0, 0, HWND_MESSAGE, NULL,
+                                       windowClass.hInstance, NULL);
+    if (g_rawInputWindow == NULL) {
+        fprintf(stderr, "[경고] Raw Input 창을 만들 수 없습니다. (Error Code: %lu)\n", GetLastError());
+        UnregisterClassA(RAW_INPUT_WINDOW_CLASS, windowClass.hInstance);
+        return;
+    }
+    
+    RAWINPUTDEVICE device;
+    device.usUsagePage = 0x01;  // Generic Desktop
+    device.usUsage = 0x06;      // Keyboard
+    device.dwFlags = RIDEV_INPUTSINK | RIDEV_DEVNOTIFY;
+    device.hwndTarget = g_rawInputWindow;
+    if (!RegisterRawInputDevices(&device, 1, sizeof(device))) {
+        device.dwFlags = RIDEV_INPUTSINK;
+        if (!RegisterRawInputDevices(&device, 1, sizeof(device))) {
+            fprintf(stderr, "[경고] Raw Input 등록에 실패했습니다. 장치별 규칙이 적용되지 않습니다. (Error Code: %lu)\n",
+                    GetLastError());
+            DestroyWindow(g_rawInputWindow);
+            g_rawInputWindow = NULL;
+            UnregisterClassA(RAW_INPUT_WINDOW_CLASS, windowClass.hInstance);
+            return;
+        }
+    }
+    g_rawInputEnabled = TRUE;
+}
+
+/**
+ * @brief Raw Input 수신을 끝냅니다. (후크 해제 뒤, 작업 스레드를 멈추기 전)
+ * @details 짝을 기다리며 붙잡아 둔 후크 이벤트를 모두 작업 스레드 큐에 넘깁니다.
+ */
+static void StopRawInput(void) {
+    if (!g_rawInputEnabled) {
+        return;
+    }
+    input_correlator_flush(&g_inputCorrelator);
+    RAWINPUTDEVICE device;
+    device.usUsagePage = 0x01;
+    device.usUsage = 0x06;
+    device.dwFlags = RIDEV_REMOVE;
+    device.hwndTarget = NULL;
+    RegisterRawInputDevices(&device, 1, sizeof(device));
+    DestroyWindow(g_rawInputWindow);
+    g_rawInputWindow = NULL;
+    UnregisterClassA(RAW_INPUT_WINDOW_CLASS, GetModuleHandleA(NULL));
+    g_rawInputEnabled = FALSE;
+}
+
+/**
+ * @brief 후크 프로시저 본문
+ * @details 모든 키 입력은 어차피 차단되므로, 후크는 이벤트를 작업 스레드 큐에 복사하고 바로 반환합니다.
+ *          프로세스 확인, 암호화, SendInput은 후크 밖에서 처리되어 콜백 시간이 일정하게 유지됩니다.
+ * @param entryNs 후크에 진입한 시각 (kp_now_ns, 큐 대기 시간의 시작점으로도 사용)
+ */
+static LRESULT HandleKeyboardHook(int nCode, WPARAM wParam, LPARAM lParam, unsigned long long entryNs) {
+    // nCode가 0보다 작으면 시스템에서 후크를 처리해야 함
+    if (nCode >= 0) {
+        // 키보드 데이터 구조체 포인터
+        KBDLLHOOKSTRUCT* pKbdStruct = (KBDLLHOOKSTRUCT*)lParam;
+        
+        // 주입된 키 입력: 자체 주입은 서명 비교 한 번으로 바로 통과
+        if (pKbdStruct->flags & LLKHF_INJECTED) {
+            // 감시 스레드의 탐침: 심장 박동은 이미 기록했으므로 차단만 함
+            if (pKbdStruct->dwExtraInfo == g_probeSignature) {
+                return 1;
+            }
+            if (pKbdStruct->dwExtraInfo == g_injectionSignature) {
+                kp_atomic_add_relaxed(&g_injectionStats.selfPassed, 1UL);
+                return CallNextHookEx(g_keyboardHook, nCode, wParam, lParam);
+            }
+            
+            int foreignPolicy = kp_atomic_load_relaxed(&g_foreignInjectionPolicy);
+            if (foreignPolicy == POLICY_INJECTION_PASS) {
+                kp_atomic_add_relaxed(&g_injectionStats.foreignPassed, 1UL);
+                return CallNextHookEx(g_keyboardHook, nCode, wParam, lParam);
+            }
+            if (foreignPolicy == POLICY_INJECTION_BLOCK) {
+                kp_atomic_add_relaxed(&g_injectionStats.foreignBlocked, 1UL);
+#if KP_FEATURE_SHADOW
+                // 그림자 모드에서는 차단했을 키로 세기만 함
+                if (g_shadowMode) {
+                    return CallNextHookEx(g_keyboardHook, nCode, wParam, lParam);
+                }
+#endif
+                return 1;
+            }
+            kp_atomic_add_relaxed(&g_injectionStats.foreignProcessed, 1UL);
+        }
+        
+        // 종료 키 (기본값 VK_ESCAPE, [KeyPolicy] ExitKey)는 종료를 위해 예외적으로 허용
+        unsigned int exitKey = CURRENT_EXIT_KEY();
+        if (exitKey != 0 && pKbdStruct->vkCode == exitKey) {
+            // 종료 이벤트만 신호 (알림 출력과 후크 해제는 이벤트 루프가 빠져나온 뒤 수행)
+            RequestShutdown(SHUTDOWN_EXIT_KEY);
+            // 다음 후크로 전달 (즉, 차단하지 않음)
+            return CallNextHookEx(g_keyboardHook, nCode, wParam, lParam);
+        }
+        
+        if (wParam == WM_KEYDOWN || wParam == WM_SYSKEYDOWN ||
+            wParam == WM_KEYUP || wParam == WM_SYSKEYUP) {
+            // 이벤트를 작업 스레드 큐에 복사 (큐가 가득 차도 안전을 위해 차단)
+            key_event event;
+            event.enqueue_ns = entryNs;
+            event.vk_code = (unsigned int)pKbdStruct->vkCode;
+            event.scan_code = (unsigned int)pKbdStruct->scanCode;
+            event.flags = (unsigned int)pKbdStruct->flags;
+            event.time = (unsigned int)pKbdStruct->time;
+            event.message = (unsigned int)wParam;
+            event.tag = DEVICE_CLASS_NORMAL;
+            if (g_rawInputEnabled) {
+                // 같은 키의 WM_INPUT과 짝지어 장치 분류를 붙인 뒤 큐에 넣음 (주입된 키는 짝을 찾지 않음)
+                unsigned int scanKey = (pKbdStruct->flags & LLKHF_INJECTED) ? INPUT_SCAN_KEY_NONE :
+                    INPUT_SCAN_KEY(pKbdStruct->scanCode, pKbdStruct->flags & LLKHF_EXTENDED);
+                input_correlator_hook(&g_inputCorrelator, &event, scanKey, entryNs);
+            } else {
+                key_pipeline_submit(&g_keyPipeline, &event);
+            }
+            
+#if KP_FEATURE_SHADOW
+            // 그림자 모드: 판정은 작업 스레드가 집계하고 원본 키 입력은 그대로 전달
+            if (g_shadowMode) {
+                return CallNextHookEx(g_keyboardHook, nCode, wParam, lParam);
+            }
+#endif
+            
+            // 원본 키 입력은 차단
+            return 1; // 키 입력 차단
+        }
+    }
+    
+    // 이외의 모든 메시지는 다음 후크로 전달
+    return CallNextHookEx(g_keyboardHook, nCode, wParam, lParam);
+}
+
+/**
+ * @brief 키보드 입력이 발생할 때마다 호출되는 저수준 키보드 후크 프로시저
+ * @details 진입부터 반환까지의 시간을 통계 블록의 후크 히스토그램에 기록하여
+ *          LowLevelHooksTimeout에 얼마나 가까운지 외부에서 확인할 수 있도록 합니다.
+ *          후크 지연 관리자에는 심장 박동과 콜백 시간을, 이벤트 루프가 밀려 후크 호출 자체가 늦어진 경우에는
+ *          입력 시각부터의 지연도 함께 넣습니다. (GetTickCount 해상도를 넘는 지연만)
+ * @param nCode 후크 프로시저가 메시지를 처리할지 다음 프로시저로 전달할지 결정하는 코드
+ * @param wParam 메시지 타입 (WM_KEYDOWN, WM_KEYUP, WM_SYSKEYDOWN, WM_SYSKEYUP)
+ * @param lParam KBDLLHOOKSTRUCT 구조체에 대한 포인터
+ * @return LRESULT 메시지를 차단하려면 0이 아닌 값을 반환, 전달하려면 CallNextHookEx의 반환값을 반환
+ */
+LRESULT CALLBACK LowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam) {
+    unsigned long long entryNs = kp_now_ns();
+    hook_governor_heartbeat(&g_hookGovernor, entryNs);
+    LRESULT result = HandleKeyboardHook(nCode, wParam, lParam, entryNs);
+    unsigned long long durationNs = kp_now_ns() - entryNs;
+    kp_stats_record(g_statsBlock, KP_STAT_HOOK, durationNs);
+    hook_governor_sample(&g_hookGovernor, durationNs);
+    if (nCode >= 0) {
+        DWORD dispatchMs = GetTickCount() - ((KBDLLHOOKSTRUCT*)lParam)->time;
+        if (dispatchMs > HOOK_DISPATCH_TICK_SLACK_MS && dispatchMs < 0x80000000UL) {
+            hook_governor_sample(&g_hookGovernor, (unsigned long long)dispatchMs * 1000000ULL + durationNs);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief 시스템의 LowLevelHooksTimeout 값을 읽습니다.
+ * @details HKCU\Control Panel\Desktop의 값이 없으면 기본값을 사용합니다. (DWORD 또는 문자열로 저장될 수 있음)
+ * @return DWORD 후크 제한 시간 (밀리초)
+ */
+static DWORD ReadHookTimeoutMs(void) {
+    DWORD timeoutMs = KP_STATS_DEFAULT_HOOK_TIMEOUT_MS;
+    HKEY key = NULL;
+    if (RegOpenKeyExA(HKEY_CURRENT_USER, "Control Panel\\Desktop", 0, KEY_QUERY_VALUE, &key) != ERROR_SUCCESS) {
+        return timeoutMs;
+    }
+    
+    BYTE data[32] = {0};
+    DWORD type = 0;
+    DWORD size = sizeof(data) - 1;
+    if (RegQueryValueExA(key, "LowLevelHooksTimeout", NULL, &type, data, &size) == ERROR_SUCCESS) {
+        if (type == REG_DWORD && size == sizeof(DWORD)) {
+            memcpy(&timeoutMs, data, sizeof(DWORD));
+        } else if (type == REG_SZ) {
+            timeoutMs = (DWORD)strtoul((const char*)data, NULL, 10);
+        }
+    }
+    RegCloseKey(key);
+    return (timeoutMs != 0) ? timeoutMs : KP_STATS_DEFAULT_HOOK_TIMEOUT_MS;
+}
 
 /**
- * @brief 키 코드별 암호화된 키 코드 저장
- * @details 각 키 코드에 대한 암호화된 값을 저장합니다.
+ * @brief 공유 메모리 통계 블록을 만듭니다.
+ * @details 공유 메모리를 만들 수 없으면 프로세스 내부 블록에 기록하며, 외부 도구에서는 볼 수 없습니다.
  */
-static unsigned int g_encryptedKeycode[256] = {0};
+static void OpenStatsBlock(void) {
+    if (kp_shared_memory_create(&g_statsMemory, KP_STATS_SHM_NAME, sizeof(kp_stats_block))) {
+        g_statsBlock = (kp_stats_block*)g_statsMemory.address;
+    } else {
+        fprintf(stderr, "[경고] 공유 메모리 통계 블록을 만들 수 없습니다. 외부 모니터링이 비활성화됩니다.\n");
+        g_statsBlock = &g_localStatsBlock;
+    }
+    kp_stats_block_init(g_statsBlock, (uint32_t)ReadHookTimeoutMs());
+    printf("[정보] 통계 블록: %s (후크 제한 시간 %lu ms)\n", KP_STATS_SHM_NAME,
+           (unsigned long)g_statsBlock->hook_timeout_ms);
+}
 
 /**
- * @brief 허용된 프로세스 목록 (최대 100개)
+ * @brief 공유 메모리 통계 블록을 닫습니다.
  */
-#define MAX_ALLOWED_PROCESSES 100
-static char g_allowedProcesses[MAX_ALLOWED_PROCESSES][MAX_PATH] = {0};
-static int g_allowedProcessCount = 0;
+static void CloseStatsBlock(void) {
+    g_statsBlock = NULL;
+    kp_shared_memory_close(&g_statsMemory);
+}
 
 /**
- * @brief 현재 포커스된 창의 프로세스 실행 파일 이름을 가져옵니다.
- * @param processName 버퍼에 저장될 프로세스 이름 (최대 MAX_PATH)
- * @param bufferSize 버퍼 크기
- * @return BOOL 성공 시 TRUE, 실패 시 FALSE
+ * @brief 키스트림 풀 통계를 출력합니다.
  */
-BOOL GetCurrentProcessName(char* processName, DWORD bufferSize) {
-    HWND hwnd = GetForegroundWindow();
-    if (hwnd == NULL) {
-        return FALSE;
-    }
+static void PrintKeystreamStats(void) {
+    keystream_stats stats;
+    keystream_pool_get_stats(&g_keystreamPool, &stats);
+    printf("[통계] 키스트림: 사용 워드 %lu | 생성 블록 %llu | 풀 고갈 %lu | 생성 스레드 깨우기 %lu\n",
+           stats.words_used, stats.blocks, stats.underflows, stats.refill_wakeups);
+}
+
+/**
+ * @brief 파이프라인 통계를 출력합니다.
+ */
+static void PrintPipelineStats(void) {
+    key_pipeline_stats stats;
+    key_pipeline_get_stats(&g_keyPipeline, &stats);
+    unsigned long processed = (stats.processed != 0) ? stats.processed : 1;
     
-    DWORD processId = 0;
-    GetWindowThreadProcessId(hwnd, &processId);
-    if (processId == 0) {
-        return FALSE;
+    printf("[통계] 파이프라인: 처리 %lu | 손실 %lu | 최대 큐 깊이 %lu | 작업 스레드 깨우기 %lu\n",
+           stats.processed, stats.dropped, stats.max_depth, stats.wakeups);
+    printf("[통계] 큐 대기: 평균 %llu ns, 최대 %llu ns\n",
+           stats.lag_total_ns / processed, stats.lag_max_ns);
+    printf("[통계] 단계별 평균/최대 (ns): 프로세스 확인 %llu/%llu | 암호화 %llu/%llu | 주입 %llu/%llu\n",
+           stats.stage_total_ns[KEY_STAGE_RESOLVE] / processed, stats.stage_max_ns[KEY_STAGE_RESOLVE],
+           stats.stage_total_ns[KEY_STAGE_CRYPTO] / processed, stats.stage_max_ns[KEY_STAGE_CRYPTO],
+           stats.stage_total_ns[KEY_STAGE_INJECT] / processed, stats.stage_max_ns[KEY_STAGE_INJECT]);
+}
+
+/**
+ * @brief 설정 파일을 지금 다시 로드하여 게시합니다. (이벤트 루프 스레드 전용)
+ * @return BOOL 새 정책을 게시했으면 TRUE
+ */
+static BOOL ReloadConfiguration(void) {
+    g_reloadDeadlineNs = 0;
+    if (!g_configWatchEnabled) {
+        return LoadAllowedProcessesFromIni(g_configPath);
     }
-    
-    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processId);
-    if (hProcess == NULL) {
+    if (config_reloader_reload(&g_configReloader) < 0) {
+        fprintf(stderr, "[경고] 설정 파일을 다시 로드하지 못해 기존 정책을 유지합니다.\n");
         return FALSE;
     }
-    
-    BOOL result = FALSE;
-    if (GetModuleFileNameExA(hProcess, NULL, processName, bufferSize) > 0) {
-        // 전체 경로에서 파일 이름만 추출
-        char* fileName = PathFindFileNameA(processName);
-        if (fileName != processName) {
-            // 파일 이름을 버퍼의 시작 위치로 이동
-            strcpy_s(processName, bufferSize, fileName);
+    return TRUE;
+}
+
+/**
+ * @brief 구독한 프로세스의 전달 채널 슬롯을 찾습니다. (이벤트 루프 스레드 전용)
+ * @return DeliverySlot* 열려 있는 슬롯, 없으면 NULL
+ */
+static DeliverySlot* FindDeliverySlot(DWORD processId) {
+    for (int i = 0; i < MAX_DELIVERY_CHANNELS; i++) {
+        if (g_deliverySlots[i].state == DELIVERY_SLOT_ACTIVE && g_deliverySlots[i].processId == processId) {
+            return &g_deliverySlots[i];
         }
-        result = TRUE;
     }
-    
-    CloseHandle(hProcess);
-    return result;
+    return NULL;
 }
 
 /**
- * @brief INI 파일에서 허용된 프로세스 목록을 로드합니다.
- * @param iniFilePath INI 파일 경로 (NULL이면 기본 경로 사용)
- * @return BOOL 성공 시 TRUE, 실패 시 FALSE
+ * @brief 전달 채널을 닫습니다. (이벤트 루프 스레드 전용)
+ * @details 작업 스레드가 키 하나를 넣는 동안만 기다리므로 대기는 매우 짧습니다.
  */
-BOOL LoadAllowedProcessesFromIni(const char* iniFilePath) {
-    // 기존 목록 초기화
-    FreeAllowedProcesses();
-    
-    // INI 파일 경로 결정
-    char configPath[MAX_PATH] = {0};
-    if (iniFilePath == NULL || iniFilePath[0] == '\0') {
-        // 실행 파일과 같은 디렉토리에 config.ini 파일 사용
-        GetModuleFileNameA(NULL, configPath, MAX_PATH);
-        char* lastSlash = strrchr(configPath, '\\');
-        if (lastSlash != NULL) {
-            *(lastSlash + 1) = '\0';
-        }
-        strcat_s(configPath, MAX_PATH, "config.ini");
-    } else {
-        strcpy_s(configPath, MAX_PATH, iniFilePath);
+static void CloseDeliverySlot(DeliverySlot* slot) {
+    kp_atomic_store(&slot->state, DELIVERY_SLOT_CLOSING);
+    kp_atomic_fence();
+    while (kp_atomic_load(&slot->users) != 0) {
+        Sleep(0);
     }
-    
-    printf("[설정] INI 파일 로드 시도: %s\n", configPath);
-    
-    // INI 파일 존재 확인
-    DWORD fileAttr = GetFileAttributesA(configPath);
-    if (fileAttr == INVALID_FILE_ATTRIBUTES) {
-        fprintf(stderr, "[경고] INI 파일을 찾을 수 없습니다: %s\n", configPath);
-        fprintf(stderr, "[정보] 기본 설정으로 notepad++.exe만 허용합니다.\n");
-        // 기본값으로 notepad++.exe 추가
-        strcpy_s(g_allowedProcesses[0], MAX_PATH, "notepad++.exe");
-        g_allowedProcessCount = 1;
-        return FALSE;
+    printf("[전달] 채널 닫음: PID %lu (전달 %lu, 링 가득 참 %lu, 깨우기 %lu)\n",
+           (unsigned long)slot->processId, slot->channel.delivered,
+           (unsigned long)slot->channel.ring->dropped, (unsigned long)slot->channel.ring->wakeups);
+    key_delivery_channel_close(&slot->channel);
+    slot->processId = 0;
+    slot->startTime = 0;
+    kp_atomic_store(&slot->state, DELIVERY_SLOT_FREE);
+}
+
+/**
+ * @brief 구독 요청을 처리하여 전달 채널을 엽니다. (이벤트 루프 스레드 전용)
+ * @details 요청한 프로세스가 제어 채널 클라이언트 자신이고 허용 목록에 있을 때만 채널 키를 응답합니다.
+ *          같은 프로세스가 다시 구독하면 이전 채널을 닫고 새 키로 엽니다.
+ */
+static control_status SubscribeDelivery(DWORD processId, control_message* reply) {
+    // 다른 프로세스 ID를 내세워 채널 키를 받아 가지 못하도록 운영체제가 알려 준 클라이언트와 비교
+    if (processId == 0 || processId != g_controlServer.client_pid) {
+        return CONTROL_ERR_INVALID;
     }
-    
-    // INI 파일에서 프로세스 목록 읽기
-    // [AllowedProcesses] 섹션에서 Process1, Process2, ... 형식으로 읽기
-    char buffer[MAX_PATH] = {0};
-    int count = 0;
-    
-    for (int i = 1; i <= MAX_ALLOWED_PROCESSES; i++) {
-        char keyName[32] = {0};
-        sprintf_s(keyName, sizeof(keyName), "Process%d", i);
-        
-        DWORD result = GetPrivateProfileStringA(
-            "AllowedProcesses",  // 섹션 이름
-            keyName,             // 키 이름
-            "",                  // 기본값
-            buffer,              // 버퍼
-            MAX_PATH,            // 버퍼 크기
-            configPath           // INI 파일 경로
-        );
-        
-        if (result > 0 && buffer[0] != '\0') {
-            // 프로세스 이름 복사
-            strcpy_s(g_allowedProcesses[count], MAX_PATH, buffer);
-            count++;
-            printf("[설정] 허용 프로세스 추가: %s\n", buffer);
-        } else {
-            // 더 이상 읽을 항목이 없으면 종료
-            break;
+    char processName[MAX_PATH];
+    unsigned long long startTime = 0;
+    if (!Win32QueryProcess(processId, &startTime, processName, sizeof(processName)) ||
+        LookupPublishedRule(processName) == 0) {
+        fprintf(stderr, "[전달] 허용되지 않은 프로세스의 구독 요청을 거부했습니다: PID %lu\n",
+                (unsigned long)processId);
+        return CONTROL_ERR_FAILED;
+    }
+
+    DeliverySlot* previous = FindDeliverySlot(processId);
+    if (previous != NULL) {
+        CloseDeliverySlot(previous);
+    }
+    DeliverySlot* slot = NULL;
+    for (int i = 0; i < MAX_DELIVERY_CHANNELS && slot == NULL; i++) {
+        if (g_deliverySlots[i].state == DELIVERY_SLOT_FREE) {
+            slot = &g_deliverySlots[i];
         }
     }
-    
-    if (count == 0) {
-        fprintf(stderr, "[경고] INI 파일에서 허용 프로세스를 찾을 수 없습니다.\n");
-        fprintf(stderr, "[정보] 기본 설정으로 notepad++.exe만 허용합니다.\n");
-        // 기본값으로 notepad++.exe 추가
-        strcpy_s(g_allowedProcesses[0], MAX_PATH, "notepad++.exe");
-        g_allowedProcessCount = 1;
-        return FALSE;
+    key_delivery_grant grant;
+    if (slot == NULL || !key_delivery_channel_open(&slot->channel, processId, &grant)) {
+        fprintf(stderr, "[전달] 전달 채널을 열 수 없습니다: %s (PID %lu)\n", processName,
+                (unsigned long)processId);
+        return CONTROL_ERR_FAILED;
     }
-    
-    g_allowedProcessCount = count;
-    printf("[설정] 총 %d개의 허용 프로세스가 로드되었습니다.\n", count);
-    return TRUE;
+    slot->processId = processId;
+    slot->startTime = startTime;
+    kp_atomic_store(&slot->state, DELIVERY_SLOT_ACTIVE);
+
+    printf("[전달] 채널 열림: %s (PID %lu) → %s\n", processName, (unsigned long)processId, grant.name);
+    control_message_set_status(reply, CONTROL_OK);
+    control_message_append(reply, &grant, sizeof(grant));
+    SecureZeroMemory(&grant, sizeof(grant));
+    return CONTROL_OK;
 }
 
 /**
- * @brief 로드된 허용 프로세스 목록을 해제합니다.
+ * @brief 종료된 구독 프로세스의 채널을 닫습니다. (이벤트 루프 타이머)
  */
-void FreeAllowedProcesses(void) {
-    for (int i = 0; i < g_allowedProcessCount; i++) {
-        g_allowedProcesses[i][0] = '\0';
+static void ReapDeliverySlots(void) {
+    for (int i = 0; i < MAX_DELIVERY_CHANNELS; i++) {
+        DeliverySlot* slot = &g_deliverySlots[i];
+        unsigned long long startTime = 0;
+        if (slot->state == DELIVERY_SLOT_ACTIVE &&
+            (!Win32QueryProcess(slot->processId, &startTime, NULL, 0) || startTime != slot->startTime)) {
+            CloseDeliverySlot(slot);
+        }
     }
-    g_allowedProcessCount = 0;
 }
 
 /**
- * @brief 특정 프로세스 이름이 허용된 프로세스인지 확인합니다.
- * @param processName 확인할 프로세스 이름
- * @return BOOL 허용된 프로세스면 TRUE, 아니면 FALSE
+ * @brief 열려 있는 전달 채널을 모두 닫습니다.
  */
-BOOL IsAllowedProcess(const char* processName) {
-    if (processName == NULL) {
-        return FALSE;
+static void CloseDeliverySlots(void) {
+    for (int i = 0; i < MAX_DELIVERY_CHANNELS; i++) {
+        if (g_deliverySlots[i].state == DELIVERY_SLOT_ACTIVE) {
+            CloseDeliverySlot(&g_deliverySlots[i]);
+        }
     }
+}
+
+/**
+ * @brief CONTROL_STATS 응답에 실시간 카운터를 채웁니다.
+ * @details 다른 스레드가 갱신하는 카운터는 잠금 없이 읽으므로 카운터 사이의 값은 순간적으로 어긋날 수 있습니다.
+ */
+static void FillControlStats(control_stats* stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->count = CONTROL_STAT_COUNT;
+    
+    uint64_t* values = stats->values;
+    values[CONTROL_STAT_UPTIME_MS] = (kp_now_ns() - g_startNs) / 1000000ULL;
+    values[CONTROL_STAT_POLICY_VERSION] = kp_atomic_load(&g_publishedPolicyVersion);
+    values[CONTROL_STAT_ALLOWED_PROCESSES] = kp_atomic_load(&g_publishedAllowedCount);
+    values[CONTROL_STAT_LOG_VERBOSITY] = (uint64_t)kp_atomic_load_relaxed(&g_logRing.verbosity);
     
-    // 허용된 프로세스 목록과 비교
-    for (int i = 0; i < g_allowedProcessCount; i++) {
-        if (_stricmp(processName, g_allowedProcesses[i]) == 0) {
-            return TRUE;
+    key_pipeline_stats pipeline;
+    key_pipeline_get_stats(&g_keyPipeline, &pipeline);
+    values[CONTROL_STAT_PROCESSED] = pipeline.processed;
+    values[CONTROL_STAT_DROPPED] = pipeline.dropped;
+    values[CONTROL_STAT_ALLOWED] = kp_atomic_load_relaxed(&g_statsBlock->verdicts[KP_VERDICT_ALLOWED]);
+    values[CONTROL_STAT_BLOCKED] = kp_atomic_load_relaxed(&g_statsBlock->verdicts[KP_VERDICT_BLOCKED]);
+    values[CONTROL_STAT_UNKNOWN] = kp_atomic_load_relaxed(&g_statsBlock->verdicts[KP_VERDICT_UNKNOWN]);
+    values[CONTROL_STAT_INJECTED] = kp_atomic_load_relaxed(&g_keyProcessor.injected);
+    values[CONTROL_STAT_REPEATS] = kp_atomic_load_relaxed(&g_keyProcessor.repeats);
+    values[CONTROL_STAT_RULE_BLOCKED] = kp_atomic_load_relaxed(&g_keyProcessor.rule_blocked);
+    values[CONTROL_STAT_SELF_PASSED] = kp_atomic_load_relaxed(&g_injectionStats.selfPassed);
+    values[CONTROL_STAT_FOREIGN_PASSED] = kp_atomic_load_relaxed(&g_injectionStats.foreignPassed);
+    values[CONTROL_STAT_FOREIGN_BLOCKED] = kp_atomic_load_relaxed(&g_injectionStats.foreignBlocked);
+    values[CONTROL_STAT_FOREIGN_PROCESSED] = kp_atomic_load_relaxed(&g_injectionStats.foreignProcessed);
+    values[CONTROL_STAT_RELOADS] = g_configReloader.reloads;
+    values[CONTROL_STAT_RELOAD_FAILURES] = g_configReloader.failures;
+    for (int i = 0; i < MAX_DELIVERY_CHANNELS; i++) {
+        if (g_deliverySlots[i].state == DELIVERY_SLOT_ACTIVE) {
+            values[CONTROL_STAT_DELIVERY_CHANNELS]++;
         }
     }
-    
-    return FALSE;
+    values[CONTROL_STAT_DELIVERED] = kp_atomic_load_relaxed(&g_deliveryStats.delivered);
+    values[CONTROL_STAT_DELIVERY_FALLBACKS] = kp_atomic_load_relaxed(&g_deliveryStats.fallbacks);
+    values[CONTROL_STAT_HOOK_LEVEL] = (uint64_t)hook_governor_level(&g_hookGovernor);
+    values[CONTROL_STAT_HOOK_OVER_BUDGET] = kp_atomic_load_relaxed(&g_hookGovernor.over_budget);
+    values[CONTROL_STAT_HOOK_DEGRADATIONS] = kp_atomic_load_relaxed(&g_hookGovernor.degradations);
+    values[CONTROL_STAT_HOOK_RECOVERIES] = kp_atomic_load_relaxed(&g_hookGovernor.recoveries);
+    values[CONTROL_STAT_HOOK_PROBES] = kp_atomic_load_relaxed(&g_hookGovernor.probes);
+    values[CONTROL_STAT_HOOK_REINSTALLS] = kp_atomic_load_relaxed(&g_hookGovernor.reinstalls);
+#if KP_FEATURE_SHADOW
+    values[CONTROL_STAT_SHADOW_KEY_DOWNS] = kp_atomic_load_relaxed(&g_shadowAudit.key_downs);
+    values[CONTROL_STAT_SHADOW_DISAGREEMENTS] = kp_atomic_load_relaxed(&g_shadowAudit.disagreements);
+#endif
 }
 
 /**
- * @brief 복호화된 키 코드를 SendInput을 사용하여 전달합니다.
- * @param vkCode 전달할 가상 키 코드
- * @param isKeyDown 키 다운 이벤트인지 여부 (TRUE: 키 다운, FALSE: 키 업)
- * @return BOOL 성공 시 TRUE, 실패 시 FALSE
+ * @brief 시스템이 마지막으로 입력(키보드/마우스)을 받은 시각을 kp_now_ns 기준으로 반환합니다.
+ * @return unsigned long long 마지막 입력 시각 (알 수 없으면 0)
  */
-BOOL SendDecryptedKey(DWORD vkCode, BOOL isKeyDown) {
-    INPUT input = {0};
-    input.type = INPUT_KEYBOARD;
-    input.ki.wVk = (WORD)vkCode;
-    input.ki.dwFlags = isKeyDown ? 0 : KEYEVENTF_KEYUP;
-    input.ki.time = 0;
-    input.ki.dwExtraInfo = 0;
-    
-    UINT result = SendInput(1, &input, sizeof(INPUT));
-    return (result == 1);
+static unsigned long long LastSystemInputNs(unsigned long long now) {
+    LASTINPUTINFO info;
+    info.cbSize = sizeof(info);
+    if (!GetLastInputInfo(&info)) {
+        return 0;
+    }
+    unsigned long long idleNs = (unsigned long long)(DWORD)(GetTickCount() - info.dwTime) * 1000000ULL;
+    return (idleNs < now) ? now - idleNs : 0;
 }
 
 /**
- * @brief 키보드 입력이 발생할 때마다 호출되는 저수준 키보드 후크 프로시저
- * @param nCode 후크 프로시저가 메시지를 처리할지 다음 프로시저로 전달할지 결정하는 코드
- * @param wParam 메시지 타입 (WM_KEYDOWN, WM_KEYUP, WM_SYSKEYDOWN, WM_SYSKEYUP)
- * @param lParam KBDLLHOOKSTRUCT 구조체에 대한 포인터
- * @return LRESULT 메시지를 차단하려면 0이 아닌 값을 반환, 전달하려면 CallNextHookEx의 반환값을 반환
+ * @brief 후크 감시 스레드 함수
+ * @details WATCHDOG_PERIOD_MS마다 지연 예산 구간을 마감하고, 단계가 바뀌면 포그라운드 조회 방식을 맞춥니다.
+ *          입력이 있었는데 후크가 호출되지 않으면 탐침 키를 보내고, 탐침도 오지 않으면 이벤트 루프에 재설치를 요청합니다.
  */
-LRESULT CALLBACK LowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam) {
-    // nCode가 0보다 작으면 시스템에서 후크를 처리해야 함
-    if (nCode >= 0) {
-        // 키보드 데이터 구조체 포인터
-        KBDLLHOOKSTRUCT* pKbdStruct = (KBDLLHOOKSTRUCT*)lParam;
+static void WatchdogThread(void* arg) {
+    (void)arg;
+    hook_degrade_level level = hook_governor_level(&g_hookGovernor);
+    
+    while (!g_watchdogStop) {
+        kp_event_wait(&g_watchdogWake, WATCHDOG_PERIOD_MS);
+        if (g_watchdogStop) {
+            break;
+        }
+        unsigned long long now = kp_now_ns();
+        hook_governor_action action = hook_governor_tick(&g_hookGovernor, now, LastSystemInputNs(now));
         
-        // Esc 키 (VK_ESCAPE)는 종료를 위해 예외적으로 허용
-        if (pKbdStruct->vkCode == VK_ESCAPE) {
-            printf("\n[알림] Esc 키가 눌렸습니다. 후크를 해제하고 종료합니다.\n");
-            // 프로그램 종료 신호 전송
-            g_running = FALSE;
-            PostQuitMessage(0);
-            // 다음 후크로 전달 (즉, 차단하지 않음)
-            return CallNextHookEx(g_keyboardHook, nCode, wParam, lParam);
+        hook_degrade_level current = hook_governor_level(&g_hookGovernor);
+        if (current != level) {
+            Win32SetLightweightForeground(current >= HOOK_LEVEL_LIGHT_LOOKUP);
+            printf("[감시] 후크 지연 %llu us: 부가 작업 단계 %s -> %s\n",
+                   (unsigned long long)(g_hookGovernor.last_window_max_ns / 1000ULL),
+                   hook_governor_level_name(level), hook_governor_level_name(current));
+            level = current;
         }
         
-        // 키 다운 이벤트 처리
-        if (wParam == WM_KEYDOWN || wParam == WM_SYSKEYDOWN) {
-            // 원본 키 코드
-            unsigned int original_keycode = (unsigned int)pKbdStruct->vkCode;
-            
-            // 솔트 생성: 현재 시간(밀리초)을 기반으로 생성
-            unsigned int salt = GetTickCount();
-            
-            // 키 코드 암호화
-            unsigned int encrypted_keycode = encrypt_keycode_with_salt(original_keycode, salt);
-            
-            // 솔트와 암호화된 키 코드 저장 (복호화를 위해)
-            // 키 코드는 0-255 범위이므로 배열 인덱스로 사용 가능
-            if (original_keycode < 256) {
-                g_keySalt[original_keycode] = salt;
-                g_encryptedKeycode[original_keycode] = encrypted_keycode;
-            }
-            
-            // 암호화된 키 코드 출력
-            printf("[키 감지] 원본 KeyCode: %u | 솔트: %u | 암호화된 KeyCode: %u\n", 
-                   original_keycode, salt, encrypted_keycode);
-            
-            // 현재 포커스된 프로세스 확인
-            char processName[MAX_PATH] = {0};
-            if (GetCurrentProcessName(processName, MAX_PATH)) {
-                if (IsAllowedProcess(processName)) {
-                    // 허용된 프로세스: 복호화하여 전달
-                    unsigned int decrypted_keycode = decrypt_keycode_with_salt(encrypted_keycode, salt);
-                    printf("[복호화] 프로세스: %s | 복호화된 KeyCode: %u\n", processName, decrypted_keycode);
-                    
-                    // 복호화된 키를 SendInput으로 전달
-                    SendDecryptedKey(decrypted_keycode, TRUE);
-                    
-                    // 원본 키 입력은 차단
-                    return 1; // 키 입력 차단
-                } else {
-                    // 허용되지 않은 프로세스: 키 입력 차단
-                    printf("[차단] 프로세스: %s | 키 입력이 차단되었습니다.\n", processName);
-                    return 1; // 키 입력 차단
-                }
-            } else {
-                // 프로세스 이름을 가져올 수 없는 경우: 안전을 위해 차단
-                printf("[경고] 프로세스 정보를 가져올 수 없습니다. 키 입력을 차단합니다.\n");
-                return 1; // 키 입력 차단
-            }
+        if (action == HOOK_ACTION_PROBE) {
+            Win32SendHookProbe();
+        } else if (action == HOOK_ACTION_REINSTALL) {
+            fprintf(stderr, "[감시] 키보드 후크가 호출되지 않습니다. 후크를 다시 설치합니다.\n");
+            SetEvent(g_hookReinstallEvent);
         }
-        // 키 업 이벤트 처리
-        else if (wParam == WM_KEYUP || wParam == WM_SYSKEYUP) {
-            unsigned int original_keycode = (unsigned int)pKbdStruct->vkCode;
-            
-            // 현재 포커스된 프로세스 확인
-            char processName[MAX_PATH] = {0};
-            if (GetCurrentProcessName(processName, MAX_PATH)) {
-                if (IsAllowedProcess(processName)) {
-                    // 허용된 프로세스: 복호화된 키 업 이벤트 전달
-                    if (original_keycode < 256 && g_keySalt[original_keycode] != 0) {
-                        unsigned int decrypted_keycode = decrypt_keycode_with_salt(
-                            g_encryptedKeycode[original_keycode], 
-                            g_keySalt[original_keycode]
-                        );
-                        SendDecryptedKey(decrypted_keycode, FALSE);
-                        
-                        // 솔트 초기화 (다음 키 입력을 위해)
-                        g_keySalt[original_keycode] = 0;
-                        g_encryptedKeycode[original_keycode] = 0;
-                    }
-                    
-                    // 원본 키 입력은 차단
-                    return 1; // 키 입력 차단
-                } else {
-                    // 허용되지 않은 프로세스: 키 입력 차단
-                    if (original_keycode < 256) {
-                        // 솔트 초기화
-                        g_keySalt[original_keycode] = 0;
-                        g_encryptedKeycode[original_keycode] = 0;
-                    }
-                    return 1; // 키 입력 차단
-                }
-            } else {
-                // 프로세스 이름을 가져올 수 없는 경우: 안전을 위해 차단
-                if (original_keycode < 256) {
-                    // 솔트 초기화
-                    g_keySalt[original_keycode] = 0;
-                    g_encryptedKeycode[original_keycode] = 0;
-                }
-                return 1; // 키 입력 차단
+    }
+}
+
+/**
+ * @brief 후크 감시 스레드를 시작합니다.
+ */
+static void StartWatchdog(void) {
+    g_watchdogStop = 0;
+    if (!kp_event_init(&g_watchdogWake)) {
+        fprintf(stderr, "[경고] 후크 감시 스레드를 시작할 수 없습니다.\n");
+        return;
+    }
+    if (!kp_thread_start(&g_watchdogThread, WatchdogThread, NULL)) {
+        kp_event_destroy(&g_watchdogWake);
+        fprintf(stderr, "[경고] 후크 감시 스레드를 시작할 수 없습니다.\n");
+        return;
+    }
+    g_watchdogRunning = TRUE;
+}
+
+/**
+ * @brief 후크 감시 스레드를 멈춥니다.
+ */
+static void StopWatchdog(void) {
+    if (!g_watchdogRunning) {
+        return;
+    }
+    g_watchdogStop = 1;
+    kp_event_signal(&g_watchdogWake);
+    kp_thread_join(&g_watchdogThread);
+    kp_event_destroy(&g_watchdogWake);
+    g_watchdogRunning = FALSE;
+}
+
+/**
+ * @brief WH_KEYBOARD_LL 저수준 키보드 후크를 시스템 전역에 설치합니다.
+ * @details 메시지 루프를 도는 스레드(이벤트 루프 스레드)에서만 호출해야 합니다.
+ * @return BOOL 설치에 성공하면 TRUE
+ */
+static BOOL InstallKeyboardHook(void) {
+    g_keyboardHook = SetWindowsHookEx(
+        WH_KEYBOARD_LL,           // 후크 타입
+        LowLevelKeyboardProc,     // 후크 프로시저
+        GetModuleHandle(NULL),    // 인스턴스 핸들
+        0                         // 스레드 ID (0 = 시스템 전역)
+    );
+    return g_keyboardHook != NULL;
+}
+
+/**
+ * @brief 시스템이 제거한 것으로 보이는 키보드 후크를 다시 설치합니다. (이벤트 루프 스레드)
+ */
+static void ReinstallKeyboardHook(void) {
+    if (g_keyboardHook != NULL) {
+        // 시스템이 이미 제거한 후크라면 실패하지만 무시해도 됨
+        UnhookWindowsHookEx(g_keyboardHook);
+        g_keyboardHook = NULL;
+    }
+    if (!InstallKeyboardHook()) {
+        fprintf(stderr, "[오류] 키보드 후크를 다시 설치할 수 없습니다. (Error Code: %lu)\n", GetLastError());
+        return;
+    }
+    hook_governor_reinstalled(&g_hookGovernor, kp_now_ns());
+    printf("[감시] 키보드 후크를 다시 설치했습니다.\n");
+}
+
+/**
+ * @brief 제어 채널 요청 처리 콜백 (이벤트 루프 스레드에서 호출)
+ */
+static void HandleControlRequest(const control_message* request, control_message* reply, void* user) {
+    (void)user;
+    switch (request->header.type) {
+    case CONTROL_PING:
+        control_message_set_status(reply, CONTROL_OK);
+        break;
+    case CONTROL_STATS: {
+        control_stats stats;
+        FillControlStats(&stats);
+        control_message_set_status(reply, CONTROL_OK);
+        control_message_append(reply, &stats, sizeof(stats));
+        break;
+    }
+    case CONTROL_RELOAD:
+        printf("[제어] 설정 파일 리로드 요청\n");
+        control_message_set_status(reply, ReloadConfiguration() ? CONTROL_OK : CONTROL_ERR_FAILED);
+        break;
+    case CONTROL_SET_VERBOSITY: {
+        uint32_t verbosity = 0;
+        if (request->header.length != sizeof(verbosity)) {
+            control_message_set_status(reply, CONTROL_ERR_INVALID);
+            break;
+        }
+        memcpy(&verbosity, request->payload, sizeof(verbosity));
+        if (verbosity > LOG_VERBOSITY_ALL) {
+            control_message_set_status(reply, CONTROL_ERR_INVALID);
+            break;
+        }
+        // 다음 정책 리로드 때 config.ini의 [Logging] Verbosity로 되돌아감
+        log_ring_set_verbosity(&g_logRing, (int)verbosity);
+        printf("[제어] 로그 상세 수준을 %u(으)로 변경했습니다.\n", (unsigned int)verbosity);
+        control_message_set_status(reply, CONTROL_OK);
+        break;
+    }
+    case CONTROL_SHUTDOWN:
+        RequestShutdown(SHUTDOWN_CONTROL);
+        control_message_set_status(reply, CONTROL_OK);
+        break;
+#if KP_FEATURE_SHADOW
+    case CONTROL_SHADOW_REPORT: {
+        if (!g_shadowMode && !g_shadowCandidate) {
+            control_message_set_status(reply, CONTROL_ERR_FAILED);
+            break;
+        }
+        // 응답 본문: 상태 뒤에 보고서 경로 (본문에 들어가는 만큼)
+        size_t length = strlen(g_shadowReportPath);
+        if (length > CONTROL_PAYLOAD_MAX - sizeof(uint32_t)) {
+            length = CONTROL_PAYLOAD_MAX - sizeof(uint32_t);
+        }
+        control_message_set_status(reply, WriteShadowReport() ? CONTROL_OK : CONTROL_ERR_FAILED);
+        control_message_append(reply, g_shadowReportPath, length);
+        break;
+    }
+#endif // KP_FEATURE_SHADOW
+    case CONTROL_SUBSCRIBE:
+    case CONTROL_UNSUBSCRIBE: {
+        uint32_t processId = 0;
+        if (request->header.length != sizeof(processId)) {
+            control_message_set_status(reply, CONTROL_ERR_INVALID);
+            break;
+        }
+        memcpy(&processId, request->payload, sizeof(processId));
+        if (request->header.type == CONTROL_SUBSCRIBE) {
+            control_status status = SubscribeDelivery((DWORD)processId, reply);
+            if (status != CONTROL_OK) {
+                control_message_set_status(reply, status);
             }
+            break;
         }
+        DeliverySlot* slot = (processId == g_controlServer.client_pid) ? FindDeliverySlot((DWORD)processId) : NULL;
+        if (slot != NULL) {
+            CloseDeliverySlot(slot);
+        }
+        control_message_set_status(reply, (slot != NULL) ? CONTROL_OK : CONTROL_ERR_INVALID);
+        break;
     }
-    
-    // 이외의 모든 메시지는 다음 후크로 전달
-    return CallNextHookEx(g_keyboardHook, nCode, wParam, lParam);
+    default:
+        control_message_set_status(reply, CONTROL_ERR_UNKNOWN);
+        break;
+    }
+}
+
+/**
+ * @brief 제어 채널 이름을 지정합니다.
+ * @details SetHook() 전에 호출해야 합니다.
+ * @param name 채널 이름 (NULL이나 빈 문자열이면 제어 채널을 열지 않음)
+ * @return BOOL 이름이 너무 길면 FALSE
+ */
+BOOL SetControlChannelName(const char* name) {
+    if (name == NULL || name[0] == '\0') {
+        g_controlName[0] = '\0';
+        return TRUE;
+    }
+    if (strlen(name) >= sizeof(g_controlName)) {
+        return FALSE;
+    }
+    strcpy_s(g_controlName, sizeof(g_controlName), name);
+    return TRUE;
 }
 
 /**
@@ -349,15 +1772,73 @@ void SetHook() {
     // Windows XP에서는 관리자 권한 확인을 건너뜀
     // 후크는 성공하면 자동으로 실행됨
 
-    // WH_KEYBOARD_LL (저수준 키보드 후크)를 시스템 전역에 설치
-    g_keyboardHook = SetWindowsHookEx(
-        WH_KEYBOARD_LL,           // 후크 타입
-        LowLevelKeyboardProc,     // 후크 프로시저
-        GetModuleHandle(NULL),    // 인스턴스 핸들
-        0                         // 스레드 ID (0 = 시스템 전역)
-    );
+    // 자체 주입 키를 식별할 세션 서명 생성
+    Win32InitInjectionSignature();
+    
+    // 후크와 제어 채널이 신호할 종료 이벤트
+    g_shutdownEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+    if (g_shutdownEvent == NULL) {
+        fprintf(stderr, "[오류] 종료 이벤트를 만들 수 없습니다. (Error Code: %lu)\n", GetLastError());
+        exit(1);
+    }
+    g_startNs = kp_now_ns();
+    
+    // 포그라운드 판정 캐시, 로그 링, 정책 저장소 초기화 (후크가 설치되자마자 사용됨)
+    foreground_cache_init(&g_foregroundCache, &g_win32ProcessProvider, AllowedProcessVerdict, NULL);
+    log_ring_init(&g_logRing, LOG_VERBOSITY_ALL);
+    policy_store_init(&g_policyStore);
+#if KP_FEATURE_SHADOW
+    policy_store_init(&g_candidateStore);
+    shadow_audit_init(&g_shadowAudit);
+#endif
+
+    // 세션 난수 키로 키스트림 풀을 채우고 백그라운드 생성 스레드 시작
+    if (!keystream_pool_start(&g_keystreamPool, NULL, 0)) {
+        fprintf(stderr, "[오류] 키스트림 생성기를 시작할 수 없습니다.\n");
+        exit(1);
+    }
+    printf("[정보] 키스트림 생성 커널: %s\n", keystream_kernel_name(g_keystreamPool.kernel));
+
+    // 키 이벤트 처리 코어와 작업 스레드 시작 (후크가 설치되기 전에 준비)
+    // 주입 묶음은 큐가 빌 때마다 작업 스레드가 내보냄
+    key_processor_init(&g_keyProcessor, &g_foregroundCache, &g_win32ProcessorBackend, &g_keyPipeline);
+    // 이후 Caps Lock 상태는 주입하는 키로 따라감 (작업 스레드의 GetKeyState는 주입 결과를 늦게 반영함)
+    inject_batch_init(&g_injectBatch, &g_win32InjectSink, 0, 0);
+    inject_batch_set_caps_lock(&g_injectBatch, GetKeyState(VK_CAPITAL) & 1);
+    if (!key_pipeline_start(&g_keyPipeline, ProcessKeyEvent, FlushInjectBatch, NULL)) {
+        fprintf(stderr, "[오류] 키 이벤트 작업 스레드를 시작할 수 없습니다.\n");
+        exit(1);
+    }
+    
+    // 단계별 지연 히스토그램을 외부에서 읽을 수 있도록 공유 메모리 통계 블록 연결
+    OpenStatsBlock();
+    key_pipeline_attach_stats(&g_keyPipeline, g_statsBlock);
+    
+    // 후크 지연 예산 관리자 (예산은 정책이 게시될 때 [Hook] LatencyBudgetUs로 갱신됨)
+    hook_governor_config governorConfig;
+    hook_governor_default_config(&governorConfig, g_statsBlock->hook_timeout_ms, 0);
+    hook_governor_init(&g_hookGovernor, &governorConfig, kp_now_ns());
+    g_hookReinstallEvent = CreateEventA(NULL, FALSE, FALSE, NULL);
+    if (g_hookReinstallEvent == NULL) {
+        fprintf(stderr, "[오류] 후크 재설치 이벤트를 만들 수 없습니다. (Error Code: %lu)\n", GetLastError());
+        exit(1);
+    }
 
-    if (g_keyboardHook == NULL) {
+    // INI 파일에서 허용 프로세스 목록과 로그 설정 로드
+    // (그림자 모드 여부는 후크가 첫 키를 받기 전에 정해져야 하므로 후크 설치 전에 로드)
+    LoadAllowedProcessesFromIni(NULL);
+#if KP_FEATURE_KEY_LOG
+    StartLogging();
+#endif
+#if KP_FEATURE_SHADOW
+    StartShadowAudit();
+#endif
+
+    // 장치별 규칙을 위한 키보드 Raw Input 수신 (후크 이벤트와 짝지을 수 있도록 후크보다 먼저 등록)
+    StartRawInput();
+
+    // WH_KEYBOARD_LL (저수준 키보드 후크)를 시스템 전역에 설치
+    if (!InstallKeyboardHook()) {
         DWORD error = GetLastError();
         fprintf(stderr, "[오류] 키보드 후크 설치에 실패했습니다. (Error Code: %lu)\n", error);
         if (error == ERROR_ACCESS_DENIED) {
@@ -366,25 +1847,265 @@ void SetHook() {
         exit(1);
     }
     
-    // INI 파일에서 허용 프로세스 목록 로드
-    LoadAllowedProcessesFromIni(NULL);
+    // 포그라운드 창 변경 알림 등록 (판정 캐시 무효화용)
+    // WINEVENT_OUTOFCONTEXT 콜백은 메시지 루프를 도는 이 스레드에서 호출됩니다.
+    g_foregroundEventHook = SetWinEventHook(
+        EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND,
+        NULL, ForegroundChangedProc, 0, 0, WINEVENT_OUTOFCONTEXT
+    );
+    if (g_foregroundEventHook == NULL) {
+        // 알림 없이는 판정 캐시가 무효화되지 않으므로, 첫 창의 허용 판정이 다른 창에 쓰이지 않도록 키마다 확인
+        fprintf(stderr, "[경고] 포그라운드 변경 알림 등록에 실패했습니다. 키마다 포그라운드 창을 확인합니다. (Error Code: %lu)\n",
+                GetLastError());
+        foreground_cache_set_verify(&g_foregroundCache, 1);
+    }
+    
+    // 후크 지연 감시 (예산 초과 시 부가 작업 축소, 후크가 제거되면 재설치 요청)
+    StartWatchdog();
+    
+    // config.ini 변경 감시 시작 (변경 시 후크를 멈추지 않고 정책만 교체, 알림은 이벤트 루프가 처리)
+    g_configWatchEnabled = config_reloader_init(&g_configReloader, g_configPath, &g_policyStore,
+                                                config_reloader_load_file, OnPolicyPublished, NULL);
+    if (g_configWatchEnabled) {
+        printf("[설정] 설정 파일 변경을 감시합니다. 저장하면 자동으로 다시 로드됩니다.\n");
+    } else {
+        fprintf(stderr, "[경고] 설정 파일 변경 감시를 시작할 수 없습니다. 자동 리로드가 비활성화됩니다.\n");
+    }
+    
+    // 로컬 제어 채널 (통계 조회, 리로드, 로그 상세 수준, 종료)
+    if (g_controlName[0] != '\0') {
+        g_controlEnabled = control_server_open(&g_controlServer, g_controlName, HandleControlRequest, NULL);
+        if (g_controlEnabled) {
+            printf("[정보] 제어 채널: \\\\.\\pipe\\%s\n", g_controlName);
+        } else {
+            fprintf(stderr, "[경고] 제어 채널을 열 수 없습니다: %s (이미 실행 중인 인스턴스가 있을 수 있습니다)\n",
+                    g_controlName);
+        }
+    }
     
     printf("[성공] 키보드 보안 툴이 실행되었습니다. 모든 키 입력이 암호화되어 출력됩니다.\n");
     if (isAdmin) {
         printf("[정보] 관리자 권한으로 실행 중입니다.\n");
     }
     printf("---------------------------------------------------------\n");
-    printf("Esc 키를 눌러 종료하십시오.\n\n");
+    unsigned int exitKey = CURRENT_EXIT_KEY();
+    if (exitKey == VK_ESCAPE) {
+        printf("Esc 키를 눌러 종료하십시오.\n\n");
+    } else if (exitKey != 0) {
+        printf("종료 키(가상 키 0x%02X)를 눌러 종료하십시오.\n\n", exitKey);
+    } else {
+#if KP_EXIT_KEY == KP_EXIT_KEY_RUNTIME
+        printf("종료 키가 없습니다. ([KeyPolicy] ExitKey=none) Ctrl+Alt+Del로 작업 관리자를 열어 종료하십시오.\n\n");
+#else
+        printf("종료 키 없이 빌드되었습니다. kp_ctl shutdown이나 작업 관리자로 종료하십시오.\n\n");
+#endif
+    }
+}
+
+/**
+ * @brief 다음 타이머 만료까지 남은 시간을 계산합니다.
+ * @param now 현재 시각 (kp_now_ns)
+ * @param nextTickNs 다음 정리 작업 시각
+ * @return DWORD MsgWaitForMultipleObjects 제한 시간 (밀리초)
+ */
+static DWORD NextTimerTimeout(unsigned long long now, unsigned long long nextTickNs) {
+    unsigned long long deadline = nextTickNs;
+    if (g_reloadDeadlineNs != 0 && g_reloadDeadlineNs < deadline) {
+        deadline = g_reloadDeadlineNs;
+    }
+    unsigned long long heldDeadline = g_rawInputEnabled ? input_correlator_deadline(&g_inputCorrelator) : 0;
+    if (heldDeadline != 0 && heldDeadline < deadline) {
+        deadline = heldDeadline;
+    }
+    if (deadline <= now) {
+        return 0;
+    }
+    // 밀리초 단위로 올림하여 만료 직전에 깨어나 다시 기다리는 일이 없도록 함
+    return (DWORD)((deadline - now + 999999ULL) / 1000000ULL);
+}
+
+/**
+ * @brief 후크 메시지, 종료 이벤트, 후크 재설치 요청, 제어 채널, 설정 파일 변경 알림, 타이머를 한 스레드에서 처리합니다.
+ * @details MsgWaitForMultipleObjects로 메시지와 커널 객체를 함께 기다립니다. 저수준 후크와 WinEvent 콜백은
+ *          메시지를 꺼내는 동안 이 스레드에서 호출되므로, 루프 안의 다른 작업은 모두 짧게 끝나야 합니다.
+ *          설정 파일이 바뀌면 CONFIG_RELOAD_DEBOUNCE_MS 동안 추가 변경이 없을 때 다시 로드합니다.
+ * @return int 프로그램 종료 코드 (0: 정상 종료, 1: 대기 오류)
+ */
+int RunEventLoop(void) {
+    unsigned long long nextTickNs = kp_now_ns() + EVENT_LOOP_TICK_MS * 1000000ULL;
+    
+    for (;;) {
+        HANDLE handles[4];
+        DWORD count = 0;
+        handles[count++] = g_shutdownEvent;
+        handles[count++] = g_hookReinstallEvent;
+        HANDLE controlHandle = g_controlEnabled ? (HANDLE)control_server_wait_handle(&g_controlServer) : NULL;
+        if (controlHandle != NULL) {
+            handles[count++] = controlHandle;
+        }
+        HANDLE watchHandle = g_configWatchEnabled ? (HANDLE)file_watch_handle(&g_configReloader.watch) : NULL;
+        if (watchHandle != NULL) {
+            handles[count++] = watchHandle;
+        }
+        
+        // 다른 스레드에서 게시된 장치 규칙 반영 (장치 테이블은 이 스레드 전용)
+        ApplyPendingDeviceRules();
+        
+        DWORD timeout = NextTimerTimeout(kp_now_ns(), nextTickNs);
+        DWORD result = MsgWaitForMultipleObjects(count, handles, FALSE, timeout, QS_ALLINPUT);
+        if (result == WAIT_FAILED) {
+            fprintf(stderr, "[오류] 이벤트 루프 대기 오류가 발생했습니다. (Error Code: %lu)\n", GetLastError());
+            return 1;
+        }
+        
+        // 메시지 처리 (후크와 WinEvent 콜백이 이 안에서 호출됨)
+        MSG msg;
+        while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) {
+            if (msg.message == WM_QUIT) {
+                return (int)msg.wParam;
+            }
+            TranslateMessage(&msg);
+            DispatchMessage(&msg);
+        }
+        if (WaitForSingleObject(g_shutdownEvent, 0) == WAIT_OBJECT_0) {
+            return 0;
+        }
+        if (g_rawInputEnabled) {
+            // 짝이 오지 않은 채 기한이 지난 후크 이벤트를 장치 미상으로 내보냄
+            input_correlator_expire(&g_inputCorrelator, kp_now_ns());
+        }
+        
+        // 신호된 핸들만 확인하므로 신호되지 않은 대상은 비용이 거의 없음
+        if (WaitForSingleObject(g_hookReinstallEvent, 0) == WAIT_OBJECT_0) {
+            ReinstallKeyboardHook();
+        }
+        if (controlHandle != NULL) {
+            control_server_service(&g_controlServer);
+        }
+        if (watchHandle != NULL && file_watch_wait(&g_configReloader.watch, 0) > 0) {
+            // 편집기의 분할 저장에 대비해 마지막 변경 뒤 디바운스 시간이 지나면 리로드
+            file_watch_rearm(&g_configReloader.watch);
+            g_reloadDeadlineNs = kp_now_ns() + CONFIG_RELOAD_DEBOUNCE_MS * 1000000ULL;
+        }
+        
+        // 타이머: 예정된 리로드, 주기적인 이전 정책 스냅샷 회수와 종료된 구독자의 전달 채널 정리
+        unsigned long long now = kp_now_ns();
+        if (g_reloadDeadlineNs != 0 && now >= g_reloadDeadlineNs) {
+            ReloadConfiguration();
+        }
+#if KP_FEATURE_SHADOW
+        if (now >= g_nextShadowReportNs) {
+            // 며칠씩 켜 두는 그림자 모드에서 비정상 종료되어도 집계가 남도록 주기적으로 기록
+            if (g_shadowMode || g_shadowCandidate) {
+                WriteShadowReport();
+            }
+            g_nextShadowReportNs = now + SHADOW_REPORT_INTERVAL_MS * 1000000ULL;
+        }
+#endif // KP_FEATURE_SHADOW
+        if (now >= nextTickNs) {
+            policy_store_reclaim(&g_policyStore);
+#if KP_FEATURE_SHADOW
+            policy_store_reclaim(&g_candidateStore);
+#endif
+            ReapDeliverySlots();
+            nextTickNs = now + EVENT_LOOP_TICK_MS * 1000000ULL;
+        }
+    }
 }
 
 /**
  * @brief 설치된 키보드 후크를 해제하는 함수
  */
 void UnsetHook() {
+    // 감시 스레드가 해제 중인 후크에 탐침을 보내거나 재설치를 요청하지 않도록 먼저 멈춤
+    StopWatchdog();
+    if (g_foregroundEventHook != NULL) {
+        UnhookWinEvent(g_foregroundEventHook);
+        g_foregroundEventHook = NULL;
+    }
     if (g_keyboardHook != NULL) {
         UnhookWindowsHookEx(g_keyboardHook);
         g_keyboardHook = NULL;
     }
-    // 허용 프로세스 목록 해제
+    if (g_shutdownReason == SHUTDOWN_EXIT_KEY) {
+        printf("\n[알림] 종료 키가 눌렸습니다. 후크를 해제하고 종료합니다.\n");
+    } else if (g_shutdownReason == SHUTDOWN_CONTROL) {
+        printf("\n[알림] 제어 채널에서 종료 요청을 받았습니다. 후크를 해제하고 종료합니다.\n");
+    }
+    if (g_controlEnabled) {
+        control_server_close(&g_controlServer);
+        g_controlEnabled = FALSE;
+    }
+    // 후크가 해제된 뒤 짝을 기다리던 이벤트를 넘기고, 작업 스레드가 남은 이벤트를 처리하고 종료
+    // (전달 채널은 그 뒤에 닫음)
+    StopRawInput();
+    key_pipeline_stop(&g_keyPipeline);
+    CloseDeliverySlots();
+#if KP_FEATURE_SHADOW
+    if (g_shadowMode || g_shadowCandidate) {
+        if (WriteShadowReport()) {
+            printf("[그림자] 집계 보고서를 기록했습니다: %s\n", g_shadowReportPath);
+        }
+        printf("[통계] 그림자 집계: 키 다운 %lu | 자동 반복 %lu | 후보 정책과 다른 판정 %lu | 프로세스 %lu | "
+               "판정 평균 %llu ns, 최대 %llu ns\n",
+               g_shadowAudit.key_downs, g_shadowAudit.repeats, g_shadowAudit.disagreements,
+               g_shadowAudit.processes_used,
+               (unsigned long long)((g_shadowAudit.key_downs != 0) ?
+                   g_shadowAudit.eval_ns_total / g_shadowAudit.key_downs : 0),
+               (unsigned long long)g_shadowAudit.eval_ns_max);
+    }
+    kp_atomic_store(&g_shadowCandidate, 0);
+    policy_store_destroy(&g_candidateStore);
+#endif // KP_FEATURE_SHADOW
+#if KP_FEATURE_TRACE
+    StopTraceRecording();
+#endif
+    keystream_pool_stop(&g_keystreamPool);
+    // 설정 파일 감시를 끝낸 뒤 남은 로그 출력
+    config_reloader_stop(&g_configReloader);
+    g_configWatchEnabled = FALSE;
+#if KP_FEATURE_KEY_LOG
+    StopLogging();
+#endif
+    PrintPipelineStats();
+    PrintKeystreamStats();
+    printf("[통계] 키 규칙으로 차단한 키: %lu | 자동 반복 빠른 경로: %lu\n",
+           g_keyProcessor.rule_blocked, g_keyProcessor.repeats);
+    printf("[통계] 자체 주입 키 빠른 경로: %lu | 외부 주입 키 통과: %lu, 차단: %lu, 처리: %lu\n",
+           kp_atomic_load_relaxed(&g_injectionStats.selfPassed),
+           kp_atomic_load_relaxed(&g_injectionStats.foreignPassed),
+           kp_atomic_load_relaxed(&g_injectionStats.foreignBlocked),
+           kp_atomic_load_relaxed(&g_injectionStats.foreignProcessed));
+    printf("[통계] 공유 메모리 전달: %lu | 링이 가득 차 SendInput으로 주입: %lu\n",
+           g_deliveryStats.delivered, g_deliveryStats.fallbacks);
+    printf("[통계] 주입 묶음: 키 %lu | SendInput %lu회 | 최대 묶음 %lu | 크기 %lu, 기한 %lu, 포그라운드 변경 %lu, "
+           "유휴 %lu | 문자 주입 %lu | 실패 %lu\n",
+           g_injectBatch.stats.keys, g_injectBatch.stats.sends, g_injectBatch.stats.max_batch,
+           g_injectBatch.stats.flushes[INJECT_FLUSH_SIZE], g_injectBatch.stats.flushes[INJECT_FLUSH_DEADLINE],
+           g_injectBatch.stats.flushes[INJECT_FLUSH_FOREGROUND], g_injectBatch.stats.flushes[INJECT_FLUSH_IDLE],
+           g_injectBatch.stats.unicode_keys, g_injectBatch.stats.failed);
+    printf("[통계] Raw Input: %lu | 짝짓기 즉시 %lu, 붙잡아서 %lu, 늦게 %lu | 장치 미상 %lu | 붙잡기 %llu us | "
+           "장치 %d개\n",
+           g_inputCorrelator.stats.raw_events, g_inputCorrelator.stats.early_matches,
+           g_inputCorrelator.stats.held_matches, g_inputCorrelator.stats.late_matches,
+           g_inputCorrelator.stats.unmatched, g_inputCorrelator.hold_ns / 1000ULL, g_deviceTable.count);
+    printf("[통계] 신뢰 장치 키: %lu (키 단위 로그 생략 %lu) | 신뢰하지 않는 장치에서 차단한 키: %lu | "
+           "장치 미상 키에 Default 적용: %lu\n",
+           g_deviceStats.trustedKeys, kp_atomic_load_relaxed(&g_deviceStats.trustedLogSkipped),
+           g_deviceStats.untrustedBlocked, g_deviceStats.unknownDefault);
+    printf("[통계] 후크 지연 예산 초과: %lu | 단계 축소: %lu, 복구: %lu | 탐침: %lu | 후크 재설치: %lu\n",
+           g_hookGovernor.over_budget, g_hookGovernor.degradations, g_hookGovernor.recoveries,
+           g_hookGovernor.probes, g_hookGovernor.reinstalls);
+    // 허용 프로세스 목록과 이벤트 루프가 꺼내지 않은 장치 규칙 해제
     FreeAllowedProcesses();
+    free(kp_atomic_exchange(&g_pendingDeviceRules, (device_rules*)NULL));
+    CloseStatsBlock();
+    if (g_hookReinstallEvent != NULL) {
+        CloseHandle(g_hookReinstallEvent);
+        g_hookReinstallEvent = NULL;
+    }
+    if (g_shutdownEvent != NULL) {
+        CloseHandle(g_shutdownEvent);
+        g_shutdownEvent = NULL;
+    }
 }
\ No newline at end of file
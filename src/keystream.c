@@ -0,0 +1,433 @@
+#include "keystream.h"
+#include "kp_atomic.h"
+#include "kp_config.h"
+
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define KEYSTREAM_HAVE_X86 1
+#include <immintrin.h>
+#else
+#define KEYSTREAM_HAVE_X86 0
+#endif
+
+/** @brief 백그라운드 스레드가 깨우기 신호를 놓친 경우에 대비한 최대 대기 시간 (밀리초) */
+#define KEYSTREAM_IDLE_WAIT_MS 100
+
+/** @brief "expand 32-byte k" 상수 */
+static const uint32_t k_sigma[4] = { 0x61707865, 0x3320646e, 0x79622d32, 0x6b206574 };
+
+#define ROTL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define QUARTER_ROUND(a, b, c, d) \
+    a += b; d ^= a; d = ROTL32(d, 16); \
+    c += d; b ^= c; b = ROTL32(b, 12); \
+    a += b; d ^= a; d = ROTL32(d, 8);  \
+    c += d; b ^= c; b = ROTL32(b, 7)
+
+/**
+ * @brief ChaCha20 초기 상태를 만듭니다. (64비트 카운터, 64비트 논스)
+ */
+static void chacha_setup(uint32_t state[16], const uint32_t key[8], uint32_t stream, uint32_t nonce,
+                         uint64_t counter) {
+    memcpy(state, k_sigma, sizeof(k_sigma));
+    memcpy(state + 4, key, 8 * sizeof(uint32_t));
+    state[12] = (uint32_t)counter;
+    state[13] = (uint32_t)(counter >> 32);
+    state[14] = stream;
+    state[15] = nonce;
+}
+
+/**
+ * @brief 스칼라 커널: 블록을 하나씩 생성합니다.
+ */
+static void generate_scalar(const uint32_t key[8], uint32_t stream, uint32_t nonce, uint64_t counter,
+                            uint32_t* out, size_t blocks) {
+    uint32_t state[16];
+    for (size_t b = 0; b < blocks; b++) {
+        chacha_setup(state, key, stream, nonce, counter + b);
+        uint32_t x[16];
+        memcpy(x, state, sizeof(x));
+        for (int round = 0; round < 10; round++) {
+            QUARTER_ROUND(x[0], x[4], x[8],  x[12]);
+            QUARTER_ROUND(x[1], x[5], x[9],  x[13]);
+            QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+            QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+            QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+            QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+            QUARTER_ROUND(x[2], x[7], x[8],  x[13]);
+            QUARTER_ROUND(x[3], x[4], x[9],  x[14]);
+        }
+        for (int i = 0; i < 16; i++) {
+            out[b * KEYSTREAM_BLOCK_WORDS + i] = x[i] + state[i];
+        }
+    }
+}
+
+#if KEYSTREAM_HAVE_X86
+
+#define SSE_ROTL(v, n) _mm_or_si128(_mm_slli_epi32((v), (n)), _mm_srli_epi32((v), 32 - (n)))
+
+#define SSE_QUARTER_ROUND(a, b, c, d) \
+    a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = SSE_ROTL(d, 16); \
+    c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = SSE_ROTL(b, 12); \
+    a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = SSE_ROTL(d, 8);  \
+    c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = SSE_ROTL(b, 7)
+
+/**
+ * @brief SSE2 커널: 레인마다 블록 하나씩, 4블록을 병렬로 생성합니다.
+ * @details 벡터 x[i]의 레인 j는 (counter + j)번째 블록의 워드 i입니다.
+ */
+__attribute__((target("sse2"), force_align_arg_pointer))
+static void generate_sse2(const uint32_t key[8], uint32_t stream, uint32_t nonce, uint64_t counter,
+                          uint32_t* out, size_t blocks) {
+    uint32_t state[16];
+    uint32_t lanes[16][4];
+    while (blocks >= 4) {
+        chacha_setup(state, key, stream, nonce, counter);
+        __m128i x[16];
+        __m128i input[16];
+        for (int i = 0; i < 16; i++) {
+            input[i] = _mm_set1_epi32((int)state[i]);
+        }
+        // 블록별 카운터 (하위 워드 올림수는 상위 워드에 반영)
+        for (int j = 0; j < 4; j++) {
+            uint64_t c = counter + (uint64_t)j;
+            lanes[12][j] = (uint32_t)c;
+            lanes[13][j] = (uint32_t)(c >> 32);
+        }
+        input[12] = _mm_loadu_si128((const __m128i*)lanes[12]);
+        input[13] = _mm_loadu_si128((const __m128i*)lanes[13]);
+        memcpy(x, input, sizeof(x));
+
+        for (int round = 0; round < 10; round++) {
+            SSE_QUARTER_ROUND(x[0], x[4], x[8],  x[12]);
+            SSE_QUARTER_ROUND(x[1], x[5], x[9],  x[13]);
+            SSE_QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+            SSE_QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+            SSE_QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+            SSE_QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+            SSE_QUARTER_ROUND(x[2], x[7], x[8],  x[13]);
+            SSE_QUARTER_ROUND(x[3], x[4], x[9],  x[14]);
+        }
+        for (int i = 0; i < 16; i++) {
+            _mm_storeu_si128((__m128i*)lanes[i], _mm_add_epi32(x[i], input[i]));
+        }
+        for (int j = 0; j < 4; j++) {
+            for (int i = 0; i < 16; i++) {
+                out[j * KEYSTREAM_BLOCK_WORDS + i] = lanes[i][j];
+            }
+        }
+        out += 4 * KEYSTREAM_BLOCK_WORDS;
+        counter += 4;
+        blocks -= 4;
+    }
+    generate_scalar(key, stream, nonce, counter, out, blocks);
+}
+
+#define AVX_ROTL(v, n) _mm256_or_si256(_mm256_slli_epi32((v), (n)), _mm256_srli_epi32((v), 32 - (n)))
+
+#define AVX_QUARTER_ROUND(a, b, c, d) \
+    a = _mm256_add_epi32(a, b); d = _mm256_xor_si256(d, a); d = AVX_ROTL(d, 16); \
+    c = _mm256_add_epi32(c, d); b = _mm256_xor_si256(b, c); b = AVX_ROTL(b, 12); \
+    a = _mm256_add_epi32(a, b); d = _mm256_xor_si256(d, a); d = AVX_ROTL(d, 8);  \
+    c = _mm256_add_epi32(c, d); b = _mm256_xor_si256(b, c); b = AVX_ROTL(b, 7)
+
+/**
+ * @brief AVX2 커널: 8블록을 병렬로 생성합니다.
+ * @details 32비트 Windows 스택은 32바이트 정렬이 보장되지 않으므로 진입 시 스택을 다시 정렬합니다.
+ */
+__attribute__((target("avx2"), force_align_arg_pointer))
+static void generate_avx2(const uint32_t key[8], uint32_t stream, uint32_t nonce, uint64_t counter,
+                          uint32_t* out, size_t blocks) {
+    uint32_t state[16];
+    uint32_t lanes[16][8];
+    while (blocks >= 8) {
+        chacha_setup(state, key, stream, nonce, counter);
+        __m256i x[16];
+        __m256i input[16];
+        for (int i = 0; i < 16; i++) {
+            input[i] = _mm256_set1_epi32((int)state[i]);
+        }
+        for (int j = 0; j < 8; j++) {
+            uint64_t c = counter + (uint64_t)j;
+            lanes[12][j] = (uint32_t)c;
+            lanes[13][j] = (uint32_t)(c >> 32);
+        }
+        input[12] = _mm256_loadu_si256((const __m256i*)lanes[12]);
+        input[13] = _mm256_loadu_si256((const __m256i*)lanes[13]);
+        memcpy(x, input, sizeof(x));
+
+        for (int round = 0; round < 10; round++) {
+            AVX_QUARTER_ROUND(x[0], x[4], x[8],  x[12]);
+            AVX_QUARTER_ROUND(x[1], x[5], x[9],  x[13]);
+            AVX_QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+            AVX_QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+            AVX_QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+            AVX_QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+            AVX_QUARTER_ROUND(x[2], x[7], x[8],  x[13]);
+            AVX_QUARTER_ROUND(x[3], x[4], x[9],  x[14]);
+        }
+        for (int i = 0; i < 16; i++) {
+            _mm256_storeu_si256((__m256i*)lanes[i], _mm256_add_epi32(x[i], input[i]));
+        }
+        for (int j = 0; j < 8; j++) {
+            for (int i = 0; i < 16; i++) {
+                out[j * KEYSTREAM_BLOCK_WORDS + i] = lanes[i][j];
+            }
+        }
+        out += 8 * KEYSTREAM_BLOCK_WORDS;
+        counter += 8;
+        blocks -= 8;
+    }
+    generate_sse2(key, stream, nonce, counter, out, blocks);
+}
+
+#endif // KEYSTREAM_HAVE_X86
+
+/**
+ * @brief 커널을 이 CPU에서 사용할 수 있는지 확인합니다.
+ */
+int keystream_kernel_supported(keystream_kernel kernel) {
+    switch (kernel) {
+    case KEYSTREAM_KERNEL_SCALAR:
+        return 1;
+#if KEYSTREAM_HAVE_X86
+    case KEYSTREAM_KERNEL_SSE2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2") ? 1 : 0;
+    case KEYSTREAM_KERNEL_AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? 1 : 0;
+#endif
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief 이 CPU에서 사용할 수 있는 가장 빠른 커널을 반환합니다.
+ */
+keystream_kernel keystream_best_kernel(void) {
+    if (keystream_kernel_supported(KEYSTREAM_KERNEL_AVX2)) {
+        return KEYSTREAM_KERNEL_AVX2;
+    }
+    if (keystream_kernel_supported(KEYSTREAM_KERNEL_SSE2)) {
+        return KEYSTREAM_KERNEL_SSE2;
+    }
+    return KEYSTREAM_KERNEL_SCALAR;
+}
+
+/**
+ * @brief 커널 이름을 반환합니다.
+ */
+const char* keystream_kernel_name(keystream_kernel kernel) {
+    switch (kernel) {
+    case KEYSTREAM_KERNEL_SCALAR: return "scalar";
+    case KEYSTREAM_KERNEL_SSE2:   return "sse2";
+    case KEYSTREAM_KERNEL_AVX2:   return "avx2";
+    default:                      return "unknown";
+    }
+}
+
+/**
+ * @brief ChaCha20 키스트림 블록을 연속으로 생성합니다.
+ */
+void keystream_generate(keystream_kernel kernel, const uint32_t key[8], uint32_t stream, uint32_t nonce,
+                        uint64_t counter, uint32_t* out, size_t blocks) {
+#if KEYSTREAM_HAVE_X86
+    if (kernel == KEYSTREAM_KERNEL_AVX2) {
+        generate_avx2(key, stream, nonce, counter, out, blocks);
+        return;
+    }
+    if (kernel == KEYSTREAM_KERNEL_SSE2) {
+        generate_sse2(key, stream, nonce, counter, out, blocks);
+        return;
+    }
+#else
+    (void)kernel;
+#endif
+    generate_scalar(key, stream, nonce, counter, out, blocks);
+}
+
+/**
+ * @brief 풀을 채울 블록을 생성합니다.
+ * @details KP_KEYSTREAM_KERNEL로 커널을 고정한 빌드에서는 CPU 검사와 커널 분기 없이 해당 커널을 직접 호출합니다.
+ */
+static void pool_generate(const keystream_pool* pool, uint32_t* out, size_t blocks) {
+#if KP_KEYSTREAM_KERNEL == 2 && KEYSTREAM_HAVE_X86
+    generate_avx2(pool->key, KEYSTREAM_STREAM_REFILL, pool->nonce, pool->refill_counter, out, blocks);
+#elif KP_KEYSTREAM_KERNEL == 1 && KEYSTREAM_HAVE_X86
+    generate_sse2(pool->key, KEYSTREAM_STREAM_REFILL, pool->nonce, pool->refill_counter, out, blocks);
+#elif KP_KEYSTREAM_KERNEL != KP_KEYSTREAM_KERNEL_RUNTIME
+    generate_scalar(pool->key, KEYSTREAM_STREAM_REFILL, pool->nonce, pool->refill_counter, out, blocks);
+#else
+    keystream_generate(pool->kernel, pool->key, KEYSTREAM_STREAM_REFILL, pool->nonce,
+                       pool->refill_counter, out, blocks);
+#endif
+}
+
+/**
+ * @brief 풀에 빈 자리가 있는 만큼 블록을 생성하여 채웁니다. (백그라운드 스레드 전용)
+ */
+static void refill(keystream_pool* pool) {
+    uint32_t batch[KEYSTREAM_BATCH_BLOCKS * KEYSTREAM_BLOCK_WORDS];
+    while (!pool->stop &&
+           KEYSTREAM_POOL_WORDS - spsc_ring_size(&pool->ring) >= KEYSTREAM_BATCH_BLOCKS * KEYSTREAM_BLOCK_WORDS) {
+        pool_generate(pool, batch, KEYSTREAM_BATCH_BLOCKS);
+        pool->refill_counter += KEYSTREAM_BATCH_BLOCKS;
+        for (size_t i = 0; i < sizeof(batch) / sizeof(batch[0]); i++) {
+            spsc_ring_push(&pool->ring, &batch[i]);
+        }
+        kp_atomic_add_relaxed(&pool->stats.blocks, (unsigned long long)KEYSTREAM_BATCH_BLOCKS);
+    }
+    memset(batch, 0, sizeof(batch));
+}
+
+/**
+ * @brief 백그라운드 생성 스레드 함수
+ * @details 풀이 낮은 수위 아래로 내려갈 때까지 잠들며, 잠들기 전에 대기 상태를 먼저 게시하고
+ *          수위를 다시 확인하여 깨우기 신호를 놓치지 않도록 합니다.
+ */
+static void refill_thread(void* arg) {
+    keystream_pool* pool = (keystream_pool*)arg;
+    while (!pool->stop) {
+        refill(pool);
+
+        __atomic_store_n(&pool->refill_sleeping, 1, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (spsc_ring_size(&pool->ring) >= KEYSTREAM_POOL_LOW_WATER && !pool->stop) {
+            kp_event_wait(&pool->wake, KEYSTREAM_IDLE_WAIT_MS);
+        }
+        __atomic_store_n(&pool->refill_sleeping, 0, __ATOMIC_SEQ_CST);
+    }
+}
+
+/**
+ * @brief 풀을 초기화하고 백그라운드 생성 스레드를 시작합니다.
+ */
+int keystream_pool_start(keystream_pool* pool, const uint32_t key[8], uint32_t nonce) {
+    memset(pool, 0, sizeof(*pool));
+    spsc_ring_init(&pool->ring, pool->storage, sizeof(uint32_t), KEYSTREAM_POOL_WORDS);
+#if KP_KEYSTREAM_KERNEL == 2 && KEYSTREAM_HAVE_X86
+    pool->kernel = KEYSTREAM_KERNEL_AVX2;
+#elif KP_KEYSTREAM_KERNEL == 1 && KEYSTREAM_HAVE_X86
+    pool->kernel = KEYSTREAM_KERNEL_SSE2;
+#elif KP_KEYSTREAM_KERNEL != KP_KEYSTREAM_KERNEL_RUNTIME
+    pool->kernel = KEYSTREAM_KERNEL_SCALAR;
+#else
+    pool->kernel = keystream_best_kernel();
+#endif
+
+    if (key != NULL) {
+        memcpy(pool->key, key, sizeof(pool->key));
+        pool->nonce = nonce;
+    } else if (!kp_random_bytes(pool->key, sizeof(pool->key)) ||
+               !kp_random_bytes(&pool->nonce, sizeof(pool->nonce))) {
+        return 0;
+    }
+
+    // 첫 키 입력 전에 풀을 채워 둠
+    refill(pool);
+
+    if (!kp_event_init(&pool->wake)) {
+        return 0;
+    }
+    if (!kp_thread_start(&pool->thread, refill_thread, pool)) {
+        kp_event_destroy(&pool->wake);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief 다음 키스트림 워드를 꺼냅니다. (소비자 스레드 전용)
+ */
+uint32_t keystream_pool_next(keystream_pool* pool, uint32_t* position) {
+    uint32_t word;
+    unsigned long remaining = spsc_ring_size(&pool->ring);
+    if (remaining > 0 && spsc_ring_pop(&pool->ring, &word)) {
+        // 백그라운드 스레드는 블록을 카운터 순서대로 넣으므로 꺼낸 순번이 곧 스트림 0의 워드 번호
+        if (position != NULL) {
+            *position = pool->refill_taken & KEYSTREAM_POSITION_INDEX;
+        }
+        pool->refill_taken++;
+        kp_atomic_add_relaxed(&pool->stats.words_used, 1UL);
+        // 낮은 수위에 닿았고 백그라운드 스레드가 잠들어 있을 때만 깨움
+        if (remaining <= KEYSTREAM_POOL_LOW_WATER &&
+            __atomic_exchange_n(&pool->refill_sleeping, 0, __ATOMIC_SEQ_CST)) {
+            kp_atomic_add_relaxed(&pool->stats.refill_wakeups, 1UL);
+            kp_event_signal(&pool->wake);
+        }
+        return word;
+    }
+
+    // 풀이 비었음: 예비 스트림에서 직접 생성 (백그라운드 스트림과 논스가 다르므로 재사용 없음)
+    if (pool->fallback_used == 0 || pool->fallback_used == KEYSTREAM_BLOCK_WORDS) {
+        keystream_generate(KEYSTREAM_KERNEL_SCALAR, pool->key, KEYSTREAM_STREAM_FALLBACK, pool->nonce,
+                           pool->fallback_counter++, pool->fallback, 1);
+        pool->fallback_used = 0;
+        kp_atomic_add_relaxed(&pool->stats.underflows, 1UL);
+    }
+    kp_atomic_add_relaxed(&pool->stats.words_used, 1UL);
+    if (__atomic_exchange_n(&pool->refill_sleeping, 0, __ATOMIC_SEQ_CST)) {
+        kp_event_signal(&pool->wake);
+    }
+    if (position != NULL) {
+        uint64_t index = (pool->fallback_counter - 1) * KEYSTREAM_BLOCK_WORDS + pool->fallback_used;
+        *position = KEYSTREAM_POSITION_FALLBACK | ((uint32_t)index & KEYSTREAM_POSITION_INDEX);
+    }
+    return pool->fallback[pool->fallback_used++];
+}
+
+/**
+ * @brief 키스트림 위치의 워드를 다시 만듭니다.
+ * @details 워드가 들어 있는 블록 하나만 스칼라 커널로 생성합니다.
+ */
+uint32_t keystream_word_at(const uint32_t key[8], uint32_t nonce, uint32_t position) {
+    uint32_t block[KEYSTREAM_BLOCK_WORDS];
+    uint32_t stream = (position & KEYSTREAM_POSITION_FALLBACK) ? KEYSTREAM_STREAM_FALLBACK : KEYSTREAM_STREAM_REFILL;
+    uint32_t index = position & KEYSTREAM_POSITION_INDEX;
+    generate_scalar(key, stream, nonce, index / KEYSTREAM_BLOCK_WORDS, block, 1);
+    uint32_t word = block[index % KEYSTREAM_BLOCK_WORDS];
+    volatile uint32_t* p = block;
+    for (size_t i = 0; i < KEYSTREAM_BLOCK_WORDS; i++) {
+        p[i] = 0;
+    }
+    return word;
+}
+
+/**
+ * @brief 통계 사본을 가져옵니다.
+ */
+void keystream_pool_get_stats(const keystream_pool* pool, keystream_stats* stats) {
+    stats->words_used = kp_atomic_load_relaxed(&pool->stats.words_used);
+    stats->underflows = kp_atomic_load_relaxed(&pool->stats.underflows);
+    stats->refill_wakeups = kp_atomic_load_relaxed(&pool->stats.refill_wakeups);
+    stats->blocks = kp_atomic_load_relaxed(&pool->stats.blocks);
+}
+
+/**
+ * @brief 백그라운드 스레드를 멈추고 키 자료를 지웁니다.
+ */
+void keystream_pool_stop(keystream_pool* pool) {
+    if (pool->thread.started) {
+        pool->stop = 1;
+        kp_event_signal(&pool->wake);
+        kp_thread_join(&pool->thread);
+        kp_event_destroy(&pool->wake);
+    }
+    // 남은 키스트림과 키를 메모리에서 지움
+    volatile unsigned char* p = (volatile unsigned char*)pool->storage;
+    for (size_t i = 0; i < sizeof(pool->storage); i++) {
+        p[i] = 0;
+    }
+    p = (volatile unsigned char*)pool->key;
+    for (size_t i = 0; i < sizeof(pool->key); i++) {
+        p[i] = 0;
+    }
+    p = (volatile unsigned char*)pool->fallback;
+    for (size_t i = 0; i < sizeof(pool->fallback); i++) {
+        p[i] = 0;
+    }
+}
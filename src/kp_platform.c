@@ -0,0 +1,540 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "kp_platform.h"
+
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <stdio.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef _WIN32
+/**
+ * @brief RtlGenRandom (advapi32, Windows XP 이상)
+ * @details 공개 헤더(ntsecapi.h) 없이 사용하기 위해 직접 선언합니다.
+ */
+BOOLEAN NTAPI SystemFunction036(PVOID RandomBuffer, ULONG RandomBufferLength);
+#endif
+
+#ifdef _WIN32
+
+/**
+ * @brief Win32 스레드 진입점에서 kp_thread_fn을 호출하는 트램펄린
+ */
+static DWORD WINAPI ThreadTrampoline(LPVOID param) {
+    kp_thread* thread = (kp_thread*)param;
+    thread->fn(thread->arg);
+    return 0;
+}
+
+int kp_thread_start(kp_thread* thread, kp_thread_fn fn, void* arg) {
+    thread->fn = fn;
+    thread->arg = arg;
+    thread->handle = CreateThread(NULL, 0, ThreadTrampoline, thread, 0, NULL);
+    thread->started = (thread->handle != NULL);
+    return thread->started;
+}
+
+void kp_thread_join(kp_thread* thread) {
+    if (!thread->started) {
+        return;
+    }
+    WaitForSingleObject((HANDLE)thread->handle, INFINITE);
+    CloseHandle((HANDLE)thread->handle);
+    thread->handle = NULL;
+    thread->started = 0;
+}
+
+int kp_event_init(kp_event* event) {
+    event->handle = CreateEventA(NULL, FALSE, FALSE, NULL);
+    return event->handle != NULL;
+}
+
+void kp_event_signal(kp_event* event) {
+    SetEvent((HANDLE)event->handle);
+}
+
+int kp_event_wait(kp_event* event, unsigned int timeout_ms) {
+    return WaitForSingleObject((HANDLE)event->handle, timeout_ms) == WAIT_OBJECT_0;
+}
+
+void kp_event_destroy(kp_event* event) {
+    if (event->handle != NULL) {
+        CloseHandle((HANDLE)event->handle);
+        event->handle = NULL;
+    }
+}
+
+void kp_sleep_ms(unsigned int milliseconds) {
+    Sleep(milliseconds);
+}
+
+unsigned long long kp_now_ns(void) {
+    static LONGLONG frequency = 0;
+    LARGE_INTEGER counter;
+    if (frequency == 0) {
+        LARGE_INTEGER freq;
+        QueryPerformanceFrequency(&freq);
+        frequency = freq.QuadPart;
+    }
+    QueryPerformanceCounter(&counter);
+    // 오버플로를 피하기 위해 초 단위와 나머지를 나누어 변환
+    unsigned long long seconds = (unsigned long long)(counter.QuadPart / frequency);
+    unsigned long long remainder = (unsigned long long)(counter.QuadPart % frequency);
+    return seconds * 1000000000ULL + remainder * 1000000000ULL / (unsigned long long)frequency;
+}
+
+unsigned long long kp_wall_time_ns(void) {
+    // FILETIME은 1601-01-01 기준 100ns 단위
+    FILETIME now;
+    GetSystemTimeAsFileTime(&now);
+    unsigned long long ticks = ((unsigned long long)now.dwHighDateTime << 32) | now.dwLowDateTime;
+    return (ticks - 116444736000000000ULL) * 100ULL;
+}
+
+int kp_random_bytes(void* buffer, unsigned long size) {
+    return SystemFunction036(buffer, size) ? 1 : 0;
+}
+
+/**
+ * @brief 매핑 이름에 세션 로컬 네임스페이스 접두사를 붙입니다.
+ */
+static void SharedMemoryName(const char* name, char* fullName, size_t fullNameSize) {
+    _snprintf(fullName, fullNameSize, "Local\\%s", name);
+    fullName[fullNameSize - 1] = '\0';
+}
+
+int kp_shared_memory_create(kp_shared_memory* shm, const char* name, size_t size) {
+    char fullName[128];
+    SharedMemoryName(name, fullName, sizeof(fullName));
+    shm->address = NULL;
+    shm->size = size;
+    shm->handle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, (DWORD)size, fullName);
+    if (shm->handle == NULL) {
+        return 0;
+    }
+    shm->address = MapViewOfFile((HANDLE)shm->handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (shm->address == NULL) {
+        CloseHandle((HANDLE)shm->handle);
+        shm->handle = NULL;
+        return 0;
+    }
+    memset(shm->address, 0, size);
+    return 1;
+}
+
+int kp_shared_memory_open(kp_shared_memory* shm, const char* name, size_t size) {
+    char fullName[128];
+    SharedMemoryName(name, fullName, sizeof(fullName));
+    shm->address = NULL;
+    shm->size = size;
+    shm->handle = OpenFileMappingA(FILE_MAP_READ, FALSE, fullName);
+    if (shm->handle == NULL) {
+        return 0;
+    }
+    shm->address = MapViewOfFile((HANDLE)shm->handle, FILE_MAP_READ, 0, 0, size);
+    if (shm->address == NULL) {
+        CloseHandle((HANDLE)shm->handle);
+        shm->handle = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+int kp_shared_memory_attach(kp_shared_memory* shm, const char* name, size_t size) {
+    char fullName[128];
+    SharedMemoryName(name, fullName, sizeof(fullName));
+    shm->address = NULL;
+    shm->size = size;
+    shm->handle = OpenFileMappingA(FILE_MAP_READ | FILE_MAP_WRITE, FALSE, fullName);
+    if (shm->handle == NULL) {
+        return 0;
+    }
+    shm->address = MapViewOfFile((HANDLE)shm->handle, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, size);
+    if (shm->address == NULL) {
+        CloseHandle((HANDLE)shm->handle);
+        shm->handle = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+void kp_shared_memory_close(kp_shared_memory* shm) {
+    if (shm->address != NULL) {
+        UnmapViewOfFile(shm->address);
+        shm->address = NULL;
+    }
+    if (shm->handle != NULL) {
+        CloseHandle((HANDLE)shm->handle);
+        shm->handle = NULL;
+    }
+}
+
+int kp_named_event_create(kp_named_event* event, const char* name) {
+    char fullName[128];
+    SharedMemoryName(name, fullName, sizeof(fullName));
+    event->owner = 1;
+    event->name[0] = '\0';
+    event->handle = CreateEventA(NULL, FALSE, FALSE, fullName);
+    if (event->handle != NULL && GetLastError() == ERROR_ALREADY_EXISTS) {
+        // 다른 프로세스가 먼저 만든 이름은 사용하지 않음
+        CloseHandle((HANDLE)event->handle);
+        event->handle = NULL;
+    }
+    return event->handle != NULL;
+}
+
+int kp_named_event_open(kp_named_event* event, const char* name) {
+    char fullName[128];
+    SharedMemoryName(name, fullName, sizeof(fullName));
+    event->owner = 0;
+    event->name[0] = '\0';
+    event->handle = OpenEventA(EVENT_MODIFY_STATE | SYNCHRONIZE, FALSE, fullName);
+    return event->handle != NULL;
+}
+
+void kp_named_event_signal(kp_named_event* event) {
+    SetEvent((HANDLE)event->handle);
+}
+
+int kp_named_event_wait(kp_named_event* event, unsigned int timeout_ms) {
+    return WaitForSingleObject((HANDLE)event->handle, timeout_ms) == WAIT_OBJECT_0;
+}
+
+void kp_named_event_close(kp_named_event* event) {
+    if (event->handle != NULL) {
+        CloseHandle((HANDLE)event->handle);
+        event->handle = NULL;
+    }
+}
+
+int kp_file_map(kp_mapped_file* map, const char* path) {
+    map->address = NULL;
+    map->size = 0;
+    // 기록 중인 파일도 읽을 수 있도록 쓰기 공유 허용
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return 0;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        return 1;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL) {
+        return 0;
+    }
+    // 뷰가 매핑을 참조하므로 핸들은 바로 닫아도 됨
+    map->address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (map->address == NULL) {
+        return 0;
+    }
+    map->size = (size_t)size.QuadPart;
+    return 1;
+}
+
+void kp_file_unmap(kp_mapped_file* map) {
+    if (map->address != NULL) {
+        UnmapViewOfFile(map->address);
+        map->address = NULL;
+    }
+    map->size = 0;
+}
+
+unsigned long kp_process_id(void) {
+    return (unsigned long)GetCurrentProcessId();
+}
+
+#else
+
+/**
+ * @brief POSIX 스레드 진입점에서 kp_thread_fn을 호출하는 트램펄린
+ */
+static void* ThreadTrampoline(void* param) {
+    kp_thread* thread = (kp_thread*)param;
+    thread->fn(thread->arg);
+    return NULL;
+}
+
+int kp_thread_start(kp_thread* thread, kp_thread_fn fn, void* arg) {
+    thread->fn = fn;
+    thread->arg = arg;
+    thread->started = (pthread_create(&thread->handle, NULL, ThreadTrampoline, thread) == 0);
+    return thread->started;
+}
+
+void kp_thread_join(kp_thread* thread) {
+    if (!thread->started) {
+        return;
+    }
+    pthread_join(thread->handle, NULL);
+    thread->started = 0;
+}
+
+int kp_event_init(kp_event* event) {
+    event->signaled = 0;
+    if (pthread_mutex_init(&event->mutex, NULL) != 0) {
+        return 0;
+    }
+    if (pthread_cond_init(&event->cond, NULL) != 0) {
+        pthread_mutex_destroy(&event->mutex);
+        return 0;
+    }
+    return 1;
+}
+
+void kp_event_signal(kp_event* event) {
+    pthread_mutex_lock(&event->mutex);
+    event->signaled = 1;
+    pthread_cond_signal(&event->cond);
+    pthread_mutex_unlock(&event->mutex);
+}
+
+int kp_event_wait(kp_event* event, unsigned int timeout_ms) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    
+    pthread_mutex_lock(&event->mutex);
+    while (!event->signaled) {
+        if (pthread_cond_timedwait(&event->cond, &event->mutex, &deadline) != 0) {
+            break;
+        }
+    }
+    int signaled = event->signaled;
+    event->signaled = 0;
+    pthread_mutex_unlock(&event->mutex);
+    return signaled;
+}
+
+void kp_event_destroy(kp_event* event) {
+    pthread_cond_destroy(&event->cond);
+    pthread_mutex_destroy(&event->mutex);
+}
+
+void kp_sleep_ms(unsigned int milliseconds) {
+    struct timespec request;
+    request.tv_sec = milliseconds / 1000;
+    request.tv_nsec = (long)(milliseconds % 1000) * 1000000L;
+    while (nanosleep(&request, &request) != 0 && errno == EINTR) {
+        // 시그널로 깨어난 경우 남은 시간만큼 다시 대기
+    }
+}
+
+unsigned long long kp_now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+}
+
+unsigned long long kp_wall_time_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+}
+
+int kp_random_bytes(void* buffer, unsigned long size) {
+    FILE* source = fopen("/dev/urandom", "rb");
+    if (source == NULL) {
+        return 0;
+    }
+    size_t read = fread(buffer, 1, size, source);
+    fclose(source);
+    return read == size;
+}
+
+int kp_shared_memory_create(kp_shared_memory* shm, const char* name, size_t size) {
+    snprintf(shm->name, sizeof(shm->name), "/%s", name);
+    shm->address = NULL;
+    shm->size = size;
+    shm->owner = 1;
+    int fd = shm_open(shm->name, O_CREAT | O_RDWR, 0600);
+    if (fd < 0) {
+        return 0;
+    }
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        shm_unlink(shm->name);
+        return 0;
+    }
+    void* address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        shm_unlink(shm->name);
+        return 0;
+    }
+    memset(address, 0, size);
+    shm->address = address;
+    return 1;
+}
+
+int kp_shared_memory_open(kp_shared_memory* shm, const char* name, size_t size) {
+    snprintf(shm->name, sizeof(shm->name), "/%s", name);
+    shm->address = NULL;
+    shm->size = size;
+    shm->owner = 0;
+    int fd = shm_open(shm->name, O_RDONLY, 0);
+    if (fd < 0) {
+        return 0;
+    }
+    void* address = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        return 0;
+    }
+    shm->address = address;
+    return 1;
+}
+
+int kp_shared_memory_attach(kp_shared_memory* shm, const char* name, size_t size) {
+    snprintf(shm->name, sizeof(shm->name), "/%s", name);
+    shm->address = NULL;
+    shm->size = size;
+    shm->owner = 0;
+    int fd = shm_open(shm->name, O_RDWR, 0);
+    if (fd < 0) {
+        return 0;
+    }
+    void* address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        return 0;
+    }
+    shm->address = address;
+    return 1;
+}
+
+void kp_shared_memory_close(kp_shared_memory* shm) {
+    if (shm->address != NULL) {
+        munmap(shm->address, shm->size);
+        shm->address = NULL;
+    }
+    if (shm->owner) {
+        shm_unlink(shm->name);
+        shm->owner = 0;
+    }
+}
+
+int kp_named_event_create(kp_named_event* event, const char* name) {
+    snprintf(event->name, sizeof(event->name), "/%s", name);
+    event->owner = 1;
+    sem_t* sem = sem_open(event->name, O_CREAT | O_EXCL, 0600, 0);
+    if (sem == SEM_FAILED && errno == EEXIST) {
+        // 이전 실행이 비정상 종료하며 남긴 세마포어
+        sem_unlink(event->name);
+        sem = sem_open(event->name, O_CREAT | O_EXCL, 0600, 0);
+    }
+    event->handle = (sem != SEM_FAILED) ? sem : NULL;
+    return event->handle != NULL;
+}
+
+int kp_named_event_open(kp_named_event* event, const char* name) {
+    snprintf(event->name, sizeof(event->name), "/%s", name);
+    event->owner = 0;
+    sem_t* sem = sem_open(event->name, 0);
+    event->handle = (sem != SEM_FAILED) ? sem : NULL;
+    return event->handle != NULL;
+}
+
+void kp_named_event_signal(kp_named_event* event) {
+    // 자동 리셋 이벤트처럼 신호가 쌓이지 않도록 이미 신호 상태면 건너뜀
+    int value = 0;
+    if (sem_getvalue((sem_t*)event->handle, &value) == 0 && value > 0) {
+        return;
+    }
+    sem_post((sem_t*)event->handle);
+}
+
+int kp_named_event_wait(kp_named_event* event, unsigned int timeout_ms) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    for (;;) {
+        if (sem_timedwait((sem_t*)event->handle, &deadline) == 0) {
+            return 1;
+        }
+        if (errno != EINTR) {
+            return 0;
+        }
+    }
+}
+
+void kp_named_event_close(kp_named_event* event) {
+    if (event->handle != NULL) {
+        sem_close((sem_t*)event->handle);
+        event->handle = NULL;
+    }
+    if (event->owner) {
+        sem_unlink(event->name);
+        event->owner = 0;
+    }
+}
+
+int kp_file_map(kp_mapped_file* map, const char* path) {
+    map->address = NULL;
+    map->size = 0;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return 0;
+    }
+    if (info.st_size == 0) {
+        close(fd);
+        return 1;
+    }
+    void* address = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        return 0;
+    }
+    map->address = address;
+    map->size = (size_t)info.st_size;
+    return 1;
+}
+
+void kp_file_unmap(kp_mapped_file* map) {
+    if (map->address != NULL) {
+        munmap((void*)map->address, map->size);
+        map->address = NULL;
+    }
+    map->size = 0;
+}
+
+unsigned long kp_process_id(void) {
+    return (unsigned long)getpid();
+}
+
+#endif
@@ -0,0 +1,528 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "linux_backend.h"
+#include "kp_platform.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/epoll.h>
+#include <linux/uinput.h>
+
+/** @brief epoll 이벤트에 붙이는 표시: 장치가 아닌 등록 파일 디스크립터 */
+#define LINUX_INPUT_WATCH_TAG 0xFFFFFFFFU
+
+/** @brief grab 전에 눌린 키가 떼어지기를 기다리는 최대 시간 (밀리초) */
+#define LINUX_GRAB_SETTLE_MS 1000
+
+/** @brief 비트맵 검사 */
+#define TEST_BIT(bits, n) (((bits)[(n) / 8] >> ((n) % 8)) & 1)
+
+/**
+ * @brief evdev 키 코드와 가상 키 코드 대응 표
+ * @details 키패드 Enter는 가상 키 코드가 Enter와 같으므로(Win32는 확장 키 플래그로 구분) 다시 내보낼 때 Enter가 됩니다.
+ */
+static const struct {
+    unsigned short code;
+    unsigned char vk;
+} g_keymap[] = {
+    { KEY_ESC, 0x1B }, { KEY_BACKSPACE, 0x08 }, { KEY_TAB, 0x09 }, { KEY_ENTER, 0x0D }, { KEY_SPACE, 0x20 },
+    { KEY_1, '1' }, { KEY_2, '2' }, { KEY_3, '3' }, { KEY_4, '4' }, { KEY_5, '5' },
+    { KEY_6, '6' }, { KEY_7, '7' }, { KEY_8, '8' }, { KEY_9, '9' }, { KEY_0, '0' },
+    { KEY_Q, 'Q' }, { KEY_W, 'W' }, { KEY_E, 'E' }, { KEY_R, 'R' }, { KEY_T, 'T' }, { KEY_Y, 'Y' },
+    { KEY_U, 'U' }, { KEY_I, 'I' }, { KEY_O, 'O' }, { KEY_P, 'P' }, { KEY_A, 'A' }, { KEY_S, 'S' },
+    { KEY_D, 'D' }, { KEY_F, 'F' }, { KEY_G, 'G' }, { KEY_H, 'H' }, { KEY_J, 'J' }, { KEY_K, 'K' },
+    { KEY_L, 'L' }, { KEY_Z, 'Z' }, { KEY_X, 'X' }, { KEY_C, 'C' }, { KEY_V, 'V' }, { KEY_B, 'B' },
+    { KEY_N, 'N' }, { KEY_M, 'M' },
+    { KEY_SEMICOLON, 0xBA }, { KEY_EQUAL, 0xBB }, { KEY_COMMA, 0xBC }, { KEY_MINUS, 0xBD },
+    { KEY_DOT, 0xBE }, { KEY_SLASH, 0xBF }, { KEY_GRAVE, 0xC0 }, { KEY_LEFTBRACE, 0xDB },
+    { KEY_BACKSLASH, 0xDC }, { KEY_RIGHTBRACE, 0xDD }, { KEY_APOSTROPHE, 0xDE }, { KEY_102ND, 0xE2 },
+    { KEY_LEFTSHIFT, 0xA0 }, { KEY_RIGHTSHIFT, 0xA1 }, { KEY_LEFTCTRL, 0xA2 }, { KEY_RIGHTCTRL, 0xA3 },
+    { KEY_LEFTALT, 0xA4 }, { KEY_RIGHTALT, 0xA5 }, { KEY_LEFTMETA, 0x5B }, { KEY_RIGHTMETA, 0x5C },
+    { KEY_COMPOSE, 0x5D }, { KEY_CAPSLOCK, 0x14 }, { KEY_NUMLOCK, 0x90 }, { KEY_SCROLLLOCK, 0x91 },
+    { KEY_SYSRQ, 0x2C }, { KEY_PAUSE, 0x13 }, { KEY_HANGEUL, 0x15 }, { KEY_HANJA, 0x19 },
+    { KEY_PAGEUP, 0x21 }, { KEY_PAGEDOWN, 0x22 }, { KEY_END, 0x23 }, { KEY_HOME, 0x24 },
+    { KEY_LEFT, 0x25 }, { KEY_UP, 0x26 }, { KEY_RIGHT, 0x27 }, { KEY_DOWN, 0x28 },
+    { KEY_INSERT, 0x2D }, { KEY_DELETE, 0x2E },
+    { KEY_KP0, 0x60 }, { KEY_KP1, 0x61 }, { KEY_KP2, 0x62 }, { KEY_KP3, 0x63 }, { KEY_KP4, 0x64 },
+    { KEY_KP5, 0x65 }, { KEY_KP6, 0x66 }, { KEY_KP7, 0x67 }, { KEY_KP8, 0x68 }, { KEY_KP9, 0x69 },
+    { KEY_KPASTERISK, 0x6A }, { KEY_KPPLUS, 0x6B }, { KEY_KPMINUS, 0x6D }, { KEY_KPDOT, 0x6E },
+    { KEY_KPSLASH, 0x6F }, { KEY_KPENTER, 0x0D },
+    { KEY_F1, 0x70 }, { KEY_F2, 0x71 }, { KEY_F3, 0x72 }, { KEY_F4, 0x73 }, { KEY_F5, 0x74 },
+    { KEY_F6, 0x75 }, { KEY_F7, 0x76 }, { KEY_F8, 0x77 }, { KEY_F9, 0x78 }, { KEY_F10, 0x79 },
+    { KEY_F11, 0x7A }, { KEY_F12, 0x7B }, { KEY_F13, 0x7C }, { KEY_F14, 0x7D }, { KEY_F15, 0x7E },
+    { KEY_F16, 0x7F }, { KEY_F17, 0x80 }, { KEY_F18, 0x81 }, { KEY_F19, 0x82 }, { KEY_F20, 0x83 },
+    { KEY_F21, 0x84 }, { KEY_F22, 0x85 }, { KEY_F23, 0x86 }, { KEY_F24, 0x87 },
+    { KEY_MUTE, 0xAD }, { KEY_VOLUMEDOWN, 0xAE }, { KEY_VOLUMEUP, 0xAF }
+};
+
+/**
+ * @brief 가상 키 코드 없이 그대로 내보내는 키 (문자를 입력하지 않는 키만)
+ */
+static const unsigned short g_passthrough_keys[] = {
+    KEY_POWER, KEY_SLEEP, KEY_WAKEUP, KEY_SUSPEND,
+    KEY_BRIGHTNESSDOWN, KEY_BRIGHTNESSUP, KEY_KBDILLUMTOGGLE, KEY_KBDILLUMDOWN, KEY_KBDILLUMUP,
+    KEY_SWITCHVIDEOMODE, KEY_DISPLAYTOGGLE, KEY_BATTERY, KEY_WLAN, KEY_BLUETOOTH, KEY_RFKILL, KEY_MICMUTE,
+    KEY_PLAYPAUSE, KEY_PLAYCD, KEY_PAUSECD, KEY_STOPCD, KEY_NEXTSONG, KEY_PREVIOUSSONG, KEY_EJECTCD,
+    KEY_REWIND, KEY_FASTFORWARD
+};
+
+/** @brief evdev 키 코드 → 가상 키 코드 (처음 사용할 때 g_keymap으로 채움) */
+static unsigned char g_code_to_vk[256];
+
+/** @brief 가상 키 코드 → evdev 키 코드 */
+static unsigned short g_vk_to_code[256];
+
+/** @brief 변환 표를 채웠는지 여부 */
+static int g_keymap_ready = 0;
+
+/**
+ * @brief 양방향 변환 표를 채웁니다.
+ * @details 같은 가상 키 코드에 여러 키가 대응하면(Enter와 키패드 Enter) 표에서 먼저 나온 키로 내보냅니다.
+ */
+static void keymap_build(void) {
+    for (size_t i = 0; i < sizeof(g_keymap) / sizeof(g_keymap[0]); i++) {
+        g_code_to_vk[g_keymap[i].code] = g_keymap[i].vk;
+        if (g_vk_to_code[g_keymap[i].vk] == 0) {
+            g_vk_to_code[g_keymap[i].vk] = g_keymap[i].code;
+        }
+    }
+    g_keymap_ready = 1;
+}
+
+/**
+ * @brief evdev 키 코드를 가상 키 코드로 바꿉니다.
+ */
+unsigned int linux_keymap_to_vk(unsigned int code) {
+    if (!g_keymap_ready) {
+        keymap_build();
+    }
+    return (code < 256) ? g_code_to_vk[code] : 0;
+}
+
+/**
+ * @brief 가상 키 코드를 evdev 키 코드로 바꿉니다.
+ */
+unsigned int linux_keymap_from_vk(unsigned int vk_code) {
+    if (!g_keymap_ready) {
+        keymap_build();
+    }
+    return (vk_code < 256) ? g_vk_to_code[vk_code] : 0;
+}
+
+/**
+ * @brief 가상 키 코드가 없는 키를 그대로 내보내도 되는지 확인합니다.
+ */
+int linux_keymap_passthrough(unsigned int code) {
+    for (size_t i = 0; i < sizeof(g_passthrough_keys) / sizeof(g_passthrough_keys[0]); i++) {
+        if (g_passthrough_keys[i] == code) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 입력 장치 묶음을 초기화합니다.
+ */
+int linux_input_init(linux_input* input) {
+    memset(input, 0, sizeof(*input));
+    for (int i = 0; i < LINUX_INPUT_MAX_DEVICES; i++) {
+        input->devices[i].fd = -1;
+    }
+    input->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    return input->epoll_fd >= 0;
+}
+
+/**
+ * @brief 눌린 키가 모두 떼어질 때까지 기다립니다.
+ * @details 실행 명령의 Enter처럼 grab 직전에 눌린 키는 키 업이 독점된 장치로 오므로,
+ *          떼어지기 전에 grab하면 다른 프로그램에는 그 키가 눌린 채로 남습니다.
+ */
+static void wait_keys_released(int fd) {
+    unsigned char keys[KEY_MAX / 8 + 1];
+    for (int waited = 0; waited < LINUX_GRAB_SETTLE_MS; waited += 10) {
+        memset(keys, 0, sizeof(keys));
+        if (ioctl(fd, EVIOCGKEY(sizeof(keys)), keys) < 0) {
+            return;
+        }
+        int pressed = 0;
+        for (size_t i = 0; i < sizeof(keys) && !pressed; i++) {
+            pressed = (keys[i] != 0);
+        }
+        if (!pressed) {
+            return;
+        }
+        kp_sleep_ms(10);
+    }
+}
+
+/**
+ * @brief 입력 장치를 엽니다.
+ */
+int linux_input_add_device(linux_input* input, const char* path, int grab) {
+    int slot = -1;
+    for (int i = 0; i < LINUX_INPUT_MAX_DEVICES && slot < 0; i++) {
+        if (input->devices[i].fd < 0) {
+            slot = i;
+        }
+    }
+    if (slot < 0) {
+        fprintf(stderr, "[오류] 입력 장치는 %d개까지 열 수 있습니다: %s\n", LINUX_INPUT_MAX_DEVICES, path);
+        return 0;
+    }
+
+    // FIFO는 쓰는 쪽이 열 때까지 기다리지 않도록 O_NONBLOCK으로 열고, epoll로 준비를 기다림
+    int fd = (strcmp(path, "-") == 0) ? dup(STDIN_FILENO) : open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "[오류] 입력 장치를 열 수 없습니다: %s (%s)\n", path, strerror(errno));
+        return 0;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    linux_input_device* device = &input->devices[slot];
+    memset(device, 0, sizeof(*device));
+    device->fd = fd;
+    strncpy(device->path, path, sizeof(device->path) - 1);
+
+    struct stat info;
+    device->fake = (fstat(fd, &info) != 0 || !S_ISCHR(info.st_mode));
+    if (!device->fake) {
+        // 커널 타임스탬프를 kp_now_ns()와 같은 시계로 맞춰 추가 지연을 잴 수 있게 함
+        int clock_id = CLOCK_MONOTONIC;
+        ioctl(fd, EVIOCSCLOCKID, &clock_id);
+        if (grab) {
+            wait_keys_released(fd);
+            if (ioctl(fd, EVIOCGRAB, 1) != 0) {
+                fprintf(stderr, "[오류] 입력 장치를 독점할 수 없습니다: %s (%s)\n", path, strerror(errno));
+                close(fd);
+                device->fd = -1;
+                return 0;
+            }
+            device->grabbed = 1;
+        }
+    }
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u32 = (uint32_t)slot;
+    if (epoll_ctl(input->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        fprintf(stderr, "[오류] 입력 장치를 epoll에 등록할 수 없습니다: %s (%s)\n", path, strerror(errno));
+        if (device->grabbed) {
+            ioctl(fd, EVIOCGRAB, 0);
+        }
+        close(fd);
+        device->fd = -1;
+        return 0;
+    }
+    input->open_devices++;
+    printf("[입력] %s%s\n", path, device->fake ? " (가짜 장치: input_event 레코드 스트림)"
+                                             : (device->grabbed ? " (독점)" : " (독점 안 함)"));
+    return 1;
+}
+
+/**
+ * @brief /dev/input/event*에서 문자 키를 가진 키보드를 모두 찾아 엽니다.
+ */
+int linux_input_add_keyboards(linux_input* input, int grab) {
+    DIR* dir = opendir("/dev/input");
+    if (dir == NULL) {
+        return 0;
+    }
+    int added = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, "event", 5) != 0) {
+            continue;
+        }
+        char path[LINUX_INPUT_PATH_SIZE];
+        snprintf(path, sizeof(path), "/dev/input/%.64s", entry->d_name);
+        int fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        // 문자 키(A, Z)와 Enter가 있는 장치만 키보드로 봄 (전원 버튼, 마우스 등 제외)
+        unsigned char keys[KEY_MAX / 8 + 1];
+        char name[128] = { 0 };
+        memset(keys, 0, sizeof(keys));
+        int keyboard = ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keys)), keys) >= 0 &&
+                       TEST_BIT(keys, KEY_A) && TEST_BIT(keys, KEY_Z) && TEST_BIT(keys, KEY_ENTER);
+        ioctl(fd, EVIOCGNAME(sizeof(name) - 1), name);
+        close(fd);
+        if (keyboard && strcmp(name, LINUX_UINPUT_NAME) != 0 && linux_input_add_device(input, path, grab)) {
+            added++;
+        }
+    }
+    closedir(dir);
+    return added;
+}
+
+/**
+ * @brief 장치 외에 함께 기다릴 파일 디스크립터를 등록합니다.
+ */
+int linux_input_watch(linux_input* input, int fd) {
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u32 = LINUX_INPUT_WATCH_TAG;
+    return epoll_ctl(input->epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+/**
+ * @brief 장치를 닫습니다. (입력 끝이나 장치 분리)
+ */
+static void close_device(linux_input* input, linux_input_device* device) {
+    epoll_ctl(input->epoll_fd, EPOLL_CTL_DEL, device->fd, NULL);
+    if (device->grabbed) {
+        ioctl(device->fd, EVIOCGRAB, 0);
+    }
+    close(device->fd);
+    device->fd = -1;
+    input->open_devices--;
+}
+
+/**
+ * @brief 장치 하나에서 읽을 수 있는 만큼 읽습니다.
+ * @details 가짜 장치는 레코드 경계와 관계없이 바이트가 도착하므로 남은 조각을 다음 read()에 이어 붙입니다.
+ * @return size_t 읽은 이벤트 수
+ */
+static size_t read_device(linux_input* input, linux_input_device* device, struct input_event* events,
+                          size_t capacity) {
+    const size_t record = sizeof(struct input_event);
+    size_t count = 0;
+    while (count < capacity) {
+        unsigned char* dst = (unsigned char*)(events + count);
+        size_t request = (capacity - count) * record - device->partial;
+        memcpy(dst, device->pending, device->partial);
+        ssize_t bytes = read(device->fd, dst + device->partial, request);
+        input->reads++;
+        if (bytes < 0 && (errno == EAGAIN || errno == EINTR)) {
+            break;
+        }
+        if (bytes <= 0) {
+            // 쓰는 쪽이 닫은 FIFO/파이프, 분리된 장치(ENODEV)
+            printf("[입력] 입력이 끝났습니다: %s\n", device->path);
+            close_device(input, device);
+            break;
+        }
+        size_t total = device->partial + (size_t)bytes;
+        size_t whole = total / record;
+        device->partial = total % record;
+        memcpy(device->pending, dst + whole * record, device->partial);
+        count += whole;
+        if ((size_t)bytes < request) {
+            // 요청보다 적게 왔으면 지금 읽을 것이 더 없음
+            break;
+        }
+    }
+    device->events += count;
+    return count;
+}
+
+/**
+ * @brief 입력을 기다린 뒤 준비된 모든 장치에서 이벤트를 한꺼번에 읽습니다.
+ */
+int linux_input_wait(linux_input* input, struct input_event* events, size_t capacity, int timeout_ms,
+                     int* watch_ready) {
+    struct epoll_event ready[LINUX_INPUT_MAX_DEVICES + 1];
+    if (watch_ready != NULL) {
+        *watch_ready = 0;
+    }
+    int count = epoll_wait(input->epoll_fd, ready, LINUX_INPUT_MAX_DEVICES + 1, timeout_ms);
+    if (count < 0) {
+        return (errno == EINTR) ? 0 : -1;
+    }
+
+    size_t total = 0;
+    for (int i = 0; i < count; i++) {
+        if (ready[i].data.u32 == LINUX_INPUT_WATCH_TAG) {
+            if (watch_ready != NULL) {
+                *watch_ready = 1;
+            }
+            continue;
+        }
+        linux_input_device* device = &input->devices[ready[i].data.u32];
+        if (device->fd >= 0 && total < capacity) {
+            total += read_device(input, device, events + total, capacity - total);
+        }
+    }
+    if (total > 0) {
+        input->wakeups++;
+        input->events += total;
+    }
+    return (int)total;
+}
+
+/**
+ * @brief 모든 장치의 독점을 풀고 닫습니다.
+ */
+void linux_input_close(linux_input* input) {
+    for (int i = 0; i < LINUX_INPUT_MAX_DEVICES; i++) {
+        if (input->devices[i].fd >= 0) {
+            close_device(input, &input->devices[i]);
+        }
+    }
+    if (input->epoll_fd >= 0) {
+        close(input->epoll_fd);
+        input->epoll_fd = -1;
+    }
+}
+
+/**
+ * @brief uinput 가상 키보드를 만듭니다.
+ */
+int linux_sink_open_uinput(linux_sink* sink, const char* name) {
+    memset(sink, 0, sizeof(*sink));
+    sink->fd = open("/dev/uinput", O_WRONLY | O_CLOEXEC);
+    if (sink->fd < 0) {
+        fprintf(stderr, "[오류] /dev/uinput을 열 수 없습니다: %s\n", strerror(errno));
+        return 0;
+    }
+    ioctl(sink->fd, UI_SET_EVBIT, EV_KEY);
+    ioctl(sink->fd, UI_SET_EVBIT, EV_SYN);
+    for (unsigned int code = 1; code < LINUX_SINK_KEYS; code++) {
+        ioctl(sink->fd, UI_SET_KEYBIT, code);
+    }
+
+    struct uinput_setup setup;
+    memset(&setup, 0, sizeof(setup));
+    setup.id.bustype = BUS_VIRTUAL;
+    setup.id.vendor = 0x4B50; // "KP"
+    setup.id.product = 0x0001;
+    setup.id.version = 1;
+    strncpy(setup.name, name, UINPUT_MAX_NAME_SIZE - 1);
+    if (ioctl(sink->fd, UI_DEV_SETUP, &setup) != 0 || ioctl(sink->fd, UI_DEV_CREATE) != 0) {
+        fprintf(stderr, "[오류] uinput 장치를 만들 수 없습니다: %s\n", strerror(errno));
+        close(sink->fd);
+        sink->fd = -1;
+        return 0;
+    }
+    sink->uinput = 1;
+    return 1;
+}
+
+/**
+ * @brief 가짜 출력 파일(또는 FIFO)을 엽니다.
+ */
+int linux_sink_open_file(linux_sink* sink, const char* path) {
+    memset(sink, 0, sizeof(*sink));
+    sink->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (sink->fd < 0) {
+        fprintf(stderr, "[오류] 출력 파일을 열 수 없습니다: %s (%s)\n", path, strerror(errno));
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief 이벤트 하나를 버퍼에 넣습니다. (가짜 출력에서 추가 지연을 볼 수 있도록 단조 시계로 시각 기록)
+ */
+static int push_event(linux_sink* sink, unsigned short type, unsigned short code, int value) {
+    if (sink->count == LINUX_SINK_BATCH && !linux_sink_flush(sink)) {
+        return 0;
+    }
+    struct input_event* event = &sink->buffer[sink->count++];
+    unsigned long long now = kp_now_ns();
+    event->input_event_sec = (time_t)(now / 1000000000ULL);
+    event->input_event_usec = (suseconds_t)((now % 1000000000ULL) / 1000ULL);
+    event->type = type;
+    event->code = code;
+    event->value = value;
+    return 1;
+}
+
+/**
+ * @brief 키 이벤트 하나를 출력 버퍼에 넣습니다.
+ */
+int linux_sink_key(linux_sink* sink, unsigned int code, int key_down) {
+    if (code == 0 || code >= LINUX_SINK_KEYS) {
+        return 0;
+    }
+    unsigned char bit = (unsigned char)(1U << (code % 8));
+    int value;
+    if (key_down) {
+        value = (sink->down[code / 8] & bit) ? 2 : 1;
+        sink->down[code / 8] |= bit;
+    } else {
+        value = 0;
+        sink->down[code / 8] &= (unsigned char)~bit;
+    }
+    if (!push_event(sink, EV_KEY, (unsigned short)code, value)) {
+        return 0;
+    }
+    sink->frame_open = 1;
+    sink->keys++;
+    return 1;
+}
+
+/**
+ * @brief 가상 키 코드가 없는 키 이벤트를 통과 허용 목록에 있을 때만 출력 버퍼에 넣습니다.
+ */
+int linux_sink_unmapped_key(linux_sink* sink, unsigned int code, int key_down) {
+    return linux_keymap_passthrough(code) ? linux_sink_key(sink, code, key_down) : 0;
+}
+
+/**
+ * @brief 입력 프레임이 끝났음을 표시합니다.
+ */
+void linux_sink_sync(linux_sink* sink) {
+    if (sink->frame_open && push_event(sink, EV_SYN, SYN_REPORT, 0)) {
+        sink->frame_open = 0;
+    }
+}
+
+/**
+ * @brief 모인 이벤트를 write() 한 번으로 씁니다.
+ */
+int linux_sink_flush(linux_sink* sink) {
+    if (sink->count < LINUX_SINK_BATCH) {
+        linux_sink_sync(sink);
+    }
+    if (sink->count == 0) {
+        return 1;
+    }
+    const unsigned char* data = (const unsigned char*)sink->buffer;
+    size_t remaining = sink->count * sizeof(struct input_event);
+    sink->count = 0;
+    while (remaining > 0) {
+        ssize_t written = write(sink->fd, data, remaining);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            sink->errors++;
+            return 0;
+        }
+        data += written;
+        remaining -= (size_t)written;
+    }
+    sink->writes++;
+    return 1;
+}
+
+/**
+ * @brief 눌린 채 남은 키를 모두 뗀 뒤 출력 장치를 닫습니다.
+ */
+void linux_sink_close(linux_sink* sink) {
+    if (sink->fd < 0) {
+        return;
+    }
+    for (unsigned int code = 1; code < LINUX_SINK_KEYS; code++) {
+        if (sink->down[code / 8] & (1U << (code % 8))) {
+            linux_sink_key(sink, code, 0);
+        }
+    }
+    linux_sink_flush(sink);
+    if (sink->uinput) {
+        ioctl(sink->fd, UI_DEV_DESTROY);
+    }
+    close(sink->fd);
+    sink->fd = -1;
+}
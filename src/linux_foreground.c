@@ -0,0 +1,241 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "linux_foreground.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+/**
+ * @brief 대소문자를 구분하는 FNV-1a 해시 (이름만 쓰인 포그라운드 파일의 창 식별 값)
+ */
+static uintptr_t hash_name(const char* name) {
+    uint32_t hash = 2166136261U;
+    for (const unsigned char* p = (const unsigned char*)name; *p != '\0'; p++) {
+        hash = (hash ^ *p) * 16777619U;
+    }
+    return (uintptr_t)hash;
+}
+
+/**
+ * @brief 작은 파일 하나를 읽어 끝의 공백을 지웁니다.
+ * @return int 성공 시 1, 파일이 없거나 비어 있으면 0
+ */
+static int read_small_file(const char* path, char* buffer, size_t size) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return 0;
+    }
+    ssize_t length = read(fd, buffer, size - 1);
+    close(fd);
+    if (length <= 0) {
+        return 0;
+    }
+    buffer[length] = '\0';
+    while (length > 0 && isspace((unsigned char)buffer[length - 1])) {
+        buffer[--length] = '\0';
+    }
+    return length > 0;
+}
+
+/**
+ * @brief /proc/<PID>/stat에서 프로세스 시작 시각(부팅 후 클록 틱)을 읽습니다.
+ * @details 두 번째 필드(실행 파일 이름)에 공백과 괄호가 들어갈 수 있으므로 마지막 ')' 뒤부터 셉니다.
+ */
+static int read_start_time(unsigned long pid, unsigned long long* start_time) {
+    char path[64];
+    char stat[1024];
+    snprintf(path, sizeof(path), "/proc/%lu/stat", pid);
+    if (!read_small_file(path, stat, sizeof(stat))) {
+        return 0;
+    }
+    const char* p = strrchr(stat, ')');
+    if (p == NULL) {
+        return 0;
+    }
+    // ')' 뒤의 세 번째 필드(state)부터 세어 22번째 필드(starttime)까지 이동
+    for (int field = 3; field < 22 && p != NULL; field++) {
+        p = strchr(p + 1, ' ');
+    }
+    if (p == NULL) {
+        return 0;
+    }
+    *start_time = strtoull(p + 1, NULL, 10);
+    return 1;
+}
+
+/**
+ * @brief PID의 실행 파일 이름을 가져옵니다. (/proc/<PID>/exe, 권한이 없으면 15자로 잘린 comm)
+ */
+static int read_process_name(unsigned long pid, char* name, size_t name_size) {
+    char path[64];
+    char target[FOREGROUND_NAME_SIZE * 2];
+    snprintf(path, sizeof(path), "/proc/%lu/exe", pid);
+    ssize_t length = readlink(path, target, sizeof(target) - 1);
+    if (length > 0) {
+        target[length] = '\0';
+        const char* base = strrchr(target, '/');
+        base = (base != NULL) ? base + 1 : target;
+        strncpy(name, base, name_size - 1);
+        name[name_size - 1] = '\0';
+        return 1;
+    }
+    snprintf(path, sizeof(path), "/proc/%lu/comm", pid);
+    return read_small_file(path, name, name_size);
+}
+
+/**
+ * @brief 포그라운드 파일을 읽어 식별 정보를 만듭니다.
+ * @details "<PID> [<창 번호>]"이면 PID와 프로세스 시작 시각으로, 그 외에는 이름 해시로 식별합니다.
+ */
+static int file_get_foreground(void* context, foreground_identity* identity) {
+    linux_foreground* foreground = (linux_foreground*)context;
+    char content[FOREGROUND_NAME_SIZE];
+    if (!read_small_file(foreground->path, content, sizeof(content))) {
+        return 0;
+    }
+
+    char* end = NULL;
+    unsigned long pid = strtoul(content, &end, 10);
+    if (end != content && (*end == '\0' || isspace((unsigned char)*end))) {
+        identity->process_id = pid;
+        identity->window = (uintptr_t)strtoull(end, NULL, 0);
+        if (!read_start_time(pid, &identity->start_time)) {
+            return 0;
+        }
+        // 이름은 식별 정보가 바뀌었을 때만 get_process_name에서 읽음
+        foreground->name[0] = '\0';
+        return 1;
+    }
+
+    identity->process_id = 0;
+    identity->window = hash_name(content);
+    identity->start_time = 0;
+    memcpy(foreground->name, content, sizeof(foreground->name));
+    return 1;
+}
+
+/**
+ * @brief 식별된 프로세스의 실행 파일 이름을 가져옵니다.
+ */
+static int file_get_process_name(void* context, const foreground_identity* identity,
+                                 char* name, size_t name_size) {
+    linux_foreground* foreground = (linux_foreground*)context;
+    if (identity->process_id != 0) {
+        return read_process_name(identity->process_id, name, name_size);
+    }
+    strncpy(name, foreground->name, name_size - 1);
+    name[name_size - 1] = '\0';
+    return name[0] != '\0';
+}
+
+/**
+ * @brief 파일 공급자를 엽니다.
+ */
+int linux_foreground_open_file(linux_foreground* foreground, const char* path) {
+    memset(foreground, 0, sizeof(*foreground));
+    strncpy(foreground->path, path, sizeof(foreground->path) - 1);
+    foreground->provider.context = foreground;
+    foreground->provider.get_foreground = file_get_foreground;
+    foreground->provider.get_process_name = file_get_process_name;
+
+    // 스크립트가 임시 파일을 쓴 뒤 이름을 바꾸는 경우도 있으므로 파일이 아니라 디렉토리를 감시
+    char directory[FOREGROUND_NAME_SIZE];
+    const char* slash = strrchr(foreground->path, '/');
+    if (slash == NULL) {
+        strcpy(directory, ".");
+        foreground->file_name = foreground->path;
+    } else {
+        size_t length = (slash == foreground->path) ? 1 : (size_t)(slash - foreground->path);
+        memcpy(directory, foreground->path, length);
+        directory[length] = '\0';
+        foreground->file_name = slash + 1;
+    }
+    foreground->notify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (foreground->notify_fd < 0 ||
+        inotify_add_watch(foreground->notify_fd, directory,
+                          IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_MOVED_FROM) < 0) {
+        fprintf(stderr, "[오류] 포그라운드 파일 디렉토리를 감시할 수 없습니다: %s (%s)\n", directory, strerror(errno));
+        if (foreground->notify_fd >= 0) {
+            close(foreground->notify_fd);
+        }
+        foreground->notify_fd = -1;
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief 고정 이름을 돌려주는 포그라운드 조회
+ */
+static int fixed_get_foreground(void* context, foreground_identity* identity) {
+    linux_foreground* foreground = (linux_foreground*)context;
+    identity->window = hash_name(foreground->name);
+    identity->process_id = 0;
+    identity->start_time = 0;
+    return 1;
+}
+
+/**
+ * @brief 고정 프로세스 이름 조회
+ */
+static int fixed_get_process_name(void* context, const foreground_identity* identity,
+                                  char* name, size_t name_size) {
+    linux_foreground* foreground = (linux_foreground*)context;
+    (void)identity;
+    strncpy(name, foreground->name, name_size - 1);
+    name[name_size - 1] = '\0';
+    return 1;
+}
+
+/**
+ * @brief 고정 공급자를 엽니다.
+ */
+void linux_foreground_open_fixed(linux_foreground* foreground, const char* name) {
+    memset(foreground, 0, sizeof(*foreground));
+    strncpy(foreground->name, name, sizeof(foreground->name) - 1);
+    foreground->notify_fd = -1;
+    foreground->provider.context = foreground;
+    foreground->provider.get_foreground = fixed_get_foreground;
+    foreground->provider.get_process_name = fixed_get_process_name;
+}
+
+/**
+ * @brief 변경 알림을 모두 읽습니다.
+ */
+int linux_foreground_drain(linux_foreground* foreground) {
+    if (foreground->notify_fd < 0) {
+        return 0;
+    }
+    int changed = 0;
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t length;
+    while ((length = read(foreground->notify_fd, buffer, sizeof(buffer))) > 0) {
+        for (char* p = buffer; p < buffer + length; ) {
+            const struct inotify_event* event = (const struct inotify_event*)p;
+            if (event->len > 0 && strcmp(event->name, foreground->file_name) == 0) {
+                changed = 1;
+            }
+            p += sizeof(struct inotify_event) + event->len;
+        }
+    }
+    if (changed) {
+        foreground->changes++;
+    }
+    return changed;
+}
+
+/**
+ * @brief 공급자를 닫습니다.
+ */
+void linux_foreground_close(linux_foreground* foreground) {
+    if (foreground->notify_fd >= 0) {
+        close(foreground->notify_fd);
+        foreground->notify_fd = -1;
+    }
+}
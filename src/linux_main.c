@@ -0,0 +1,432 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "linux_backend.h"
+#include "linux_foreground.h"
+#include "key_processor.h"
+#include "keystream.h"
+#include "policy_loader.h"
+#include "config_reloader.h"
+#include "stats_block.h"
+#include "kp_platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+
+/**
+ * @file linux_main.c
+ * @brief Linux용 키보드 보안 툴 (evdev 입력 → 처리 코어 → uinput 출력)
+ * @details Win32 후크 대신 키보드 장치를 독점하여 읽고, 같은 처리 코어(솔트 생성, 암호화, 포그라운드 판정과
+ *          키 규칙, 복호화)를 거친 허용 키만 uinput 가상 키보드로 내보냅니다. 후크 제한 시간이 없으므로
+ *          후크/작업 스레드로 나누지 않고 이벤트 루프 스레드 하나가 깨어날 때마다 모인 이벤트를 한꺼번에 처리합니다.
+ *
+ *          사용법:
+ *            keyboard_protector_linux [--config <ini>] [--device <경로>]... [--no-grab] [--sink <출력 파일>]
+ *                                     [--foreground-file <경로> | --foreground <이름>] [--report <초>]
+ *
+ *          --device를 지정하지 않으면 /dev/input의 키보드를 모두 엽니다. --device에 FIFO나 "-"(표준 입력)를
+ *          지정하고 --sink에 파일을 지정하면 장치 권한 없이 tools/evdev_feed로 같은 경로를 시험할 수 있습니다.
+ *          포그라운드 파일의 기본값은 $XDG_RUNTIME_DIR/kp_foreground입니다.
+ *          종료 키, SIGINT/SIGTERM, 또는 모든 입력이 끝나면 처리량과 추가 지연을 출력하고 종료합니다.
+ */
+
+/** @brief 깨어남 한 번에 읽는 최대 이벤트 수 */
+#define LINUX_EVENT_BATCH 256
+
+/**
+ * @brief Linux 백엔드 상태 (이벤트 루프 스레드 전용, 리로드 스레드는 정책 게시와 캐시 무효화만 함)
+ */
+typedef struct linux_protector {
+    linux_input input;                  /**< 입력 장치 */
+    linux_sink sink;                    /**< 출력 장치 */
+    linux_foreground foreground;        /**< 포그라운드 공급자 */
+    foreground_cache cache;             /**< 포그라운드 판정 캐시 */
+    key_processor processor;            /**< 처리 코어 */
+    keystream_pool keystream;           /**< 솔트를 꺼낼 키스트림 풀 */
+    policy_store store;                 /**< 현재 정책 */
+    config_reloader reloader;           /**< 설정 파일 감시 */
+    const policy_snapshot* active;      /**< 이벤트를 처리하는 동안 참조하는 정책 */
+    kp_stats_block* stats;              /**< 지연 히스토그램과 판정 카운터 */
+    kp_shared_memory stats_memory;      /**< 통계 블록 공유 메모리 */
+    kp_stats_block local_stats;         /**< 공유 메모리를 만들 수 없을 때 쓰는 블록 */
+
+    unsigned long key_events;           /**< 처리한 키 이벤트 수 */
+    unsigned long passthrough;          /**< 가상 키 코드가 없어 그대로 내보낸 키 이벤트 수 (미디어 키 등) */
+    unsigned long unmapped_blocked;     /**< 가상 키 코드가 없고 통과 목록에도 없어 차단한 키 이벤트 수 */
+    unsigned long ignored;              /**< 키와 SYN이 아니어서 버린 이벤트 수 (EV_MSC 등) */
+    unsigned long long first_ns;        /**< 첫 키 이벤트를 읽은 시각 */
+    unsigned long long last_ns;         /**< 마지막 키 이벤트를 처리한 시각 */
+} linux_protector;
+
+static linux_protector g_protector;
+
+/** @brief 종료 요청 (신호 처리기, 종료 키) */
+static volatile sig_atomic_t g_stop = 0;
+
+/**
+ * @brief SIGINT/SIGTERM 처리기
+ */
+static void on_signal(int signal_number) {
+    (void)signal_number;
+    g_stop = 1;
+}
+
+/**
+ * @brief 현재 정책의 허용 목록으로 판정 (허용이면 키 규칙 번호 + 1)
+ */
+static int protector_verdict(const char* process_name, void* user) {
+    linux_protector* protector = (linux_protector*)user;
+    return (protector->active != NULL) ? (int)allowlist_value(&protector->active->allowed, process_name) : 0;
+}
+
+/**
+ * @brief 키스트림 풀에서 워드를 꺼내고, 솔트로는 그 위치를 반환합니다.
+ */
+static unsigned int protector_make_salt(void* context, unsigned int* pad) {
+    linux_protector* protector = (linux_protector*)context;
+    uint32_t position;
+    *pad = (unsigned int)keystream_pool_next(&protector->keystream, &position);
+    return (unsigned int)position;
+}
+
+/**
+ * @brief 복호화된 키를 출력 버퍼에 넣습니다. (깨어남 한 번의 처리가 끝나면 한꺼번에 씀)
+ */
+static int protector_inject(void* context, unsigned int vk_code, int key_down) {
+    linux_protector* protector = (linux_protector*)context;
+    return linux_sink_key(&protector->sink, linux_keymap_from_vk(vk_code), key_down);
+}
+
+#if KP_STATIC_BACKEND
+/**
+ * @brief 정적 백엔드 솔트 생성 (KP_STATIC_BACKEND 빌드의 처리 코어가 직접 호출)
+ */
+unsigned int kp_backend_make_salt(void* context, unsigned int* pad) {
+    return protector_make_salt(context, pad);
+}
+
+/**
+ * @brief 정적 백엔드 주입 (KP_STATIC_BACKEND 빌드의 처리 코어가 직접 호출)
+ */
+int kp_backend_inject(void* context, unsigned int vk_code, int key_down) {
+    return protector_inject(context, vk_code, key_down);
+}
+#endif
+
+/**
+ * @brief 새 정책이 게시된 뒤 캐시된 판정을 무효화합니다. (어느 스레드에서든 호출 가능)
+ */
+static void on_policy_published(const policy_snapshot* snapshot, void* user) {
+    linux_protector* protector = (linux_protector*)user;
+    foreground_cache_invalidate(&protector->cache);
+    if (snapshot != NULL) {
+        printf("[설정] 정책 버전 %lu 적용 (허용 프로세스 %lu개, 키 규칙 %u개)\n", snapshot->version,
+               allowlist_count(&snapshot->allowed), snapshot->keys.count - 1);
+    }
+}
+
+/**
+ * @brief 종료 키 가상 키 코드 (0이면 없음)
+ */
+static unsigned int current_exit_key(const policy_snapshot* policy) {
+#if KP_EXIT_KEY == KP_EXIT_KEY_RUNTIME
+    return (policy != NULL) ? policy->exit_key : 0;
+#else
+    (void)policy;
+    return (unsigned int)KP_EXIT_KEY;
+#endif
+}
+
+/**
+ * @brief evdev 타임스탬프를 나노초로 바꿉니다. (장치는 CLOCK_MONOTONIC, 가짜 장치는 evdev_feed가 같은 시계로 기록)
+ */
+static unsigned long long event_time_ns(const struct input_event* event) {
+    return (unsigned long long)event->input_event_sec * 1000000000ULL +
+           (unsigned long long)event->input_event_usec * 1000ULL;
+}
+
+/**
+ * @brief 깨어남 한 번에 읽은 이벤트를 처리하고 출력을 한 번에 씁니다.
+ * @details 추가 지연은 커널(또는 evdev_feed)이 찍은 시각부터 출력을 쓴 시각까지이며, 차단된 키도 처리가 끝난 시각으로 기록합니다.
+ */
+static void process_batch(linux_protector* protector, const struct input_event* events, int count,
+                          unsigned long long read_ns) {
+    static const kp_stat_verdict verdict_counter[] = {
+        KP_VERDICT_UNKNOWN,  // FOREGROUND_UNKNOWN
+        KP_VERDICT_BLOCKED,  // FOREGROUND_BLOCKED
+        KP_VERDICT_ALLOWED   // FOREGROUND_ALLOWED
+    };
+    policy_snapshot* policy = policy_store_enter(&protector->store);
+    protector->active = policy;
+    protector->processor.policy = (policy != NULL) ? &policy->keys : NULL;
+    unsigned int exit_key = current_exit_key(policy);
+
+    for (int i = 0; i < count; i++) {
+        const struct input_event* input = &events[i];
+        if (input->type == EV_SYN) {
+            if (input->code == SYN_REPORT) {
+                linux_sink_sync(&protector->sink);
+            }
+            continue;
+        }
+        if (input->type != EV_KEY) {
+            protector->ignored++;
+            continue;
+        }
+        protector->key_events++;
+        unsigned int vk_code = linux_keymap_to_vk(input->code);
+        if (vk_code == 0) {
+            // 가상 키 코드가 없는 키는 문자를 입력하지 않는 키(미디어, 밝기 등)만 통과, 나머지는 차단
+            if (linux_sink_unmapped_key(&protector->sink, input->code, input->value != 0)) {
+                protector->passthrough++;
+            } else {
+                protector->unmapped_blocked++;
+            }
+            continue;
+        }
+        if (exit_key != 0 && vk_code == exit_key && input->value == 1) {
+            printf("[종료] 종료 키가 눌렸습니다.\n");
+            g_stop = 1;
+            continue;
+        }
+
+        key_event event;
+        event.enqueue_ns = event_time_ns(input);
+        event.vk_code = vk_code;
+        event.scan_code = input->code;
+        event.flags = 0;
+        event.time = (unsigned int)(event.enqueue_ns / 1000000ULL);
+        event.message = (input->value != 0) ? KEY_MESSAGE_KEYDOWN : KEY_MESSAGE_KEYUP;
+        event.tag = 0;
+        foreground_verdict verdict = key_processor_handle(&protector->processor, &event, NULL);
+        kp_stats_count_verdict(protector->stats, verdict_counter[verdict]);
+    }
+
+    protector->processor.policy = NULL;
+    protector->active = NULL;
+    policy_store_exit(&protector->store);
+    linux_sink_flush(&protector->sink);
+
+    unsigned long long now = kp_now_ns();
+    for (int i = 0; i < count; i++) {
+        unsigned long long stamp = event_time_ns(&events[i]);
+        // 다른 시계로 찍힌 입력(시각 0, 미래 시각)은 지연 통계에서 제외
+        if (events[i].type != EV_KEY || stamp == 0 || stamp > read_ns) {
+            continue;
+        }
+        kp_stats_record(protector->stats, KP_STAT_QUEUE, read_ns - stamp);
+        kp_stats_record(protector->stats, KP_STAT_EVENT, now - stamp);
+    }
+    if (protector->first_ns == 0) {
+        protector->first_ns = read_ns;
+    }
+    protector->last_ns = now;
+}
+
+/**
+ * @brief 처리량과 추가 지연, 판정 수를 출력합니다.
+ */
+static void print_report(const linux_protector* protector) {
+    const latency_histogram* added = &protector->stats->stages[KP_STAT_EVENT];
+    const latency_histogram* queue = &protector->stats->stages[KP_STAT_QUEUE];
+    double seconds = (protector->last_ns > protector->first_ns) ?
+                     (double)(protector->last_ns - protector->first_ns) / 1e9 : 0.0;
+    printf("[통계] 키 이벤트 %lu개 (통과 %lu, 변환 없는 키 차단 %lu, 무시한 이벤트 %lu), %.3f초, 초당 %.0f 이벤트\n",
+           protector->key_events, protector->passthrough, protector->unmapped_blocked, protector->ignored, seconds,
+           (seconds > 0.0) ? (double)protector->key_events / seconds : 0.0);
+    printf("[통계] 추가 지연 (ns): p50 %llu | p99 %llu | p99.9 %llu | 최대 %llu (읽기까지 p50 %llu | p99 %llu)\n",
+           (unsigned long long)latency_histogram_percentile(added, 0.50),
+           (unsigned long long)latency_histogram_percentile(added, 0.99),
+           (unsigned long long)latency_histogram_percentile(added, 0.999), (unsigned long long)added->max_ns,
+           (unsigned long long)latency_histogram_percentile(queue, 0.50),
+           (unsigned long long)latency_histogram_percentile(queue, 0.99));
+    printf("[통계] 판정: 허용 %llu | 차단 %llu | 확인 불가 %llu | 주입 %lu | 자동 반복 빠른 경로 %lu | 키 규칙 차단 %lu\n",
+           (unsigned long long)protector->stats->verdicts[KP_VERDICT_ALLOWED],
+           (unsigned long long)protector->stats->verdicts[KP_VERDICT_BLOCKED],
+           (unsigned long long)protector->stats->verdicts[KP_VERDICT_UNKNOWN],
+           protector->processor.injected, protector->processor.repeats, protector->processor.rule_blocked);
+    printf("[통계] 깨어남 %lu (평균 %.1f 이벤트) | read %lu | 출력 write %lu (실패 %lu) | "
+           "포그라운드 조회 %lu (캐시 적중 %lu, 변경 알림 %lu)\n",
+           protector->input.wakeups,
+           (protector->input.wakeups != 0) ? (double)protector->input.events / (double)protector->input.wakeups : 0.0,
+           protector->input.reads, protector->sink.writes, protector->sink.errors,
+           protector->cache.lookups, protector->cache.hits, protector->foreground.changes);
+}
+
+/**
+ * @brief 사용법을 출력합니다.
+ */
+static void print_usage(const char* program) {
+    fprintf(stderr,
+            "사용법: %s [--config <ini>] [--device <경로>]... [--no-grab] [--sink <출력 파일>]\n"
+            "       %*s [--foreground-file <경로> | --foreground <이름>] [--report <초>]\n",
+            program, (int)strlen(program), "");
+}
+
+/**
+ * @brief Linux용 프로그램의 메인 진입점
+ * @details 장치를 열고(독점), 출력 장치와 처리 코어를 준비한 뒤 이벤트 루프를 실행합니다.
+ * @return int 프로그램 종료 코드 (0: 정상 종료, 1: 오류 발생)
+ */
+int main(int argc, char* argv[]) {
+    linux_protector* protector = &g_protector;
+    const char* config_path = "config.ini";
+    const char* devices[LINUX_INPUT_MAX_DEVICES];
+    int device_count = 0;
+    int grab = 1;
+    const char* sink_path = NULL;
+    const char* foreground_file = NULL;
+    const char* foreground_name = NULL;
+    unsigned int report_seconds = 0;
+
+    // 0. 명령줄 옵션 처리
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
+            config_path = argv[++i];
+        } else if (strcmp(argv[i], "--device") == 0 && i + 1 < argc && device_count < LINUX_INPUT_MAX_DEVICES) {
+            devices[device_count++] = argv[++i];
+        } else if (strcmp(argv[i], "--no-grab") == 0) {
+            grab = 0;
+        } else if (strcmp(argv[i], "--sink") == 0 && i + 1 < argc) {
+            sink_path = argv[++i];
+        } else if (strcmp(argv[i], "--foreground-file") == 0 && i + 1 < argc) {
+            foreground_file = argv[++i];
+        } else if (strcmp(argv[i], "--foreground") == 0 && i + 1 < argc) {
+            foreground_name = argv[++i];
+        } else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc) {
+            report_seconds = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    // 1. 정책 로드와 설정 파일 감시
+    policy_store_init(&protector->store);
+    policy_load_status status = POLICY_LOAD_OK;
+    policy_snapshot* snapshot = policy_load_file(config_path, &status);
+    if (snapshot == NULL) {
+        return 1;
+    }
+    policy_store_publish(&protector->store, snapshot);
+    int reloading = config_reloader_init(&protector->reloader, config_path, &protector->store,
+                                         config_reloader_load_file, on_policy_published, protector) &&
+                    config_reloader_start(&protector->reloader);
+    if (!reloading) {
+        fprintf(stderr, "[경고] 설정 파일 변경 감시를 시작할 수 없습니다. 자동 리로드가 비활성화됩니다.\n");
+    }
+
+    // 2. 포그라운드 공급자 (고정 이름 또는 포그라운드 파일)
+    char default_foreground[FOREGROUND_NAME_SIZE];
+    if (foreground_name != NULL) {
+        linux_foreground_open_fixed(&protector->foreground, foreground_name);
+        printf("[정보] 포그라운드 프로세스를 %s(으)로 고정합니다.\n", foreground_name);
+    } else {
+        if (foreground_file == NULL) {
+            const char* runtime = getenv("XDG_RUNTIME_DIR");
+            snprintf(default_foreground, sizeof(default_foreground), "%s/kp_foreground",
+                     (runtime != NULL && runtime[0] != '\0') ? runtime : "/tmp");
+            foreground_file = default_foreground;
+        }
+        if (!linux_foreground_open_file(&protector->foreground, foreground_file)) {
+            return 1;
+        }
+        printf("[정보] 포그라운드 파일: %s (PID 또는 프로세스 이름, 없으면 모든 키 차단)\n", foreground_file);
+    }
+    foreground_cache_init(&protector->cache, &protector->foreground.provider, protector_verdict, protector);
+
+    // 3. 통계 블록 (tools/stats_reader로 실행 중에 볼 수 있음)
+    if (kp_shared_memory_create(&protector->stats_memory, KP_STATS_SHM_NAME, sizeof(kp_stats_block))) {
+        protector->stats = (kp_stats_block*)protector->stats_memory.address;
+    } else {
+        fprintf(stderr, "[경고] 공유 메모리 통계 블록을 만들 수 없습니다. 외부 모니터링이 비활성화됩니다.\n");
+        protector->stats = &protector->local_stats;
+    }
+    kp_stats_block_init(protector->stats, KP_STATS_DEFAULT_HOOK_TIMEOUT_MS);
+
+    // 4. 처리 코어 (솔트는 세션 난수 키의 키스트림 풀에서 꺼냄)
+    if (!keystream_pool_start(&protector->keystream, NULL, 0)) {
+        fprintf(stderr, "[오류] 키스트림 풀을 시작할 수 없습니다.\n");
+        return 1;
+    }
+    key_processor_backend backend = { protector, protector_make_salt, protector_inject, NULL };
+    key_processor_init(&protector->processor, &protector->cache, &backend, NULL);
+
+    // 5. 출력 장치를 만든 뒤 입력 장치 독점 (자동 검색은 uinput 장치를 이름으로 제외)
+    if (sink_path != NULL ? !linux_sink_open_file(&protector->sink, sink_path)
+                          : !linux_sink_open_uinput(&protector->sink, LINUX_UINPUT_NAME)) {
+        return 1;
+    }
+    if (!linux_input_init(&protector->input)) {
+        fprintf(stderr, "[오류] epoll을 만들 수 없습니다.\n");
+        return 1;
+    }
+    for (int i = 0; i < device_count; i++) {
+        if (!linux_input_add_device(&protector->input, devices[i], grab)) {
+            linux_input_close(&protector->input);
+            linux_sink_close(&protector->sink);
+            return 1;
+        }
+    }
+    if (device_count == 0 && linux_input_add_keyboards(&protector->input, grab) == 0) {
+        fprintf(stderr, "[오류] 열 수 있는 키보드가 없습니다. (/dev/input/event* 읽기 권한 필요, --device로 지정 가능)\n");
+        linux_sink_close(&protector->sink);
+        return 1;
+    }
+    if (protector->foreground.notify_fd >= 0) {
+        linux_input_watch(&protector->input, protector->foreground.notify_fd);
+    }
+    unsigned int exit_key = current_exit_key(snapshot);
+    if (exit_key != 0) {
+        printf("[정보] 종료 키(가상 키 0x%02X)나 Ctrl+C로 종료합니다.\n", exit_key);
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = on_signal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    // 6. 이벤트 루프 (장치 입력, 포그라운드 변경 알림, 주기 보고)
+    static struct input_event events[LINUX_EVENT_BATCH];
+    unsigned long long next_report = (report_seconds != 0) ? kp_now_ns() + report_seconds * 1000000000ULL : 0;
+    int exit_code = 0;
+    while (!g_stop && protector->input.open_devices > 0) {
+        int foreground_changed = 0;
+        int count = linux_input_wait(&protector->input, events, LINUX_EVENT_BATCH,
+                                     (report_seconds != 0) ? 1000 : -1, &foreground_changed);
+        if (count < 0) {
+            perror("[오류] epoll_wait");
+            exit_code = 1;
+            break;
+        }
+        // 같은 깨어남에 읽은 키는 변경 알림보다 먼저 입력된 것이므로 이전 포그라운드로 판정한 뒤 무효화
+        if (count > 0) {
+            process_batch(protector, events, count, kp_now_ns());
+        }
+        if (foreground_changed && linux_foreground_drain(&protector->foreground)) {
+            foreground_cache_invalidate(&protector->cache);
+        }
+        if (next_report != 0 && kp_now_ns() >= next_report) {
+            print_report(protector);
+            next_report += report_seconds * 1000000000ULL;
+        }
+    }
+
+    // 7. 정리 (독점 해제, 눌린 키 떼기) 후 보고
+    linux_input_close(&protector->input);
+    linux_sink_close(&protector->sink);
+    print_report(protector);
+    if (reloading) {
+        config_reloader_stop(&protector->reloader);
+    }
+    keystream_pool_stop(&protector->keystream);
+    linux_foreground_close(&protector->foreground);
+    if (protector->stats != &protector->local_stats) {
+        kp_shared_memory_close(&protector->stats_memory);
+    }
+    policy_store_destroy(&protector->store);
+    printf("[종료] 키보드 보안 툴이 정상적으로 종료되었습니다.\n");
+    return exit_code;
+}
@@ -0,0 +1,138 @@
+#include "log_ring.h"
+#include "kp_atomic.h"
+
+#include <string.h>
+
+/**
+ * @brief 로그 링을 초기화합니다.
+ * @param log 초기화할 로그 링
+ * @param verbosity 초기 상세 수준
+ */
+void log_ring_init(log_ring* log, int verbosity) {
+    memset(log, 0, sizeof(*log));
+    spsc_ring_init(&log->ring, log->storage, sizeof(log_record), LOG_RING_CAPACITY);
+    log->verbosity = verbosity;
+}
+
+/**
+ * @brief 상세 수준을 변경합니다.
+ */
+void log_ring_set_verbosity(log_ring* log, int verbosity) {
+    kp_atomic_store(&log->verbosity, verbosity);
+}
+
+/**
+ * @brief 주어진 판정의 레코드를 기록해야 하는지 확인합니다.
+ */
+int log_ring_wants(const log_ring* log, int verdict) {
+    int verbosity = kp_atomic_load_relaxed(&log->verbosity);
+    if (verbosity >= LOG_VERBOSITY_ALL) {
+        return 1;
+    }
+    return verbosity >= LOG_VERBOSITY_BLOCKED && verdict != LOG_VERDICT_ALLOWED;
+}
+
+/**
+ * @brief 프로세스 이름을 인턴하고 인덱스를 반환합니다.
+ * @details 테이블은 추가만 가능하므로 소비자는 name_count 이하의 슬롯을 잠금 없이 읽을 수 있습니다.
+ */
+unsigned short log_ring_intern_name(log_ring* log, const char* name) {
+    if (name == NULL) {
+        return LOG_NAME_NONE;
+    }
+    
+    unsigned long count = log->name_count;
+    for (unsigned long i = 0; i < count; i++) {
+        if (strcmp(log->names[i], name) == 0) {
+            return (unsigned short)i;
+        }
+    }
+    
+    if (count >= LOG_NAME_SLOTS) {
+        return LOG_NAME_NONE;
+    }
+    
+    strncpy(log->names[count], name, LOG_NAME_SIZE - 1);
+    log->names[count][LOG_NAME_SIZE - 1] = '\0';
+    kp_atomic_store(&log->name_count, count + 1);
+    return (unsigned short)count;
+}
+
+/**
+ * @brief 레코드를 기록합니다.
+ */
+int log_ring_write(log_ring* log, const log_record* record) {
+    if (!spsc_ring_push(&log->ring, record)) {
+        kp_atomic_add_relaxed(&log->dropped, 1UL);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief 인덱스에 해당하는 프로세스 이름을 반환합니다. (소비자 측)
+ */
+static const char* lookup_name(log_ring* log, unsigned short name_id) {
+    if (name_id == LOG_NAME_NONE || name_id >= kp_atomic_load(&log->name_count)) {
+        return "?";
+    }
+    return log->names[name_id];
+}
+
+/**
+ * @brief 쌓인 레코드를 포맷팅하여 출력합니다.
+ * @param log 로그 링
+ * @param out 출력 스트림
+ * @param with_timestamp 각 줄 앞에 시각을 붙일지 여부
+ * @return unsigned long 처리한 레코드 수
+ */
+unsigned long log_ring_drain(log_ring* log, FILE* out, int with_timestamp) {
+    log_record record;
+    unsigned long processed = 0;
+    
+    while (spsc_ring_pop(&log->ring, &record)) {
+        if (with_timestamp) {
+            fprintf(out, "[%llu.%06llu] ", record.timestamp_ns / 1000000000ULL,
+                    (record.timestamp_ns / 1000ULL) % 1000000ULL);
+        }
+        if (record.repeats > 0) {
+            // 키를 누르고 있는 동안 합쳐진 자동 반복 요약
+            fprintf(out, "[반복] 원본 KeyCode: %u | 프로세스: %s | 자동 반복 %u회 (같은 판정)\n",
+                    (unsigned int)record.vk_code,
+                    lookup_name(log, record.name_id),
+                    (unsigned int)record.repeats);
+            processed++;
+            continue;
+        }
+        fprintf(out, "[키 감지] 원본 KeyCode: %u | 솔트: %u | 암호화된 KeyCode: %u\n",
+                (unsigned int)record.vk_code, record.salt, record.encrypted_keycode);
+        
+        switch (record.verdict) {
+        case LOG_VERDICT_ALLOWED:
+            fprintf(out, "[복호화] 프로세스: %s | 복호화된 KeyCode: %u\n",
+                    lookup_name(log, record.name_id), (unsigned int)record.vk_code);
+            break;
+        case LOG_VERDICT_BLOCKED:
+            fprintf(out, "[차단] 프로세스: %s | 키 입력이 차단되었습니다.\n",
+                    lookup_name(log, record.name_id));
+            break;
+        default:
+            fprintf(out, "[경고] 프로세스 정보를 가져올 수 없습니다. 키 입력을 차단합니다.\n");
+            break;
+        }
+        processed++;
+    }
+    
+    // 링이 가득 차서 버려진 레코드가 있으면 한 번에 보고
+    unsigned long dropped = kp_atomic_load_relaxed(&log->dropped);
+    if (dropped != log->reported_dropped) {
+        fprintf(out, "[로그] 로그 링이 가득 차서 %lu개의 기록이 누락되었습니다.\n",
+                dropped - log->reported_dropped);
+        log->reported_dropped = dropped;
+    }
+    
+    if (processed > 0) {
+        fflush(out);
+    }
+    return processed;
+}
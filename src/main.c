@@ -1,37 +1,58 @@
 #include "keyboard_protector.h"
 
+#include <string.h>
+
 /**
  * @brief 프로그램의 메인 진입점
- * @details 키보드 후크를 설치하고 메시지 루프를 실행하여 키보드 입력을 모니터링합니다.
- *          Esc 키를 눌러 종료할 수 있으며, 정상 종료 시 후크를 해제하고 종료합니다.
+ * @details 키보드 후크를 설치하고 이벤트 루프를 실행하여 키보드 입력을 모니터링합니다.
+ *          종료 키(기본값 Esc)나 제어 채널의 종료 요청으로 종료할 수 있으며, 정상 종료 시 후크를 해제하고 종료합니다.
+ *          --record <파일>을 지정하면 처리한 키 이벤트를 트레이스 파일로 기록하고,
+ *          --control <이름>으로 제어 채널 이름을 바꾸거나 --no-control로 제어 채널을 끌 수 있습니다.
+ *          --shadow를 지정하면 키 입력을 차단하지 않고 정책 판정만 집계하는 그림자 모드로 실행합니다.
+ *          --record와 --shadow는 해당 기능을 켠 빌드(kp_config.h)에서만 받습니다.
+ * @param argc 명령줄 인자 수
+ * @param argv 명령줄 인자
  * @return int 프로그램 종료 코드 (0: 정상 종료, 1: 오류 발생)
  */
-int main() {
+int main(int argc, char* argv[]) {
+    // 0. 명령줄 옵션 처리
+    for (int i = 1; i < argc; i++) {
+#if KP_FEATURE_TRACE
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            if (!StartTraceRecording(argv[++i])) {
+                return 1;
+            }
+            continue;
+        }
+#endif
+#if KP_FEATURE_SHADOW
+        if (strcmp(argv[i], "--shadow") == 0) {
+            EnableShadowMode();
+            continue;
+        }
+#endif
+        if (strcmp(argv[i], "--control") == 0 && i + 1 < argc) {
+            if (!SetControlChannelName(argv[++i])) {
+                fprintf(stderr, "[오류] 제어 채널 이름이 너무 깁니다: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--no-control") == 0) {
+            SetControlChannelName(NULL);
+        } else {
+            fprintf(stderr, "사용법: %s%s [--control <채널 이름> | --no-control]%s\n", argv[0],
+                    KP_FEATURE_TRACE ? " [--record <트레이스 파일>]" : "", KP_FEATURE_SHADOW ? " [--shadow]" : "");
+            return 1;
+        }
+    }
+
     // 1. 후크 설치
     SetHook();
 
-    // 2. 메시지 루프
-    MSG msg;
-    // WM_QUIT 메시지를 받을 때까지 루프를 계속 돌면서 후크가 동작하도록 합니다.
-    BOOL bRet;
-    int exitCode = 0;
-    while ((bRet = GetMessage(&msg, NULL, 0, 0)) != 0) {
-        // GetMessage가 -1을 반환하면 오류 발생
-        if (bRet == -1) {
-            fprintf(stderr, "[오류] 메시지 루프 오류가 발생했습니다.\n");
-            exitCode = 1;
-            break;
-        }
-        
-        TranslateMessage(&msg);
-        DispatchMessage(&msg);
-        
-        // Esc 키는 LowLevelKeyboardProc에서 처리되므로, WM_QUIT을 명시적으로 체크할 필요는 없지만
-        // 일반적으로 메시지 루프의 기본적인 형태를 유지합니다.
-    }
+    // 2. 이벤트 루프 (후크 메시지, 종료 요청, 제어 채널, 설정 파일 변경, 타이머)
+    int exitCode = RunEventLoop();
 
     // 3. 후크 해제 및 종료
     UnsetHook();
     printf("[종료] 키보드 보안 툴이 정상적으로 종료되었습니다.\n");
     return exitCode;
-}
\ No newline at end of file
+}
@@ -0,0 +1,288 @@
+#include "policy_loader.h"
+#include "ini_parser.h"
+#include "log_ring.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** @brief 1이면 항목별 안내 출력을 생략, 2이면 INI 줄 경고도 생략 (오류는 항상 출력) */
+static int g_policy_quiet = 0;
+
+/**
+ * @brief INI 줄 하나에 대한 경고를 출력합니다.
+ */
+static void warn_line(int line, const char* format, ...) {
+    if (g_policy_quiet >= 2) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    fprintf(stderr, "[경고] INI %d번째 줄: ", line);
+    vfprintf(stderr, format, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
+
+/**
+ * @brief 파싱 중 상태
+ */
+typedef struct policy_load_context {
+    policy_snapshot* snapshot; /**< 채우는 중인 스냅샷 */
+    int out_of_memory;         /**< 메모리 부족으로 중단되었는지 여부 */
+} policy_load_context;
+
+/**
+ * @brief 잘못된 줄을 경고로 출력합니다.
+ */
+static void on_error(void* user, int line, const char* message) {
+    (void)user;
+    warn_line(line, "%s (무시합니다)", message);
+}
+
+/**
+ * @brief 키 규칙을 쓸 수 없는 프로세스를 모든 키 차단으로 지정합니다.
+ * @details 같은 프로세스가 [AllowedProcesses]에 (앞이든 뒤든) 있어도 전체 허용으로 남지 않도록
+ *          허용 목록에 KEY_POLICY_RULE_DENY를 저장합니다.
+ */
+static int deny_key_rule(policy_load_context* context, const char* name) {
+    if (!allowlist_set(&context->snapshot->allowed, name, KEY_POLICY_RULE_DENY + 1)) {
+        fprintf(stderr, "[오류] 메모리가 부족하여 키 규칙을 추가할 수 없습니다: %s\n", name);
+        context->out_of_memory = 1;
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief [KeyRules]의 "<프로세스>=<규칙>" 항목을 컴파일하여 규칙 테이블에 추가합니다.
+ * @details 규칙에 알 수 없는 항목이 있거나 테이블이 가득 차면 경고 후 해당 프로세스의 모든 키를 차단합니다.
+ *          같은 프로세스가 [AllowedProcesses]에도 있으면 키 규칙이 우선합니다.
+ */
+static int add_key_rule(policy_load_context* context, const ini_entry* entry) {
+    policy_snapshot* snapshot = context->snapshot;
+    char name[POLICY_PATH_SIZE];
+    char spec[POLICY_PATH_SIZE];
+    char bad_token[32];
+    ini_slice_copy(entry->key, name, sizeof(name));
+    ini_slice_copy(entry->value, spec, sizeof(spec));
+    
+    key_rule rule;
+    if (!key_rule_compile(&rule, spec, bad_token, sizeof(bad_token))) {
+        warn_line(entry->line, "알 수 없는 키 규칙 항목입니다: %s (%s은(는) 모든 키를 차단합니다)",
+                  bad_token, name);
+        return deny_key_rule(context, name);
+    }
+    int index = key_policy_add(&snapshot->keys, &rule);
+    if (index < 0) {
+        warn_line(entry->line, "키 규칙은 최대 %d개까지 사용할 수 있습니다. (%s은(는) 모든 키를 차단합니다)",
+                  KEY_POLICY_MAX_RULES - 1, name);
+        return deny_key_rule(context, name);
+    }
+    if (!allowlist_set(&snapshot->allowed, name, (unsigned int)index + 1)) {
+        fprintf(stderr, "[오류] 메모리가 부족하여 키 규칙을 추가할 수 없습니다: %s\n", name);
+        context->out_of_memory = 1;
+        return 0;
+    }
+    if (!g_policy_quiet) {
+        printf("[설정] 키 규칙 추가: %s (키 %u개, 조합 키 상태 %u/%d)\n", name,
+               key_rule_key_count(&rule), key_rule_chord_count(&rule), KEY_MOD_STATES);
+    }
+    return 1;
+}
+
+/**
+ * @brief [Devices]의 "Default=<분류>" 또는 "<장치 이름 일부>=<분류>" 항목을 반영합니다.
+ */
+static void add_device_rule(policy_load_context* context, const ini_entry* entry) {
+    device_rules* rules = &context->snapshot->devices;
+    char pattern[DEVICE_RULE_PATTERN_SIZE];
+    char value[32];
+    ini_slice_copy(entry->key, pattern, sizeof(pattern));
+    ini_slice_copy(entry->value, value, sizeof(value));
+    int device_class = device_class_parse(value);
+    if (device_class < 0) {
+        warn_line(entry->line, "알 수 없는 장치 분류입니다: %s (normal, trusted, untrusted 중 하나)",
+                  value);
+        return;
+    }
+    if (ini_slice_equals(entry->key, "Default")) {
+        rules->default_class = device_class;
+        return;
+    }
+    if (!device_rules_add(rules, pattern, device_class)) {
+        warn_line(entry->line, "장치 규칙은 최대 %d개까지 사용할 수 있습니다: %s", DEVICE_MAX_RULES, pattern);
+        return;
+    }
+    if (!g_policy_quiet) {
+        printf("[설정] 장치 규칙 추가: %s → %s\n", pattern, device_class_name(device_class));
+    }
+}
+
+/**
+ * @brief 항목 하나를 스냅샷에 반영합니다.
+ */
+static int on_entry(void* user, const ini_entry* entry) {
+    policy_load_context* context = (policy_load_context*)user;
+    policy_snapshot* snapshot = context->snapshot;
+    char value[POLICY_PATH_SIZE];
+    
+    if (ini_slice_equals(entry->section, "AllowedProcesses")) {
+        if (entry->value.len == 0) {
+            return 1;
+        }
+        ini_slice_copy(entry->value, value, sizeof(value));
+        if (!allowlist_add(&snapshot->allowed, value)) {
+            fprintf(stderr, "[오류] 메모리가 부족하여 허용 프로세스를 추가할 수 없습니다: %s\n", value);
+            context->out_of_memory = 1;
+            return 0;
+        }
+        if (!g_policy_quiet) {
+            printf("[설정] 허용 프로세스 추가: %s\n", value);
+        }
+    } else if (ini_slice_equals(entry->section, "KeyRules")) {
+        return add_key_rule(context, entry);
+    } else if (ini_slice_equals(entry->section, "KeyPolicy")) {
+        if (ini_slice_equals(entry->key, "ExitKey")) {
+            ini_slice_copy(entry->value, value, sizeof(value));
+            int vk = ini_slice_equals(entry->value, "none") ? 0 : key_name_to_vk(value);
+            if (vk < 0) {
+                warn_line(entry->line, "알 수 없는 ExitKey 값입니다: %s (Esc로 처리)", value);
+                vk = KEY_POLICY_DEFAULT_EXIT_KEY;
+            }
+            snapshot->exit_key = (unsigned int)vk;
+        }
+    } else if (ini_slice_equals(entry->section, "Logging")) {
+        if (ini_slice_equals(entry->key, "Verbosity")) {
+            ini_slice_copy(entry->value, value, sizeof(value));
+            snapshot->log_verbosity = atoi(value);
+        } else if (ini_slice_equals(entry->key, "LogFile")) {
+            ini_slice_copy(entry->value, snapshot->log_file, sizeof(snapshot->log_file));
+        } else if (ini_slice_equals(entry->key, "JournalDir")) {
+            ini_slice_copy(entry->value, snapshot->journal_dir, sizeof(snapshot->journal_dir));
+        } else if (ini_slice_equals(entry->key, "JournalSegmentMB")) {
+            ini_slice_copy(entry->value, value, sizeof(value));
+            snapshot->journal_segment_mb = strtoul(value, NULL, 10);
+        } else if (ini_slice_equals(entry->key, "JournalKeyFile")) {
+            ini_slice_copy(entry->value, snapshot->journal_key_file, sizeof(snapshot->journal_key_file));
+        }
+    } else if (ini_slice_equals(entry->section, "Injection")) {
+        if (ini_slice_equals(entry->key, "Foreign")) {
+            if (ini_slice_equals(entry->value, "pass")) {
+                snapshot->foreign_injection = POLICY_INJECTION_PASS;
+            } else if (ini_slice_equals(entry->value, "block")) {
+                snapshot->foreign_injection = POLICY_INJECTION_BLOCK;
+            } else if (ini_slice_equals(entry->value, "process")) {
+                snapshot->foreign_injection = POLICY_INJECTION_PROCESS;
+            } else {
+                warn_line(entry->line, "알 수 없는 Foreign 값입니다 (process로 처리)");
+                snapshot->foreign_injection = POLICY_INJECTION_PROCESS;
+            }
+        } else if (ini_slice_equals(entry->key, "BatchSize")) {
+            ini_slice_copy(entry->value, value, sizeof(value));
+            snapshot->inject_batch_size = strtoul(value, NULL, 10);
+        } else if (ini_slice_equals(entry->key, "BatchDelayUs")) {
+            ini_slice_copy(entry->value, value, sizeof(value));
+            snapshot->inject_batch_delay_us = strtoul(value, NULL, 10);
+        } else if (ini_slice_equals(entry->key, "Unicode")) {
+            ini_slice_copy(entry->value, value, sizeof(value));
+            snapshot->inject_unicode = (atoi(value) != 0);
+        }
+    } else if (ini_slice_equals(entry->section, "Hook")) {
+        if (ini_slice_equals(entry->key, "LatencyBudgetUs")) {
+            ini_slice_copy(entry->value, value, sizeof(value));
+            snapshot->hook_budget_us = strtoul(value, NULL, 10);
+        }
+    } else if (ini_slice_equals(entry->section, "Shadow")) {
+        if (ini_slice_equals(entry->key, "Enabled")) {
+            ini_slice_copy(entry->value, value, sizeof(value));
+            snapshot->shadow_enabled = (atoi(value) != 0);
+        } else if (ini_slice_equals(entry->key, "Candidate")) {
+            ini_slice_copy(entry->value, snapshot->shadow_candidate, sizeof(snapshot->shadow_candidate));
+        } else if (ini_slice_equals(entry->key, "ReportFile")) {
+            ini_slice_copy(entry->value, snapshot->shadow_report, sizeof(snapshot->shadow_report));
+        }
+    } else if (ini_slice_equals(entry->section, "Devices")) {
+        add_device_rule(context, entry);
+    }
+    return 1;
+}
+
+/**
+ * @brief 항목별 안내 출력을 켜거나 끕니다.
+ */
+void policy_load_set_quiet(int quiet) {
+    g_policy_quiet = quiet;
+}
+
+/**
+ * @brief 메모리에 있는 INI 내용으로 정책 스냅샷을 만듭니다.
+ */
+policy_snapshot* policy_load_buffer(const char* data, size_t size, policy_load_status* status) {
+    policy_snapshot* snapshot = policy_snapshot_create();
+    if (snapshot == NULL) {
+        fprintf(stderr, "[오류] 메모리가 부족하여 정책을 만들 수 없습니다.\n");
+        return NULL;
+    }
+    snapshot->log_verbosity = LOG_VERBOSITY_ALL;
+    
+    policy_load_context context;
+    context.snapshot = snapshot;
+    context.out_of_memory = 0;
+    
+    ini_handler handler;
+    handler.entry = on_entry;
+    handler.error = on_error;
+    handler.user = &context;
+    ini_parse(data, size, &handler);
+    
+    if (context.out_of_memory) {
+        policy_snapshot_destroy(snapshot);
+        return NULL;
+    }
+    
+    *status = POLICY_LOAD_OK;
+    if (allowlist_count(&snapshot->allowed) == 0) {
+        if (g_policy_quiet < 2) {
+            fprintf(stderr, "[경고] INI 파일에서 허용 프로세스를 찾을 수 없습니다.\n");
+            fprintf(stderr, "[정보] 기본 설정으로 %s만 허용합니다.\n", POLICY_DEFAULT_PROCESS);
+        }
+        allowlist_add(&snapshot->allowed, POLICY_DEFAULT_PROCESS);
+        *status = POLICY_LOAD_DEFAULT;
+        return snapshot;
+    }
+    
+    if (!g_policy_quiet) {
+        printf("[설정] 총 %lu개의 허용 프로세스가 로드되었습니다.\n", allowlist_count(&snapshot->allowed));
+    }
+    return snapshot;
+}
+
+/**
+ * @brief INI 파일을 한 번 읽어 정책 스냅샷을 만듭니다.
+ */
+policy_snapshot* policy_load_file(const char* path, policy_load_status* status) {
+    if (!g_policy_quiet) {
+        printf("[설정] INI 파일 로드 시도: %s\n", path);
+    }
+    
+    size_t size = 0;
+    char* data = ini_read_file(path, &size);
+    if (data == NULL) {
+        fprintf(stderr, "[경고] INI 파일을 찾을 수 없습니다: %s\n", path);
+        fprintf(stderr, "[정보] 기본 설정으로 %s만 허용합니다.\n", POLICY_DEFAULT_PROCESS);
+        policy_snapshot* snapshot = policy_snapshot_create();
+        if (snapshot == NULL) {
+            return NULL;
+        }
+        snapshot->log_verbosity = LOG_VERBOSITY_ALL;
+        allowlist_add(&snapshot->allowed, POLICY_DEFAULT_PROCESS);
+        *status = POLICY_LOAD_MISSING;
+        return snapshot;
+    }
+    
+    policy_snapshot* snapshot = policy_load_buffer(data, size, status);
+    free(data);
+    return snapshot;
+}
@@ -0,0 +1,119 @@
+#include "policy_store.h"
+#include "kp_atomic.h"
+#include "kp_platform.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 빈 정책 스냅샷을 만듭니다.
+ */
+policy_snapshot* policy_snapshot_create(void) {
+    policy_snapshot* snapshot = (policy_snapshot*)calloc(1, sizeof(policy_snapshot));
+    if (snapshot != NULL) {
+        allowlist_init(&snapshot->allowed);
+        key_policy_init(&snapshot->keys);
+        device_rules_init(&snapshot->devices);
+        snapshot->exit_key = KEY_POLICY_DEFAULT_EXIT_KEY;
+    }
+    return snapshot;
+}
+
+/**
+ * @brief 스냅샷과 그 안의 목록을 해제합니다.
+ */
+void policy_snapshot_destroy(policy_snapshot* snapshot) {
+    if (snapshot == NULL) {
+        return;
+    }
+    allowlist_free(&snapshot->allowed);
+    free(snapshot);
+}
+
+/**
+ * @brief 정책 저장소를 초기화합니다.
+ */
+void policy_store_init(policy_store* store) {
+    memset(store, 0, sizeof(*store));
+    store->reader_epoch = POLICY_READER_IDLE;
+}
+
+/**
+ * @brief 현재 스냅샷을 읽기 위해 진입합니다.
+ * @details 세대 값을 먼저 게시한 뒤 포인터를 읽습니다. 게시 스레드는 포인터 교환 뒤
+ *          이 값을 확인하므로, 유휴 상태로 보였다면 읽기 스레드는 반드시 새 포인터를 읽게 됩니다.
+ */
+policy_snapshot* policy_store_enter(policy_store* store) {
+    unsigned long epoch = __atomic_load_n(&store->epoch, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&store->reader_epoch, epoch, __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&store->current, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief 스냅샷 참조를 끝냅니다.
+ */
+void policy_store_exit(policy_store* store) {
+    kp_atomic_store(&store->reader_epoch, POLICY_READER_IDLE);
+}
+
+/**
+ * @brief 현재 스냅샷을 반환합니다. (게시 스레드 전용)
+ */
+policy_snapshot* policy_store_current(const policy_store* store) {
+    return kp_atomic_load(&store->current);
+}
+
+/**
+ * @brief 읽기 스레드가 더 이상 참조하지 않는 스냅샷을 해제합니다.
+ * @details 세대 E에 대체된 스냅샷은 읽기 스레드가 유휴 상태이거나 E 이상의 세대로 진입한 경우에만
+ *          안전하게 해제할 수 있습니다.
+ */
+int policy_store_reclaim(policy_store* store) {
+    unsigned long reader = __atomic_load_n(&store->reader_epoch, __ATOMIC_SEQ_CST);
+    int kept = 0;
+    for (int i = 0; i < store->retired_count; i++) {
+        policy_retired* entry = &store->retired[i];
+        if (reader == POLICY_READER_IDLE || reader >= entry->epoch) {
+            policy_snapshot_destroy(entry->snapshot);
+        } else {
+            store->retired[kept++] = *entry;
+        }
+    }
+    store->retired_count = kept;
+    return kept;
+}
+
+/**
+ * @brief 새 스냅샷을 게시하고 이전 스냅샷을 회수 대기 목록에 넣습니다.
+ */
+void policy_store_publish(policy_store* store, policy_snapshot* snapshot) {
+    // 대기 목록에 자리가 생길 때까지 읽기 스레드가 빠져나오기를 기다림
+    while (store->retired_count >= POLICY_RETIRE_SLOTS && policy_store_reclaim(store) >= POLICY_RETIRE_SLOTS) {
+        kp_sleep_ms(1);
+    }
+    
+    unsigned long epoch = __atomic_load_n(&store->epoch, __ATOMIC_SEQ_CST) + 1;
+    if (snapshot != NULL) {
+        snapshot->version = epoch;
+    }
+    policy_snapshot* old = __atomic_exchange_n(&store->current, snapshot, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&store->epoch, epoch, __ATOMIC_SEQ_CST);
+    
+    if (old != NULL) {
+        store->retired[store->retired_count].snapshot = old;
+        store->retired[store->retired_count].epoch = epoch;
+        store->retired_count++;
+    }
+    policy_store_reclaim(store);
+}
+
+/**
+ * @brief 현재 스냅샷과 대기 중인 스냅샷을 모두 해제합니다.
+ */
+void policy_store_destroy(policy_store* store) {
+    for (int i = 0; i < store->retired_count; i++) {
+        policy_snapshot_destroy(store->retired[i].snapshot);
+    }
+    policy_snapshot_destroy(store->current);
+    policy_store_init(store);
+}
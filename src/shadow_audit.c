@@ -0,0 +1,290 @@
+#include "shadow_audit.h"
+#include "key_processor.h"
+#include "kp_atomic.h"
+#include "kp_platform.h"
+
+#include <ctype.h>
+#include <string.h>
+
+/**
+ * @brief 키 분류 범위 (key_policy.c의 분류 표와 같은 범위)
+ */
+static const struct {
+    unsigned char first;
+    unsigned char last;
+    unsigned char key_class;
+} g_class_ranges[] = {
+    { 0x41, 0x5A, SHADOW_KEY_ALPHA },
+    { 0x30, 0x39, SHADOW_KEY_DIGIT },
+    { 0x70, 0x87, SHADOW_KEY_FUNC },
+    { 0x21, 0x28, SHADOW_KEY_NAV }, { 0x2D, 0x2E, SHADOW_KEY_NAV },
+    { 0x08, 0x09, SHADOW_KEY_EDIT }, { 0x0D, 0x0D, SHADOW_KEY_EDIT }, { 0x20, 0x20, SHADOW_KEY_EDIT },
+    { 0xBA, 0xC0, SHADOW_KEY_PUNCT }, { 0xDB, 0xDF, SHADOW_KEY_PUNCT }, { 0xE2, 0xE2, SHADOW_KEY_PUNCT },
+    { 0x60, 0x6F, SHADOW_KEY_NUMPAD },
+    { 0x10, 0x12, SHADOW_KEY_MODIFIER }, { 0x5B, 0x5C, SHADOW_KEY_MODIFIER }, { 0xA0, 0xA5, SHADOW_KEY_MODIFIER }
+};
+
+/**
+ * @brief 집계 상태를 초기화합니다.
+ */
+void shadow_audit_init(shadow_audit* audit) {
+    memset(audit, 0, sizeof(*audit));
+    memset(audit->classes, SHADOW_KEY_OTHER, sizeof(audit->classes));
+    for (size_t i = 0; i < sizeof(g_class_ranges) / sizeof(g_class_ranges[0]); i++) {
+        for (unsigned int vk = g_class_ranges[i].first; vk <= g_class_ranges[i].last; vk++) {
+            audit->classes[vk] = g_class_ranges[i].key_class;
+        }
+    }
+    strcpy(audit->unknown.name, "(unknown)");
+    audit->unknown.used = 1;
+    strcpy(audit->overflow.name, "(other)");
+    audit->overflow.used = 1;
+}
+
+/**
+ * @brief 대소문자를 구분하지 않는 FNV-1a 해시
+ */
+static uint32_t hash_name(const char* name) {
+    uint32_t hash = 2166136261U;
+    for (const unsigned char* p = (const unsigned char*)name; *p != '\0'; p++) {
+        hash = (hash ^ (uint32_t)tolower(*p)) * 16777619U;
+    }
+    return hash;
+}
+
+/**
+ * @brief 대소문자를 구분하지 않고 이름을 비교합니다.
+ */
+static int name_equals(const char* a, const char* b) {
+    while (*a != '\0' && tolower((unsigned char)*a) == tolower((unsigned char)*b)) {
+        a++;
+        b++;
+    }
+    return *a == '\0' && *b == '\0';
+}
+
+/**
+ * @brief 프로세스 항목을 찾고, 없으면 빈 자리에 등록합니다.
+ * @details 표가 가득 차면 "(other)" 항목을 반환합니다. 항목은 삭제하지 않으므로 탐사는 빈 자리에서 끝납니다.
+ */
+static shadow_process* find_process(shadow_audit* audit, const char* name) {
+    uint32_t index = hash_name(name) & (SHADOW_AUDIT_PROCESSES - 1);
+    for (int probe = 0; probe < SHADOW_AUDIT_PROCESSES; probe++) {
+        shadow_process* entry = &audit->processes[index];
+        if (!entry->used) {
+            strncpy(entry->name, name, sizeof(entry->name) - 1);
+            entry->name[sizeof(entry->name) - 1] = '\0';
+            // 보고서를 쓰는 스레드가 완성된 이름만 보도록 이름을 쓴 뒤 게시
+            kp_atomic_store(&entry->used, 1);
+            audit->processes_used++;
+            return entry;
+        }
+        if (name_equals(entry->name, name)) {
+            return entry;
+        }
+        index = (index + 1) & (SHADOW_AUDIT_PROCESSES - 1);
+    }
+    return &audit->overflow;
+}
+
+/**
+ * @brief 포그라운드 캐시 세대와 후보 정책이 바뀌었으면 프로세스 항목과 후보 규칙 번호를 다시 구합니다.
+ */
+static void refresh_cache(shadow_audit* audit, const foreground_cache* foreground,
+                          const policy_snapshot* candidate, const char* process_name) {
+    unsigned long candidate_version = (candidate != NULL) ? candidate->version : 0;
+    if (audit->cache_valid && audit->cached_generation == foreground->cached_generation &&
+        audit->cached_candidate == candidate && audit->cached_candidate_version == candidate_version) {
+        return;
+    }
+    audit->cached_entry = find_process(audit, process_name);
+    audit->cached_candidate_rule = (candidate != NULL) ? allowlist_value(&candidate->allowed, process_name) : 0;
+    audit->cached_generation = foreground->cached_generation;
+    audit->cached_candidate = candidate;
+    audit->cached_candidate_version = candidate_version;
+    audit->cache_valid = 1;
+}
+
+/**
+ * @brief 키 다운 하나를 판정하고 집계합니다.
+ */
+static foreground_verdict audit_key_down(shadow_audit* audit, foreground_cache* foreground,
+                                         const policy_snapshot* active, const policy_snapshot* candidate,
+                                         unsigned int vk_code) {
+    const char* process_name = NULL;
+    unsigned int modifiers = key_modifier_state(audit->modifier_keys);
+    foreground_verdict verdict = foreground_cache_lookup(foreground, &process_name);
+
+    shadow_process* entry;
+    int candidate_verdict;
+    if (verdict == FOREGROUND_UNKNOWN || process_name == NULL) {
+        verdict = FOREGROUND_UNKNOWN;
+        entry = &audit->unknown;
+        candidate_verdict = (candidate != NULL) ? FOREGROUND_UNKNOWN : SHADOW_VERDICT_NONE;
+    } else {
+        refresh_cache(audit, foreground, candidate, process_name);
+        entry = audit->cached_entry;
+        if (verdict == FOREGROUND_ALLOWED && active != NULL &&
+            !key_policy_allows(&active->keys, (unsigned int)foreground->allowed - 1U, vk_code, modifiers)) {
+            verdict = FOREGROUND_BLOCKED;
+        }
+        if (candidate == NULL) {
+            candidate_verdict = SHADOW_VERDICT_NONE;
+        } else {
+            unsigned int rule = audit->cached_candidate_rule;
+            candidate_verdict = (rule != 0 && key_policy_allows(&candidate->keys, rule - 1U, vk_code, modifiers))
+                                ? FOREGROUND_ALLOWED : FOREGROUND_BLOCKED;
+        }
+    }
+
+    entry->counts[audit->classes[vk_code & 0xFF]][verdict][candidate_verdict]++;
+    audit->key_downs++;
+    if (candidate_verdict != SHADOW_VERDICT_NONE && candidate_verdict != (int)verdict) {
+        audit->disagreements++;
+    }
+    return verdict;
+}
+
+/**
+ * @brief 키 이벤트 하나를 판정하고 집계합니다. (작업 스레드)
+ */
+foreground_verdict shadow_audit_handle(shadow_audit* audit, foreground_cache* foreground,
+                                       const policy_snapshot* active, const policy_snapshot* candidate,
+                                       const key_event* event) {
+    unsigned int vk_code = event->vk_code & 0xFF;
+    uint32_t bit = 1U << (vk_code & 31);
+    uint32_t* pressed = &audit->pressed[vk_code >> 5];
+    unsigned int modifier = key_modifier_key(vk_code);
+    foreground_verdict verdict;
+
+    if (key_processor_is_key_down(event->message)) {
+        if (*pressed & bit) {
+            // 자동 반복: 첫 키 다운과 판정이 같으므로 집계하지 않음
+            audit->repeats++;
+            verdict = foreground_cache_lookup(foreground, NULL);
+        } else {
+            // 판정과 집계는 새 키 다운에서만 하므로 이 구간만 시간을 잼 (자동 반복과 키 업은 조회 캐시 적중뿐)
+            unsigned long long start = kp_now_ns();
+            *pressed |= bit;
+            verdict = audit_key_down(audit, foreground, active, candidate, vk_code);
+            uint64_t elapsed = kp_now_ns() - start;
+            audit->eval_ns_total += elapsed;
+            if (elapsed > audit->eval_ns_max) {
+                audit->eval_ns_max = elapsed;
+            }
+        }
+        audit->modifier_keys |= modifier;
+    } else {
+        *pressed &= ~bit;
+        audit->modifier_keys &= ~modifier;
+        verdict = foreground_cache_lookup(foreground, NULL);
+    }
+    return verdict;
+}
+
+/**
+ * @brief 키 분류 이름을 반환합니다.
+ */
+const char* shadow_key_class_name(shadow_key_class key_class) {
+    static const char* names[SHADOW_KEY_CLASS_COUNT] = {
+        "alpha", "digit", "func", "nav", "edit", "punct", "numpad", "modifiers", "other"
+    };
+    return ((unsigned int)key_class < SHADOW_KEY_CLASS_COUNT) ? names[key_class] : "unknown";
+}
+
+/**
+ * @brief 판정 번호의 이름을 반환합니다.
+ */
+const char* shadow_verdict_name(int verdict) {
+    switch (verdict) {
+    case FOREGROUND_UNKNOWN:  return "unknown";
+    case FOREGROUND_BLOCKED:  return "blocked";
+    case FOREGROUND_ALLOWED:  return "allowed";
+    case SHADOW_VERDICT_NONE: return "none";
+    default:                  return "invalid";
+    }
+}
+
+/**
+ * @brief CSV 필드 하나를 씁니다. (쉼표나 따옴표가 있으면 따옴표로 감쌈)
+ */
+static void write_csv_field(FILE* out, const char* text) {
+    if (strpbrk(text, ",\"\n") == NULL) {
+        fputs(text, out);
+        return;
+    }
+    fputc('"', out);
+    for (const char* p = text; *p != '\0'; p++) {
+        if (*p == '"') {
+            fputc('"', out);
+        }
+        fputc(*p, out);
+    }
+    fputc('"', out);
+}
+
+/**
+ * @brief 프로세스 항목 하나의 0이 아닌 카운터를 씁니다.
+ */
+static void write_process(const shadow_process* entry, FILE* out) {
+    for (int key_class = 0; key_class < SHADOW_KEY_CLASS_COUNT; key_class++) {
+        for (int active = 0; active < SHADOW_VERDICT_NONE; active++) {
+            for (int candidate = 0; candidate < SHADOW_VERDICTS; candidate++) {
+                uint32_t count = kp_atomic_load_relaxed(&entry->counts[key_class][active][candidate]);
+                if (count == 0) {
+                    continue;
+                }
+                write_csv_field(out, entry->name);
+                fprintf(out, ",%s,%s,%s,%lu\n", shadow_key_class_name((shadow_key_class)key_class),
+                        shadow_verdict_name(active), shadow_verdict_name(candidate), (unsigned long)count);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 0이 아닌 카운터를 CSV로 씁니다. (어느 스레드에서든 호출 가능)
+ */
+int shadow_audit_write_report(const shadow_audit* audit, FILE* out) {
+    unsigned long key_downs = kp_atomic_load_relaxed(&audit->key_downs);
+    uint64_t total = kp_atomic_load_relaxed(&audit->eval_ns_total);
+    fprintf(out, "# shadow_audit key_downs=%lu repeats=%lu disagreements=%lu processes=%lu "
+                 "eval_avg_ns=%llu eval_max_ns=%llu\n",
+            key_downs, kp_atomic_load_relaxed(&audit->repeats),
+            kp_atomic_load_relaxed(&audit->disagreements), kp_atomic_load_relaxed(&audit->processes_used),
+            (unsigned long long)((key_downs != 0) ? total / key_downs : 0),
+            (unsigned long long)kp_atomic_load_relaxed(&audit->eval_ns_max));
+    fprintf(out, "process,key_class,active,candidate,count\n");
+    for (int i = 0; i < SHADOW_AUDIT_PROCESSES; i++) {
+        if (kp_atomic_load(&audit->processes[i].used)) {
+            write_process(&audit->processes[i], out);
+        }
+    }
+    write_process(&audit->unknown, out);
+    write_process(&audit->overflow, out);
+    return ferror(out) ? 0 : 1;
+}
+
+/**
+ * @brief [Shadow] 경로 값을 현재 설정 파일 기준 경로로 바꿉니다.
+ */
+int shadow_audit_resolve_path(const char* config_path, const char* value, const char* default_name,
+                              char* path, size_t size) {
+    const char* name = (value != NULL && value[0] != '\0') ? value : default_name;
+    size_t directory = 0;
+    if (!(name[0] == '\\' || name[0] == '/' || (name[0] != '\0' && name[1] == ':')) && config_path != NULL) {
+        for (size_t i = 0; config_path[i] != '\0'; i++) {
+            if (config_path[i] == '\\' || config_path[i] == '/') {
+                directory = i + 1;
+            }
+        }
+    }
+    int written = snprintf(path, size, "%.*s%s", (int)directory, (directory > 0) ? config_path : "", name);
+    if (written < 0 || (size_t)written >= size) {
+        if (size > 0) {
+            path[0] = '\0';
+        }
+        return 0;
+    }
+    return 1;
+}
@@ -0,0 +1,72 @@
+#include "spsc_ring.h"
+#include "kp_atomic.h"
+
+#include <string.h>
+
+/**
+ * @brief 링 버퍼를 초기화합니다.
+ * @param ring 초기화할 링 버퍼
+ * @param storage capacity * element_size 바이트 이상의 저장 공간
+ * @param element_size 레코드 크기
+ * @param capacity 레코드 개수 (2의 거듭제곱)
+ * @return int 성공 시 1, 용량이 2의 거듭제곱이 아니면 0
+ */
+int spsc_ring_init(spsc_ring* ring, void* storage, size_t element_size, unsigned long capacity) {
+    memset(ring, 0, sizeof(*ring));
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0 || element_size == 0) {
+        return 0;
+    }
+    ring->storage = (unsigned char*)storage;
+    ring->element_size = element_size;
+    ring->mask = capacity - 1;
+    return 1;
+}
+
+/**
+ * @brief 레코드 하나를 넣습니다. (생산자 전용)
+ * @details 소비자의 head는 공간이 부족해 보일 때만 다시 읽어 캐시 라인 공유를 줄입니다.
+ */
+int spsc_ring_push(spsc_ring* ring, const void* element) {
+    unsigned long tail = ring->tail;
+    if (tail - ring->cached_head > ring->mask) {
+        ring->cached_head = kp_atomic_load(&ring->head);
+        if (tail - ring->cached_head > ring->mask) {
+            return 0;
+        }
+    }
+    memcpy(ring->storage + (tail & ring->mask) * ring->element_size, element, ring->element_size);
+    kp_atomic_store(&ring->tail, tail + 1);
+    return 1;
+}
+
+/**
+ * @brief 레코드 하나를 꺼냅니다. (소비자 전용)
+ */
+int spsc_ring_pop(spsc_ring* ring, void* element) {
+    unsigned long head = ring->head;
+    if (head == ring->cached_tail) {
+        ring->cached_tail = kp_atomic_load(&ring->tail);
+        if (head == ring->cached_tail) {
+            return 0;
+        }
+    }
+    memcpy(element, ring->storage + (head & ring->mask) * ring->element_size, ring->element_size);
+    kp_atomic_store(&ring->head, head + 1);
+    return 1;
+}
+
+/**
+ * @brief 현재 링에 들어 있는 레코드 수의 근사값을 반환합니다.
+ */
+unsigned long spsc_ring_size(const spsc_ring* ring) {
+    unsigned long head = kp_atomic_load(&ring->head);
+    unsigned long tail = kp_atomic_load(&ring->tail);
+    return tail - head;
+}
+
+/**
+ * @brief 링의 전체 용량을 반환합니다.
+ */
+unsigned long spsc_ring_capacity(const spsc_ring* ring) {
+    return ring->mask + 1;
+}
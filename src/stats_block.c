@@ -0,0 +1,133 @@
+#include "stats_block.h"
+#include "kp_atomic.h"
+
+/** @brief 하위 버킷 수 */
+#define LATENCY_SUB_BUCKETS (1U << LATENCY_SUB_BUCKET_BITS)
+
+/**
+ * @brief 값의 최상위 비트 위치를 구합니다. (value > 0)
+ */
+static unsigned int highest_bit(uint64_t value) {
+    return 63U - (unsigned int)__builtin_clzll(value);
+}
+
+/**
+ * @brief 값이 들어가는 버킷 번호를 반환합니다.
+ * @details 16 미만은 값 그대로, 그 이상은 (지수, 최상위 다음 4비트)로 버킷을 정합니다.
+ */
+unsigned int latency_bucket_index(uint64_t value_ns) {
+    if (value_ns < LATENCY_SUB_BUCKETS) {
+        return (unsigned int)value_ns;
+    }
+    unsigned int exponent = highest_bit(value_ns);
+    if (exponent >= LATENCY_MAX_EXPONENT) {
+        return LATENCY_BUCKETS - 1;
+    }
+    unsigned int sub = (unsigned int)(value_ns >> (exponent - LATENCY_SUB_BUCKET_BITS)) & (LATENCY_SUB_BUCKETS - 1);
+    return ((exponent - LATENCY_SUB_BUCKET_BITS + 1) << LATENCY_SUB_BUCKET_BITS) + sub;
+}
+
+/**
+ * @brief 버킷이 나타내는 값 범위의 상한을 반환합니다.
+ */
+uint64_t latency_bucket_upper(unsigned int index) {
+    if (index < LATENCY_SUB_BUCKETS) {
+        return index;
+    }
+    unsigned int exponent = (index >> LATENCY_SUB_BUCKET_BITS) + LATENCY_SUB_BUCKET_BITS - 1;
+    uint64_t sub = index & (LATENCY_SUB_BUCKETS - 1);
+    uint64_t width = 1ULL << (exponent - LATENCY_SUB_BUCKET_BITS);
+    return ((LATENCY_SUB_BUCKETS + sub) << (exponent - LATENCY_SUB_BUCKET_BITS)) + width - 1;
+}
+
+/**
+ * @brief 히스토그램에 값을 기록합니다.
+ * @details 기록하는 스레드가 하나이므로 최대값은 비교 후 저장만 하며, 카운터는 읽는 쪽을 위해 원자적으로 올립니다.
+ */
+void latency_histogram_record(latency_histogram* histogram, uint64_t value_ns) {
+    if (histogram == NULL) {
+        return;
+    }
+    kp_atomic_add_relaxed(&histogram->buckets[latency_bucket_index(value_ns)], 1U);
+    kp_atomic_add_relaxed(&histogram->sum_ns, value_ns);
+    if (value_ns > kp_atomic_load_relaxed(&histogram->max_ns)) {
+        kp_atomic_store_relaxed(&histogram->max_ns, value_ns);
+    }
+    // 개수는 마지막에 올려 읽는 쪽이 버킷 합보다 큰 개수를 보지 않도록 함
+    kp_atomic_fetch_add(&histogram->count, 1ULL);
+}
+
+/**
+ * @brief 히스토그램의 백분위 값을 구합니다.
+ */
+uint64_t latency_histogram_percentile(const latency_histogram* histogram, double quantile) {
+    uint64_t count = kp_atomic_load(&histogram->count);
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t target = (uint64_t)(quantile * (double)count);
+    if (target >= count) {
+        target = count - 1;
+    }
+
+    uint64_t seen = 0;
+    for (unsigned int i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += kp_atomic_load_relaxed(&histogram->buckets[i]);
+        if (seen > target) {
+            uint64_t upper = latency_bucket_upper(i);
+            uint64_t max = kp_atomic_load_relaxed(&histogram->max_ns);
+            return (upper < max) ? upper : max;
+        }
+    }
+    return kp_atomic_load_relaxed(&histogram->max_ns);
+}
+
+/**
+ * @brief 통계 블록을 초기화합니다.
+ */
+void kp_stats_block_init(kp_stats_block* block, uint32_t hook_timeout_ms) {
+    block->version = KP_STATS_VERSION;
+    block->size = (uint32_t)sizeof(kp_stats_block);
+    block->process_id = (uint32_t)kp_process_id();
+    block->hook_timeout_ms = hook_timeout_ms;
+    // 읽는 쪽은 식별 값을 보고 나서 나머지 필드를 읽음
+    kp_atomic_store(&block->magic, (uint32_t)KP_STATS_MAGIC);
+}
+
+/**
+ * @brief 단계 지연을 기록합니다.
+ */
+void kp_stats_record(kp_stats_block* block, kp_stat_stage stage, uint64_t elapsed_ns) {
+    if (block == NULL) {
+        return;
+    }
+    latency_histogram_record(&block->stages[stage], elapsed_ns);
+    if (stage == KP_STAT_HOOK && elapsed_ns * 2 > (uint64_t)block->hook_timeout_ms * 1000000ULL) {
+        kp_atomic_add_relaxed(&block->near_timeout, 1ULL);
+    }
+}
+
+/**
+ * @brief 판정 카운터를 올립니다.
+ */
+void kp_stats_count_verdict(kp_stats_block* block, kp_stat_verdict verdict) {
+    if (block == NULL) {
+        return;
+    }
+    kp_atomic_add_relaxed(&block->verdicts[verdict], 1ULL);
+}
+
+/**
+ * @brief 단계 이름을 반환합니다.
+ */
+const char* kp_stat_stage_name(kp_stat_stage stage) {
+    switch (stage) {
+    case KP_STAT_HOOK:    return "hook";
+    case KP_STAT_QUEUE:   return "queue";
+    case KP_STAT_RESOLVE: return "resolve";
+    case KP_STAT_CRYPTO:  return "crypto";
+    case KP_STAT_INJECT:  return "inject";
+    case KP_STAT_EVENT:   return "event";
+    default:              return "unknown";
+    }
+}
@@ -0,0 +1,282 @@
+#include "win32_backend.h"
+#include "kp_platform.h"
+#include "kp_atomic.h"
+
+#include <string.h>
+#include <psapi.h>
+#include <shlwapi.h>
+
+/**
+ * @brief 이 프로그램이 SendInput으로 주입한 키에 붙이는 세션 서명 (dwExtraInfo)
+ * @details 시작할 때 난수로 정하며, 후크는 이 값으로 자신이 주입한 키를 O(1)에 식별합니다.
+ */
+ULONG_PTR g_injectionSignature = 0;
+
+/**
+ * @brief 후크 생존 확인 탐침 키의 서명
+ */
+ULONG_PTR g_probeSignature = 0;
+
+/**
+ * @brief 가벼운 포그라운드 조회 여부 (감시 스레드가 쓰고 작업 스레드가 읽음)
+ */
+static LONG g_lightweightForeground = 0;
+
+/**
+ * @brief 세션 서명을 생성합니다.
+ * @details 0은 일반 SendInput과 구분되지 않으므로 피합니다.
+ */
+void Win32InitInjectionSignature(void) {
+    if (!kp_random_bytes(&g_injectionSignature, sizeof(g_injectionSignature))) {
+        g_injectionSignature = (ULONG_PTR)(GetTickCount() ^ (GetCurrentProcessId() << 16));
+    }
+    if (g_injectionSignature == 0) {
+        g_injectionSignature = 1;
+    }
+    // 탐침은 자체 주입 빠른 경로를 타지 않도록 다른 값을 사용
+    g_probeSignature = ~g_injectionSignature;
+}
+
+/**
+ * @brief 프로세스 ID로 실행 파일 이름을 가져옵니다.
+ * @param processId 조회할 프로세스 ID
+ * @param processName 버퍼에 저장될 프로세스 이름 (최대 MAX_PATH)
+ * @param bufferSize 버퍼 크기
+ * @return BOOL 성공 시 TRUE, 실패 시 FALSE
+ */
+static BOOL GetProcessNameById(DWORD processId, char* processName, DWORD bufferSize) {
+    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processId);
+    if (hProcess == NULL) {
+        return FALSE;
+    }
+    
+    BOOL result = FALSE;
+    if (GetModuleFileNameExA(hProcess, NULL, processName, bufferSize) > 0) {
+        // 전체 경로에서 파일 이름만 추출
+        char* fileName = PathFindFileNameA(processName);
+        if (fileName != processName) {
+            // 파일 이름을 버퍼의 시작 위치로 이동
+            memmove(processName, fileName, strlen(fileName) + 1);
+        }
+        result = TRUE;
+    }
+    
+    CloseHandle(hProcess);
+    return result;
+}
+
+/**
+ * @brief 현재 포커스된 창의 프로세스 실행 파일 이름을 가져옵니다.
+ * @param processName 버퍼에 저장될 프로세스 이름 (최대 MAX_PATH)
+ * @param bufferSize 버퍼 크기
+ * @return BOOL 성공 시 TRUE, 실패 시 FALSE
+ */
+BOOL GetCurrentProcessName(char* processName, DWORD bufferSize) {
+    HWND hwnd = GetForegroundWindow();
+    if (hwnd == NULL) {
+        return FALSE;
+    }
+    
+    DWORD processId = 0;
+    GetWindowThreadProcessId(hwnd, &processId);
+    if (processId == 0) {
+        return FALSE;
+    }
+    
+    return GetProcessNameById(processId, processName, bufferSize);
+}
+
+/**
+ * @brief 프로세스 생성 시각을 가져옵니다. (PID 재사용 구분용)
+ * @return BOOL 성공 시 TRUE, 실패 시 FALSE
+ */
+static BOOL GetProcessStartTime(DWORD processId, unsigned long long* startTime) {
+    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, processId);
+    if (hProcess == NULL) {
+        return FALSE;
+    }
+    
+    FILETIME creation, exitTime, kernelTime, userTime;
+    BOOL result = GetProcessTimes(hProcess, &creation, &exitTime, &kernelTime, &userTime);
+    if (result) {
+        *startTime = ((unsigned long long)creation.dwHighDateTime << 32) | creation.dwLowDateTime;
+    }
+    CloseHandle(hProcess);
+    return result;
+}
+
+/**
+ * @brief 프로세스 ID로 생성 시각과 실행 파일 이름을 가져옵니다.
+ */
+BOOL Win32QueryProcess(DWORD processId, unsigned long long* startTime, char* processName, DWORD bufferSize) {
+    if (!GetProcessStartTime(processId, startTime)) {
+        return FALSE;
+    }
+    return (processName == NULL) ? TRUE : GetProcessNameById(processId, processName, bufferSize);
+}
+
+/**
+ * @brief 포그라운드 창의 (HWND, PID, 시작 시각)을 조회하는 Win32 공급자 함수
+ * @return int 성공 시 1, 실패 시 0
+ */
+static int Win32GetForeground(void* context, foreground_identity* identity) {
+    (void)context;
+    HWND hwnd = GetForegroundWindow();
+    if (hwnd == NULL) {
+        return 0;
+    }
+    
+    DWORD processId = 0;
+    GetWindowThreadProcessId(hwnd, &processId);
+    if (processId == 0) {
+        return 0;
+    }
+    
+    // 축소 단계에서는 창과 PID가 그대로면 직전 생성 시각을 재사용 (창이 살아 있는 동안 PID는 재사용되지 않음)
+    static HWND lastWindow = NULL;
+    static DWORD lastProcessId = 0;
+    static unsigned long long lastStartTime = 0;
+    if (kp_atomic_load_relaxed(&g_lightweightForeground) && hwnd == lastWindow && processId == lastProcessId) {
+        identity->window = (uintptr_t)hwnd;
+        identity->process_id = processId;
+        identity->start_time = lastStartTime;
+        return 1;
+    }
+    
+    identity->window = (uintptr_t)hwnd;
+    identity->process_id = processId;
+    identity->start_time = 0;
+    
+    // PID 재사용을 구분하기 위해 프로세스 생성 시각을 함께 사용
+    GetProcessStartTime(processId, &identity->start_time);
+    lastWindow = hwnd;
+    lastProcessId = processId;
+    lastStartTime = identity->start_time;
+    return 1;
+}
+
+/**
+ * @brief 식별된 프로세스의 실행 파일 이름을 조회하는 Win32 공급자 함수
+ * @return int 성공 시 1, 실패 시 0
+ */
+static int Win32GetProcessName(void* context, const foreground_identity* identity,
+                               char* name, size_t nameSize) {
+    (void)context;
+    return GetProcessNameById((DWORD)identity->process_id, name, (DWORD)nameSize) ? 1 : 0;
+}
+
+/**
+ * @brief Win32 API 기반 프로세스 조회 공급자
+ */
+const process_lookup_provider g_win32ProcessProvider = {
+    NULL,
+    Win32GetForeground,
+    Win32GetProcessName
+};
+
+/**
+ * @brief 복호화된 키 코드를 SendInput을 사용하여 전달합니다.
+ * @param vkCode 전달할 가상 키 코드
+ * @param isKeyDown 키 다운 이벤트인지 여부 (TRUE: 키 다운, FALSE: 키 업)
+ * @return BOOL 성공 시 TRUE, 실패 시 FALSE
+ */
+BOOL SendDecryptedKey(DWORD vkCode, BOOL isKeyDown) {
+    INPUT input = {0};
+    input.type = INPUT_KEYBOARD;
+    input.ki.wVk = (WORD)vkCode;
+    input.ki.dwFlags = isKeyDown ? 0 : KEYEVENTF_KEYUP;
+    input.ki.time = 0;
+    // 후크가 자신이 주입한 키를 식별할 수 있도록 세션 서명을 붙임
+    input.ki.dwExtraInfo = g_injectionSignature;
+    
+    UINT result = SendInput(1, &input, sizeof(INPUT));
+    return (result == 1);
+}
+
+/**
+ * @brief 주입 묶음을 SendInput 한 번으로 주입합니다.
+ * @details SendInput은 배열의 입력을 다른 입력과 섞지 않고 연속으로 넣으며, 모든 키에 세션 서명을 붙입니다.
+ */
+static size_t Win32SendInputBatch(void* context, const inject_key* keys, size_t count) {
+    (void)context;
+    INPUT inputs[INJECT_BATCH_CAPACITY];
+    if (count > INJECT_BATCH_CAPACITY) {
+        count = INJECT_BATCH_CAPACITY;
+    }
+    ZeroMemory(inputs, count * sizeof(INPUT));
+    for (size_t i = 0; i < count; i++) {
+        INPUT* input = &inputs[i];
+        input->type = INPUT_KEYBOARD;
+        if (keys[i].flags & INJECT_KEY_UNICODE) {
+            input->ki.wScan = keys[i].unicode;
+            input->ki.dwFlags = KEYEVENTF_UNICODE;
+        } else {
+            input->ki.wVk = keys[i].vk_code;
+        }
+        if (keys[i].flags & INJECT_KEY_UP) {
+            input->ki.dwFlags |= KEYEVENTF_KEYUP;
+        }
+        input->ki.dwExtraInfo = g_injectionSignature;
+    }
+    return (size_t)SendInput((UINT)count, inputs, sizeof(INPUT));
+}
+
+/**
+ * @brief 가상 키 코드를 포그라운드 창의 자판 배열 문자로 바꿉니다.
+ * @details 조합 키 상태 대신 Shift와 Caps Lock만 반영하며, Caps Lock은 아직 주입하지 않은 키까지 따라간
+ *          묶음의 상태를 씁니다. (GetKeyState는 묶음 앞쪽의 Caps Lock 키가 주입되기 전 상태를 돌려줌)
+ *          커널의 데드 키 상태를 바꾸지 않도록 ToUnicodeEx에 0x4 플래그를 넘깁니다. (Windows 10 1607 이상, 이전 버전에서는 무시됨)
+ *          데드 키나 제어 문자는 0을 반환하여 가상 키 코드로 주입되게 합니다.
+ */
+static unsigned int Win32TranslateKey(void* context, unsigned int vkCode, int shift, int capsLock) {
+    (void)context;
+    BYTE state[256] = {0};
+    WCHAR buffer[4];
+    HKL layout = GetKeyboardLayout(GetWindowThreadProcessId(GetForegroundWindow(), NULL));
+    if (shift) {
+        state[VK_SHIFT] = 0x80;
+    }
+    if (capsLock) {
+        state[VK_CAPITAL] = 0x01;
+    }
+    UINT scanCode = MapVirtualKeyExA(vkCode, 0, layout);  // MAPVK_VK_TO_VSC
+    int length = ToUnicodeEx(vkCode, scanCode, state, buffer, 4, 0x4, layout);
+    return (length == 1 && buffer[0] >= 0x20 && buffer[0] != 0x7F) ? (unsigned int)buffer[0] : 0;
+}
+
+/**
+ * @brief SendInput 기반 주입 묶음 출력
+ */
+const inject_sink g_win32InjectSink = {
+    NULL,
+    Win32SendInputBatch,
+    Win32TranslateKey
+};
+
+/**
+ * @brief 후크가 받을 탐침 키를 주입합니다.
+ * @details 후크는 탐침 서명을 보고 심장 박동만 기록한 뒤 차단하므로 애플리케이션에는 전달되지 않습니다.
+ */
+BOOL Win32SendHookProbe(void) {
+    INPUT input = {0};
+    input.type = INPUT_KEYBOARD;
+    input.ki.wVk = HOOK_PROBE_VK;
+    input.ki.dwFlags = KEYEVENTF_KEYUP;
+    input.ki.dwExtraInfo = g_probeSignature;
+    return SendInput(1, &input, sizeof(INPUT)) == 1;
+}
+
+/**
+ * @brief 포그라운드 조회를 가볍게 할지 정합니다.
+ */
+void Win32SetLightweightForeground(BOOL enabled) {
+    kp_atomic_store_relaxed(&g_lightweightForeground, enabled ? 1 : 0);
+}
+
+/**
+ * @brief 처리 코어의 키 주입 함수 (SendInput)
+ */
+int Win32InjectKey(void* context, unsigned int vkCode, int keyDown) {
+    (void)context;
+    return SendDecryptedKey(vkCode, keyDown ? TRUE : FALSE) ? 1 : 0;
+}
@@ -0,0 +1,63 @@
+#ifndef KP_TEST_H
+#define KP_TEST_H
+
+#include <stddef.h>
+
+/**
+ * @file kp_test.h
+ * @brief 코어 단위 테스트 러너 공용 선언
+ * @details 테스트 파일마다 kp_test_case 표 하나를 KP_TEST_SUITE로 내보내고, test_main.c의 스위트 목록에 추가합니다.
+ *          검사가 실패해도 테스트를 멈추지 않고 실패 위치를 모두 출력한 뒤 다음 테스트로 넘어갑니다.
+ */
+
+/**
+ * @brief 테스트 하나
+ */
+typedef struct kp_test_case {
+    const char* name;       /**< 테스트 이름 */
+    void (*run)(void);      /**< 테스트 함수 */
+} kp_test_case;
+
+/**
+ * @brief 테스트 파일 하나의 테스트 모음
+ */
+typedef struct kp_test_suite {
+    const char* name;             /**< 스위트 이름 (모듈 이름) */
+    const kp_test_case* cases;    /**< 테스트 목록 */
+    size_t count;                 /**< 테스트 수 */
+} kp_test_suite;
+
+/** @brief 테스트 표를 스위트로 내보냅니다. (test_main.c에서 kp_suite_<이름>으로 참조) */
+#define KP_TEST_SUITE(suite_name, table) \
+    const kp_test_suite kp_suite_##suite_name = { #suite_name, table, sizeof(table) / sizeof(table[0]) }
+
+/**
+ * @brief 검사 실패를 기록합니다.
+ */
+void kp_test_fail(const char* file, int line, const char* expression);
+
+/**
+ * @brief 두 정수 값이 다른 검사 실패를 기록합니다.
+ */
+void kp_test_fail_values(const char* file, int line, const char* expression,
+                         unsigned long long actual, unsigned long long expected);
+
+/** @brief 조건이 참인지 검사합니다. */
+#define KP_CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            kp_test_fail(__FILE__, __LINE__, #condition); \
+        } \
+    } while (0)
+
+/** @brief 두 정수 값이 같은지 검사합니다. (실패하면 두 값을 함께 출력) */
+#define KP_CHECK_EQ(actual, expected) \
+    do { \
+        unsigned long long kp_actual_ = (unsigned long long)(actual); \
+        unsigned long long kp_expected_ = (unsigned long long)(expected); \
+        if (kp_actual_ != kp_expected_) { \
+            kp_test_fail_values(__FILE__, __LINE__, #actual " == " #expected, kp_actual_, kp_expected_); \
+        } \
+    } while (0)
+
+#endif // KP_TEST_H
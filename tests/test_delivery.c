@@ -0,0 +1,170 @@
+/**
+ * @file test_delivery.c
+ * @brief 공유 메모리 키 전달 링의 암호화 왕복, 가득 찬 링, 깨우기, 닫기 테스트
+ * @details 플랫폼 독립 빌드에서는 링이 POSIX 공유 메모리에 놓이므로, 같은 프로세스 안에서
+ *          생산자 채널과 소비자 클라이언트를 따로 매핑하여 실제 배치를 검사합니다.
+ */
+#include "kp_test.h"
+#include "key_delivery.h"
+#include "key_processor.h"
+#include "kp_atomic.h"
+
+#include <string.h>
+
+static key_delivery_channel g_channel;
+static key_delivery_client g_client;
+static key_delivery_key g_keys[KEY_DELIVERY_CAPACITY];
+
+/**
+ * @brief 자기 자신을 소비자로 채널을 열고 클라이언트를 붙입니다.
+ */
+static int open_pair(void) {
+    key_delivery_grant grant;
+    memset(&g_channel, 0, sizeof(g_channel));
+    memset(&g_client, 0, sizeof(g_client));
+    if (!key_delivery_channel_open(&g_channel, kp_process_id(), &grant)) {
+        return 0;
+    }
+    if (!key_delivery_client_attach(&g_client, &grant)) {
+        key_delivery_channel_close(&g_channel);
+        return 0;
+    }
+    return 1;
+}
+
+static void close_pair(void) {
+    key_delivery_client_close(&g_client);
+    key_delivery_channel_close(&g_channel);
+}
+
+static void test_round_trip_across_mappings(void) {
+    KP_CHECK(open_pair());
+    if (g_client.ring == NULL) {
+        return;
+    }
+    // 생산자와 소비자는 같은 공유 메모리를 서로 다른 주소로 매핑
+    KP_CHECK((void*)g_client.ring != (void*)g_channel.ring);
+    KP_CHECK_EQ(g_client.ring->magic, KEY_DELIVERY_MAGIC);
+    KP_CHECK_EQ(g_client.ring->consumer_pid, kp_process_id());
+
+    // 블록 경계(16워드)를 여러 번 넘도록 넣음
+    for (uint32_t i = 0; i < 100; i++) {
+        KP_CHECK(key_delivery_push(&g_channel, 0x41 + i % 26, (i & 1) ? KEY_MESSAGE_KEYUP : KEY_MESSAGE_KEYDOWN, i));
+    }
+    // 링에는 평문 키 코드가 없어야 함
+    unsigned long plain = 0;
+    for (uint32_t i = 0; i < 100; i++) {
+        if (g_client.ring->records[i].encrypted == 0x41 + i % 26) {
+            plain++;
+        }
+    }
+    KP_CHECK(plain < 3);
+
+    size_t count = key_delivery_client_read(&g_client, g_keys, KEY_DELIVERY_CAPACITY, 0);
+    KP_CHECK_EQ(count, 100);
+    unsigned long wrong = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (g_keys[i].vk_code != 0x41 + i % 26 || g_keys[i].time_ms != i ||
+            g_keys[i].message != ((i & 1) ? KEY_MESSAGE_KEYUP : KEY_MESSAGE_KEYDOWN)) {
+            wrong++;
+        }
+    }
+    KP_CHECK_EQ(wrong, 0);
+    KP_CHECK_EQ(g_channel.delivered, 100);
+    KP_CHECK_EQ(key_delivery_client_read(&g_client, g_keys, KEY_DELIVERY_CAPACITY, 0), 0);
+    close_pair();
+}
+
+static void test_full_ring_drops_without_blocking(void) {
+    KP_CHECK(open_pair());
+    if (g_client.ring == NULL) {
+        return;
+    }
+    for (uint32_t i = 0; i < KEY_DELIVERY_CAPACITY; i++) {
+        KP_CHECK(key_delivery_push(&g_channel, i & 0xFF, KEY_MESSAGE_KEYDOWN, i));
+    }
+    KP_CHECK(!key_delivery_push(&g_channel, 0x42, KEY_MESSAGE_KEYDOWN, 0));
+    KP_CHECK(!key_delivery_push(&g_channel, 0x43, KEY_MESSAGE_KEYDOWN, 0));
+    KP_CHECK_EQ(g_channel.ring->dropped, 2);
+
+    // 일부만 읽으면 그만큼 다시 넣을 수 있고, 순서는 이어짐
+    KP_CHECK_EQ(key_delivery_client_read(&g_client, g_keys, 10, 0), 10);
+    KP_CHECK_EQ(g_keys[9].time_ms, 9);
+    for (uint32_t i = 0; i < 10; i++) {
+        KP_CHECK(key_delivery_push(&g_channel, 0x50, KEY_MESSAGE_KEYUP, KEY_DELIVERY_CAPACITY + i));
+    }
+    KP_CHECK(!key_delivery_push(&g_channel, 0x50, KEY_MESSAGE_KEYUP, 0));
+    size_t count = key_delivery_client_read(&g_client, g_keys, KEY_DELIVERY_CAPACITY, 0);
+    KP_CHECK_EQ(count, KEY_DELIVERY_CAPACITY);
+    KP_CHECK_EQ(g_keys[0].time_ms, 10);
+    KP_CHECK_EQ(g_keys[count - 1].time_ms, KEY_DELIVERY_CAPACITY + 9);
+    KP_CHECK_EQ(g_keys[count - 1].vk_code, 0x50);
+    close_pair();
+}
+
+/**
+ * @brief 소비자 스레드: 빈 링에서 기다렸다가 깨어나 읽은 키 수를 기록합니다.
+ */
+static void consumer_thread(void* arg) {
+    size_t* count = (size_t*)arg;
+    *count = key_delivery_client_read(&g_client, g_keys, KEY_DELIVERY_CAPACITY, 5000);
+}
+
+static void test_sleeping_consumer_is_woken(void) {
+    KP_CHECK(open_pair());
+    if (g_client.ring == NULL) {
+        return;
+    }
+    size_t count = 0;
+    kp_thread thread;
+    KP_CHECK(kp_thread_start(&thread, consumer_thread, &count));
+    // 소비자가 waiting을 세우고 잠들 때까지 대기
+    for (int i = 0; i < 1000 && !kp_atomic_load(&g_client.ring->waiting); i++) {
+        kp_sleep_ms(1);
+    }
+    KP_CHECK(kp_atomic_load(&g_client.ring->waiting));
+    // waiting을 세운 뒤 head를 다시 확인하고 실제로 잠들 시간
+    kp_sleep_ms(20);
+
+    unsigned long long started = kp_now_ns();
+    KP_CHECK(key_delivery_push(&g_channel, 0x41, KEY_MESSAGE_KEYDOWN, 1));
+    kp_thread_join(&thread);
+    KP_CHECK_EQ(count, 1);
+    KP_CHECK_EQ(g_keys[0].vk_code, 0x41);
+    // 제한 시간까지 기다리지 않고 신호로 깨어남
+    KP_CHECK(kp_now_ns() - started < 2000000000ULL);
+    KP_CHECK_EQ(g_channel.ring->wakeups, 1);
+    KP_CHECK_EQ(g_client.waits, 1);
+
+    // 깨어 있는 소비자에게는 신호를 보내지 않음
+    KP_CHECK(key_delivery_push(&g_channel, 0x42, KEY_MESSAGE_KEYDOWN, 2));
+    KP_CHECK_EQ(g_channel.ring->wakeups, 1);
+    close_pair();
+}
+
+static void test_close_is_visible_to_client(void) {
+    KP_CHECK(open_pair());
+    if (g_client.ring == NULL) {
+        return;
+    }
+    KP_CHECK(!key_delivery_client_closed(&g_client));
+    KP_CHECK(key_delivery_push(&g_channel, 0x41, KEY_MESSAGE_KEYDOWN, 1));
+    key_delivery_channel_close(&g_channel);
+    KP_CHECK(key_delivery_client_closed(&g_client));
+    // 닫힌 채널에는 더 넣지 않지만 이미 넣은 키는 읽을 수 있고, 닫힌 링에서는 기다리지 않음
+    KP_CHECK(!key_delivery_push(&g_channel, 0x42, KEY_MESSAGE_KEYDOWN, 2));
+    KP_CHECK_EQ(key_delivery_client_read(&g_client, g_keys, KEY_DELIVERY_CAPACITY, 0), 1);
+    KP_CHECK_EQ(g_keys[0].vk_code, 0x41);
+    KP_CHECK_EQ(key_delivery_client_read(&g_client, g_keys, KEY_DELIVERY_CAPACITY, 5000), 0);
+    KP_CHECK_EQ(g_client.waits, 0);
+    key_delivery_client_close(&g_client);
+}
+
+static const kp_test_case g_cases[] = {
+    { "round_trip_across_mappings", test_round_trip_across_mappings },
+    { "full_ring_drops_without_blocking", test_full_ring_drops_without_blocking },
+    { "sleeping_consumer_is_woken", test_sleeping_consumer_is_woken },
+    { "close_is_visible_to_client", test_close_is_visible_to_client }
+};
+
+KP_TEST_SUITE(delivery, g_cases);
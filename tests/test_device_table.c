@@ -0,0 +1,194 @@
+/**
+ * @file test_device_table.c
+ * @brief 장치 규칙 분류, 장치 테이블 등록/조회/제거(뒤 항목 당기기), 버스트 판정 테스트
+ */
+#include "kp_test.h"
+#include "device_table.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/** @brief 테이블을 채우는 장치 수 (군집이 생기도록 용량의 3/4) */
+#define DEVICE_TEST_FILL (DEVICE_TABLE_CAPACITY * 3 / 4)
+
+static device_table g_table;
+static device_rules g_rules;
+
+/**
+ * @brief 테스트용 장치 핸들 (Win32 핸들처럼 4의 배수)
+ */
+static uintptr_t test_handle(int i) {
+    return (uintptr_t)(0x1000 + i * 4);
+}
+
+/**
+ * @brief 제거하지 않은 장치는 모두 찾고, 제거한 장치는 찾지 않는지 확인합니다.
+ * @return unsigned long 어긋난 장치 수
+ */
+static unsigned long check_lookups(const int* removed) {
+    unsigned long wrong = 0;
+    for (int i = 0; i < DEVICE_TEST_FILL; i++) {
+        device_entry* entry = device_table_find(&g_table, test_handle(i));
+        if (removed[i] ? (entry != NULL) : (entry == NULL || entry->handle != test_handle(i))) {
+            wrong++;
+        }
+    }
+    return wrong;
+}
+
+static void test_class_names(void) {
+    KP_CHECK_EQ(device_class_parse("normal"), DEVICE_CLASS_NORMAL);
+    KP_CHECK_EQ(device_class_parse("Trusted"), DEVICE_CLASS_TRUSTED);
+    KP_CHECK_EQ(device_class_parse("UNTRUSTED"), DEVICE_CLASS_UNTRUSTED);
+    KP_CHECK_EQ(device_class_parse("trust"), -1);
+    KP_CHECK_EQ(device_class_parse(""), -1);
+    KP_CHECK(strcmp(device_class_name(DEVICE_CLASS_TRUSTED), "trusted") == 0);
+    KP_CHECK(strcmp(device_class_name(7), "?") == 0);
+}
+
+static void test_rules_classify(void) {
+    device_rules_init(&g_rules);
+    KP_CHECK_EQ(device_rules_classify(&g_rules, "\\\\?\\HID#VID_046D"), DEVICE_CLASS_NORMAL);
+    KP_CHECK(!device_rules_has_untrusted(&g_rules));
+
+    KP_CHECK(device_rules_add(&g_rules, "vid_05e0&pid_1200", DEVICE_CLASS_TRUSTED));
+    KP_CHECK(device_rules_add(&g_rules, "VID_05E0", DEVICE_CLASS_UNTRUSTED));
+    KP_CHECK(device_rules_has_untrusted(&g_rules));
+    // 대소문자 무시, 먼저 적은 규칙 우선
+    KP_CHECK_EQ(device_rules_classify(&g_rules, "\\\\?\\HID#VID_05E0&PID_1200#7"), DEVICE_CLASS_TRUSTED);
+    KP_CHECK_EQ(device_rules_classify(&g_rules, "\\\\?\\HID#VID_05E0&PID_9999#7"), DEVICE_CLASS_UNTRUSTED);
+    // 규칙에 없거나 이름이 없으면 Default
+    g_rules.default_class = DEVICE_CLASS_TRUSTED;
+    KP_CHECK_EQ(device_rules_classify(&g_rules, "\\\\?\\HID#VID_046D"), DEVICE_CLASS_TRUSTED);
+    KP_CHECK_EQ(device_rules_classify(&g_rules, NULL), DEVICE_CLASS_TRUSTED);
+    KP_CHECK_EQ(device_rules_classify(NULL, "VID_05E0"), DEVICE_CLASS_NORMAL);
+
+    // Default만 untrusted여도 차단할 장치가 있는 규칙
+    device_rules_init(&g_rules);
+    g_rules.default_class = DEVICE_CLASS_UNTRUSTED;
+    KP_CHECK(device_rules_has_untrusted(&g_rules));
+
+    // 가득 차면 추가하지 않음
+    device_rules_init(&g_rules);
+    for (int i = 0; i < DEVICE_MAX_RULES; i++) {
+        KP_CHECK(device_rules_add(&g_rules, "VID", DEVICE_CLASS_NORMAL));
+    }
+    KP_CHECK(!device_rules_add(&g_rules, "VID", DEVICE_CLASS_UNTRUSTED));
+    KP_CHECK(!device_rules_has_untrusted(&g_rules));
+}
+
+static void test_insert_find_and_reclassify(void) {
+    device_rules_init(&g_rules);
+    device_rules_add(&g_rules, "SCANNER", DEVICE_CLASS_TRUSTED);
+    device_table_init(&g_table);
+
+    device_entry* scanner = device_table_insert(&g_table, test_handle(1), "HID#scanner#1", &g_rules);
+    device_entry* keyboard = device_table_insert(&g_table, test_handle(2), NULL, &g_rules);
+    KP_CHECK(scanner != NULL && keyboard != NULL);
+    if (scanner == NULL || keyboard == NULL) {
+        return;
+    }
+    KP_CHECK_EQ(scanner->device_class, DEVICE_CLASS_TRUSTED);
+    KP_CHECK_EQ(keyboard->device_class, DEVICE_CLASS_NORMAL);
+    KP_CHECK(device_table_insert(&g_table, test_handle(1), "other", &g_rules) == scanner);
+    KP_CHECK_EQ(g_table.count, 2);
+    KP_CHECK(device_table_find(&g_table, test_handle(1)) == scanner);
+    KP_CHECK(device_table_find(&g_table, test_handle(3)) == NULL);
+
+    // 규칙이 바뀌면 이름 없는 장치는 새 Default로, 이름 있는 장치는 새 규칙으로
+    device_rules_init(&g_rules);
+    device_rules_add(&g_rules, "scanner", DEVICE_CLASS_UNTRUSTED);
+    g_rules.default_class = DEVICE_CLASS_TRUSTED;
+    KP_CHECK_EQ(device_table_classify(&g_table, &g_rules), 2);
+    KP_CHECK_EQ(scanner->device_class, DEVICE_CLASS_UNTRUSTED);
+    KP_CHECK_EQ(keyboard->device_class, DEVICE_CLASS_TRUSTED);
+    KP_CHECK_EQ(device_table_classify(&g_table, &g_rules), 0);
+}
+
+static void test_full_table(void) {
+    device_table_init(&g_table);
+    for (int i = 0; i < DEVICE_TABLE_CAPACITY; i++) {
+        KP_CHECK(device_table_insert(&g_table, test_handle(i), NULL, NULL) != NULL);
+    }
+    KP_CHECK_EQ(g_table.count, DEVICE_TABLE_CAPACITY);
+    KP_CHECK(device_table_insert(&g_table, test_handle(DEVICE_TABLE_CAPACITY), NULL, NULL) == NULL);
+    // 가득 찬 테이블에서도 없는 장치 조회는 끝남
+    KP_CHECK(device_table_find(&g_table, test_handle(DEVICE_TABLE_CAPACITY)) == NULL);
+    KP_CHECK(device_table_find(&g_table, test_handle(DEVICE_TABLE_CAPACITY - 1)) != NULL);
+}
+
+static void test_remove_shifts_followers(void) {
+    device_table_init(&g_table);
+    int removed[DEVICE_TEST_FILL];
+    memset(removed, 0, sizeof(removed));
+    for (int i = 0; i < DEVICE_TEST_FILL; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "keyboard-%d", i);
+        KP_CHECK(device_table_insert(&g_table, test_handle(i), name, NULL) != NULL);
+    }
+
+    // 군집 중간의 항목을 지워도 뒤따르는 항목을 모두 찾아야 함 (묘비 없음)
+    unsigned long wrong = 0;
+    for (int step = 0; step < DEVICE_TEST_FILL; step++) {
+        int i = (step * 7) % DEVICE_TEST_FILL;
+        KP_CHECK(device_table_remove(&g_table, test_handle(i)));
+        removed[i] = 1;
+        KP_CHECK(!device_table_remove(&g_table, test_handle(i)));
+        wrong += check_lookups(removed);
+        // 옮겨진 항목은 이름과 카운터를 그대로 가짐
+        for (int j = 0; j < DEVICE_TEST_FILL; j++) {
+            device_entry* entry = removed[j] ? NULL : device_table_find(&g_table, test_handle(j));
+            char name[32];
+            snprintf(name, sizeof(name), "keyboard-%d", j);
+            if (entry != NULL && strcmp(entry->name, name) != 0) {
+                wrong++;
+            }
+        }
+    }
+    KP_CHECK_EQ(wrong, 0);
+    KP_CHECK_EQ(g_table.count, 0);
+
+    // 모두 지운 뒤에는 빈 자리 하나만 보고 끝남
+    unsigned long probes = g_table.probes;
+    for (int i = 0; i < DEVICE_TEST_FILL; i++) {
+        KP_CHECK(device_table_find(&g_table, test_handle(i)) == NULL);
+    }
+    KP_CHECK_EQ(g_table.probes - probes, DEVICE_TEST_FILL);
+}
+
+static void test_burst_detection(void) {
+    device_entry entry;
+    memset(&entry, 0, sizeof(entry));
+    unsigned long long now = 1000000000ULL;
+    int started = 0;
+    for (int i = 0; i < DEVICE_BURST_MIN_KEYS - 1; i++) {
+        started += device_entry_key(&entry, now);
+        now += DEVICE_BURST_GAP_NS;
+    }
+    KP_CHECK_EQ(started, 0);
+    // MIN_KEYS번째 연속 키에서 한 번만 시작
+    KP_CHECK_EQ(device_entry_key(&entry, now), 1);
+    now += 1000000ULL;
+    KP_CHECK_EQ(device_entry_key(&entry, now), 0);
+    KP_CHECK_EQ(entry.bursts, 1);
+    KP_CHECK_EQ(entry.longest_burst, DEVICE_BURST_MIN_KEYS + 1);
+
+    // 간격이 길면 끊기고, 시계가 거꾸로 가도 이어지지 않음
+    now += DEVICE_BURST_GAP_NS + 1;
+    KP_CHECK_EQ(device_entry_key(&entry, now), 0);
+    KP_CHECK_EQ(entry.run, 1);
+    KP_CHECK_EQ(device_entry_key(&entry, now - 1), 0);
+    KP_CHECK_EQ(entry.run, 1);
+    KP_CHECK_EQ(entry.keys, DEVICE_BURST_MIN_KEYS + 3);
+}
+
+static const kp_test_case g_cases[] = {
+    { "class_names", test_class_names },
+    { "rules_classify", test_rules_classify },
+    { "insert_find_and_reclassify", test_insert_find_and_reclassify },
+    { "full_table", test_full_table },
+    { "remove_shifts_followers", test_remove_shifts_followers },
+    { "burst_detection", test_burst_detection }
+};
+
+KP_TEST_SUITE(device_table, g_cases);
@@ -0,0 +1,219 @@
+/**
+ * @file test_foreground_cache.c
+ * @brief 포그라운드 판정 캐시의 무효화, 세대 처리, 알림 없는 확인 모드 테스트 (각본대로 답하는 가짜 공급자)
+ */
+#include "kp_test.h"
+#include "foreground_cache.h"
+
+#include <string.h>
+
+/**
+ * @brief 가짜 공급자 각본: 현재 포그라운드와 호출 횟수
+ */
+typedef struct scripted_provider {
+    foreground_identity identity;  /**< 현재 포그라운드 식별 정보 */
+    const char* name;              /**< 현재 프로세스 이름 */
+    int foreground_ok;             /**< get_foreground 성공 여부 */
+    int name_ok;                   /**< get_process_name 성공 여부 */
+    unsigned long foreground_calls; /**< get_foreground 호출 수 */
+    unsigned long name_calls;      /**< get_process_name 호출 수 */
+    unsigned long verdict_calls;   /**< 판정 콜백 호출 수 */
+    int allow_value;               /**< 허용 프로세스에 돌려줄 판정 값 */
+} scripted_provider;
+
+static scripted_provider g_script;
+
+static int scripted_get_foreground(void* context, foreground_identity* identity) {
+    scripted_provider* script = (scripted_provider*)context;
+    script->foreground_calls++;
+    if (!script->foreground_ok) {
+        return 0;
+    }
+    *identity = script->identity;
+    return 1;
+}
+
+static int scripted_get_process_name(void* context, const foreground_identity* identity,
+                                     char* name, size_t name_size) {
+    scripted_provider* script = (scripted_provider*)context;
+    (void)identity;
+    script->name_calls++;
+    if (!script->name_ok) {
+        return 0;
+    }
+    strncpy(name, script->name, name_size - 1);
+    name[name_size - 1] = '\0';
+    return 1;
+}
+
+static int scripted_verdict(const char* process_name, void* user) {
+    scripted_provider* script = (scripted_provider*)user;
+    script->verdict_calls++;
+    return (strcmp(process_name, "code.exe") == 0) ? script->allow_value : 0;
+}
+
+static const process_lookup_provider g_provider = { &g_script, scripted_get_foreground, scripted_get_process_name };
+
+static foreground_cache g_cache;
+
+/**
+ * @brief 각본을 한 프로세스로 정하고 캐시를 초기화합니다.
+ */
+static void setup(uintptr_t window, unsigned long pid, const char* name) {
+    memset(&g_script, 0, sizeof(g_script));
+    g_script.identity.window = window;
+    g_script.identity.process_id = pid;
+    g_script.identity.start_time = 1000 + pid;
+    g_script.name = name;
+    g_script.foreground_ok = 1;
+    g_script.name_ok = 1;
+    g_script.allow_value = 1;
+    foreground_cache_init(&g_cache, &g_provider, scripted_verdict, &g_script);
+}
+
+static void test_hit_after_first_lookup(void) {
+    setup(0x10, 100, "code.exe");
+    const char* name = NULL;
+    KP_CHECK_EQ(foreground_cache_lookup(&g_cache, &name), FOREGROUND_ALLOWED);
+    KP_CHECK(name != NULL && strcmp(name, "code.exe") == 0);
+    for (int i = 0; i < 10; i++) {
+        KP_CHECK_EQ(foreground_cache_lookup(&g_cache, NULL), FOREGROUND_ALLOWED);
+    }
+    // 무효화가 없는 동안에는 공급자를 다시 부르지 않음
+    KP_CHECK_EQ(g_script.foreground_calls, 1);
+    KP_CHECK_EQ(g_script.name_calls, 1);
+    KP_CHECK_EQ(g_cache.lookups, 1);
+    KP_CHECK_EQ(g_cache.hits, 10);
+}
+
+static void test_invalidate_same_process_revalidates(void) {
+    setup(0x10, 100, "code.exe");
+    foreground_cache_lookup(&g_cache, NULL);
+    // 같은 창으로 돌아온 포그라운드 알림: 이름은 다시 조회하지 않고 판정만 다시 함
+    foreground_cache_invalidate(&g_cache);
+    KP_CHECK_EQ(foreground_cache_lookup(&g_cache, NULL), FOREGROUND_ALLOWED);
+    KP_CHECK_EQ(g_script.foreground_calls, 2);
+    KP_CHECK_EQ(g_script.name_calls, 1);
+    KP_CHECK_EQ(g_script.verdict_calls, 2);
+    KP_CHECK_EQ(g_cache.revalidations, 1);
+}
+
+static void test_invalidate_new_process_looks_up(void) {
+    setup(0x10, 100, "code.exe");
+    KP_CHECK_EQ(foreground_cache_lookup(&g_cache, NULL), FOREGROUND_ALLOWED);
+    g_script.identity.window = 0x20;
+    g_script.identity.process_id = 200;
+    g_script.name = "malware.exe";
+    // 알림 전에는 캐시된 판정을 그대로 사용
+    KP_CHECK_EQ(foreground_cache_lookup(&g_cache, NULL), FOREGROUND_ALLOWED);
+    foreground_cache_invalidate(&g_cache);
+    const char* name = NULL;
+    KP_CHECK_EQ(foreground_cache_lookup(&g_cache, &name), FOREGROUND_BLOCKED);
+    KP_CHECK(name != NULL && strcmp(name, "malware.exe") == 0);
+    KP_CHECK_EQ(g_cache.lookups, 2);
+    KP_CHECK_EQ(g_cache.identity.process_id, 200);
+}
+
+static void test_pid_reuse_detected_by_start_time(void) {
+    setup(0x10, 100, "code.exe");
+    foreground_cache_lookup(&g_cache, NULL);
+    // 같은 창 핸들과 PID이지만 다른 시작 시각: 다른 프로세스로 보고 이름을 다시 조회
+    g_script.identity.start_time += 1;
+    g_script.name = "other.exe";
+    foreground_cache_invalidate(&g_cache);
+    KP_CHECK_EQ(foreground_cache_lookup(&g_cache, NULL), FOREGROUND_BLOCKED);
+    KP_CHECK_EQ(g_script.name_calls, 2);
+    KP_CHECK_EQ(g_cache.revalidations, 0);
+}
+
+static void test_failure_not_cached(void) {
+    setup(0x10, 100, "code.exe");
+    g_script.foreground_ok = 0;
+    KP_CHECK_EQ(foreground_cache_lookup(&g_cache, NULL), FOREGROUND_UNKNOWN);
+    KP_CHECK_EQ(foreground_cache_lookup(&g_cache, NULL), FOREGROUND_UNKNOWN);
+    KP_CHECK_EQ(g_script.foreground_calls, 2);
+    KP_CHECK_EQ(g_cache.failures, 2);
+
+    // 이름 조회 실패도 캐시하지 않으며, 이전에 캐시된 판정을 버림
+    g_script.foreground_ok = 1;
+    KP_CHECK_EQ(foreground_cache_lookup(&g_cache, NULL), FOREGROUND_ALLOWED);
+    g_script.identity.process_id = 300;
+    g_script.name_ok = 0;
+    foreground_cache_invalidate(&g_cache);
+    KP_CHECK_EQ(foreground_cache_lookup(&g_cache, NULL), FOREGROUND_UNKNOWN);
+    KP_CHECK(!g_cache.valid);
+    g_script.name_ok = 1;
+    KP_CHECK_EQ(foreground_cache_lookup(&g_cache, NULL), FOREGROUND_ALLOWED);
+    KP_CHECK_EQ(g_cache.failures, 3);
+}
+
+static void test_verdict_value_kept(void) {
+    // 판정 콜백 값(키 규칙 번호 + 1)이 캐시에 그대로 남음
+    setup(0x10, 100, "code.exe");
+    g_script.allow_value = 5;
+    KP_CHECK_EQ(foreground_cache_lookup(&g_cache, NULL), FOREGROUND_ALLOWED);
+    KP_CHECK_EQ(g_cache.allowed, 5);
+    // 정책 변경으로 무효화하면 같은 프로세스라도 새 판정 값을 사용
+    g_script.allow_value = 2;
+    foreground_cache_invalidate(&g_cache);
+    foreground_cache_lookup(&g_cache, NULL);
+    KP_CHECK_EQ(g_cache.allowed, 2);
+}
+
+static void test_verify_mode_detects_window_change(void) {
+    setup(0x10, 100, "code.exe");
+    foreground_cache_set_verify(&g_cache, 1);
+    KP_CHECK_EQ(foreground_cache_lookup(&g_cache, NULL), FOREGROUND_ALLOWED);
+    // 같은 창이면 포그라운드만 확인하고 이름은 다시 조회하지 않음
+    KP_CHECK_EQ(foreground_cache_lookup(&g_cache, NULL), FOREGROUND_ALLOWED);
+    KP_CHECK_EQ(g_script.foreground_calls, 2);
+    KP_CHECK_EQ(g_script.name_calls, 1);
+    KP_CHECK_EQ(g_cache.hits, 1);
+
+    // 알림(무효화) 없이 다른 창으로 바뀌어도 캐시된 허용 판정을 쓰지 않음
+    unsigned long generation = g_cache.generation;
+    g_script.identity.window = 0x20;
+    g_script.identity.process_id = 200;
+    g_script.name = "malware.exe";
+    const char* name = NULL;
+    KP_CHECK_EQ(foreground_cache_lookup(&g_cache, &name), FOREGROUND_BLOCKED);
+    KP_CHECK(name != NULL && strcmp(name, "malware.exe") == 0);
+    KP_CHECK_EQ(g_cache.verify_changes, 1);
+    KP_CHECK(g_cache.generation != generation);
+
+    // 세대만 비교하는 경로(자동 반복)도 foreground_cache_verify로 변경을 알 수 있음
+    g_script.identity.window = 0x10;
+    g_script.identity.process_id = 100;
+    g_script.name = "code.exe";
+    generation = g_cache.generation;
+    KP_CHECK_EQ(foreground_cache_verify(&g_cache), 1);
+    KP_CHECK(g_cache.generation != generation);
+    KP_CHECK_EQ(foreground_cache_lookup(&g_cache, NULL), FOREGROUND_ALLOWED);
+    KP_CHECK_EQ(foreground_cache_verify(&g_cache), 0);
+
+    // 확인 중 조회에 실패하면 캐시된 판정을 버림
+    g_script.foreground_ok = 0;
+    KP_CHECK_EQ(foreground_cache_lookup(&g_cache, NULL), FOREGROUND_UNKNOWN);
+}
+
+static void test_without_verify_generation_decides(void) {
+    // 알림이 있는 기본 모드: 확인 함수는 공급자를 부르지 않음
+    setup(0x10, 100, "code.exe");
+    foreground_cache_lookup(&g_cache, NULL);
+    g_script.identity.window = 0x20;
+    KP_CHECK_EQ(foreground_cache_verify(&g_cache), 0);
+    KP_CHECK_EQ(g_script.foreground_calls, 1);
+}
+
+static const kp_test_case g_cases[] = {
+    { "hit_after_first_lookup", test_hit_after_first_lookup },
+    { "invalidate_same_process_revalidates", test_invalidate_same_process_revalidates },
+    { "invalidate_new_process_looks_up", test_invalidate_new_process_looks_up },
+    { "pid_reuse_detected_by_start_time", test_pid_reuse_detected_by_start_time },
+    { "failure_not_cached", test_failure_not_cached },
+    { "verdict_value_kept", test_verdict_value_kept },
+    { "verify_mode_detects_window_change", test_verify_mode_detects_window_change },
+    { "without_verify_generation_decides", test_without_verify_generation_decides }
+};
+
+KP_TEST_SUITE(foreground_cache, g_cases);
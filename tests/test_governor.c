@@ -0,0 +1,229 @@
+/**
+ * @file test_governor.c
+ * @brief 후크 지연 예산 관리자의 단계 내리기/복구, 탐침, 재설치 판정 테스트 (가상 시계)
+ * @details hook_governor_tick()은 시각을 인자로만 받으므로, 테스트가 밀리초 단위 가상 시계를 직접 넘깁니다.
+ */
+#include "kp_test.h"
+#include "hook_governor.h"
+
+#include <string.h>
+
+/** @brief 가상 시계 밀리초 → 나노초 */
+#define MS(value) ((uint64_t)(value) * 1000000ULL)
+
+/** @brief 테스트에 쓰는 후크 제한 시간 (밀리초) */
+#define GOVERNOR_TEST_TIMEOUT_MS 300
+
+/** @brief 테스트에 쓰는 지연 예산 (마이크로초) */
+#define GOVERNOR_TEST_BUDGET_US 1000
+
+static hook_governor g_governor;
+
+/** @brief 가상 시계 (나노초) */
+static uint64_t g_now;
+
+static void setup(void) {
+    hook_governor_config config;
+    hook_governor_default_config(&config, GOVERNOR_TEST_TIMEOUT_MS, GOVERNOR_TEST_BUDGET_US);
+    g_now = MS(1000);
+    hook_governor_init(&g_governor, &config, g_now);
+}
+
+/**
+ * @brief 가상 시계를 진행하고 구간 하나를 마감합니다. 후크는 방금 호출된 것으로 둡니다.
+ */
+static hook_governor_action tick_alive(uint64_t advance_ns) {
+    g_now += advance_ns;
+    hook_governor_heartbeat(&g_governor, g_now);
+    return hook_governor_tick(&g_governor, g_now, g_now);
+}
+
+static void test_default_config(void) {
+    hook_governor_config config;
+    hook_governor_default_config(&config, 300, 0);
+    KP_CHECK_EQ(config.budget_ns, (uint64_t)HOOK_GOVERNOR_DEFAULT_BUDGET_US * 1000ULL);
+    KP_CHECK_EQ(config.timeout_ns, MS(300));
+    KP_CHECK_EQ(config.stall_ns, MS(HOOK_GOVERNOR_STALL_MS));
+    KP_CHECK_EQ(config.recover_windows, HOOK_GOVERNOR_RECOVER_WINDOWS);
+}
+
+static void test_over_budget_degrades_one_level(void) {
+    setup();
+    KP_CHECK_EQ(hook_governor_level(&g_governor), HOOK_LEVEL_NORMAL);
+
+    // 예산 안의 표본만 있으면 그대로
+    hook_governor_sample(&g_governor, 900000);
+    KP_CHECK_EQ(tick_alive(MS(100)), HOOK_ACTION_NONE);
+    KP_CHECK_EQ(hook_governor_level(&g_governor), HOOK_LEVEL_NORMAL);
+    KP_CHECK_EQ(g_governor.last_window_max_ns, 900000);
+
+    // 예산을 넘은 구간마다 한 단계씩
+    hook_governor_sample(&g_governor, 1500000);
+    hook_governor_sample(&g_governor, 1200000);
+    tick_alive(MS(100));
+    KP_CHECK_EQ(hook_governor_level(&g_governor), HOOK_LEVEL_QUIET_LOG);
+    KP_CHECK_EQ(g_governor.over_budget, 2);
+    KP_CHECK_EQ(g_governor.degradations, 1);
+
+    hook_governor_sample(&g_governor, 1500000);
+    tick_alive(MS(100));
+    KP_CHECK_EQ(hook_governor_level(&g_governor), HOOK_LEVEL_LIGHT_LOOKUP);
+
+    // 가장 낮은 단계에서는 더 내려가지 않음
+    hook_governor_sample(&g_governor, 1500000);
+    tick_alive(MS(100));
+    KP_CHECK_EQ(hook_governor_level(&g_governor), HOOK_LEVEL_LIGHT_LOOKUP);
+    KP_CHECK_EQ(g_governor.degradations, 2);
+    KP_CHECK_EQ(g_governor.over_budget, 4);
+}
+
+static void test_timeout_risk_drops_to_lowest(void) {
+    setup();
+    // 후크 제한 시간의 절반(150ms)을 넘으면 한 번에 가장 낮은 단계로
+    hook_governor_sample(&g_governor, MS(151));
+    tick_alive(MS(100));
+    KP_CHECK_EQ(hook_governor_level(&g_governor), HOOK_LEVEL_LIGHT_LOOKUP);
+    KP_CHECK_EQ(g_governor.timeout_risks, 1);
+    KP_CHECK_EQ(g_governor.degradations, 1);
+}
+
+static void test_recovers_after_calm_windows(void) {
+    setup();
+    hook_governor_sample(&g_governor, MS(200));
+    tick_alive(MS(100));
+    KP_CHECK_EQ(hook_governor_level(&g_governor), HOOK_LEVEL_LIGHT_LOOKUP);
+
+    // 예산 절반 이하 구간이 recover_windows번 이어져야 한 단계 복구 (입력 없는 구간도 안정 구간)
+    for (unsigned int i = 0; i + 1 < HOOK_GOVERNOR_RECOVER_WINDOWS; i++) {
+        hook_governor_sample(&g_governor, 400000);
+        tick_alive(MS(100));
+    }
+    KP_CHECK_EQ(hook_governor_level(&g_governor), HOOK_LEVEL_LIGHT_LOOKUP);
+    tick_alive(MS(100));
+    KP_CHECK_EQ(hook_governor_level(&g_governor), HOOK_LEVEL_QUIET_LOG);
+    KP_CHECK_EQ(g_governor.recoveries, 1);
+
+    // 예산 절반과 예산 사이 구간은 안정 구간 수를 되돌림
+    for (unsigned int i = 0; i + 1 < HOOK_GOVERNOR_RECOVER_WINDOWS; i++) {
+        tick_alive(MS(100));
+    }
+    hook_governor_sample(&g_governor, 700000);
+    tick_alive(MS(100));
+    KP_CHECK_EQ(g_governor.calm_windows, 0);
+    KP_CHECK_EQ(hook_governor_level(&g_governor), HOOK_LEVEL_QUIET_LOG);
+
+    for (unsigned int i = 0; i < HOOK_GOVERNOR_RECOVER_WINDOWS; i++) {
+        tick_alive(MS(100));
+    }
+    KP_CHECK_EQ(hook_governor_level(&g_governor), HOOK_LEVEL_NORMAL);
+    KP_CHECK_EQ(g_governor.recoveries, 2);
+}
+
+static void test_budget_change_applies_to_next_samples(void) {
+    setup();
+    hook_governor_set_budget(&g_governor, 5000000);
+    hook_governor_sample(&g_governor, 1500000);
+    tick_alive(MS(100));
+    KP_CHECK_EQ(hook_governor_level(&g_governor), HOOK_LEVEL_NORMAL);
+    KP_CHECK_EQ(g_governor.over_budget, 0);
+}
+
+static void test_stall_probe_answered(void) {
+    setup();
+    uint64_t heartbeat = g_now;
+
+    // 후크 호출 뒤 입력이 있었지만 유예 시간(1초)이 안 지났으면 기다림
+    uint64_t input = heartbeat + MS(10);
+    g_now = input + MS(999);
+    KP_CHECK_EQ(hook_governor_tick(&g_governor, g_now, input), HOOK_ACTION_NONE);
+
+    g_now = input + MS(1000);
+    KP_CHECK_EQ(hook_governor_tick(&g_governor, g_now, input), HOOK_ACTION_PROBE);
+    KP_CHECK_EQ(g_governor.probes, 1);
+    KP_CHECK(g_governor.probing);
+
+    // 탐침 응답을 기다리는 동안에는 다시 탐침하지 않음
+    g_now += MS(100);
+    KP_CHECK_EQ(hook_governor_tick(&g_governor, g_now, input), HOOK_ACTION_NONE);
+
+    // 탐침이 후크에 도착하면 살아 있는 것으로 보고 감시를 끝냄
+    hook_governor_heartbeat(&g_governor, g_now);
+    g_now += MS(100);
+    KP_CHECK_EQ(hook_governor_tick(&g_governor, g_now, input), HOOK_ACTION_NONE);
+    KP_CHECK(!g_governor.probing);
+    KP_CHECK_EQ(g_governor.reinstalls, 0);
+}
+
+static void test_unanswered_probe_reinstalls(void) {
+    setup();
+    uint64_t input = g_now + MS(5);
+    g_now = input + MS(HOOK_GOVERNOR_STALL_MS);
+    KP_CHECK_EQ(hook_governor_tick(&g_governor, g_now, input), HOOK_ACTION_PROBE);
+    uint64_t probe_sent = g_now;
+
+    g_now = probe_sent + MS(HOOK_GOVERNOR_PROBE_TIMEOUT_MS - 1);
+    KP_CHECK_EQ(hook_governor_tick(&g_governor, g_now, input), HOOK_ACTION_NONE);
+    g_now = probe_sent + MS(HOOK_GOVERNOR_PROBE_TIMEOUT_MS);
+    KP_CHECK_EQ(hook_governor_tick(&g_governor, g_now, input), HOOK_ACTION_REINSTALL);
+    KP_CHECK_EQ(g_governor.reinstalls, 1);
+    KP_CHECK(!g_governor.probing);
+
+    // 재설치 뒤에는 그 전의 입력으로 다시 탐침하지 않음
+    hook_governor_reinstalled(&g_governor, g_now);
+    g_now += MS(HOOK_GOVERNOR_PROBE_INTERVAL_MS * 2);
+    KP_CHECK_EQ(hook_governor_tick(&g_governor, g_now, input), HOOK_ACTION_NONE);
+}
+
+static void test_probe_interval_limits_probes(void) {
+    setup();
+    // 마우스 입력만 계속되는 경우: 탐침은 응답되지만 입력은 후크에 오지 않음
+    uint64_t input = g_now + MS(1);
+    g_now = input + MS(HOOK_GOVERNOR_STALL_MS);
+    KP_CHECK_EQ(hook_governor_tick(&g_governor, g_now, input), HOOK_ACTION_PROBE);
+    uint64_t probe_sent = g_now;
+    hook_governor_heartbeat(&g_governor, probe_sent);
+    g_now += MS(100);
+    KP_CHECK_EQ(hook_governor_tick(&g_governor, g_now, input), HOOK_ACTION_NONE);
+
+    unsigned long probes = 0;
+    for (int i = 0; i < 49; i++) {
+        g_now += MS(100);
+        input = g_now - MS(HOOK_GOVERNOR_STALL_MS);
+        hook_governor_action action = hook_governor_tick(&g_governor, g_now, input);
+        if (action == HOOK_ACTION_PROBE) {
+            probes++;
+            hook_governor_heartbeat(&g_governor, g_now);
+        }
+    }
+    // 첫 탐침 뒤 5초 안에는 다시 탐침하지 않고, 5초가 지나면 한 번
+    KP_CHECK_EQ(probes, 1);
+    KP_CHECK_EQ(g_governor.probes, 2);
+    KP_CHECK(g_governor.probe_sent_ns - probe_sent >= MS(HOOK_GOVERNOR_PROBE_INTERVAL_MS));
+}
+
+static void test_no_input_no_probe(void) {
+    setup();
+    // 입력이 없거나 후크가 입력 뒤에 호출되었다면 아무리 오래 지나도 탐침하지 않음
+    g_now += MS(60000);
+    KP_CHECK_EQ(hook_governor_tick(&g_governor, g_now, 0), HOOK_ACTION_NONE);
+    uint64_t input = g_now;
+    hook_governor_heartbeat(&g_governor, input + MS(1));
+    g_now += MS(60000);
+    KP_CHECK_EQ(hook_governor_tick(&g_governor, g_now, input), HOOK_ACTION_NONE);
+    KP_CHECK_EQ(g_governor.probes, 0);
+    KP_CHECK(strcmp(hook_governor_level_name(HOOK_LEVEL_LIGHT_LOOKUP), "light_lookup") == 0);
+}
+
+static const kp_test_case g_cases[] = {
+    { "default_config", test_default_config },
+    { "over_budget_degrades_one_level", test_over_budget_degrades_one_level },
+    { "timeout_risk_drops_to_lowest", test_timeout_risk_drops_to_lowest },
+    { "recovers_after_calm_windows", test_recovers_after_calm_windows },
+    { "budget_change_applies_to_next_samples", test_budget_change_applies_to_next_samples },
+    { "stall_probe_answered", test_stall_probe_answered },
+    { "unanswered_probe_reinstalls", test_unanswered_probe_reinstalls },
+    { "probe_interval_limits_probes", test_probe_interval_limits_probes },
+    { "no_input_no_probe", test_no_input_no_probe }
+};
+
+KP_TEST_SUITE(governor, g_cases);
@@ -0,0 +1,218 @@
+/**
+ * @file test_ini_parser.c
+ * @brief 단일 패스 INI 파서의 섹션/키/값 슬라이스, 주석, 잘못된 줄 번호 테스트
+ */
+#include "kp_test.h"
+#include "ini_parser.h"
+
+#include <string.h>
+
+/** @brief 테스트가 모아 두는 최대 항목/오류 수 */
+#define INI_TEST_MAX 16
+
+/**
+ * @brief 콜백이 받은 항목과 오류를 모아 두는 상태
+ */
+typedef struct ini_capture {
+    char section[INI_TEST_MAX][32]; /**< 항목의 섹션 이름 */
+    char key[INI_TEST_MAX][64];     /**< 키 이름 */
+    char value[INI_TEST_MAX][64];   /**< 값 */
+    int line[INI_TEST_MAX];         /**< 항목의 줄 번호 */
+    int entries;                    /**< 받은 항목 수 */
+    int error_line[INI_TEST_MAX];   /**< 잘못된 줄 번호 */
+    int errors;                     /**< 받은 오류 수 */
+    int stop_after;                 /**< 이만큼 받으면 파싱 중단 (0이면 끝까지) */
+} ini_capture;
+
+static int capture_entry(void* user, const ini_entry* entry) {
+    ini_capture* capture = (ini_capture*)user;
+    if (capture->entries < INI_TEST_MAX) {
+        int i = capture->entries;
+        ini_slice_copy(entry->section, capture->section[i], sizeof(capture->section[i]));
+        ini_slice_copy(entry->key, capture->key[i], sizeof(capture->key[i]));
+        ini_slice_copy(entry->value, capture->value[i], sizeof(capture->value[i]));
+        capture->line[i] = entry->line;
+    }
+    capture->entries++;
+    return capture->stop_after == 0 || capture->entries < capture->stop_after;
+}
+
+static void capture_error(void* user, int line, const char* message) {
+    ini_capture* capture = (ini_capture*)user;
+    (void)message;
+    if (capture->errors < INI_TEST_MAX) {
+        capture->error_line[capture->errors] = line;
+    }
+    capture->errors++;
+}
+
+/**
+ * @brief 문자열을 파싱하고 ini_parse의 반환 값을 돌려줍니다.
+ */
+static int parse(const char* text, ini_capture* capture) {
+    ini_handler handler;
+    handler.entry = capture_entry;
+    handler.error = capture_error;
+    handler.user = capture;
+    return ini_parse(text, strlen(text), &handler);
+}
+
+static void test_sections_and_entries(void) {
+    ini_capture capture;
+    memset(&capture, 0, sizeof(capture));
+    const char* text =
+        "Top=before\n"
+        "[AllowedProcesses]\n"
+        "Process1=notepad.exe\n"
+        "[ KeyPolicy ]\n"
+        "  ExitKey  =  f12  \n"
+        "[AllowedProcesses]\n"
+        "Process2=code.exe\n";
+    KP_CHECK_EQ(parse(text, &capture), 0);
+    KP_CHECK_EQ(capture.entries, 4);
+
+    // 첫 섹션 헤더 전의 항목은 빈 섹션
+    KP_CHECK(strcmp(capture.section[0], "") == 0);
+    KP_CHECK(strcmp(capture.key[0], "Top") == 0);
+    KP_CHECK(strcmp(capture.section[1], "AllowedProcesses") == 0);
+    KP_CHECK(strcmp(capture.value[1], "notepad.exe") == 0);
+    // 섹션 이름과 키/값의 앞뒤 공백 제거
+    KP_CHECK(strcmp(capture.section[2], "KeyPolicy") == 0);
+    KP_CHECK(strcmp(capture.key[2], "ExitKey") == 0);
+    KP_CHECK(strcmp(capture.value[2], "f12") == 0);
+    // 같은 섹션이 다시 나와도 그대로 이어서 보고
+    KP_CHECK(strcmp(capture.section[3], "AllowedProcesses") == 0);
+    KP_CHECK(strcmp(capture.value[3], "code.exe") == 0);
+    KP_CHECK_EQ(capture.line[3], 7);
+}
+
+static void test_comments_and_blank_lines(void) {
+    ini_capture capture;
+    memset(&capture, 0, sizeof(capture));
+    const char* text =
+        "; 세미콜론 주석\n"
+        "# 샵 주석\n"
+        "\n"
+        "   \t\n"
+        "[Section]\n"
+        "   ; 들여쓴 주석 = 항목 아님\n"
+        "Key=value ; 줄 끝은 값의 일부\n";
+    KP_CHECK_EQ(parse(text, &capture), 0);
+    KP_CHECK_EQ(capture.entries, 1);
+    KP_CHECK(strcmp(capture.key[0], "Key") == 0);
+    KP_CHECK(strcmp(capture.value[0], "value ; 줄 끝은 값의 일부") == 0);
+    KP_CHECK_EQ(capture.line[0], 7);
+}
+
+static void test_arbitrary_key_names(void) {
+    ini_capture capture;
+    memset(&capture, 0, sizeof(capture));
+    const char* text =
+        "[KeyRules]\n"
+        "my editor.exe=ctrl+c\n"
+        "C:\\Tools\\app.exe=none\n"
+        "키 이름=값\n"
+        "a[1]=x=y\n"
+        "Quoted=\"  spaced value  \"\n"
+        "Half=\"open\n"
+        "Empty=\n";
+    KP_CHECK_EQ(parse(text, &capture), 0);
+    KP_CHECK_EQ(capture.entries, 7);
+    KP_CHECK(strcmp(capture.key[0], "my editor.exe") == 0);
+    KP_CHECK(strcmp(capture.key[1], "C:\\Tools\\app.exe") == 0);
+    KP_CHECK(strcmp(capture.key[2], "키 이름") == 0);
+    // 첫 '='에서만 나눔
+    KP_CHECK(strcmp(capture.key[3], "a[1]") == 0);
+    KP_CHECK(strcmp(capture.value[3], "x=y") == 0);
+    // 값을 감싼 큰따옴표만 제거하고 안쪽 공백은 유지
+    KP_CHECK(strcmp(capture.value[4], "  spaced value  ") == 0);
+    KP_CHECK(strcmp(capture.value[5], "\"open") == 0);
+    KP_CHECK(strcmp(capture.value[6], "") == 0);
+}
+
+static void test_error_line_numbers(void) {
+    ini_capture capture;
+    memset(&capture, 0, sizeof(capture));
+    const char* text =
+        "[Good]\n"
+        "A=1\n"
+        "[Broken\n"
+        "no equals sign\n"
+        "\n"
+        "=value\n"
+        "B=2\n";
+    // 잘못된 줄은 건너뛰고 나머지는 계속 파싱
+    KP_CHECK_EQ(parse(text, &capture), 3);
+    KP_CHECK_EQ(capture.errors, 3);
+    KP_CHECK_EQ(capture.error_line[0], 3);
+    KP_CHECK_EQ(capture.error_line[1], 4);
+    KP_CHECK_EQ(capture.error_line[2], 6);
+    KP_CHECK_EQ(capture.entries, 2);
+    // 닫히지 않은 섹션 헤더는 현재 섹션을 바꾸지 않음
+    KP_CHECK(strcmp(capture.section[1], "Good") == 0);
+    KP_CHECK_EQ(capture.line[1], 7);
+
+    // 오류 콜백이 없어도 개수는 반환
+    ini_handler handler;
+    handler.entry = capture_entry;
+    handler.error = NULL;
+    handler.user = &capture;
+    KP_CHECK_EQ(ini_parse(text, strlen(text), &handler), 3);
+}
+
+static void test_bom_crlf_and_unterminated_buffer(void) {
+    ini_capture capture;
+    memset(&capture, 0, sizeof(capture));
+    const char* text = "\xEF\xBB\xBF[S]\r\nKey=value\r\n\r\nbad\r\nLast=end";
+    KP_CHECK_EQ(parse(text, &capture), 1);
+    KP_CHECK_EQ(capture.error_line[0], 4);
+    KP_CHECK_EQ(capture.entries, 2);
+    KP_CHECK(strcmp(capture.section[0], "S") == 0);
+    KP_CHECK(strcmp(capture.value[0], "value") == 0);
+    KP_CHECK(strcmp(capture.value[1], "end") == 0);
+    KP_CHECK_EQ(capture.line[1], 5);
+
+    // NUL 종료 없이 길이만큼만 읽음 ("Key=val"까지)
+    memset(&capture, 0, sizeof(capture));
+    ini_handler handler;
+    handler.entry = capture_entry;
+    handler.error = capture_error;
+    handler.user = &capture;
+    KP_CHECK_EQ(ini_parse("Key=value", 7, &handler), 0);
+    KP_CHECK(strcmp(capture.value[0], "val") == 0);
+}
+
+static void test_entry_callback_stops(void) {
+    ini_capture capture;
+    memset(&capture, 0, sizeof(capture));
+    capture.stop_after = 2;
+    KP_CHECK_EQ(parse("A=1\nB=2\nC=3\n", &capture), -1);
+    KP_CHECK_EQ(capture.entries, 2);
+}
+
+static void test_slice_helpers(void) {
+    ini_slice slice;
+    slice.ptr = "ExitKey=f12";
+    slice.len = 7;
+    KP_CHECK(ini_slice_equals(slice, "exitkey"));
+    KP_CHECK(ini_slice_equals(slice, "EXITKEY"));
+    KP_CHECK(!ini_slice_equals(slice, "ExitKe"));
+    KP_CHECK(!ini_slice_equals(slice, "ExitKeys"));
+
+    char buffer[5];
+    KP_CHECK_EQ(ini_slice_copy(slice, buffer, sizeof(buffer)), 4);
+    KP_CHECK(strcmp(buffer, "Exit") == 0);
+    KP_CHECK_EQ(ini_slice_copy(slice, buffer, 0), 0);
+}
+
+static const kp_test_case g_cases[] = {
+    { "sections_and_entries", test_sections_and_entries },
+    { "comments_and_blank_lines", test_comments_and_blank_lines },
+    { "arbitrary_key_names", test_arbitrary_key_names },
+    { "error_line_numbers", test_error_line_numbers },
+    { "bom_crlf_and_unterminated_buffer", test_bom_crlf_and_unterminated_buffer },
+    { "entry_callback_stops", test_entry_callback_stops },
+    { "slice_helpers", test_slice_helpers }
+};
+
+KP_TEST_SUITE(ini_parser, g_cases);
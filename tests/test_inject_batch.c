@@ -0,0 +1,230 @@
+/**
+ * @file test_inject_batch.c
+ * @brief 키 주입 묶음의 크기/기한/포그라운드/유휴 내보내기, 부분 주입 재시도, 유니코드 경로와 Caps Lock 추적 테스트
+ * @details 기록용 가짜 출력으로 SendInput 대신 내보낸 키와 호출 수를 확인합니다.
+ */
+#include "kp_test.h"
+#include "inject_batch.h"
+
+#include <string.h>
+
+/** @brief 기록할 수 있는 주입 키 수 */
+#define INJECT_TEST_MAX_KEYS 256
+
+/** @brief 왼쪽 Shift 가상 키 코드 */
+#define TEST_VK_LSHIFT 0xA0
+
+/** @brief 왼쪽 Ctrl 가상 키 코드 */
+#define TEST_VK_LCONTROL 0xA2
+
+/**
+ * @brief 가짜 출력 상태
+ */
+typedef struct fake_sink_state {
+    inject_key keys[INJECT_TEST_MAX_KEYS]; /**< 주입한 키 (순서대로) */
+    size_t count;                  /**< 주입한 키 수 */
+    unsigned long sends;           /**< 출력 함수 호출 수 */
+    size_t accept_limit;           /**< 호출 한 번에 받아들이는 최대 키 수 (0이면 제한 없음) */
+    unsigned long translates;      /**< 문자 변환 호출 수 */
+    int last_caps_lock;            /**< 마지막 문자 변환에 넘어온 Caps Lock 상태 */
+} fake_sink_state;
+
+static fake_sink_state g_fake;
+static inject_batch g_batch;
+
+static size_t fake_send(void* context, const inject_key* keys, size_t count) {
+    fake_sink_state* fake = (fake_sink_state*)context;
+    fake->sends++;
+    if (fake->accept_limit != 0 && count > fake->accept_limit) {
+        count = fake->accept_limit;
+    }
+    for (size_t i = 0; i < count && fake->count < INJECT_TEST_MAX_KEYS; i++) {
+        fake->keys[fake->count++] = keys[i];
+    }
+    return count;
+}
+
+/**
+ * @brief 가짜 문자 변환 (글자 키만, Shift와 Caps Lock 중 하나만 켜져 있으면 대문자)
+ */
+static unsigned int fake_translate(void* context, unsigned int vk_code, int shift, int caps_lock) {
+    fake_sink_state* fake = (fake_sink_state*)context;
+    fake->translates++;
+    fake->last_caps_lock = caps_lock;
+    if (vk_code >= 'A' && vk_code <= 'Z') {
+        return (shift != caps_lock) ? vk_code : vk_code + ('a' - 'A');
+    }
+    return 0;
+}
+
+static const inject_sink g_sink = { &g_fake, fake_send, fake_translate };
+
+static void setup(size_t limit, unsigned long long max_delay_ns, int unicode) {
+    memset(&g_fake, 0, sizeof(g_fake));
+    inject_batch_init(&g_batch, &g_sink, limit, max_delay_ns);
+    inject_batch_configure(&g_batch, limit, max_delay_ns, unicode);
+}
+
+/**
+ * @brief 키 다운과 키 업을 같은 대상, 같은 시각으로 넣습니다.
+ */
+static void tap(unsigned int vk_code, unsigned long long now_ns) {
+    inject_batch_add(&g_batch, vk_code, 1, 1, now_ns);
+    inject_batch_add(&g_batch, vk_code, 0, 1, now_ns);
+}
+
+static void test_defaults_and_clamp(void) {
+    setup(0, 0, 0);
+    KP_CHECK_EQ(g_batch.limit, INJECT_BATCH_DEFAULT_LIMIT);
+    KP_CHECK_EQ(g_batch.max_delay_ns, INJECT_BATCH_DEFAULT_DELAY_NS);
+    setup(INJECT_BATCH_CAPACITY + 100, 5000, 0);
+    KP_CHECK_EQ(g_batch.limit, INJECT_BATCH_CAPACITY);
+    KP_CHECK_EQ(g_batch.max_delay_ns, 5000);
+    KP_CHECK(strcmp(inject_flush_reason_name(INJECT_FLUSH_FOREGROUND), "foreground") == 0);
+    KP_CHECK(strcmp(inject_flush_reason_name(INJECT_FLUSH_REASON_COUNT), "?") == 0);
+}
+
+static void test_size_flush_keeps_order(void) {
+    setup(8, 1000000000ULL, 0);
+    for (unsigned int i = 0; i < 10; i++) {
+        inject_batch_add(&g_batch, 'A' + i, (i & 1) == 0, 1, 0);
+    }
+    // 8개가 모이면 한 번에 내보내고, 남은 2개는 유휴 때
+    KP_CHECK_EQ(g_fake.sends, 1);
+    KP_CHECK_EQ(g_fake.count, 8);
+    KP_CHECK_EQ(g_batch.count, 2);
+    KP_CHECK_EQ(inject_batch_flush(&g_batch, INJECT_FLUSH_IDLE), 2);
+    KP_CHECK_EQ(inject_batch_flush(&g_batch, INJECT_FLUSH_IDLE), 0);
+    KP_CHECK_EQ(g_fake.count, 10);
+
+    unsigned long wrong = 0;
+    for (unsigned int i = 0; i < 10; i++) {
+        int key_up = (g_fake.keys[i].flags & INJECT_KEY_UP) != 0;
+        if (g_fake.keys[i].vk_code != 'A' + i || key_up != (int)(i & 1)) {
+            wrong++;
+        }
+    }
+    KP_CHECK_EQ(wrong, 0);
+    KP_CHECK_EQ(g_batch.stats.flushes[INJECT_FLUSH_SIZE], 1);
+    KP_CHECK_EQ(g_batch.stats.flushes[INJECT_FLUSH_IDLE], 1);
+    KP_CHECK_EQ(g_batch.stats.max_batch, 8);
+    KP_CHECK_EQ(g_batch.stats.keys, 10);
+}
+
+static void test_deadline_and_poll(void) {
+    setup(16, 1000, 0);
+    inject_batch_add(&g_batch, 'A', 1, 1, 5000);
+    KP_CHECK_EQ(g_batch.deadline_ns, 6000);
+    inject_batch_poll(&g_batch, 5999);
+    KP_CHECK_EQ(g_fake.sends, 0);
+    inject_batch_poll(&g_batch, 6000);
+    KP_CHECK_EQ(g_fake.count, 1);
+    KP_CHECK_EQ(g_batch.deadline_ns, 0);
+
+    // 밀린 큐를 처리하는 동안 기한이 지나면 넣는 순간 내보냄
+    inject_batch_add(&g_batch, 'B', 1, 1, 7000);
+    inject_batch_add(&g_batch, 'B', 0, 1, 8000);
+    KP_CHECK_EQ(g_fake.count, 3);
+    KP_CHECK_EQ(g_batch.stats.flushes[INJECT_FLUSH_DEADLINE], 2);
+}
+
+static void test_foreground_change_flushes_first(void) {
+    setup(16, 1000000000ULL, 0);
+    inject_batch_add(&g_batch, 'A', 1, 1, 0);
+    inject_batch_add(&g_batch, 'A', 0, 1, 0);
+    inject_batch_add(&g_batch, 'B', 1, 2, 0);
+    // 이전 창의 키만 먼저 내보내고, 새 창의 키는 새 묶음에
+    KP_CHECK_EQ(g_fake.count, 2);
+    KP_CHECK_EQ(g_batch.count, 1);
+    KP_CHECK_EQ(g_batch.target, 2);
+    KP_CHECK_EQ(g_batch.stats.flushes[INJECT_FLUSH_FOREGROUND], 1);
+}
+
+static void test_partial_send_retried_once(void) {
+    setup(16, 1000000000ULL, 0);
+    g_fake.accept_limit = 3;
+    for (unsigned int i = 0; i < 5; i++) {
+        inject_batch_add(&g_batch, 'A' + i, 1, 1, 0);
+    }
+    KP_CHECK_EQ(inject_batch_flush(&g_batch, INJECT_FLUSH_IDLE), 5);
+    KP_CHECK_EQ(g_fake.sends, 2);
+    KP_CHECK_EQ(g_fake.keys[3].vk_code, 'D');
+    KP_CHECK_EQ(g_batch.stats.failed, 0);
+
+    // 두 번 보내도 남으면 버리고 셈
+    for (unsigned int i = 0; i < 8; i++) {
+        inject_batch_add(&g_batch, 'A' + i, 1, 1, 0);
+    }
+    KP_CHECK_EQ(inject_batch_flush(&g_batch, INJECT_FLUSH_IDLE), 6);
+    KP_CHECK_EQ(g_batch.stats.failed, 2);
+    KP_CHECK_EQ(g_batch.count, 0);
+}
+
+static void test_unicode_path(void) {
+    setup(64, 1000000000ULL, 1);
+    tap('A', 0);
+    inject_batch_add(&g_batch, TEST_VK_LSHIFT, 1, 1, 0);
+    tap('B', 0);
+    inject_batch_add(&g_batch, TEST_VK_LSHIFT, 0, 1, 0);
+    // Ctrl이 눌려 있으면 단축키이므로 가상 키 코드로
+    inject_batch_add(&g_batch, TEST_VK_LCONTROL, 1, 1, 0);
+    tap('C', 0);
+    inject_batch_add(&g_batch, TEST_VK_LCONTROL, 0, 1, 0);
+    tap('1', 0);
+    inject_batch_flush(&g_batch, INJECT_FLUSH_IDLE);
+    KP_CHECK_EQ(g_fake.count, 12);
+
+    KP_CHECK(g_fake.keys[0].flags & INJECT_KEY_UNICODE);
+    KP_CHECK_EQ(g_fake.keys[0].unicode, 'a');
+    // 키 업은 키 다운 때 쓴 문자로
+    KP_CHECK_EQ(g_fake.keys[1].flags, INJECT_KEY_UP | INJECT_KEY_UNICODE);
+    KP_CHECK_EQ(g_fake.keys[1].unicode, 'a');
+    KP_CHECK_EQ(g_fake.keys[2].flags, 0);
+    KP_CHECK_EQ(g_fake.keys[3].unicode, 'B');
+    KP_CHECK_EQ(g_fake.keys[4].unicode, 'B');
+    KP_CHECK_EQ(g_fake.keys[7].vk_code, 'C');
+    KP_CHECK_EQ(g_fake.keys[7].flags, 0);
+    KP_CHECK_EQ(g_fake.keys[8].flags, INJECT_KEY_UP);
+    KP_CHECK_EQ(g_fake.keys[10].flags, 0);
+    KP_CHECK_EQ(g_batch.stats.unicode_keys, 2);
+}
+
+static void test_caps_lock_follows_injected_keys(void) {
+    setup(64, 1000000000ULL, 1);
+    inject_batch_set_caps_lock(&g_batch, 1);
+    tap('A', 0);
+    // 같은 묶음 안의 Caps Lock 키 다운에서 바로 꺼지고, 자동 반복은 다시 바꾸지 않음
+    inject_batch_add(&g_batch, INJECT_VK_CAPITAL, 1, 1, 0);
+    inject_batch_add(&g_batch, INJECT_VK_CAPITAL, 1, 1, 0);
+    inject_batch_add(&g_batch, INJECT_VK_CAPITAL, 0, 1, 0);
+    tap('B', 0);
+    KP_CHECK_EQ(g_fake.last_caps_lock, 0);
+    inject_batch_add(&g_batch, TEST_VK_LSHIFT, 1, 1, 0);
+    tap('C', 0);
+    inject_batch_add(&g_batch, TEST_VK_LSHIFT, 0, 1, 0);
+    tap(INJECT_VK_CAPITAL, 0);
+    tap('D', 0);
+    KP_CHECK_EQ(g_fake.last_caps_lock, 1);
+    inject_batch_flush(&g_batch, INJECT_FLUSH_IDLE);
+
+    KP_CHECK_EQ(g_fake.keys[0].unicode, 'A');
+    KP_CHECK_EQ(g_fake.keys[5].unicode, 'b');
+    KP_CHECK_EQ(g_fake.keys[8].unicode, 'C');
+    KP_CHECK_EQ(g_fake.keys[13].unicode, 'D');
+    KP_CHECK(g_batch.caps_lock);
+    // Caps Lock 키 자체는 문자가 아니므로 가상 키 코드로
+    KP_CHECK_EQ(g_fake.keys[2].flags, 0);
+    KP_CHECK_EQ(g_fake.keys[2].vk_code, INJECT_VK_CAPITAL);
+}
+
+static const kp_test_case g_cases[] = {
+    { "defaults_and_clamp", test_defaults_and_clamp },
+    { "size_flush_keeps_order", test_size_flush_keeps_order },
+    { "deadline_and_poll", test_deadline_and_poll },
+    { "foreground_change_flushes_first", test_foreground_change_flushes_first },
+    { "partial_send_retried_once", test_partial_send_retried_once },
+    { "unicode_path", test_unicode_path },
+    { "caps_lock_follows_injected_keys", test_caps_lock_follows_injected_keys }
+};
+
+KP_TEST_SUITE(inject_batch, g_cases);
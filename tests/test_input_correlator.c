@@ -0,0 +1,236 @@
+/**
+ * @file test_input_correlator.c
+ * @brief Raw Input과 후크 이벤트 짝짓기의 먼저 온 짝/붙잡은 짝/늦은 짝 학습/만료 경로 테스트 (가상 시계)
+ */
+#include "kp_test.h"
+#include "input_correlator.h"
+#include "key_processor.h"
+
+#include <string.h>
+
+/** @brief 가상 시계 마이크로초 → 나노초 */
+#define US(value) ((unsigned long long)(value) * 1000ULL)
+
+/** @brief 기록할 수 있는 내보낸 이벤트 수 */
+#define CORRELATOR_TEST_MAX_RELEASED 64
+
+/** @brief 테스트 장치 핸들 */
+#define TEST_DEVICE ((uintptr_t)0x2004)
+
+static input_correlator g_correlator;
+
+/** @brief 내보낸 이벤트의 가상 키 코드 (후크 순서 확인용) */
+static unsigned int g_released_vk[CORRELATOR_TEST_MAX_RELEASED];
+
+/** @brief 내보낸 이벤트에 붙은 장치 */
+static uintptr_t g_released_device[CORRELATOR_TEST_MAX_RELEASED];
+
+static size_t g_released;
+
+/** @brief 가상 시계 (나노초) */
+static unsigned long long g_now;
+
+static void record_release(const key_event* event, uintptr_t device, void* user) {
+    (void)user;
+    if (g_released < CORRELATOR_TEST_MAX_RELEASED) {
+        g_released_vk[g_released] = event->vk_code;
+        g_released_device[g_released] = device;
+        g_released++;
+    }
+}
+
+static void setup(void) {
+    input_correlator_init(&g_correlator, record_release, NULL);
+    g_released = 0;
+    g_now = 1000000000ULL;
+}
+
+/**
+ * @brief 후크 이벤트 하나를 넣습니다. (스캔 코드는 가상 키 코드와 같게 둠)
+ */
+static void hook(unsigned int vk_code, int key_down) {
+    key_event event;
+    memset(&event, 0, sizeof(event));
+    event.vk_code = vk_code;
+    event.message = key_down ? KEY_MESSAGE_KEYDOWN : KEY_MESSAGE_KEYUP;
+    event.enqueue_ns = g_now;
+    input_correlator_hook(&g_correlator, &event, INPUT_SCAN_KEY(vk_code, 0), g_now);
+}
+
+static void hook_injected(unsigned int vk_code) {
+    key_event event;
+    memset(&event, 0, sizeof(event));
+    event.vk_code = vk_code;
+    event.message = KEY_MESSAGE_KEYDOWN;
+    input_correlator_hook(&g_correlator, &event, INPUT_SCAN_KEY_NONE, g_now);
+}
+
+static void raw(unsigned int vk_code, int key_down) {
+    input_correlator_raw(&g_correlator, TEST_DEVICE, INPUT_SCAN_KEY(vk_code, 0), key_down, g_now);
+}
+
+/**
+ * @brief 후크가 먼저 오고 delay_ns 뒤에 Raw Input이 오는 키 다운을 count번 넣습니다.
+ */
+static void hook_then_raw(int count, unsigned long long delay_ns) {
+    for (int i = 0; i < count; i++) {
+        hook(0x41 + (unsigned int)i % 26, 1);
+        g_now += delay_ns;
+        raw(0x41 + (unsigned int)i % 26, 1);
+        g_now += US(1000);
+        input_correlator_expire(&g_correlator, g_now);
+    }
+}
+
+static void test_raw_first_matches_immediately(void) {
+    setup();
+    raw('A', 1);
+    g_now += US(50);
+    hook('A', 1);
+    KP_CHECK_EQ(g_released, 1);
+    KP_CHECK_EQ(g_released_device[0], TEST_DEVICE);
+    KP_CHECK_EQ(g_correlator.stats.early_matches, 1);
+
+    // 다운/업이 다르면 짝이 아님
+    raw('B', 0);
+    hook('B', 1);
+    KP_CHECK_EQ(g_released, 2);
+    KP_CHECK_EQ(g_released_device[1], 0);
+    KP_CHECK_EQ(g_correlator.stats.unmatched, 1);
+    KP_CHECK_EQ(g_correlator.raw_count, 1);
+
+    // 짝짓기 범위(50ms)를 넘긴 Raw Input은 버림
+    g_now += INPUT_CORRELATOR_WINDOW_NS + 1;
+    hook('B', 0);
+    KP_CHECK_EQ(g_released_device[2], 0);
+    KP_CHECK_EQ(g_correlator.stats.stale_raw, 1);
+    KP_CHECK_EQ(g_correlator.raw_count, 0);
+}
+
+static void test_late_raw_learns_hold(void) {
+    setup();
+    // 붙잡기 전: 바로 장치 미상으로 내보내고 늦은 짝으로 지연만 학습
+    hook_then_raw(INPUT_CORRELATOR_LEARN - 1, US(300));
+    KP_CHECK_EQ(g_correlator.hold_ns, 0);
+    KP_CHECK_EQ(g_correlator.stats.late_matches, INPUT_CORRELATOR_LEARN - 1);
+    KP_CHECK_EQ(g_correlator.stats.unmatched, INPUT_CORRELATOR_LEARN - 1);
+
+    hook_then_raw(1, US(300));
+    KP_CHECK_EQ(g_correlator.hold_ns, US(600));
+    KP_CHECK_EQ(g_correlator.stats.max_late_ns, US(300));
+    KP_CHECK_EQ(g_correlator.stats.hold_changes, 1);
+    KP_CHECK_EQ(g_released, INPUT_CORRELATOR_LEARN);
+}
+
+static void test_held_event_gets_device_in_order(void) {
+    setup();
+    hook_then_raw(INPUT_CORRELATOR_LEARN, US(300));
+    size_t before = g_released;
+
+    // 붙잡은 후크 이벤트 뒤의 주입된 키도 순서를 지키기 위해 함께 기다림
+    hook('Q', 1);
+    KP_CHECK_EQ(input_correlator_deadline(&g_correlator), g_now + US(600));
+    hook_injected('Z');
+    KP_CHECK_EQ(g_released, before);
+    KP_CHECK_EQ(g_correlator.pending_count, 2);
+
+    g_now += US(200);
+    raw('Q', 1);
+    KP_CHECK_EQ(g_released, before + 2);
+    KP_CHECK_EQ(g_released_vk[before], 'Q');
+    KP_CHECK_EQ(g_released_device[before], TEST_DEVICE);
+    KP_CHECK_EQ(g_released_vk[before + 1], 'Z');
+    KP_CHECK_EQ(g_released_device[before + 1], 0);
+    KP_CHECK_EQ(g_correlator.stats.held_matches, 1);
+    KP_CHECK_EQ(g_correlator.stats.injected, 1);
+    KP_CHECK_EQ(input_correlator_deadline(&g_correlator), 0);
+}
+
+static void test_expired_holds_turn_off(void) {
+    setup();
+    hook_then_raw(INPUT_CORRELATOR_LEARN, US(300));
+    size_t before = g_released;
+
+    // 기한 전에는 내보내지 않고, 기한이 지나면 장치 미상으로
+    hook('E', 1);
+    g_now += US(599);
+    input_correlator_expire(&g_correlator, g_now);
+    KP_CHECK_EQ(g_released, before);
+    g_now += US(1);
+    input_correlator_expire(&g_correlator, g_now);
+    KP_CHECK_EQ(g_released, before + 1);
+    KP_CHECK_EQ(g_released_device[before], 0);
+    KP_CHECK_EQ(g_correlator.stats.expired, 1);
+
+    // 붙잡은 이벤트가 계속 짝 없이 만료되면 붙잡기를 끔
+    for (int i = 1; i < INPUT_CORRELATOR_LEARN; i++) {
+        hook('E', i & 1);
+        g_now += US(1000);
+        input_correlator_expire(&g_correlator, g_now);
+    }
+    KP_CHECK_EQ(g_correlator.stats.expired, INPUT_CORRELATOR_LEARN);
+    KP_CHECK_EQ(g_correlator.hold_ns, 0);
+    KP_CHECK_EQ(g_correlator.stats.hold_changes, 2);
+
+    // 끈 뒤에는 바로 내보냄
+    hook('F', 1);
+    KP_CHECK_EQ(g_correlator.pending_count, 0);
+}
+
+static void test_required_hold_stays_on(void) {
+    setup();
+    // 장치 규칙이 요구하면 학습 없이 처음부터 최대 시간만큼 붙잡음
+    input_correlator_require_hold(&g_correlator, 1);
+    KP_CHECK_EQ(g_correlator.hold_ns, INPUT_CORRELATOR_MAX_HOLD_NS);
+    hook('A', 1);
+    KP_CHECK_EQ(g_released, 0);
+    g_now += US(1500);
+    raw('A', 1);
+    KP_CHECK_EQ(g_released, 1);
+    KP_CHECK_EQ(g_released_device[0], TEST_DEVICE);
+
+    // 만료가 이어져도 끄지 않음
+    for (int i = 0; i < INPUT_CORRELATOR_LEARN * 2; i++) {
+        hook('B', i & 1);
+        g_now += INPUT_CORRELATOR_MAX_HOLD_NS;
+        input_correlator_expire(&g_correlator, g_now);
+    }
+    KP_CHECK_EQ(g_correlator.stats.expired, INPUT_CORRELATOR_LEARN * 2);
+    KP_CHECK_EQ(g_correlator.hold_ns, INPUT_CORRELATOR_MAX_HOLD_NS);
+
+    // 요구가 풀리면 붙잡기를 끄고 다시 학습
+    input_correlator_require_hold(&g_correlator, 0);
+    KP_CHECK_EQ(g_correlator.hold_ns, 0);
+    KP_CHECK_EQ(g_correlator.stats.hold_changes, 2);
+    input_correlator_require_hold(&g_correlator, 0);
+    KP_CHECK_EQ(g_correlator.stats.hold_changes, 2);
+}
+
+static void test_flush_releases_in_order(void) {
+    setup();
+    input_correlator_require_hold(&g_correlator, 1);
+    hook('A', 1);
+    hook('B', 1);
+    hook('C', 1);
+    raw('B', 1);
+    // 맨 앞이 아직 짝이 없으므로 짝지은 B도 기다림
+    KP_CHECK_EQ(g_released, 0);
+    input_correlator_flush(&g_correlator);
+    KP_CHECK_EQ(g_released, 3);
+    KP_CHECK_EQ(g_released_vk[0], 'A');
+    KP_CHECK_EQ(g_released_vk[1], 'B');
+    KP_CHECK_EQ(g_released_device[1], TEST_DEVICE);
+    KP_CHECK_EQ(g_released_vk[2], 'C');
+    KP_CHECK_EQ(g_correlator.pending_count, 0);
+}
+
+static const kp_test_case g_cases[] = {
+    { "raw_first_matches_immediately", test_raw_first_matches_immediately },
+    { "late_raw_learns_hold", test_late_raw_learns_hold },
+    { "held_event_gets_device_in_order", test_held_event_gets_device_in_order },
+    { "expired_holds_turn_off", test_expired_holds_turn_off },
+    { "required_hold_stays_on", test_required_hold_stays_on },
+    { "flush_releases_in_order", test_flush_releases_in_order }
+};
+
+KP_TEST_SUITE(input_correlator, g_cases);
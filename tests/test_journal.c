@@ -0,0 +1,246 @@
+/**
+ * @file test_journal.c
+ * @brief 저널 세그먼트의 위치(솔트) 기록, 감싼 세션 키 풀기, 저널 키 파일 읽기 테스트
+ * @details 임시 디렉토리에 실제 세그먼트를 기록한 뒤 다시 매핑하여 검사합니다.
+ */
+#include "kp_test.h"
+#include "key_journal.h"
+#include "keystream.h"
+#include "crypto_keycode.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** @brief 기록하는 레코드 수 */
+#define JOURNAL_TEST_RECORDS 300
+
+/** @brief 레코드의 솔트로 쓰는 위치 (예비 스트림 위치도 포함) */
+#define JOURNAL_TEST_POSITION(i) (((i) % 7 == 0) ? (KEYSTREAM_POSITION_FALLBACK | (uint32_t)(i)) : (uint32_t)(i) * 3)
+
+static const uint32_t g_session_key[8] = {
+    0x11111111, 0x22222222, 0x33333333, 0x44444444, 0x55555555, 0x66666666, 0x77777777, 0x88888888
+};
+static const uint32_t g_journal_key[8] = {
+    0x03020100, 0x07060504, 0x0b0a0908, 0x0f0e0d0c, 0x13121110, 0x17161514, 0x1b1a1918, 0x1f1e1d1c
+};
+static const uint32_t g_nonce = 0x5eed;
+
+static key_journal_writer g_writer;
+
+/**
+ * @brief 복호화 검사에서 모으는 값
+ */
+typedef struct journal_check {
+    const uint32_t* session_key;  /**< 복호화할 세션 키 (NULL이면 세지 않음) */
+    uint32_t nonce;               /**< 세그먼트의 세션 논스 */
+    unsigned long visited;        /**< 받은 레코드 수 */
+    unsigned long decrypted;      /**< 원래 키 코드로 복호화된 레코드 수 */
+    unsigned long salt_is_word;   /**< 솔트가 키스트림 워드와 같은 레코드 수 */
+} journal_check;
+
+static unsigned int test_vk(unsigned int sequence) {
+    return 0x30 + sequence % 40;
+}
+
+static void check_record(void* user, const key_journal_segment* segment, const key_journal_record* record) {
+    journal_check* check = (journal_check*)user;
+    (void)segment;
+    check->visited++;
+    if (record->salt == keystream_word_at(g_session_key, g_nonce, record->salt)) {
+        check->salt_is_word++;
+    }
+    if (check->session_key != NULL &&
+        key_journal_decrypt(check->session_key, check->nonce, record) == test_vk(record->sequence)) {
+        check->decrypted++;
+    }
+}
+
+/**
+ * @brief 임시 디렉토리의 파일을 지우고 디렉토리를 제거합니다.
+ */
+static void remove_directory(const char* directory) {
+    DIR* dir = opendir(directory);
+    if (dir == NULL) {
+        return;
+    }
+    struct dirent* item;
+    char path[512];
+    while ((item = readdir(dir)) != NULL) {
+        if (item->d_name[0] == '.') {
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", directory, item->d_name);
+        remove(path);
+    }
+    closedir(dir);
+    rmdir(directory);
+}
+
+/**
+ * @brief 디렉토리에서 첫 세그먼트 파일 경로를 찾습니다.
+ * @return int 찾았으면 1
+ */
+static int find_segment(const char* directory, char* path, size_t size) {
+    DIR* dir = opendir(directory);
+    if (dir == NULL) {
+        return 0;
+    }
+    struct dirent* item;
+    int found = 0;
+    while (!found && (item = readdir(dir)) != NULL) {
+        size_t length = strlen(item->d_name);
+        if (length > 4 && strcmp(item->d_name + length - 4, ".kpj") == 0) {
+            snprintf(path, size, "%s/%s", directory, item->d_name);
+            found = 1;
+        }
+    }
+    closedir(dir);
+    return found;
+}
+
+/**
+ * @brief 세션 키 정보로 저널을 기록하고 세그먼트 경로를 돌려줍니다.
+ * @details 레코드 i는 위치 JOURNAL_TEST_POSITION(i)의 워드로 암호화한 test_vk(i)를 담습니다.
+ */
+static int write_journal(const char* directory, const key_journal_key_info* key_info, char* path, size_t size) {
+    remove_directory(directory);
+    if (mkdir(directory, 0700) != 0) {
+        return 0;
+    }
+    if (!key_journal_writer_start(&g_writer, directory, 0, key_info)) {
+        return 0;
+    }
+    unsigned short name_id = key_journal_intern_name(&g_writer, "notepad.exe");
+    for (unsigned int i = 0; i < JOURNAL_TEST_RECORDS; i++) {
+        key_journal_entry entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.timestamp_ns = kp_now_ns();
+        entry.salt = JOURNAL_TEST_POSITION(i);
+        entry.encrypted_keycode = encrypt_keycode_with_salt(test_vk(i), keystream_word_at(g_session_key, g_nonce, entry.salt));
+        entry.name_id = name_id;
+        entry.verdict = (unsigned char)(i % 3);
+        while (!key_journal_append(&g_writer, &entry)) {
+            kp_sleep_ms(1);
+        }
+    }
+    key_journal_writer_stop(&g_writer);
+    return find_segment(directory, path, size);
+}
+
+static void test_wrapped_key_decrypts_positions(void) {
+    char directory[128];
+    char path[512];
+    snprintf(directory, sizeof(directory), "/tmp/kp_test_journal_%lu", kp_process_id());
+
+    key_journal_key_info key_info;
+    key_journal_wrap_key(&key_info, g_journal_key, g_session_key, g_nonce);
+    KP_CHECK(key_info.wrapped);
+    // 감싼 키는 세션 키 그대로가 아니어야 함
+    KP_CHECK(memcmp(key_info.wrapped_key, g_session_key, sizeof(g_session_key)) != 0);
+    KP_CHECK(write_journal(directory, &key_info, path, sizeof(path)));
+
+    key_journal_segment segment;
+    KP_CHECK(key_journal_segment_open(&segment, path));
+    KP_CHECK(segment.flags & KEY_JOURNAL_FLAG_WRAPPED_KEY);
+    KP_CHECK_EQ(segment.key_info.nonce, g_nonce);
+
+    uint32_t session_key[8];
+    KP_CHECK(key_journal_unwrap_key(&segment, g_journal_key, session_key));
+    KP_CHECK(memcmp(session_key, g_session_key, sizeof(session_key)) == 0);
+
+    journal_check check;
+    memset(&check, 0, sizeof(check));
+    check.session_key = session_key;
+    check.nonce = segment.key_info.nonce;
+    key_journal_query query;
+    memset(&query, 0, sizeof(query));
+    key_journal_scan_result result;
+    memset(&result, 0, sizeof(result));
+    KP_CHECK(key_journal_scan(&segment, &query, check_record, &check, &result));
+    KP_CHECK_EQ(check.visited, JOURNAL_TEST_RECORDS);
+    KP_CHECK_EQ(check.decrypted, JOURNAL_TEST_RECORDS);
+    // 파일에는 위치만 있고 키스트림 워드는 없음
+    KP_CHECK_EQ(check.salt_is_word, 0);
+
+    // 다른 저널 키로는 풀리지 않음
+    uint32_t wrong_key[8];
+    memcpy(wrong_key, g_journal_key, sizeof(wrong_key));
+    wrong_key[5] ^= 0x100;
+    KP_CHECK(!key_journal_unwrap_key(&segment, wrong_key, session_key));
+
+    key_journal_segment_close(&segment);
+    remove_directory(directory);
+}
+
+static void test_segment_without_key_is_locked(void) {
+    char directory[128];
+    char path[512];
+    snprintf(directory, sizeof(directory), "/tmp/kp_test_journal_nokey_%lu", kp_process_id());
+
+    // 저널 키 파일이 없으면 논스만 기록되고 세션 키는 어디에도 남지 않음
+    key_journal_key_info key_info;
+    memset(&key_info, 0, sizeof(key_info));
+    key_info.nonce = g_nonce;
+    KP_CHECK(write_journal(directory, &key_info, path, sizeof(path)));
+
+    key_journal_segment segment;
+    KP_CHECK(key_journal_segment_open(&segment, path));
+    KP_CHECK(!(segment.flags & KEY_JOURNAL_FLAG_WRAPPED_KEY));
+    uint32_t session_key[8];
+    KP_CHECK(!key_journal_unwrap_key(&segment, g_journal_key, session_key));
+
+    journal_check check;
+    memset(&check, 0, sizeof(check));
+    key_journal_query query;
+    memset(&query, 0, sizeof(query));
+    key_journal_scan_result result;
+    memset(&result, 0, sizeof(result));
+    KP_CHECK(key_journal_scan(&segment, &query, check_record, &check, &result));
+    KP_CHECK_EQ(check.visited, JOURNAL_TEST_RECORDS);
+    KP_CHECK_EQ(check.salt_is_word, 0);
+
+    key_journal_segment_close(&segment);
+    remove_directory(directory);
+}
+
+static void test_read_key_file(void) {
+    char path[128];
+    snprintf(path, sizeof(path), "/tmp/kp_test_journal_%lu.key", kp_process_id());
+    uint32_t key[8];
+
+    // 앞 바이트부터 적은 16진수, 공백과 줄바꿈은 무시
+    FILE* file = fopen(path, "w");
+    KP_CHECK(file != NULL);
+    if (file == NULL) {
+        return;
+    }
+    fputs("00010203 04050607 08090a0b 0c0d0e0f\n10111213 14151617 18191A1B 1C1D1E1F\n", file);
+    fclose(file);
+    KP_CHECK(key_journal_read_key_file(path, key));
+    KP_CHECK(memcmp(key, g_journal_key, sizeof(key)) == 0);
+
+    // 자릿수가 모자라거나 16진수가 아닌 문자가 있으면 거부
+    file = fopen(path, "w");
+    fputs("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e", file);
+    fclose(file);
+    KP_CHECK(!key_journal_read_key_file(path, key));
+
+    file = fopen(path, "w");
+    fputs("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1g", file);
+    fclose(file);
+    KP_CHECK(!key_journal_read_key_file(path, key));
+
+    remove(path);
+    KP_CHECK(!key_journal_read_key_file(path, key));
+}
+
+static const kp_test_case g_cases[] = {
+    { "wrapped_key_decrypts_positions", test_wrapped_key_decrypts_positions },
+    { "segment_without_key_is_locked", test_segment_without_key_is_locked },
+    { "read_key_file", test_read_key_file }
+};
+
+KP_TEST_SUITE(journal, g_cases);
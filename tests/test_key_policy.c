@@ -0,0 +1,219 @@
+/**
+ * @file test_key_policy.c
+ * @brief 키 규칙 컴파일/판정과 컴파일할 수 없는 [KeyRules] 항목의 차단(fail closed) 테스트
+ */
+#include "kp_test.h"
+#include "key_policy.h"
+#include "policy_loader.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static key_policy g_policy;
+
+/**
+ * @brief 규칙 하나를 컴파일하여 테이블에 넣고 규칙 번호를 반환합니다. (실패하면 -1)
+ */
+static int compile_rule(const char* spec) {
+    key_rule rule;
+    key_policy_init(&g_policy);
+    if (!key_rule_compile(&rule, spec, NULL, 0)) {
+        return -1;
+    }
+    return key_policy_add(&g_policy, &rule);
+}
+
+static int allows(int rule, unsigned int vk_code, unsigned int modifiers) {
+    return key_policy_allows(&g_policy, (unsigned int)rule, vk_code, modifiers);
+}
+
+/**
+ * @brief INI 내용으로 정책을 로드하고 프로세스의 규칙 번호 + 1을 반환합니다.
+ */
+static unsigned int load_rule_value(const char* ini, const char* process, policy_snapshot** snapshot) {
+    policy_load_status status;
+    *snapshot = policy_load_buffer(ini, strlen(ini), &status);
+    return (*snapshot != NULL) ? allowlist_value(&(*snapshot)->allowed, process) : 0;
+}
+
+static void test_rule_zero_allows_everything(void) {
+    key_policy_init(&g_policy);
+    KP_CHECK_EQ(g_policy.count, 1);
+    KP_CHECK(allows(KEY_POLICY_RULE_ALL, 'A', 0));
+    KP_CHECK(allows(KEY_POLICY_RULE_ALL, 0xFE, KEY_MOD_CTRL | KEY_MOD_ALT | KEY_MOD_SHIFT | KEY_MOD_WIN));
+    KP_CHECK(!allows(KEY_POLICY_RULE_ALL, 0x00, 0));
+    KP_CHECK(!allows(KEY_POLICY_RULE_ALL, 0xFF, 0));
+    // 범위 밖 번호(재로드 직후의 이전 번호, 차단 규칙)는 차단
+    KP_CHECK(!allows(1, 'A', 0));
+    KP_CHECK(!allows(KEY_POLICY_RULE_DENY, 'A', 0));
+}
+
+static void test_categories_and_exclusions(void) {
+    int rule = compile_rule("alnum punct edit nav");
+    KP_CHECK_EQ(rule, 1);
+    KP_CHECK(allows(rule, 'A', 0));
+    KP_CHECK(allows(rule, '7', 0));
+    KP_CHECK(allows(rule, 0x0D, 0));   // enter
+    KP_CHECK(allows(rule, 0x25, 0));   // left
+    KP_CHECK(allows(rule, 0xBA, 0));   // ;
+    KP_CHECK(!allows(rule, 0x70, 0));  // f1
+    KP_CHECK(!allows(rule, 0x5B, 0));  // lwin
+
+    // 첫 항목이 제외 항목이면 all에서 시작
+    rule = compile_rule("-func -win");
+    KP_CHECK(allows(rule, 'Z', 0));
+    KP_CHECK(!allows(rule, 0x74, 0));  // f5
+    KP_CHECK(!allows(rule, 0x5C, 0));  // rwin
+    KP_CHECK(allows(rule, 0x1B, 0));
+
+    // 키 항목이 없으면 모든 키
+    rule = compile_rule("| -alt");
+    KP_CHECK(allows(rule, 0x70, 0));
+    KP_CHECK(!allows(rule, 0x70, KEY_MOD_ALT));
+}
+
+static void test_hex_codes_and_names(void) {
+    int rule = compile_rule("0x41 0X5a f24 numpad7 esc");
+    KP_CHECK(rule > 0);
+    KP_CHECK(allows(rule, 0x41, 0));
+    KP_CHECK(allows(rule, 0x5A, 0));
+    KP_CHECK(!allows(rule, 0x42, 0));
+    KP_CHECK(allows(rule, 0x87, 0));
+    KP_CHECK(allows(rule, 0x67, 0));
+    KP_CHECK(allows(rule, 0x1B, 0));
+
+    KP_CHECK_EQ(key_name_to_vk("0x01"), 0x01);
+    KP_CHECK_EQ(key_name_to_vk("0xfe"), 0xFE);
+    KP_CHECK_EQ(key_name_to_vk("0x00"), -1);
+    KP_CHECK_EQ(key_name_to_vk("0xFF"), -1);
+    KP_CHECK_EQ(key_name_to_vk("0x100"), -1);
+    KP_CHECK_EQ(key_name_to_vk("0x+41"), -1);
+    KP_CHECK_EQ(key_name_to_vk("0x-1"), -1);
+    KP_CHECK_EQ(key_name_to_vk("0x41g"), -1);
+    KP_CHECK_EQ(key_name_to_vk("f0"), -1);
+    KP_CHECK_EQ(key_name_to_vk("f25"), -1);
+    // 분류 이름은 키 하나가 아니므로 키 이름이 아님
+    KP_CHECK_EQ(key_name_to_vk("alnum"), -1);
+    KP_CHECK_EQ(key_name_to_vk("ESCAPE"), 0x1B);
+}
+
+static void test_chord_terms(void) {
+    int rule = compile_rule("alnum | -shift");
+    KP_CHECK(allows(rule, 'A', 0));
+    KP_CHECK(allows(rule, 'A', KEY_MOD_CTRL));
+    KP_CHECK(!allows(rule, 'A', KEY_MOD_SHIFT));
+    KP_CHECK(!allows(rule, 'A', KEY_MOD_SHIFT | KEY_MOD_CTRL));
+    KP_CHECK_EQ(key_rule_chord_count(&g_policy.rules[rule]), KEY_MOD_STATES / 2);
+
+    rule = compile_rule("alnum | none");
+    KP_CHECK(allows(rule, 'A', 0));
+    KP_CHECK(!allows(rule, 'A', KEY_MOD_SHIFT));
+    KP_CHECK(!allows(rule, 'A', KEY_MOD_WIN));
+    KP_CHECK_EQ(key_rule_chord_count(&g_policy.rules[rule]), 1);
+
+    rule = compile_rule("all, | -ctrl, -alt");
+    KP_CHECK(allows(rule, 'C', KEY_MOD_SHIFT));
+    KP_CHECK(!allows(rule, 'C', KEY_MOD_CTRL));
+    KP_CHECK(!allows(rule, 'C', KEY_MOD_ALT | KEY_MOD_SHIFT));
+    KP_CHECK_EQ(key_rule_chord_count(&g_policy.rules[rule]), 4);
+}
+
+static void test_malformed_tokens_rejected(void) {
+    static const char* const bad_specs[] = {
+        "alnum bogus",
+        "alnum | shift",     // 조합 항목은 any/none 또는 -로 시작해야 함
+        "alnum | -bogus",
+        "alnum | -",
+        "0x",
+        "0xZZ",
+        "--alnum",
+        "alnum | alnum",
+        "escapeescapeescapeescapeescapeescape"
+    };
+    char bad_token[32];
+    for (size_t i = 0; i < sizeof(bad_specs) / sizeof(bad_specs[0]); i++) {
+        key_rule rule;
+        bad_token[0] = '\0';
+        KP_CHECK(!key_rule_compile(&rule, bad_specs[i], bad_token, sizeof(bad_token)));
+        KP_CHECK(bad_token[0] != '\0');
+    }
+    key_rule rule;
+    KP_CHECK(!key_rule_compile(&rule, "a b 0xQQ", bad_token, sizeof(bad_token)));
+    KP_CHECK(strcmp(bad_token, "0xQQ") == 0);
+}
+
+static void test_modifier_state(void) {
+    unsigned int held = key_modifier_key(0xA1) | key_modifier_key(0xA2);  // rshift, lctrl
+    KP_CHECK_EQ(key_modifier_state(held), KEY_MOD_SHIFT | KEY_MOD_CTRL);
+    KP_CHECK_EQ(key_modifier_state(key_modifier_key(0x5C)), KEY_MOD_WIN);
+    KP_CHECK_EQ(key_modifier_key('A'), 0);
+}
+
+static void test_bad_rule_fails_closed(void) {
+    // 허용 목록에도 있는 프로세스의 규칙을 컴파일할 수 없으면 전체 허용이 아니라 모든 키 차단
+    static const char* const configs[] = {
+        "[AllowedProcesses]\nProcess1=putty.exe\n[KeyRules]\nputty.exe=alnum bogus\n",
+        "[KeyRules]\nputty.exe=alnum bogus\n[AllowedProcesses]\nProcess1=putty.exe\n",
+        "[KeyRules]\nputty.exe=alnum | shift\n"
+    };
+    for (size_t i = 0; i < sizeof(configs) / sizeof(configs[0]); i++) {
+        policy_snapshot* snapshot = NULL;
+        unsigned int value = load_rule_value(configs[i], "putty.exe", &snapshot);
+        KP_CHECK(snapshot != NULL);
+        if (snapshot == NULL) {
+            continue;
+        }
+        KP_CHECK_EQ(value, KEY_POLICY_RULE_DENY + 1);
+        KP_CHECK(!key_policy_allows(&snapshot->keys, value - 1, 'A', 0));
+        KP_CHECK(!key_policy_allows(&snapshot->keys, value - 1, 0x0D, 0));
+        policy_snapshot_destroy(snapshot);
+    }
+
+    // 올바른 규칙은 그대로 적용되고 다른 허용 프로세스는 전체 허용
+    policy_snapshot* snapshot = NULL;
+    const char* good = "[AllowedProcesses]\nProcess1=notepad.exe\nProcess2=putty.exe\n[KeyRules]\nputty.exe=alnum | -ctrl\n";
+    unsigned int value = load_rule_value(good, "putty.exe", &snapshot);
+    KP_CHECK(snapshot != NULL);
+    if (snapshot != NULL) {
+        KP_CHECK(value >= 2 && value - 1 < snapshot->keys.count);
+        KP_CHECK(key_policy_allows(&snapshot->keys, value - 1, 'A', 0));
+        KP_CHECK(!key_policy_allows(&snapshot->keys, value - 1, 'A', KEY_MOD_CTRL));
+        KP_CHECK_EQ(allowlist_value(&snapshot->allowed, "notepad.exe"), KEY_POLICY_RULE_ALL + 1);
+        policy_snapshot_destroy(snapshot);
+    }
+}
+
+static void test_full_table_fails_closed(void) {
+    // 규칙 테이블이 가득 찬 뒤의 규칙도 모든 키 차단
+    char ini[8192];
+    size_t used = (size_t)snprintf(ini, sizeof(ini), "[KeyRules]\n");
+    for (int i = 0; i < KEY_POLICY_MAX_RULES + 2; i++) {
+        used += (size_t)snprintf(ini + used, sizeof(ini) - used, "p%d.exe=alnum\n", i);
+    }
+    used += (size_t)snprintf(ini + used, sizeof(ini) - used, "[AllowedProcesses]\nProcess1=last.exe\n[KeyRules]\nlast.exe=alnum\n");
+    KP_CHECK(used < sizeof(ini));
+
+    policy_snapshot* snapshot = NULL;
+    unsigned int value = load_rule_value(ini, "last.exe", &snapshot);
+    KP_CHECK(snapshot != NULL);
+    if (snapshot != NULL) {
+        KP_CHECK_EQ(snapshot->keys.count, KEY_POLICY_MAX_RULES);
+        KP_CHECK_EQ(value, KEY_POLICY_RULE_DENY + 1);
+        KP_CHECK(!key_policy_allows(&snapshot->keys, value - 1, 'A', 0));
+        KP_CHECK(key_policy_allows(&snapshot->keys, allowlist_value(&snapshot->allowed, "p0.exe") - 1, 'A', 0));
+        policy_snapshot_destroy(snapshot);
+    }
+}
+
+static const kp_test_case g_cases[] = {
+    { "rule_zero_allows_everything", test_rule_zero_allows_everything },
+    { "categories_and_exclusions", test_categories_and_exclusions },
+    { "hex_codes_and_names", test_hex_codes_and_names },
+    { "chord_terms", test_chord_terms },
+    { "malformed_tokens_rejected", test_malformed_tokens_rejected },
+    { "modifier_state", test_modifier_state },
+    { "bad_rule_fails_closed", test_bad_rule_fails_closed },
+    { "full_table_fails_closed", test_full_table_fails_closed }
+};
+
+KP_TEST_SUITE(key_policy, g_cases);
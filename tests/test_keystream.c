@@ -0,0 +1,100 @@
+/**
+ * @file test_keystream.c
+ * @brief 키스트림 커널 일치, 풀 워드의 위치(솔트)와 keystream_word_at() 복원 테스트
+ */
+#include "kp_test.h"
+#include "keystream.h"
+
+#include <string.h>
+
+/** @brief 위치 복원 테스트에서 꺼내는 워드 수 (풀 용량을 여러 번 넘기도록) */
+#define KEYSTREAM_TEST_WORDS (KEYSTREAM_POOL_WORDS * 3)
+
+static const uint32_t g_key[8] = {
+    0x03020100, 0x07060504, 0x0b0a0908, 0x0f0e0d0c, 0x13121110, 0x17161514, 0x1b1a1918, 0x1f1e1d1c
+};
+
+static keystream_pool g_pool;
+
+static void test_kernels_agree(void) {
+    uint32_t expected[KEYSTREAM_BATCH_BLOCKS * 2 * KEYSTREAM_BLOCK_WORDS];
+    uint32_t actual[KEYSTREAM_BATCH_BLOCKS * 2 * KEYSTREAM_BLOCK_WORDS];
+    size_t blocks = sizeof(expected) / sizeof(expected[0]) / KEYSTREAM_BLOCK_WORDS;
+    // 카운터 하위 워드가 넘어가는 구간도 포함
+    uint64_t counter = 0xFFFFFFFAULL;
+    keystream_generate(KEYSTREAM_KERNEL_SCALAR, g_key, 0, 0x4a000000, counter, expected, blocks);
+    for (int kernel = KEYSTREAM_KERNEL_SSE2; kernel < KEYSTREAM_KERNEL_COUNT; kernel++) {
+        if (!keystream_kernel_supported((keystream_kernel)kernel)) {
+            continue;
+        }
+        memset(actual, 0, sizeof(actual));
+        keystream_generate((keystream_kernel)kernel, g_key, 0, 0x4a000000, counter, actual, blocks);
+        KP_CHECK(memcmp(expected, actual, sizeof(expected)) == 0);
+    }
+}
+
+static void test_pool_positions_regenerate_words(void) {
+    KP_CHECK(keystream_pool_start(&g_pool, g_key, 0x1234));
+    unsigned long mismatched = 0;
+    unsigned long out_of_sequence = 0;
+    for (uint32_t i = 0; i < KEYSTREAM_TEST_WORDS; i++) {
+        uint32_t position = 0;
+        uint32_t word = keystream_pool_next(&g_pool, &position);
+        if (word != keystream_word_at(g_key, 0x1234, position)) {
+            mismatched++;
+        }
+        // 풀이 비어 예비 스트림을 쓴 경우가 아니면 스트림 0의 워드 번호가 차례로 증가
+        if (!(position & KEYSTREAM_POSITION_FALLBACK) && position != i) {
+            out_of_sequence++;
+        }
+    }
+    keystream_stats stats;
+    keystream_pool_get_stats(&g_pool, &stats);
+    keystream_pool_stop(&g_pool);
+    KP_CHECK_EQ(mismatched, 0);
+    if (stats.underflows == 0) {
+        KP_CHECK_EQ(out_of_sequence, 0);
+    }
+    KP_CHECK_EQ(stats.words_used, KEYSTREAM_TEST_WORDS);
+}
+
+static void test_fallback_positions_regenerate_words(void) {
+    // 백그라운드 스레드 없이 빈 풀을 만들어 예비 스트림 경로만 사용
+    memset(&g_pool, 0, sizeof(g_pool));
+    spsc_ring_init(&g_pool.ring, g_pool.storage, sizeof(uint32_t), KEYSTREAM_POOL_WORDS);
+    memcpy(g_pool.key, g_key, sizeof(g_key));
+    g_pool.nonce = 77;
+
+    for (uint32_t i = 0; i < 3 * KEYSTREAM_BLOCK_WORDS; i++) {
+        uint32_t position = 0;
+        uint32_t word = keystream_pool_next(&g_pool, &position);
+        KP_CHECK_EQ(position, KEYSTREAM_POSITION_FALLBACK | i);
+        KP_CHECK_EQ(word, keystream_word_at(g_key, 77, position));
+    }
+    // 같은 워드 번호라도 스트림 0의 워드와는 달라야 함 (예비 경로가 키스트림을 재사용하지 않음)
+    KP_CHECK(keystream_word_at(g_key, 77, 0) != keystream_word_at(g_key, 77, KEYSTREAM_POSITION_FALLBACK));
+    keystream_pool_stop(&g_pool);
+}
+
+static void test_position_is_not_the_word(void) {
+    KP_CHECK(keystream_pool_start(&g_pool, g_key, 9));
+    unsigned long leaked = 0;
+    for (int i = 0; i < 1000; i++) {
+        uint32_t position = 0;
+        uint32_t word = keystream_pool_next(&g_pool, &position);
+        if (word == position) {
+            leaked++;
+        }
+    }
+    keystream_pool_stop(&g_pool);
+    KP_CHECK_EQ(leaked, 0);
+}
+
+static const kp_test_case g_cases[] = {
+    { "kernels_agree", test_kernels_agree },
+    { "pool_positions_regenerate_words", test_pool_positions_regenerate_words },
+    { "fallback_positions_regenerate_words", test_fallback_positions_regenerate_words },
+    { "position_is_not_the_word", test_position_is_not_the_word }
+};
+
+KP_TEST_SUITE(keystream, g_cases);
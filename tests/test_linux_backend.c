@@ -0,0 +1,336 @@
+/**
+ * @file test_linux_backend.c
+ * @brief Linux 백엔드의 키 코드 변환, 가짜 장치(FIFO) 입력 조각 잇기, 출력 묶음 쓰기, 변환 없는 키 차단 테스트
+ * @details 장치 권한 없이 시험하도록 FIFO를 가짜 입력 장치로, 일반 파일을 가짜 출력으로 씁니다.
+ *          Linux 호스트에서만 빌드합니다. (Makefile이 src/linux_backend.c를 함께 링크)
+ */
+#ifdef __linux__
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "kp_test.h"
+#include "linux_backend.h"
+#include "kp_platform.h"
+#include "key_processor.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** @brief 가짜 장치로 보내는 키 수 */
+#define LINUX_TEST_KEYS 40
+
+static linux_input g_input;
+static linux_sink g_sink;
+static struct input_event g_events[LINUX_TEST_KEYS * 2 + 8];
+
+static struct input_event make_event(unsigned short type, unsigned short code, int value) {
+    struct input_event event;
+    memset(&event, 0, sizeof(event));
+    event.type = type;
+    event.code = code;
+    event.value = value;
+    return event;
+}
+
+/**
+ * @brief 출력 파일의 레코드를 읽습니다.
+ * @return size_t 읽은 레코드 수
+ */
+static size_t read_records(const char* path, struct input_event* records, size_t capacity) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return 0;
+    }
+    size_t count = fread(records, sizeof(struct input_event), capacity, file);
+    fclose(file);
+    return count;
+}
+
+static void test_keymap_round_trip(void) {
+    KP_CHECK_EQ(linux_keymap_to_vk(KEY_A), 'A');
+    KP_CHECK_EQ(linux_keymap_from_vk('A'), KEY_A);
+    KP_CHECK_EQ(linux_keymap_to_vk(KEY_F24), 0x87);
+    // 키패드 Enter는 Enter와 같은 가상 키 코드이고, 다시 내보낼 때는 Enter
+    KP_CHECK_EQ(linux_keymap_to_vk(KEY_KPENTER), 0x0D);
+    KP_CHECK_EQ(linux_keymap_from_vk(0x0D), KEY_ENTER);
+
+    unsigned long mapped = 0;
+    unsigned long mismatched = 0;
+    for (unsigned int vk = 1; vk < 256; vk++) {
+        unsigned int code = linux_keymap_from_vk(vk);
+        if (code != 0) {
+            mapped++;
+            if (linux_keymap_to_vk(code) != vk) {
+                mismatched++;
+            }
+        }
+    }
+    KP_CHECK(mapped > 100);
+    KP_CHECK_EQ(mismatched, 0);
+    KP_CHECK_EQ(linux_keymap_to_vk(KEY_MAX), 0);
+    KP_CHECK_EQ(linux_keymap_from_vk(0x100), 0);
+}
+
+static void test_fake_device_joins_split_records(void) {
+    char path[128];
+    snprintf(path, sizeof(path), "/tmp/kp_test_evdev_%lu.fifo", kp_process_id());
+    unlink(path);
+    KP_CHECK(mkfifo(path, 0600) == 0);
+    KP_CHECK(linux_input_init(&g_input));
+    KP_CHECK(linux_input_add_device(&g_input, path, 1));
+    KP_CHECK_EQ(g_input.open_devices, 1);
+    KP_CHECK(g_input.devices[0].fake);
+    KP_CHECK(!g_input.devices[0].grabbed);
+
+    int writer = open(path, O_WRONLY);
+    KP_CHECK(writer >= 0);
+    if (writer < 0) {
+        linux_input_close(&g_input);
+        unlink(path);
+        return;
+    }
+    struct input_event records[LINUX_TEST_KEYS * 2];
+    for (int i = 0; i < LINUX_TEST_KEYS; i++) {
+        records[i * 2] = make_event(EV_KEY, KEY_A + (unsigned short)(i % 10), 1);
+        records[i * 2 + 1] = make_event(EV_SYN, SYN_REPORT, 0);
+    }
+
+    // 레코드 경계가 아닌 곳에서 나누어 씀: 첫 조각 뒤에는 완성된 레코드 하나만 나옴
+    const unsigned char* bytes = (const unsigned char*)records;
+    size_t total = sizeof(records);
+    size_t first = sizeof(struct input_event) + 5;
+    KP_CHECK_EQ(write(writer, bytes, first), first);
+    int count = linux_input_wait(&g_input, g_events, sizeof(g_events) / sizeof(g_events[0]), 1000, NULL);
+    KP_CHECK_EQ(count, 1);
+    KP_CHECK_EQ(g_input.devices[0].partial, 5);
+    KP_CHECK_EQ(g_events[0].code, KEY_A);
+
+    KP_CHECK_EQ(write(writer, bytes + first, total - first), total - first);
+    count = linux_input_wait(&g_input, g_events, sizeof(g_events) / sizeof(g_events[0]), 1000, NULL);
+    KP_CHECK_EQ(count, LINUX_TEST_KEYS * 2 - 1);
+    KP_CHECK_EQ(g_input.devices[0].partial, 0);
+    unsigned long wrong = 0;
+    for (int i = 0; i < count; i++) {
+        const struct input_event* expected = &records[i + 1];
+        if (g_events[i].type != expected->type || g_events[i].code != expected->code ||
+            g_events[i].value != expected->value) {
+            wrong++;
+        }
+    }
+    KP_CHECK_EQ(wrong, 0);
+    KP_CHECK_EQ(g_input.events, LINUX_TEST_KEYS * 2);
+    KP_CHECK_EQ(g_input.wakeups, 2);
+
+    // 쓰는 쪽이 닫으면 장치를 닫고 입력 끝
+    close(writer);
+    count = linux_input_wait(&g_input, g_events, sizeof(g_events) / sizeof(g_events[0]), 1000, NULL);
+    KP_CHECK_EQ(count, 0);
+    KP_CHECK_EQ(g_input.open_devices, 0);
+    KP_CHECK(g_input.devices[0].fd < 0);
+
+    linux_input_close(&g_input);
+    unlink(path);
+}
+
+static void test_watch_fd_reported(void) {
+    int pipe_fds[2];
+    KP_CHECK(pipe(pipe_fds) == 0);
+    KP_CHECK(linux_input_init(&g_input));
+    KP_CHECK(linux_input_watch(&g_input, pipe_fds[0]));
+
+    int watch_ready = 1;
+    KP_CHECK_EQ(linux_input_wait(&g_input, g_events, 4, 0, &watch_ready), 0);
+    KP_CHECK_EQ(watch_ready, 0);
+    KP_CHECK_EQ(write(pipe_fds[1], "x", 1), 1);
+    KP_CHECK_EQ(linux_input_wait(&g_input, g_events, 4, 1000, &watch_ready), 0);
+    KP_CHECK_EQ(watch_ready, 1);
+
+    linux_input_close(&g_input);
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
+
+static void test_sink_batches_and_releases(void) {
+    char path[128];
+    snprintf(path, sizeof(path), "/tmp/kp_test_sink_%lu.bin", kp_process_id());
+    KP_CHECK(linux_sink_open_file(&g_sink, path));
+    if (g_sink.fd < 0) {
+        return;
+    }
+    // 같은 키의 두 번째 키 다운은 자동 반복(값 2), 프레임마다 SYN_REPORT 하나
+    KP_CHECK(linux_sink_key(&g_sink, KEY_A, 1));
+    linux_sink_sync(&g_sink);
+    KP_CHECK(linux_sink_key(&g_sink, KEY_A, 1));
+    KP_CHECK(linux_sink_key(&g_sink, KEY_LEFTSHIFT, 1));
+    linux_sink_sync(&g_sink);
+    linux_sink_sync(&g_sink);
+    KP_CHECK(!linux_sink_key(&g_sink, 0, 1));
+    KP_CHECK(!linux_sink_key(&g_sink, LINUX_SINK_KEYS, 1));
+    KP_CHECK_EQ(g_sink.writes, 0);
+    KP_CHECK(linux_sink_flush(&g_sink));
+    KP_CHECK_EQ(g_sink.writes, 1);
+    KP_CHECK_EQ(g_sink.keys, 3);
+
+    struct input_event records[16];
+    KP_CHECK_EQ(read_records(path, records, 16), 5);
+    KP_CHECK_EQ(records[0].value, 1);
+    KP_CHECK_EQ(records[1].type, EV_SYN);
+    KP_CHECK_EQ(records[2].code, KEY_A);
+    KP_CHECK_EQ(records[2].value, 2);
+    KP_CHECK_EQ(records[3].code, KEY_LEFTSHIFT);
+    KP_CHECK_EQ(records[4].type, EV_SYN);
+
+    // 닫을 때 눌린 채 남은 키를 모두 뗌
+    linux_sink_close(&g_sink);
+    size_t count = read_records(path, records, 16);
+    KP_CHECK_EQ(count, 8);
+    unsigned long releases = 0;
+    for (size_t i = 5; i < count; i++) {
+        if (records[i].type == EV_KEY && records[i].value == 0) {
+            releases++;
+        }
+    }
+    KP_CHECK_EQ(releases, 2);
+    KP_CHECK_EQ(records[count - 1].type, EV_SYN);
+    remove(path);
+}
+
+static void test_sink_flushes_when_full(void) {
+    char path[128];
+    snprintf(path, sizeof(path), "/tmp/kp_test_sink_full_%lu.bin", kp_process_id());
+    KP_CHECK(linux_sink_open_file(&g_sink, path));
+    if (g_sink.fd < 0) {
+        return;
+    }
+    for (int i = 0; i < LINUX_SINK_BATCH + 10; i++) {
+        KP_CHECK(linux_sink_key(&g_sink, KEY_B, i & 1));
+    }
+    // 버퍼가 가득 찬 순간 한 번 씀
+    KP_CHECK_EQ(g_sink.writes, 1);
+    KP_CHECK_EQ(g_sink.count, 10);
+    linux_sink_close(&g_sink);
+    KP_CHECK_EQ(g_sink.writes, 2);
+    KP_CHECK_EQ(g_sink.errors, 0);
+    remove(path);
+}
+
+static int blocked_get_foreground(void* context, foreground_identity* identity) {
+    (void)context;
+    identity->window = 0x100;
+    identity->process_id = 7;
+    identity->start_time = 1;
+    return 1;
+}
+
+static int blocked_get_process_name(void* context, const foreground_identity* identity, char* name, size_t name_size) {
+    (void)context;
+    (void)identity;
+    snprintf(name, name_size, "%s", "malware");
+    return 1;
+}
+
+static int block_all(const char* process_name, void* user) {
+    (void)process_name;
+    (void)user;
+    return 0;
+}
+
+static unsigned int counter_salt(void* context, unsigned int* pad) {
+    unsigned int* counter = (unsigned int*)context;
+    ++*counter;
+    *pad = *counter * 2654435761U;
+    return *counter;
+}
+
+static int sink_inject(void* context, unsigned int vk_code, int key_down) {
+    (void)context;
+    return linux_sink_key(&g_sink, linux_keymap_from_vk(vk_code), key_down);
+}
+
+static void test_unmapped_keys_blocked(void) {
+    // 문자를 입력할 수 있는 변환 없는 키는 차단, 전원/밝기/미디어 키만 통과
+    KP_CHECK(!linux_keymap_passthrough(KEY_YEN));
+    KP_CHECK(!linux_keymap_passthrough(KEY_RO));
+    KP_CHECK(!linux_keymap_passthrough(KEY_KPEQUAL));
+    KP_CHECK(!linux_keymap_passthrough(KEY_KPCOMMA));
+    KP_CHECK(!linux_keymap_passthrough(KEY_KPJPCOMMA));
+    KP_CHECK(!linux_keymap_passthrough(KEY_HENKAN));
+    KP_CHECK(!linux_keymap_passthrough(KEY_MUHENKAN));
+    KP_CHECK(!linux_keymap_passthrough(KEY_KATAKANA));
+    KP_CHECK(linux_keymap_passthrough(KEY_BRIGHTNESSUP));
+    KP_CHECK(linux_keymap_passthrough(KEY_PLAYPAUSE));
+    // 통과 목록의 키는 가상 키 코드가 없어야 판정 경로와 겹치지 않음
+    KP_CHECK_EQ(linux_keymap_to_vk(KEY_BRIGHTNESSUP), 0);
+    KP_CHECK_EQ(linux_keymap_to_vk(KEY_YEN), 0);
+
+    char path[128];
+    snprintf(path, sizeof(path), "/tmp/kp_test_unmapped_%lu.bin", kp_process_id());
+    KP_CHECK(linux_sink_open_file(&g_sink, path));
+    if (g_sink.fd < 0) {
+        return;
+    }
+    static const process_lookup_provider provider = { NULL, blocked_get_foreground, blocked_get_process_name };
+    static foreground_cache cache;
+    static key_processor processor;
+    unsigned int salt_counter = 0;
+    key_processor_backend backend = { &salt_counter, counter_salt, sink_inject, NULL };
+    foreground_cache_init(&cache, &provider, block_all, NULL);
+    key_processor_init(&processor, &cache, &backend, NULL);
+
+    // linux_main의 process_batch와 같은 분기: 변환되는 키는 처리 코어로, 변환 없는 키는 통과 목록 확인
+    static const unsigned short codes[] = { KEY_A, KEY_YEN, KEY_KPEQUAL, KEY_HENKAN, KEY_BRIGHTNESSUP };
+    unsigned long passed = 0;
+    for (size_t i = 0; i < sizeof(codes) / sizeof(codes[0]); i++) {
+        for (int down = 1; down >= 0; down--) {
+            unsigned int vk_code = linux_keymap_to_vk(codes[i]);
+            if (vk_code == 0) {
+                passed += (unsigned long)linux_sink_unmapped_key(&g_sink, codes[i], down);
+                continue;
+            }
+            key_event event;
+            memset(&event, 0, sizeof(event));
+            event.vk_code = vk_code;
+            event.message = down ? KEY_MESSAGE_KEYDOWN : KEY_MESSAGE_KEYUP;
+            KP_CHECK_EQ(key_processor_handle(&processor, &event, NULL), FOREGROUND_BLOCKED);
+        }
+        linux_sink_sync(&g_sink);
+    }
+    linux_sink_close(&g_sink);
+
+    // 차단된 포그라운드에서는 밝기 키의 다운/업만 출력에 닿음
+    KP_CHECK_EQ(passed, 2);
+    KP_CHECK_EQ(processor.injected, 0);
+    struct input_event records[16];
+    size_t count = read_records(path, records, 16);
+    unsigned long leaked = 0;
+    unsigned long brightness = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (records[i].type != EV_KEY) {
+            continue;
+        }
+        if (records[i].code == KEY_BRIGHTNESSUP) {
+            brightness++;
+        } else {
+            leaked++;
+        }
+    }
+    KP_CHECK_EQ(leaked, 0);
+    KP_CHECK_EQ(brightness, 2);
+    remove(path);
+}
+
+static const kp_test_case g_cases[] = {
+    { "keymap_round_trip", test_keymap_round_trip },
+    { "fake_device_joins_split_records", test_fake_device_joins_split_records },
+    { "watch_fd_reported", test_watch_fd_reported },
+    { "sink_batches_and_releases", test_sink_batches_and_releases },
+    { "sink_flushes_when_full", test_sink_flushes_when_full },
+    { "unmapped_keys_blocked", test_unmapped_keys_blocked }
+};
+
+KP_TEST_SUITE(linux_backend, g_cases);
+
+#endif // __linux__
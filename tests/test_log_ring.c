@@ -0,0 +1,278 @@
+/**
+ * @file test_log_ring.c
+ * @brief SPSC 링의 인덱스 되감기/가득 참과 로그 링의 손실 카운터, 상세 수준별 기록 테스트
+ */
+#include "kp_test.h"
+#include "spsc_ring.h"
+#include "log_ring.h"
+#include "kp_platform.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+/** @brief 테스트 링 용량 (2의 거듭제곱) */
+#define RING_TEST_CAPACITY 4
+
+/** @brief 스레드 간 전달 테스트에서 넘기는 값의 수 */
+#define RING_TEST_TRANSFERS 200000UL
+
+/** @brief 로그 링은 크므로 정적 공간에 둠 */
+static log_ring g_log;
+
+static void test_init_rejects_bad_capacity(void) {
+    spsc_ring ring;
+    unsigned int storage[8];
+    KP_CHECK(!spsc_ring_init(&ring, storage, sizeof(storage[0]), 0));
+    KP_CHECK(!spsc_ring_init(&ring, storage, sizeof(storage[0]), 6));
+    KP_CHECK(!spsc_ring_init(&ring, storage, 0, 8));
+    KP_CHECK(spsc_ring_init(&ring, storage, sizeof(storage[0]), 8));
+    KP_CHECK_EQ(spsc_ring_capacity(&ring), 8);
+    KP_CHECK_EQ(spsc_ring_size(&ring), 0);
+}
+
+static void test_full_ring_rejects_push(void) {
+    spsc_ring ring;
+    unsigned int storage[RING_TEST_CAPACITY];
+    unsigned int value = 0;
+    KP_CHECK(spsc_ring_init(&ring, storage, sizeof(storage[0]), RING_TEST_CAPACITY));
+    KP_CHECK(!spsc_ring_pop(&ring, &value));
+
+    for (unsigned int i = 0; i < RING_TEST_CAPACITY; i++) {
+        KP_CHECK(spsc_ring_push(&ring, &i));
+    }
+    KP_CHECK_EQ(spsc_ring_size(&ring), RING_TEST_CAPACITY);
+    // 가득 차면 덮어쓰지 않고 거부
+    value = 99;
+    KP_CHECK(!spsc_ring_push(&ring, &value));
+
+    // 하나를 꺼내면 다시 한 칸이 생김
+    KP_CHECK(spsc_ring_pop(&ring, &value));
+    KP_CHECK_EQ(value, 0);
+    value = 4;
+    KP_CHECK(spsc_ring_push(&ring, &value));
+    for (unsigned int i = 1; i <= RING_TEST_CAPACITY; i++) {
+        KP_CHECK(spsc_ring_pop(&ring, &value));
+        KP_CHECK_EQ(value, i);
+    }
+    KP_CHECK(!spsc_ring_pop(&ring, &value));
+}
+
+static void test_wraparound_keeps_order(void) {
+    spsc_ring ring;
+    unsigned int storage[RING_TEST_CAPACITY];
+    KP_CHECK(spsc_ring_init(&ring, storage, sizeof(storage[0]), RING_TEST_CAPACITY));
+
+    // 용량과 서로소인 묶음 크기로 저장 공간 끝을 여러 번 넘김
+    unsigned int next_push = 0;
+    unsigned int next_pop = 0;
+    for (int round = 0; round < 50; round++) {
+        for (int i = 0; i < 3; i++) {
+            KP_CHECK(spsc_ring_push(&ring, &next_push));
+            next_push++;
+        }
+        for (int i = 0; i < 3; i++) {
+            unsigned int value = 0;
+            KP_CHECK(spsc_ring_pop(&ring, &value));
+            KP_CHECK_EQ(value, next_pop);
+            next_pop++;
+        }
+    }
+    KP_CHECK_EQ(spsc_ring_size(&ring), 0);
+}
+
+static void test_index_counter_overflow(void) {
+    spsc_ring ring;
+    unsigned int storage[RING_TEST_CAPACITY];
+    KP_CHECK(spsc_ring_init(&ring, storage, sizeof(storage[0]), RING_TEST_CAPACITY));
+    // 오래 돈 링처럼 인덱스를 unsigned long 최댓값 근처로 옮김
+    ring.head = ring.cached_head = ULONG_MAX - 1;
+    ring.tail = ring.cached_tail = ULONG_MAX - 1;
+
+    for (unsigned int i = 0; i < RING_TEST_CAPACITY; i++) {
+        KP_CHECK(spsc_ring_push(&ring, &i));
+    }
+    KP_CHECK_EQ(spsc_ring_size(&ring), RING_TEST_CAPACITY);
+    unsigned int value = 99;
+    KP_CHECK(!spsc_ring_push(&ring, &value));
+    for (unsigned int i = 0; i < RING_TEST_CAPACITY; i++) {
+        KP_CHECK(spsc_ring_pop(&ring, &value));
+        KP_CHECK_EQ(value, i);
+    }
+    KP_CHECK(!spsc_ring_pop(&ring, &value));
+    KP_CHECK_EQ(ring.tail, 2);
+}
+
+/**
+ * @brief 스레드 간 전달 테스트 상태
+ */
+typedef struct transfer_state {
+    spsc_ring ring;                            /**< 전달 링 */
+    unsigned long storage[RING_TEST_CAPACITY]; /**< 링 저장 공간 */
+    unsigned long received;                    /**< 소비자가 받은 수 */
+    unsigned long out_of_order;                /**< 순서가 어긋난 수 */
+} transfer_state;
+
+static void consumer_thread(void* arg) {
+    transfer_state* state = (transfer_state*)arg;
+    while (state->received < RING_TEST_TRANSFERS) {
+        unsigned long value;
+        if (!spsc_ring_pop(&state->ring, &value)) {
+            kp_sleep_ms(0);
+            continue;
+        }
+        if (value != state->received) {
+            state->out_of_order++;
+        }
+        state->received++;
+    }
+}
+
+static void test_threads_transfer_in_order(void) {
+    static transfer_state state;
+    memset(&state, 0, sizeof(state));
+    KP_CHECK(spsc_ring_init(&state.ring, state.storage, sizeof(state.storage[0]), RING_TEST_CAPACITY));
+
+    kp_thread thread;
+    KP_CHECK(kp_thread_start(&thread, consumer_thread, &state));
+    for (unsigned long i = 0; i < RING_TEST_TRANSFERS; i++) {
+        while (!spsc_ring_push(&state.ring, &i)) {
+            kp_sleep_ms(0);
+        }
+    }
+    kp_thread_join(&thread);
+    KP_CHECK_EQ(state.received, RING_TEST_TRANSFERS);
+    KP_CHECK_EQ(state.out_of_order, 0);
+}
+
+/**
+ * @brief 후크 쪽 기록 경로처럼 상세 수준을 확인한 뒤에만 레코드를 씁니다.
+ * @return int 기록했으면 1
+ */
+static int log_if_wanted(int verdict, unsigned short vk_code) {
+    if (!log_ring_wants(&g_log, verdict)) {
+        return 0;
+    }
+    log_record record;
+    memset(&record, 0, sizeof(record));
+    record.vk_code = vk_code;
+    record.verdict = (unsigned char)verdict;
+    record.name_id = LOG_NAME_NONE;
+    return log_ring_write(&g_log, &record);
+}
+
+/**
+ * @brief 드레인 출력을 임시 파일에 받아 버퍼로 읽어 옵니다.
+ * @return unsigned long 드레인이 처리한 레코드 수
+ */
+static unsigned long drain_text(char* text, size_t size) {
+    text[0] = '\0';
+    FILE* out = tmpfile();
+    if (out == NULL) {
+        return 0;
+    }
+    unsigned long processed = log_ring_drain(&g_log, out, 0);
+    rewind(out);
+    size_t length = fread(text, 1, size - 1, out);
+    text[length] = '\0';
+    fclose(out);
+    return processed;
+}
+
+static void test_verbosity_selects_records(void) {
+    char text[512];
+    log_ring_init(&g_log, LOG_VERBOSITY_OFF);
+    // 0이면 어떤 판정도 기록하지 않음
+    KP_CHECK(!log_if_wanted(LOG_VERDICT_ALLOWED, 'A'));
+    KP_CHECK(!log_if_wanted(LOG_VERDICT_BLOCKED, 'B'));
+    KP_CHECK(!log_if_wanted(LOG_VERDICT_UNKNOWN, 'C'));
+    KP_CHECK_EQ(spsc_ring_size(&g_log.ring), 0);
+    KP_CHECK_EQ(drain_text(text, sizeof(text)), 0);
+    KP_CHECK(text[0] == '\0');
+
+    // 1이면 차단과 조회 실패만
+    log_ring_set_verbosity(&g_log, LOG_VERBOSITY_BLOCKED);
+    KP_CHECK(!log_if_wanted(LOG_VERDICT_ALLOWED, 'A'));
+    KP_CHECK(log_if_wanted(LOG_VERDICT_BLOCKED, 'B'));
+    KP_CHECK(log_if_wanted(LOG_VERDICT_UNKNOWN, 'C'));
+    KP_CHECK_EQ(drain_text(text, sizeof(text)), 2);
+    KP_CHECK(strstr(text, "[차단]") != NULL);
+    KP_CHECK(strstr(text, "[복호화]") == NULL);
+
+    // 2이면 모두
+    log_ring_set_verbosity(&g_log, LOG_VERBOSITY_ALL);
+    KP_CHECK(log_if_wanted(LOG_VERDICT_ALLOWED, 'A'));
+    KP_CHECK_EQ(drain_text(text, sizeof(text)), 1);
+    KP_CHECK(strstr(text, "[복호화]") != NULL);
+}
+
+static void test_full_ring_counts_drops(void) {
+    char text[512];
+    log_ring_init(&g_log, LOG_VERBOSITY_ALL);
+    for (unsigned int i = 0; i < LOG_RING_CAPACITY; i++) {
+        KP_CHECK(log_if_wanted(LOG_VERDICT_BLOCKED, (unsigned short)i));
+    }
+    // 가득 찬 뒤의 기록은 버리고 세기만 함
+    for (int i = 0; i < 5; i++) {
+        KP_CHECK(!log_if_wanted(LOG_VERDICT_BLOCKED, 0));
+    }
+    KP_CHECK_EQ(g_log.dropped, 5);
+    KP_CHECK_EQ(spsc_ring_size(&g_log.ring), LOG_RING_CAPACITY);
+
+    // 드레인은 손실을 한 번 보고하고, 새 손실이 없으면 다시 보고하지 않음
+    FILE* out = tmpfile();
+    KP_CHECK(out != NULL);
+    if (out != NULL) {
+        KP_CHECK_EQ(log_ring_drain(&g_log, out, 1), LOG_RING_CAPACITY);
+        fclose(out);
+    }
+    KP_CHECK_EQ(g_log.reported_dropped, 5);
+    KP_CHECK_EQ(drain_text(text, sizeof(text)), 0);
+    KP_CHECK(text[0] == '\0');
+
+    KP_CHECK(log_if_wanted(LOG_VERDICT_BLOCKED, 'X'));
+    KP_CHECK_EQ(g_log.dropped, 5);
+    KP_CHECK_EQ(drain_text(text, sizeof(text)), 1);
+    KP_CHECK(strstr(text, "누락") == NULL);
+}
+
+static void test_drop_report_counts_only_new(void) {
+    char text[512];
+    log_ring_init(&g_log, LOG_VERBOSITY_ALL);
+    g_log.dropped = 7;
+    g_log.reported_dropped = 4;
+    KP_CHECK_EQ(drain_text(text, sizeof(text)), 0);
+    KP_CHECK(strstr(text, "3개의 기록이 누락") != NULL);
+    KP_CHECK_EQ(g_log.reported_dropped, 7);
+}
+
+static void test_intern_names(void) {
+    char text[512];
+    log_ring_init(&g_log, LOG_VERBOSITY_ALL);
+    KP_CHECK_EQ(log_ring_intern_name(&g_log, "notepad.exe"), 0);
+    KP_CHECK_EQ(log_ring_intern_name(&g_log, "code.exe"), 1);
+    KP_CHECK_EQ(log_ring_intern_name(&g_log, "notepad.exe"), 0);
+    KP_CHECK_EQ(log_ring_intern_name(&g_log, NULL), LOG_NAME_NONE);
+
+    log_record record;
+    memset(&record, 0, sizeof(record));
+    record.verdict = LOG_VERDICT_BLOCKED;
+    record.name_id = 1;
+    KP_CHECK(log_ring_write(&g_log, &record));
+    KP_CHECK_EQ(drain_text(text, sizeof(text)), 1);
+    KP_CHECK(strstr(text, "code.exe") != NULL);
+}
+
+static const kp_test_case g_cases[] = {
+    { "init_rejects_bad_capacity", test_init_rejects_bad_capacity },
+    { "full_ring_rejects_push", test_full_ring_rejects_push },
+    { "wraparound_keeps_order", test_wraparound_keeps_order },
+    { "index_counter_overflow", test_index_counter_overflow },
+    { "threads_transfer_in_order", test_threads_transfer_in_order },
+    { "verbosity_selects_records", test_verbosity_selects_records },
+    { "full_ring_counts_drops", test_full_ring_counts_drops },
+    { "drop_report_counts_only_new", test_drop_report_counts_only_new },
+    { "intern_names", test_intern_names }
+};
+
+KP_TEST_SUITE(log_ring, g_cases);
@@ -0,0 +1,141 @@
+/**
+ * @file test_main.c
+ * @brief 플랫폼 독립 코어 단위 테스트 러너
+ * @details libkpcore를 가짜 백엔드(포그라운드 공급자, 솔트, 주입)로 구동하여 검사합니다.
+ *          Win32 API를 쓰지 않으므로 Linux 빌드 환경에서 make test로 실행하며, 실패한 검사가 하나라도 있으면
+ *          종료 코드 1을 반환합니다.
+ *
+ *          사용법:
+ *            kp_test [--filter <이름 일부>] [--list]
+ *
+ *          테스트 이름은 "<스위트>/<테스트>" 형식이며, --filter는 이 이름의 일부와 비교합니다.
+ */
+#include "kp_test.h"
+#include "policy_loader.h"
+
+#include <stdio.h>
+#include <string.h>
+
+extern const kp_test_suite kp_suite_processor;
+extern const kp_test_suite kp_suite_foreground_cache;
+extern const kp_test_suite kp_suite_pipeline;
+extern const kp_test_suite kp_suite_keystream;
+extern const kp_test_suite kp_suite_stats_block;
+extern const kp_test_suite kp_suite_journal;
+extern const kp_test_suite kp_suite_key_policy;
+extern const kp_test_suite kp_suite_delivery;
+extern const kp_test_suite kp_suite_governor;
+extern const kp_test_suite kp_suite_shadow_audit;
+extern const kp_test_suite kp_suite_device_table;
+extern const kp_test_suite kp_suite_input_correlator;
+extern const kp_test_suite kp_suite_inject_batch;
+extern const kp_test_suite kp_suite_policy_store;
+extern const kp_test_suite kp_suite_ini_parser;
+extern const kp_test_suite kp_suite_log_ring;
+#ifdef __linux__
+extern const kp_test_suite kp_suite_linux_backend;
+#endif
+
+/**
+ * @brief 실행할 스위트 목록 (테스트 파일을 추가하면 여기에도 추가)
+ */
+static const kp_test_suite* const g_suites[] = {
+    &kp_suite_processor,
+    &kp_suite_foreground_cache,
+    &kp_suite_pipeline,
+    &kp_suite_keystream,
+    &kp_suite_stats_block,
+    &kp_suite_journal,
+    &kp_suite_key_policy,
+    &kp_suite_delivery,
+    &kp_suite_governor,
+    &kp_suite_shadow_audit,
+    &kp_suite_device_table,
+    &kp_suite_input_correlator,
+    &kp_suite_inject_batch,
+    &kp_suite_policy_store,
+    &kp_suite_ini_parser,
+    &kp_suite_log_ring,
+#ifdef __linux__
+    &kp_suite_linux_backend,
+#endif
+};
+
+/** @brief 현재 테스트에서 실패한 검사 수 */
+static unsigned long g_case_failures;
+
+/** @brief 현재 테스트 이름 */
+static char g_case_name[128];
+
+/**
+ * @brief 검사 실패를 기록합니다.
+ */
+void kp_test_fail(const char* file, int line, const char* expression) {
+    g_case_failures++;
+    printf("  [실패] %s:%d: %s\n", file, line, expression);
+}
+
+/**
+ * @brief 두 정수 값이 다른 검사 실패를 기록합니다.
+ */
+void kp_test_fail_values(const char* file, int line, const char* expression,
+                         unsigned long long actual, unsigned long long expected) {
+    g_case_failures++;
+    printf("  [실패] %s:%d: %s (실제 %llu, 기대 %llu)\n", file, line, expression, actual, expected);
+}
+
+/**
+ * @brief 사용법을 출력합니다.
+ */
+static void print_usage(const char* program) {
+    fprintf(stderr, "사용법: %s [--filter <이름 일부>] [--list]\n", program);
+}
+
+int main(int argc, char* argv[]) {
+    const char* filter = NULL;
+    int list_only = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--list") == 0) {
+            list_only = 1;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    // 정책 로더의 줄 번호 경고는 잘못된 설정을 일부러 넣는 테스트에서 출력을 어지럽히므로 끔
+    policy_load_set_quiet(2);
+
+    unsigned long run = 0;
+    unsigned long failed = 0;
+    for (size_t s = 0; s < sizeof(g_suites) / sizeof(g_suites[0]); s++) {
+        const kp_test_suite* suite = g_suites[s];
+        for (size_t i = 0; i < suite->count; i++) {
+            snprintf(g_case_name, sizeof(g_case_name), "%s/%s", suite->name, suite->cases[i].name);
+            if (filter != NULL && strstr(g_case_name, filter) == NULL) {
+                continue;
+            }
+            if (list_only) {
+                printf("%s\n", g_case_name);
+                continue;
+            }
+            g_case_failures = 0;
+            suite->cases[i].run();
+            run++;
+            if (g_case_failures != 0) {
+                failed++;
+                printf("[실패] %s (검사 %lu개 실패)\n", g_case_name, g_case_failures);
+            } else {
+                printf("[통과] %s\n", g_case_name);
+            }
+            fflush(stdout);
+        }
+    }
+    if (list_only) {
+        return 0;
+    }
+    printf("[테스트] %lu개 실행, %lu개 통과, %lu개 실패\n", run, run - failed, failed);
+    return (failed == 0 && run > 0) ? 0 : 1;
+}
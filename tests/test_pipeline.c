@@ -0,0 +1,126 @@
+/**
+ * @file test_pipeline.c
+ * @brief 후크 → 작업 스레드 파이프라인의 순서 보존, 종료 시 비우기, 깨우기 테스트
+ * @details 테스트 스레드가 후크 역할로 key_pipeline_submit을 호출하고, 처리 함수가 받은 순서를 기록합니다.
+ */
+#include "kp_test.h"
+#include "key_pipeline.h"
+#include "kp_atomic.h"
+
+#include <string.h>
+
+/** @brief 순서 보존 테스트에서 넣는 이벤트 수 (큐 용량보다 많게) */
+#define PIPELINE_TEST_EVENTS 20000
+
+/**
+ * @brief 처리 함수가 기록하는 관측값 (작업 스레드가 쓰고 종료 후 테스트 스레드가 읽음)
+ */
+typedef struct pipeline_observer {
+    unsigned int next_tag;        /**< 다음에 받아야 할 레코드 번호 */
+    unsigned long out_of_order;   /**< 순서가 어긋난 이벤트 수 */
+    unsigned long handled;        /**< 처리한 이벤트 수 */
+    unsigned long idle_calls;     /**< 유휴 처리 함수 호출 수 */
+    unsigned long handled_at_idle; /**< 마지막 유휴 호출 시점의 처리 수 */
+} pipeline_observer;
+
+static key_pipeline g_pipeline;
+static pipeline_observer g_observer;
+
+static void observe_event(const key_event* event, void* user) {
+    pipeline_observer* observer = (pipeline_observer*)user;
+    if (event->tag != observer->next_tag) {
+        observer->out_of_order++;
+    }
+    observer->next_tag = event->tag + 1;
+    observer->handled++;
+}
+
+static void observe_idle(void* user) {
+    pipeline_observer* observer = (pipeline_observer*)user;
+    observer->idle_calls++;
+    observer->handled_at_idle = observer->handled;
+}
+
+/**
+ * @brief 레코드 번호를 붙인 키 이벤트를 큐에 넣습니다. 큐가 가득 차면 빌 때까지 다시 시도합니다.
+ */
+static void submit_tagged(unsigned int tag, int retry) {
+    key_event event;
+    memset(&event, 0, sizeof(event));
+    event.enqueue_ns = kp_now_ns();
+    event.vk_code = 'A' + (tag % 26);
+    event.message = (tag & 1) ? 0x0101 : 0x0100;
+    event.tag = tag;
+    while (!key_pipeline_submit(&g_pipeline, &event) && retry) {
+        kp_sleep_ms(0);
+    }
+}
+
+static int start_pipeline(void) {
+    memset(&g_observer, 0, sizeof(g_observer));
+    return key_pipeline_start(&g_pipeline, observe_event, observe_idle, &g_observer);
+}
+
+static void test_order_preserved_under_backpressure(void) {
+    KP_CHECK(start_pipeline());
+    for (unsigned int i = 0; i < PIPELINE_TEST_EVENTS; i++) {
+        submit_tagged(i, 1);
+    }
+    key_pipeline_stop(&g_pipeline);
+
+    key_pipeline_stats stats;
+    key_pipeline_get_stats(&g_pipeline, &stats);
+    KP_CHECK_EQ(g_observer.handled, PIPELINE_TEST_EVENTS);
+    KP_CHECK_EQ(g_observer.out_of_order, 0);
+    KP_CHECK_EQ(stats.enqueued, PIPELINE_TEST_EVENTS);
+    KP_CHECK_EQ(stats.processed, PIPELINE_TEST_EVENTS);
+    KP_CHECK(stats.max_depth <= KEY_PIPELINE_CAPACITY);
+}
+
+static void test_stop_drains_queue(void) {
+    KP_CHECK(start_pipeline());
+    for (unsigned int i = 0; i < 300; i++) {
+        submit_tagged(i, 0);
+    }
+    key_pipeline_stop(&g_pipeline);
+
+    key_pipeline_stats stats;
+    key_pipeline_get_stats(&g_pipeline, &stats);
+    KP_CHECK_EQ(stats.dropped, 0);
+    KP_CHECK_EQ(g_observer.handled, 300);
+    KP_CHECK_EQ(g_observer.out_of_order, 0);
+    KP_CHECK_EQ(key_pipeline_depth(&g_pipeline), 0);
+    // 종료할 때 남은 이벤트를 처리한 뒤 유휴 처리 함수가 한 번 더 불려 모아 둔 주입을 내보냄
+    KP_CHECK(g_observer.idle_calls >= 1);
+    KP_CHECK_EQ(g_observer.handled_at_idle, 300);
+}
+
+static void test_sleeping_worker_is_woken(void) {
+    KP_CHECK(start_pipeline());
+    // 작업 스레드가 빈 큐에서 잠들 때까지 대기
+    for (int i = 0; i < 1000 && !__atomic_load_n(&g_pipeline.worker_sleeping, __ATOMIC_SEQ_CST); i++) {
+        kp_sleep_ms(1);
+    }
+    KP_CHECK(__atomic_load_n(&g_pipeline.worker_sleeping, __ATOMIC_SEQ_CST));
+    submit_tagged(0, 0);
+
+    key_pipeline_stats stats;
+    for (int i = 0; i < 1000; i++) {
+        key_pipeline_get_stats(&g_pipeline, &stats);
+        if (stats.processed == 1) {
+            break;
+        }
+        kp_sleep_ms(1);
+    }
+    KP_CHECK_EQ(stats.processed, 1);
+    KP_CHECK_EQ(stats.wakeups, 1);
+    key_pipeline_stop(&g_pipeline);
+}
+
+static const kp_test_case g_cases[] = {
+    { "order_preserved_under_backpressure", test_order_preserved_under_backpressure },
+    { "stop_drains_queue", test_stop_drains_queue },
+    { "sleeping_worker_is_woken", test_sleeping_worker_is_woken }
+};
+
+KP_TEST_SUITE(pipeline, g_cases);
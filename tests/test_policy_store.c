@@ -0,0 +1,250 @@
+/**
+ * @file test_policy_store.c
+ * @brief 정책 스냅샷 게시/회수(읽기 세대)와 설정 파일 감시 리로드 테스트
+ * @details 임시 config.ini를 쓰고 바꾸어 파일 감시(stat 비교) → 디바운스 → 로드 → 게시 경로를 스레드 없이
+ *          config_reloader_poll()로 한 주기씩 구동합니다.
+ */
+#include "kp_test.h"
+#include "config_reloader.h"
+#include "policy_loader.h"
+#include "kp_platform.h"
+#include "kp_atomic.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/** @brief 동시 게시 테스트에서 게시하는 스냅샷 수 */
+#define POLICY_TEST_PUBLISHES 2000
+
+static policy_store g_store;
+
+/** @brief 게시 후 콜백이 받은 스냅샷의 순번 */
+static unsigned long g_published_version;
+
+static unsigned long g_published_calls;
+
+static void on_published(const policy_snapshot* snapshot, void* user) {
+    (void)user;
+    g_published_calls++;
+    g_published_version = snapshot->version;
+}
+
+/**
+ * @brief 표시 값(journal_segment_mb)을 가진 빈 스냅샷을 만듭니다.
+ */
+static policy_snapshot* make_snapshot(unsigned long mark) {
+    policy_snapshot* snapshot = policy_snapshot_create();
+    if (snapshot != NULL) {
+        snapshot->journal_segment_mb = mark;
+    }
+    return snapshot;
+}
+
+static int write_file(const char* path, const char* text) {
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        return 0;
+    }
+    fputs(text, file);
+    fclose(file);
+    return 1;
+}
+
+static void test_publish_replaces_current(void) {
+    policy_store_init(&g_store);
+    KP_CHECK(policy_store_enter(&g_store) == NULL);
+    policy_store_exit(&g_store);
+
+    policy_snapshot* first = make_snapshot(1);
+    policy_store_publish(&g_store, first);
+    KP_CHECK(policy_store_current(&g_store) == first);
+    KP_CHECK_EQ(first->version, 1);
+
+    // 읽기 스레드가 유휴 상태면 대체된 스냅샷은 게시하면서 바로 해제
+    policy_snapshot* second = make_snapshot(2);
+    policy_store_publish(&g_store, second);
+    KP_CHECK(policy_store_current(&g_store) == second);
+    KP_CHECK_EQ(second->version, 2);
+    KP_CHECK_EQ(g_store.retired_count, 0);
+
+    // NULL 게시는 정책을 비움
+    policy_store_publish(&g_store, NULL);
+    KP_CHECK(policy_store_current(&g_store) == NULL);
+    KP_CHECK_EQ(g_store.epoch, 3);
+    policy_store_destroy(&g_store);
+}
+
+static void test_retired_kept_until_reader_moves_on(void) {
+    policy_store_init(&g_store);
+    policy_store_publish(&g_store, make_snapshot(10));
+
+    // 읽기 스레드가 세대 1에서 스냅샷을 참조하는 동안 새 게시가 두 번 일어남
+    policy_snapshot* held = policy_store_enter(&g_store);
+    KP_CHECK(held != NULL);
+    policy_store_publish(&g_store, make_snapshot(11));
+    policy_store_publish(&g_store, make_snapshot(12));
+    KP_CHECK_EQ(g_store.retired_count, 2);
+    KP_CHECK_EQ(policy_store_reclaim(&g_store), 2);
+    // 참조 중인 스냅샷은 아직 살아 있음
+    KP_CHECK_EQ(held->journal_segment_mb, 10);
+
+    // 새 세대로 다시 진입하면 그 전 세대에 대체된 스냅샷은 모두 해제 가능
+    policy_store_exit(&g_store);
+    policy_snapshot* now = policy_store_enter(&g_store);
+    KP_CHECK_EQ(now->journal_segment_mb, 12);
+    KP_CHECK_EQ(policy_store_reclaim(&g_store), 0);
+    KP_CHECK_EQ(g_store.retired_count, 0);
+
+    // 현재 세대에 머무는 동안 게시된 것은 다시 대기
+    policy_store_publish(&g_store, make_snapshot(13));
+    KP_CHECK_EQ(g_store.retired_count, 1);
+    KP_CHECK_EQ(now->journal_segment_mb, 12);
+    policy_store_exit(&g_store);
+    KP_CHECK_EQ(policy_store_reclaim(&g_store), 0);
+    policy_store_destroy(&g_store);
+}
+
+/**
+ * @brief 동시 게시 테스트의 읽기 스레드 상태
+ */
+typedef struct reader_state {
+    volatile int stop;          /**< 종료 요청 */
+    unsigned long reads;        /**< 진입 횟수 */
+    unsigned long torn;         /**< 순번과 표시 값이 어긋난 스냅샷 수 */
+    unsigned long backwards;    /**< 순번이 거꾸로 간 횟수 */
+} reader_state;
+
+static void reader_thread(void* arg) {
+    reader_state* state = (reader_state*)arg;
+    unsigned long last = 0;
+    while (!state->stop) {
+        policy_snapshot* snapshot = policy_store_enter(&g_store);
+        if (snapshot != NULL) {
+            // 게시 전에 채운 값과 게시 순번이 항상 함께 보여야 함
+            if (snapshot->journal_segment_mb != snapshot->version) {
+                state->torn++;
+            }
+            if (snapshot->version < last) {
+                state->backwards++;
+            }
+            last = snapshot->version;
+        }
+        policy_store_exit(&g_store);
+        kp_atomic_add_relaxed(&state->reads, 1);
+    }
+}
+
+static void test_concurrent_publish_is_atomic(void) {
+    policy_store_init(&g_store);
+    reader_state state;
+    memset(&state, 0, sizeof(state));
+    kp_thread thread;
+    KP_CHECK(kp_thread_start(&thread, reader_thread, &state));
+    // 읽기 스레드가 돌기 시작한 뒤에 게시
+    while (kp_atomic_load(&state.reads) == 0) {
+        kp_sleep_ms(0);
+    }
+
+    for (unsigned long i = 1; i <= POLICY_TEST_PUBLISHES; i++) {
+        policy_store_publish(&g_store, make_snapshot(i));
+        KP_CHECK(g_store.retired_count <= POLICY_RETIRE_SLOTS);
+    }
+    state.stop = 1;
+    kp_thread_join(&thread);
+
+    KP_CHECK_EQ(state.torn, 0);
+    KP_CHECK_EQ(state.backwards, 0);
+    KP_CHECK(state.reads > 0);
+    KP_CHECK_EQ(policy_store_current(&g_store)->version, POLICY_TEST_PUBLISHES);
+    KP_CHECK_EQ(policy_store_reclaim(&g_store), 0);
+    policy_store_destroy(&g_store);
+}
+
+static void test_reloader_publishes_changed_file(void) {
+    char path[128];
+    snprintf(path, sizeof(path), "/tmp/kp_test_config_%lu.ini", kp_process_id());
+    KP_CHECK(write_file(path, "[AllowedProcesses]\nProcess1=notepad.exe\n"));
+    policy_load_set_quiet(2);
+
+    policy_store_init(&g_store);
+    policy_load_status status = POLICY_LOAD_MISSING;
+    policy_store_publish(&g_store, policy_load_file(path, &status));
+    KP_CHECK_EQ(status, POLICY_LOAD_OK);
+    policy_snapshot* before = policy_store_current(&g_store);
+
+    config_reloader reloader;
+    g_published_calls = 0;
+    KP_CHECK(config_reloader_init(&reloader, path, &g_store, config_reloader_load_file, on_published, NULL));
+    // 바뀌지 않았으면 게시하지 않음
+    KP_CHECK_EQ(config_reloader_poll(&reloader, 0), 0);
+    KP_CHECK(policy_store_current(&g_store) == before);
+
+    // 크기가 바뀌도록 항목을 추가하면 다음 주기에 새 스냅샷 게시
+    KP_CHECK(write_file(path, "[AllowedProcesses]\nProcess1=notepad.exe\nProcess2=putty.exe\n"
+                              "[KeyPolicy]\nExitKey=f12\n"));
+    KP_CHECK_EQ(config_reloader_poll(&reloader, 0), 1);
+    policy_snapshot* after = policy_store_current(&g_store);
+    KP_CHECK(after != before);
+    KP_CHECK(after != NULL && allowlist_value(&after->allowed, "putty.exe") != 0);
+    KP_CHECK(after != NULL && after->exit_key == 0x7B);
+    KP_CHECK_EQ(reloader.reloads, 1);
+    KP_CHECK_EQ(g_published_calls, 1);
+    KP_CHECK_EQ(g_published_version, after->version);
+    // 처리한 변경은 다시 보고하지 않음
+    KP_CHECK_EQ(config_reloader_poll(&reloader, 0), 0);
+
+    // 파일이 사라지면 기본 정책으로 되돌리지 않고 기존 스냅샷 유지
+    remove(path);
+    KP_CHECK_EQ(config_reloader_poll(&reloader, 0), -1);
+    KP_CHECK(policy_store_current(&g_store) == after);
+    KP_CHECK_EQ(reloader.failures, 1);
+    KP_CHECK_EQ(g_published_calls, 1);
+
+    // 다시 생기면 게시
+    KP_CHECK(write_file(path, "[AllowedProcesses]\nProcess1=code.exe\n"));
+    KP_CHECK_EQ(config_reloader_poll(&reloader, 0), 1);
+    KP_CHECK(allowlist_value(&policy_store_current(&g_store)->allowed, "code.exe") != 0);
+    KP_CHECK(allowlist_value(&policy_store_current(&g_store)->allowed, "putty.exe") == 0);
+
+    file_watch_close(&reloader.watch);
+    policy_store_destroy(&g_store);
+    policy_load_set_quiet(0);
+    remove(path);
+}
+
+/**
+ * @brief 항상 실패하는 로드 콜백 (메모리 부족 등)
+ */
+static policy_snapshot* failing_load(const char* path, void* user) {
+    (void)path;
+    (*(unsigned long*)user)++;
+    return NULL;
+}
+
+static void test_failed_reload_keeps_old_snapshot(void) {
+    policy_store_init(&g_store);
+    policy_snapshot* old = make_snapshot(1);
+    policy_store_publish(&g_store, old);
+
+    unsigned long calls = 0;
+    config_reloader reloader;
+    KP_CHECK(config_reloader_init(&reloader, "/nonexistent/kp_config.ini", &g_store, failing_load, NULL, &calls));
+    KP_CHECK_EQ(config_reloader_reload(&reloader), -1);
+    KP_CHECK_EQ(calls, 1);
+    KP_CHECK(policy_store_current(&g_store) == old);
+    KP_CHECK_EQ(g_store.epoch, 1);
+    KP_CHECK_EQ(reloader.failures, 1);
+
+    file_watch_close(&reloader.watch);
+    policy_store_destroy(&g_store);
+}
+
+static const kp_test_case g_cases[] = {
+    { "publish_replaces_current", test_publish_replaces_current },
+    { "retired_kept_until_reader_moves_on", test_retired_kept_until_reader_moves_on },
+    { "concurrent_publish_is_atomic", test_concurrent_publish_is_atomic },
+    { "reloader_publishes_changed_file", test_reloader_publishes_changed_file },
+    { "failed_reload_keeps_old_snapshot", test_failed_reload_keeps_old_snapshot }
+};
+
+KP_TEST_SUITE(policy_store, g_cases);
@@ -0,0 +1,291 @@
+/**
+ * @file test_processor.c
+ * @brief 처리 코어 키 다운/업 경로와 자동 반복 빠른 경로 테스트 (가짜 포그라운드 공급자와 주입 기록)
+ */
+#include "kp_test.h"
+#include "key_processor.h"
+#include "crypto_keycode.h"
+#include "log_ring.h"
+
+#include <string.h>
+
+/** @brief 기록할 수 있는 주입 수 */
+#define FAKE_MAX_INJECTED 64
+
+/**
+ * @brief 가짜 백엔드 상태
+ */
+typedef struct fake_backend {
+    const char* foreground;        /**< 포그라운드 프로세스 이름 (NULL이면 조회 실패) */
+    const char* allowed;           /**< 허용할 프로세스 이름 */
+    unsigned int salt_counter;     /**< 가짜 솔트 카운터 */
+    unsigned long lookups;         /**< 포그라운드 조회 수 */
+    unsigned int injected_vk[FAKE_MAX_INJECTED];   /**< 주입한 가상 키 코드 */
+    int injected_down[FAKE_MAX_INJECTED];          /**< 주입한 키가 키 다운인지 여부 */
+    size_t injected;               /**< 주입 수 */
+    unsigned long logs;            /**< 로그 호출 수 */
+    int last_verdict;              /**< 마지막 로그의 판정 (LOG_VERDICT_*) */
+    unsigned int last_repeats;     /**< 마지막 로그의 반복 횟수 */
+} fake_backend;
+
+static fake_backend g_fake;
+
+static int fake_get_foreground(void* context, foreground_identity* identity) {
+    (void)context;
+    g_fake.lookups++;
+    if (g_fake.foreground == NULL) {
+        return 0;
+    }
+    identity->window = 0x100;
+    // 프로세스마다 다른 PID (같은 PID면 캐시가 이름을 다시 조회하지 않음)
+    identity->process_id = (unsigned long)(unsigned char)g_fake.foreground[0];
+    identity->start_time = 1;
+    return 1;
+}
+
+static int fake_get_process_name(void* context, const foreground_identity* identity, char* name, size_t name_size) {
+    (void)context;
+    (void)identity;
+    strncpy(name, g_fake.foreground, name_size - 1);
+    name[name_size - 1] = '\0';
+    return 1;
+}
+
+static int fake_verdict(const char* process_name, void* user) {
+    (void)user;
+    return strcmp(process_name, g_fake.allowed) == 0;
+}
+
+/**
+ * @brief 가짜 키스트림 워드 (위치 salt의 워드)
+ */
+static unsigned int fake_pad(unsigned int salt) {
+    return salt * 2654435761U;
+}
+
+static unsigned int fake_make_salt(void* context, unsigned int* pad) {
+    (void)context;
+    ++g_fake.salt_counter;
+    *pad = fake_pad(g_fake.salt_counter);
+    return g_fake.salt_counter;
+}
+
+static int fake_inject(void* context, unsigned int vk_code, int key_down) {
+    (void)context;
+    if (g_fake.injected < FAKE_MAX_INJECTED) {
+        g_fake.injected_vk[g_fake.injected] = vk_code;
+        g_fake.injected_down[g_fake.injected] = key_down;
+        g_fake.injected++;
+    }
+    return 1;
+}
+
+static void fake_log(void* context, unsigned int vk_code, unsigned int salt, unsigned int encrypted_keycode,
+                     int verdict, const char* process_name, unsigned int repeats) {
+    (void)context;
+    (void)process_name;
+    // 로그에는 워드가 아니라 위치(솔트)만 남고, 암호화된 키 코드는 그 위치의 워드로만 풀려야 함
+    KP_CHECK(salt >= 1 && salt <= g_fake.salt_counter);
+    KP_CHECK(salt != fake_pad(salt));
+    KP_CHECK_EQ(decrypt_keycode_with_salt(encrypted_keycode, fake_pad(salt)), vk_code);
+    g_fake.logs++;
+    g_fake.last_repeats = repeats;
+    g_fake.last_verdict = verdict;
+}
+
+static const process_lookup_provider g_provider = { NULL, fake_get_foreground, fake_get_process_name };
+
+static foreground_cache g_cache;
+static key_processor g_processor;
+
+/**
+ * @brief 포그라운드와 허용 프로세스를 정하고 처리 코어를 새로 만듭니다.
+ */
+static void setup(const char* foreground, const char* allowed) {
+    memset(&g_fake, 0, sizeof(g_fake));
+    g_fake.foreground = foreground;
+    g_fake.allowed = allowed;
+    key_processor_backend backend = { NULL, fake_make_salt, fake_inject, fake_log };
+    foreground_cache_init(&g_cache, &g_provider, fake_verdict, NULL);
+    key_processor_init(&g_processor, &g_cache, &backend, NULL);
+}
+
+/**
+ * @brief 키 이벤트 하나를 처리합니다.
+ */
+static foreground_verdict send_key(unsigned int vk_code, int key_down) {
+    key_event event;
+    memset(&event, 0, sizeof(event));
+    event.vk_code = vk_code;
+    event.message = key_down ? KEY_MESSAGE_KEYDOWN : KEY_MESSAGE_KEYUP;
+    return key_processor_handle(&g_processor, &event, NULL);
+}
+
+static void test_allowed_down_up(void) {
+    setup("notepad.exe", "notepad.exe");
+    KP_CHECK_EQ(send_key('A', 1), FOREGROUND_ALLOWED);
+    KP_CHECK_EQ(send_key('A', 0), FOREGROUND_ALLOWED);
+    KP_CHECK_EQ(g_fake.injected, 2);
+    KP_CHECK_EQ(g_fake.injected_vk[0], 'A');
+    KP_CHECK_EQ(g_fake.injected_down[0], 1);
+    KP_CHECK_EQ(g_fake.injected_vk[1], 'A');
+    KP_CHECK_EQ(g_fake.injected_down[1], 0);
+    KP_CHECK_EQ(g_processor.injected, 2);
+    KP_CHECK_EQ(g_fake.logs, 1);
+    KP_CHECK_EQ(g_processor.keys['A'].flags, 0);
+}
+
+static void test_blocked_process(void) {
+    setup("malware.exe", "notepad.exe");
+    KP_CHECK_EQ(send_key('B', 1), FOREGROUND_BLOCKED);
+    KP_CHECK_EQ(send_key('B', 0), FOREGROUND_BLOCKED);
+    KP_CHECK_EQ(g_fake.injected, 0);
+    KP_CHECK_EQ(g_fake.logs, 1);
+}
+
+static void test_unknown_foreground_blocks(void) {
+    setup(NULL, "notepad.exe");
+    KP_CHECK_EQ(send_key('C', 1), FOREGROUND_UNKNOWN);
+    KP_CHECK_EQ(g_fake.injected, 0);
+    KP_CHECK_EQ(g_cache.failures, 1);
+}
+
+static void test_key_up_after_focus_change(void) {
+    // 차단된 창에서 누르고 허용된 창에서 뗀 키는 키 업만 주입하지 않음
+    setup("malware.exe", "notepad.exe");
+    send_key('D', 1);
+    g_fake.foreground = "notepad.exe";
+    foreground_cache_invalidate(&g_cache);
+    KP_CHECK_EQ(send_key('D', 0), FOREGROUND_BLOCKED);
+    KP_CHECK_EQ(g_fake.injected, 0);
+}
+
+static void test_ordering_interleaved(void) {
+    setup("notepad.exe", "notepad.exe");
+    send_key('X', 1);
+    send_key('Y', 1);
+    send_key('X', 0);
+    send_key('Y', 0);
+    KP_CHECK_EQ(g_fake.injected, 4);
+    KP_CHECK_EQ(g_fake.injected_vk[0], 'X');
+    KP_CHECK_EQ(g_fake.injected_vk[1], 'Y');
+    KP_CHECK_EQ(g_fake.injected_vk[2], 'X');
+    KP_CHECK_EQ(g_fake.injected_down[2], 0);
+    KP_CHECK_EQ(g_fake.injected_vk[3], 'Y');
+}
+
+static void test_repeats_reuse_salt_and_verdict(void) {
+    setup("notepad.exe", "notepad.exe");
+    send_key('R', 1);
+    unsigned long lookups = g_fake.lookups;
+    for (int i = 0; i < 5; i++) {
+        KP_CHECK_EQ(send_key('R', 1), FOREGROUND_ALLOWED);
+    }
+    // 반복은 솔트를 새로 만들지 않고, 포그라운드를 다시 조회하지 않으며, 하나씩 기록하지 않음
+    KP_CHECK_EQ(g_fake.salt_counter, 1);
+    KP_CHECK_EQ(g_fake.lookups, lookups);
+    KP_CHECK_EQ(g_fake.logs, 1);
+    KP_CHECK_EQ(g_processor.repeats, 5);
+    KP_CHECK_EQ(g_processor.keys['R'].repeats, 5);
+    // 반복도 대상 프로그램에 그대로 주입
+    KP_CHECK_EQ(g_fake.injected, 6);
+    KP_CHECK_EQ(g_fake.injected_vk[5], 'R');
+    KP_CHECK_EQ(g_fake.injected_down[5], 1);
+
+    // 키 업에 반복 횟수를 한 줄로 기록하고 키 업을 주입
+    KP_CHECK_EQ(send_key('R', 0), FOREGROUND_ALLOWED);
+    KP_CHECK_EQ(g_fake.logs, 2);
+    KP_CHECK_EQ(g_fake.last_repeats, 5);
+    KP_CHECK_EQ(g_fake.last_verdict, LOG_VERDICT_ALLOWED);
+    KP_CHECK_EQ(g_fake.injected, 7);
+    KP_CHECK_EQ(g_fake.injected_down[6], 0);
+    KP_CHECK_EQ(g_processor.keys['R'].repeats, 0);
+
+    // 떼고 다시 누르면 반복이 아니라 새 키 다운
+    send_key('R', 1);
+    KP_CHECK_EQ(g_fake.salt_counter, 2);
+    KP_CHECK_EQ(g_fake.last_repeats, 0);
+}
+
+static void test_repeat_after_focus_change_rejudges(void) {
+    setup("notepad.exe", "notepad.exe");
+    send_key('S', 1);
+    send_key('S', 1);
+    send_key('S', 1);
+    KP_CHECK_EQ(g_fake.injected, 3);
+
+    // 키를 누른 채 차단된 창으로 바뀌면 세대가 달라져 반복을 다시 판정
+    g_fake.foreground = "malware.exe";
+    foreground_cache_invalidate(&g_cache);
+    KP_CHECK_EQ(send_key('S', 1), FOREGROUND_BLOCKED);
+    // 그동안의 반복 2회를 마감하고, 바뀐 판정을 새로 기록
+    KP_CHECK_EQ(g_fake.logs, 3);
+    KP_CHECK_EQ(g_fake.last_repeats, 0);
+    KP_CHECK_EQ(g_fake.last_verdict, LOG_VERDICT_BLOCKED);
+    KP_CHECK_EQ(g_fake.injected, 3);
+    KP_CHECK_EQ(g_fake.salt_counter, 1);
+
+    // 이후 반복은 새 판정으로 빠른 경로를 타고 주입되지 않음
+    unsigned long lookups = g_fake.lookups;
+    KP_CHECK_EQ(send_key('S', 1), FOREGROUND_BLOCKED);
+    KP_CHECK_EQ(g_fake.lookups, lookups);
+    KP_CHECK_EQ(send_key('S', 0), FOREGROUND_BLOCKED);
+    KP_CHECK_EQ(g_fake.injected, 3);
+    KP_CHECK_EQ(g_fake.last_repeats, 1);
+}
+
+static void test_repeat_verifies_without_notification(void) {
+    // 포그라운드 변경 알림이 없는 확인 모드: 무효화 없이 창이 바뀌어도 반복을 다시 판정
+    setup("notepad.exe", "notepad.exe");
+    foreground_cache_set_verify(&g_cache, 1);
+    send_key('V', 1);
+    send_key('V', 1);
+    KP_CHECK_EQ(g_fake.injected, 2);
+    g_fake.foreground = "malware.exe";
+    KP_CHECK_EQ(send_key('V', 1), FOREGROUND_BLOCKED);
+    KP_CHECK_EQ(send_key('W', 1), FOREGROUND_BLOCKED);
+    KP_CHECK_EQ(send_key('V', 0), FOREGROUND_BLOCKED);
+    KP_CHECK_EQ(g_fake.injected, 2);
+    KP_CHECK_EQ(g_cache.verify_changes, 1);
+}
+
+static void test_blocked_repeats_counted_not_injected(void) {
+    setup("malware.exe", "notepad.exe");
+    for (int i = 0; i < 40; i++) {
+        KP_CHECK_EQ(send_key('T', 1), FOREGROUND_BLOCKED);
+    }
+    send_key('T', 0);
+    KP_CHECK_EQ(g_fake.injected, 0);
+    KP_CHECK_EQ(g_fake.logs, 2);
+    KP_CHECK_EQ(g_fake.last_repeats, 39);
+    KP_CHECK_EQ(g_fake.last_verdict, LOG_VERDICT_BLOCKED);
+}
+
+static void test_unknown_repeat_retries_lookup(void) {
+    // 확인 실패 판정은 캐시하지 않으므로 반복마다 다시 조회하고, 조회되면 허용
+    setup(NULL, "notepad.exe");
+    KP_CHECK_EQ(send_key('U', 1), FOREGROUND_UNKNOWN);
+    unsigned long lookups = g_fake.lookups;
+    KP_CHECK_EQ(send_key('U', 1), FOREGROUND_UNKNOWN);
+    KP_CHECK(g_fake.lookups > lookups);
+    g_fake.foreground = "notepad.exe";
+    KP_CHECK_EQ(send_key('U', 1), FOREGROUND_ALLOWED);
+    KP_CHECK_EQ(g_fake.last_verdict, LOG_VERDICT_ALLOWED);
+    KP_CHECK_EQ(g_fake.injected, 1);
+    KP_CHECK_EQ(g_fake.salt_counter, 1);
+}
+
+static const kp_test_case g_cases[] = {
+    { "allowed_down_up", test_allowed_down_up },
+    { "blocked_process", test_blocked_process },
+    { "unknown_foreground_blocks", test_unknown_foreground_blocks },
+    { "key_up_after_focus_change", test_key_up_after_focus_change },
+    { "ordering_interleaved", test_ordering_interleaved },
+    { "repeats_reuse_salt_and_verdict", test_repeats_reuse_salt_and_verdict },
+    { "repeat_after_focus_change_rejudges", test_repeat_after_focus_change_rejudges },
+    { "repeat_verifies_without_notification", test_repeat_verifies_without_notification },
+    { "blocked_repeats_counted_not_injected", test_blocked_repeats_counted_not_injected },
+    { "unknown_repeat_retries_lookup", test_unknown_repeat_retries_lookup }
+};
+
+KP_TEST_SUITE(processor, g_cases);
@@ -0,0 +1,186 @@
+/**
+ * @file test_shadow_audit.c
+ * @brief 그림자 모드 경로 결정(현재 설정 파일 기준)과 현재/후보 정책 판정 집계 테스트
+ */
+#include "kp_test.h"
+#include "shadow_audit.h"
+#include "policy_loader.h"
+#include "key_processor.h"
+
+#include <string.h>
+
+/** @brief 가짜 포그라운드 프로세스 이름 (NULL이면 조회 실패) */
+static const char* g_foreground;
+
+static shadow_audit g_audit;
+static foreground_cache g_cache;
+
+static int fake_get_foreground(void* context, foreground_identity* identity) {
+    (void)context;
+    if (g_foreground == NULL) {
+        return 0;
+    }
+    identity->window = 0x100;
+    identity->process_id = (unsigned long)(unsigned char)g_foreground[0];
+    identity->start_time = 1;
+    return 1;
+}
+
+static int fake_get_process_name(void* context, const foreground_identity* identity, char* name, size_t name_size) {
+    (void)context;
+    (void)identity;
+    strncpy(name, g_foreground, name_size - 1);
+    name[name_size - 1] = '\0';
+    return 1;
+}
+
+static const process_lookup_provider g_provider = { NULL, fake_get_foreground, fake_get_process_name };
+
+/**
+ * @brief 현재 정책의 허용 목록으로 판정합니다. (규칙 번호 + 1)
+ */
+static int active_verdict(const char* process_name, void* user) {
+    return (int)allowlist_value(&((const policy_snapshot*)user)->allowed, process_name);
+}
+
+static policy_snapshot* load(const char* ini) {
+    policy_load_status status;
+    return policy_load_buffer(ini, strlen(ini), &status);
+}
+
+static key_event make_event(unsigned int vk_code, int key_down) {
+    key_event event;
+    memset(&event, 0, sizeof(event));
+    event.vk_code = vk_code;
+    event.message = key_down ? KEY_MESSAGE_KEYDOWN : KEY_MESSAGE_KEYUP;
+    return event;
+}
+
+static foreground_verdict press(const policy_snapshot* active, const policy_snapshot* candidate, unsigned int vk_code) {
+    key_event down = make_event(vk_code, 1);
+    key_event up = make_event(vk_code, 0);
+    foreground_verdict verdict = shadow_audit_handle(&g_audit, &g_cache, active, candidate, &down);
+    shadow_audit_handle(&g_audit, &g_cache, active, candidate, &up);
+    return verdict;
+}
+
+/**
+ * @brief 프로세스 항목에서 (분류, 현재 판정, 후보 판정) 카운터를 찾습니다.
+ */
+static unsigned long count_of(const char* process, shadow_key_class key_class, int active, int candidate) {
+    for (int i = 0; i < SHADOW_AUDIT_PROCESSES; i++) {
+        const shadow_process* entry = &g_audit.processes[i];
+        if (entry->used && strcmp(entry->name, process) == 0) {
+            return entry->counts[key_class][active][candidate];
+        }
+    }
+    return 0;
+}
+
+static void test_relative_paths_follow_config(void) {
+    char path[64];
+    KP_CHECK(shadow_audit_resolve_path("D:\\policies\\site.ini", "candidate.ini", "", path, sizeof(path)));
+    KP_CHECK(strcmp(path, "D:\\policies\\candidate.ini") == 0);
+    KP_CHECK(shadow_audit_resolve_path("/etc/kp/config.ini", "", "shadow_report.csv", path, sizeof(path)));
+    KP_CHECK(strcmp(path, "/etc/kp/shadow_report.csv") == 0);
+    KP_CHECK(shadow_audit_resolve_path("C:\\kp/conf\\config.ini", "sub\\next.ini", "", path, sizeof(path)));
+    KP_CHECK(strcmp(path, "C:\\kp/conf\\sub\\next.ini") == 0);
+
+    // 디렉토리 없는 설정 파일 경로는 상대 경로 그대로
+    KP_CHECK(shadow_audit_resolve_path("config.ini", "candidate.ini", "", path, sizeof(path)));
+    KP_CHECK(strcmp(path, "candidate.ini") == 0);
+    KP_CHECK(shadow_audit_resolve_path(NULL, NULL, "shadow_report.csv", path, sizeof(path)));
+    KP_CHECK(strcmp(path, "shadow_report.csv") == 0);
+}
+
+static void test_absolute_paths_kept(void) {
+    char path[64];
+    KP_CHECK(shadow_audit_resolve_path("D:\\policies\\site.ini", "E:\\audit.csv", "", path, sizeof(path)));
+    KP_CHECK(strcmp(path, "E:\\audit.csv") == 0);
+    KP_CHECK(shadow_audit_resolve_path("D:\\policies\\site.ini", "\\\\server\\share\\c.ini", "", path, sizeof(path)));
+    KP_CHECK(strcmp(path, "\\\\server\\share\\c.ini") == 0);
+    KP_CHECK(shadow_audit_resolve_path("/etc/kp/config.ini", "/var/log/kp.csv", "", path, sizeof(path)));
+    KP_CHECK(strcmp(path, "/var/log/kp.csv") == 0);
+}
+
+static void test_long_path_rejected(void) {
+    char path[16];
+    KP_CHECK(!shadow_audit_resolve_path("/a/very/long/directory/config.ini", "candidate.ini", "", path, sizeof(path)));
+    KP_CHECK_EQ(path[0], '\0');
+}
+
+static void test_counts_active_and_candidate(void) {
+    policy_snapshot* active = load("[AllowedProcesses]\nProcess1=notepad.exe\n[KeyRules]\nnotepad.exe=alpha\n");
+    policy_snapshot* candidate = load("[AllowedProcesses]\nProcess1=notepad.exe\nProcess2=putty.exe\n");
+    KP_CHECK(active != NULL && candidate != NULL);
+    if (active == NULL || candidate == NULL) {
+        policy_snapshot_destroy(active);
+        policy_snapshot_destroy(candidate);
+        return;
+    }
+    shadow_audit_init(&g_audit);
+    foreground_cache_init(&g_cache, &g_provider, active_verdict, active);
+
+    // 현재 정책: 문자만 허용, 후보 정책: 모든 키 허용
+    g_foreground = "notepad.exe";
+    KP_CHECK_EQ(press(active, candidate, 'A'), FOREGROUND_ALLOWED);
+    KP_CHECK_EQ(press(active, candidate, '1'), FOREGROUND_BLOCKED);
+    KP_CHECK_EQ(count_of("notepad.exe", SHADOW_KEY_ALPHA, FOREGROUND_ALLOWED, FOREGROUND_ALLOWED), 1);
+    KP_CHECK_EQ(count_of("notepad.exe", SHADOW_KEY_DIGIT, FOREGROUND_BLOCKED, FOREGROUND_ALLOWED), 1);
+
+    // 포그라운드가 바뀌면 캐시 무효화 뒤 새 프로세스 항목과 후보 규칙을 씀
+    g_foreground = "putty.exe";
+    foreground_cache_invalidate(&g_cache);
+    KP_CHECK_EQ(press(active, candidate, 'B'), FOREGROUND_BLOCKED);
+    KP_CHECK_EQ(count_of("putty.exe", SHADOW_KEY_ALPHA, FOREGROUND_BLOCKED, FOREGROUND_ALLOWED), 1);
+
+    // 후보 정책이 없으면 후보 판정은 SHADOW_VERDICT_NONE이고 불일치로 세지 않음
+    KP_CHECK_EQ(press(active, NULL, 'C'), FOREGROUND_BLOCKED);
+    KP_CHECK_EQ(count_of("putty.exe", SHADOW_KEY_ALPHA, FOREGROUND_BLOCKED, SHADOW_VERDICT_NONE), 1);
+
+    KP_CHECK_EQ(g_audit.key_downs, 4);
+    KP_CHECK_EQ(g_audit.disagreements, 2);
+    KP_CHECK_EQ(g_audit.processes_used, 2);
+
+    // 조회 실패는 "(unknown)" 항목에
+    g_foreground = NULL;
+    foreground_cache_invalidate(&g_cache);
+    KP_CHECK_EQ(press(active, candidate, 'D'), FOREGROUND_UNKNOWN);
+    KP_CHECK_EQ(g_audit.unknown.counts[SHADOW_KEY_ALPHA][FOREGROUND_UNKNOWN][FOREGROUND_UNKNOWN], 1);
+
+    policy_snapshot_destroy(active);
+    policy_snapshot_destroy(candidate);
+}
+
+static void test_repeats_not_counted(void) {
+    policy_snapshot* active = load("[AllowedProcesses]\nProcess1=notepad.exe\n");
+    KP_CHECK(active != NULL);
+    if (active == NULL) {
+        return;
+    }
+    shadow_audit_init(&g_audit);
+    foreground_cache_init(&g_cache, &g_provider, active_verdict, active);
+    g_foreground = "notepad.exe";
+
+    key_event down = make_event('A', 1);
+    key_event up = make_event('A', 0);
+    for (int i = 0; i < 5; i++) {
+        KP_CHECK_EQ(shadow_audit_handle(&g_audit, &g_cache, active, NULL, &down), FOREGROUND_ALLOWED);
+    }
+    shadow_audit_handle(&g_audit, &g_cache, active, NULL, &up);
+    KP_CHECK_EQ(g_audit.key_downs, 1);
+    KP_CHECK_EQ(g_audit.repeats, 4);
+    KP_CHECK_EQ(count_of("notepad.exe", SHADOW_KEY_ALPHA, FOREGROUND_ALLOWED, SHADOW_VERDICT_NONE), 1);
+
+    policy_snapshot_destroy(active);
+}
+
+static const kp_test_case g_cases[] = {
+    { "relative_paths_follow_config", test_relative_paths_follow_config },
+    { "absolute_paths_kept", test_absolute_paths_kept },
+    { "long_path_rejected", test_long_path_rejected },
+    { "counts_active_and_candidate", test_counts_active_and_candidate },
+    { "repeats_not_counted", test_repeats_not_counted }
+};
+
+KP_TEST_SUITE(shadow_audit, g_cases);
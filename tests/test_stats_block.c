@@ -0,0 +1,161 @@
+/**
+ * @file test_stats_block.c
+ * @brief 로그 구간 지연 히스토그램의 버킷 경계, 백분위, 공유 메모리 통계 블록 테스트
+ */
+#include "kp_test.h"
+#include "stats_block.h"
+#include "key_pipeline.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static latency_histogram g_histogram;
+static kp_stats_block g_block;
+static key_pipeline g_pipeline;
+
+static void test_small_values_exact(void) {
+    for (uint64_t v = 0; v < 16; v++) {
+        KP_CHECK_EQ(latency_bucket_index(v), v);
+        KP_CHECK_EQ(latency_bucket_upper((unsigned int)v), v);
+    }
+}
+
+static void test_bucket_bounds_contain_value(void) {
+    unsigned long outside = 0;
+    unsigned long too_wide = 0;
+    unsigned int previous = 0;
+    unsigned long not_monotonic = 0;
+    // 1ns부터 지수적으로 늘어나는 값과 그 이웃 값
+    for (uint64_t base = 16; base < (1ULL << 40); base += (base >> 3) + 1) {
+        uint64_t values[3] = { base - 1, base, base + 1 };
+        for (int i = 0; i < 3; i++) {
+            uint64_t v = values[i];
+            unsigned int index = latency_bucket_index(v);
+            if (latency_bucket_upper(index) < v || (index > 0 && latency_bucket_upper(index - 1) >= v)) {
+                outside++;
+            }
+            // 하위 버킷 16개: 버킷 폭은 값의 1/16 이하
+            if (latency_bucket_upper(index) - v > v / 16) {
+                too_wide++;
+            }
+            if (index < previous) {
+                not_monotonic++;
+            }
+            previous = index;
+        }
+    }
+    KP_CHECK_EQ(outside, 0);
+    KP_CHECK_EQ(too_wide, 0);
+    KP_CHECK_EQ(not_monotonic, 0);
+}
+
+static void test_huge_values_clamp(void) {
+    KP_CHECK_EQ(latency_bucket_index(1ULL << 40), LATENCY_BUCKETS - 1);
+    KP_CHECK_EQ(latency_bucket_index(~0ULL), LATENCY_BUCKETS - 1);
+    KP_CHECK(latency_bucket_index((1ULL << 40) - 1) < LATENCY_BUCKETS);
+}
+
+static void test_percentiles(void) {
+    memset(&g_histogram, 0, sizeof(g_histogram));
+    KP_CHECK_EQ(latency_histogram_percentile(&g_histogram, 0.5), 0);
+
+    for (uint64_t v = 1; v <= 10000; v++) {
+        latency_histogram_record(&g_histogram, v * 100);
+    }
+    KP_CHECK_EQ(g_histogram.count, 10000);
+    KP_CHECK_EQ(g_histogram.max_ns, 1000000);
+    KP_CHECK_EQ(g_histogram.sum_ns, 100ULL * 10000 * 10001 / 2);
+
+    uint64_t p50 = latency_histogram_percentile(&g_histogram, 0.50);
+    uint64_t p99 = latency_histogram_percentile(&g_histogram, 0.99);
+    KP_CHECK(p50 >= 500000 && p50 <= 500000 + 500000 / 16);
+    KP_CHECK(p99 >= 990000 && p99 <= 1000000);
+    // 최대 백분위는 버킷 상한이 아니라 실제 최대값으로 잘림
+    KP_CHECK_EQ(latency_histogram_percentile(&g_histogram, 1.0), 1000000);
+
+    latency_histogram_record(NULL, 5);
+}
+
+static void test_block_counters(void) {
+    memset(&g_block, 0, sizeof(g_block));
+    kp_stats_block_init(&g_block, 300);
+    KP_CHECK_EQ(g_block.magic, KP_STATS_MAGIC);
+    KP_CHECK_EQ(g_block.version, KP_STATS_VERSION);
+    KP_CHECK_EQ(g_block.size, sizeof(kp_stats_block));
+
+    // 후크 시간이 제한 시간(300ms)의 절반을 넘은 경우만 센다
+    kp_stats_record(&g_block, KP_STAT_HOOK, 149000000ULL);
+    kp_stats_record(&g_block, KP_STAT_HOOK, 151000000ULL);
+    kp_stats_record(&g_block, KP_STAT_EVENT, 400000000ULL);
+    KP_CHECK_EQ(g_block.near_timeout, 1);
+    KP_CHECK_EQ(g_block.stages[KP_STAT_HOOK].count, 2);
+
+    kp_stats_count_verdict(&g_block, KP_VERDICT_ALLOWED);
+    kp_stats_count_verdict(&g_block, KP_VERDICT_BLOCKED);
+    kp_stats_count_verdict(&g_block, KP_VERDICT_BLOCKED);
+    KP_CHECK_EQ(g_block.verdicts[KP_VERDICT_ALLOWED], 1);
+    KP_CHECK_EQ(g_block.verdicts[KP_VERDICT_BLOCKED], 2);
+    KP_CHECK_EQ(g_block.verdicts[KP_VERDICT_UNKNOWN], 0);
+
+    kp_stats_record(NULL, KP_STAT_HOOK, 1);
+    kp_stats_count_verdict(NULL, KP_VERDICT_ALLOWED);
+}
+
+static void test_pipeline_stages_feed_histograms(void) {
+    memset(&g_block, 0, sizeof(g_block));
+    memset(&g_pipeline, 0, sizeof(g_pipeline));
+    kp_stats_block_init(&g_block, KP_STATS_DEFAULT_HOOK_TIMEOUT_MS);
+    key_pipeline_attach_stats(&g_pipeline, &g_block);
+
+    key_pipeline_record_stage(&g_pipeline, KEY_STAGE_RESOLVE, 1000);
+    key_pipeline_record_stage(&g_pipeline, KEY_STAGE_CRYPTO, 20);
+    key_pipeline_record_stage(&g_pipeline, KEY_STAGE_INJECT, 3000);
+    key_pipeline_record_stage(&g_pipeline, KEY_STAGE_INJECT, 5000);
+    KP_CHECK_EQ(g_block.stages[KP_STAT_RESOLVE].count, 1);
+    KP_CHECK_EQ(g_block.stages[KP_STAT_CRYPTO].count, 1);
+    KP_CHECK_EQ(g_block.stages[KP_STAT_INJECT].count, 2);
+    KP_CHECK_EQ(g_block.stages[KP_STAT_INJECT].max_ns, 5000);
+    KP_CHECK_EQ(g_block.stages[KP_STAT_HOOK].count, 0);
+
+    key_pipeline_stats stats;
+    key_pipeline_get_stats(&g_pipeline, &stats);
+    KP_CHECK_EQ(stats.stage_total_ns[KEY_STAGE_INJECT], 8000);
+}
+
+static void test_shared_block_visible_to_reader(void) {
+    char name[64];
+    snprintf(name, sizeof(name), "KeyboardProtectorStatsTest%lu", kp_process_id());
+
+    kp_shared_memory writer;
+    kp_shared_memory reader;
+    KP_CHECK(kp_shared_memory_create(&writer, name, sizeof(kp_stats_block)));
+    if (writer.address == NULL) {
+        return;
+    }
+    kp_stats_block* block = (kp_stats_block*)writer.address;
+    kp_stats_block_init(block, 250);
+    kp_stats_record(block, KP_STAT_QUEUE, 777);
+
+    KP_CHECK(kp_shared_memory_open(&reader, name, sizeof(kp_stats_block)));
+    if (reader.address != NULL) {
+        const kp_stats_block* seen = (const kp_stats_block*)reader.address;
+        KP_CHECK_EQ(seen->magic, KP_STATS_MAGIC);
+        KP_CHECK_EQ(seen->hook_timeout_ms, 250);
+        KP_CHECK_EQ(seen->stages[KP_STAT_QUEUE].count, 1);
+        KP_CHECK_EQ(latency_histogram_percentile(&seen->stages[KP_STAT_QUEUE], 0.5), 777);
+        kp_shared_memory_close(&reader);
+    }
+    kp_shared_memory_close(&writer);
+}
+
+static const kp_test_case g_cases[] = {
+    { "small_values_exact", test_small_values_exact },
+    { "bucket_bounds_contain_value", test_bucket_bounds_contain_value },
+    { "huge_values_clamp", test_huge_values_clamp },
+    { "percentiles", test_percentiles },
+    { "block_counters", test_block_counters },
+    { "pipeline_stages_feed_histograms", test_pipeline_stages_feed_histograms },
+    { "shared_block_visible_to_reader", test_shared_block_visible_to_reader }
+};
+
+KP_TEST_SUITE(stats_block, g_cases);
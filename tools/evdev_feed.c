@@ -0,0 +1,283 @@
+/**
+ * @file evdev_feed.c
+ * @brief Linux 백엔드 시험용 가짜 키보드 공급 도구
+ * @details 키 입력 트레이스를 evdev 레코드(struct input_event) 스트림으로 바꾸어 FIFO나 파이프에 씁니다.
+ *          keyboard_protector_linux --device <FIFO> --sink <출력 파일>과 함께 쓰면 장치 권한 없이
+ *          evdev 입력 → 처리 코어 → 출력 경로 전체를 시험할 수 있습니다.
+ *
+ *          사용법:
+ *            evdev_feed <FIFO|파일|-> <트레이스> [--speed max|realtime|<배속>] [--loops <횟수>]
+ *                       [--foreground-file <경로>]
+ *            evdev_feed --dump <출력 파일>
+ *
+ *          이벤트마다 CLOCK_MONOTONIC 시각을 찍고 키 이벤트마다 SYN_REPORT를 붙이며, 최대 속도에서는
+ *          FEED_BATCH개씩 모아 씁니다. 가상 키 코드에 대응하는 evdev 키가 없는 레코드는 건너뜁니다.
+ *          --foreground-file을 지정하면 트레이스의 프로세스 라벨이 바뀔 때마다 그 이름을 포그라운드 파일에 씁니다.
+ *          --dump는 출력 파일의 키 이벤트 수와 trace_replay와 같은 방식의 주입 순서 체크섬을 출력합니다.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "linux_backend.h"
+#include "key_processor.h"
+#include "key_trace.h"
+#include "kp_platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/** @brief 최대 속도에서 write() 한 번에 모아 쓰는 이벤트 수 */
+#define FEED_BATCH 256
+
+/** @brief 재생 속도: 최대 속도 */
+#define FEED_SPEED_MAX 0.0
+
+/**
+ * @brief 공급 상태
+ */
+typedef struct feed_context {
+    int fd;                                 /**< 출력 FIFO */
+    struct input_event buffer[FEED_BATCH];  /**< 다음 write()로 쓸 이벤트 */
+    size_t count;                           /**< 버퍼에 모인 이벤트 수 */
+    unsigned char down[LINUX_SINK_KEYS / 8]; /**< 눌린 키 비트맵 (자동 반복 값 2) */
+    unsigned long keys;                     /**< 쓴 키 이벤트 수 */
+    unsigned long skipped;                  /**< evdev 키가 없어 건너뛴 레코드 수 */
+    unsigned long writes;                   /**< write() 호출 수 */
+    const char* foreground_path;            /**< 포그라운드 파일 (NULL이면 쓰지 않음) */
+    unsigned int foreground_label;          /**< 마지막으로 쓴 라벨 */
+    unsigned long foreground_changes;       /**< 포그라운드 파일을 쓴 횟수 */
+} feed_context;
+
+/**
+ * @brief 버퍼에 모인 이벤트를 씁니다. (FIFO가 가득 차면 읽힐 때까지 기다림)
+ */
+static int feed_flush(feed_context* ctx) {
+    const unsigned char* data = (const unsigned char*)ctx->buffer;
+    size_t remaining = ctx->count * sizeof(struct input_event);
+    while (remaining > 0) {
+        ssize_t written = write(ctx->fd, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("[오류] write");
+            return 0;
+        }
+        data += written;
+        remaining -= (size_t)written;
+    }
+    if (ctx->count > 0) {
+        ctx->writes++;
+    }
+    ctx->count = 0;
+    return 1;
+}
+
+/**
+ * @brief 현재 시각을 찍은 이벤트 하나를 버퍼에 넣습니다.
+ */
+static int feed_event(feed_context* ctx, unsigned int type, unsigned int code, int value) {
+    if (ctx->count == FEED_BATCH && !feed_flush(ctx)) {
+        return 0;
+    }
+    unsigned long long now = kp_now_ns();
+    struct input_event* event = &ctx->buffer[ctx->count++];
+    memset(event, 0, sizeof(*event));
+    event->input_event_sec = (time_t)(now / 1000000000ULL);
+    event->input_event_usec = (suseconds_t)((now % 1000000000ULL) / 1000ULL);
+    event->type = (unsigned short)type;
+    event->code = (unsigned short)code;
+    event->value = value;
+    return 1;
+}
+
+/**
+ * @brief 포그라운드 파일에 프로세스 이름을 씁니다. (임시 파일을 쓴 뒤 이름을 바꾸어 반쯤 쓰인 내용을 읽지 않게 함)
+ */
+static void feed_foreground(feed_context* ctx, const char* name) {
+    char temporary[FOREGROUND_NAME_SIZE + 8];
+    snprintf(temporary, sizeof(temporary), "%.*s.tmp", FOREGROUND_NAME_SIZE - 1, ctx->foreground_path);
+    FILE* file = fopen(temporary, "w");
+    if (file == NULL) {
+        return;
+    }
+    fprintf(file, "%s\n", (name != NULL) ? name : "");
+    fclose(file);
+    if (rename(temporary, ctx->foreground_path) == 0) {
+        ctx->foreground_changes++;
+    }
+}
+
+/**
+ * @brief 트레이스를 한 번 공급합니다.
+ * @param speed 배속 (FEED_SPEED_MAX이면 기다리지 않음)
+ */
+static int feed_trace(feed_context* ctx, const char* path, double speed) {
+    key_trace trace;
+    if (!key_trace_open_read(&trace, path)) {
+        fprintf(stderr, "[오류] 트레이스 파일을 열 수 없습니다: %s\n", path);
+        return 0;
+    }
+
+    key_trace_record record;
+    unsigned long long start_ns = kp_now_ns();
+    int result;
+    while ((result = key_trace_read(&trace, &record)) == 1) {
+        if (ctx->foreground_path != NULL && record.label != ctx->foreground_label) {
+            // 라벨이 바뀌기 전의 키를 먼저 보내야 판정이 트레이스 순서와 같아짐
+            if (!feed_flush(ctx)) {
+                break;
+            }
+            feed_foreground(ctx, key_trace_label(&trace, record.label));
+            ctx->foreground_label = record.label;
+        }
+        unsigned int code = linux_keymap_from_vk(record.vk_code);
+        if (code == 0 || code >= LINUX_SINK_KEYS) {
+            ctx->skipped++;
+            continue;
+        }
+        if (speed != FEED_SPEED_MAX) {
+            unsigned long long due_ns = start_ns + (unsigned long long)((double)record.timestamp_ns / speed);
+            unsigned long long now = kp_now_ns();
+            if (due_ns > now) {
+                if (!feed_flush(ctx)) {
+                    break;
+                }
+                kp_sleep_ms((unsigned int)((due_ns - now) / 1000000ULL));
+            }
+        }
+
+        int key_down = (record.message == KEY_MESSAGE_KEYDOWN || record.message == KEY_MESSAGE_SYSKEYDOWN);
+        unsigned char bit = (unsigned char)(1u << (code & 7));
+        int value = 0;
+        if (key_down) {
+            value = (ctx->down[code >> 3] & bit) ? 2 : 1;
+            ctx->down[code >> 3] |= bit;
+        } else {
+            ctx->down[code >> 3] &= (unsigned char)~bit;
+        }
+        if (!feed_event(ctx, EV_KEY, code, value) || !feed_event(ctx, EV_SYN, SYN_REPORT, 0)) {
+            break;
+        }
+        ctx->keys++;
+        if (speed != FEED_SPEED_MAX && !feed_flush(ctx)) {
+            break;
+        }
+    }
+    key_trace_close(&trace);
+    if (result < 0) {
+        fprintf(stderr, "[오류] 트레이스 형식이 올바르지 않습니다: %s\n", path);
+        return 0;
+    }
+    return feed_flush(ctx);
+}
+
+/**
+ * @brief 출력 파일의 키 이벤트를 집계합니다.
+ * @details 체크섬은 trace_replay의 주입 순서 체크섬과 같은 식(가상 키 코드 기준)이므로, 모든 키가 허용되는
+ *          포그라운드에서 같은 트레이스를 공급했다면 두 결과를 비교할 수 있습니다.
+ */
+static int feed_dump(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "[오류] 출력 파일을 열 수 없습니다: %s\n", path);
+        return 1;
+    }
+    struct input_event event;
+    unsigned long downs = 0, repeats = 0, ups = 0, syncs = 0, others = 0;
+    unsigned long checksum = 0;
+    while (fread(&event, sizeof(event), 1, file) == 1) {
+        if (event.type == EV_SYN) {
+            syncs++;
+            continue;
+        }
+        if (event.type != EV_KEY) {
+            others++;
+            continue;
+        }
+        if (event.value == 1) {
+            downs++;
+        } else if (event.value == 2) {
+            repeats++;
+        } else {
+            ups++;
+        }
+        unsigned int vk_code = linux_keymap_to_vk(event.code);
+        checksum = checksum * 31UL + vk_code * 2UL + ((event.value != 0) ? 1UL : 0UL);
+    }
+    fclose(file);
+    printf("[덤프] %s: 키 다운 %lu | 자동 반복 %lu | 키 업 %lu | SYN %lu | 기타 %lu | 체크섬 %08lx\n", path,
+           downs, repeats, ups, syncs, others, checksum & 0xFFFFFFFFUL);
+    return 0;
+}
+
+/**
+ * @brief 공급 도구 진입점
+ */
+int main(int argc, char* argv[]) {
+    if (argc == 3 && strcmp(argv[1], "--dump") == 0) {
+        return feed_dump(argv[2]);
+    }
+    if (argc < 3) {
+        fprintf(stderr,
+                "사용법: %s <FIFO|파일|-> <트레이스> [--speed max|realtime|<배속>] [--loops <횟수>]\n"
+                "                  [--foreground-file <경로>]\n"
+                "       %s --dump <출력 파일>\n",
+                argv[0], argv[0]);
+        return 1;
+    }
+
+    static feed_context ctx;
+    double speed = FEED_SPEED_MAX;
+    unsigned long loops = 1;
+    ctx.foreground_label = KEY_TRACE_NO_LABEL + 1;
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "max") == 0) {
+                speed = FEED_SPEED_MAX;
+            } else if (strcmp(argv[i], "realtime") == 0) {
+                speed = 1.0;
+            } else {
+                speed = atof(argv[i]);
+                if (speed <= 0.0) {
+                    speed = FEED_SPEED_MAX;
+                }
+            }
+        } else if (strcmp(argv[i], "--loops") == 0 && i + 1 < argc) {
+            loops = strtoul(argv[++i], NULL, 10);
+            if (loops == 0) {
+                loops = 1;
+            }
+        } else if (strcmp(argv[i], "--foreground-file") == 0 && i + 1 < argc) {
+            ctx.foreground_path = argv[++i];
+        } else {
+            fprintf(stderr, "[오류] 알 수 없는 옵션: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    // FIFO는 읽는 쪽(keyboard_protector_linux)이 열 때까지 기다림
+    ctx.fd = (strcmp(argv[1], "-") == 0) ? STDOUT_FILENO : open(argv[1], O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    if (ctx.fd < 0) {
+        fprintf(stderr, "[오류] 출력을 열 수 없습니다: %s (%s)\n", argv[1], strerror(errno));
+        return 1;
+    }
+
+    unsigned long long start_ns = kp_now_ns();
+    int ok = 1;
+    for (unsigned long loop = 0; loop < loops && ok; loop++) {
+        ok = feed_trace(&ctx, argv[2], speed);
+    }
+    double seconds = (double)(kp_now_ns() - start_ns) / 1e9;
+    if (ctx.fd != STDOUT_FILENO) {
+        close(ctx.fd);
+    }
+    fprintf(stderr, "[공급] 키 이벤트 %lu개 (건너뜀 %lu), write %lu회, 포그라운드 변경 %lu회, %.3f초 (초당 %.0f 이벤트)\n",
+            ctx.keys, ctx.skipped, ctx.writes, ctx.foreground_changes, seconds,
+            (seconds > 0.0) ? (double)ctx.keys / seconds : 0.0);
+    return ok ? 0 : 1;
+}
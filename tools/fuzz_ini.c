@@ -0,0 +1,245 @@
+/**
+ * @file fuzz_ini.c
+ * @brief INI 파서와 정책 로더 퍼징 대상
+ * @details LLVMFuzzerTestOneInput은 입력을 NUL 종료 없이 딱 맞는 크기의 버퍼에 담아 ini_parse와
+ *          policy_load_buffer에 넘기고, 파서가 넘긴 슬라이스가 모두 버퍼 안에 있는지, 줄 번호가 줄어들지 않는지,
+ *          반환한 오류 수가 오류 콜백 수와 같은지 확인합니다. 어긋나면 abort하여 퍼저가 입력을 남기게 합니다.
+ *
+ *          빌드 방법:
+ *            make fuzz                                          gcc + ASan/UBSan, 내장 변형기로 실행
+ *            make fuzz FUZZ_CC=clang FUZZ_ENGINE="-fsanitize=fuzzer -DKP_LIBFUZZER"   libFuzzer
+ *            afl-gcc ... tools/fuzz_ini.c와 src 디렉터리의 .c 파일 (KP_LIBFUZZER 없이)   AFL: 파일 인자 또는 표준 입력 하나를 실행
+ *
+ *          내장 변형기 사용법 (KP_LIBFUZZER가 아닐 때):
+ *            fuzz_ini [--iterations <횟수>] [--seed <값>] [시드 파일...]
+ *            --iterations가 없으면 시드 파일(없으면 표준 입력)을 한 번씩만 실행합니다.
+ */
+#include "ini_parser.h"
+#include "policy_loader.h"
+#include "policy_store.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 파싱 중 확인 상태
+ */
+typedef struct fuzz_state {
+    const char* data;     /**< 입력 버퍼 */
+    size_t size;          /**< 입력 길이 */
+    int last_line;        /**< 마지막 항목/오류의 줄 번호 */
+    int errors;           /**< 오류 콜백 수 */
+    unsigned long entries;/**< 항목 콜백 수 */
+} fuzz_state;
+
+/**
+ * @brief 조건이 거짓이면 입력을 남기도록 중단합니다.
+ */
+static void fuzz_assert(int condition, const char* message) {
+    if (!condition) {
+        fprintf(stderr, "[퍼징] 불변 조건 위반: %s\n", message);
+        abort();
+    }
+}
+
+/**
+ * @brief 슬라이스가 입력 버퍼 안에 있는지 확인합니다. (빈 슬라이스는 위치를 보지 않음)
+ */
+static void check_slice(const fuzz_state* state, ini_slice slice, const char* what) {
+    if (slice.len == 0) {
+        return;
+    }
+    fuzz_assert(slice.ptr >= state->data && slice.ptr + slice.len <= state->data + state->size, what);
+}
+
+static int fuzz_entry(void* user, const ini_entry* entry) {
+    fuzz_state* state = (fuzz_state*)user;
+    check_slice(state, entry->section, "섹션 슬라이스가 버퍼 밖");
+    check_slice(state, entry->key, "키 슬라이스가 버퍼 밖");
+    check_slice(state, entry->value, "값 슬라이스가 버퍼 밖");
+    fuzz_assert(entry->key.len > 0, "빈 키");
+    fuzz_assert(entry->line >= state->last_line && entry->line >= 1, "줄 번호가 줄어듦");
+    state->last_line = entry->line;
+    state->entries++;
+
+    char buffer[16];
+    size_t copied = ini_slice_copy(entry->value, buffer, sizeof(buffer));
+    fuzz_assert(copied < sizeof(buffer) && buffer[copied] == '\0', "잘린 복사가 NUL로 끝나지 않음");
+    return 1;
+}
+
+static void fuzz_error(void* user, int line, const char* message) {
+    fuzz_state* state = (fuzz_state*)user;
+    fuzz_assert(message != NULL && line >= state->last_line && line >= 1, "오류 줄 번호가 줄어듦");
+    state->last_line = line;
+    state->errors++;
+}
+
+/**
+ * @brief 퍼징 입력 하나를 실행합니다.
+ */
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    // NUL 종료 없이 딱 맞는 버퍼에 복사하여 끝을 넘어 읽으면 ASan이 잡도록 함
+    char* buffer = (char*)malloc(size != 0 ? size : 1);
+    if (buffer == NULL) {
+        return 0;
+    }
+    if (size != 0) {
+        memcpy(buffer, data, size);
+    }
+
+    fuzz_state state;
+    memset(&state, 0, sizeof(state));
+    state.data = buffer;
+    state.size = size;
+    ini_handler handler = { fuzz_entry, fuzz_error, &state };
+    int errors = ini_parse(buffer, size, &handler);
+    fuzz_assert(errors == state.errors, "반환한 오류 수가 오류 콜백 수와 다름");
+
+    policy_load_status status = POLICY_LOAD_OK;
+    policy_snapshot* snapshot = policy_load_buffer(buffer, size, &status);
+    fuzz_assert(snapshot != NULL || status != POLICY_LOAD_OK, "실패했지만 상태가 OK");
+    policy_snapshot_destroy(snapshot);
+
+    free(buffer);
+    return 0;
+}
+
+#ifndef KP_LIBFUZZER
+
+/** @brief 변형기가 만드는 입력의 최대 크기 */
+#define FUZZ_MAX_INPUT 4096
+
+/** @brief 읽어 둘 수 있는 시드 파일 수 */
+#define FUZZ_MAX_SEEDS 64
+
+/** @brief 시드가 없을 때 쓰는 기본 입력 */
+static const char g_default_seed[] =
+    "\xEF\xBB\xBF[AllowedProcesses]\r\nProcess1=notepad.exe\n; comment\n"
+    "[KeyRules]\ncode.exe=alnum,-ctrl\n[Injection]\nForeign=pass\n[Devices]\nVID_05E0=trusted\n";
+
+/** @brief 변형에 섞어 넣는 INI 구문 조각 */
+static const char* const g_tokens[] = {
+    "[", "]", "=", "\n", "\r\n", ";", "#", "\"", " ", "\t", "[AllowedProcesses]", "[KeyRules]",
+    "[KeyPolicy]", "[Logging]", "[Injection]", "[Hook]", "[Shadow]", "[Devices]", "0x", "-shift", "none", "all", "\xEF\xBB\xBF"
+};
+
+/**
+ * @brief 결정적인 의사 난수 (xorshift64)
+ */
+static uint64_t next_random(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+/**
+ * @brief 입력을 한 번 변형합니다. (바이트 바꾸기, 지우기, 구문 조각 끼우기)
+ */
+static size_t mutate(unsigned char* data, size_t size, uint64_t* random) {
+    size_t pos = (size != 0) ? (size_t)(next_random(random) % size) : 0;
+    switch (next_random(random) % 4) {
+    case 0:
+        if (size != 0) {
+            data[pos] = (unsigned char)next_random(random);
+        }
+        break;
+    case 1:
+        if (size != 0) {
+            size_t count = 1 + (size_t)(next_random(random) % 8);
+            if (count > size - pos) {
+                count = size - pos;
+            }
+            memmove(data + pos, data + pos + count, size - pos - count);
+            size -= count;
+        }
+        break;
+    default: {
+        const char* token = g_tokens[next_random(random) % (sizeof(g_tokens) / sizeof(g_tokens[0]))];
+        size_t length = strlen(token);
+        if (size + length <= FUZZ_MAX_INPUT) {
+            memmove(data + pos + length, data + pos, size - pos);
+            memcpy(data + pos, token, length);
+            size += length;
+        }
+        break;
+    }
+    }
+    return size;
+}
+
+/**
+ * @brief 파일이나 표준 입력을 최대 FUZZ_MAX_INPUT 바이트까지 읽습니다.
+ */
+static size_t read_seed(const char* path, unsigned char* data) {
+    FILE* file = (path != NULL) ? fopen(path, "rb") : stdin;
+    if (file == NULL) {
+        fprintf(stderr, "[오류] 시드 파일을 열 수 없습니다: %s\n", path);
+        exit(1);
+    }
+    size_t size = fread(data, 1, FUZZ_MAX_INPUT, file);
+    if (path != NULL) {
+        fclose(file);
+    }
+    return size;
+}
+
+int main(int argc, char* argv[]) {
+    unsigned long iterations = 0;
+    uint64_t random = 0x9E3779B97F4A7C15ULL;
+    const char* seeds[FUZZ_MAX_SEEDS];
+    int seed_count = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            random = strtoull(argv[++i], NULL, 0) | 1ULL;
+        } else if (seed_count < (int)(sizeof(seeds) / sizeof(seeds[0]))) {
+            seeds[seed_count++] = argv[i];
+        }
+    }
+    policy_load_set_quiet(2);
+
+    static unsigned char base[FUZZ_MAX_SEEDS][FUZZ_MAX_INPUT];
+    static size_t base_sizes[FUZZ_MAX_SEEDS];
+    static unsigned char work[FUZZ_MAX_INPUT];
+    if (iterations == 0) {
+        // AFL 등 외부 퍼저: 입력 하나씩 실행
+        if (seed_count == 0) {
+            LLVMFuzzerTestOneInput(base[0], read_seed(NULL, base[0]));
+        }
+        for (int i = 0; i < seed_count; i++) {
+            LLVMFuzzerTestOneInput(base[0], read_seed(seeds[i], base[0]));
+        }
+        return 0;
+    }
+
+    // 시드는 한 번만 읽어 두고 변형마다 사본을 만듦
+    for (int i = 0; i < seed_count; i++) {
+        base_sizes[i] = read_seed(seeds[i], base[i]);
+    }
+    if (seed_count == 0) {
+        base_sizes[0] = sizeof(g_default_seed) - 1;
+        memcpy(base[0], g_default_seed, base_sizes[0]);
+        seed_count = 1;
+    }
+    for (unsigned long n = 0; n < iterations; n++) {
+        int seed = (int)(n % (unsigned long)seed_count);
+        size_t size = base_sizes[seed];
+        memcpy(work, base[seed], size);
+        int rounds = 1 + (int)(next_random(&random) % 16);
+        for (int r = 0; r < rounds; r++) {
+            size = mutate(work, size, &random);
+        }
+        LLVMFuzzerTestOneInput(work, size);
+    }
+    printf("[퍼징] 변형 입력 %lu개 실행, 불변 조건 위반 없음\n", iterations);
+    return 0;
+}
+
+#endif // KP_LIBFUZZER
@@ -0,0 +1,370 @@
+/**
+ * @file journal_query.c
+ * @brief 이진 키 입력 저널 조회 도구
+ * @details 저널 세그먼트를 메모리 매핑하여 텍스트 파싱 없이 시각 범위, 프로세스, 판정 조건으로 조회합니다.
+ *          세그먼트는 서로 독립적이므로 작업 스레드 여러 개가 세그먼트를 하나씩 가져가 병렬로 검사합니다.
+ *          결과는 세그먼트 순서대로 출력하므로 스레드 수와 관계없이 같습니다.
+ *
+ *          레코드에는 암호화된 키 코드와 솔트(키스트림 위치)만 있으므로 --list는 기본적으로 이 두 값을 출력합니다.
+ *          기록할 때 쓴 저널 키 파일을 --key-file로 주면 세그먼트 헤더의 세션 키를 풀어 원래 키 코드도 출력합니다.
+ *
+ *          사용법:
+ *            journal_query [--from <유닉스 초>] [--to <유닉스 초>] [--process <이름>]
+ *                          [--verdict allowed|blocked|unknown] [--threads <개수>] [--list]
+ *                          [--key-file <저널 키 파일>] <세그먼트>...
+ */
+#include "key_journal.h"
+#include "log_ring.h"
+#include "kp_platform.h"
+#include "kp_atomic.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** @brief 최대 조회 스레드 수 */
+#define QUERY_MAX_THREADS 16
+
+/** @brief 기본 조회 스레드 수 */
+#define QUERY_DEFAULT_THREADS 4
+
+/** @brief 판정 종류 수 */
+#define QUERY_VERDICTS 3
+
+/**
+ * @brief 세그먼트 하나의 조회 결과 (그 세그먼트를 맡은 스레드만 기록)
+ */
+typedef struct segment_job {
+    const char* path;                          /**< 세그먼트 파일 경로 */
+    key_journal_segment segment;               /**< 매핑된 세그먼트 */
+    int opened;                                /**< 매핑과 헤더 확인에 성공했는지 여부 */
+    int list;                                  /**< 일치한 레코드를 모을지 여부 */
+    key_journal_scan_result result;            /**< 검사 요약 */
+    unsigned long verdicts[QUERY_VERDICTS];    /**< 판정별 일치 수 */
+    unsigned long per_name[KEY_JOURNAL_MAX_NAMES + 1]; /**< 이름 번호별 일치 수 (마지막은 알 수 없음) */
+    key_journal_record* records;               /**< --list 지정 시 일치한 레코드 */
+    size_t record_count;                       /**< 모은 레코드 수 */
+    size_t record_capacity;                    /**< 레코드 배열 용량 */
+    int out_of_memory;                         /**< 레코드를 모으다 메모리가 부족했는지 여부 */
+} segment_job;
+
+/**
+ * @brief 조회 스레드가 공유하는 상태
+ */
+typedef struct query_context {
+    key_journal_query query;     /**< 조회 조건 */
+    segment_job* jobs;           /**< 세그먼트별 작업 */
+    unsigned long job_count;     /**< 세그먼트 수 */
+    unsigned long next_job;      /**< 다음에 가져갈 세그먼트 (원자적 접근) */
+    int list;                    /**< 일치한 레코드를 모아 출력할지 여부 */
+} query_context;
+
+/**
+ * @brief 조회 스레드 인자
+ */
+typedef struct query_worker {
+    query_context* context;      /**< 공유 상태 */
+    kp_thread thread;            /**< 스레드 핸들 */
+} query_worker;
+
+/**
+ * @brief 조건에 맞는 레코드를 세그먼트 결과에 더합니다.
+ */
+static void visit_record(void* user, const key_journal_segment* segment, const key_journal_record* record) {
+    segment_job* job = (segment_job*)user;
+    (void)segment;
+    if (record->verdict < QUERY_VERDICTS) {
+        job->verdicts[record->verdict]++;
+    }
+    job->per_name[(record->name_id < KEY_JOURNAL_MAX_NAMES) ? record->name_id : KEY_JOURNAL_MAX_NAMES]++;
+
+    if (job->list && !job->out_of_memory) {
+        if (job->record_count == job->record_capacity) {
+            size_t capacity = (job->record_capacity != 0) ? job->record_capacity * 2 : 1024;
+            key_journal_record* grown = (key_journal_record*)realloc(job->records, capacity * sizeof(*grown));
+            if (grown == NULL) {
+                job->out_of_memory = 1;
+                return;
+            }
+            job->records = grown;
+            job->record_capacity = capacity;
+        }
+        job->records[job->record_count++] = *record;
+    }
+}
+
+/**
+ * @brief 조회 스레드 함수 (남은 세그먼트가 없을 때까지 하나씩 가져가 검사)
+ */
+static void query_thread(void* arg) {
+    query_worker* worker = (query_worker*)arg;
+    query_context* context = worker->context;
+    for (;;) {
+        unsigned long index = kp_atomic_fetch_add(&context->next_job, 1UL);
+        if (index >= context->job_count) {
+            break;
+        }
+        segment_job* job = &context->jobs[index];
+        job->opened = key_journal_segment_open(&job->segment, job->path);
+        if (job->opened) {
+            key_journal_scan(&job->segment, &context->query, visit_record, job, &job->result);
+        }
+    }
+}
+
+/**
+ * @brief UTC 나노초를 ISO 8601 형식으로 출력합니다.
+ */
+static void print_time(unsigned long long timestamp_ns) {
+    time_t seconds = (time_t)(timestamp_ns / 1000000000ULL);
+    struct tm* utc = gmtime(&seconds);
+    if (utc == NULL) {
+        printf("%llu", timestamp_ns);
+        return;
+    }
+    printf("%04d-%02d-%02dT%02d:%02d:%02d.%06lluZ", utc->tm_year + 1900, utc->tm_mon + 1, utc->tm_mday,
+           utc->tm_hour, utc->tm_min, utc->tm_sec, (timestamp_ns / 1000ULL) % 1000000ULL);
+}
+
+/**
+ * @brief 판정 이름을 반환합니다.
+ */
+static const char* verdict_name(unsigned int verdict) {
+    switch (verdict) {
+    case LOG_VERDICT_ALLOWED: return "allowed";
+    case LOG_VERDICT_BLOCKED: return "blocked";
+    case LOG_VERDICT_UNKNOWN: return "unknown";
+    default:                  return "?";
+    }
+}
+
+/**
+ * @brief 프로세스별 합계 (세그먼트마다 이름 번호가 다르므로 이름으로 합침)
+ */
+typedef struct process_total {
+    const char* name;            /**< 이름 (매핑된 세그먼트를 가리킴, NULL이면 알 수 없음) */
+    size_t length;               /**< 이름 길이 */
+    unsigned long count;         /**< 일치 수 */
+} process_total;
+
+/**
+ * @brief 이름이 같은 합계 항목을 찾거나 추가합니다.
+ */
+static process_total* find_total(process_total* totals, size_t* count, size_t capacity,
+                                 const char* name, size_t length) {
+    for (size_t i = 0; i < *count; i++) {
+        if (totals[i].length == length &&
+            (length == 0 ? totals[i].name == name : memcmp(totals[i].name, name, length) == 0)) {
+            return &totals[i];
+        }
+    }
+    if (*count >= capacity) {
+        return NULL;
+    }
+    process_total* total = &totals[(*count)++];
+    total->name = name;
+    total->length = length;
+    total->count = 0;
+    return total;
+}
+
+static int compare_totals(const void* a, const void* b) {
+    unsigned long left = ((const process_total*)a)->count;
+    unsigned long right = ((const process_total*)b)->count;
+    return (left < right) ? 1 : (left > right) ? -1 : 0;
+}
+
+static void print_usage(const char* program) {
+    fprintf(stderr,
+            "사용법: %s [--from <유닉스 초>] [--to <유닉스 초>] [--process <이름>]\n"
+            "                  [--verdict allowed|blocked|unknown] [--threads <개수>] [--list]\n"
+            "                  [--key-file <저널 키 파일>] <세그먼트>...\n",
+            program);
+}
+
+int main(int argc, char* argv[]) {
+    static query_context context;
+    unsigned int thread_count = QUERY_DEFAULT_THREADS;
+    const char** paths = (const char**)calloc((size_t)argc, sizeof(const char*));
+    unsigned long path_count = 0;
+    const char* key_path = NULL;
+    uint32_t journal_key[8];
+    if (paths == NULL) {
+        return 1;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--from") == 0 && i + 1 < argc) {
+            context.query.from_ns = strtoull(argv[++i], NULL, 10) * 1000000000ULL;
+        } else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc) {
+            context.query.to_ns = strtoull(argv[++i], NULL, 10) * 1000000000ULL;
+        } else if (strcmp(argv[i], "--process") == 0 && i + 1 < argc) {
+            context.query.process = argv[++i];
+        } else if (strcmp(argv[i], "--verdict") == 0 && i + 1 < argc) {
+            const char* value = argv[++i];
+            unsigned int verdict;
+            for (verdict = 0; verdict < QUERY_VERDICTS && strcmp(value, verdict_name(verdict)) != 0; verdict++) {
+            }
+            if (verdict == QUERY_VERDICTS) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            context.query.verdict_mask |= 1U << verdict;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            thread_count = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--list") == 0) {
+            context.list = 1;
+        } else if (strcmp(argv[i], "--key-file") == 0 && i + 1 < argc) {
+            key_path = argv[++i];
+        } else if (argv[i][0] == '-') {
+            print_usage(argv[0]);
+            return 1;
+        } else {
+            paths[path_count++] = argv[i];
+        }
+    }
+    if (path_count == 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (key_path != NULL && !key_journal_read_key_file(key_path, journal_key)) {
+        fprintf(stderr, "[오류] 저널 키 파일을 읽을 수 없습니다: %s (16진수 %d자리)\n", key_path, KEY_JOURNAL_KEY_HEX_DIGITS);
+        return 1;
+    }
+    if (thread_count == 0) {
+        thread_count = 1;
+    }
+    if (thread_count > QUERY_MAX_THREADS) {
+        thread_count = QUERY_MAX_THREADS;
+    }
+    if (thread_count > path_count) {
+        thread_count = (unsigned int)path_count;
+    }
+
+    context.jobs = (segment_job*)calloc(path_count, sizeof(segment_job));
+    if (context.jobs == NULL) {
+        fprintf(stderr, "[오류] 메모리가 부족합니다.\n");
+        return 1;
+    }
+    context.job_count = path_count;
+    for (unsigned long i = 0; i < path_count; i++) {
+        context.jobs[i].path = paths[i];
+        context.jobs[i].list = context.list;
+    }
+
+    // 세그먼트를 병렬로 검사 (스레드 하나는 이 스레드가 맡음)
+    static query_worker workers[QUERY_MAX_THREADS];
+    unsigned long long start_ns = kp_now_ns();
+    for (unsigned int i = 1; i < thread_count; i++) {
+        workers[i].context = &context;
+        if (!kp_thread_start(&workers[i].thread, query_thread, &workers[i])) {
+            break;
+        }
+    }
+    workers[0].context = &context;
+    query_thread(&workers[0]);
+    for (unsigned int i = 1; i < thread_count; i++) {
+        kp_thread_join(&workers[i].thread);
+    }
+    unsigned long long elapsed_ns = kp_now_ns() - start_ns;
+
+    // 세그먼트 순서대로 결과 출력
+    key_journal_scan_result total = {0, 0, 0, 0, 0};
+    unsigned long verdicts[QUERY_VERDICTS] = {0, 0, 0};
+    unsigned long long bytes = 0;
+    unsigned long unreadable = 0;
+    unsigned long truncated = 0;
+    unsigned long locked = 0;
+    size_t total_count = 0;
+    size_t total_capacity = path_count * (KEY_JOURNAL_MAX_NAMES + 1);
+    process_total* totals = (process_total*)malloc(total_capacity * sizeof(process_total));
+    if (totals == NULL) {
+        fprintf(stderr, "[오류] 메모리가 부족합니다.\n");
+        return 1;
+    }
+
+    for (unsigned long i = 0; i < path_count; i++) {
+        segment_job* job = &context.jobs[i];
+        if (!job->opened) {
+            fprintf(stderr, "[경고] 저널 세그먼트가 아니거나 열 수 없습니다: %s\n", job->path);
+            unreadable++;
+            continue;
+        }
+        if (job->result.truncated) {
+            truncated++;
+        }
+        if (job->out_of_memory) {
+            fprintf(stderr, "[경고] 메모리가 부족하여 %s의 일부 레코드를 출력하지 못했습니다.\n", job->path);
+        }
+        // 저널 키가 맞는 세그먼트만 세션 키를 풀어 복호화
+        uint32_t session_key[8];
+        int decrypt = key_path != NULL && key_journal_unwrap_key(&job->segment, journal_key, session_key);
+        if (key_path != NULL && !decrypt) {
+            fprintf(stderr, "[경고] %s: 저널 키가 다르거나 감싼 세션 키가 없어 복호화할 수 없습니다.\n", job->path);
+            locked++;
+        }
+        for (size_t r = 0; r < job->record_count; r++) {
+            const key_journal_record* record = &job->records[r];
+            size_t length = 0;
+            const char* name = key_journal_segment_name(&job->segment, record->name_id, &length);
+            print_time(record->timestamp_ns);
+            printf("  %-8s %08x %08x", verdict_name(record->verdict), record->encrypted_keycode, record->salt);
+            if (decrypt) {
+                printf("  vk %3u", key_journal_decrypt(session_key, job->segment.key_info.nonce, record));
+            }
+            printf("  %.*s\n", (int)length, (name != NULL) ? name : "?");
+        }
+        memset(session_key, 0, sizeof(session_key));
+
+        total.blocks += job->result.blocks;
+        total.blocks_skipped += job->result.blocks_skipped;
+        total.records += job->result.records;
+        total.matched += job->result.matched;
+        bytes += job->segment.map.size;
+        for (int v = 0; v < QUERY_VERDICTS; v++) {
+            verdicts[v] += job->verdicts[v];
+        }
+        for (unsigned int n = 0; n <= KEY_JOURNAL_MAX_NAMES; n++) {
+            if (job->per_name[n] == 0) {
+                continue;
+            }
+            size_t length = 0;
+            const char* name = key_journal_segment_name(&job->segment, n, &length);
+            process_total* entry = find_total(totals, &total_count, total_capacity, name, length);
+            if (entry != NULL) {
+                entry->count += job->per_name[n];
+            }
+        }
+    }
+
+    double seconds = (double)elapsed_ns / 1e9;
+    printf("[조회] 세그먼트 %lu개 (읽기 실패 %lu, 잘림 %lu), %.1f MB, 스레드 %u개, %.3f ms (%.0f MB/s)\n",
+           path_count, unreadable, truncated, (double)bytes / 1e6, thread_count, (double)elapsed_ns / 1e6,
+           (seconds > 0.0) ? (double)bytes / 1e6 / seconds : 0.0);
+    if (key_path != NULL) {
+        printf("[조회] 복호화: 세그먼트 %lu개 중 %lu개 (저널 키 불일치 또는 키 없음 %lu)\n",
+               path_count - unreadable, path_count - unreadable - locked, locked);
+    }
+    printf("[조회] 블록: 검사 %lu | 시각 범위 밖 건너뜀 %lu | 레코드 %lu | 일치 %lu\n",
+           total.blocks, total.blocks_skipped, total.records, total.matched);
+    printf("[조회] 판정: 허용 %lu | 차단 %lu | 확인 실패 %lu\n",
+           verdicts[LOG_VERDICT_ALLOWED], verdicts[LOG_VERDICT_BLOCKED], verdicts[LOG_VERDICT_UNKNOWN]);
+    qsort(totals, total_count, sizeof(process_total), compare_totals);
+    for (size_t i = 0; i < total_count; i++) {
+        printf("[조회] 프로세스 %.*s: %lu\n", (int)totals[i].length,
+               (totals[i].name != NULL) ? totals[i].name : "?", totals[i].count);
+    }
+
+    for (unsigned long i = 0; i < path_count; i++) {
+        free(context.jobs[i].records);
+        if (context.jobs[i].opened) {
+            key_journal_segment_close(&context.jobs[i].segment);
+        }
+    }
+    memset(journal_key, 0, sizeof(journal_key));
+    free(totals);
+    free(context.jobs);
+    free(paths);
+    return (unreadable == 0) ? 0 : 1;
+}
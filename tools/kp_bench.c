@@ -0,0 +1,829 @@
+/**
+ * @file kp_bench.c
+ * @brief 플랫폼 독립 코어 마이크로벤치마크
+ * @details libkpcore의 핵심 경로를 가짜 백엔드(포그라운드, 솔트, 주입)로 실행하여 연산 하나의 비용을 측정합니다.
+ *          Win32 API를 쓰지 않으므로 Linux 빌드 환경에서도 실행할 수 있으며,
+ *          --json을 지정하면 회귀 추적용으로 결과를 JSON 파일에도 기록합니다.
+ *
+ *          사용법:
+ *            kp_bench [--filter <이름 일부>] [--min-ms <밀리초>] [--runs <횟수>] [--json <파일>]
+ *
+ *          측정 항목:
+ *            crypto/...    encrypt_keycode_with_salt, decrypt_keycode_with_salt
+ *            allowlist/... IsAllowedProcess와 같은 경로 (정책 진입 + 해시 조회 + 종료),
+ *                          항목 10/100/10000개에서 해시 조회와 이전 선형 _stricmp 탐색 비교 (4번에 1번은 없는 이름)
+ *            ini/...       INI 파서 단일 패스 (항목 72개 측정용 INI, 주석과 CRLF가 섞인 항목 10000개 INI)
+ *            policy/...    LoadAllowedProcessesFromIni와 같은 경로 (INI 파싱 + 스냅샷 게시/회수), 키 규칙 판정
+ *            processor/... 키 다운/업 전체 경로 (판정 캐시 적중, 캐시 무효화 후 재판정, 자동 반복)
+ *            delivery/...  공유 메모리 전달 링에 16개씩 넣고 한 번에 읽어 복호화 (키 하나당 시간)
+ *            governor/...  후크 심장 박동과 지연 표본 기록 (후크 안에서 키 하나마다 더해지는 비용)
+ *            shadow/...    그림자 모드 키 다운/업 (현재 정책과 후보 정책 판정 + 집계, 자체 시간 측정 포함)
+ *            device/...    장치 16개 테이블 조회, Raw Input과 후크 이벤트 짝짓기 (키 다운/업 한 쌍)
+ *            inject/...    주입 묶음에 키 다운/업 넣기 (16개씩 가짜 출력으로 내보냄, 가상 키 코드와 문자 경로)
+ */
+#include "crypto_keycode.h"
+#include "policy_loader.h"
+#include "ini_parser.h"
+#include "policy_store.h"
+#include "hook_governor.h"
+#include "shadow_audit.h"
+#include "key_processor.h"
+#include "key_delivery.h"
+#include "device_table.h"
+#include "input_correlator.h"
+#include "inject_batch.h"
+#include "kp_platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** @brief 측정 결과의 최대 개수 */
+#define BENCH_MAX_RESULTS 32
+
+/** @brief 반복 횟수를 정할 때 한 번에 걸려야 하는 최소 시간 */
+#define BENCH_CALIBRATE_NS 10000000ULL
+
+/** @brief 전달 링 측정에서 한 번에 넣고 읽는 키 수 */
+#define BENCH_DELIVERY_BATCH 16
+
+/** @brief 장치 테이블 측정에 등록하는 장치 수 */
+#define BENCH_DEVICES 16
+
+/** @brief 허용 목록 크기별 측정의 크기 수 */
+#define BENCH_SCALE_COUNT 3
+
+/** @brief 허용 목록 크기별 측정에서 돌아가며 조회하는 이름 수 */
+#define BENCH_SCALE_QUERIES 64
+
+/** @brief 선형 탐색 비교용 이름 칸 크기 (이전 g_allowedProcesses[][MAX_PATH]와 같음) */
+#define BENCH_NAME_SIZE 260
+
+/** @brief 큰 INI 파싱 측정의 항목 수 */
+#define BENCH_LARGE_INI_ENTRIES 10000
+
+/** @brief 가짜 포그라운드 프로세스 이름 */
+#define BENCH_FOREGROUND "notepad++.exe"
+
+/**
+ * @brief 측정 항목
+ */
+typedef struct bench_case {
+    const char* name;                              /**< 항목 이름 (분류/이름) */
+    unsigned long (*run)(unsigned long iterations); /**< 연산을 iterations번 수행하고 결과 합을 반환 */
+} bench_case;
+
+/**
+ * @brief 측정 결과
+ */
+typedef struct bench_result {
+    const char* name;          /**< 항목 이름 */
+    double ns_median;          /**< 연산당 시간 중앙값 (ns) */
+    double ns_min;             /**< 연산당 시간 최소값 (ns) */
+    unsigned long long ops;    /**< 측정한 전체 연산 수 */
+} bench_result;
+
+/**
+ * @brief 허용 목록 크기 하나의 해시 목록과 선형 탐색 비교 대상
+ */
+typedef struct bench_scale {
+    unsigned long size;                         /**< 항목 수 */
+    allowlist hashed;                           /**< 해시 허용 목록 */
+    char (*linear)[BENCH_NAME_SIZE];            /**< 이전 방식의 고정 크기 이름 배열 */
+    char queries[BENCH_SCALE_QUERIES][32];      /**< 조회할 이름 (대소문자 섞음) */
+} bench_scale;
+
+/**
+ * @brief 가짜 백엔드와 측정 대상 상태
+ */
+typedef struct bench_fixture {
+    policy_store store;              /**< 정책 저장소 */
+    policy_snapshot* policy;         /**< 현재 정책 */
+    foreground_cache cache;          /**< 판정 캐시 */
+    key_processor processor;         /**< 처리 코어 */
+    unsigned long salt_counter;      /**< 가짜 솔트 카운터 */
+    unsigned long injected;          /**< 가짜 주입 체크섬 */
+    char* ini;                       /**< 측정용 INI 내용 */
+    size_t ini_size;                 /**< INI 길이 */
+    char* large_ini;                 /**< 파서 측정용 큰 INI 내용 */
+    size_t large_ini_size;           /**< 큰 INI 길이 */
+    key_delivery_channel channel;    /**< 전달 링 생산자 */
+    key_delivery_client client;      /**< 전달 링 소비자 (같은 프로세스에서 연결) */
+    int delivery_ready;              /**< 전달 링을 만들었는지 여부 */
+    policy_snapshot* candidate;      /**< 그림자 모드 후보 정책 (현재 정책과 같은 내용) */
+    shadow_audit audit;              /**< 그림자 집계 */
+    device_table devices;            /**< 장치 테이블 (BENCH_DEVICES개 등록) */
+    input_correlator correlator;     /**< 짝짓기 상태 */
+    unsigned long released;          /**< 짝짓기가 끝난 이벤트 체크섬 */
+    inject_batch batch;              /**< 주입 묶음 (가짜 출력) */
+    bench_scale scales[BENCH_SCALE_COUNT]; /**< 허용 목록 크기별 측정 대상 */
+} bench_fixture;
+
+static bench_fixture g_fixture;
+
+/** @brief 결과 합 (최적화로 측정 대상이 사라지지 않도록 사용) */
+static volatile unsigned long g_sink;
+
+/**
+ * @brief 가짜 공급자: 항상 같은 창과 프로세스
+ */
+static int fake_get_foreground(void* context, foreground_identity* identity) {
+    (void)context;
+    identity->window = 0x1000;
+    identity->process_id = 4242;
+    identity->start_time = 1;
+    return 1;
+}
+
+/**
+ * @brief 가짜 공급자: 고정된 프로세스 이름
+ */
+static int fake_get_process_name(void* context, const foreground_identity* identity, char* name, size_t name_size) {
+    (void)context;
+    (void)identity;
+    strncpy(name, BENCH_FOREGROUND, name_size - 1);
+    name[name_size - 1] = '\0';
+    return 1;
+}
+
+/**
+ * @brief 정책의 허용 목록으로 판정 (허용이면 키 규칙 번호 + 1)
+ */
+static int fake_verdict(const char* process_name, void* user) {
+    (void)user;
+    return (int)allowlist_value(&g_fixture.policy->allowed, process_name);
+}
+
+/**
+ * @brief 가짜 솔트 (키스트림 풀 대신 카운터 해시를 워드로, 카운터를 위치로 사용)
+ */
+static unsigned int fake_make_salt(void* context, unsigned int* pad) {
+    (void)context;
+    *pad = (unsigned int)(++g_fixture.salt_counter * 2654435761UL);
+    return (unsigned int)g_fixture.salt_counter;
+}
+
+/**
+ * @brief 가짜 키 주입 (체크섬만 갱신)
+ */
+static int fake_inject(void* context, unsigned int vk_code, int key_down) {
+    (void)context;
+    g_fixture.injected = g_fixture.injected * 31UL + vk_code * 2UL + (key_down ? 1UL : 0UL);
+    return 1;
+}
+
+/**
+ * @brief 짝짓기가 끝난 이벤트를 받음 (체크섬만 갱신)
+ */
+static void fake_release(const key_event* event, uintptr_t device, void* user) {
+    (void)user;
+    g_fixture.released = g_fixture.released * 31UL + event->vk_code + (unsigned long)device;
+}
+
+/**
+ * @brief 가짜 묶음 출력 (받은 키의 체크섬만 갱신)
+ */
+static size_t fake_send(void* context, const inject_key* keys, size_t count) {
+    (void)context;
+    for (size_t i = 0; i < count; i++) {
+        g_fixture.injected = g_fixture.injected * 31UL + keys[i].vk_code * 2UL + keys[i].unicode + keys[i].flags;
+    }
+    return count;
+}
+
+/**
+ * @brief 가짜 문자 변환 (글자 키만)
+ */
+static unsigned int fake_translate(void* context, unsigned int vk_code, int shift, int caps_lock) {
+    (void)context;
+    if (vk_code >= 'A' && vk_code <= 'Z') {
+        return (shift != caps_lock) ? vk_code : vk_code + ('a' - 'A');
+    }
+    return 0;
+}
+
+static const process_lookup_provider g_fake_provider = { NULL, fake_get_foreground, fake_get_process_name };
+
+/**
+ * @brief 허용 프로세스 64개와 키 규칙 8개로 된 측정용 INI를 만듭니다.
+ */
+static int build_ini(void) {
+    size_t capacity = 16384;
+    char* ini = (char*)malloc(capacity);
+    if (ini == NULL) {
+        return 0;
+    }
+    size_t used = (size_t)snprintf(ini, capacity, "[AllowedProcesses]\nProcess0=%s\n", BENCH_FOREGROUND);
+    for (int i = 1; i < 64; i++) {
+        used += (size_t)snprintf(ini + used, capacity - used, "Process%d=app%02d.exe\n", i, i);
+    }
+    used += (size_t)snprintf(ini + used, capacity - used, "\n[KeyRules]\n");
+    for (int i = 0; i < 8; i++) {
+        used += (size_t)snprintf(ini + used, capacity - used, "term%d.exe=alnum punct edit nav | -ctrl -alt\n", i);
+    }
+    used += (size_t)snprintf(ini + used, capacity - used,
+                             "\n[Logging]\nVerbosity=0\n\n[Injection]\nForeign=process\n");
+    g_fixture.ini = ini;
+    g_fixture.ini_size = used;
+    return 1;
+}
+
+/**
+ * @brief 주석과 CRLF 줄바꿈이 섞인 항목 BENCH_LARGE_INI_ENTRIES개짜리 INI를 만듭니다.
+ */
+static int build_large_ini(void) {
+    size_t capacity = (size_t)BENCH_LARGE_INI_ENTRIES * 48 + 64;
+    char* ini = (char*)malloc(capacity);
+    if (ini == NULL) {
+        return 0;
+    }
+    size_t used = (size_t)snprintf(ini, capacity, "[AllowedProcesses]\r\n");
+    for (int i = 0; i < BENCH_LARGE_INI_ENTRIES; i++) {
+        if (i % 10 == 0) {
+            used += (size_t)snprintf(ini + used, capacity - used, "; group %d\r\n", i / 10);
+        }
+        used += (size_t)snprintf(ini + used, capacity - used, "App%d = \"fleetapp%05d.exe\"\r\n", i, i);
+    }
+    g_fixture.large_ini = ini;
+    g_fixture.large_ini_size = used;
+    return 1;
+}
+
+/**
+ * @brief 허용 목록 크기 하나의 해시 목록, 선형 배열, 조회 이름을 만듭니다.
+ */
+static int setup_scale(bench_scale* scale, unsigned long size) {
+    scale->size = size;
+    allowlist_init(&scale->hashed);
+    scale->linear = (char (*)[BENCH_NAME_SIZE])calloc(size, BENCH_NAME_SIZE);
+    if (scale->linear == NULL) {
+        return 0;
+    }
+    for (unsigned long i = 0; i < size; i++) {
+        snprintf(scale->linear[i], BENCH_NAME_SIZE, "fleetapp%05lu.exe", i);
+        if (!allowlist_add(&scale->hashed, scale->linear[i])) {
+            return 0;
+        }
+    }
+    for (unsigned long i = 0; i < BENCH_SCALE_QUERIES; i++) {
+        if ((i & 3) == 3) {
+            snprintf(scale->queries[i], sizeof(scale->queries[i]), "unknown%02lu.exe", i);
+        } else {
+            snprintf(scale->queries[i], sizeof(scale->queries[i]), "FleetApp%05lu.EXE",
+                     (unsigned long)((i * 2654435761UL) % size));
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief 측정 대상 상태를 준비합니다.
+ */
+static int setup_fixture(void) {
+    policy_load_set_quiet(1);
+    if (!build_ini() || !build_large_ini()) {
+        return 0;
+    }
+    policy_load_status status = POLICY_LOAD_OK;
+    g_fixture.policy = policy_load_buffer(g_fixture.ini, g_fixture.ini_size, &status);
+    if (g_fixture.policy == NULL) {
+        return 0;
+    }
+    policy_store_init(&g_fixture.store);
+    policy_store_publish(&g_fixture.store, g_fixture.policy);
+
+    key_processor_backend backend = { NULL, fake_make_salt, fake_inject, NULL };
+    foreground_cache_init(&g_fixture.cache, &g_fake_provider, fake_verdict, NULL);
+    key_processor_init(&g_fixture.processor, &g_fixture.cache, &backend, NULL);
+    g_fixture.processor.policy = &g_fixture.policy->keys;
+    g_fixture.candidate = policy_load_buffer(g_fixture.ini, g_fixture.ini_size, &status);
+    if (g_fixture.candidate == NULL) {
+        return 0;
+    }
+    g_fixture.candidate->version = 1;
+    shadow_audit_init(&g_fixture.audit);
+
+    // Raw Input 장치 핸들처럼 4의 배수인 핸들로 장치 등록 (절반은 규칙에 걸림)
+    device_rules rules;
+    device_rules_init(&rules);
+    device_rules_add(&rules, "VID_05E0", DEVICE_CLASS_TRUSTED);
+    device_table_init(&g_fixture.devices);
+    for (int i = 0; i < BENCH_DEVICES; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "\\\\?\\HID#VID_%04X&PID_%04X#%d",
+                 (i & 1) ? 0x05E0 : 0x046D, 0x1200 + i, i);
+        device_table_insert(&g_fixture.devices, (uintptr_t)(0x10000 + i * 4), name, &rules);
+    }
+    input_correlator_init(&g_fixture.correlator, fake_release, NULL);
+    static const unsigned long scale_sizes[BENCH_SCALE_COUNT] = { 10, 100, 10000 };
+    for (int i = 0; i < BENCH_SCALE_COUNT; i++) {
+        if (!setup_scale(&g_fixture.scales[i], scale_sizes[i])) {
+            return 0;
+        }
+    }
+    inject_sink sink = { NULL, fake_send, fake_translate };
+    inject_batch_init(&g_fixture.batch, &sink, INJECT_BATCH_DEFAULT_LIMIT, 0);
+
+    // 공유 메모리를 만들 수 없는 환경에서는 전달 링 항목만 건너뜀
+    key_delivery_grant grant;
+    if (key_delivery_channel_open(&g_fixture.channel, kp_process_id(), &grant)) {
+        g_fixture.delivery_ready = key_delivery_client_attach(&g_fixture.client, &grant);
+        if (!g_fixture.delivery_ready) {
+            key_delivery_channel_close(&g_fixture.channel);
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief 측정 대상 상태를 정리합니다.
+ */
+static void teardown_fixture(void) {
+    if (g_fixture.delivery_ready) {
+        key_delivery_client_close(&g_fixture.client);
+        key_delivery_channel_close(&g_fixture.channel);
+    }
+    policy_store_destroy(&g_fixture.store);
+    policy_snapshot_destroy(g_fixture.candidate);
+    free(g_fixture.ini);
+    free(g_fixture.large_ini);
+    for (int i = 0; i < BENCH_SCALE_COUNT; i++) {
+        allowlist_free(&g_fixture.scales[i].hashed);
+        free(g_fixture.scales[i].linear);
+    }
+}
+
+static unsigned long bench_encrypt(unsigned long iterations) {
+    unsigned long sum = 0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        sum += encrypt_keycode_with_salt((unsigned int)(i & 0xFF), (unsigned int)(i * 2654435761UL));
+    }
+    return sum;
+}
+
+static unsigned long bench_decrypt(unsigned long iterations) {
+    unsigned long sum = 0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        sum += decrypt_keycode_with_salt((unsigned int)i, (unsigned int)(i * 2654435761UL));
+    }
+    return sum;
+}
+
+/**
+ * @brief IsAllowedProcess와 같은 경로로 이름 하나를 판정합니다.
+ */
+static unsigned long is_allowed(const char* name) {
+    policy_snapshot* policy = policy_store_enter(&g_fixture.store);
+    unsigned long rule = (policy != NULL) ? allowlist_value(&policy->allowed, name) : 0;
+    policy_store_exit(&g_fixture.store);
+    return rule;
+}
+
+static unsigned long bench_allowlist_hit(unsigned long iterations) {
+    static const char* names[] = { "NOTEPAD++.EXE", "app17.exe", "term3.exe", "App42.exe" };
+    unsigned long sum = 0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        sum += is_allowed(names[i & 3]);
+    }
+    return sum;
+}
+
+static unsigned long bench_allowlist_miss(unsigned long iterations) {
+    static const char* names[] = { "chrome.exe", "explorer.exe", "app99.exe", "keylogger.exe" };
+    unsigned long sum = 0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        sum += is_allowed(names[i & 3]);
+    }
+    return sum;
+}
+
+/**
+ * @brief 이전 IsAllowedProcess의 _stricmp와 같은 대소문자 무시 비교
+ */
+static int linear_stricmp(const char* a, const char* b) {
+    for (;; a++, b++) {
+        int ca = (*a >= 'A' && *a <= 'Z') ? *a + ('a' - 'A') : (unsigned char)*a;
+        int cb = (*b >= 'A' && *b <= 'Z') ? *b + ('a' - 'A') : (unsigned char)*b;
+        if (ca != cb || ca == 0) {
+            return ca - cb;
+        }
+    }
+}
+
+/**
+ * @brief 이전 방식: 고정 크기 배열을 처음부터 _stricmp로 탐색
+ */
+static unsigned long scale_linear(const bench_scale* scale, unsigned long iterations) {
+    unsigned long sum = 0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        const char* name = scale->queries[i & (BENCH_SCALE_QUERIES - 1)];
+        for (unsigned long j = 0; j < scale->size; j++) {
+            if (linear_stricmp(name, scale->linear[j]) == 0) {
+                sum += j + 1;
+                break;
+            }
+        }
+    }
+    return sum;
+}
+
+/**
+ * @brief 해시 허용 목록 조회
+ */
+static unsigned long scale_hashed(const bench_scale* scale, unsigned long iterations) {
+    unsigned long sum = 0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        sum += allowlist_value(&scale->hashed, scale->queries[i & (BENCH_SCALE_QUERIES - 1)]);
+    }
+    return sum;
+}
+
+static unsigned long bench_linear_10(unsigned long iterations) {
+    return scale_linear(&g_fixture.scales[0], iterations);
+}
+
+static unsigned long bench_linear_100(unsigned long iterations) {
+    return scale_linear(&g_fixture.scales[1], iterations);
+}
+
+static unsigned long bench_linear_10000(unsigned long iterations) {
+    return scale_linear(&g_fixture.scales[2], iterations);
+}
+
+static unsigned long bench_hashed_10(unsigned long iterations) {
+    return scale_hashed(&g_fixture.scales[0], iterations);
+}
+
+static unsigned long bench_hashed_100(unsigned long iterations) {
+    return scale_hashed(&g_fixture.scales[1], iterations);
+}
+
+static unsigned long bench_hashed_10000(unsigned long iterations) {
+    return scale_hashed(&g_fixture.scales[2], iterations);
+}
+
+/**
+ * @brief 파서 측정용 항목 콜백 (값 길이만 더함)
+ */
+static int count_entry(void* user, const ini_entry* entry) {
+    *(unsigned long*)user += entry->value.len + 1;
+    return 1;
+}
+
+/**
+ * @brief INI 내용 하나를 iterations번 파싱합니다.
+ */
+static unsigned long parse_ini(const char* data, size_t size, unsigned long iterations) {
+    unsigned long sum = 0;
+    ini_handler handler = { count_entry, NULL, &sum };
+    for (unsigned long i = 0; i < iterations; i++) {
+        sum += (unsigned long)ini_parse(data, size, &handler);
+    }
+    return sum;
+}
+
+static unsigned long bench_ini_parse(unsigned long iterations) {
+    return parse_ini(g_fixture.ini, g_fixture.ini_size, iterations);
+}
+
+static unsigned long bench_ini_parse_large(unsigned long iterations) {
+    return parse_ini(g_fixture.large_ini, g_fixture.large_ini_size, iterations);
+}
+
+/**
+ * @brief LoadAllowedProcessesFromIni와 같은 경로 (파일 읽기 제외): 파싱, 게시, 이전 스냅샷 회수
+ */
+static unsigned long bench_policy_load(unsigned long iterations) {
+    static policy_store store;
+    policy_store_init(&store);
+    unsigned long sum = 0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        policy_load_status status = POLICY_LOAD_OK;
+        policy_snapshot* snapshot = policy_load_buffer(g_fixture.ini, g_fixture.ini_size, &status);
+        if (snapshot == NULL) {
+            break;
+        }
+        sum += allowlist_count(&snapshot->allowed);
+        policy_store_publish(&store, snapshot);
+        policy_store_reclaim(&store);
+    }
+    policy_store_destroy(&store);
+    return sum;
+}
+
+static unsigned long bench_key_rule(unsigned long iterations) {
+    const key_policy* keys = &g_fixture.policy->keys;
+    unsigned long sum = 0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        sum += (unsigned long)key_policy_allows(keys, (unsigned int)(i % keys->count),
+                                                (unsigned int)((i * 7) & 0xFF), (unsigned int)(i >> 8) & 15U);
+    }
+    return sum;
+}
+
+/**
+ * @brief 키 하나의 다운/업 쌍을 처리합니다.
+ */
+static unsigned long press_key(unsigned int vk_code) {
+    key_event event;
+    memset(&event, 0, sizeof(event));
+    event.vk_code = vk_code;
+    event.message = KEY_MESSAGE_KEYDOWN;
+    unsigned long verdicts = (unsigned long)key_processor_handle(&g_fixture.processor, &event, NULL);
+    event.message = KEY_MESSAGE_KEYUP;
+    verdicts += (unsigned long)key_processor_handle(&g_fixture.processor, &event, NULL);
+    return verdicts;
+}
+
+static unsigned long bench_key_path(unsigned long iterations) {
+    unsigned long sum = 0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        sum += press_key('A' + (unsigned int)(i % 26));
+    }
+    return sum + g_fixture.injected;
+}
+
+static unsigned long bench_key_path_refresh(unsigned long iterations) {
+    unsigned long sum = 0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        // 포그라운드 변경 알림을 받은 것처럼 매번 캐시를 무효화 (공급자 조회 + 허용 목록 재판정)
+        foreground_cache_invalidate(&g_fixture.cache);
+        sum += press_key('A' + (unsigned int)(i % 26));
+    }
+    return sum + g_fixture.injected;
+}
+
+static unsigned long bench_key_repeat(unsigned long iterations) {
+    key_event event;
+    memset(&event, 0, sizeof(event));
+    event.vk_code = 'J';
+    event.message = KEY_MESSAGE_KEYDOWN;
+    unsigned long sum = (unsigned long)key_processor_handle(&g_fixture.processor, &event, NULL);
+    for (unsigned long i = 0; i < iterations; i++) {
+        sum += (unsigned long)key_processor_handle(&g_fixture.processor, &event, NULL);
+    }
+    event.message = KEY_MESSAGE_KEYUP;
+    sum += (unsigned long)key_processor_handle(&g_fixture.processor, &event, NULL);
+    return sum + g_fixture.injected;
+}
+
+static unsigned long bench_delivery(unsigned long iterations) {
+    key_delivery_key keys[BENCH_DELIVERY_BATCH];
+    unsigned long sum = 0;
+    if (!g_fixture.delivery_ready) {
+        return 0;
+    }
+    for (unsigned long i = 0; i < iterations; i++) {
+        key_delivery_push(&g_fixture.channel, (uint32_t)(i & 0xFF), KEY_MESSAGE_KEYDOWN, (uint32_t)i);
+        if ((i + 1) % BENCH_DELIVERY_BATCH == 0 || i + 1 == iterations) {
+            size_t count = key_delivery_client_read(&g_fixture.client, keys, BENCH_DELIVERY_BATCH, 0);
+            for (size_t k = 0; k < count; k++) {
+                sum += keys[k].vk_code;
+            }
+        }
+    }
+    return sum;
+}
+
+static unsigned long bench_governor(unsigned long iterations) {
+    static hook_governor governor;
+    hook_governor_config config;
+    hook_governor_default_config(&config, 300, 0);
+    hook_governor_init(&governor, &config, 0);
+    for (unsigned long i = 0; i < iterations; i++) {
+        hook_governor_heartbeat(&governor, i);
+        hook_governor_sample(&governor, (uint64_t)(i & 0xFFFF) * 64ULL);
+    }
+    return governor.window_samples + governor.window_over;
+}
+
+static unsigned long bench_shadow(unsigned long iterations) {
+    key_event event;
+    memset(&event, 0, sizeof(event));
+    unsigned long sum = 0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        event.vk_code = 'A' + (unsigned int)(i % 26);
+        event.message = KEY_MESSAGE_KEYDOWN;
+        sum += (unsigned long)shadow_audit_handle(&g_fixture.audit, &g_fixture.cache, g_fixture.policy,
+                                                  g_fixture.candidate, &event);
+        event.message = KEY_MESSAGE_KEYUP;
+        sum += (unsigned long)shadow_audit_handle(&g_fixture.audit, &g_fixture.cache, g_fixture.policy,
+                                                  g_fixture.candidate, &event);
+    }
+    return sum + g_fixture.audit.key_downs;
+}
+
+static unsigned long bench_device_find(unsigned long iterations) {
+    unsigned long sum = 0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        device_entry* entry = device_table_find(&g_fixture.devices, (uintptr_t)(0x10000 + (i % BENCH_DEVICES) * 4));
+        sum += (entry != NULL) ? (unsigned long)entry->device_class + 1 : 0;
+    }
+    return sum;
+}
+
+static unsigned long bench_device_correlate(unsigned long iterations) {
+    key_event event;
+    memset(&event, 0, sizeof(event));
+    unsigned long long now = 0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        unsigned int scan_key = INPUT_SCAN_KEY(0x10 + (i % 26), 0);
+        uintptr_t device = (uintptr_t)(0x10000 + (i % BENCH_DEVICES) * 4);
+        event.vk_code = 'A' + (unsigned int)(i % 26);
+        for (int down = 1; down >= 0; down--) {
+            now += 1000;
+            event.message = down ? KEY_MESSAGE_KEYDOWN : KEY_MESSAGE_KEYUP;
+            input_correlator_raw(&g_fixture.correlator, device, scan_key, down, now);
+            input_correlator_hook(&g_fixture.correlator, &event, scan_key, now + 100);
+        }
+    }
+    return g_fixture.released + g_fixture.correlator.stats.early_matches;
+}
+
+/**
+ * @brief 주입 묶음에 키 다운/업 한 쌍을 넣습니다. (대상 창은 바뀌지 않음, 기한은 넘지 않음)
+ */
+static unsigned long bench_inject_run(unsigned long iterations, int unicode) {
+    inject_batch_configure(&g_fixture.batch, INJECT_BATCH_DEFAULT_LIMIT, 0, unicode);
+    unsigned long long now = kp_now_ns();
+    for (unsigned long i = 0; i < iterations; i++) {
+        unsigned int vk_code = 'A' + (unsigned int)(i % 26);
+        inject_batch_add(&g_fixture.batch, vk_code, 1, 0x1000, now);
+        inject_batch_add(&g_fixture.batch, vk_code, 0, 0x1000, now);
+    }
+    inject_batch_flush(&g_fixture.batch, INJECT_FLUSH_IDLE);
+    return g_fixture.injected + g_fixture.batch.stats.sends;
+}
+
+static unsigned long bench_inject_batch(unsigned long iterations) {
+    return bench_inject_run(iterations, 0);
+}
+
+static unsigned long bench_inject_unicode(unsigned long iterations) {
+    return bench_inject_run(iterations, 1);
+}
+
+static const bench_case g_cases[] = {
+    { "crypto/encrypt_keycode_with_salt", bench_encrypt },
+    { "crypto/decrypt_keycode_with_salt", bench_decrypt },
+    { "allowlist/is_allowed_hit", bench_allowlist_hit },
+    { "allowlist/is_allowed_miss", bench_allowlist_miss },
+    { "allowlist/linear_scan_10", bench_linear_10 },
+    { "allowlist/hashed_10", bench_hashed_10 },
+    { "allowlist/linear_scan_100", bench_linear_100 },
+    { "allowlist/hashed_100", bench_hashed_100 },
+    { "allowlist/linear_scan_10000", bench_linear_10000 },
+    { "allowlist/hashed_10000", bench_hashed_10000 },
+    { "ini/parse_72_entries", bench_ini_parse },
+    { "ini/parse_10000_entries", bench_ini_parse_large },
+    { "policy/load_publish_72_entries", bench_policy_load },
+    { "policy/key_rule_allows", bench_key_rule },
+    { "processor/key_down_up", bench_key_path },
+    { "processor/key_down_up_refresh", bench_key_path_refresh },
+    { "processor/key_repeat", bench_key_repeat },
+    { "delivery/push_read_batch16", bench_delivery },
+    { "governor/heartbeat_sample", bench_governor },
+    { "shadow/key_down_up_candidate", bench_shadow },
+    { "device/table_find_16", bench_device_find },
+    { "device/correlate_raw_first", bench_device_correlate },
+    { "inject/batch16_key_down_up", bench_inject_batch },
+    { "inject/batch16_unicode_down_up", bench_inject_unicode }
+};
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief 항목 하나를 측정합니다.
+ * @details 한 번에 BENCH_CALIBRATE_NS 이상 걸리는 반복 횟수를 찾은 뒤, 전체 시간이 min_ms가 되도록
+ *          runs번 나누어 실행하여 연산당 시간의 중앙값과 최소값을 구합니다.
+ */
+static void run_case(const bench_case* entry, unsigned long min_ms, int runs, bench_result* result) {
+    unsigned long iterations = 1;
+    unsigned long long elapsed = 0;
+    for (;;) {
+        unsigned long long start = kp_now_ns();
+        g_sink += entry->run(iterations);
+        elapsed = kp_now_ns() - start;
+        if (elapsed >= BENCH_CALIBRATE_NS || iterations >= (1UL << 30)) {
+            break;
+        }
+        iterations *= 2;
+    }
+    double per_op = (double)elapsed / (double)iterations;
+    double target = (double)min_ms * 1e6 / (double)runs;
+    unsigned long batch = (per_op > 0.0) ? (unsigned long)(target / per_op) : iterations;
+    if (batch == 0) {
+        batch = 1;
+    }
+
+    double samples[64];
+    result->name = entry->name;
+    result->ops = 0;
+    for (int run = 0; run < runs; run++) {
+        unsigned long long start = kp_now_ns();
+        g_sink += entry->run(batch);
+        samples[run] = (double)(kp_now_ns() - start) / (double)batch;
+        result->ops += batch;
+    }
+    qsort(samples, (size_t)runs, sizeof(double), compare_double);
+    result->ns_median = samples[runs / 2];
+    result->ns_min = samples[0];
+}
+
+/**
+ * @brief 결과를 JSON 파일로 기록합니다.
+ */
+static int write_json(const char* path, const bench_result* results, int count, unsigned long min_ms, int runs) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        return 0;
+    }
+    fprintf(file, "{\n  \"schema\": \"kp_bench/1\",\n  \"timestamp_unix\": %llu,\n",
+            kp_wall_time_ns() / 1000000000ULL);
+#ifdef _WIN32
+    fprintf(file, "  \"platform\": \"windows\",\n");
+#else
+    fprintf(file, "  \"platform\": \"posix\",\n");
+#endif
+    fprintf(file, "  \"min_ms\": %lu,\n  \"runs\": %d,\n  \"results\": [\n", min_ms, runs);
+    for (int i = 0; i < count; i++) {
+        fprintf(file, "    { \"name\": \"%s\", \"ns_per_op\": %.3f, \"ns_per_op_min\": %.3f, \"ops\": %llu }%s\n",
+                results[i].name, results[i].ns_median, results[i].ns_min, results[i].ops,
+                (i + 1 < count) ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    return fclose(file) == 0;
+}
+
+static void print_usage(const char* program) {
+    fprintf(stderr, "사용법: %s [--filter <이름 일부>] [--min-ms <밀리초>] [--runs <횟수>] [--json <파일>]\n", program);
+}
+
+int main(int argc, char* argv[]) {
+    const char* filter = NULL;
+    const char* json_path = NULL;
+    unsigned long min_ms = 300;
+    int runs = 5;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--min-ms") == 0 && i + 1 < argc) {
+            min_ms = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (runs < 1) {
+        runs = 1;
+    } else if (runs > 64) {
+        runs = 64;
+    }
+    if (min_ms == 0) {
+        min_ms = 1;
+    }
+
+    if (!setup_fixture()) {
+        fprintf(stderr, "[오류] 측정 대상을 준비할 수 없습니다.\n");
+        return 1;
+    }
+
+    static bench_result results[BENCH_MAX_RESULTS];
+    int count = 0;
+    printf("%-36s %12s %12s %14s\n", "항목", "ns/연산", "최소", "연산 수");
+    for (size_t i = 0; i < sizeof(g_cases) / sizeof(g_cases[0]) && count < BENCH_MAX_RESULTS; i++) {
+        if (filter != NULL && strstr(g_cases[i].name, filter) == NULL) {
+            continue;
+        }
+        bench_result* result = &results[count++];
+        run_case(&g_cases[i], min_ms, runs, result);
+        printf("%-36s %12.2f %12.2f %14llu\n", result->name, result->ns_median, result->ns_min, result->ops);
+        fflush(stdout);
+    }
+    printf("[벤치] 처리 코어가 주입한 키 이벤트: %lu, 자동 반복 빠른 경로: %lu\n",
+           g_fixture.processor.injected, g_fixture.processor.repeats);
+    if (g_fixture.delivery_ready) {
+        printf("[벤치] 전달 링: 넣은 키 %lu, 가득 참 %lu, 소비자 깨우기 %lu\n", g_fixture.channel.delivered,
+               (unsigned long)g_fixture.channel.ring->dropped, (unsigned long)g_fixture.channel.ring->wakeups);
+    } else {
+        printf("[벤치] 공유 메모리를 만들 수 없어 전달 링 항목은 측정하지 않았습니다.\n");
+    }
+    teardown_fixture();
+
+    if (json_path != NULL) {
+        if (!write_json(json_path, results, count, min_ms, runs)) {
+            fprintf(stderr, "[오류] 결과 파일을 쓸 수 없습니다: %s\n", json_path);
+            return 1;
+        }
+        printf("[벤치] 결과 기록: %s\n", json_path);
+    }
+    return 0;
+}
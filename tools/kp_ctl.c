@@ -0,0 +1,143 @@
+/**
+ * @file kp_ctl.c
+ * @brief 실행 중인 키보드 보안 툴 제어 도구
+ * @details 로컬 제어 채널(Windows: 이름 있는 파이프, 그 외: Unix 도메인 소켓)로 요청을 보내고 응답을 출력합니다.
+ *          키보드 없이 원격 관리 도구나 스크립트에서 툴을 관리할 때 사용합니다.
+ *
+ *          사용법:
+ *            kp_ctl [--name <채널 이름>] [--timeout <밀리초>] ping
+ *            kp_ctl [--name <채널 이름>] stats [--json]
+ *            kp_ctl [--name <채널 이름>] reload
+ *            kp_ctl [--name <채널 이름>] verbosity <0|1|2>
+ *            kp_ctl [--name <채널 이름>] shadow-report   (그림자 집계 보고서를 지금 기록하고 경로 출력)
+ *            kp_ctl [--name <채널 이름>] shutdown
+ */
+#include "control_channel.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 응답 상태 설명
+ */
+static const char* status_text(control_status status) {
+    switch (status) {
+    case CONTROL_OK:          return "성공";
+    case CONTROL_ERR_UNKNOWN: return "알 수 없는 요청";
+    case CONTROL_ERR_INVALID: return "잘못된 요청";
+    case CONTROL_ERR_FAILED:  return "수행 실패";
+    default:                  return "알 수 없는 상태";
+    }
+}
+
+/**
+ * @brief CONTROL_STATS 응답을 출력합니다.
+ * @details 서버가 더 많은 카운터를 보내면 아는 것만 출력하고, 적게 보내면 받은 것만 출력합니다.
+ */
+static int print_stats(const control_message* reply, int json) {
+    control_stats stats;
+    memset(&stats, 0, sizeof(stats));
+    size_t size = reply->header.length - sizeof(uint32_t);
+    if (size > sizeof(stats)) {
+        size = sizeof(stats);
+    }
+    memcpy(&stats, reply->payload + sizeof(uint32_t), size);
+    unsigned int count = stats.count;
+    if (count > CONTROL_STAT_COUNT) {
+        count = CONTROL_STAT_COUNT;
+    }
+    if (size < sizeof(uint64_t) + count * sizeof(uint64_t)) {
+        fprintf(stderr, "[오류] 통계 응답이 잘렸습니다.\n");
+        return 0;
+    }
+
+    if (json) {
+        printf("{");
+        for (unsigned int i = 0; i < count; i++) {
+            printf("%s\"%s\": %llu", (i > 0) ? ", " : "", control_stat_name((control_stat)i),
+                   (unsigned long long)stats.values[i]);
+        }
+        printf("}\n");
+    } else {
+        for (unsigned int i = 0; i < count; i++) {
+            printf("%-20s %llu\n", control_stat_name((control_stat)i), (unsigned long long)stats.values[i]);
+        }
+    }
+    return 1;
+}
+
+static void print_usage(const char* program) {
+    fprintf(stderr, "사용법: %s [--name <채널 이름>] [--timeout <밀리초>] "
+                    "ping | stats [--json] | reload | verbosity <0|1|2> | shadow-report | shutdown\n", program);
+}
+
+int main(int argc, char* argv[]) {
+    const char* name = NULL;
+    unsigned int timeout_ms = 2000;
+    int index = 1;
+    while (index < argc && strncmp(argv[index], "--", 2) == 0) {
+        if (strcmp(argv[index], "--name") == 0 && index + 1 < argc) {
+            name = argv[index + 1];
+            index += 2;
+        } else if (strcmp(argv[index], "--timeout") == 0 && index + 1 < argc) {
+            timeout_ms = (unsigned int)strtoul(argv[index + 1], NULL, 10);
+            index += 2;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (index >= argc) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    const char* verb = argv[index++];
+    control_command command;
+    uint32_t argument = 0;
+    const void* payload = NULL;
+    size_t size = 0;
+    int json = 0;
+    if (strcmp(verb, "ping") == 0) {
+        command = CONTROL_PING;
+    } else if (strcmp(verb, "stats") == 0) {
+        command = CONTROL_STATS;
+        json = (index < argc && strcmp(argv[index], "--json") == 0);
+    } else if (strcmp(verb, "reload") == 0) {
+        command = CONTROL_RELOAD;
+    } else if (strcmp(verb, "verbosity") == 0 && index < argc) {
+        command = CONTROL_SET_VERBOSITY;
+        argument = (uint32_t)strtoul(argv[index], NULL, 10);
+        payload = &argument;
+        size = sizeof(argument);
+    } else if (strcmp(verb, "shadow-report") == 0) {
+        command = CONTROL_SHADOW_REPORT;
+    } else if (strcmp(verb, "shutdown") == 0) {
+        command = CONTROL_SHUTDOWN;
+    } else {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    control_message reply;
+    if (!control_client_call(name, command, payload, size, &reply, timeout_ms)) {
+        fprintf(stderr, "[오류] 제어 채널에 연결할 수 없습니다: %s\n", (name != NULL) ? name : CONTROL_CHANNEL_NAME);
+        return 2;
+    }
+    control_status status = control_message_status(&reply);
+    if (status != CONTROL_OK) {
+        fprintf(stderr, "[오류] %s: %s\n", verb, status_text(status));
+        return 1;
+    }
+    if (command == CONTROL_STATS) {
+        return print_stats(&reply, json) ? 0 : 1;
+    }
+    if (command == CONTROL_SHADOW_REPORT && reply.header.length > sizeof(uint32_t)) {
+        printf("[제어] %s: %.*s\n", verb, (int)(reply.header.length - sizeof(uint32_t)),
+               (const char*)reply.payload + sizeof(uint32_t));
+        return 0;
+    }
+    printf("[제어] %s: %s\n", verb, status_text(status));
+    return 0;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file stats_reader.c
+ * @brief 공유 메모리 통계 블록 읽기 도구
+ * @details 실행 중인 keyboard_protector(또는 trace_replay --stats)가 게시한 통계 블록을 읽기 전용으로 매핑하여
+ *          단계별 지연 백분위와 판정 카운터를 출력합니다. 대상 프로세스를 멈추거나 잠그지 않습니다.
+ *
+ *          사용법:
+ *            stats_reader [--watch <초>]
+ */
+#include "stats_block.h"
+#include "kp_platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 나노초 값을 마이크로초 단위로 출력합니다.
+ */
+static void print_us(uint64_t ns) {
+    printf(" %10.1f", (double)ns / 1000.0);
+}
+
+/**
+ * @brief 통계 블록 사본을 표로 출력합니다.
+ */
+static void print_block(const kp_stats_block* block) {
+    printf("PID %lu | 후크 제한 시간 %lu ms | 제한 시간 절반 초과 %llu회\n",
+           (unsigned long)block->process_id, (unsigned long)block->hook_timeout_ms,
+           (unsigned long long)block->near_timeout);
+    printf("판정: 허용 %llu | 차단 %llu | 확인 실패 %llu\n",
+           (unsigned long long)block->verdicts[KP_VERDICT_ALLOWED],
+           (unsigned long long)block->verdicts[KP_VERDICT_BLOCKED],
+           (unsigned long long)block->verdicts[KP_VERDICT_UNKNOWN]);
+    printf("%-8s %10s %10s %10s %10s %10s %10s %10s\n",
+           "단계", "개수", "평균(us)", "p50", "p90", "p99", "p99.9", "최대");
+
+    for (int stage = 0; stage < KP_STAT_COUNT; stage++) {
+        const latency_histogram* histogram = &block->stages[stage];
+        uint64_t count = histogram->count;
+        printf("%-8s %10llu", kp_stat_stage_name((kp_stat_stage)stage), (unsigned long long)count);
+        if (count == 0) {
+            printf("\n");
+            continue;
+        }
+        print_us(histogram->sum_ns / count);
+        print_us(latency_histogram_percentile(histogram, 0.50));
+        print_us(latency_histogram_percentile(histogram, 0.90));
+        print_us(latency_histogram_percentile(histogram, 0.99));
+        print_us(latency_histogram_percentile(histogram, 0.999));
+        print_us(histogram->max_ns);
+        printf("\n");
+    }
+}
+
+int main(int argc, char* argv[]) {
+    unsigned int watch_seconds = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--watch") == 0 && i + 1 < argc) {
+            watch_seconds = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "사용법: %s [--watch <초>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    kp_shared_memory shm;
+    if (!kp_shared_memory_open(&shm, KP_STATS_SHM_NAME, sizeof(kp_stats_block))) {
+        fprintf(stderr, "[오류] 통계 블록(%s)을 찾을 수 없습니다. keyboard_protector가 실행 중인지 확인하세요.\n",
+                KP_STATS_SHM_NAME);
+        return 1;
+    }
+    const kp_stats_block* live = (const kp_stats_block*)shm.address;
+    if (live->magic != KP_STATS_MAGIC || live->version != KP_STATS_VERSION ||
+        live->size != sizeof(kp_stats_block)) {
+        fprintf(stderr, "[오류] 통계 블록 형식이 다릅니다. (버전 %lu, 크기 %lu)\n",
+                (unsigned long)live->version, (unsigned long)live->size);
+        kp_shared_memory_close(&shm);
+        return 1;
+    }
+
+    // 기록 중인 블록을 그대로 읽음 (카운터는 원자적으로 갱신되므로 근사값이지만 일관됨)
+    static kp_stats_block snapshot;
+    for (;;) {
+        memcpy(&snapshot, live, sizeof(snapshot));
+        print_block(&snapshot);
+        if (watch_seconds == 0) {
+            break;
+        }
+        printf("\n");
+        fflush(stdout);
+        kp_sleep_ms(watch_seconds * 1000U);
+    }
+
+    kp_shared_memory_close(&shm);
+    return 0;
+}
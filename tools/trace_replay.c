@@ -0,0 +1,965 @@
+/**
+ * @file trace_replay.c
+ * @brief 키 입력 트레이스 재생 도구
+ * @details keyboard_protector.exe --record로 기록한 트레이스를 후크 없이 같은 처리 코어(key_processor)에 공급하여
+ *          처리량과 이벤트당 지연 시간 분포를 측정합니다. 포그라운드 창, 시계, 키 주입은 모두 가짜 백엔드로
+ *          대체되므로 Windows가 아닌 환경(Linux 등)에서도 헤드리스로 실행할 수 있습니다.
+ *
+ *          사용법:
+ *            trace_replay <트레이스> [--speed max|realtime|<배속>] [--foreground <스크립트>]
+ *                         [--config <ini>] [--loops <횟수>] [--pipeline] [--keystream] [--stats]
+ *                         [--journal <디렉토리>] [--journal-key <파일>] [--shadow] [--candidate <ini>] [--report <csv>]
+ *                         [--variant <이름> <산출물>] [--variant-report <파일>] [--variant-reset]
+ *                         [--inject-batch <크기>] [--inject-unicode]
+ *            trace_replay --generate <트레이스> <이벤트 수> [<자동 반복 수>]
+ *            trace_replay --bench-keystream
+ *            trace_replay --bench-policy
+ *
+ *          포그라운드 스크립트는 "<밀리초> <프로세스 이름>" 형식의 줄로 이루어지며,
+ *          지정하면 트레이스에 기록된 프로세스 라벨 대신 해당 시각부터 그 프로세스가 포그라운드가 됩니다.
+ *          --keystream을 지정하면 가상 시계 대신 실제와 같은 키스트림 풀(고정 키)에서 솔트를 꺼냅니다.
+ *          --stats를 지정하면 공유 메모리 통계 블록에 기록하므로 재생 중에 tools/stats_reader로 볼 수 있습니다.
+ *          --journal을 지정하면 판정을 이진 저널 세그먼트로 기록하므로 tools/journal_query로 조회할 수 있습니다.
+ *          --journal-key를 함께 지정하면 키스트림 풀을 켜고 세션 키를 그 저널 키로 감싸 세그먼트에 넣으므로,
+ *          journal_query --key-file로 레코드를 복호화할 수 있습니다.
+ *          --shadow를 지정하면 그림자 모드처럼 주입 없이 판정만 집계하고, --candidate를 지정하면 후보 정책을
+ *          나란히 판정합니다. 집계는 --report 파일(없으면 표준 출력)에 CSV로 씁니다.
+ *          --variant를 지정하면 빌드 변형 이름, 산출물 크기, 처리량과 지연 분위수를 한 줄로 --variant-report 파일에
+ *          덧붙이고 지금까지의 비교표를 출력합니다. --variant-reset을 지정하면 파일을 비우고 새로 씁니다.
+ *          (make variants와 make release-lean의 비교표)
+ *          --inject-batch를 지정하면 주입을 키마다 세는 대신 주입 묶음(inject_batch)에 넣고 기록용 가짜 출력으로
+ *          내보내어 출력 호출 수와 묶음 크기를 보고합니다. 체크섬은 출력이 받은 순서로 계산하므로 묶지 않은 재생과
+ *          같아야 합니다. --inject-unicode는 ASCII 문자 키를 유니코드 경로로 바꾸는 가짜 변환을 함께 켭니다.
+ */
+#include "key_processor.h"
+#include "key_trace.h"
+#include "keystream.h"
+#include "stats_block.h"
+#include "key_journal.h"
+#include "policy_loader.h"
+#include "shadow_audit.h"
+#include "inject_batch.h"
+#include "kp_platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** @brief 포그라운드 스크립트의 최대 항목 수 */
+#define REPLAY_MAX_SCRIPT 1024
+
+/** @brief 재생 속도: 최대 속도 */
+#define REPLAY_SPEED_MAX 0.0
+
+/**
+ * @brief 포그라운드 스크립트 항목
+ */
+typedef struct replay_script_entry {
+    unsigned long long offset_ns;       /**< 트레이스 시작 기준 시각 */
+    char name[FOREGROUND_NAME_SIZE];    /**< 이 시각부터 포그라운드인 프로세스 */
+} replay_script_entry;
+
+/**
+ * @brief 재생 상태 (가짜 Win32 계층)
+ */
+typedef struct replay_context {
+    key_trace_record* records;          /**< 메모리에 올린 트레이스 레코드 */
+    size_t record_count;                /**< 레코드 수 */
+    const key_trace* trace;             /**< 라벨 이름 조회용 트레이스 */
+    replay_script_entry* script;        /**< 포그라운드 스크립트 (NULL이면 트레이스 라벨 사용) */
+    size_t script_count;                /**< 스크립트 항목 수 */
+
+    policy_snapshot* policy;            /**< 판정에 사용할 정책 */
+    foreground_cache cache;             /**< 포그라운드 판정 캐시 */
+    key_processor processor;            /**< 처리 코어 */
+    key_pipeline* pipeline;             /**< --pipeline 지정 시 사용하는 파이프라인 */
+
+    const char* foreground;             /**< 현재 가짜 포그라운드 프로세스 (NULL이면 확인 불가) */
+    unsigned long foreground_id;        /**< 현재 가짜 포그라운드 창 번호 */
+    unsigned int virtual_ms;            /**< 가상 시계 (GetTickCount 대체) */
+    keystream_pool* keystream;          /**< 솔트를 꺼낼 키스트림 풀 (NULL이면 가상 시계 사용) */
+    kp_stats_block* stats_block;        /**< --stats 지정 시 기록할 통계 블록 */
+    key_journal_writer* journal;        /**< --journal 지정 시 판정을 기록할 저널 */
+    shadow_audit* audit;                /**< --shadow 또는 --candidate 지정 시 그림자 집계 */
+    policy_snapshot* candidate;         /**< --candidate 지정 시 후보 정책 */
+    int shadow_only;                    /**< --shadow: 처리 코어 대신 그림자 집계만 수행 */
+
+    unsigned long long* latencies;      /**< 이벤트별 처리 지연 (나노초) */
+    size_t latency_count;               /**< 기록된 지연 수 */
+    unsigned long verdicts[3];          /**< 판정별 이벤트 수 (UNKNOWN, BLOCKED, ALLOWED) */
+    inject_batch* batch;                /**< --inject-batch 지정 시 주입 묶음 */
+    unsigned long injected;             /**< 주입된 키 이벤트 수 */
+    unsigned long checksum;             /**< 주입된 키 순서 체크섬 (빌드 간 결과 비교용) */
+} replay_context;
+
+/**
+ * @brief 가짜 포그라운드 조회 (창 번호와 PID는 포그라운드가 바뀔 때마다 달라짐)
+ */
+static int replay_get_foreground(void* context, foreground_identity* identity) {
+    replay_context* ctx = (replay_context*)context;
+    if (ctx->foreground == NULL) {
+        return 0;
+    }
+    identity->window = (uintptr_t)ctx->foreground_id;
+    identity->process_id = 1000 + ctx->foreground_id;
+    identity->start_time = 0;
+    return 1;
+}
+
+/**
+ * @brief 가짜 프로세스 이름 조회
+ */
+static int replay_get_process_name(void* context, const foreground_identity* identity,
+                                   char* name, size_t name_size) {
+    replay_context* ctx = (replay_context*)context;
+    (void)identity;
+    if (ctx->foreground == NULL || name_size == 0) {
+        return 0;
+    }
+    strncpy(name, ctx->foreground, name_size - 1);
+    name[name_size - 1] = '\0';
+    return 1;
+}
+
+/**
+ * @brief 정책의 허용 목록으로 판정 (허용이면 키 규칙 번호 + 1)
+ */
+static int replay_verdict(const char* process_name, void* user) {
+    replay_context* ctx = (replay_context*)user;
+    return (int)allowlist_value(&ctx->policy->allowed, process_name);
+}
+
+/**
+ * @brief 키스트림 풀(--keystream) 또는 가상 시계로 솔트 생성
+ * @details 키스트림 풀을 쓰면 솔트는 워드의 위치입니다. 가상 시계는 세션 키가 없는 결정적 재생용이므로
+ *          시계 값을 워드와 솔트로 함께 씁니다.
+ */
+static unsigned int replay_make_salt(void* context, unsigned int* pad) {
+    replay_context* ctx = (replay_context*)context;
+    if (ctx->keystream != NULL) {
+        uint32_t position;
+        *pad = (unsigned int)keystream_pool_next(ctx->keystream, &position);
+        return (unsigned int)position;
+    }
+    *pad = ctx->virtual_ms;
+    return ctx->virtual_ms;
+}
+
+/**
+ * @brief 주입된 키 하나의 개수와 체크섬을 갱신합니다.
+ */
+static void replay_count_injected(replay_context* ctx, unsigned int vk_code, int key_down) {
+    ctx->injected++;
+    ctx->checksum = ctx->checksum * 31UL + vk_code * 2UL + (key_down ? 1UL : 0UL);
+}
+
+/**
+ * @brief 기록용 가짜 묶음 출력 (받은 순서대로 개수와 체크섬 갱신)
+ */
+static size_t replay_sink_send(void* context, const inject_key* keys, size_t count) {
+    replay_context* ctx = (replay_context*)context;
+    for (size_t i = 0; i < count; i++) {
+        replay_count_injected(ctx, keys[i].vk_code, (keys[i].flags & INJECT_KEY_UP) == 0);
+    }
+    return count;
+}
+
+/**
+ * @brief 가짜 문자 변환 (미국 자판 배열의 글자, 숫자, 공백만)
+ */
+static unsigned int replay_sink_translate(void* context, unsigned int vk_code, int shift, int caps_lock) {
+    (void)context;
+    if (vk_code >= 'A' && vk_code <= 'Z') {
+        return (shift != caps_lock) ? vk_code : vk_code + ('a' - 'A');
+    }
+    if ((vk_code >= '0' && vk_code <= '9' && !shift) || vk_code == ' ') {
+        return vk_code;
+    }
+    return 0;
+}
+
+/**
+ * @brief 가짜 키 주입 (실제로 주입하지 않고 개수와 체크섬만 갱신, --inject-batch이면 묶음에 넣음)
+ */
+static int replay_inject(void* context, unsigned int vk_code, int key_down) {
+    replay_context* ctx = (replay_context*)context;
+    if (ctx->batch != NULL) {
+        return inject_batch_add(ctx->batch, vk_code, key_down, (uint64_t)ctx->foreground_id, kp_now_ns());
+    }
+    replay_count_injected(ctx, vk_code, key_down);
+    return 1;
+}
+
+#if KP_STATIC_BACKEND
+/**
+ * @brief 정적 백엔드 솔트 생성 (KP_STATIC_BACKEND 빌드의 처리 코어가 직접 호출)
+ */
+unsigned int kp_backend_make_salt(void* context, unsigned int* pad) {
+    return replay_make_salt(context, pad);
+}
+
+/**
+ * @brief 정적 백엔드 주입 (KP_STATIC_BACKEND 빌드의 처리 코어가 직접 호출)
+ */
+int kp_backend_inject(void* context, unsigned int vk_code, int key_down) {
+    return replay_inject(context, vk_code, key_down);
+}
+#endif
+
+/**
+ * @brief 키 다운 판정을 저널에 기록합니다.
+ * @details 저널은 키 다운 판정만 기록하므로 자동 반복 요약(repeats > 0)은 건너뜁니다.
+ */
+static void replay_log(void* context, unsigned int vk_code, unsigned int salt,
+                       unsigned int encrypted_keycode, int verdict, const char* process_name,
+                       unsigned int repeats) {
+    replay_context* ctx = (replay_context*)context;
+    (void)vk_code;
+    if (repeats > 0) {
+        return;
+    }
+    key_journal_entry entry;
+    entry.timestamp_ns = kp_now_ns();
+    entry.encrypted_keycode = encrypted_keycode;
+    entry.salt = salt;
+    entry.name_id = key_journal_intern_name(ctx->journal, process_name);
+    entry.verdict = (unsigned char)verdict;
+    entry.reserved = 0;
+    key_journal_append(ctx->journal, &entry);
+}
+
+/**
+ * @brief 레코드 시각에 해당하는 포그라운드 프로세스를 결정합니다.
+ * @return long 포그라운드 번호 (-1이면 확인 불가)
+ */
+static long replay_foreground_for(const replay_context* ctx, const key_trace_record* record) {
+    if (ctx->script == NULL) {
+        return (record->label == KEY_TRACE_NO_LABEL) ? -1 : (long)record->label;
+    }
+    long found = -1;
+    for (size_t i = 0; i < ctx->script_count && ctx->script[i].offset_ns <= record->timestamp_ns; i++) {
+        found = (long)i;
+    }
+    return found;
+}
+
+/**
+ * @brief 레코드 하나를 처리 코어에 공급합니다. (직접 모드는 재생 스레드, 파이프라인 모드는 작업 스레드)
+ * @details 포그라운드가 바뀌면 EVENT_SYSTEM_FOREGROUND 알림처럼 판정 캐시를 무효화합니다.
+ */
+static void replay_process(replay_context* ctx, const key_event* event, size_t index) {
+    const key_trace_record* record = &ctx->records[index];
+    long foreground = replay_foreground_for(ctx, record);
+    unsigned long foreground_id = (unsigned long)(foreground + 1);
+    if (foreground_id != ctx->foreground_id) {
+        ctx->foreground_id = foreground_id;
+        if (foreground < 0) {
+            ctx->foreground = NULL;
+        } else if (ctx->script != NULL) {
+            ctx->foreground = ctx->script[foreground].name;
+        } else {
+            ctx->foreground = key_trace_label(ctx->trace, (unsigned int)foreground);
+        }
+        foreground_cache_invalidate(&ctx->cache);
+    }
+    ctx->virtual_ms = event->time;
+
+    static const kp_stat_verdict verdict_counter[] = {
+        KP_VERDICT_UNKNOWN, KP_VERDICT_BLOCKED, KP_VERDICT_ALLOWED
+    };
+    foreground_verdict verdict;
+    if (ctx->shadow_only) {
+        verdict = shadow_audit_handle(ctx->audit, &ctx->cache, ctx->policy, ctx->candidate, event);
+    } else {
+        verdict = key_processor_handle(&ctx->processor, event, NULL);
+        if (ctx->audit != NULL) {
+            shadow_audit_handle(ctx->audit, &ctx->cache, ctx->policy, ctx->candidate, event);
+        }
+    }
+    ctx->verdicts[verdict]++;
+    kp_stats_count_verdict(ctx->stats_block, verdict_counter[verdict]);
+}
+
+/**
+ * @brief 파이프라인 작업 스레드의 처리 함수
+ * @details tag에 실어 보낸 레코드 번호로 포그라운드를 결정하고, 큐 대기를 포함한 지연을 기록합니다.
+ */
+static void replay_pipeline_handler(const key_event* event, void* user) {
+    replay_context* ctx = (replay_context*)user;
+    replay_process(ctx, event, event->tag);
+    ctx->latencies[ctx->latency_count++] = kp_now_ns() - event->enqueue_ns;
+}
+
+/**
+ * @brief 파이프라인 작업 스레드의 큐가 비면 모아 둔 주입을 내보냅니다.
+ */
+static void replay_pipeline_idle(void* user) {
+    replay_context* ctx = (replay_context*)user;
+    if (ctx->batch != NULL) {
+        inject_batch_flush(ctx->batch, INJECT_FLUSH_IDLE);
+    }
+}
+
+/**
+ * @brief 포그라운드 스크립트를 읽습니다.
+ * @return int 성공 시 1, 실패 시 0
+ */
+static int replay_load_script(replay_context* ctx, const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        fprintf(stderr, "[오류] 포그라운드 스크립트를 열 수 없습니다: %s\n", path);
+        return 0;
+    }
+    ctx->script = (replay_script_entry*)calloc(REPLAY_MAX_SCRIPT, sizeof(replay_script_entry));
+    if (ctx->script == NULL) {
+        fclose(file);
+        return 0;
+    }
+
+    char line[512];
+    while (fgets(line, sizeof(line), file) != NULL && ctx->script_count < REPLAY_MAX_SCRIPT) {
+        unsigned long long offset_ms = 0;
+        char name[FOREGROUND_NAME_SIZE];
+        if (line[0] == '#' || line[0] == ';' || sscanf(line, "%llu %259s", &offset_ms, name) != 2) {
+            continue;
+        }
+        replay_script_entry* entry = &ctx->script[ctx->script_count++];
+        entry->offset_ns = offset_ms * 1000000ULL;
+        memcpy(entry->name, name, sizeof(entry->name));
+    }
+    fclose(file);
+    printf("[재생] 포그라운드 스크립트 항목 %lu개\n", (unsigned long)ctx->script_count);
+    return 1;
+}
+
+/**
+ * @brief 트레이스 전체를 메모리에 읽어 들입니다. (측정 구간에서 파일 입출력 제외)
+ * @return int 성공 시 1, 실패 시 0
+ */
+static int replay_load_trace(replay_context* ctx, key_trace* trace) {
+    size_t capacity = 4096;
+    ctx->records = (key_trace_record*)malloc(capacity * sizeof(key_trace_record));
+    if (ctx->records == NULL) {
+        return 0;
+    }
+
+    int result;
+    key_trace_record record;
+    while ((result = key_trace_read(trace, &record)) == 1) {
+        if (ctx->record_count == capacity) {
+            capacity *= 2;
+            key_trace_record* grown = (key_trace_record*)realloc(ctx->records, capacity * sizeof(key_trace_record));
+            if (grown == NULL) {
+                return 0;
+            }
+            ctx->records = grown;
+        }
+        ctx->records[ctx->record_count++] = record;
+    }
+    if (result < 0) {
+        fprintf(stderr, "[경고] 트레이스 %lu번째 레코드 이후가 손상되어 무시합니다.\n",
+                (unsigned long)ctx->record_count);
+    }
+    return 1;
+}
+
+/**
+ * @brief 실시간 재생에서 목표 시각까지 기다립니다.
+ */
+static void replay_wait_until(unsigned long long target_ns) {
+    for (;;) {
+        unsigned long long now = kp_now_ns();
+        if (now >= target_ns) {
+            return;
+        }
+        if (target_ns - now > 2000000ULL) {
+            kp_sleep_ms((unsigned int)((target_ns - now) / 1000000ULL) - 1);
+        }
+    }
+}
+
+static int compare_u64(const void* a, const void* b) {
+    unsigned long long x = *(const unsigned long long*)a;
+    unsigned long long y = *(const unsigned long long*)b;
+    return (x > y) - (x < y);
+}
+
+static unsigned long long percentile(const unsigned long long* sorted, size_t count, double q) {
+    if (count == 0) {
+        return 0;
+    }
+    return sorted[(size_t)(q * (double)(count - 1))];
+}
+
+/**
+ * @brief 합성 트레이스를 만듭니다. (녹화 환경이 없을 때 부하 시험용)
+ * @details 세 프로세스 사이를 200 이벤트마다 전환하며, 30ms 간격의 키 다운/업 쌍을 기록합니다.
+ *          repeats를 지정하면 키를 누르고 있는 경우처럼 키 다운 뒤에 33ms 간격의 자동 반복 키 다운을
+ *          repeats개 넣은 다음 키 업을 기록합니다.
+ */
+static int replay_generate(const char* path, unsigned long count, unsigned long repeats) {
+    static const char* labels[] = { "notepad++.exe", "chrome.exe", "code.exe" };
+    key_trace trace;
+    if (!key_trace_open_write(&trace, path)) {
+        fprintf(stderr, "[오류] 트레이스 파일을 만들 수 없습니다: %s\n", path);
+        return 1;
+    }
+
+    unsigned long seed = 12345;
+    unsigned int vk = 'A';
+    unsigned long press_length = repeats + 2;
+    unsigned long long timestamp_ns = 0;
+    for (unsigned long i = 0; i < count; i++) {
+        unsigned long phase = i % press_length;
+        key_event event;
+        memset(&event, 0, sizeof(event));
+        if (phase == 0) {
+            seed = seed * 1103515245UL + 12345UL;
+            vk = 'A' + (unsigned int)((seed >> 16) % 26);
+        }
+        event.enqueue_ns = timestamp_ns;
+        event.vk_code = vk;
+        event.scan_code = vk - 'A' + 0x10;
+        event.message = (phase == press_length - 1) ? KEY_MESSAGE_KEYUP : KEY_MESSAGE_KEYDOWN;
+        event.time = (unsigned int)(timestamp_ns / 1000000ULL);
+        key_trace_write(&trace, &event, labels[(i / 200) % 3]);
+        timestamp_ns += (phase > 0 && phase < press_length - 1) ? 33000000ULL : 30000000ULL;
+    }
+    printf("[재생] 합성 트레이스 생성: %s (키 이벤트 %lu개, 누를 때마다 자동 반복 %lu개)\n", path,
+           trace.records, repeats);
+    key_trace_close(&trace);
+    return 0;
+}
+
+/**
+ * @brief 키스트림 커널 처리량과 풀 꺼내기 지연을 측정합니다.
+ * @details 커널마다 일정 시간 동안 블록을 생성하여 MB/s를 구하고,
+ *          풀에서 워드를 하나씩 꺼내는 비용(키 이벤트 하나의 암호화 비용)의 분포를 출력합니다.
+ */
+static int replay_bench_keystream(void) {
+    static uint32_t buffer[256 * KEYSTREAM_BLOCK_WORDS];
+    uint32_t key[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    uint32_t reference[KEYSTREAM_BLOCK_WORDS * 9];
+    keystream_generate(KEYSTREAM_KERNEL_SCALAR, key, 0, 0, 0, reference, 9);
+
+    for (int kernel = 0; kernel < KEYSTREAM_KERNEL_COUNT; kernel++) {
+        if (!keystream_kernel_supported((keystream_kernel)kernel)) {
+            printf("[벤치] %-6s: 이 CPU에서 지원하지 않음\n", keystream_kernel_name((keystream_kernel)kernel));
+            continue;
+        }
+        // 스칼라 커널과 같은 키스트림을 만드는지 먼저 확인
+        keystream_generate((keystream_kernel)kernel, key, 0, 0, 0, buffer, 9);
+        int matches = memcmp(buffer, reference, sizeof(reference)) == 0;
+
+        unsigned long long blocks = 0;
+        unsigned long long start = kp_now_ns();
+        unsigned long long elapsed;
+        do {
+            keystream_generate((keystream_kernel)kernel, key, 0, 0, blocks, buffer, 256);
+            blocks += 256;
+            elapsed = kp_now_ns() - start;
+        } while (elapsed < 200000000ULL);
+        double seconds = (double)elapsed / 1e9;
+        printf("[벤치] %-6s: %8.1f MB/s | 블록당 %6.1f ns | 스칼라와 일치: %s\n",
+               keystream_kernel_name((keystream_kernel)kernel),
+               (double)blocks * 64.0 / seconds / 1e6, (double)elapsed / (double)blocks,
+               matches ? "예" : "아니오");
+    }
+
+    static keystream_pool pool;
+    if (!keystream_pool_start(&pool, key, 0)) {
+        fprintf(stderr, "[오류] 키스트림 풀을 시작할 수 없습니다.\n");
+        return 1;
+    }
+    enum { SAMPLES = 1000000 };
+    unsigned long long* latencies = (unsigned long long*)malloc(SAMPLES * sizeof(unsigned long long));
+    if (latencies == NULL) {
+        keystream_pool_stop(&pool);
+        return 1;
+    }
+    uint32_t sink = 0;
+    for (int i = 0; i < SAMPLES; i++) {
+        unsigned long long t0 = kp_now_ns();
+        sink ^= keystream_pool_next(&pool, NULL);
+        latencies[i] = kp_now_ns() - t0;
+    }
+    keystream_stats stats;
+    keystream_pool_get_stats(&pool, &stats);
+    keystream_pool_stop(&pool);
+
+    qsort(latencies, SAMPLES, sizeof(unsigned long long), compare_u64);
+    printf("[벤치] 풀 꺼내기 (%s, 시계 호출 포함 ns): p50 %llu | p99 %llu | p99.9 %llu | 최대 %llu\n",
+           keystream_kernel_name(pool.kernel), percentile(latencies, SAMPLES, 0.50),
+           percentile(latencies, SAMPLES, 0.99), percentile(latencies, SAMPLES, 0.999),
+           latencies[SAMPLES - 1]);
+    printf("[벤치] 풀 고갈 %lu회 / %d회 (연속 꺼내기 기준, 실제 입력 속도에서는 0이어야 함) [%08lx]\n",
+           stats.underflows, SAMPLES, (unsigned long)sink);
+    free(latencies);
+    return 0;
+}
+
+/**
+ * @brief 키 규칙 컴파일과 키 단위 판정 비용을 측정합니다.
+ * @details 예제 규칙의 판정 몇 가지를 먼저 확인한 뒤, 무작위 (규칙, 가상 키, 조합 키 상태) 입력으로
+ *          판정 한 번의 비용을 구합니다.
+ */
+static int replay_bench_policy(void) {
+    static const char* specs[] = {
+        "alnum punct edit nav | -ctrl -alt",
+        "all | -win",
+        "alpha digit space enter backspace | none",
+        "-f4 -lwin -rwin -apps",
+        "func nav numpad | -shift"
+    };
+    enum { SPEC_COUNT = sizeof(specs) / sizeof(specs[0]), COMPILE_ROUNDS = 20000,
+           INPUTS = 1 << 16, EVAL_ROUNDS = 256 };
+
+    static key_policy policy;
+    key_policy_init(&policy);
+    for (int i = 0; i < SPEC_COUNT; i++) {
+        key_rule rule;
+        char bad_token[32];
+        if (!key_rule_compile(&rule, specs[i], bad_token, sizeof(bad_token)) || key_policy_add(&policy, &rule) < 0) {
+            printf("[벤치] 규칙을 컴파일할 수 없습니다: %s (%s)\n", specs[i], bad_token);
+            return 1;
+        }
+    }
+
+    // 판정 확인: (규칙, 가상 키, 조합 키 상태, 기대값)
+    static const unsigned int checks[][4] = {
+        { 1, 'A', 0, 1 }, { 1, 'A', KEY_MOD_SHIFT, 1 }, { 1, 'C', KEY_MOD_CTRL, 0 }, { 1, 0x70, 0, 0 },
+        { 1, 0xA2, 0, 0 }, { 2, 'R', KEY_MOD_WIN, 0 }, { 2, 0x5B, 0, 1 }, { 2, 'C', KEY_MOD_CTRL | KEY_MOD_SHIFT, 1 },
+        { 3, ' ', 0, 1 }, { 3, 'A', KEY_MOD_SHIFT, 0 }, { 4, 0x73, KEY_MOD_ALT, 0 }, { 4, 0x74, KEY_MOD_ALT, 1 },
+        { 5, 0x60, 0, 1 }, { 5, 0x25, KEY_MOD_SHIFT, 0 }, { 0, 0xFE, 15, 1 }, { 9, 'A', 0, 0 }
+    };
+    for (size_t i = 0; i < sizeof(checks) / sizeof(checks[0]); i++) {
+        int allowed = key_policy_allows(&policy, checks[i][0], checks[i][1], checks[i][2]);
+        if (allowed != (int)checks[i][3]) {
+            printf("[벤치] 판정 불일치: 규칙 %u, 가상 키 0x%02X, 조합 %u -> %d (기대값 %u)\n",
+                   checks[i][0], checks[i][1], checks[i][2], allowed, checks[i][3]);
+            return 1;
+        }
+    }
+
+    unsigned long long start = kp_now_ns();
+    unsigned int sink = 0;
+    for (int round = 0; round < COMPILE_ROUNDS; round++) {
+        key_rule rule;
+        key_rule_compile(&rule, specs[round % SPEC_COUNT], NULL, 0);
+        sink += rule.keys[round & (KEY_POLICY_KEY_WORDS - 1)];
+    }
+    unsigned long long compile_ns = kp_now_ns() - start;
+
+    static unsigned int inputs[INPUTS][3];
+    unsigned long seed = 12345;
+    for (int i = 0; i < INPUTS; i++) {
+        seed = seed * 1103515245UL + 12345UL;
+        inputs[i][0] = (unsigned int)((seed >> 8) % policy.count);
+        inputs[i][1] = (unsigned int)((seed >> 16) & 0xFF);
+        inputs[i][2] = (unsigned int)((seed >> 24) & (KEY_MOD_STATES - 1));
+    }
+    unsigned long allowed = 0;
+    start = kp_now_ns();
+    for (int round = 0; round < EVAL_ROUNDS; round++) {
+        for (int i = 0; i < INPUTS; i++) {
+            allowed += (unsigned long)key_policy_allows(&policy, inputs[i][0], inputs[i][1], inputs[i][2]);
+        }
+    }
+    unsigned long long eval_ns = kp_now_ns() - start;
+    double evaluations = (double)INPUTS * EVAL_ROUNDS;
+
+    printf("[벤치] 키 규칙 %u개, 판정 확인 %lu건 통과\n", policy.count, (unsigned long)(sizeof(checks) / sizeof(checks[0])));
+    printf("[벤치] 규칙 컴파일: %.0f ns/규칙 [%08x]\n", (double)compile_ns / COMPILE_ROUNDS, sink);
+    printf("[벤치] 키 단위 판정: %.2f ns/판정 (%.0f만 판정, 허용 비율 %.1f%%)\n", (double)eval_ns / evaluations,
+           evaluations / 10000.0, 100.0 * (double)allowed / evaluations);
+    return 0;
+}
+
+/**
+ * @brief 빌드 변형 비교표에 한 줄을 덧붙입니다.
+ * @details 파일이 비어 있으면 머리글을 먼저 쓰고, 덧붙인 뒤 파일 전체를 표준 출력으로 보여 줍니다.
+ *          산출물 크기는 파일 끝 위치로 구합니다. (읽을 수 없으면 0)
+ * @param path 비교표 파일 (NULL이면 표준 출력)
+ * @param reset 0이 아니면 기존 비교표를 비우고 새로 씀
+ * @return int 성공 시 1, 실패 시 0
+ */
+static int replay_write_variant(const char* path, int reset, const char* label, const char* artifact,
+                                double events_per_sec, const unsigned long long* sorted, size_t count) {
+    long size = 0;
+    FILE* file = fopen(artifact, "rb");
+    if (file != NULL) {
+        if (fseek(file, 0, SEEK_END) == 0) {
+            size = ftell(file);
+        }
+        fclose(file);
+    }
+
+    FILE* out = (path != NULL) ? fopen(path, reset ? "w" : "a") : stdout;
+    if (out == NULL) {
+        fprintf(stderr, "[오류] 변형 비교표를 열 수 없습니다: %s\n", path);
+        return 0;
+    }
+    if (out == stdout || ftell(out) == 0) {
+        fprintf(out, "%-16s %12s %14s %8s %8s %8s %10s\n",
+                "# variant", "size_bytes", "events_per_s", "p50_ns", "p99_ns", "p999_ns", "max_ns");
+    }
+    fprintf(out, "%-16s %12ld %14.0f %8llu %8llu %8llu %10llu\n", label, size, events_per_sec,
+            percentile(sorted, count, 0.50), percentile(sorted, count, 0.99), percentile(sorted, count, 0.999),
+            (count > 0) ? sorted[count - 1] : 0ULL);
+    if (out == stdout) {
+        return 1;
+    }
+    fclose(out);
+
+    // 이전 변형의 줄과 함께 비교표 전체를 출력
+    FILE* table = fopen(path, "r");
+    if (table != NULL) {
+        char line[256];
+        printf("[재생] 변형 비교표 (%s):\n", path);
+        while (fgets(line, sizeof(line), table) != NULL) {
+            fputs(line, stdout);
+        }
+        fclose(table);
+    }
+    return 1;
+}
+
+static void print_usage(const char* program) {
+    fprintf(stderr,
+            "사용법: %s <트레이스> [--speed max|realtime|<배속>] [--foreground <스크립트>]\n"
+            "                 [--config <ini>] [--loops <횟수>] [--pipeline] [--keystream] [--stats]\n"
+            "                 [--journal <디렉토리>] [--journal-key <파일>] [--shadow] [--candidate <ini>] [--report <csv>]\n"
+            "                 [--variant <이름> <산출물>] [--variant-report <파일>] [--variant-reset]\n"
+            "                 [--inject-batch <크기>] [--inject-unicode]\n"
+            "        %s --generate <트레이스> <이벤트 수> [<자동 반복 수>]\n"
+            "        %s --bench-keystream\n"
+            "        %s --bench-policy\n", program, program, program, program);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc >= 4 && strcmp(argv[1], "--generate") == 0) {
+        return replay_generate(argv[2], strtoul(argv[3], NULL, 10),
+                               (argc >= 5) ? strtoul(argv[4], NULL, 10) : 0);
+    }
+    if (argc >= 2 && strcmp(argv[1], "--bench-keystream") == 0) {
+        return replay_bench_keystream();
+    }
+    if (argc >= 2 && strcmp(argv[1], "--bench-policy") == 0) {
+        return replay_bench_policy();
+    }
+    if (argc < 2 || argv[1][0] == '-') {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    static replay_context ctx;
+    static key_trace trace;
+    const char* trace_path = argv[1];
+    const char* script_path = NULL;
+    const char* config_path = "config.ini";
+    double speed = REPLAY_SPEED_MAX;
+    unsigned long loops = 1;
+    int use_pipeline = 0;
+    int use_keystream = 0;
+    int use_stats = 0;
+    const char* journal_dir = NULL;
+    const char* journal_key_path = NULL;
+    const char* candidate_path = NULL;
+    const char* report_path = NULL;
+    const char* variant_label = NULL;
+    const char* variant_artifact = NULL;
+    const char* variant_path = NULL;
+    int variant_reset = 0;
+    unsigned long inject_batch_size = 0;
+    int inject_unicode = 0;
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            const char* value = argv[++i];
+            speed = (strcmp(value, "max") == 0) ? REPLAY_SPEED_MAX
+                  : (strcmp(value, "realtime") == 0) ? 1.0 : atof(value);
+        } else if (strcmp(argv[i], "--foreground") == 0 && i + 1 < argc) {
+            script_path = argv[++i];
+        } else if (strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
+            config_path = argv[++i];
+        } else if (strcmp(argv[i], "--loops") == 0 && i + 1 < argc) {
+            loops = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--pipeline") == 0) {
+            use_pipeline = 1;
+        } else if (strcmp(argv[i], "--keystream") == 0) {
+            use_keystream = 1;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            use_stats = 1;
+        } else if (strcmp(argv[i], "--journal") == 0 && i + 1 < argc) {
+            journal_dir = argv[++i];
+        } else if (strcmp(argv[i], "--journal-key") == 0 && i + 1 < argc) {
+            journal_key_path = argv[++i];
+            use_keystream = 1;
+        } else if (strcmp(argv[i], "--shadow") == 0) {
+            ctx.shadow_only = 1;
+        } else if (strcmp(argv[i], "--candidate") == 0 && i + 1 < argc) {
+            candidate_path = argv[++i];
+        } else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc) {
+            report_path = argv[++i];
+        } else if (strcmp(argv[i], "--variant") == 0 && i + 2 < argc) {
+            variant_label = argv[++i];
+            variant_artifact = argv[++i];
+        } else if (strcmp(argv[i], "--variant-report") == 0 && i + 1 < argc) {
+            variant_path = argv[++i];
+        } else if (strcmp(argv[i], "--variant-reset") == 0) {
+            variant_reset = 1;
+        } else if (strcmp(argv[i], "--inject-batch") == 0 && i + 1 < argc) {
+            inject_batch_size = strtoul(argv[++i], NULL, 10);
+            if (inject_batch_size == 0) {
+                inject_batch_size = INJECT_BATCH_DEFAULT_LIMIT;
+            }
+        } else if (strcmp(argv[i], "--inject-unicode") == 0) {
+            inject_unicode = 1;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (loops == 0) {
+        loops = 1;
+    }
+
+    if (!key_trace_open_read(&trace, trace_path)) {
+        fprintf(stderr, "[오류] 트레이스 파일을 열 수 없거나 형식이 다릅니다: %s\n", trace_path);
+        return 1;
+    }
+    if (!replay_load_trace(&ctx, &trace) || (script_path != NULL && !replay_load_script(&ctx, script_path))) {
+        fprintf(stderr, "[오류] 메모리가 부족합니다.\n");
+        return 1;
+    }
+    key_trace_close(&trace);
+    ctx.trace = &trace;
+    if (ctx.record_count == 0) {
+        fprintf(stderr, "[오류] 트레이스에 키 이벤트가 없습니다.\n");
+        return 1;
+    }
+
+    policy_load_status status = POLICY_LOAD_OK;
+    ctx.policy = policy_load_file(config_path, &status);
+    if (ctx.policy == NULL) {
+        return 1;
+    }
+    static shadow_audit audit;
+    if (candidate_path != NULL) {
+        policy_load_set_quiet(1);
+        ctx.candidate = policy_load_file(candidate_path, &status);
+        policy_load_set_quiet(0);
+        if (ctx.candidate == NULL || status == POLICY_LOAD_MISSING) {
+            fprintf(stderr, "[오류] 후보 정책 파일을 읽을 수 없습니다: %s\n", candidate_path);
+            return 1;
+        }
+        ctx.candidate->version = 1;
+    }
+    if (ctx.shadow_only || ctx.candidate != NULL) {
+        shadow_audit_init(&audit);
+        ctx.audit = &audit;
+    }
+
+    size_t total = ctx.record_count * loops;
+    ctx.latencies = (unsigned long long*)malloc(total * sizeof(unsigned long long));
+    if (ctx.latencies == NULL) {
+        fprintf(stderr, "[오류] 메모리가 부족합니다.\n");
+        return 1;
+    }
+
+    process_lookup_provider provider = { &ctx, replay_get_foreground, replay_get_process_name };
+    key_processor_backend backend = { &ctx, replay_make_salt, replay_inject, NULL };
+    static key_pipeline pipeline;
+    static keystream_pool keystream;
+    static key_journal_writer journal;
+    if (use_keystream) {
+        // 실행마다 같은 결과가 나오도록 고정 키 사용
+        static const uint32_t replay_key[8] = { 0 };
+        if (!keystream_pool_start(&keystream, replay_key, 0)) {
+            fprintf(stderr, "[오류] 키스트림 풀을 시작할 수 없습니다.\n");
+            return 1;
+        }
+        ctx.keystream = &keystream;
+    }
+    if (journal_dir != NULL) {
+        key_journal_key_info key_info;
+        memset(&key_info, 0, sizeof(key_info));
+        key_info.nonce = keystream.nonce;
+        if (journal_key_path != NULL) {
+            uint32_t journal_key[8];
+            if (!key_journal_read_key_file(journal_key_path, journal_key)) {
+                fprintf(stderr, "[오류] 저널 키 파일을 읽을 수 없습니다: %s\n", journal_key_path);
+                return 1;
+            }
+            key_journal_wrap_key(&key_info, journal_key, keystream.key, keystream.nonce);
+        }
+        if (!key_journal_writer_start(&journal, journal_dir, 0, &key_info)) {
+            fprintf(stderr, "[오류] 저널 스레드를 시작할 수 없습니다.\n");
+            return 1;
+        }
+        ctx.journal = &journal;
+        backend.log = replay_log;
+        if (!KP_FEATURE_KEY_LOG) {
+            fprintf(stderr, "[경고] 판정 기록이 빠진 빌드(KP_FEATURE_KEY_LOG=0)이므로 저널에 기록되지 않습니다.\n");
+        }
+    }
+    foreground_cache_init(&ctx.cache, &provider, replay_verdict, &ctx);
+    static inject_batch batch;
+    if (inject_batch_size != 0) {
+        inject_sink sink = { &ctx, replay_sink_send, replay_sink_translate };
+        inject_batch_init(&batch, &sink, inject_batch_size, 0);
+        inject_batch_configure(&batch, inject_batch_size, 0, inject_unicode);
+        ctx.batch = &batch;
+    }
+    if (use_pipeline) {
+        ctx.pipeline = &pipeline;
+        if (!key_pipeline_start(&pipeline, replay_pipeline_handler, replay_pipeline_idle, &ctx)) {
+            fprintf(stderr, "[오류] 작업 스레드를 시작할 수 없습니다.\n");
+            return 1;
+        }
+    }
+    key_processor_init(&ctx.processor, &ctx.cache, &backend, ctx.pipeline);
+    ctx.processor.policy = &ctx.policy->keys;
+    kp_shared_memory stats_memory;
+    if (use_stats) {
+        if (!kp_shared_memory_create(&stats_memory, KP_STATS_SHM_NAME, sizeof(kp_stats_block))) {
+            fprintf(stderr, "[오류] 공유 메모리 통계 블록을 만들 수 없습니다.\n");
+            return 1;
+        }
+        ctx.stats_block = (kp_stats_block*)stats_memory.address;
+        kp_stats_block_init(ctx.stats_block, KP_STATS_DEFAULT_HOOK_TIMEOUT_MS);
+        if (use_pipeline) {
+            key_pipeline_attach_stats(&pipeline, ctx.stats_block);
+        }
+    }
+
+    printf("[재생] %s: 키 이벤트 %lu개 x %lu회, 속도 %s, %s%s\n", trace_path,
+           (unsigned long)ctx.record_count, loops, (speed == REPLAY_SPEED_MAX) ? "최대" : "실시간 기준",
+           use_pipeline ? "후크/작업 스레드 파이프라인" : "처리 코어 직접 호출",
+           ctx.shadow_only ? " (그림자 모드)" : "");
+
+    unsigned long submit_retries = 0;
+    unsigned long long duration_ns = ctx.records[ctx.record_count - 1].timestamp_ns + 1000000ULL;
+    unsigned long long start_ns = kp_now_ns();
+    for (unsigned long loop = 0; loop < loops; loop++) {
+        for (size_t i = 0; i < ctx.record_count; i++) {
+            const key_trace_record* record = &ctx.records[i];
+            unsigned long long virtual_ns = loop * duration_ns + record->timestamp_ns;
+            if (speed != REPLAY_SPEED_MAX) {
+                // 직접 호출에서는 다음 키를 기다리는 동안이 작업 스레드의 유휴 시간에 해당
+                if (ctx.batch != NULL && !use_pipeline) {
+                    inject_batch_flush(ctx.batch, INJECT_FLUSH_IDLE);
+                }
+                replay_wait_until(start_ns + (unsigned long long)((double)virtual_ns / speed));
+            }
+
+            key_event event;
+            event.vk_code = record->vk_code;
+            event.scan_code = record->scan_code;
+            event.flags = record->flags;
+            event.message = record->message;
+            event.time = (unsigned int)(virtual_ns / 1000000ULL) + 1;
+            event.tag = (unsigned int)i;
+            event.enqueue_ns = kp_now_ns();
+            if (use_pipeline) {
+                // 최대 속도에서는 큐가 빌 때까지 재시도하여 처리량을 측정하고,
+                // 실시간 재생에서는 후크와 같이 가득 찬 큐의 이벤트를 버림
+                while (!key_pipeline_submit(&pipeline, &event) && speed == REPLAY_SPEED_MAX) {
+                    submit_retries++;
+                }
+            } else {
+                replay_process(&ctx, &event, i);
+                ctx.latencies[ctx.latency_count] = kp_now_ns() - event.enqueue_ns;
+                kp_stats_record(ctx.stats_block, KP_STAT_EVENT, ctx.latencies[ctx.latency_count]);
+                ctx.latency_count++;
+            }
+        }
+    }
+    if (use_pipeline) {
+        key_pipeline_stop(&pipeline);
+    } else if (ctx.batch != NULL) {
+        inject_batch_flush(ctx.batch, INJECT_FLUSH_IDLE);
+    }
+    unsigned long long elapsed_ns = kp_now_ns() - start_ns;
+    if (journal_dir != NULL) {
+        key_journal_stats journal_stats;
+        key_journal_writer_stop(&journal);
+        key_journal_writer_get_stats(&journal, &journal_stats);
+        printf("[재생] 저널 (%s): 레코드 %lu | 블록 %lu | 세그먼트 %lu | 손실 %lu | 쓰기 실패 %lu\n", journal_dir,
+               journal_stats.records, journal_stats.blocks, journal_stats.segments,
+               journal_stats.dropped, journal_stats.write_errors);
+    }
+    if (use_keystream) {
+        keystream_stats keystream_stats;
+        keystream_pool_get_stats(&keystream, &keystream_stats);
+        keystream_pool_stop(&keystream);
+        printf("[재생] 키스트림 (%s): 사용 워드 %lu | 풀 고갈 %lu\n", keystream_kernel_name(keystream.kernel),
+               keystream_stats.words_used, keystream_stats.underflows);
+    }
+
+    qsort(ctx.latencies, ctx.latency_count, sizeof(unsigned long long), compare_u64);
+    double seconds = (double)elapsed_ns / 1e9;
+    printf("[재생] 처리 %lu개, 경과 %.3f ms, 초당 %.0f 이벤트\n", (unsigned long)ctx.latency_count,
+           (double)elapsed_ns / 1e6, (seconds > 0.0) ? (double)ctx.latency_count / seconds : 0.0);
+    printf("[재생] 이벤트당 지연 (ns): p50 %llu | p99 %llu | p99.9 %llu | 최대 %llu\n",
+           percentile(ctx.latencies, ctx.latency_count, 0.50),
+           percentile(ctx.latencies, ctx.latency_count, 0.99),
+           percentile(ctx.latencies, ctx.latency_count, 0.999),
+           (ctx.latency_count > 0) ? ctx.latencies[ctx.latency_count - 1] : 0ULL);
+    printf("[재생] 판정: 허용 %lu | 차단 %lu | 확인 불가 %lu | 주입 %lu (체크섬 %08lx)\n",
+           ctx.verdicts[FOREGROUND_ALLOWED], ctx.verdicts[FOREGROUND_BLOCKED],
+           ctx.verdicts[FOREGROUND_UNKNOWN], ctx.injected, ctx.checksum & 0xFFFFFFFFUL);
+    printf("[재생] 판정 캐시: 적중 %lu | 재판정 %lu | 이름 조회 %lu | 자동 반복 빠른 경로 %lu | 키 규칙 차단 %lu\n",
+           ctx.cache.hits, ctx.cache.revalidations, ctx.cache.lookups, ctx.processor.repeats,
+           ctx.processor.rule_blocked);
+    if (ctx.batch != NULL) {
+        const inject_batch_stats* batch_stats = &ctx.batch->stats;
+        printf("[재생] 주입 묶음 (크기 %lu): 키 %lu | 출력 호출 %lu (호출당 %.2f개) | 최대 묶음 %lu | "
+               "크기 %lu, 기한 %lu, 포그라운드 변경 %lu, 유휴 %lu | 문자 주입 %lu\n",
+               (unsigned long)ctx.batch->limit, batch_stats->keys, batch_stats->sends,
+               (batch_stats->sends != 0) ? (double)batch_stats->keys / (double)batch_stats->sends : 0.0,
+               batch_stats->max_batch, batch_stats->flushes[INJECT_FLUSH_SIZE],
+               batch_stats->flushes[INJECT_FLUSH_DEADLINE], batch_stats->flushes[INJECT_FLUSH_FOREGROUND],
+               batch_stats->flushes[INJECT_FLUSH_IDLE], batch_stats->unicode_keys);
+    }
+    if (use_pipeline) {
+        key_pipeline_stats stats;
+        key_pipeline_get_stats(&pipeline, &stats);
+        printf("[재생] 파이프라인: 손실 %lu | 재시도 %lu | 최대 큐 깊이 %lu | 작업 스레드 깨우기 %lu\n",
+               stats.dropped - submit_retries, submit_retries, stats.max_depth, stats.wakeups);
+    }
+
+    if (variant_label != NULL &&
+        !replay_write_variant(variant_path, variant_reset, variant_label, variant_artifact,
+                              (seconds > 0.0) ? (double)ctx.latency_count / seconds : 0.0,
+                              ctx.latencies, ctx.latency_count)) {
+        return 1;
+    }
+
+    if (ctx.audit != NULL) {
+        printf("[재생] 그림자 집계: 키 다운 %lu | 자동 반복 %lu | 후보 정책과 다른 판정 %lu | 판정 평균 %llu ns, 최대 %llu ns\n",
+               audit.key_downs, audit.repeats, audit.disagreements,
+               (unsigned long long)((audit.key_downs != 0) ? audit.eval_ns_total / audit.key_downs : 0),
+               (unsigned long long)audit.eval_ns_max);
+        FILE* report = (report_path != NULL) ? fopen(report_path, "w") : stdout;
+        if (report == NULL) {
+            fprintf(stderr, "[오류] 집계 보고서를 만들 수 없습니다: %s\n", report_path);
+        } else {
+            shadow_audit_write_report(&audit, report);
+            if (report != stdout) {
+                fclose(report);
+                printf("[재생] 그림자 집계 보고서: %s\n", report_path);
+            }
+        }
+    }
+
+    if (use_stats) {
+        kp_shared_memory_close(&stats_memory);
+    }
+    policy_snapshot_destroy(ctx.candidate);
+    policy_snapshot_destroy(ctx.policy);
+    free(ctx.latencies);
+    free(ctx.records);
+    free(ctx.script);
+    return 0;
+}